@@ -0,0 +1,50 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the state associated with a single black hole.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_BLACKHOLE_HPP
+#define GW_BLACKHOLE_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "entity.hpp"
+#include "field.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Represents a single black hole entity. Black holes do not move;
+/// they pull bullets, enemies and particles toward themselves and swirl them
+/// around, and draw in the background grid.
+class BlackHole : public Entity
+{
+public:
+    BlackHole(float p_x=0.0f, float p_y=0.0f);
+    virtual ~BlackHole(void);
+
+public:
+    /// @summary Adds the gravity of the black hole to a force field.
+    /// @param field The force field to update.
+    void AddToField(force_field_t *field) const;
+
+public:
+    /// @summary Perform initialization when the entity is spawned.
+    /// @param dm The DisplayManager, which can be used to retrieve textures.
+    virtual void Init(DisplayManager *dm);
+
+    /// @summary Executes a single simulation tick for the entity.
+    /// @param currentTime The current simulation time, in seconds.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    virtual void Update(double currentTime, double elapsedTime);
+
+    /// @summary Sets state and submits geometry used for rendering.
+    /// @param currentTime The current game time, in seconds.
+    /// @param elapsedTime The time elapsed since the previous frame, in seconds.
+    /// @param dm The display manager used to submit rendering commands.
+    virtual void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
+};
+
+#endif /* !defined(GW_BLACKHOLE_HPP) */
@@ -19,8 +19,8 @@
 class Bullet : public Entity
 {
 protected:
-    float ViewportWidth;
-    float ViewportHeight;
+    float WorldWidth;
+    float WorldHeight;
 
 public:
     Bullet(float p_x=0.0f, float p_y=0.0f, float v_x=0.0f, float v_y=0.0f);
@@ -0,0 +1,62 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines continuous collision detection between moving circles and
+/// the stationary circles stored in a spatial grid. Each mover is swept along
+/// its displacement for the tick, so fast, small objects cannot tunnel through
+/// thin targets regardless of the simulation rate.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_COLLIDE_HPP
+#define GW_COLLIDE_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "ll_spatial.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The minimum number of movers swept by a single task.
+#define COLLIDE_MIN_CHUNK            (64U)
+
+/// @summary The Item value reported for a mover that hits nothing.
+#define COLLIDE_NO_HIT               (0xFFFFFFFFU)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Describes the first contact of a swept circle.
+struct sweep_hit_t
+{
+    uint32_t Item;              /// The index of the point hit, in the order passed to spatial_grid_build(), or COLLIDE_NO_HIT.
+    float    Time;              /// The fraction of the displacement, in [0, 1], at which contact occurs.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Finds the first circle in a spatial grid touched by each of a set
+/// of moving circles. Mover i travels from (x[i], y[i]) to (x[i] + dx[i],
+/// y[i] + dy[i]). Candidates are taken from the grid cells overlapping the
+/// swept bounding box of the mover, then tested several at a time with a SIMD
+/// segment-to-point distance check; the exact time of first contact is only
+/// computed for circles that pass. Targets are treated as stationary.
+/// @param grid The spatial grid containing the target circles.
+/// @param x The starting x-coordinate of each mover.
+/// @param y The starting y-coordinate of each mover.
+/// @param dx The x-component of the displacement of each mover.
+/// @param dy The y-component of the displacement of each mover.
+/// @param r The radius of each mover.
+/// @param count The number of movers.
+/// @param hits An array of count elements receiving the first contact of each mover.
+/// @param pool The task pool used to split the work, or NULL.
+void collide_sweep(spatial_grid_t const *grid, float const *x, float const *y, float const *dx, float const *dy, float const *r, size_t count, sweep_hit_t *hits, task_pool_t *pool);
+
+#endif /* !defined(GW_COLLIDE_HPP) */
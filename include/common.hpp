@@ -169,6 +169,7 @@
 #endif /* !defined(BACKEND_ALIGNMENT_DEFINED) */
 
 /// @summary Wrap compiler differences used to force inlining of a function.
+/// Functions defined in a header are declared `inline BACKEND_FORCE_INLINE`.
 #ifndef BACKEND_FORCE_INLINE
     #ifdef _MSC_VER
         #define BACKEND_FORCE_INLINE       __forceinline
@@ -17,6 +17,15 @@
 #include "ll_sprite.hpp"
 #include "ll_image.hpp"
 
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The default size of the play area, in world units. The simulation
+/// runs in world units on every instance whatever the size of its window, and
+/// the default sprite batch maps the play area onto the framebuffer.
+#define DISPLAY_WORLD_WIDTH          (800.0f)
+#define DISPLAY_WORLD_HEIGHT         (600.0f)
+
 /*////////////////
 //  Data Types  //
 ////////////////*/
@@ -39,6 +48,8 @@ protected:
     GLenum Filter;  /// One of GL_NEAREST, GL_LINEAR, etc. for magnification.
     size_t Width;   /// The width of level 0 of the texture, in pixels.
     size_t Height;  /// The height of level 0 of the texture, in pixels.
+    float  InvWidth;  /// The reciprocal of Width, used to scale texture coordinates.
+    float  InvHeight; /// The reciprocal of Height, used to scale texture coordinates.
 
 public:
     Texture(void);
@@ -65,6 +76,14 @@ public:
     /// @return The height of the texture object, in pixels.
     size_t GetHeight(void) const { return Height; }
 
+    /// @summary Retrieves the reciprocal of the width of the texture.
+    /// @return One over the width of the texture, or zero if it is not loaded.
+    float GetInverseWidth(void) const { return InvWidth; }
+
+    /// @summary Retrieves the reciprocal of the height of the texture.
+    /// @return One over the height of the texture, or zero if it is not loaded.
+    float GetInverseHeight(void) const { return InvHeight; }
+
 public:
     /// @summary Sets the wrapping mode to use for tecture coordinates outside
     /// the [0, 1] range on both the horizontal and vertical axes.
@@ -91,7 +110,6 @@ public:
 class SpriteBatch
 {
 protected:
-    std::vector<sprite_t>  SpriteData; /// A buffer for sprite definitions.
     GLuint                 Program;    /// The OpenGL program object ID.
     shader_desc_t          ShaderDesc; /// Metadata about the shader program.
     attribute_desc_t      *AttribPTX;  /// Information about the Position-Texture attribute.
@@ -100,6 +118,7 @@ protected:
     uniform_desc_t        *UniformMSS; /// Information about the screenspace -> clipspace matrix.
     sprite_effect_t        EffectData; /// Low-level sprite renderer state.
     sprite_batch_t         BatchData;  /// Low-level sprite batch state.
+    uint32_t               BlendMode;  /// The sprite_blend_e applied to sprites as they are added.
 
 public:
     /// @summary Constructs a new SpriteBatch and creates GPU resources.
@@ -158,20 +177,75 @@ public:
     /// @param sy The scale factor to apply along the vertical axis, 1.0 = no scaling.
     void Add(uint32_t z, Texture *t, float x, float y, rect_t const &src, float const *rgba, float rot, float ox, float oy, float sx, float sy);
 
-    /// @summary Disables alpha blending. Changing the blend mode flushes the
-    /// current contents of the sprite batch.
+    /// @summary Queues a sprite for rendering, with its orientation given as a
+    /// unit direction. Sprites aligned with a vector, such as a velocity, can
+    /// pass the normalized vector and skip converting it to an angle.
+    /// @param z The layer depth of the sprite, increasing into the screen.
+    /// @param t The texture containing the sprite image.
+    /// @param x The x-coordinate of the sprite, in pixels.
+    /// @param y The y-coordinate of the sprite, in pixels.
+    /// @param src A rectangle defining the position and size of the image on the source texture.
+    /// @param rgba An array of four float values in [0, 1] defining the RGBA tint color.
+    /// @param rot_cos The cosine of the sprite orientation.
+    /// @param rot_sin The sine of the sprite orientation.
+    /// @param ox The x-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    /// @param oy The y-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    /// @param sx The scale factor to apply along the horizontal axis, 1.0 = no scaling.
+    /// @param sy The scale factor to apply along the vertical axis, 1.0 = no scaling.
+    void AddRotated(uint32_t z, Texture *t, float x, float y, rect_t const &src, float const *rgba, float rot_cos, float rot_sin, float ox, float oy, float sx, float sy);
+
+    /// @summary Queues a set of sprites sharing the same texture, source
+    /// rectangle and origin for rendering. The sprite definitions are written
+    /// in a single pass, avoiding the per-sprite overhead of Add().
+    /// @param z The layer depth of the sprites, increasing into the screen.
+    /// @param t The texture containing the sprite image.
+    /// @param src A rectangle defining the position and size of the image on the source texture.
+    /// @param count The number of sprites to queue.
+    /// @param x An array of count x-coordinates of the sprites, in pixels.
+    /// @param y An array of count y-coordinates of the sprites, in pixels.
+    /// @param rot An array of count sprite orientations, in radians, or NULL for no rotation.
+    /// @param sx An array of count horizontal scale factors, or NULL for no scaling.
+    /// @param sy An array of count vertical scale factors, or NULL to use sx.
+    /// @param abgr An array of count packed ABGR tint colors, as returned by color32().
+    /// @param ox The x-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    /// @param oy The y-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    void AddArray(uint32_t z, Texture *t, rect_t const &src, size_t count, float const *x, float const *y, float const *rot, float const *sx, float const *sy, uint32_t const *abgr, float ox, float oy);
+
+    /// @summary Queues a set of sprites sharing the same texture, source
+    /// rectangle and origin for rendering, with each orientation given as a
+    /// unit direction such as one produced by vec2_soa_direction().
+    /// @param z The layer depth of the sprites, increasing into the screen.
+    /// @param t The texture containing the sprite image.
+    /// @param src A rectangle defining the position and size of the image on the source texture.
+    /// @param count The number of sprites to queue.
+    /// @param x An array of count x-coordinates of the sprites, in pixels.
+    /// @param y An array of count y-coordinates of the sprites, in pixels.
+    /// @param rot_cos An array of count cosines of the sprite orientations.
+    /// @param rot_sin An array of count sines of the sprite orientations.
+    /// @param sx An array of count horizontal scale factors, or NULL for no scaling.
+    /// @param sy An array of count vertical scale factors, or NULL to use sx.
+    /// @param abgr An array of count packed ABGR tint colors, as returned by color32().
+    /// @param ox The x-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    /// @param oy The y-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+    void AddArrayRotated(uint32_t z, Texture *t, rect_t const &src, size_t count, float const *x, float const *y, float const *rot_cos, float const *rot_sin, float const *sx, float const *sy, uint32_t const *abgr, float ox, float oy);
+
+    /// @summary Disables alpha blending for sprites added after the call. The
+    /// blend mode is recorded with each sprite, so changing it does not flush.
     void SetBlendModeNone(void);
 
-    /// @summary Enables standard alpha blending. Changing the blend mode
-    /// flushes the current contents of the sprite batch.
+    /// @summary Enables standard alpha blending for sprites added after the
+    /// call. The blend mode is recorded with each sprite, so changing it does
+    /// not flush.
     void SetBlendModeAlpha(void);
 
-    /// @summary Enables additive alpha blending. Changing the blend mode
-    /// flushes the current contents of the sprite batch.
+    /// @summary Enables additive alpha blending for sprites added after the
+    /// call. The blend mode is recorded with each sprite, so changing it does
+    /// not flush.
     void SetBlendModeAdditive(void);
 
-    /// @summary Enables premultiplied alpha blending. Changing the blend mode
-    /// flushes the current contents of the sprite batch.
+    /// @summary Enables premultiplied alpha blending for sprites added after
+    /// the call. The blend mode is recorded with each sprite, so changing it
+    /// does not flush.
     void SetBlendModePremultiplied(void);
 
 public:
@@ -182,6 +256,8 @@ public:
     virtual void SetViewport(int width, int height);
 
     /// @summary FLushes the current contents of the sprite batch to the GPU.
+    /// Sprites are sorted once, drawing layers of greater depth first and
+    /// grouping sprites with the same blend mode and texture within a layer.
     virtual void Flush(void);
 
     /// @summary Disposes of resources associated with the sprite batch.
@@ -279,6 +355,8 @@ private:
     GLFWwindow  *MainWindow;
     float        ViewportWidth;
     float        ViewportHeight;
+    float        WorldWidth;
+    float        WorldHeight;
     SpriteBatch *DefaultBatch;
     SpriteFont  *DefaultFont;
     Texture     *FontTexture;
@@ -312,6 +390,8 @@ public:
     Texture*     GetWandererTexture(void) const { return WandererTexture; }
     float        GetViewportWidth(void) const { return ViewportWidth; }
     float        GetViewportHeight(void) const { return ViewportHeight; }
+    float        GetWorldWidth(void) const { return WorldWidth; }
+    float        GetWorldHeight(void) const { return WorldHeight; }
 
 public:
     /// @summary Performs one-time initialization of display resources.
@@ -336,6 +416,13 @@ public:
     /// @param height The viewport height, in pixels.
     void SetViewport(int width, int height);
 
+    /// @summary Sets the size of the play area, which must be the same on
+    /// every instance of a networked session. The new size is mapped onto
+    /// the framebuffer from the next call to SetViewport().
+    /// @param width The width of the play area, in world units.
+    /// @param height The height of the play area, in world units.
+    void SetWorldSize(float width, float height) { WorldWidth = width; WorldHeight = height; }
+
     /// @summary Called at the end of the frame to flush all display output.
     void EndFrame(void);
 
@@ -347,4 +434,13 @@ private:
     DisplayManager& operator =(DisplayManager const &other);
 };
 
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Packs an RGBA color into the 32-bit ABGR format used for sprite
+/// tint colors. Each channel is clamped to [0, 1].
+/// @param rgba An array of four float values in [0, 1] defining the RGBA color.
+/// @return The packed ABGR color value.
+uint32_t color32(float const *rgba);
+
 #endif /* !defined(GW_DISPLAY_HPP) */
@@ -0,0 +1,260 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the batched enemy system. Seekers and wanderers are not
+/// individual entities; their state is stored in structure-of-arrays form and
+/// steered in bulk by SIMD kernels split across the task pool, with neighbor
+/// queries answered by a uniform spatial grid rebuilt every tick.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_ENEMY_HPP
+#define GW_ENEMY_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <vector>
+#include "common.hpp"
+#include "display.hpp"
+#include "field.hpp"
+#include "math_rng.hpp"
+#include "ll_spatial.hpp"
+#include "raycast.hpp"
+#include "collide.hpp"
+#include "ll_snapshot.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The default maximum number of live enemies.
+#define ENEMY_CAPACITY               (64U * 1024U)
+
+/// @summary The minimum number of enemies updated by a single task.
+#define ENEMY_MIN_CHUNK              (4U * 1024U)
+
+/// @summary The distance within which enemies push each other apart, in
+/// pixels. This is also the edge length of a spatial grid cell.
+#define ENEMY_SEPARATION_RADIUS      (24.0f)
+
+/// @summary The maximum number of neighbors sampled from each run of three
+/// cells when computing separation. Bounds the cost in crowded areas.
+#define ENEMY_SEPARATION_SAMPLES     (16U)
+
+/// @summary The number of low bits of a handle holding the slot index.
+#define ENEMY_SLOT_BITS              (20U)
+
+/// @summary The value of a handle that does not refer to any enemy.
+#define ENEMY_INVALID_HANDLE         (0xFFFFFFFFU)
+
+/// @summary The default number of ticks between Morton-order re-sorts of the
+/// enemy arrays; two seconds at 120 ticks per second.
+#define ENEMY_SORT_INTERVAL          (240U)
+
+/// @summary The default fraction of live enemies that may be spawned or moved
+/// by despawns before the enemy arrays are re-sorted early.
+#define ENEMY_SORT_THRESHOLD         (0.25f)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Define the various types of enemies.
+enum EnemyType
+{
+    ENEMY_SEEKER     = 0,
+    ENEMY_WANDERER   = 1,
+    ENEMY_TYPE_COUNT = 2
+};
+
+/// @summary Manages all enemies. Live enemies are packed into the first Count
+/// elements of each array. Each enemy is also identified by a handle made up
+/// of a slot index and a generation counter; slots are recycled through a free
+/// list and the generation is bumped on despawn so that stale handles are
+/// rejected. Spawns and kills are queued and applied at the start of the next
+/// Update, so dense indices and the spatial grid stay valid between updates.
+/// Spawns, despawns and movement gradually scatter neighbors across memory, so
+/// Update periodically re-sorts the packed arrays along a Z-order curve and
+/// remaps the handles, keeping grid queries and scatters cache friendly.
+class EnemyManager
+{
+private:
+    static EnemyManager *EM;
+public:
+    static EnemyManager* GetInstance(void);
+
+private:
+    /// @summary A queued request to spawn an enemy.
+    struct spawn_t
+    {
+        float    X;            /// The x-coordinate of the spawn position.
+        float    Y;            /// The y-coordinate of the spawn position.
+        uint32_t Type;         /// One of EnemyType.
+    };
+
+private:
+    task_pool_t *TaskPool;     /// The pool used to split the update, or NULL.
+    Texture     *Images[ENEMY_TYPE_COUNT]; /// The texture used for each enemy type.
+    float        Radii[ENEMY_TYPE_COUNT];  /// The collision radius of each enemy type.
+    void        *Memory;       /// The single allocation backing all arrays.
+    float       *PosX;         /// The x-coordinate of each enemy.
+    float       *PosY;         /// The y-coordinate of each enemy.
+    float       *VelX;         /// The x-velocity of each enemy, in pixels per second.
+    float       *VelY;         /// The y-velocity of each enemy, in pixels per second.
+    float       *Radius;       /// The collision radius of each enemy.
+    float       *SepX;         /// The x-component of the separation acceleration.
+    float       *SepY;         /// The y-component of the separation acceleration.
+    float       *Heading;      /// The wander heading of each enemy, in radians.
+    float       *HeadingCos;   /// The cosine of the wander heading.
+    float       *HeadingSin;   /// The sine of the wander heading.
+    float       *Turn;         /// Scratch storage for random heading changes.
+    float       *SeekGain;     /// 1 for enemies that seek the player, else 0.
+    float       *WanderGain;   /// 1 for enemies that wander, else 0.
+    float       *FacingCos;    /// The cosine of the direction of travel, computed during Draw.
+    float       *FacingSin;    /// The sine of the direction of travel, computed during Draw.
+    float       *DrawX;        /// Scratch storage for the positions of one type during Draw.
+    float       *DrawY;        /// Scratch storage for the positions of one type during Draw.
+    float       *DrawCos;      /// Scratch storage for the orientations of one type during Draw.
+    float       *DrawSin;      /// Scratch storage for the orientations of one type during Draw.
+    uint32_t    *DrawColor;    /// The packed ABGR tint of every enemy sprite.
+    uint32_t    *Type;         /// The EnemyType of each enemy.
+    uint32_t    *Handle;       /// The handle of each enemy.
+    uint32_t    *Sparse;       /// For each slot, the index of its enemy in the packed arrays.
+    uint32_t    *Generation;   /// For each slot, the current generation counter.
+    uint32_t    *FreeSlots;    /// The stack of unused slots.
+    size_t       FreeCount;    /// The number of entries on the FreeSlots stack.
+    size_t       FreeLow;      /// The smallest FreeCount so far; slots from Capacity - FreeLow up have never been used.
+    size_t       Capacity;     /// The maximum number of live enemies.
+    size_t       Count;        /// The number of live enemies.
+    float        WorldWidth;   /// The width of the play area, in world units.
+    float        WorldHeight;  /// The height of the play area, in world units.
+    float        SpawnOdds;    /// The spawner's inverse chance per 1/60th of a second.
+    size_t       SortInterval; /// The number of ticks between re-sorts, or 0.
+    float        SortThreshold;/// The fraction of displaced enemies forcing a re-sort, or 0.
+    uint32_t     SortTicks;    /// The number of ticks since the last re-sort.
+    uint32_t     Displaced;    /// The number of enemies spawned or moved since the last re-sort.
+    spatial_grid_t        Grid;       /// The neighbor query structure.
+    rng8_state_t          Random;     /// The generator used for wandering and spawning.
+    std::vector<spawn_t>  SpawnQueue; /// Spawns waiting for the next Update.
+    std::vector<uint32_t> KillQueue;  /// Handles of enemies waiting to be despawned.
+
+public:
+    /// @summary Allocates storage for the enemy pool.
+    /// @param capacity The maximum number of live enemies, at most 1 << ENEMY_SLOT_BITS.
+    /// @param pool The task pool used to split the update, or NULL.
+    EnemyManager(size_t capacity, task_pool_t *pool);
+    ~EnemyManager(void);
+
+public:
+    size_t GetCount(void) const { return Count; }
+    size_t GetCapacity(void) const { return Capacity; }
+    float  GetRadius(EnemyType type) const { return Radii[type]; }
+    spatial_grid_t const* GetSpatialGrid(void) const { return &Grid; }
+    uint32_t GetHandle(size_t index) const { return Handle[index]; }
+    float const* GetPositionX(void) const { return PosX; }
+    float const* GetPositionY(void) const { return PosY; }
+
+public:
+    /// @summary Retrieves textures and the play area, and builds the spatial grid.
+    /// @param dm The DisplayManager, which can be used to retrieve textures.
+    void Init(DisplayManager *dm);
+
+    /// @summary Despawns all enemies and discards any queued requests.
+    void Clear(void);
+
+    /// @summary Controls when Update re-sorts the enemy arrays into Morton
+    /// order. Re-sorting changes dense indices but not handles.
+    /// @param interval The number of ticks between re-sorts, or 0 to disable
+    /// periodic re-sorting.
+    /// @param threshold The fraction of live enemies spawned or moved by a
+    /// despawn since the last re-sort that triggers an early re-sort, or 0 to
+    /// disable early re-sorting.
+    void SetSortPolicy(size_t interval, float threshold);
+
+    /// @summary Re-sorts the enemy arrays into Morton order of position and
+    /// remaps the handles. Must not be called between computing dense indices,
+    /// such as ray hits, and converting them to handles.
+    void SortByPosition(void);
+
+    /// @summary Queues an enemy to be spawned at the start of the next Update.
+    /// @param type One of EnemyType.
+    /// @param x The x-coordinate of the spawn position, in pixels.
+    /// @param y The y-coordinate of the spawn position, in pixels.
+    void Spawn(EnemyType type, float x, float y);
+
+    /// @summary Queues an enemy to be despawned at the start of the next
+    /// Update. Stale or repeated handles are ignored.
+    /// @param handle The handle of the enemy to despawn.
+    void Kill(uint32_t handle);
+
+    /// @summary Checks whether a handle refers to a live enemy.
+    /// @param handle The handle to check.
+    /// @return true if the enemy is live.
+    bool IsAlive(uint32_t handle) const;
+
+    /// @summary Casts a batch of rays against the enemies as of the most
+    /// recent Update. Hit items are indices into the packed arrays; convert
+    /// them with GetHandle() before passing them to Kill().
+    /// @param rays The rays to cast.
+    /// @param count The number of rays.
+    /// @param max_hits The maximum number of hits to return per ray.
+    /// @param hits An array of count * max_hits elements receiving the hits
+    /// of each ray, nearest first.
+    /// @param hit_counts An array of count elements receiving the number of
+    /// hits found for each ray.
+    void CastRays(ray_t const *rays, size_t count, size_t max_hits, ray_hit_t *hits, size_t *hit_counts) const;
+
+    /// @summary Sweeps a batch of moving circles against the enemies as of
+    /// the most recent Update, reporting the first enemy each one touches.
+    /// Hit items are indices into the packed arrays, as for CastRays().
+    /// @param x The starting x-coordinate of each mover.
+    /// @param y The starting y-coordinate of each mover.
+    /// @param dx The x-component of the displacement of each mover.
+    /// @param dy The y-component of the displacement of each mover.
+    /// @param r The radius of each mover.
+    /// @param count The number of movers.
+    /// @param hits An array of count elements receiving the first contact
+    /// of each mover.
+    void SweepCircles(float const *x, float const *y, float const *dx, float const *dy, float const *r, size_t count, sweep_hit_t *hits) const;
+
+    /// @summary Accelerates all enemies according to a force field. This
+    /// should be called before Update for the same tick.
+    /// @param field The force field to apply.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    void ApplyForceField(force_field_t const *field, double elapsedTime);
+
+    /// @summary Executes a single simulation tick: applies queued spawns and
+    /// kills, runs the spawner, rebuilds the spatial grid, and computes the
+    /// separation, seek and wander steering for every enemy.
+    /// @param currentTime The current simulation time, in seconds.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    void Update(double currentTime, double elapsedTime);
+
+    /// @summary Appends the simulation state of every enemy, including the
+    /// spatial grid used by queries between updates, to a snapshot.
+    /// @param buffer The snapshot buffer to append to.
+    /// @return true if the state was written.
+    bool Save(snapshot_buffer_t *buffer) const;
+
+    /// @summary Replaces the simulation state of every enemy with state
+    /// previously written by Save.
+    /// @param buffer The snapshot buffer to read from.
+    /// @return true if the state was restored.
+    bool Restore(snapshot_buffer_t *buffer);
+
+    /// @summary Submits all enemies to the default sprite batch.
+    /// @param currentTime The current game time, in seconds.
+    /// @param elapsedTime The time elapsed since the previous frame, in seconds.
+    /// @param dm The display manager used to submit rendering commands.
+    void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
+
+private:
+    void CommitQueues(void);
+    void UpdateSpawner(float elapsed);
+    EnemyManager(EnemyManager const &other);
+    EnemyManager& operator =(EnemyManager const &other);
+};
+
+#endif /* !defined(GW_ENEMY_HPP) */
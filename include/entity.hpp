@@ -11,16 +11,30 @@
 //   Includes   //
 ////////////////*/
 #include <list>
+#include <vector>
 #include "common.hpp"
 #include "display.hpp"
 #include "input.hpp"
+#include "field.hpp"
+#include "collide.hpp"
+#include "ll_snapshot.hpp"
+#include "ll_timer.hpp"
+#include "ll_quadtree.hpp"
+#include "ll_spatial.hpp"
 
 /*//////////////////////////
 //  Forward Declarations  //
 //////////////////////////*/
 class Bullet;
+class BlackHole;
 class Player;
 
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The largest number of entities returned by EntityManager::FindNearest.
+#define ENTITY_NEAREST_MAX           (16U)
+
 /*////////////////
 //  Data Types  //
 ////////////////*/
@@ -34,33 +48,99 @@ enum EntityType
     ENTITY_PLAYER    = 4
 };
 
-/// @summary The base class for all game entities.
+/// @summary Define the kinds of timers scheduled by entities. The payload of
+/// each timer is the index of the player it applies to.
+enum EntityTimerKind
+{
+    TIMER_PLAYER_RELOAD  = 0,
+    TIMER_PLAYER_RESPAWN = 1
+};
+
+/// @summary The simulation state specific to a player.
+struct player_state_t
+{
+    float    TargetPoint[2];   /// The point the player is moving toward.
+    float    TargetVector[2];  /// The offset from the player to TargetPoint.
+    float    BeamLength;       /// The length of the beam drawn this tick, or zero.
+    uint32_t FiringBeam;       /// Non-zero while the beam button is held.
+    uint32_t WeaponReady;      /// Non-zero once the weapon has cooled down.
+    uint32_t Dead;             /// Non-zero while the player waits to respawn.
+};
+
+/// @summary The simulation state specific to a black hole.
+struct blackhole_state_t
+{
+    float    Phase;            /// The phase of the pulse, in radians.
+    float    Scale;            /// The scale of the sprite for the current pulse.
+};
+
+/// @summary The flat, relocatable simulation state of a single entity. The
+/// EntityManager keeps the state of every entity in one array, in update
+/// order, so that a snapshot is a single copy. Rendering resources are not
+/// included; they are reacquired by Init when an entity is recreated.
+struct entity_state_t
+{
+    uint32_t Kind;             /// One of EntityType.
+    int32_t  Index;            /// A kind-specific identifier, such as the player index.
+    float    Color[4];         /// The RGBA tint color.
+    float    Position[2];      /// The entity position.
+    float    Velocity[2];      /// The entity velocity.
+    float    Rotation[2];      /// The entity orientation as a unit (cos, sin) pair.
+    float    Radius;           /// The entity radius.
+    uint32_t IsExpired;        /// Non-zero if the entity has 'died'.
+    union
+    {
+        player_state_t    Player;
+        blackhole_state_t BlackHole;
+    }        Extra;            /// Kind-specific state; unused bytes are zero.
+};
+
+/// @summary The base class for all game entities. The simulation state of an
+/// entity is held in its Spawn record until it is added to the manager, and
+/// in the manager's state array after that; State points at whichever holds
+/// it, and is updated by the manager whenever the array moves.
 class Entity
 {
 protected:
-    Texture   *Image;       /// The texture used to render the entity.
-    float      Color[4];    /// The RGBA tint color used to modify the entity.
-    float      Position[2]; /// The entity position [0] = X, [1] = Y.
-    float      Velocity[2]; /// The entity velocity [0] = X, [1] = Y.
-    float      Orientation; /// The entity angle of orientation, in radians.
-    float      Radius;      /// The entity radius, used for collision detection.
-    bool       IsExpired;   /// true if this entity has 'died'.
-    EntityType Kind;        /// The type of entity.
+    Texture        *Image;     /// The texture used to render the entity.
+    entity_state_t *State;     /// The simulation state of the entity.
+    entity_state_t  Spawn;     /// The simulation state before the entity is added.
 
 public:
     Entity(void);
     virtual ~Entity(void);
 
 public:
-    EntityType GetKind(void) const { return Kind; }
+    EntityType GetKind(void) const { return EntityType(State->Kind); }
     float GetWidth(void) const { return (float) Image->GetWidth(); }
     float GetHeight(void) const { return (float) Image->GetHeight(); }
-    float const* GetPosition(void) const { return Position; }
-    float const* GetVelocity(void) const { return Velocity; }
-    float GetRadius(void) const { return Radius; }
-    bool GetExpired(void) const { return IsExpired; }
-    void SetVelocity(float x, float y) { Velocity[0] = x; Velocity[1] = y; }
-    void SetExpired(void) { IsExpired = true; }
+    float const* GetPosition(void) const { return State->Position; }
+    float const* GetVelocity(void) const { return State->Velocity; }
+    float GetRadius(void) const { return State->Radius; }
+    bool GetExpired(void) const { return State->IsExpired != 0; }
+    void SetPosition(float x, float y) { State->Position[0] = x; State->Position[1] = y; }
+    void SetVelocity(float x, float y) { State->Velocity[0] = x; State->Velocity[1] = y; }
+    void SetExpired(void) { State->IsExpired = 1; }
+    float const* GetRotation(void) const { return State->Rotation; }
+    entity_state_t const* GetState(void) const { return State; }
+    void SetState(entity_state_t *state) { State = state; }
+
+public:
+    /// @summary Computes the angle of orientation of the entity. The angle is
+    /// not stored, and is derived from the rotation on each call.
+    /// @return The angle of orientation, in radians.
+    float GetOrientation(void) const;
+
+    /// @summary Sets the orientation of the entity from an angle.
+    /// @param angle The angle of orientation, in radians.
+    void SetOrientation(float angle);
+
+    /// @summary Sets the orientation of the entity to face along a vector,
+    /// such as its velocity, without computing an angle. A zero-length
+    /// vector leaves the orientation unchanged.
+    /// @param x The x-component of the vector.
+    /// @param y The y-component of the vector.
+    void SetDirection(float x, float y);
 
 public:
     /// @summary Perform initialization when the entity is spawned.
@@ -85,7 +165,18 @@ public:
     virtual void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
 };
 
-/// @summary Manages all of the game entities.
+/// @summary Manages all of the game entities. The manager also owns the force
+/// field describing the gravity of every active black hole, which is rebuilt
+/// at the start of each tick and applied to bullets before they move. Other
+/// systems apply the same field to their own bodies via GetForceField().
+/// Bullets are swept along their velocity against the enemies before they
+/// move, so fast bullets cannot pass through an enemy between ticks. Delays
+/// such as weapon cooldowns are scheduled on a timing wheel that advances
+/// once per tick, so entities do not count down timers themselves. Bullets
+/// are binned into a uniform grid each tick to find those swallowed by black
+/// holes. Radius and nearest-neighbor queries are answered by a loose quadtree
+/// that is rebuilt by the first query after the entities move, so ticks
+/// without queries pay nothing for it.
 class EntityManager
 {
 private:
@@ -94,19 +185,33 @@ public:
     static EntityManager *GetInstance(void);
 
 private:
-    std::list<Entity*> Entities;
-    std::list<Entity*> AddedEntities;
-    std::list<Bullet*> Bullets;
-    std::list<Player*> Players;
-    bool               IsUpdating;
+    std::list<Entity*>    Entities;
+    std::list<Entity*>    AddedEntities;
+    std::list<Bullet*>    Bullets;
+    std::list<BlackHole*> BlackHoles;
+    std::list<Player*>    Players;
+    std::vector<entity_state_t> States;  /// The state of each entity in Entities, in the same order.
+    std::vector<float>    FieldScratch; /// Bullet positions and velocities in SoA form.
+    std::vector<sweep_hit_t> SweepHits; /// The first enemy touched by each bullet.
+    force_field_t         Field;        /// The gravity of every active black hole.
+    timer_wheel_t         Timers;       /// Pending entity timers, in ticks.
+    quadtree_t            Index;        /// The bounding circle of every entity.
+    std::vector<Entity*>  IndexItems;   /// The entity stored in each item of Index.
+    std::vector<uint32_t> IndexHits;    /// Scratch storage for index queries.
+    spatial_grid_t        BulletGrid;   /// The center of every bullet, rebuilt each tick.
+    std::vector<Bullet*>  BulletItems;  /// The bullet of each point in BulletGrid.
+    double                TickLength;   /// The length of a simulation tick, in seconds.
+    bool                  IndexStale;   /// true if entities moved since Index was built.
+    bool                  IsUpdating;
 
 public:
-    EntityManager(void);
+    EntityManager(double tickLength);
     ~EntityManager(void);
 
 public:
     size_t  PlayerCount(void) const;
     size_t  EntityCount(void) const;
+    force_field_t const* GetForceField(void) const { return &Field; }
 
 public:
     Player* GetPlayer(int index);
@@ -116,7 +221,63 @@ public:
     void Input(double currentTime, double elapsedTime, InputManager *im);
     void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
 
+    /// @summary Schedules a timer that expires after a delay. The delay is
+    /// rounded up to a whole number of ticks.
+    /// @param kind One of EntityTimerKind.
+    /// @param payload The index of the player the timer applies to.
+    /// @param delay The delay, in seconds.
+    /// @return A handle that can be passed to Cancel.
+    timer_handle_t Schedule(EntityTimerKind kind, uint32_t payload, double delay);
+
+    /// @summary Cancels a pending timer.
+    /// @param handle The handle returned by Schedule.
+    /// @return true if the timer was pending.
+    bool Cancel(timer_handle_t handle);
+
+    /// @summary Finds every entity whose bounding circle overlaps a circle,
+    /// as of the end of the most recent tick.
+    /// @param x The x-coordinate of the center of the query circle.
+    /// @param y The y-coordinate of the center of the query circle.
+    /// @param r The radius of the query circle.
+    /// @param result On return, the overlapping entities.
+    /// @return The number of entities found.
+    size_t QueryCircle(float x, float y, float r, std::vector<Entity*> &result);
+
+    /// @summary Finds the entities whose centers are nearest to a point, as of
+    /// the end of the most recent tick.
+    /// @param x The x-coordinate of the point.
+    /// @param y The y-coordinate of the point.
+    /// @param k The maximum number of entities to return, at most ENTITY_NEAREST_MAX.
+    /// @param max_dist Entities farther than this are ignored.
+    /// @param result An array of k elements receiving the entities, nearest first.
+    /// @return The number of entities found.
+    size_t FindNearest(float x, float y, size_t k, float max_dist, Entity **result);
+
+    /// @summary Appends the state of every entity to a snapshot. Must not be
+    /// called during Update.
+    /// @param buffer The snapshot buffer to append to.
+    /// @return true if the state was written.
+    bool Save(snapshot_buffer_t *buffer) const;
+
+    /// @summary Replaces every entity with the state written by Save. Live
+    /// entities are kept while they line up with the saved ones, so restoring
+    /// a recent snapshot rarely allocates.
+    /// @param buffer The snapshot buffer to read from.
+    /// @return true if the state was restored.
+    bool Restore(snapshot_buffer_t *buffer);
+
 private:
+    void Track(Entity *entity);
+    void RebuildIndex(void);
+    void BindStates(void);
+    void RemoveExpired(void);
+    Entity* CreateEntity(entity_state_t const *state);
+    void ApplyForceField(float elapsed);
+    void CollideBullets(void);
+    void CollideBlackHoles(void);
+    bool RestoreTimers(snapshot_buffer_t *buffer);
+    static void PlayersReloaded(uint32_t const *players, size_t count, void *context);
+    static void PlayersRespawned(uint32_t const *players, size_t count, void *context);
     EntityManager(EntityManager const &other);
     EntityManager& operator =(EntityManager const &other);
 };
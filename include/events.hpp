@@ -0,0 +1,99 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the simulation event bus. Systems do not create entities
+/// or emit effects directly while they update; they append typed events to a
+/// stream per event kind, and the bus hands each stream to its consumer in
+/// one batch once every system has finished the tick.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_EVENTS_HPP
+#define GW_EVENTS_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "ll_event.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The number of bullet spawn events allocated up front.
+#define EVENT_BULLET_CAPACITY        (256U)
+
+/// @summary The number of particle burst events allocated up front.
+#define EVENT_BURST_CAPACITY         (1024U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Requests that a bullet be created.
+struct bullet_spawn_event_t
+{
+    float X;           /// The x-coordinate of the bullet, in pixels.
+    float Y;           /// The y-coordinate of the bullet, in pixels.
+    float VelX;        /// The x-velocity of the bullet, in pixels per tick.
+    float VelY;        /// The y-velocity of the bullet, in pixels per tick.
+};
+
+/// @summary Requests a burst of particles; see ParticleManager::EmitBurst.
+struct particle_burst_event_t
+{
+    float    X;        /// The x-coordinate of the origin, in pixels.
+    float    Y;        /// The y-coordinate of the origin, in pixels.
+    uint32_t Count;    /// The number of particles to spawn.
+    float    MinSpeed; /// The minimum particle speed, in pixels per second.
+    float    MaxSpeed; /// The maximum particle speed, in pixels per second.
+    float    Color[4]; /// The RGBA base color of the particles.
+    float    Duration; /// The lifetime of each particle, in seconds.
+    float    Scale;    /// The uniform scale factor of each particle.
+};
+
+/// @summary Collects the events raised during a simulation tick. The post
+/// functions may be called from any thread during the update phase. Events
+/// raised on a single thread are dispatched in the order they were raised,
+/// so a single-threaded simulation remains deterministic. The bus is empty
+/// between ticks, so it holds no state that needs to be saved.
+class EventBus
+{
+private:
+    static EventBus *EB;
+public:
+    static EventBus* GetInstance(void);
+
+private:
+    event_stream_t BulletSpawns;   /// bullet_spawn_event_t records.
+    event_stream_t ParticleBursts; /// particle_burst_event_t records.
+
+public:
+    EventBus(void);
+    ~EventBus(void);
+
+public:
+    /// @summary Requests that a bullet be created after the update phase.
+    /// @param x The x-coordinate of the bullet, in pixels.
+    /// @param y The y-coordinate of the bullet, in pixels.
+    /// @param vx The x-velocity of the bullet, in pixels per tick.
+    /// @param vy The y-velocity of the bullet, in pixels per tick.
+    void SpawnBullet(float x, float y, float vx, float vy);
+
+    /// @summary Requests a burst of particles after the update phase. The
+    /// arguments are the same as those of ParticleManager::EmitBurst.
+    void EmitBurst(float x, float y, size_t count, float min_speed, float max_speed, float const *rgba, float duration, float scale);
+
+    /// @summary Hands every pending event to its consumer and empties the bus.
+    /// Called once per tick, after every producer has finished updating and
+    /// before the consumers update.
+    void Dispatch(void);
+
+    /// @summary Retrieves the number of events dropped because a stream was
+    /// full. Each stream grows to fit after the first overflow.
+    /// @return The total number of events dropped.
+    size_t DroppedCount(void) const;
+
+private:
+    EventBus(EventBus const &other);
+    EventBus& operator =(EventBus const &other);
+};
+
+#endif /* !defined(GW_EVENTS_HPP) */
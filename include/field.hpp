@@ -0,0 +1,110 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines a force field made up of point sources, such as black
+/// holes, that pull on and swirl the bodies around them. Sources are bucketed
+/// into a coarse grid of cells so that each block of bodies only evaluates
+/// the sources whose influence radius overlaps it.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_FIELD_HPP
+#define GW_FIELD_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The maximum number of sources in a force field. Each cell records
+/// the sources overlapping it as a bitmask, which limits the count to 64.
+#define FIELD_MAX_SOURCES            64U
+
+/// @summary The default edge length of a bucketing cell, in pixels.
+#define FIELD_CELL_SIZE              128.0f
+
+/// @summary The number of bodies culled against the sources as a unit.
+#define FIELD_BLOCK_SIZE             64U
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Describes a single source of force. A body at offset d = source
+/// - body, |d| < Radius, has its velocity changed by
+/// (d * Pull + perp(d) * Swirl) / (|d|^2 + Softening), where perp(d) rotates
+/// d by 90 degrees. The pull therefore falls off with the inverse of distance
+/// and the swirl drives bodies around the source.
+struct field_source_t
+{
+    float    X;                 /// The x-coordinate of the source.
+    float    Y;                 /// The y-coordinate of the source.
+    float    Pull;              /// The strength of the pull toward the source.
+    float    Swirl;             /// The strength of the tangential swirl.
+    float    Radius;            /// The radius beyond which the source has no effect.
+    float    Softening;         /// Limits the force close to the source.
+};
+
+/// @summary The sources making up a force field, and the coarse grid used to
+/// find the sources that may affect a region.
+struct force_field_t
+{
+    field_source_t Sources[FIELD_MAX_SOURCES]; /// The active sources.
+    size_t         SourceCount; /// The number of valid Sources.
+    float          OriginX;     /// The x-coordinate of the upper-left corner of the grid.
+    float          OriginY;     /// The y-coordinate of the upper-left corner of the grid.
+    float          InvCellSize; /// The reciprocal of the cell edge length.
+    size_t         CellsX;      /// The number of cells along the horizontal axis.
+    size_t         CellsY;      /// The number of cells along the vertical axis.
+    uint64_t      *CellMask;    /// For each cell, the bitmask of overlapping sources.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Initializes an empty force field covering a region. Bodies and
+/// sources outside of the region are still handled correctly, but are
+/// bucketed into the cells along the edge of the region.
+/// @param field The force field to initialize.
+/// @param x The x-coordinate of the upper-left corner of the region.
+/// @param y The y-coordinate of the upper-left corner of the region.
+/// @param width The width of the region.
+/// @param height The height of the region.
+/// @param cell_size The edge length of a bucketing cell.
+void field_create(force_field_t *field, float x, float y, float width, float height, float cell_size = FIELD_CELL_SIZE);
+
+/// @summary Frees the memory associated with a force field.
+/// @param field The force field to free.
+void field_delete(force_field_t *field);
+
+/// @summary Removes all sources from a force field.
+/// @param field The force field to clear.
+void field_clear(force_field_t *field);
+
+/// @summary Adds a source to a force field.
+/// @param field The force field to update.
+/// @param source The source definition.
+/// @return true if the source was added, or false if the field is full.
+bool field_add_source(force_field_t *field, field_source_t const &source);
+
+/// @summary Accumulates the force of every source into the velocities of a
+/// set of bodies stored in structure-of-arrays form. Bodies are processed in
+/// blocks of FIELD_BLOCK_SIZE; each block only evaluates the sources whose
+/// cells overlap its bounding box.
+/// @param field The force field to evaluate.
+/// @param vel_x The x-velocities of the bodies, updated in place.
+/// @param vel_y The y-velocities of the bodies, updated in place.
+/// @param pos_x The x-coordinates of the bodies.
+/// @param pos_y The y-coordinates of the bodies.
+/// @param count The number of bodies.
+/// @param scale A factor applied to the velocity change, used to convert the
+/// source strengths to the time step and velocity units of the bodies.
+/// @param pool The task pool used to split the work, or NULL.
+void field_apply(force_field_t const *field, float *vel_x, float *vel_y, float const *pos_x, float const *pos_y, size_t count, float scale, task_pool_t *pool);
+
+#endif /* !defined(GW_FIELD_HPP) */
@@ -0,0 +1,196 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the warping background grid. The grid is a lattice of
+/// point masses connected to their neighbors by Hooke springs and anchored to
+/// their rest positions. Point attributes are stored in structure-of-arrays
+/// form and solved with SIMD kernels, partitioned by row across the task pool.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_GRID_HPP
+#define GW_GRID_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "display.hpp"
+#include "ll_snapshot.hpp"
+#include "ll_lod.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The default number of point masses along the horizontal axis.
+#define GRID_COLUMNS                 200U
+
+/// @summary The default number of point masses along the vertical axis.
+#define GRID_ROWS                    150U
+
+/// @summary The minimum number of rows solved by a single task.
+#define GRID_MIN_ROWS                16U
+
+/// @summary The number of interior rows in each band scheduled by the
+/// level-of-detail scheduler.
+#define GRID_BAND_ROWS               8U
+
+/// @summary The default number of ticks between updates of a quiet band. At
+/// 120 ticks per second, quiet bands step at the 60 Hz rate the spring
+/// constants were tuned for, so larger periods risk instability.
+#define GRID_LOD_PERIOD              2U
+
+/// @summary The default number of ticks a band stays at full rate after an
+/// impulse touches it or one of its neighbors.
+#define GRID_LOD_SETTLE              60U
+
+/// @summary The stiffness of the springs between neighboring point masses.
+#define GRID_SPRING_STIFFNESS        (0.28f)
+
+/// @summary The damping applied to the relative velocity of neighboring points.
+#define GRID_SPRING_DAMPING          (0.06f)
+
+/// @summary The stiffness of the spring anchoring each point to its rest position.
+#define GRID_ANCHOR_STIFFNESS        (0.02f)
+
+/// @summary The fraction of point velocity retained over 1/60th of a second.
+#define GRID_VELOCITY_DAMPING        (0.98f)
+
+/// @summary The thickness of the rendered grid lines, in pixels.
+#define GRID_LINE_THICKNESS          (1.0f)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Manages the background grid. The border points are fixed; every
+/// interior point has exactly four neighbors, so the spring forces on a point
+/// are gathered from its neighbors without any scattered writes, and rows can
+/// be solved independently. Forces and impulses are expressed in units of
+/// 1/60th of a second so that the tuning is independent of the tick rate.
+/// Rows are grouped into bands; bands that no impulse has touched recently
+/// are nearly at rest, and are updated at a reduced rate with a longer step.
+class GridManager
+{
+private:
+    static GridManager *GM;
+public:
+    static GridManager* GetInstance(void);
+
+private:
+    task_pool_t *TaskPool;     /// The pool used to split the update, or NULL.
+    Texture     *Image;        /// The texture used to render grid lines.
+    void        *Memory;       /// The single allocation backing all arrays.
+    float       *PosX;         /// The x-coordinate of each point.
+    float       *PosY;         /// The y-coordinate of each point.
+    float       *VelX;         /// The x-velocity of each point.
+    float       *VelY;         /// The y-velocity of each point.
+    float       *AccX;         /// The x-component of the force accumulated on each point.
+    float       *AccY;         /// The y-component of the force accumulated on each point.
+    float       *RestX;        /// The x-coordinate of the rest position of each point.
+    float       *RestY;        /// The y-coordinate of the rest position of each point.
+    float       *SegDX;        /// Scratch storage for segment direction cosines during Draw.
+    float       *SegDY;        /// Scratch storage for segment direction sines during Draw.
+    float       *SegLength;    /// Scratch storage for segment lengths during Draw.
+    float       *SegThick;     /// The vertical scale of every segment sprite.
+    uint32_t    *SegColor;     /// The packed ABGR color of every segment sprite.
+    size_t       Columns;      /// The number of points along the horizontal axis.
+    size_t       Rows;         /// The number of points along the vertical axis.
+    float        SpacingX;     /// The horizontal distance between points at rest.
+    float        SpacingY;     /// The vertical distance between points at rest.
+    lod_scheduler_t Lod;       /// The schedule of band updates.
+    size_t       BandCount;    /// The number of bands of interior rows.
+    uint32_t     Settle;       /// The number of ticks a band stays active after an impulse.
+    uint64_t    *BandLast;     /// The tick at which each band last updated.
+    uint64_t    *BandActive;   /// The last tick at which each band updates at full rate.
+    uint32_t    *DueBand;      /// Scratch storage for the bands updated this tick.
+    uint32_t    *DueTicks;     /// Scratch storage for the ticks each due band advances by.
+
+public:
+    /// @summary Allocates storage for the grid.
+    /// @param columns The number of points along the horizontal axis, at least 3.
+    /// @param rows The number of points along the vertical axis, at least 3.
+    /// @param pool The task pool used to split the update, or NULL.
+    GridManager(size_t columns, size_t rows, task_pool_t *pool);
+    ~GridManager(void);
+
+public:
+    size_t GetColumns(void) const { return Columns; }
+    size_t GetRows(void) const { return Rows; }
+
+    /// @summary Configures the level-of-detail schedule.
+    /// @param period The number of ticks between updates of a quiet band, or
+    /// 1 to update every band on every tick.
+    /// @param settle The number of ticks a band stays at full rate after an
+    /// impulse touches it.
+    void SetLodPolicy(uint32_t period, uint32_t settle);
+
+    /// @summary Retrieves the fraction of point updates skipped by the
+    /// level-of-detail schedule since the grid was created.
+    /// @return A value in [0, 1].
+    float GetLodSkipped(void) const { return lod_scheduler_skipped(&Lod); }
+
+public:
+    /// @summary Lays out the grid over the viewport and places every point at
+    /// its rest position.
+    /// @param dm The DisplayManager, which can be used to retrieve textures.
+    void Init(DisplayManager *dm);
+
+    /// @summary Pushes points within a radius in a given direction. The push
+    /// weakens with distance from the center.
+    /// @param fx The x-component of the force.
+    /// @param fy The y-component of the force.
+    /// @param x The x-coordinate of the center of the force, in pixels.
+    /// @param y The y-coordinate of the center of the force, in pixels.
+    /// @param radius The radius of the affected area, in pixels.
+    void ApplyDirectedForce(float fx, float fy, float x, float y, float radius);
+
+    /// @summary Pushes points within a radius away from a center point.
+    /// @param force The magnitude of the force.
+    /// @param x The x-coordinate of the center of the force, in pixels.
+    /// @param y The y-coordinate of the center of the force, in pixels.
+    /// @param radius The radius of the affected area, in pixels.
+    void ApplyExplosiveForce(float force, float x, float y, float radius);
+
+    /// @summary Pulls points within a radius toward a center point.
+    /// @param force The magnitude of the force.
+    /// @param x The x-coordinate of the center of the force, in pixels.
+    /// @param y The y-coordinate of the center of the force, in pixels.
+    /// @param radius The radius of the affected area, in pixels.
+    void ApplyImplosiveForce(float force, float x, float y, float radius);
+
+    /// @summary Executes a single simulation tick, accumulating spring forces
+    /// and integrating the point masses using semi-implicit Euler. Only the
+    /// bands due this tick are updated.
+    /// @param currentTime The current simulation time, in seconds.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    void Update(double currentTime, double elapsedTime);
+
+    /// @summary Appends the simulation state of every point mass to a snapshot.
+    /// @param buffer The snapshot buffer to append to.
+    /// @return true if the state was written.
+    bool Save(snapshot_buffer_t *buffer) const;
+
+    /// @summary Replaces the simulation state of every point mass with state
+    /// previously written by Save.
+    /// @param buffer The snapshot buffer to read from.
+    /// @return true if the state was restored.
+    bool Restore(snapshot_buffer_t *buffer);
+
+    /// @summary Submits the grid lines to the default sprite batch.
+    /// @param currentTime The current game time, in seconds.
+    /// @param elapsedTime The time elapsed since the previous frame, in seconds.
+    /// @param dm The display manager used to submit rendering commands.
+    void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
+
+private:
+    template <typename K>
+    void ApplyImpulse(K const &k, float x, float y, float radius);
+    void Activate(size_t row_begin, size_t row_end);
+    GridManager(GridManager const &other);
+    GridManager& operator =(GridManager const &other);
+};
+
+#endif /* !defined(GW_GRID_HPP) */
@@ -13,6 +13,13 @@
 #include "platform.hpp"
 #include "ll_input.hpp"
 
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The maximum number of players whose input can be supplied
+/// separately through InputManager::SetPlayerSnapshot().
+#define INPUT_MAX_PLAYERS            (4U)
+
 /*////////////////
 //  Data Types  //
 ////////////////*/
@@ -44,6 +51,7 @@ private:
     uint32_t          DisconnectEvents; /// Bit i set if controller index i was disconnected.
     float             MouseDeltaX;      /// Mouse delta from the previous tick.
     float             MouseDeltaY;      /// Mouse delta from the previous tick.
+    input_snapshot_t const *PlayerStates[INPUT_MAX_PLAYERS]; /// Per-player input overrides, or NULL.
 
 public:
     InputManager(void);
@@ -53,8 +61,11 @@ public:
     /// @summary Performs one-time initialization for the input manager and
     /// resets the state of all input devices.
     /// @param win The window to which the input manager is attached.
+    /// @param controller_poll_rate The maximum rate, in Hz, at which
+    /// input_controller_poll() queries controllers, or zero to poll them
+    /// every tick during InputManager::Update().
     /// @return true if initialization was successful.
-    bool Init(GLFWwindow *win);
+    bool Init(GLFWwindow *win, uint32_t controller_poll_rate = INPUT_CONTROLLER_POLL_RATE);
 
     /// @summary Performs any teardown required by the input manager.
     void Shutdown(void);
@@ -68,6 +79,24 @@ public:
     /// @return The input device state for the previous tick.
     input_snapshot_t const* GetPreviousSnapshot(void) const { return &PreviousState; }
 
+    /// @summary Retrieve the input state that controls a given player. This
+    /// is the local device state unless another snapshot has been supplied,
+    /// as it is for remote players during networked play.
+    /// @param index The player index.
+    /// @return The input state controlling the player.
+    input_snapshot_t const* GetPlayerSnapshot(int index) const
+    {
+        if (index >= 0 && index < int(INPUT_MAX_PLAYERS) && PlayerStates[index] != NULL)
+            return PlayerStates[index];
+        return &CurrentState;
+    }
+
+    /// @summary Supplies the input state controlling a player.
+    /// @param index The player index, less than INPUT_MAX_PLAYERS.
+    /// @param state The input state, which must remain valid until replaced,
+    /// or NULL to use the local device state.
+    void SetPlayerSnapshot(int index, input_snapshot_t const *state) { PlayerStates[index] = state; }
+
     /// @summary Retrieve the window attached to this InputManager.
     /// @return The attached window.
     GLFWwindow* GetWindow(void) const { return MainWindow; }
@@ -0,0 +1,89 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a frame budget scheduler for
+/// a fixed-step simulation. The scheduler measures the cost of each step and
+/// decides how many steps a frame may run. When the simulation does not fit
+/// in its share of the frame, it raises a degradation level so the caller
+/// can shed optional work, and only once every level has been used does it
+/// drop ticks, so a slow frame cannot cause a spiral of catch-up steps.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_BUDGET_HPP
+#define LL_BUDGET_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The weight of the newest sample in the smoothed step cost.
+#define BUDGET_COST_WEIGHT           (0.1)
+
+/// @summary A frame that uses less than this fraction of the budget counts
+/// as under budget and toward restoring a degradation level.
+#define BUDGET_RELAX_FRACTION        (0.5)
+
+/// @summary The number of consecutive frames under budget required before
+/// the degradation level is lowered.
+#define BUDGET_RECOVER_FRAMES        (120U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The state of a frame budget scheduler.
+struct frame_budget_t
+{
+    double   Step;          /// The length of a simulation tick, in seconds.
+    double   Budget;        /// The wall-clock time per frame allowed for simulation.
+    double   StepCost;      /// The smoothed wall-clock cost of a single step.
+    uint32_t MaxSteps;      /// The most steps a frame may run to catch up.
+    uint32_t MaxLevel;      /// The highest degradation level the caller supports.
+    uint32_t Level;         /// The current degradation level; 0 is full quality.
+    uint32_t CalmFrames;    /// The number of consecutive frames under budget.
+    uint32_t Carried;       /// The number of owed steps the current frame leaves for later frames.
+    uint64_t Frames;        /// The number of frames scheduled.
+    uint64_t OverBudget;    /// The number of frames that exceeded the budget.
+    uint64_t UnderBudget;   /// The number of frames well under the budget.
+    uint64_t Dropped;       /// The number of ticks discarded without being simulated.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Initializes a frame budget scheduler.
+/// @param budget The scheduler to initialize.
+/// @param step The length of a simulation tick, in seconds.
+/// @param frame_budget The wall-clock time per frame allowed for simulation.
+/// @param max_steps The most steps a single frame may run, at least 1.
+/// @param max_level The number of degradation levels the caller can apply,
+/// or 0 if the simulation must not be degraded.
+void frame_budget_init(frame_budget_t *budget, double step, double frame_budget, uint32_t max_steps, uint32_t max_level);
+
+/// @summary Determines the number of steps to run in the current frame, at
+/// most MaxSteps. Below the highest degradation level, the steps that do not
+/// fit remain in the accumulator for later frames, and the frame counts as
+/// over budget. At the highest level, the steps run are limited further to
+/// those expected to fit in the budget, and time that cannot be simulated is
+/// removed from the accumulator and counted as dropped ticks.
+/// @param budget The frame budget scheduler.
+/// @param accumulator The simulation time owed, in seconds.
+/// @return The number of steps to run.
+uint32_t frame_budget_begin(frame_budget_t *budget, double &accumulator);
+
+/// @summary Records the wall-clock cost of a single step.
+/// @param budget The frame budget scheduler.
+/// @param seconds The time taken by the step.
+void frame_budget_step(frame_budget_t *budget, double seconds);
+
+/// @summary Records the total simulation cost of a frame and updates the
+/// degradation level. A frame over budget, or one that left owed steps for
+/// later frames, raises the level.
+/// @param budget The frame budget scheduler.
+/// @param seconds The time taken by every step run in the frame.
+/// @return The degradation level to apply to the next frame.
+uint32_t frame_budget_end(frame_budget_t *budget, double seconds);
+
+#endif /* !defined(LL_BUDGET_HPP) */
@@ -0,0 +1,98 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to an event stream, a contiguous
+/// buffer of fixed-size records of a single kind. Producers on any number of
+/// threads append records with a single atomic increment; once every producer
+/// has finished, the consumer processes the whole buffer in one pass and then
+/// resets it for the next tick.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_EVENT_HPP
+#define LL_EVENT_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <atomic>
+#include "common.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary A buffer of records of a single kind. Count is the number of
+/// appends attempted since the last reset, and may exceed Capacity; records
+/// past Capacity are dropped, and the next reset grows the buffer so that the
+/// same demand fits.
+struct event_stream_t
+{
+    size_t              ElementSize; /// The size of a single record, in bytes.
+    size_t              Capacity;    /// The number of records the buffer can hold.
+    size_t              Dropped;     /// The total number of records dropped.
+    std::atomic<size_t> Count;       /// The number of appends since the last reset.
+    uint8_t            *Data;        /// Storage for Capacity records.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Allocates storage for an empty event stream.
+/// @param stream The stream to initialize.
+/// @param element_size The size of a single record, in bytes.
+/// @param capacity The number of records to allocate storage for.
+/// @return true if the stream was initialized.
+bool event_stream_create(event_stream_t *stream, size_t element_size, size_t capacity);
+
+/// @summary Frees the storage associated with an event stream.
+/// @param stream The stream to free.
+void event_stream_delete(event_stream_t *stream);
+
+/// @summary Discards every record and, if records were dropped since the last
+/// reset, grows the buffer to hold them. Must not be called while any thread
+/// may be appending.
+/// @param stream The event stream.
+void event_stream_reset(event_stream_t *stream);
+
+/// @summary Reserves storage for a single record. Safe to call from multiple
+/// threads at once.
+/// @param stream The event stream.
+/// @return A pointer to ElementSize bytes to be filled in, or NULL if the
+/// buffer is full and the record is dropped.
+inline void* event_stream_append(event_stream_t *stream)
+{
+    size_t index = stream->Count.fetch_add(1, std::memory_order_relaxed);
+    return index < stream->Capacity ? stream->Data + index * stream->ElementSize : NULL;
+}
+
+/// @summary Retrieves the number of records available to the consumer. Must
+/// not be called while any thread may be appending.
+/// @param stream The event stream.
+/// @return The number of records stored in the buffer.
+inline size_t event_stream_count(event_stream_t const *stream)
+{
+    size_t count = stream->Count.load(std::memory_order_relaxed);
+    return count < stream->Capacity ? count : stream->Capacity;
+}
+
+/// @summary Appends a typed record to a stream.
+/// @param stream An event stream whose ElementSize is sizeof(T).
+/// @param ev The record to copy into the stream.
+/// @return true if the record was stored, or false if it was dropped.
+template <typename T>
+inline bool event_stream_push(event_stream_t *stream, T const &ev)
+{
+    void *dst = event_stream_append(stream);
+    if (dst == NULL) return false;
+    *((T*) dst) = ev;
+    return true;
+}
+
+/// @summary Retrieves the records of a stream as a typed array.
+/// @param stream An event stream whose ElementSize is sizeof(T).
+/// @return A pointer to event_stream_count(stream) records.
+template <typename T>
+inline T const* event_stream_data(event_stream_t const *stream)
+{
+    return (T const*) stream->Data;
+}
+
+#endif /* !defined(LL_EVENT_HPP) */
@@ -36,6 +36,11 @@
 /// @summary Define the maximum number of joystick controllers.
 #define INPUT_MAX_CONTROLLERS        16
 
+/// @summary Define the default rate, in Hz, at which controller state is
+/// polled by input_controller_poll() once input_controller_poll_start() has
+/// been called. Well below the frame rate, so most frames skip the queries.
+#define INPUT_CONTROLLER_POLL_RATE   30U
+
 /// @summary Internal data associated with the input system attached to a window.
 struct input_context_t
 {
@@ -50,6 +55,19 @@ struct input_context_t
     uint32_t    KeyboardState[INPUT_KEY_WORDS];
 };
 
+/// @summary Represents the state of all attached controllers at a single
+/// point in time. Kept as a single block so it can be stored by
+/// input_controller_poll() and copied out by input_snapshot() with one memcpy.
+struct input_controllers_t
+{
+    size_t      ControllerCount;
+    int         ControllerIds[INPUT_MAX_CONTROLLERS];
+    size_t      ControllerAxisCount[INPUT_MAX_CONTROLLERS];
+    size_t      ControllerButtonCount[INPUT_MAX_CONTROLLERS];
+    float       ControllerAxes[INPUT_MAX_CONTROLLERS][INPUT_MAX_CONTROLLER_AXES];
+    uint8_t     ControllerButtons[INPUT_MAX_CONTROLLERS][INPUT_MAX_CONTROLLER_BUTTONS];
+};
+
 /// @summary Represents a snapshot of state for all input devices at a single point in time.
 struct input_snapshot_t
 {
@@ -62,12 +80,7 @@ struct input_snapshot_t
     uint32_t    MouseModifiers;
     uint32_t    KeyboardModifiers;
     uint32_t    KeyboardState[INPUT_KEY_WORDS];
-    size_t      ControllerCount;
-    int         ControllerIds[INPUT_MAX_CONTROLLERS];
-    size_t      ControllerAxisCount[INPUT_MAX_CONTROLLERS];
-    size_t      ControllerButtonCount[INPUT_MAX_CONTROLLERS];
-    float       ControllerAxes[INPUT_MAX_CONTROLLERS][INPUT_MAX_CONTROLLER_AXES];
-    uint8_t     ControllerButtons[INPUT_MAX_CONTROLLERS][INPUT_MAX_CONTROLLER_BUTTONS];
+    input_controllers_t Controllers;
 };
 
 /*///////////////
@@ -82,8 +95,45 @@ bool input_attach(GLFWwindow *window);
 void input_detach(GLFWwindow *window);
 
 /// @summary Grabs a snapshot of input device state for the specified window.
+/// If controller polling has been started, controller state is copied from
+/// the most recent poll; otherwise controllers are polled
+/// synchronously, and this function must be called on the main thread.
 /// @param dst The snapshot structure to populate.
 /// @param window The window whose input state is being queried.
 void input_snapshot(input_snapshot_t *dst, GLFWwindow *window);
 
+/// @summary Starts rate-limited controller polling. Controller state is then
+/// queried by input_controller_poll() no more than rate_hz times per-second
+/// and kept for input_snapshot(). Hotplug events are accumulated for
+/// retrieval with input_controller_events(). Like all of the controller
+/// functions, this must be called on the main thread.
+/// @param rate_hz The number of times per-second controllers are polled.
+/// @return true if controller polling is active.
+bool input_controller_poll_start(uint32_t rate_hz);
+
+/// @summary Stops controller polling. Subsequent calls to input_snapshot()
+/// poll controllers synchronously.
+void input_controller_poll_stop(void);
+
+/// @summary Determines whether rate-limited controller polling is active.
+/// @return true if input_snapshot() reads polled controller state.
+bool input_controller_poll_active(void);
+
+/// @summary Queries GLFW for the state of all attached controllers and
+/// stores it for input_snapshot(), if the configured polling interval has
+/// elapsed; otherwise returns immediately. GLFW does not guarantee that its
+/// joystick functions are thread-safe, and some platforms rebuild the joystick
+/// tables from within glfwPollEvents(), so this must only be called on the
+/// main thread.
+/// Call it once per iteration of the main loop, after glfwPollEvents().
+void input_controller_poll(void);
+
+/// @summary Retrieves and clears the controller hotplug events detected by
+/// input_controller_poll() since the previous call. Bit i is set if the controller
+/// with GLFW joystick identifier i was connected (or disconnected). A device
+/// plugged and unplugged between two calls reports both events.
+/// @param connect On return, stores the bitmap of connect events.
+/// @param disconnect On return, stores the bitmap of disconnect events.
+void input_controller_events(uint32_t *connect, uint32_t *disconnect);
+
 #endif /* !defined(LL_INPUT_HPP) */
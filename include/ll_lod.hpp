@@ -0,0 +1,90 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a simulation level-of-detail
+/// scheduler. Work is divided into groups, each assigned an importance tier
+/// by its owner every tick. Groups in tier 0 update every tick; groups in a
+/// lower tier update every Nth tick with a timestep covering every tick since
+/// their last update. Groups are staggered by a key, so a different slice of
+/// each tier updates on each tick and the cost is spread evenly.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_LOD_HPP
+#define LL_LOD_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The maximum number of importance tiers.
+#define LOD_MAX_TIERS                (4U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The schedule shared by every group of a single system. The tick
+/// counter and each group's last update tick are simulation state, and must
+/// be saved and restored along with the system that owns them.
+struct lod_scheduler_t
+{
+    uint64_t Tick;                   /// The current tick.
+    uint32_t Period[LOD_MAX_TIERS];  /// The number of ticks between updates in each tier.
+    uint64_t Considered;             /// The number of work items scheduled since the last reset.
+    uint64_t Updated;                /// The number of those items that were updated.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Initializes a scheduler in which every tier updates every tick.
+/// @param sched The scheduler to initialize.
+void lod_scheduler_init(lod_scheduler_t *sched);
+
+/// @summary Sets the update period of a tier. Tier 0 always has a period of 1.
+/// @param sched The scheduler.
+/// @param tier The tier, less than LOD_MAX_TIERS.
+/// @param period The number of ticks between updates, at least 1.
+void lod_scheduler_set_period(lod_scheduler_t *sched, uint32_t tier, uint32_t period);
+
+/// @summary Computes the fraction of scheduled work skipped since the last
+/// call to lod_scheduler_reset_stats.
+/// @param sched The scheduler.
+/// @return A value in [0, 1].
+float lod_scheduler_skipped(lod_scheduler_t const *sched);
+
+/// @summary Resets the work counters of a scheduler.
+/// @param sched The scheduler.
+void lod_scheduler_reset_stats(lod_scheduler_t *sched);
+
+/// @summary Determines whether a group updates on the current tick.
+/// @param sched The scheduler.
+/// @param tier The current tier of the group.
+/// @param key A value that staggers groups of the same tier, such as the
+/// index of the group.
+/// @param last The tick at which the group last updated.
+/// @return The number of ticks the group must advance by, or 0 if it is
+/// skipped this tick. A group that has waited a full period of its tier,
+/// which happens after it moves to a more important tier, is always due.
+inline uint32_t lod_scheduler_due(lod_scheduler_t const *sched, uint32_t tier, uint32_t key, uint64_t last)
+{
+    uint32_t period = sched->Period[tier < LOD_MAX_TIERS ? tier : LOD_MAX_TIERS - 1];
+    uint64_t wait   = sched->Tick - last;
+    if (wait >= period || ((sched->Tick + key) % period) == 0)
+        return uint32_t(wait);
+    return 0;
+}
+
+/// @summary Records the outcome of scheduling a group.
+/// @param sched The scheduler.
+/// @param items The number of work items in the group.
+/// @param updated true if the group was updated.
+inline void lod_scheduler_record(lod_scheduler_t *sched, size_t items, bool updated)
+{
+    sched->Considered += items;
+    sched->Updated    += updated ? items : 0;
+}
+
+#endif /* !defined(LL_LOD_HPP) */
@@ -0,0 +1,88 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to non-blocking UDP sockets. Only
+/// IPv4 is supported; addresses are kept in host byte order.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_NET_HPP
+#define LL_NET_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The largest datagram sent or received, in bytes. Datagrams this
+/// size are not fragmented on typical links.
+#define NET_MAX_DATAGRAM             (1200U)
+
+/// @summary The size of the IPv4 and UDP headers that accompany each datagram.
+#define NET_UDP_OVERHEAD             (28U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary An IPv4 endpoint.
+struct net_address_t
+{
+    uint32_t Host;         /// The IPv4 address, in host byte order.
+    uint16_t Port;         /// The port number, in host byte order.
+};
+
+/// @summary A non-blocking UDP socket.
+struct udp_socket_t
+{
+    int      Handle;       /// The socket descriptor, or -1.
+    uint64_t BytesSent;    /// The number of payload bytes sent.
+    uint64_t BytesRecv;    /// The number of payload bytes received.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Parses an endpoint of the form "a.b.c.d:port". The host may be
+/// omitted, as in ":port", in which case the loopback address is used.
+/// @param str The string to parse.
+/// @param addr On return, the parsed endpoint.
+/// @return true if the string was parsed.
+bool net_parse_address(char const *str, net_address_t *addr);
+
+/// @summary Checks whether two endpoints are equal.
+/// @param a The first endpoint.
+/// @param b The second endpoint.
+/// @return true if the endpoints are equal.
+inline bool net_address_equal(net_address_t const &a, net_address_t const &b)
+{
+    return a.Host == b.Host && a.Port == b.Port;
+}
+
+/// @summary Opens a non-blocking UDP socket bound to a local port.
+/// @param sock The socket to initialize.
+/// @param port The local port to bind, or 0 for any port.
+/// @return true if the socket was opened.
+bool udp_open(udp_socket_t *sock, uint16_t port);
+
+/// @summary Closes a UDP socket.
+/// @param sock The socket to close.
+void udp_close(udp_socket_t *sock);
+
+/// @summary Sends a datagram.
+/// @param sock The socket to send on.
+/// @param to The destination endpoint.
+/// @param data The payload.
+/// @param size The payload size, at most NET_MAX_DATAGRAM bytes.
+/// @return true if the datagram was handed to the network stack.
+bool udp_send(udp_socket_t *sock, net_address_t const &to, void const *data, size_t size);
+
+/// @summary Receives a pending datagram without blocking.
+/// @param sock The socket to receive on.
+/// @param from On return, the source endpoint.
+/// @param data The buffer that receives the payload.
+/// @param capacity The size of the buffer, in bytes.
+/// @return The size of the payload, or 0 if no datagram is pending.
+size_t udp_recv(udp_socket_t *sock, net_address_t *from, void *data, size_t capacity);
+
+#endif /* !defined(LL_NET_HPP) */
@@ -0,0 +1,143 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a loose quadtree used to index
+/// circles of widely varying size and density. Every node's bounds are twice
+/// the size of its cell, so a circle is stored in the cell containing its
+/// center at the deepest level whose cells are at least twice its diameter.
+/// The node is computed directly from the position and radius, which makes
+/// insertion and removal constant-time list operations plus a walk up the
+/// tree to maintain subtree counts. Unlike a uniform grid, dense clusters
+/// are split across deeper levels rather than piling into a few cells.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_QUADTREE_HPP
+#define LL_QUADTREE_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The maximum number of levels below the root.
+#define QUADTREE_MAX_DEPTH           (10U)
+
+/// @summary The index used to terminate item lists and to mark items that
+/// are not in the tree.
+#define QUADTREE_NIL                 (0xFFFFFFFFU)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The data read for each item visited by a query, kept together so
+/// that walking a node's list touches one cache line per item.
+struct quadtree_item_t
+{
+    float     X;           /// The x-coordinate of the center of the item.
+    float     Y;           /// The y-coordinate of the center of the item.
+    float     R;           /// The radius of the item.
+    uint32_t  Next;        /// The next item in the same node, or QUADTREE_NIL.
+};
+
+/// @summary A loose quadtree over a square region. Nodes are stored level by
+/// level, with level L holding a 2^L by 2^L array of cells in row-major
+/// order. Items are identified by caller-assigned indices below Capacity.
+/// Circles whose centers lie outside of the region are stored at the root,
+/// which is always searched, so queries remain correct if slower.
+struct quadtree_t
+{
+    float     OriginX;     /// The x-coordinate of the upper-left corner of the region.
+    float     OriginY;     /// The y-coordinate of the upper-left corner of the region.
+    float     Size;        /// The edge length of the region.
+    size_t    Depth;       /// The number of levels below the root.
+    size_t    NodeCount;   /// The total number of nodes in all levels.
+    size_t    Capacity;    /// The maximum number of items.
+    size_t    Count;       /// The number of items in the tree.
+    uint32_t *Head;        /// The first item stored in each node, or QUADTREE_NIL.
+    uint32_t *Total;       /// The number of items in the subtree rooted at each node.
+    uint32_t *Node;        /// The node holding each item, or QUADTREE_NIL.
+    uint32_t *Prev;        /// The previous item in the same node, or QUADTREE_NIL.
+    quadtree_item_t *Items;/// The circle and list link of each item.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Allocates storage for an empty loose quadtree.
+/// @param tree The tree to initialize.
+/// @param x The x-coordinate of the upper-left corner of the region.
+/// @param y The y-coordinate of the upper-left corner of the region.
+/// @param size The edge length of the square region.
+/// @param depth The number of levels below the root, at most QUADTREE_MAX_DEPTH.
+/// The smallest cells have an edge length of size / 2^depth.
+/// @param capacity The maximum number of items.
+/// @return true if the tree was initialized.
+bool quadtree_create(quadtree_t *tree, float x, float y, float size, size_t depth, size_t capacity);
+
+/// @summary Frees the storage associated with a loose quadtree.
+/// @param tree The tree to free.
+void quadtree_delete(quadtree_t *tree);
+
+/// @summary Removes every item from a loose quadtree.
+/// @param tree The tree to clear.
+void quadtree_clear(quadtree_t *tree);
+
+/// @summary Replaces the contents of a tree with items [0, count). This is
+/// faster than inserting the items one at a time when most of them move.
+/// @param tree The tree to rebuild.
+/// @param x The x-coordinate of the center of each item.
+/// @param y The y-coordinate of the center of each item.
+/// @param r The radius of each item.
+/// @param count The number of items, at most the tree capacity.
+void quadtree_build(quadtree_t *tree, float const *x, float const *y, float const *r, size_t count);
+
+/// @summary Inserts an item into the tree, or moves it if it is already present.
+/// Moving an item within the same node only updates its stored circle.
+/// @param tree The loose quadtree.
+/// @param item The item index, less than the tree capacity.
+/// @param x The x-coordinate of the center of the item.
+/// @param y The y-coordinate of the center of the item.
+/// @param r The radius of the item.
+void quadtree_update(quadtree_t *tree, uint32_t item, float x, float y, float r);
+
+/// @summary Removes an item from the tree. Items not in the tree are ignored.
+/// @param tree The loose quadtree.
+/// @param item The item index.
+void quadtree_remove(quadtree_t *tree, uint32_t item);
+
+/// @summary Finds every item whose circle overlaps a query circle.
+/// @param tree The loose quadtree.
+/// @param x The x-coordinate of the center of the query circle.
+/// @param y The y-coordinate of the center of the query circle.
+/// @param r The radius of the query circle.
+/// @param items An array of max_items elements receiving the overlapping items.
+/// @param max_items The maximum number of items to return.
+/// @return The number of items written to items.
+size_t quadtree_query_circle(quadtree_t const *tree, float x, float y, float r, uint32_t *items, size_t max_items);
+
+/// @summary Finds every item whose circle overlaps an axis-aligned rectangle.
+/// @param tree The loose quadtree.
+/// @param x0 The minimum x-coordinate of the rectangle.
+/// @param y0 The minimum y-coordinate of the rectangle.
+/// @param x1 The maximum x-coordinate of the rectangle.
+/// @param y1 The maximum y-coordinate of the rectangle.
+/// @param items An array of max_items elements receiving the overlapping items.
+/// @param max_items The maximum number of items to return.
+/// @return The number of items written to items.
+size_t quadtree_query_rect(quadtree_t const *tree, float x0, float y0, float x1, float y1, uint32_t *items, size_t max_items);
+
+/// @summary Finds the items whose centers are nearest to a point.
+/// @param tree The loose quadtree.
+/// @param x The x-coordinate of the point.
+/// @param y The y-coordinate of the point.
+/// @param k The maximum number of items to return.
+/// @param max_dist Items whose centers are farther than this are ignored.
+/// @param items An array of k elements receiving the items, nearest first.
+/// @param dist_sq An array of k elements receiving the squared distance to
+/// each item.
+/// @return The number of items found, at most k.
+size_t quadtree_nearest(quadtree_t const *tree, float x, float y, size_t k, float max_dist, uint32_t *items, float *dist_sq);
+
+#endif /* !defined(LL_QUADTREE_HPP) */
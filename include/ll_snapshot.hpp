@@ -0,0 +1,151 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a ring of simulation snapshots.
+/// Each saved tick is a flat byte buffer that systems append their state to
+/// with memcpy and read back in the same order. Buffers are allocated on first
+/// use and then reused from one save to the next, so once they have grown to
+/// the size of the world saving and restoring never allocate.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_SNAPSHOT_HPP
+#define LL_SNAPSHOT_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The default number of ticks retained by a snapshot ring; two
+/// seconds of simulation at 120 ticks per second.
+#define SNAPSHOT_DEFAULT_FRAMES      (240U)
+
+/// @summary The smallest allocation made for a snapshot buffer, in bytes.
+#define SNAPSHOT_DEFAULT_RESERVE     (1024U * 1024U)
+
+/// @summary The default limit on the memory held by a snapshot ring, in bytes.
+#define SNAPSHOT_DEFAULT_BUDGET      (256U * 1024U * 1024U)
+
+/// @summary The tick value of a snapshot buffer that holds no data.
+#define SNAPSHOT_INVALID_TICK        (~uint64_t(0))
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The saved state of the simulation for a single tick.
+struct snapshot_buffer_t
+{
+    uint64_t  Tick;        /// The tick saved in the buffer, or SNAPSHOT_INVALID_TICK.
+    uint8_t  *Data;        /// The saved state.
+    size_t    Size;        /// The number of bytes of saved state.
+    size_t    Capacity;    /// The number of bytes allocated for Data.
+    size_t    Cursor;      /// The read offset, in bytes.
+};
+
+/// @summary A fixed number of snapshot buffers. Tick t is stored in buffer
+/// t % FrameCount, so saving a tick evicts the one FrameCount ticks older.
+/// Once the buffers hold MaxBytes between them, saving a tick into an empty
+/// buffer takes the memory of the oldest saved tick instead of allocating.
+struct snapshot_ring_t
+{
+    snapshot_buffer_t *Frames;     /// The snapshot buffers.
+    size_t             FrameCount; /// The number of snapshot buffers.
+    size_t             MaxBytes;   /// The memory limit for all buffers, in bytes.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Allocates a snapshot ring. No buffer memory is allocated until a
+/// tick is saved.
+/// @param ring The ring to initialize.
+/// @param frame_count The largest number of ticks retained.
+/// @param max_bytes The memory limit for all buffers, in bytes. Fewer than
+/// frame_count ticks are retained if they do not fit.
+/// @return true if the ring was initialized.
+bool snapshot_ring_create(snapshot_ring_t *ring, size_t frame_count, size_t max_bytes);
+
+/// @summary Frees the storage associated with a snapshot ring.
+/// @param ring The ring to free.
+void snapshot_ring_delete(snapshot_ring_t *ring);
+
+/// @summary Discards every saved tick later than a given tick, for example
+/// after rewinding to it.
+/// @param ring The snapshot ring.
+/// @param tick The last tick to keep.
+void snapshot_ring_truncate(snapshot_ring_t *ring, uint64_t tick);
+
+/// @summary Retrieves an empty buffer to save a tick into, evicting the tick
+/// previously stored in it, and the oldest saved tick if the ring is at its
+/// memory limit.
+/// @param ring The snapshot ring.
+/// @param tick The tick being saved.
+/// @return The buffer to write to.
+snapshot_buffer_t* snapshot_ring_save(snapshot_ring_t *ring, uint64_t tick);
+
+/// @summary Retrieves the buffer holding a saved tick, positioned for reading
+/// from the start.
+/// @param ring The snapshot ring.
+/// @param tick The tick to restore.
+/// @return The buffer to read from, or NULL if the tick has not been saved
+/// or has been evicted.
+snapshot_buffer_t* snapshot_ring_find(snapshot_ring_t *ring, uint64_t tick);
+
+/// @summary Reserves space at the end of a snapshot buffer, growing it if
+/// necessary. The space must be filled before the next call.
+/// @param buffer The snapshot buffer.
+/// @param size The number of bytes to reserve.
+/// @return A pointer to the reserved space, or NULL if memory is exhausted.
+void* snapshot_reserve(snapshot_buffer_t *buffer, size_t size);
+
+/// @summary Appends bytes to a snapshot buffer.
+/// @param buffer The snapshot buffer.
+/// @param src The data to append.
+/// @param size The number of bytes to append.
+/// @return true if the data was written.
+bool snapshot_write(snapshot_buffer_t *buffer, void const *src, size_t size);
+
+/// @summary Retrieves a pointer to the next bytes of a snapshot buffer and
+/// advances past them.
+/// @param buffer The snapshot buffer.
+/// @param size The number of bytes to consume.
+/// @return A pointer to the data, or NULL if fewer than size bytes remain.
+void const* snapshot_view(snapshot_buffer_t *buffer, size_t size);
+
+/// @summary Copies the next bytes of a snapshot buffer and advances past them.
+/// @param buffer The snapshot buffer.
+/// @param dst The destination for the data.
+/// @param size The number of bytes to read.
+/// @return true if the data was read.
+bool snapshot_read(snapshot_buffer_t *buffer, void *dst, size_t size);
+
+/// @summary Computes a 64-bit hash of the contents of a snapshot buffer. Two
+/// simulations that saved identical state produce the same hash, which makes
+/// it suitable for detecting divergence between peers.
+/// @param buffer The snapshot buffer.
+/// @return The hash of the saved state.
+uint64_t snapshot_hash(snapshot_buffer_t const *buffer);
+
+/// @summary Appends a single value to a snapshot buffer.
+/// @param buffer The snapshot buffer.
+/// @param value The value to append.
+/// @return true if the value was written.
+template <typename T>
+inline bool snapshot_write_value(snapshot_buffer_t *buffer, T const &value)
+{
+    return snapshot_write(buffer, &value, sizeof(T));
+}
+
+/// @summary Reads a single value from a snapshot buffer.
+/// @param buffer The snapshot buffer.
+/// @param value On return, the value read.
+/// @return true if the value was read.
+template <typename T>
+inline bool snapshot_read_value(snapshot_buffer_t *buffer, T &value)
+{
+    return snapshot_read(buffer, &value, sizeof(T));
+}
+
+#endif /* !defined(LL_SNAPSHOT_HPP) */
@@ -0,0 +1,136 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a uniform grid used to answer
+/// neighbor queries over large sets of points. The grid is rebuilt from scratch
+/// with a counting sort whenever the points move, after which the points in
+/// any horizontal run of cells occupy a contiguous range of the sorted arrays
+/// and can be scanned with SIMD kernels. Z-order (Morton) codes and a radix
+/// sort are also provided so that callers can periodically put their own
+/// point storage into spatial order.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_SPATIAL_HPP
+#define LL_SPATIAL_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary A uniform grid of square cells covering a rectangular region.
+/// Points outside of the region are placed in the nearest edge cell, so
+/// queries remain correct (if slower) when points stray outside of it. Points
+/// may optionally carry a radius, in which case they are binned by center and
+/// MaxRadius tells queries how far beyond a cell its points may extend.
+struct spatial_grid_t
+{
+    float     OriginX;     /// The x-coordinate of the upper-left corner of the grid.
+    float     OriginY;     /// The y-coordinate of the upper-left corner of the grid.
+    float     CellSize;    /// The edge length of a cell.
+    float     InvCellSize; /// The reciprocal of the cell edge length.
+    size_t    CellsX;      /// The number of cells along the horizontal axis.
+    size_t    CellsY;      /// The number of cells along the vertical axis.
+    size_t    Capacity;    /// The maximum number of points.
+    size_t    Count;       /// The number of points in the most recent build.
+    float     MaxRadius;   /// The largest point radius in the most recent build.
+    uint32_t *CellStart;   /// Points in cell c are [CellStart[c], CellStart[c+1]).
+    uint32_t *Cursor;      /// Scratch storage used while building, one per cell.
+    void     *Memory;      /// The allocation backing the per-point arrays.
+    uint32_t *PointCell;   /// The cell of each point, in input order.
+    uint32_t *Items;       /// The input index of each point, in cell order.
+    float    *SortedX;     /// The x-coordinate of each point, in cell order.
+    float    *SortedY;     /// The y-coordinate of each point, in cell order.
+    float    *SortedR;     /// The radius of each point, in cell order.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Computes the column containing an x-coordinate, clamped to the grid.
+/// @param grid The spatial grid.
+/// @param x The x-coordinate.
+/// @return The column index, in [0, CellsX).
+inline size_t spatial_grid_column(spatial_grid_t const *grid, float x)
+{
+    float c = (x - grid->OriginX) * grid->InvCellSize;
+    if (c <= 0.0f) return 0;
+    if (c >= float(grid->CellsX - 1)) return grid->CellsX - 1;
+    return size_t(c);
+}
+
+/// @summary Computes the row containing a y-coordinate, clamped to the grid.
+/// @param grid The spatial grid.
+/// @param y The y-coordinate.
+/// @return The row index, in [0, CellsY).
+inline size_t spatial_grid_row(spatial_grid_t const *grid, float y)
+{
+    float r = (y - grid->OriginY) * grid->InvCellSize;
+    if (r <= 0.0f) return 0;
+    if (r >= float(grid->CellsY - 1)) return grid->CellsY - 1;
+    return size_t(r);
+}
+
+/// @summary Retrieves the range of sorted points lying in a horizontal run of
+/// cells within a single row.
+/// @param grid The spatial grid.
+/// @param row The row index.
+/// @param col0 The index of the first column in the run.
+/// @param col1 The index of the last column in the run, inclusive.
+/// @param begin On return, the index of the first point in the sorted arrays.
+/// @param end On return, the index one past the last point in the sorted arrays.
+inline void spatial_grid_run(spatial_grid_t const *grid, size_t row, size_t col0, size_t col1, size_t &begin, size_t &end)
+{
+    size_t base = row * grid->CellsX;
+    begin = grid->CellStart[base + col0];
+    end   = grid->CellStart[base + col1 + 1];
+}
+
+/// @summary Allocates storage for a spatial grid.
+/// @param grid The grid to initialize.
+/// @param x The x-coordinate of the upper-left corner of the region.
+/// @param y The y-coordinate of the upper-left corner of the region.
+/// @param width The width of the region.
+/// @param height The height of the region.
+/// @param cell_size The edge length of a cell.
+/// @param capacity The maximum number of points.
+/// @return true if the grid was initialized.
+bool spatial_grid_create(spatial_grid_t *grid, float x, float y, float width, float height, float cell_size, size_t capacity);
+
+/// @summary Frees the storage associated with a spatial grid.
+/// @param grid The grid to free.
+void spatial_grid_delete(spatial_grid_t *grid);
+
+/// @summary Sorts a set of points into the grid, replacing its contents.
+/// @param grid The grid to rebuild.
+/// @param x The x-coordinate of each point.
+/// @param y The y-coordinate of each point.
+/// @param r The radius of each point, or NULL if all points have zero radius.
+/// @param count The number of points, at most the grid capacity.
+void spatial_grid_build(spatial_grid_t *grid, float const *x, float const *y, float const *r, size_t count);
+
+/// @summary Computes the Z-order (Morton) code of each point by interleaving
+/// the bits of its coordinates, quantized to 16 bits across the grid region.
+/// Points that are close in space are usually close in code order.
+/// @param grid The spatial grid defining the region.
+/// @param x The x-coordinate of each point.
+/// @param y The y-coordinate of each point.
+/// @param count The number of points.
+/// @param codes An array of count elements receiving the code of each point.
+void spatial_morton_codes(spatial_grid_t const *grid, float const *x, float const *y, size_t count, uint32_t *codes);
+
+/// @summary Sorts 32-bit keys in ascending order with a stable LSD radix sort
+/// of four 8-bit digits, carrying the original index of each key. Digits that
+/// are the same for every key are skipped.
+/// @param keys The keys to sort. Overwritten.
+/// @param scratch_keys Scratch storage for count keys.
+/// @param order Storage for count indices.
+/// @param scratch_order Scratch storage for count indices.
+/// @param count The number of keys.
+/// @return Either order or scratch_order, whichever holds the original index
+/// of each key in sorted order.
+uint32_t* spatial_radix_sort(uint32_t *keys, uint32_t *scratch_keys, uint32_t *order, uint32_t *scratch_order, size_t count);
+
+#endif /* !defined(LL_SPATIAL_HPP) */
@@ -26,9 +26,28 @@
 /// This attribute is encoded as a packed 32-bit RGBA color value.
 #define SPRITE_PTC_LOCATION_CLR    (1)
 
+/// @summary The number of bits the blend mode is shifted left by within a
+/// sprite render state. The blend mode occupies the two most significant bits,
+/// and the application-defined state, such as a texture name, the remainder.
+#define SPRITE_BLEND_SHIFT         (30U)
+
+/// @summary The mask of the application-defined portion of a render state.
+#define SPRITE_STATE_MASK          ((1U << SPRITE_BLEND_SHIFT) - 1U)
+
 /*////////////////
 //  Data Types  //
 ////////////////*/
+/// @summary Define the blend modes supported by a sprite effect. The blend
+/// mode of each quad is stored in its render state, so quads with different
+/// blend modes can share a batch.
+enum sprite_blend_e
+{
+    SPRITE_BLEND_NONE          = 0,
+    SPRITE_BLEND_ALPHA         = 1,
+    SPRITE_BLEND_ADDITIVE      = 2,
+    SPRITE_BLEND_PREMULTIPLIED = 3
+};
+
 /// @summary A structure representing a single interleaved sprite vertex in
 /// the vertex buffer. The vertex encodes 2D screen space position, texture
 /// coordinate, and packed ABGR color values into 20 bytes per-vertex. The
@@ -41,49 +60,28 @@ struct sprite_vertex_ptc_t
 };
 #pragma pack(pop)
 
-/// @summary A structure representing the data required to describe a single
-/// sprite within the application. Each sprite is translated into four vertices
-/// and six indices. The application fills out a sprite descriptor and pushes
-/// it to the batch for later processing.
-struct sprite_t
-{
-    float    ScreenX;           /// Screen-space X coordinate of the origin.
-    float    ScreenY;           /// Screen-space Y coordinate of the origin.
-    float    OriginX;           /// Origin X-offset from the upper-left corner.
-    float    OriginY;           /// Origin Y-offset from the upper-left corner.
-    float    ScaleX;            /// The horizontal scale factor.
-    float    ScaleY;            /// The vertical scale factor.
-    float    Orientation;       /// The angle of orientation, in radians.
-    uint32_t TintColor;         /// The ABGR tint color.
-    uint32_t ImageX;            /// Y-offset of the upper-left corner of the source image.
-    uint32_t ImageY;            /// Y-offset of the upper-left corner of the source image.
-    uint32_t ImageWidth;        /// The width of the source image, in pixels.
-    uint32_t ImageHeight;       /// The height of the source image, in pixels.
-    uint32_t TextureWidth;      /// The width of the texture defining the source image.
-    uint32_t TextureHeight;     /// The height of the texture defining the source image.
-    uint32_t LayerDepth;        /// The layer depth of the sprite, increasing into the background.
-    uint32_t RenderState;       /// An application-defined render state identifier.
-};
-
 /// @summary A structure storing the data required to represent a sprite within
-/// the sprite batch. Sprites are transformed to quads when they are pushed to
-/// the sprite batch. Each quad definition is 64 bytes.
+/// the sprite batch. Sprites are written directly in this form when they are
+/// pushed to the sprite batch, so each sprite is stored once before vertex
+/// generation. Orientation is stored as a unit (cos, sin) pair so that vertex
+/// generation needs no trigonometry. Each quad definition is 60 bytes.
 struct squad_t
 {
     float    Source[4];         /// The XYWH rectangle on the source texture.
     float    Target[4];         /// The XYWH rectangle on the screen.
     float    Origin[2];         /// The XY origin point of rotation.
-    float    Scale[2];          /// Texture coordinate scale factors.
-    float    Orientation;       /// The angle of orientation, in radians.
+    float    Scale[2];          /// Texture coordinate scale factors, the reciprocal texture dimensions.
+    float    Rotation[2];       /// The cosine and sine of the angle of orientation.
     uint32_t TintColor;         /// The ABGR tint color.
 };
 
 /// @summary Data used for sorting buffered quads. Grouped together to improve
 /// cache usage by avoiding loading all of the data for a quad_t.
+/// Together the two fields form the 64-bit sort key of the quad.
 struct qsdata_t
 {
     uint32_t LayerDepth;        /// The layer depth of the sprite, increasing into the background.
-    uint32_t RenderState;       /// The render state associated with the sprite.
+    uint32_t RenderState;       /// The render state associated with the sprite, see sprite_render_state().
 };
 
 /// @summary A structure for buffering data associated with a set of sprites.
@@ -94,6 +92,8 @@ struct sprite_batch_t
     squad_t  *Quads;            /// Buffer for transformed quad data.
     qsdata_t *State;            /// Render state identifiers for each quad.
     uint32_t *Order;            /// Insertion order values for each quad.
+    uint32_t *SortOrder;        /// Scratch storage for insertion order values while sorting.
+    uint64_t *SortKeys;         /// Scratch storage for two sort keys per quad while sorting.
 };
 
 /// @summary A structure storing all of the data required to render sprites
@@ -102,11 +102,10 @@ struct sprite_effect_t
 {
     size_t    VertexCapacity;   /// The maximum number of vertices we can buffer.
     size_t    VertexOffset;     /// Current offset (in vertices) in buffer.
-    size_t    VertexSize;       /// Size of one vertex, in bytes.
     size_t    IndexCapacity;    /// The maximum number of indices we can buffer.
     size_t    IndexOffset;      /// Current offset (in indices) in buffer.
-    size_t    IndexSize;        /// Size of one index, in bytes.
     uint32_t  CurrentState;     /// The active render state identifier.
+    bool      HasState;         /// true if CurrentState has been applied.
     GLuint    VertexArray;      /// The VAO describing the vertex layout.
     GLuint    VertexBuffer;     /// Buffer object for dynamic vertex data.
     GLuint    IndexBuffer;      /// Buffer object for dynamic index data.
@@ -136,24 +135,6 @@ typedef void (*sprite_effect_setup_fn)(sprite_effect_t *effect, void *context);
 /// @param context Opaque data passed by the application.
 typedef void (*sprite_effect_apply_fn)(sprite_effect_t *effect, uint32_t render_state, void *context);
 
-/// @summary Generates and uploads vertex and index data for a batch of quads
-/// to the vertex and index buffers of an effect. The buffers act as circular
-/// buffers. If the end of the buffers is reached, as much data as possible is
-/// buffered, and the function returns.
-/// @param effect The effect to update.
-/// @param batch The source sprite batch.
-/// @param quad_offset The offset, in quads, of the first quad to read.
-/// @param quad_count The number of quads to read.
-/// @param base_index On return, this address is updated with the offset, in
-/// indices, of the first buffered primitive written to the index buffer.
-/// @return The number of quads actually buffered. May be less than @a count.
-size_t sprite_effect_buffer_data_ptc(
-    sprite_effect_t *effect,
-    sprite_batch_t  *batch,
-    size_t           quad_offset,
-    size_t           quad_count,
-    size_t          *base_index);
-
 /// @summary Wraps a set of function pointers used to apply effect-specific state.
 struct sprite_effect_apply_t
 {
@@ -161,6 +142,79 @@ struct sprite_effect_apply_t
     sprite_effect_apply_fn ApplyState;
 };
 
+/// @summary Primitive shape traits for quads, drawn as two triangles sharing
+/// a diagonal. The sprite_effect_* templates are parameterized by a shape,
+/// which names its primitive type, the number of vertices and indices each
+/// primitive expands into, and generates the indices.
+struct sprite_shape_quad_t
+{
+    typedef squad_t primitive_t;  /// The type of a single primitive.
+    static size_t vertex_count(void) { return 4; }
+    static size_t index_count(void)  { return 6; }
+
+    /// @summary Generates index data for a set of quads. Triangles are
+    /// specified using counter-clockwise winding.
+    /// @param buffer The destination buffer.
+    /// @param base_vertex The zero-based index of the first vertex of the batch.
+    /// This allows multiple batches to write into the same index buffer.
+    /// @param count The number of quads being generated.
+    template <typename TIndex>
+    static inline void generate_indices(typename TIndex::index_t *buffer, size_t base_vertex, size_t count)
+    {
+        typedef typename TIndex::index_t index_t;
+        index_t *dst  = buffer;
+        index_t  base = (index_t ) base_vertex;
+        for (size_t i = 0; i < count; ++i)
+        {
+            *dst++ = index_t(base + 1);
+            *dst++ = index_t(base + 0);
+            *dst++ = index_t(base + 2);
+            *dst++ = index_t(base + 2);
+            *dst++ = index_t(base + 0);
+            *dst++ = index_t(base + 3);
+            base  += 4;
+        }
+    }
+};
+
+/// @summary Vertex format traits for the position-texture-color layout. The
+/// sprite_effect_* templates are parameterized by a vertex format, which
+/// names its vertex type, configures the vertex array object and expands
+/// primitives into vertices, with one overload of generate_vertices for each
+/// shape it supports. Another format is added by defining a structure with
+/// the same members; no existing code needs to change.
+struct sprite_format_ptc_t
+{
+    typedef sprite_vertex_ptc_t vertex_t; /// The type of a single vertex.
+
+    /// @summary Configures the Vertex Array Object of an effect for the format.
+    /// @param effect The effect to configure.
+    static void setup_vao(sprite_effect_t *effect);
+
+    /// @summary Generates four transformed vertices for each of a set of quads.
+    /// @param buffer The buffer to which vertex data will be written.
+    /// @param quads The buffer from which quad attributes will be read.
+    /// @param indices An array of zero-based indices specifying the order in which to read quads from the quad buffer.
+    /// @param quad_offset The offset into the quad list of the first quad.
+    /// @param quad_count The number of quads to generate.
+    static void generate_vertices(vertex_t *buffer, squad_t const *quads, uint32_t const *indices, size_t quad_offset, size_t quad_count);
+};
+
+/// @summary Index type traits for 16-bit indices, which address up to 65536
+/// vertices per buffer.
+struct sprite_index_u16_t
+{
+    typedef uint16_t index_t;     /// The type of a single index.
+    static GLenum gl_type(void) { return GL_UNSIGNED_SHORT; }
+};
+
+/// @summary Index type traits for 32-bit indices.
+struct sprite_index_u32_t
+{
+    typedef uint32_t index_t;     /// The type of a single index.
+    static GLenum gl_type(void) { return GL_UNSIGNED_INT; }
+};
+
 /*//////////////
 //  Functors  //
 //////////////*/
@@ -231,6 +285,15 @@ struct by_render_state
 /*///////////////
 //  Functions  //
 ///////////////*/
+/// @summary Combines a blend mode and an application-defined render state.
+/// @param blend One of sprite_blend_e.
+/// @param state The application-defined state, less than SPRITE_STATE_MASK.
+/// @return The combined render state.
+inline uint32_t sprite_render_state(uint32_t blend, uint32_t state)
+{
+    return (blend << SPRITE_BLEND_SHIFT) | (state & SPRITE_STATE_MASK);
+}
+
 /// @summary Initializes a sprite batch with the specified capacity.
 /// @param batch The sprite batch.
 /// @param capacity The initial capacity of the batch, in quads.
@@ -259,62 +322,27 @@ inline void sort_sprite_batch(sprite_batch_t *batch)
     std::sort(batch->Order, batch->Order + batch->Count, cmp);
 }
 
-/// @summary Transforms a set of sprite definitions into a series of quad definitions.
-/// @param quads The buffer of quads to write to.
-/// @param sdata The buffer of state data to write to.
-/// @param indices The buffer of order indices to write to.
-/// @param quad_offset The zero-based index of the first quad to write.
-/// @param sprites The buffer of sprite definitions to read from.
-/// @param sprite_offset The zero-based index of the first sprite to read.
-/// @param count The number of sprite definitions to read.
-void generate_quads(
-    squad_t        *quads,
-    qsdata_t       *sdata,
-    uint32_t       *indices,
-    size_t          quad_offset,
-    sprite_t const *sprites,
-    size_t          sprite_offset,
-    size_t          sprite_count);
-
-/// @summary Generates transformed position-texture-color vertex data for a set, or subset, of quads.
-/// @param buffer The buffer to which vertex data will be written.
-/// @param buffer_offset The offset into the buffer of the first vertex.
-/// @param quads The buffer from which quad attributes will be read.
-/// @param indices An array of zero-based indices specifying the order in which to read quads from the quad buffer.
-/// @param quad_offset The offset into the quad list of the first quad.
-/// @param quad_count The number of quads to generate.
-void generate_quad_vertices_ptc(
-    void           *buffer,
-    size_t          buffer_offset,
-    squad_t const  *quads,
-    uint32_t const *indices,
-    size_t          quad_offset,
-    size_t          quad_count);
-
-/// @summary Generates index data for a set, or subset, of quads. Triangles are
-/// specified using counter-clockwise winding. Indices are 16-bit unsigned int.
-/// @param buffer The destination buffer.
-/// @param offset The offset into the buffer of the first index.
-/// @param base_vertex The zero-based index of the first vertex of the batch.
-/// This allows multiple batches to write into the same index buffer.
-/// @param quad_count The number of quads being generated.
-void generate_quad_indices_u16(void *buffer, size_t offset, size_t base_vertex, size_t quad_count);
-
-/// @summary Generates index data for a set, or subset, of quads. Triangles are
-/// specified using counter-clockwise winding. Indices are 32-bit unsigned int.
-/// @param buffer The destination buffer.
-/// @param offset The offset into the buffer of the first index.
-/// @param base_vertex The zero-based index of the first vertex of the batch.
-/// This allows multiple batches to write into the same index buffer.
-/// @param quad_count The number of quads being generated.
-void generate_quad_indices_u32(void *buffer, size_t offset, size_t base_vertex, size_t quad_count);
-
-/// @summary Creates the GPU resources required to buffer and render quads.
-/// @param effect The effect to initialize.
-/// @param quad_count The maximum number of quads that can be buffered.
-/// @param vertex_size The size of a single vertex, in bytes.
-/// @param index_size The size of a single index, in bytes.
-bool create_sprite_effect(sprite_effect_t *effect, size_t quad_count, size_t vertex_size, size_t index_size);
+/// @summary Sorts a sprite batch with a stable LSD radix sort of the 64-bit
+/// key formed by the layer depth and render state of each quad. Quads are
+/// ordered by layer, then by blend mode and render state within a layer, and
+/// quads with the same key keep their insertion order. Digits that are the
+/// same for every quad are skipped, so the sort usually makes only a few
+/// passes. On return, the order array lists the quads in sorted order.
+/// @param batch The sprite batch to sort.
+/// @param back_to_front true to draw layers with greater depth first, or
+/// false to draw layers with lesser depth first.
+void radix_sort_sprite_batch(sprite_batch_t *batch, bool back_to_front);
+
+/// @summary Appends quads to a sprite batch, growing it if necessary. The
+/// render state and insertion order of the new quads are written in the same
+/// pass, and the caller fills in the quad definitions.
+/// @param batch The sprite batch.
+/// @param count The number of quads to append.
+/// @param layer_depth The layer depth of the quads, increasing into the background.
+/// @param render_state The application-defined render state identifier of the quads.
+/// @return A pointer to the first of count uninitialized quad definitions,
+/// valid until the next call that adds to the batch.
+squad_t* sprite_batch_append(sprite_batch_t *batch, size_t count, uint32_t layer_depth, uint32_t render_state);
 
 /// @summary Releases the GPU resources used for buffering and rendering quads.
 /// @param effect The effect to destroy.
@@ -346,6 +374,12 @@ void sprite_effect_blend_premultiplied(sprite_effect_t *effect);
 /// @param height The viewport height.
 void sprite_effect_set_viewport(sprite_effect_t *effect, int width, int height);
 
+/// @summary Sets the blend state of an effect to one of the standard modes.
+/// The state changes do not take effect until the effect is (re)bound.
+/// @param effect The effect to update.
+/// @param blend One of sprite_blend_e.
+void sprite_effect_blend_mode(sprite_effect_t *effect, uint32_t blend);
+
 /// @summary Binds the vertex and index buffers of an effect for use in
 /// subsequent rendering commands.
 /// @param effect The effect being applied.
@@ -355,56 +389,232 @@ void sprite_effect_bind_buffers(sprite_effect_t *effect);
 /// @param effect The effect being applied.
 void sprite_effect_apply_blendstate(sprite_effect_t *effect);
 
-/// @summary Configures the Vertex Array Object for an effect using the standard
-/// Position-TexCoord-Color layout configuration.
-void sprite_effect_setup_vao_ptc(sprite_effect_t *effect);
+/// @summary Creates the GPU resources required to buffer and render primitives
+/// with a given vertex format, shape and index type, and configures the
+/// vertex array. Blending is initially disabled.
+/// @param effect The effect to initialize.
+/// @param primitive_count The maximum number of primitives that can be buffered.
+/// @return true if the effect was created.
+template <typename TFormat, typename TShape, typename TIndex>
+inline bool create_sprite_effect(sprite_effect_t *effect, size_t primitive_count)
+{
+    typedef typename TFormat::vertex_t vertex_t;
+    typedef typename TIndex::index_t   index_t;
+
+    GLuint  vao        =  0;
+    GLuint  buffers[2] = {0, 0};
+    size_t  vcount     = primitive_count * TShape::vertex_count();
+    size_t  icount     = primitive_count * TShape::index_count();
+    GLsizei abo_size   = GLsizei(vcount * sizeof(vertex_t));
+    GLsizei eao_size   = GLsizei(icount * sizeof(index_t));
+
+    // @todo: error handling.
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, abo_size, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, eao_size, NULL, GL_DYNAMIC_DRAW);
+    glGenVertexArrays(1, &vao);
+
+    effect->VertexCapacity = vcount;
+    effect->VertexOffset   = 0;
+    effect->IndexCapacity  = icount;
+    effect->IndexOffset    = 0;
+    effect->CurrentState   = 0;
+    effect->HasState       = false;
+    effect->VertexArray    = vao;
+    effect->VertexBuffer   = buffers[0];
+    effect->IndexBuffer    = buffers[1];
+    effect->BlendColor[0]  = 0.0f;
+    effect->BlendColor[1]  = 0.0f;
+    effect->BlendColor[2]  = 0.0f;
+    effect->BlendColor[3]  = 0.0f;
+    sprite_effect_blend_none(effect);
+    TFormat::setup_vao(effect);
+    return true;
+}
 
-/// @summary Generates and uploads vertex and index data for a batch of quads
-/// to the vertex and index buffers of an effect. The buffers act as circular
-/// buffers. If the end of the buffers is reached, as much data as possible is
-/// buffered, and the function returns.
-/// @param effect The effect to update.
-/// @param quads The source quad definitions.
-/// @param indices An array of zero-based indices specifying the order in which to read quads from the quad buffer.
-/// @param quad_offset The offset, in quads, of the first quad to read.
-/// @param quad_count The number of quads to read.
-/// @param base_index On return, this address is updated with the offset, in
+/// @summary Generates and uploads vertex and index data for a batch of
+/// primitives to the vertex and index buffers of an effect. The buffers act
+/// as circular buffers. If the end of the buffers is reached, as much data as
+/// possible is buffered, and the function returns.
+/// @param effect The effect to update, created with the same format, shape and index type.
+/// @param prims The source primitive definitions.
+/// @param indices An array of zero-based indices specifying the order in which to read primitives.
+/// @param prim_offset The offset, in primitives, of the first primitive to read.
+/// @param prim_count The number of primitives to read.
+/// @param base_index_arg On return, this address is updated with the offset, in
 /// indices, of the first buffered primitive written to the index buffer.
-/// @return The number of quads actually buffered. May be less than @a count.
-size_t sprite_effect_buffer_data_ptc(
-    sprite_effect_t *effect,
-    squad_t const   *quads,
-    uint32_t const  *indices,
-    size_t           quad_offset,
-    size_t           quad_count,
-    size_t          *base_index);
+/// @return The number of primitives actually buffered. May be less than @a prim_count.
+template <typename TFormat, typename TShape, typename TIndex>
+inline size_t sprite_effect_buffer_data(
+    sprite_effect_t                        *effect,
+    typename TShape::primitive_t const     *prims,
+    uint32_t const                         *indices,
+    size_t                                  prim_offset,
+    size_t                                  prim_count,
+    size_t                                 *base_index_arg)
+{
+    typedef typename TFormat::vertex_t vertex_t;
+    typedef typename TIndex::index_t   index_t;
+    size_t const vertex_count = TShape::vertex_count();
+    size_t const index_count  = TShape::index_count();
 
-/// @summary Renders an entire sprite batch with a given effect.
-/// @param effect The effect being applied.
-/// @param batch The sprite batch being rendered.
-/// @param fxfuncs The effect-specific functions for applying render state.
-/// @param context Opaque data defined by the application.
-void sprite_effect_draw_batch_ptc(
-    sprite_effect_t             *effect,
-    sprite_batch_t              *batch,
-    sprite_effect_apply_t const *fxfuncs,
-    void                        *context);
+    if (effect->VertexOffset == effect->VertexCapacity)
+    {
+        // the buffer is completely full. time to discard it and
+        // request a new buffer from the driver, to avoid stalls.
+        GLsizei abo_size     = effect->VertexCapacity * sizeof(vertex_t);
+        GLsizei eao_size     = effect->IndexCapacity  * sizeof(index_t);
+        effect->VertexOffset = 0;
+        effect->IndexOffset  = 0;
+        glBufferData(GL_ARRAY_BUFFER, abo_size, NULL, GL_DYNAMIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, eao_size, NULL, GL_DYNAMIC_DRAW);
+    }
+
+    size_t num_indices  = prim_count * index_count;
+    size_t num_vertices = prim_count * vertex_count;
+    size_t max_vertices = effect->VertexCapacity;
+    size_t base_vertex  = effect->VertexOffset;
+    size_t max_indices  = effect->IndexCapacity;
+    size_t base_index   = effect->IndexOffset;
+    if (max_vertices < base_vertex + num_vertices)
+    {
+        // not enough space in the buffer to fit everything.
+        // only a portion of the desired data will be buffered.
+        num_vertices = max_vertices - base_vertex;
+        num_indices  = max_indices  - base_index;
+    }
+
+    size_t buffer_count =  num_vertices / vertex_count;
+    if (buffer_count == 0) return 0;
+
+    GLintptr   v_offset = base_vertex  * sizeof(vertex_t);
+    GLsizeiptr v_size   = num_vertices * sizeof(vertex_t);
+    GLbitfield v_access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    GLvoid    *v_data   = glMapBufferRange(GL_ARRAY_BUFFER, v_offset, v_size, v_access);
+    if (v_data != NULL)
+    {
+        TFormat::generate_vertices((vertex_t*) v_data, prims, indices, prim_offset, buffer_count);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    GLintptr   i_offset = base_index  * sizeof(index_t);
+    GLsizeiptr i_size   = num_indices * sizeof(index_t);
+    GLbitfield i_access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    GLvoid    *i_data   = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, i_offset, i_size, i_access);
+    if (i_data != NULL)
+    {
+        TShape::template generate_indices<TIndex>((index_t*) i_data, base_vertex, buffer_count);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+
+    effect->VertexOffset += buffer_count * vertex_count;
+    effect->IndexOffset  += buffer_count * index_count;
+    *base_index_arg       = base_index;
+    return buffer_count;
+}
 
 /// @summary Renders a portion of a sprite batch for which the vertex and index
 /// data has already been buffered. This function is generally not called by
-/// the user directly; it is called internally from sprite_effect_draw_batch_ptc().
+/// the user directly; it is called internally from sprite_effect_draw_batch().
+/// The blend mode is applied between sub-batches whenever it changes, and the
+/// application-defined portion of the render state is passed to ApplyState.
 /// @param effect The effect being applied.
 /// @param batch The sprite batch being rendered.
 /// @param quad_offset The index of the first quad in the batch to be rendered.
 /// @param quad_count The number of quads to draw.
 /// @param base_index The first index to read from the index buffer.
-void sprite_effect_draw_batch_region_ptc(
+/// @param fxfuncs The effect-specific functions for applying render state.
+/// @param context Opaque data defined by the application.
+template <typename TShape, typename TIndex>
+inline void sprite_effect_draw_batch_region(
     sprite_effect_t             *effect,
     sprite_batch_t              *batch,
     size_t                       quad_offset,
     size_t                       quad_count,
     size_t                       base_index,
     sprite_effect_apply_t const *fxfuncs,
-    void                        *context);
+    void                        *context)
+{
+    #define GLPTR(x)  (GLvoid const*)(x)
+    uint32_t state_0 = effect->CurrentState;
+    uint32_t state_1 = effect->CurrentState;
+    bool     applied = effect->HasState;
+    size_t   index   = 0; // index of start of sub-batch
+    size_t   nquad   = 0; // count of quads in sub-batch
+    size_t   nindex  = 0; // count of indices in sub-batch
+    size_t   quad_id = 0; // quad insertion index
+    size_t   size    = sizeof(typename TIndex::index_t);
+    GLenum   type    = TIndex::gl_type();
+
+    for (size_t i = 0; i < quad_count; ++i)
+    {
+        quad_id = batch->Order[quad_offset + i];
+        state_1 = batch->State[quad_id].RenderState;
+        if (!applied || state_1 != state_0)
+        {
+            // render the previous sub-batch with the current state,
+            // as long as it has at least one quad in the sub-batch.
+            if (i > index)
+            {
+                nquad  = i - index;  // the number of quads being submitted
+                nindex = nquad * TShape::index_count(); // the number of indices being submitted
+                glDrawElements(GL_TRIANGLES, nindex, type, GLPTR(base_index * size));
+                base_index += nindex;
+            }
+            // now apply the new state and start a new sub-batch. the blend
+            // mode is only changed when it differs from the previous quad.
+            uint32_t blend = state_1 >> SPRITE_BLEND_SHIFT;
+            if (!applied || blend != (state_0 >> SPRITE_BLEND_SHIFT))
+            {
+                sprite_effect_blend_mode(effect, blend);
+                sprite_effect_apply_blendstate(effect);
+            }
+            fxfuncs->ApplyState(effect, state_1 & SPRITE_STATE_MASK, context);
+            state_0 = state_1;
+            applied = true;
+            index   = i;
+        }
+    }
+    // submit the remainder of the sub-batch.
+    nquad  = quad_count - index;
+    nindex = nquad * TShape::index_count();
+    glDrawElements(GL_TRIANGLES, nindex, type, GLPTR(base_index * size));
+    effect->CurrentState = state_1;
+    effect->HasState     = applied;
+    #undef GLPTR
+}
+
+/// @summary Renders an entire sprite batch with a given effect.
+/// @param effect The effect being applied, created with the same format and
+/// index type, and sprite_shape_quad_t.
+/// @param batch The sprite batch being rendered.
+/// @param fxfuncs The effect-specific functions for applying render state.
+/// @param context Opaque data defined by the application.
+template <typename TFormat, typename TIndex>
+inline void sprite_effect_draw_batch(
+    sprite_effect_t             *effect,
+    sprite_batch_t              *batch,
+    sprite_effect_apply_t const *fxfuncs,
+    void                        *context)
+{
+    size_t quad_count = batch->Count;
+    size_t quad_index = 0;
+    size_t base_index = 0;
+    size_t n          = 0;
+
+    fxfuncs->SetupEffect(effect, context);
+    effect->HasState = false;
+
+    while (quad_count > 0)
+    {
+        n = sprite_effect_buffer_data<TFormat, sprite_shape_quad_t, TIndex>(effect, batch->Quads, batch->Order, quad_index, quad_count, &base_index);
+        sprite_effect_draw_batch_region<sprite_shape_quad_t, TIndex>(effect, batch, quad_index, n, base_index, fxfuncs, context);
+        base_index  = effect->IndexOffset;
+        quad_index += n;
+        quad_count -= n;
+    }
+}
 
 #endif /* !defined(LL_SPRITE_HPP) */
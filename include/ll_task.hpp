@@ -0,0 +1,64 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a persistent pool of worker
+/// threads used to split data-parallel loops across the available cores.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_TASK_HPP
+#define LL_TASK_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Define the maximum number of worker threads in a task pool.
+#define TASK_MAX_WORKERS             32
+
+/// @summary Signature for a function that processes the range [begin, end) of
+/// a data-parallel loop. The function may be invoked concurrently from several
+/// threads, each with a disjoint range.
+/// @param begin The index of the first item to process.
+/// @param end The index one past the last item to process.
+/// @param context Opaque data passed by the application.
+typedef void (*task_range_fn)(size_t begin, size_t end, void *context);
+
+/// @summary Opaque state associated with a pool of worker threads.
+struct task_pool_t;
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Creates a pool of worker threads. The threads sleep until work
+/// is submitted through task_pool_parallel_for().
+/// @param worker_count The number of worker threads to create, or zero to
+/// create one fewer than the number of hardware threads. The calling thread
+/// also participates in each loop.
+/// @return The new pool, or NULL if the pool could not be created.
+task_pool_t* task_pool_create(size_t worker_count = 0);
+
+/// @summary Stops all worker threads and frees the pool.
+/// @param pool The pool returned by task_pool_create().
+void task_pool_delete(task_pool_t *pool);
+
+/// @summary Retrieves the number of threads, including the calling thread,
+/// that execute the items of a loop.
+/// @param pool The pool to query. May be NULL, in which case 1 is returned.
+/// @return The number of threads that share the work of a loop.
+size_t task_pool_concurrency(task_pool_t const *pool);
+
+/// @summary Executes a data-parallel loop over [0, count), splitting the range
+/// into chunks of at least min_chunk items. Returns when all items have been
+/// processed. If pool is NULL or the range is small, the function runs on the
+/// calling thread. Must not be called concurrently for the same pool.
+/// @param pool The pool used to execute the loop. May be NULL.
+/// @param count The number of items in the loop.
+/// @param min_chunk The minimum number of items processed per invocation.
+/// @param func The function invoked to process each chunk.
+/// @param context Opaque data passed through to func.
+void task_pool_parallel_for(task_pool_t *pool, size_t count, size_t min_chunk, task_range_fn func, void *context);
+
+#endif /* !defined(LL_TASK_HPP) */
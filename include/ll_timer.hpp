@@ -0,0 +1,159 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the low-level interface to a hierarchical timing wheel.
+/// Timers are measured in whole simulation ticks. Scheduling and cancelling a
+/// timer are constant-time list operations, and advancing the wheel touches
+/// only the timers that expire, plus one slot of timers that move down a level
+/// every 64 ticks. Expired timers are delivered in batches, one callback per
+/// timer kind, so a tick in which nothing expires costs a single slot check.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef LL_TIMER_HPP
+#define LL_TIMER_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The number of bits of the deadline resolved by each level.
+#define TIMER_WHEEL_BITS             (6U)
+
+/// @summary The number of slots in each level of the wheel.
+#define TIMER_WHEEL_SLOTS            (1U << TIMER_WHEEL_BITS)
+
+/// @summary The number of levels in the wheel. Four levels of 64 slots cover
+/// 2^24 ticks, or about 38 hours at 120 ticks per second.
+#define TIMER_WHEEL_LEVELS           (4U)
+
+/// @summary The longest delay that can be scheduled, in ticks. Longer delays
+/// are clamped to this value.
+#define TIMER_MAX_DELAY              ((1ULL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1ULL)
+
+/// @summary The number of distinct timer kinds, each with its own callback.
+#define TIMER_MAX_KINDS              (16U)
+
+/// @summary The handle value that never refers to a timer.
+#define TIMER_INVALID_HANDLE         (0U)
+
+/// @summary The index used to terminate a timer list.
+#define TIMER_NIL                    (0xFFFFFFFFU)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Identifies a scheduled timer. The low 24 bits hold the node index
+/// plus one and the high 8 bits hold the generation of the node, so handles
+/// to timers that have fired or been cancelled are detected as stale.
+typedef uint32_t timer_handle_t;
+
+/// @summary Signature for the function that receives every timer of a single
+/// kind that expired during a tick. The function may schedule new timers.
+/// @param payloads The payload of each expired timer. The order is unspecified
+/// but identical for identical sequences of calls, so it is deterministic.
+/// @param count The number of expired timers.
+/// @param context Opaque data supplied when the callback was registered.
+typedef void (*timer_fire_fn)(uint32_t const *payloads, size_t count, void *context);
+
+/// @summary A single timer. Free nodes are chained through Next.
+struct timer_node_t
+{
+    uint64_t Deadline;       /// The tick at which the timer expires.
+    uint32_t Next;           /// The next node in the same slot, or TIMER_NIL.
+    uint32_t Prev;           /// The previous node in the same slot, or TIMER_NIL.
+    uint32_t Payload;        /// Application data passed to the callback.
+    uint16_t Slot;           /// The index of the slot list holding the node.
+    uint8_t  Kind;           /// The kind of timer, selecting the callback.
+    uint8_t  Generation;     /// Incremented each time the node is freed.
+};
+
+/// @summary The state of a hierarchical timing wheel. The slot lists and the
+/// node storage are plain data and may be copied directly into a snapshot.
+struct timer_wheel_t
+{
+    uint64_t       Now;      /// The current tick.
+    size_t         Count;    /// The number of pending timers.
+    size_t         Used;     /// The number of nodes ever allocated.
+    size_t         Capacity; /// The number of nodes in Nodes.
+    uint32_t       FreeHead; /// The first free node below Used, or TIMER_NIL.
+    timer_node_t  *Nodes;    /// Storage for every timer.
+    uint32_t       Slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS]; /// The head of each slot list.
+    uint32_t      *Batch;    /// Payloads of the timers expiring this tick, grouped by kind.
+    size_t         BatchCapacity;                 /// The number of entries in Batch.
+    timer_fire_fn  Callbacks[TIMER_MAX_KINDS];    /// The callback for each kind.
+    void          *Contexts[TIMER_MAX_KINDS];     /// The context for each callback.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Converts a duration to a whole number of ticks, rounding up so
+/// that a timer never expires early. Durations within a millionth of a tick
+/// of a whole number are not rounded up, since 0.1 / (1 / 120) is slightly
+/// more than 12 in floating point.
+/// @param seconds The duration, in seconds.
+/// @param tick_length The length of a tick, in seconds.
+/// @return The duration, in ticks.
+inline uint64_t timer_ticks(double seconds, double tick_length)
+{
+    double ticks = seconds / tick_length - 1.0e-6;
+    if (ticks <= 0.0) return 0;
+    uint64_t   n = uint64_t(ticks);
+    return (double(n) < ticks) ? n + 1 : n;
+}
+
+/// @summary Initializes an empty timing wheel.
+/// @param wheel The wheel to initialize.
+/// @param capacity The number of timers to allocate storage for. Storage
+/// grows as needed when more timers are scheduled.
+/// @return true if the wheel was initialized.
+bool timer_wheel_create(timer_wheel_t *wheel, size_t capacity);
+
+/// @summary Frees the storage associated with a timing wheel.
+/// @param wheel The wheel to free.
+void timer_wheel_delete(timer_wheel_t *wheel);
+
+/// @summary Ensures that storage is available for a number of timer nodes.
+/// @param wheel The timing wheel.
+/// @param capacity The number of nodes required.
+/// @return true if the storage is available.
+bool timer_wheel_reserve(timer_wheel_t *wheel, size_t capacity);
+
+/// @summary Sets the function invoked for expired timers of a given kind.
+/// @param wheel The timing wheel.
+/// @param kind The timer kind, less than TIMER_MAX_KINDS.
+/// @param callback The function to invoke, or NULL to discard the timers.
+/// @param context Opaque data passed through to callback.
+void timer_wheel_register(timer_wheel_t *wheel, uint32_t kind, timer_fire_fn callback, void *context);
+
+/// @summary Schedules a timer.
+/// @param wheel The timing wheel.
+/// @param kind The timer kind, less than TIMER_MAX_KINDS.
+/// @param payload Application data passed to the callback.
+/// @param delay The number of ticks until the timer expires. A delay of zero
+/// is treated as one, so the timer expires on the next call to advance.
+/// @return A handle to the timer, or TIMER_INVALID_HANDLE if memory is exhausted.
+timer_handle_t timer_wheel_schedule(timer_wheel_t *wheel, uint32_t kind, uint32_t payload, uint64_t delay);
+
+/// @summary Cancels a pending timer.
+/// @param wheel The timing wheel.
+/// @param handle The handle returned by timer_wheel_schedule.
+/// @return true if the timer was pending and has been cancelled.
+bool timer_wheel_cancel(timer_wheel_t *wheel, timer_handle_t handle);
+
+/// @summary Retrieves the number of ticks until a pending timer expires.
+/// @param wheel The timing wheel.
+/// @param handle The handle returned by timer_wheel_schedule.
+/// @return The number of ticks remaining, or zero if the timer is not pending.
+uint64_t timer_wheel_remaining(timer_wheel_t const *wheel, timer_handle_t handle);
+
+/// @summary Advances the wheel by one tick and invokes the callback of each
+/// kind that has expired timers, in order of kind.
+/// @param wheel The timing wheel.
+/// @return The number of timers that expired.
+size_t timer_wheel_advance(timer_wheel_t *wheel);
+
+#endif /* !defined(LL_TIMER_HPP) */
@@ -0,0 +1,166 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines deterministic lockstep play between several instances of
+/// the game. Each instance runs the full simulation; only the input of each
+/// player for each tick is exchanged, delta-encoded against the previous tick,
+/// bit-packed and run-length compressed. Inputs are scheduled a fixed number
+/// of ticks in the future to hide latency, and instances periodically compare
+/// hashes of their simulation state to detect divergence.
+///
+/// Every instance must compute bit-identical results from the same input.
+/// SSE and AVX builds do: the vector kernels round lane by lane, reductions
+/// add in a fixed order whatever the vector width, and the Makefile builds
+/// with -ffp-contract=off so that no multiply and add is fused. Builds with
+/// GW_MATH_SSE=0 reduce trig arguments differently and cannot play with SIMD
+/// builds, and builds linked with a different libm may round powf differently.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_LOCKSTEP_HPP
+#define GW_LOCKSTEP_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "ll_input.hpp"
+#include "ll_net.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The maximum number of players in a session.
+#define LOCKSTEP_MAX_PLAYERS         (4U)
+
+/// @summary The number of ticks of input retained for each player. Must be a
+/// power of two.
+#define LOCKSTEP_WINDOW              (256U)
+
+/// @summary The default number of ticks between sampling local input and
+/// applying it; 83 milliseconds at 120 ticks per second. Input must reach the
+/// other instances within this time, so it covers LOCKSTEP_SEND_PERIOD plus
+/// about 16 milliseconds of network latency.
+#define LOCKSTEP_DEFAULT_DELAY       (10U)
+
+/// @summary The number of ticks between state hash comparisons.
+#define LOCKSTEP_HASH_INTERVAL       (60U)
+
+/// @summary The number of local state hashes retained for comparison.
+#define LOCKSTEP_HASH_HISTORY        (16U)
+
+/// @summary The minimum time between packets sent to each peer, in seconds.
+/// Every packet repeats all unacknowledged input, so lost packets are covered
+/// by the next one. At this rate the 28 bytes of UDP/IP header on each packet
+/// cost 420 bytes per second, about as much as the input itself.
+#define LOCKSTEP_SEND_PERIOD         (1.0 / 15.0)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The portion of an input_snapshot_t that affects the simulation,
+/// quantized so that every instance sees exactly the same values.
+struct lockstep_input_t
+{
+    int16_t  MouseX;                    /// The cursor x-coordinate, in whole world units.
+    int16_t  MouseY;                    /// The cursor y-coordinate, in whole world units.
+    uint8_t  MouseButtons;              /// One bit per mouse button.
+    uint8_t  Modifiers;                 /// The GLFW keyboard modifier bits.
+    uint32_t Keys[INPUT_KEY_WORDS];     /// One bit per key, as in input_snapshot_t.
+};
+
+/// @summary The state tracked for each player in a session.
+struct lockstep_player_t
+{
+    net_address_t Address;              /// The endpoint of the instance controlling the player.
+    uint32_t      Received;             /// The number of leading ticks of input available for the player.
+    uint32_t      Acked;                /// The number of ticks of local input the player's instance holds.
+    uint32_t      HashTick;             /// The most recent tick hashed by the player's instance, or 0.
+    uint64_t      Hash;                 /// The state hash reported for HashTick.
+    uint32_t      HashSent;             /// The tick of the local state hash being sent to the player's instance.
+    uint32_t      HashMark;             /// Local.Received when HashSent was first sent; an Acked past it means the hash arrived.
+    double        LastSend;             /// The time the last packet was sent to the player's instance.
+};
+
+/// @summary The state of a lockstep session.
+struct lockstep_t
+{
+    udp_socket_t      Socket;           /// The socket bound to the local endpoint.
+    size_t            PlayerCount;      /// The number of players in the session.
+    size_t            LocalPlayer;      /// The index of the player controlled by this instance.
+    uint32_t          Delay;            /// The input delay, in ticks.
+    uint32_t          Tick;             /// The next tick to be simulated.
+    uint64_t          PacketsSent;      /// The number of packets sent.
+    uint32_t          DesyncTick;       /// The first tick found to differ between instances, or 0.
+    uint32_t          HashTicks[LOCKSTEP_HASH_HISTORY]; /// The ticks of the retained local hashes.
+    uint64_t          Hashes[LOCKSTEP_HASH_HISTORY];    /// The retained local hashes.
+    lockstep_player_t Players[LOCKSTEP_MAX_PLAYERS];    /// The per-player state.
+    lockstep_input_t  Inputs[LOCKSTEP_MAX_PLAYERS][LOCKSTEP_WINDOW]; /// Input for tick t is at t % LOCKSTEP_WINDOW.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Quantizes the simulation-relevant portion of an input snapshot.
+/// @param dst On return, the quantized input.
+/// @param src The input snapshot.
+void lockstep_input_from_snapshot(lockstep_input_t *dst, input_snapshot_t const *src);
+
+/// @summary Expands a quantized input into an input snapshot. Fields that do
+/// not affect the simulation are left unchanged.
+/// @param dst The input snapshot to update.
+/// @param src The quantized input.
+void lockstep_input_to_snapshot(input_snapshot_t *dst, lockstep_input_t const *src);
+
+/// @summary Starts a lockstep session. Every instance must be given the same
+/// list of endpoints and delay; the endpoint at local_player is bound. Input
+/// for the first delay ticks is empty for every player.
+/// @param ls The session to initialize.
+/// @param endpoints The endpoint of the instance controlling each player.
+/// @param player_count The number of players, at most LOCKSTEP_MAX_PLAYERS.
+/// @param local_player The index of the player controlled by this instance.
+/// @param delay The input delay, in ticks, less than LOCKSTEP_WINDOW / 2.
+/// @return true if the session was started.
+bool lockstep_create(lockstep_t *ls, net_address_t const *endpoints, size_t player_count, size_t local_player, uint32_t delay);
+
+/// @summary Ends a lockstep session.
+/// @param ls The session to end.
+void lockstep_delete(lockstep_t *ls);
+
+/// @summary Schedules local input for the first tick that does not yet have
+/// any, which is Tick + Delay in steady state.
+/// @param ls The session.
+/// @param input The local input.
+/// @return false if too much input is unacknowledged to accept more.
+bool lockstep_submit(lockstep_t *ls, lockstep_input_t const *input);
+
+/// @summary Checks whether input from every player is available for a tick,
+/// and marks older ticks as no longer needed.
+/// @param ls The session.
+/// @param tick The next tick to simulate.
+/// @return true if the tick can be simulated.
+bool lockstep_ready(lockstep_t *ls, uint32_t tick);
+
+/// @summary Retrieves the input of a player for a tick that is ready.
+/// @param ls The session.
+/// @param player The player index.
+/// @param tick The tick.
+/// @return The input of the player.
+inline lockstep_input_t const* lockstep_get_input(lockstep_t const *ls, size_t player, uint32_t tick)
+{
+    return &ls->Inputs[player][tick & (LOCKSTEP_WINDOW - 1)];
+}
+
+/// @summary Records the hash of the local simulation state at the end of a
+/// tick. The hash is sent to the other instances and compared with theirs.
+/// @param ls The session.
+/// @param tick The tick just completed, a multiple of LOCKSTEP_HASH_INTERVAL.
+/// @param hash The hash of the simulation state.
+void lockstep_submit_hash(lockstep_t *ls, uint32_t tick, uint64_t hash);
+
+/// @summary Receives pending packets and sends local input to any instance
+/// that has not heard from this one for LOCKSTEP_SEND_PERIOD. Call at least
+/// once per frame, including while waiting for input.
+/// @param ls The session.
+/// @param now The current time, in seconds.
+void lockstep_update(lockstep_t *ls, double now);
+
+#endif /* !defined(GW_LOCKSTEP_HPP) */
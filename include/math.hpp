@@ -10,8 +10,12 @@
 /*////////////////
 //   Includes   //
 ////////////////*/
+#include <float.h>
+#include <math.h>
+#include <string.h>
 #include <limits>
 #include "common.hpp"
+#include "math_simd.hpp"
 
 /*////////////////
 //  Data Types  //
@@ -25,6 +29,23 @@ struct rng_state_t
     uint32_t state[16]; /// The RNG state data
 };
 
+/// @summary Opaque task pool type, defined in ll_task.hpp.
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The minimum size, in bytes, of a transformed output array for
+/// the mat4_transform_array_x functions to use non-temporal stores. Outputs
+/// this large would otherwise evict most of the cache. The output must also
+/// be suitably aligned (16 bytes for SSE, 32 bytes for AVX).
+#define MATH_STREAM_THRESHOLD      (1024U * 1024U)
+
+/// @summary The number of elements in a unit of work for the multi-threaded
+/// mat4_transform_x_mt functions. A multiple of four, which keeps every block
+/// of three-component elements 16-byte aligned relative to the array start.
+#define MATH_TRANSFORM_BLOCK       (4096U)
+
 /*///////////////
 //  Functions  //
 ///////////////*/
@@ -32,48 +53,69 @@ struct rng_state_t
 /// @param a The first value.
 /// @param b The second value.
 /// @return The smaller of a or b.
-float min2(float a, float b);
+inline BACKEND_FORCE_INLINE float min2(float a, float b)
+{
+    return (a < b ? a : b);
+}
 
 /// @summary Determines the larger of two floating point values.
 /// @param a The first value.
 /// @param b The second value.
 /// @return The larger of a or b.
-float max2(float a, float b);
+inline BACKEND_FORCE_INLINE float max2(float a, float b)
+{
+    return (a < b ? b : a);
+}
 
 /// @summary Determines the smallest of three floating point values.
 /// @param a The first value.
 /// @param b The second value.
 /// @param c The third value.
 /// @return The smaller of a, b and c.
-float min3(float a, float b, float c);
+inline BACKEND_FORCE_INLINE float min3(float a, float b, float c)
+{
+    return (a < b ? (a < c ? a : c) : (b < c ? b : c));
+}
 
 /// @summary Determines the largest of three floating point values.
 /// @param a The first value.
 /// @param b The second value.
 /// @param c The third value.
 /// @return The largest of a, b and c.
-float max3(float a, float b, float c);
+inline BACKEND_FORCE_INLINE float max3(float a, float b, float c)
+{
+    return (a > b ? (a > c ? a : c) : (b > c ? b : c));
+}
 
 /// @summary Performs linear interpolation between two scalar values.
 /// @param a The value at t = 0.
 /// @param b The value at t = 1.
 /// @param t A normalized interpolation parameter.
 /// @return The interpolated value.
-float mix(float a, float b, float t);
+inline BACKEND_FORCE_INLINE float mix(float a, float b, float t)
+{
+    return (a + ((b - a) * t));
+}
 
 /// @summary Clamps a value to a given range.
 /// @param x The value to clamp.
 /// @param a The lower-bound of the range.
 /// @param b The upper-bound of the range.
 /// @return The value x clamped to the range [a, b].
-float clamp(float x, float a, float b);
+inline BACKEND_FORCE_INLINE float clamp(float x, float a, float b)
+{
+    return max2(min2(x, b), a);
+}
 
 /// @summary Determines whether two floating point values are close enough to
 /// be considered equal, using the same value for absolute and relative tolerance (FLT_EPSILON).
 /// @param a The first value.
 /// @param b The second value.
 /// @return true if a and b can be considered equal.
-bool eq(float a, float b);
+inline bool eq(float a, float b)
+{
+    return (fabsf(a-b) <= (FLT_EPSILON * max2(fabsf(a), fabsf(b))));
+}
 
 /// @summary Determines whether two floating point values are close enough to
 /// be considered equal, using the specified absolute tolerance. This test
@@ -82,7 +124,10 @@ bool eq(float a, float b);
 /// @param b The second value.
 /// @param tol The absolute tolerance value.
 /// @return true if a and b can be considered equal.
-bool eq_abs(float a, float b, float tol);
+inline bool eq_abs(float a, float b, float tol)
+{
+    return (fabsf(a-b) <= tol);
+}
 
 /// @summary Determines whether two floating point values are close enough to
 /// be considered equal, using the specified relative tolerance. This test
@@ -91,7 +136,10 @@ bool eq_abs(float a, float b, float tol);
 /// @param b The second value.
 /// @param tol The relative tolerance value.
 /// @return true if a and b can be considered equal.
-bool eq_rel(float a, float b, float tol);
+inline bool eq_rel(float a, float b, float tol)
+{
+    return (fabsf(a-b) <= (tol * max2(fabsf(a), fabsf(b))));
+}
 
 /// @summary Determines whether two floating point values are close enough to
 /// be considered equal, using the specified absolute and relative tolerance values.
@@ -100,39 +148,103 @@ bool eq_rel(float a, float b, float tol);
 /// @param tol_a The absolute tolerance value.
 /// @param tol_r The relative tolerance value.
 /// @return true if a and b can be considered equal.
-bool eq_com(float a, float b, float tol_a, float tol_r);
+inline bool eq_com(float a, float b, float t_a, float t_r)
+{
+    return (fabsf(a-b) <= max2(t_a, t_r*max2(fabsf(a), fabsf(b))));
+}
+
+/// @summary Computes the number of representable single-precision values
+/// between two floating point values, which is the natural measure of error
+/// when comparing an optimized routine against a reference. Positive and
+/// negative zero are zero ULPs apart.
+/// @param a The first value.
+/// @param b The second value.
+/// @return The distance between a and b in units in the last place, or
+/// UINT32_MAX if either value is NaN.
+inline uint32_t ulp_distance(float a, float b)
+{
+    if (a != a || b != b) return UINT32_MAX;
+    int32_t  ia = 0;
+    int32_t  ib = 0;
+    memcpy(&ia, &a, sizeof(float));
+    memcpy(&ib, &b, sizeof(float));
+    // remap sign-magnitude to a monotonic two's complement ordering.
+    int64_t  oa = ia < 0 ? int64_t(INT32_MIN) - ia : int64_t(ia);
+    int64_t  ob = ib < 0 ? int64_t(INT32_MIN) - ib : int64_t(ib);
+    int64_t  d  = oa > ob ? oa - ob : ob - oa;
+    return d > int64_t(UINT32_MAX) ? UINT32_MAX : uint32_t(d);
+}
+
+/// @summary Determines whether two floating point values are within a given
+/// number of units in the last place of each other.
+/// @param a The first value.
+/// @param b The second value.
+/// @param max_ulps The maximum permitted distance, in ULPs.
+/// @return true if a and b can be considered equal.
+inline bool eq_ulp(float a, float b, uint32_t max_ulps)
+{
+    return (ulp_distance(a, b) <= max_ulps);
+}
 
 /// @summary Determines whether a floating point value has the special Not A Number value.
 /// @param a The value to check.
 /// @return true if a is NaN.
-bool is_nan(float a);
+inline bool is_nan(float a)
+{
+    const uint32_t   mask   = 0xFFC00000;  // sign + exponent
+    const uint32_t   snan   = 0x7FC00000;  // all exponent + top-most mantissa
+    uint32_t         value  = 0;
+    memcpy(&value, &a, sizeof(float));
+    return ((value & mask) == snan);
+}
 
 /// @summary Determines whether a floating point value is either positive or negative infinity.
 /// @param a The value to check.
 /// @return true if a is either the positive or negative infinity value.
-bool is_inf(float a);
+inline bool is_inf(float a)
+{
+    const uint32_t   mask    = 0x7FFFFFFF;  // all exponent + all mantissa
+    const uint32_t   inf     = 0x7F800000;  // all exponent; no mantissa
+    uint32_t         value   = 0;
+    memcpy(&value, &a, sizeof(float));
+    return ((value & mask)  == inf);
+}
 
 /// @summary Computes the reciporical value 1/a for a given value.
 /// @param a The input value.
 /// @return The value 1/a. The function does not check for divide-by-zero.
-float rcp(float a);
+inline BACKEND_FORCE_INLINE float rcp(float a)
+{
+    return 1.0f / a;
+}
 
 /// @summary Converts a value specified in degrees to radians.
 /// @param degrees The angle measure specified in degrees.
 /// @return The angle measure specified in radians.
-float rad(float degrees);
+inline float rad(float degrees)
+{
+    // degrees * (PI/180)
+    return (degrees * 0.017453292519943295769236907684886f);
+}
 
 /// @summary Converts a value specified in radians to degrees.
 /// @param radians The angle measure specified in radians.
 /// @return The angle measure specified in degrees.
-float deg(float radians);
+inline float deg(float radians)
+{
+    // radians * (180/PI)
+    return (radians * 57.29577951308232087679815481410500f);
+}
 
 /// @summary Performs linear interpolation between two scalar values.
 /// @param a The value at t = 0.
 /// @param b The value at t = 1.
 /// @param t A normalized interpolation parameter.
 /// @return The interpolated value.
-float linear(float a, float b, float t);
+inline BACKEND_FORCE_INLINE float linear(float a, float b, float t)
+{
+    return (a + ((b - a) * t));
+}
 
 /// @summary Performs Bezier interpolation between two scalar values.
 /// @param a The value at t = 0.
@@ -141,7 +253,13 @@ float linear(float a, float b, float t);
 /// @param out_t The tangent value (slope) coming out of b.
 /// @param t A normalized interpolation parameter.
 /// @return The interpolated value.
-float bezier(float  a, float b, float in_t, float out_t, float t);
+inline float bezier(float a, float b, float in_t, float out_t, float t)
+{
+    float d  =  b - a;
+    float a2 = (d * 3.0f) - (in_t + (out_t * 2.0f));
+    float a3 =   out_t    +  in_t - (d  * 2.0f);
+    return a + ((out_t    +  (a2  + (a3 * t)) * t) * t);
+}
 
 /// @summary Performs Hermite interpolation between two scalar values.
 /// @param a The value at t = 0.
@@ -150,7 +268,15 @@ float bezier(float  a, float b, float in_t, float out_t, float t);
 /// @param out_t The tangent value (slope) coming out of b.
 /// @param t A normalized interpolation parameter.
 /// @return The interpolated value.
-float hermite(float a, float b, float in_t, float out_t, float t);
+inline float hermite(float a, float b, float in_t, float out_t, float t)
+{
+    float t2 =  t  * t;
+    float t3 =  t2 * t;
+    return ((+2.0f * t3   - 3.0f * t2  + 1.0f) * a     +
+            (-2.0f * t3   + 3.0f * t2)         * b     +
+            (  t3  - 2.0f *   t2 +  t)         * out_t +
+            (  t3  -  t2)                      * in_t);
+}
 
 /// @summary Determines the number of bytes of seed data required to seed a
 /// random number generator instance.
@@ -233,28 +359,48 @@ uint32_t random_bits(rng_state_t *rng);
 /// @param x The x-component of the vector or point.
 /// @param y The y-component of the vector or point.
 /// @return The pointer dst_xy.
-float* vec2_set_xy(float *dst_xy, float x, float y);
+inline BACKEND_FORCE_INLINE float* vec2_set_xy(float *dst_xy, float x, float y)
+{
+    dst_xy[0] = x;
+    dst_xy[1] = y;
+    return dst_xy;
+}
 
 /// @summary Copies a 2-component vector or point value. The source and
 /// destination values must not overlap.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xy Pointer to the source value.
 /// @return The pointer @a dst_xy.
-float* vec2_set_vec2(float * __restrict dst_xy, float const * __restrict src_xy);
+inline BACKEND_FORCE_INLINE float* vec2_set_vec2(float * __restrict dst_xy, float const * __restrict src_xy)
+{
+    dst_xy[0] = src_xy[0];
+    dst_xy[1] = src_xy[1];
+    return dst_xy;
+}
 
 /// @summary Extracts the x- and y-components of a vector or point value into a
 /// destination value. The source and destination values must not overlap.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xyz Pointer to the source value.
 /// @return The pointer dst_xy.
-float* vec2_set_vec3(float * __restrict dst_xy, float const * __restrict src_xyz);
+inline BACKEND_FORCE_INLINE float* vec2_set_vec3(float * __restrict dst_xy, float const * __restrict src_xyz)
+{
+    dst_xy[0] = src_xyz[0];
+    dst_xy[1] = src_xyz[1];
+    return dst_xy;
+}
 
 /// @summary Extracts the x- and y-components of a vector or point value into a
 /// destination value. The source and destination values must not overlap.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xyzw Pointer to the source value.
 /// @return The pointer dst_xy.
-float* vec2_set_vec4(float * __restrict dst_xy, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec2_set_vec4(float * __restrict dst_xy, float const * __restrict src_xyzw)
+{
+    dst_xy[0] = src_xyzw[0];
+    dst_xy[1] = src_xyzw[1];
+    return dst_xy;
+}
 
 /// @summary Sets a 3-component vector or point value.
 /// @param dst_xyz Pointer to the destination storage.
@@ -262,7 +408,13 @@ float* vec2_set_vec4(float * __restrict dst_xy, float const * __restrict src_xyz
 /// @param y The y-component of the vector or point.
 /// @param z The z-component of the vector or point.
 /// @return The pointer dst_xyz.
-float* vec3_set_xyz(float *dst_xyz, float x, float y, float z);
+inline BACKEND_FORCE_INLINE float* vec3_set_xyz(float *dst_xyz, float x, float y, float z)
+{
+    dst_xyz[0] = x;
+    dst_xyz[1] = y;
+    dst_xyz[2] = z;
+    return dst_xyz;
+}
 
 /// @summary Extracts the x- and y-components of a vector or point value into a
 /// destination value with explicitly specified z-component. The source and
@@ -271,21 +423,39 @@ float* vec3_set_xyz(float *dst_xyz, float x, float y, float z);
 /// @param src_xy Pointer to the source storage from which the x- and y-components will be read.
 /// @param z The z-component value.
 /// @return The pointer to dst_xyz.
-float* vec3_set_vec2(float * __restrict dst_xyz, float const * __restrict src_xy, float z);
+inline BACKEND_FORCE_INLINE float* vec3_set_vec2(float * __restrict dst_xyz, float const * __restrict src_xy, float z)
+{
+    dst_xyz[0] = src_xy[0];
+    dst_xyz[1] = src_xy[1];
+    dst_xyz[2] = z;
+    return dst_xyz;
+}
 
 /// @summary Copies a 3-component vector or point value. The source and
 /// destination values must not overlap.
 /// @param dst_xyz Pointer to the destination storage.
 /// @param src_xyz Pointer to the source value.
 /// @return The pointer dst_xyz.
-float* vec3_set_vec3(float * __restrict dst_xyz, float const * __restrict src_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_set_vec3(float * __restrict dst_xyz, float const * __restrict src_xyz)
+{
+    dst_xyz[0] = src_xyz[0];
+    dst_xyz[1] = src_xyz[1];
+    dst_xyz[2] = src_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Extracts the x- and y- and z-components of a vector or point value
 /// into a destination value. The source and destination values must not overlap.
 /// @param dst_xyz Pointer to the destination storage.
 /// @param src_xyzw Pointer to the source storage from which the x- y- and z-components will be read.
 /// @return The pointer to dst_xyz.
-float* vec3_set_vec4(float * __restrict dst_xyz, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec3_set_vec4(float * __restrict dst_xyz, float const * __restrict src_xyzw)
+{
+    dst_xyz[0] = src_xyzw[0];
+    dst_xyz[1] = src_xyzw[1];
+    dst_xyz[2] = src_xyzw[2];
+    return dst_xyz;
+}
 
 /// @summary Sets a 4-component vector or point value.
 /// @param dst_xyzw Pointer to the destination storage.
@@ -295,7 +465,14 @@ float* vec3_set_vec4(float * __restrict dst_xyz, float const * __restrict src_xy
 /// @param w The w-component of the vector or point. Vectors typically have a
 /// w-component of zero; points typically have a w-component of one.
 /// @return The pointer dst_xyzw.
-float* vec4_set_xyzw(float *dst_xyzw, float x, float y, float z, float w);
+inline BACKEND_FORCE_INLINE float* vec4_set_xyzw(float *dst_xyzw, float x, float y, float z, float w)
+{
+    dst_xyzw[0] = x;
+    dst_xyzw[1] = y;
+    dst_xyzw[2] = z;
+    dst_xyzw[3] = w;
+    return dst_xyzw;
+}
 
 /// @summary Extracts the x- and y-components of a vector or point value into a
 /// destination value with explicitly specified z- and w-component. The source
@@ -306,7 +483,14 @@ float* vec4_set_xyzw(float *dst_xyzw, float x, float y, float z, float w);
 /// @param w The w-component of the vector or point. Vectors typically have a
 /// w-component of zero; points typically have a w-component of one.
 /// @return The pointer dst_xyzw.
-float* vec4_set_vec2(float * __restrict dst_xyzw, float const * __restrict src_xy, float z, float w);
+inline BACKEND_FORCE_INLINE float* vec4_set_vec2(float * __restrict dst_xyzw, float const * __restrict src_xy, float z, float w)
+{
+    dst_xyzw[0] = src_xy[0];
+    dst_xyzw[1] = src_xy[1];
+    dst_xyzw[2] = z;
+    dst_xyzw[3] = w;
+    return dst_xyzw;
+}
 
 /// @summary Extracts the x- y- and z-components of a vector or point value into
 /// a destination value with explicitly specified w-component. The source and
@@ -316,151 +500,338 @@ float* vec4_set_vec2(float * __restrict dst_xyzw, float const * __restrict src_x
 /// @param w The w-component of the vector or point. Vectors typically have a
 /// w-component of zero; points typically have a w-component of one.
 /// @return The pointer dst_xyzw.
-float* vec4_set_vec3(float * __restrict dst_xyzw, float const * __restrict src_xyz, float w);
+inline BACKEND_FORCE_INLINE float* vec4_set_vec3(float * __restrict dst_xyzw, float const * __restrict src_xyz, float w)
+{
+    dst_xyzw[0] = src_xyz[0];
+    dst_xyzw[1] = src_xyz[1];
+    dst_xyzw[2] = src_xyz[2];
+    dst_xyzw[3] = w;
+    return dst_xyzw;
+}
 
 /// @summary Copies a 4-component vector or point value. The source and destination values must not overlap.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param src_xyzw Pointer to the source value.
 /// @return The pointer dst_xyzw.
-float* vec4_set_vec4(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_set_vec4(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = src_xyzw[0];
+    dst_xyzw[1] = src_xyzw[1];
+    dst_xyzw[2] = src_xyzw[2];
+    dst_xyzw[3] = src_xyzw[3];
+    return dst_xyzw;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point Not-A-Number (NaN) value.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_nan(float *dst_xy);
+inline float* vec2_set_nan(float *dst_xy)
+{
+    float qnan = std::numeric_limits<float>::quiet_NaN();
+    dst_xy[0]  = qnan;
+    dst_xy[1]  = qnan;
+    return dst_xy;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point Not-A-Number (NaN) value.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_nan(float *dst_xyz);
+inline float* vec3_set_nan(float *dst_xyz)
+{
+    float qnan = std::numeric_limits<float>::quiet_NaN();
+    dst_xyz[0] = qnan;
+    dst_xyz[1] = qnan;
+    dst_xyz[2] = qnan;
+    return dst_xyz;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point Not-A-Number (NaN) value.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_nan(float *dst_xyzw);
+inline float* vec4_set_nan(float *dst_xyzw)
+{
+    float qnan  = std::numeric_limits<float>::quiet_NaN();
+    dst_xyzw[0] = qnan;
+    dst_xyzw[1] = qnan;
+    dst_xyzw[2] = qnan;
+    dst_xyzw[3] = qnan;
+    return dst_xyzw;
+}
 
 /// @summary Sets all elements of a vector to 1.0.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_one(float *dst_xy);
+inline float* vec2_set_one(float *dst_xy)
+{
+    dst_xy[0] = 1.0f;
+    dst_xy[1] = 1.0f;
+    return dst_xy;
+}
 
 /// @summary Sets all elements of a vector to 1.0.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_one(float *dst_xyz);
+inline float* vec3_set_one(float *dst_xyz)
+{
+    dst_xyz[0] = 1.0f;
+    dst_xyz[1] = 1.0f;
+    dst_xyz[2] = 1.0f;
+    return dst_xyz;
+}
 
 /// @summary Sets all elements of a vector to 1.0.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_one(float *dst_xyzw);
+inline float* vec4_set_one(float *dst_xyzw)
+{
+    dst_xyzw[0] = 1.0f;
+    dst_xyzw[1] = 1.0f;
+    dst_xyzw[2] = 1.0f;
+    dst_xyzw[3] = 1.0f;
+    return dst_xyzw;
+}
 
 /// @summary Sets all elements of a vector to 0.0.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_zero(float *dst_xy);
+inline float* vec2_set_zero(float *dst_xy)
+{
+    dst_xy[0] = 0.0f;
+    dst_xy[1] = 0.0f;
+    return dst_xy;
+}
 
 /// @summary Sets all elements of a vector to 0.0.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_zero(float *dst_xyz);
+inline float* vec3_set_zero(float *dst_xyz)
+{
+    dst_xyz[0] = 0.0f;
+    dst_xyz[1] = 0.0f;
+    dst_xyz[2] = 0.0f;
+    return dst_xyz;
+}
 
 /// @summary Sets all elements of a vector to 0.0.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_zero(float *dst_xyzw);
+inline float* vec4_set_zero(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 0.0f;
+    return dst_xyzw;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point negative infinity value.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_ninf(float *dst_xy);
+inline float* vec2_set_ninf(float *dst_xy)
+{
+    float ninf = -std::numeric_limits<float>::infinity();
+    dst_xy[0]  = ninf;
+    dst_xy[1]  = ninf;
+    return dst_xy;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point negative infinity value.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_ninf(float *dst_xyz);
+inline float* vec3_set_ninf(float *dst_xyz)
+{
+    float ninf = -std::numeric_limits<float>::infinity();
+    dst_xyz[0] = ninf;
+    dst_xyz[1] = ninf;
+    dst_xyz[2] = ninf;
+    return dst_xyz;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point negative infinity value.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_ninf(float *dst_xyzw);
+inline float* vec4_set_ninf(float *dst_xyzw)
+{
+    float ninf  = -std::numeric_limits<float>::infinity();
+    dst_xyzw[0] = ninf;
+    dst_xyzw[1] = ninf;
+    dst_xyzw[2] = ninf;
+    dst_xyzw[3] = ninf;
+    return dst_xyzw;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point positive infinity value.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_pinf(float *dst_xy);
+inline float* vec2_set_pinf(float *dst_xy)
+{
+    float pinf = std::numeric_limits<float>::infinity();
+    dst_xy[0]  = pinf;
+    dst_xy[1]  = pinf;
+    return dst_xy;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point positive infinity value.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_pinf(float *dst_xyz);
+inline float* vec3_set_pinf(float *dst_xyz)
+{
+    float pinf = std::numeric_limits<float>::infinity();
+    dst_xyz[0] = pinf;
+    dst_xyz[1] = pinf;
+    dst_xyz[2] = pinf;
+    return dst_xyz;
+}
 
 /// @summary Sets all elements of a vector to the IEEE-754 floating point positive infinity value.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_pinf(float *dst_xyzw);
+inline float* vec4_set_pinf(float *dst_xyzw)
+{
+    float pinf  = std::numeric_limits<float>::infinity();
+    dst_xyzw[0] = pinf;
+    dst_xyzw[1] = pinf;
+    dst_xyzw[2] = pinf;
+    dst_xyzw[3] = pinf;
+    return dst_xyzw;
+}
 
 /// @summary Sets the elements of a vector to the unit-length x-axis value <1,0>.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_unit_x(float *dst_xy);
+inline float* vec2_set_unit_x(float *dst_xy)
+{
+    dst_xy[0] = 1.0f;
+    dst_xy[1] = 0.0f;
+    return dst_xy;
+}
 
 /// @summary Sets the elements of a vector to the unit-length x-axis value <1,0,0>.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_unit_x(float *dst_xyz);
+inline float* vec3_set_unit_x(float *dst_xyz)
+{
+    dst_xyz[0] = 1.0f;
+    dst_xyz[1] = 0.0f;
+    dst_xyz[2] = 0.0f;
+    return dst_xyz;
+}
 
 /// @summary Sets the elements of a vector to the unit-length x-axis value <1,0,0,0>.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_unit_x(float *dst_xyzw);
+inline float* vec4_set_unit_x(float *dst_xyzw)
+{
+    dst_xyzw[0] = 1.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 0.0f;
+    return dst_xyzw;
+}
 
 /// @summary Sets the elements of a vector to the unit-length y-axis value <0,1>.
 /// @param dst_xy Pointer to the destination storage.
 /// @return The pointer dst_xy.
-float* vec2_set_unit_y(float *dst_xy);
+inline float* vec2_set_unit_y(float *dst_xy)
+{
+    dst_xy[0] = 0.0f;
+    dst_xy[1] = 1.0f;
+    return dst_xy;
+}
 
 /// @summary Sets the elements of a vector to the unit-length y-axis value <0,1,0>.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_unit_y(float *dst_xyz);
+inline float* vec3_set_unit_y(float *dst_xyz)
+{
+    dst_xyz[0] = 0.0f;
+    dst_xyz[1] = 1.0f;
+    dst_xyz[2] = 0.0f;
+    return dst_xyz;
+}
 
 /// @summary Sets the elements of a vector to the unit-length y-axis value <0,1,0,0>.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_unit_y(float *dst_xyzw);
+inline float* vec4_set_unit_y(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 1.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 0.0f;
+    return dst_xyzw;
+}
 
 /// @summary Sets the elements of a vector to the unit-length z-axis value <0,0,1>.
 /// @param dst_xyz Pointer to the destination storage.
 /// @return The pointer dst_xyz.
-float* vec3_set_unit_z(float *dst_xyz);
+inline float* vec3_set_unit_z(float *dst_xyz)
+{
+    dst_xyz[0] = 0.0f;
+    dst_xyz[1] = 0.0f;
+    dst_xyz[2] = 1.0f;
+    return dst_xyz;
+}
 
 /// @summary Sets the elements of a vector to the unit-length z-axis value <0,1,0,0>.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_unit_z(float *dst_xyzw);
+inline float* vec4_set_unit_z(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 1.0f;
+    dst_xyzw[3] = 0.0f;
+    return dst_xyzw;
+}
 
 /// @summary Sets the elements of a vector to the unit-length w-axis value <0,0,0,1>.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @return The pointer dst_xyzw.
-float* vec4_set_unit_w(float *dst_xyzw);
+inline float* vec4_set_unit_w(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 1.0f;
+    return dst_xyzw;
+}
 
 /// @summary Compares two vector values for equality.
 /// @param a_xy The first vector value.
 /// @param b_xy The second vector value.
 /// @return true if a_xy and b_xy can be considered equal.
-bool vec2_eq(float const * __restrict a_xy, float const * __restrict b_xy);
+inline bool vec2_eq(float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    if (!eq(a_xy[0], b_xy[0])) return false;
+    if (!eq(a_xy[1], b_xy[1])) return false;
+    return true;
+}
 
 /// @summary Compares two vector values for equality.
 /// @param a_xyz The first vector value.
 /// @param b_xyz The second vector value.
 /// @return true if a_xyz and b_xyz can be considered equal.
-bool vec3_eq(float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline bool vec3_eq(float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    if (!eq(a_xyz[0], b_xyz[0])) return false;
+    if (!eq(a_xyz[1], b_xyz[1])) return false;
+    if (!eq(a_xyz[2], b_xyz[2])) return false;
+    return true;
+}
 
 /// @summary Compares two vector values for equality.
 /// @param a_xyzw The first vector value.
 /// @param b_xyzw The second vector value.
 /// @return true if a_xyzw and b_xyzw can be considered equal.
-bool vec4_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline bool vec4_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    if (!eq(a_xyzw[0], b_xyzw[0])) return false;
+    if (!eq(a_xyzw[1], b_xyzw[1])) return false;
+    if (!eq(a_xyzw[2], b_xyzw[2])) return false;
+    if (!eq(a_xyzw[3], b_xyzw[3])) return false;
+    return true;
+}
 
 /// @summary Performs component-wise addition of two vector quantities, storing
 /// the result in a third, such that dst = a + b.
@@ -468,7 +839,12 @@ bool vec4_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw);
 /// @param a_xy The first source value.
 /// @param b_xy The second source value.
 /// @return The pointer dst_xy.
-float* vec2_add(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy);
+inline BACKEND_FORCE_INLINE float* vec2_add(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    dst_xy[0] = a_xy[0] + b_xy[0];
+    dst_xy[1] = a_xy[1] + b_xy[1];
+    return dst_xy;
+}
 
 /// @summary Performs component-wise addition of two vector quantities, storing
 /// the result in a third, such that dst = a + b.
@@ -476,7 +852,13 @@ float* vec2_add(float * __restrict dst_xy, float const * __restrict a_xy, float
 /// @param a_xyz The first source value.
 /// @param b_xyz The second source value.
 /// @return The pointer dst_xyz.
-float* vec3_add(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_add(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    dst_xyz[0] = a_xyz[0] + b_xyz[0];
+    dst_xyz[1] = a_xyz[1] + b_xyz[1];
+    dst_xyz[2] = a_xyz[2] + b_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Performs component-wise addition of two vector quantities, storing
 /// the result in a third, such that dst = a + b.
@@ -484,7 +866,11 @@ float* vec3_add(float * __restrict dst_xyz, float const * __restrict a_xyz, floa
 /// @param a_xyzw The first source value.
 /// @param b_xyzw The second source value.
 /// @return The pointer dst_xyzw.
-float* vec4_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    vec4_store(dst_xyzw, vec4_add(vec4_load(a_xyzw), vec4_load(b_xyzw)));
+    return dst_xyzw;
+}
 
 /// @summary Performs component-wise subtraction of two vector quantities,
 /// storing the result in a third, such that dst = a - b.
@@ -492,7 +878,12 @@ float* vec4_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, fl
 /// @param a_xy The first source value.
 /// @param b_xy The second source value.
 /// @return The pointer dst_xy.
-float* vec2_sub(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy);
+inline BACKEND_FORCE_INLINE float* vec2_sub(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    dst_xy[0] = a_xy[0] - b_xy[0];
+    dst_xy[1] = a_xy[1] - b_xy[1];
+    return dst_xy;
+}
 
 /// @summary Performs component-wise subtraction of two vector quantities,
 /// storing the result in a third, such that dst = a - b.
@@ -500,7 +891,13 @@ float* vec2_sub(float * __restrict dst_xy, float const * __restrict a_xy, float
 /// @param a_xyz The first source value.
 /// @param b_xyz The second source value.
 /// @return The pointer dst_xyz.
-float* vec3_sub(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_sub(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    dst_xyz[0] = a_xyz[0] - b_xyz[0];
+    dst_xyz[1] = a_xyz[1] - b_xyz[1];
+    dst_xyz[2] = a_xyz[2] - b_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Performs component-wise subtraction of two vector quantities,
 /// storing the result in a third, such that dst = a - b.
@@ -508,7 +905,11 @@ float* vec3_sub(float * __restrict dst_xyz, float const * __restrict a_xyz, floa
 /// @param a_xyzw The first source value.
 /// @param b_xyzw The second source value.
 /// @return The pointer dst_xyzw.
-float* vec4_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    vec4_store(dst_xyzw, vec4_sub(vec4_load(a_xyzw), vec4_load(b_xyzw)));
+    return dst_xyzw;
+}
 
 /// @summary Performs component-wise multiplication of two vector quantities,
 /// storing the result in a third, such that dst = a * b.
@@ -516,7 +917,12 @@ float* vec4_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, fl
 /// @param a_xy The first source value.
 /// @param b_xy The second source value.
 /// @return The pointer to dst_xy.
-float* vec2_mul(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy);
+inline BACKEND_FORCE_INLINE float* vec2_mul(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    dst_xy[0] = a_xy[0] * b_xy[0];
+    dst_xy[1] = a_xy[1] * b_xy[1];
+    return dst_xy;
+}
 
 /// @summary Performs component-wise multiplication of two vector quantities,
 /// storing the result in a third, such that dst = a * b.
@@ -524,7 +930,13 @@ float* vec2_mul(float * __restrict dst_xy, float const * __restrict a_xy, float
 /// @param a_xyz The first source value.
 /// @param b_xyz The second source value.
 /// @return The pointer to dst_xyz.
-float* vec3_mul(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_mul(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    dst_xyz[0] = a_xyz[0] * b_xyz[0];
+    dst_xyz[1] = a_xyz[1] * b_xyz[1];
+    dst_xyz[2] = a_xyz[2] * b_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Performs component-wise multiplication of two vector quantities,
 /// storing the result in a third, such that dst = a * b.
@@ -532,7 +944,11 @@ float* vec3_mul(float * __restrict dst_xyz, float const * __restrict a_xyz, floa
 /// @param a_xyzw The first source value.
 /// @param b_xyzw The second source value.
 /// @return The pointer to dst_xyzw.
-float* vec4_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    vec4_store(dst_xyzw, vec4_mul(vec4_load(a_xyzw), vec4_load(b_xyzw)));
+    return dst_xyzw;
+}
 
 /// @summary Performs component-wise division of two vector quantities, storing
 /// the result in a third, such that dst = a / b.
@@ -540,7 +956,12 @@ float* vec4_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, fl
 /// @param a_xy The first source value.
 /// @param b_xy The second source value.
 /// @return The pointer to dst_xy.
-float* vec2_div(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy);
+inline BACKEND_FORCE_INLINE float* vec2_div(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    dst_xy[0] = a_xy[0] / b_xy[0];
+    dst_xy[1] = a_xy[1] / b_xy[1];
+    return dst_xy;
+}
 
 /// @summary Performs component-wise division of two vector quantities, storing
 /// the result in a third, such that dst = a / b.
@@ -548,7 +969,13 @@ float* vec2_div(float * __restrict dst_xy, float const * __restrict a_xy, float
 /// @param a_xyz The first source value.
 /// @param b_xyz The second source value.
 /// @return The pointer to @a dst_xyz.
-float* vec3_div(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_div(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    dst_xyz[0] = a_xyz[0] / b_xyz[0];
+    dst_xyz[1] = a_xyz[1] / b_xyz[1];
+    dst_xyz[2] = a_xyz[2] / b_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Performs component-wise division of two vector quantities, storing
 /// the result in a third, such that dst = a / b.
@@ -556,28 +983,47 @@ float* vec3_div(float * __restrict dst_xyz, float const * __restrict a_xyz, floa
 /// @param a_xyzw The first source value.
 /// @param b_xyzw The second source value.
 /// @return The pointer to dst_xyzw.
-float* vec4_div(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_div(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    vec4_store(dst_xyzw, vec4_div(vec4_load(a_xyzw), vec4_load(b_xyzw)));
+    return dst_xyzw;
+}
 
 /// @summary Multiplies each component of a vector value by a scalar.
 /// @param dst_xy Pointer to the destination storage.
 /// @param a_xy The source vector value.
 /// @param b The scalar value.
 /// @return The pointer to dst_xy.
-float* vec2_scl(float * __restrict dst_xy, float const * __restrict a_xy, float b);
+inline BACKEND_FORCE_INLINE float* vec2_scl(float * __restrict dst_xy, float const * __restrict a_xy, float b)
+{
+    dst_xy[0] = a_xy[0] * b;
+    dst_xy[1] = a_xy[1] * b;
+    return dst_xy;
+}
 
 /// @summary Multiplies each component of a vector value by a scalar.
 /// @param dst_xyz Pointer to the destination storage.
 /// @param a_xyz The source vector value.
 /// @param b The scalar value.
 /// @return The pointer to dst_xyz.
-float* vec3_scl(float * __restrict dst_xyz, float const * __restrict a_xyz, float b);
+inline BACKEND_FORCE_INLINE float* vec3_scl(float * __restrict dst_xyz, float const * __restrict a_xyz, float b)
+{
+    dst_xyz[0] = a_xyz[0] * b;
+    dst_xyz[1] = a_xyz[1] * b;
+    dst_xyz[2] = a_xyz[2] * b;
+    return dst_xyz;
+}
 
 /// @summary Multiplies each component of a vector value by a scalar.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param a_xyzw The source vector value.
 /// @param b The scalar value.
 /// @return The pointer to dst_xyzw.
-float* vec4_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b);
+inline BACKEND_FORCE_INLINE float* vec4_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+{
+    vec4_store(dst_xyzw, vec4_scl(vec4_load(a_xyzw), b));
+    return dst_xyzw;
+}
 
 /// @summary Multiplies each component of a vector value by a scalar. Only the
 /// first three components of the vector are multiplied by the scalar value.
@@ -585,133 +1031,246 @@ float* vec4_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, fl
 /// @param a_xyzw The source vector value.
 /// @param b The scalar value.
 /// @return The pointer to dst_xyzw.
-float* vec4_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b);
+inline BACKEND_FORCE_INLINE float* vec4_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+{
+    dst_xyzw[0] = a_xyzw[0] * b;
+    dst_xyzw[1] = a_xyzw[1] * b;
+    dst_xyzw[2] = a_xyzw[2] * b;
+    dst_xyzw[3] = a_xyzw[3];
+    return dst_xyzw;
+}
 
 /// @summary Negates each component of a vector value, preserving the magnitude
 /// but reversing the direction.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xy The source vector value.
 /// @return The pointer to dst_xy.
-float* vec2_neg(float * __restrict dst_xy, float const * __restrict src_xy);
+inline BACKEND_FORCE_INLINE float* vec2_neg(float * __restrict dst_xy, float const * __restrict src_xy)
+{
+    dst_xy[0] = -src_xy[0];
+    dst_xy[1] = -src_xy[1];
+    return dst_xy;
+}
 
 /// @summary Negates each component of a vector value, preserving the magnitude
 /// but reversing the direction.
 /// @param dst_xyz Pointer to the destination storage.
 /// @param src_xyz The source vector value.
 /// @return The pointer to dst_xyz.
-float* vec3_neg(float * __restrict dst_xyz, float const * __restrict src_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_neg(float * __restrict dst_xyz, float const * __restrict src_xyz)
+{
+    dst_xyz[0] = -src_xyz[0];
+    dst_xyz[1] = -src_xyz[1];
+    dst_xyz[2] = -src_xyz[2];
+    return dst_xyz;
+}
 
 /// @summary Negates each component of a vector value, preserving the magnitude
 /// but reversing the direction.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param src_xyzw The source vector value.
 /// @return The pointer to dst_xyzw.
-float* vec4_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    vec4_store(dst_xyzw, vec4_neg(vec4_load(src_xyzw)));
+    return dst_xyzw;
+}
 
 /// @summary Negates each component of a vector value, preserving the magnitude
 /// but reversing the direction. Only the first three components are negated.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param src_xyzw The source vector value.
 /// @return The pointer to dst_xyzw.
-float* vec4_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = -src_xyzw[0];
+    dst_xyzw[1] = -src_xyzw[1];
+    dst_xyzw[2] = -src_xyzw[2];
+    dst_xyzw[3] =  src_xyzw[3];
+    return dst_xyzw;
+}
 
 /// @summary Computes the dot product of two vectors.
 /// @param dst On return, this value is set to the dot product of a and b.
 /// @param a_xy Vector value a.
 /// @param b_xy Vector value b.
 /// @return The dot product of the vectors.
-float vec2_dot(float &dst, float const * __restrict a_xy, float const * __restrict b_xy);
+inline BACKEND_FORCE_INLINE float vec2_dot(float &dst, float const * __restrict a_xy, float const * __restrict b_xy)
+{
+    dst = (a_xy[0] * b_xy[0] + a_xy[1] * b_xy[1]);
+    return dst;
+}
 
 /// @summary Computes the dot product of two vectors.
 /// @param dst On return, this value is set to the dot product of a and b.
 /// @param a_xyz Vector value a.
 /// @param b_xyz Vector value b.
 /// @return The dot product of the vectors.
-float vec3_dot(float &dst, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float vec3_dot(float &dst, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    dst = (a_xyz[0] * b_xyz[0] + a_xyz[1] * b_xyz[1] + a_xyz[2] * b_xyz[2]);
+    return dst;
+}
 
 /// @summary Computes the dot product of two vectors.
 /// @param dst On return, this value is set to the dot product of a and b.
 /// @param a_xyzw Vector value a.
 /// @param b_xyzw Vector value b.
 /// @return The dot product of the vectors.
-float vec4_dot(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_dot(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    dst = vec4_dot(vec4_load(a_xyzw), vec4_load(b_xyzw));
+    return dst;
+}
 
 /// @summary Computes the dot product of two vectors, considering only the first three components of each.
 /// @param dst On return, this value is set to the dot product of a and b.
 /// @param a_xyzw Vector value a.
 /// @param b_xyzw Vector value b.
 /// @return The dot product of the vectors.
-float vec4_dot3(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_dot3(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    dst = vec4_dot3(vec4_load(a_xyzw), vec4_load(b_xyzw));
+    return dst;
+}
 
 /// @summary Calculates the magnitude (length) of a vector.
 /// @param dst On return, this value is set to the length of the vector.
 /// @param a_xy The vector value.
 /// @return The magnitude (length) of vector a_xy.
-float vec2_len(float &dst, float const *a_xy);
+inline BACKEND_FORCE_INLINE float vec2_len(float &dst, float const *a_xy)
+{
+    dst  = sqrtf(a_xy[0] * a_xy[0] + a_xy[1] * a_xy[1]);
+    return dst;
+}
 
 /// @summary Calculates the magnitude (length) of a vector.
 /// @param dst On return, this value is set to the length of the vector.
 /// @param a_xyz The vector value.
 /// @return The magnitude (length) of vector a_xyz.
-float vec3_len(float &dst, float const *a_xyz);
+inline BACKEND_FORCE_INLINE float vec3_len(float &dst, float const *a_xyz)
+{
+    dst = sqrtf(a_xyz[0] * a_xyz[0] + a_xyz[1] * a_xyz[1] + a_xyz[2] * a_xyz[2]);
+    return dst;
+}
 
 /// @summary Calculates the magnitude (length) of a vector.
 /// @param dst On return, this value is set to the length of the vector.
 /// @param a_xyzw The vector value.
 /// @return The magnitude (length) of vector a_xyzw.
-float vec4_len(float &dst, float const *a_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_len(float &dst, float const *a_xyzw)
+{
+    dst = sqrtf(a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2] + a_xyzw[3] * a_xyzw[3]);
+    return dst;
+}
 
 /// @summary Calculates the magnitude (length) of a vector. Only the first
 /// three components of the vector are considered.
 /// @param dst On return, this value is set to the length of the vector.
 /// @param a_xyzw The vector value.
 /// @return The magnitude (length) of vector a_xyzw.
-float vec4_len3(float &dst, float const *a_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_len3(float &dst, float const *a_xyzw)
+{
+    dst = sqrtf(a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2]);
+    return dst;
+}
 
 /// @summary Calculates the squared magnitude (length) of a vector.
 /// @param dst On return, this value is set to the squared length of the vector.
 /// @param a_xy The vector value.
 /// @return The squared magnitude (length) of vector a_xy.
-float vec2_len_sq(float &dst, float const *a_xy);
+inline BACKEND_FORCE_INLINE float vec2_len_sq(float &dst, float const *a_xy)
+{
+    dst = (a_xy[0] * a_xy[0] + a_xy[1] * a_xy[1]);
+    return dst;
+}
 
 /// @summary Calculates the squared magnitude (length) of a vector.
 /// @param dst On return, this value is set to the squared length of the vector.
 /// @param a_xyz The vector value.
 /// @return The squared magnitude (length) of vector a_xyz.
-float vec3_len_sq(float &dst, float const *a_xyz);
+inline BACKEND_FORCE_INLINE float vec3_len_sq(float &dst, float const *a_xyz)
+{
+    dst = (a_xyz[0] * a_xyz[0] + a_xyz[1] * a_xyz[1] + a_xyz[2] * a_xyz[2]);
+    return dst;
+}
 
 /// @summary Calculates the squared magnitude (length) of a vector.
 /// @param dst On return, this value is set to the squared length of the vector.
 /// @param a_xyzw The vector value.
 /// @return The squared magnitude (length) of vector a_xyzw.
-float vec4_len_sq(float &dst, float const *a_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_len_sq(float &dst, float const *a_xyzw)
+{
+    dst = (a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2] + a_xyzw[3] * a_xyzw[3]);
+    return dst;
+}
 
 /// @summary Calculates the squared magnitude (length) of a vector.
 /// @param dst On return, this value is set to the squared length of the vector.
 /// @param a_xy The vector value.
 /// @return The squared magnitude (length) of vector a_xy.
-float vec4_len3_sq(float &dst, float const *a_xyzw);
+inline BACKEND_FORCE_INLINE float vec4_len3_sq(float &dst, float const *a_xyzw)
+{
+    dst = (a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2]);
+    return dst;
+}
 
 /// @summary Calculates the normalized (unit-length) vector for a given vector
 /// value. The normalized vector has the same direction, but magnitude 1.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xy The source vector value.
 /// @return The pointer dst_xy.
-float* vec2_nrm(float * __restrict dst_xy, float const * __restrict src_xy);
+inline BACKEND_FORCE_INLINE float* vec2_nrm(float * __restrict dst_xy, float const * __restrict src_xy)
+{
+    float len;
+    if (!eq(vec2_len(len, src_xy), 0))
+    {
+        float rcp = 1.0f / len;
+        dst_xy[0]  = src_xy[0] * rcp;
+        dst_xy[1]  = src_xy[1] * rcp;
+        return dst_xy;
+    }
+    else return vec2_set_pinf(dst_xy);
+}
 
 /// @summary Calculates the normalized (unit-length) vector for a given vector
 /// value. The normalized vector has the same direction, but magnitude 1.
 /// @param dst_xyz Pointer to the destination storage.
 /// @param src_xyz The source vector value.
 /// @return The pointer dst_xyz.
-float* vec3_nrm(float * __restrict dst_xyz, float const * __restrict src_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_nrm(float * __restrict dst_xyz, float const * __restrict src_xyz)
+{
+    float len;
+    if (!eq(vec3_len(len, src_xyz), 0))
+    {
+        float rcp = 1.0f / len;
+        dst_xyz[0]  = src_xyz[0] * rcp;
+        dst_xyz[1]  = src_xyz[1] * rcp;
+        dst_xyz[2]  = src_xyz[2] * rcp;
+        return dst_xyz;
+    }
+    else return vec3_set_pinf(dst_xyz);
+}
 
 /// @summary Calculates the normalized (unit-length) vector for a given vector
 /// value. The normalized vector has the same direction, but magnitude 1.
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param src_xyzw The source vector value.
 /// @return The pointer dst_xyzw.
-float* vec4_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    float len;
+    if (!eq(vec4_len(len, src_xyzw), 0))
+    {
+        float rcp = 1.0f / len;
+        dst_xyzw[0]  = src_xyzw[0] * rcp;
+        dst_xyzw[1]  = src_xyzw[1] * rcp;
+        dst_xyzw[2]  = src_xyzw[2] * rcp;
+        dst_xyzw[3]  = src_xyzw[3] * rcp;
+        return dst_xyzw;
+    }
+    else return vec4_set_pinf(dst_xyzw);
+}
 
 /// @summary Calculates the normalized (unit-length) vector for a given vector
 /// value. The normalized vector has the same direction, but magnitude 1. Only
@@ -720,13 +1279,38 @@ float* vec4_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
 /// @param dst_xyzw Pointer to the destination storage.
 /// @param src_xyzw The source vector value.
 /// @return The pointer dst_xyzw.
-float* vec4_nrm3(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_nrm3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    float len;
+    if (!eq(vec4_len3(len, src_xyzw), 0))
+    {
+        float rcp = 1.0f / len;
+        dst_xyzw[0]  = src_xyzw[0] * rcp;
+        dst_xyzw[1]  = src_xyzw[1] * rcp;
+        dst_xyzw[2]  = src_xyzw[2] * rcp;
+        dst_xyzw[3]  = src_xyzw[3];
+        return dst_xyzw;
+    }
+    else
+    {
+        vec3_set_pinf(dst_xyzw);
+        dst_xyzw[3]  = src_xyzw[3];
+        return dst_xyzw;
+    }
+}
 
 /// @summary Calculates a vector perpendicular to a given vector, but with the same magnitude.
 /// @param dst_xy Pointer to the destination storage.
 /// @param src_xy The source vector value.
 /// @return The pointer dst_xy.
-float* vec2_perp(float * __restrict dst_xy, float const * __restrict src_xy);
+inline BACKEND_FORCE_INLINE float* vec2_perp(float * __restrict dst_xy, float const * __restrict src_xy)
+{
+    float x   = src_xy[0];
+    float y   = src_xy[1];
+    dst_xy[0] = -y;
+    dst_xy[1] =  x;
+    return dst_xy;
+}
 
 /// @summary Calculates the cross product of two vectors, producing a third
 /// vector that is orthogonal to the source vectors; the dot product of the
@@ -735,7 +1319,15 @@ float* vec2_perp(float * __restrict dst_xy, float const * __restrict src_xy);
 /// @param a_xyz The first source vector.
 /// @param b_xyz The second source vector.
 /// @return The pointer dst_xyz.
-float* vec3_cross(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz);
+inline BACKEND_FORCE_INLINE float* vec3_cross(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
+{
+    float ax   = a_xyz[0], ay = a_xyz[1], az = a_xyz[2];
+    float bx   = b_xyz[0], by = b_xyz[1], bz = b_xyz[2];
+    dst_xyz[0] = ay * bz - az * by;
+    dst_xyz[1] = az * bx - ax * bz;
+    dst_xyz[2] = ax * by - ay * bx;
+    return dst_xyz;
+}
 
 /// @summary Calculates the cross product of two vectors, producing a third
 /// vector that is orthogonal to the source vectors; the dot product of the
@@ -746,7 +1338,16 @@ float* vec3_cross(float * __restrict dst_xyz, float const * __restrict a_xyz, fl
 /// @param a_xyzw The first source vector.
 /// @param b_xyzw The second source vector.
 /// @return The pointer dst_xyzw.
-float* vec4_cross(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
+inline BACKEND_FORCE_INLINE float* vec4_cross(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    float ax    = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2];
+    float bx    = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2];
+    dst_xyzw[0] = ay * bz  - az * by;
+    dst_xyzw[1] = az * bx  - ax * bz;
+    dst_xyzw[2] = ax * by  - ay * bx;
+    dst_xyzw[3] = 0.0f; // cross product always results in a vector
+    return dst_xyzw;
+}
 
 /// @summary Performs a swizzle operation on a vector or point value to select
 /// or change the order of components.
@@ -757,7 +1358,14 @@ float* vec4_cross(float * __restrict dst_xyzw, float const * __restrict a_xyzw,
 /// @param y The zero-based index of the source component that will be written
 /// to the destination value at index 1.
 /// @return The pointer dst_xy.
-float* vec2_swizzle(float * __restrict dst_xy, float const * __restrict src_xy, size_t x, size_t y);
+inline float* vec2_swizzle(float * __restrict dst_xy, float const * __restrict src_xy, size_t x, size_t y)
+{
+    float a   = src_xy[x];
+    float b   = src_xy[y];
+    dst_xy[0] = a;
+    dst_xy[1] = b;
+    return dst_xy;
+}
 
 /// @summary Performs a swizzle operation on a vector or point value to select
 /// or change the order of components.
@@ -770,7 +1378,16 @@ float* vec2_swizzle(float * __restrict dst_xy, float const * __restrict src_xy,
 /// @param z The zero-based index of the source component that will be written
 /// to the destination value at index 2.
 /// @return The pointer dst_xyz.
-float* vec3_swizzle(float * __restrict dst_xyz, float const * __restrict src_xyz, size_t x, size_t y, size_t z);
+inline float* vec3_swizzle(float * __restrict dst_xyz, float const * __restrict src_xyz, size_t x, size_t y, size_t z)
+{
+    float a    = src_xyz[x];
+    float b    = src_xyz[y];
+    float c    = src_xyz[z];
+    dst_xyz[0] = a;
+    dst_xyz[1] = b;
+    dst_xyz[2] = c;
+    return dst_xyz;
+}
 
 /// @summary Performs a swizzle operation on a vector or point value to select
 /// or change the order of components.
@@ -785,7 +1402,18 @@ float* vec3_swizzle(float * __restrict dst_xyz, float const * __restrict src_xyz
 /// @param w The zero-based index of the source component that will be written
 /// to the destination value at index 3.
 /// @return The pointer dst_xyzw.
-float* vec4_swizzle(float * __restrict dst_xyzw, float const * __restrict src_xyzw, size_t x, size_t y, size_t z, size_t w);
+inline float* vec4_swizzle(float * __restrict dst_xyzw, float const * __restrict src_xyzw, size_t x, size_t y, size_t z, size_t w)
+{
+    float a     = src_xyzw[x];
+    float b     = src_xyzw[y];
+    float c     = src_xyzw[z];
+    float d     = src_xyzw[w];
+    dst_xyzw[0] = a;
+    dst_xyzw[1] = b;
+    dst_xyzw[2] = c;
+    dst_xyzw[3] = d;
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise linear interpolation between two vector or point quantities.
 /// @param dst_xy Pointer to the destination storage.
@@ -793,7 +1421,12 @@ float* vec4_swizzle(float * __restrict dst_xyzw, float const * __restrict src_xy
 /// @param b_xy The value at @a t = 1.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xy.
-float* vec2_linear(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy, float t);
+inline BACKEND_FORCE_INLINE float* vec2_linear(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy, float t)
+{
+    dst_xy[0] = linear(a_xy[0], b_xy[0], t);
+    dst_xy[1] = linear(a_xy[1], b_xy[1], t);
+    return dst_xy;
+}
 
 /// @summary Performs componentwise linear interpolation between two vector or point quantities.
 /// @param dst_xyz Pointer to the destination storage.
@@ -801,7 +1434,13 @@ float* vec2_linear(float * __restrict dst_xy, float const * __restrict a_xy, flo
 /// @param b_xyz The value at @a t = 1.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyz.
-float* vec3_linear(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz, float t);
+inline BACKEND_FORCE_INLINE float* vec3_linear(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz, float t)
+{
+    dst_xyz[0] = linear(a_xyz[0], b_xyz[0], t);
+    dst_xyz[1] = linear(a_xyz[1], b_xyz[1], t);
+    dst_xyz[2] = linear(a_xyz[2], b_xyz[2], t);
+    return dst_xyz;
+}
 
 /// @summary Performs componentwise linear interpolation between two vector or point quantities.
 /// @param dst_xyzw Pointer to the destination storage.
@@ -809,7 +1448,14 @@ float* vec3_linear(float * __restrict dst_xyz, float const * __restrict a_xyz, f
 /// @param b_xyzw The value at @a t = 1.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_linear(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t);
+inline BACKEND_FORCE_INLINE float* vec4_linear(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t)
+{
+    dst_xyzw[0] = linear(a_xyzw[0], b_xyzw[0], t);
+    dst_xyzw[1] = linear(a_xyzw[1], b_xyzw[1], t);
+    dst_xyzw[2] = linear(a_xyzw[2], b_xyzw[2], t);
+    dst_xyzw[3] = linear(a_xyzw[3], b_xyzw[3], t);
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise linear interpolation between two vector or
 /// point quantities. Only the first three components are interpolated.
@@ -818,7 +1464,14 @@ float* vec4_linear(float * __restrict dst_xyzw, float const * __restrict a_xyzw,
 /// @param b_xyzw The value at @a t = 1.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_linear3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t);
+inline BACKEND_FORCE_INLINE float* vec4_linear3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t)
+{
+    dst_xyzw[0] = linear(a_xyzw[0], b_xyzw[0], t);
+    dst_xyzw[1] = linear(a_xyzw[1], b_xyzw[1], t);
+    dst_xyzw[2] = linear(a_xyzw[2], b_xyzw[2], t);
+    dst_xyzw[3] = a_xyzw[3];
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise Bezier interpolation between two vector or point quantities.
 /// @param dst_xy Pointer to the destination storage.
@@ -828,13 +1481,18 @@ float* vec4_linear3(float * __restrict dst_xyzw, float const * __restrict a_xyzw
 /// @param otan_xy The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xy.
-float* vec2_bezier(
+inline float* vec2_bezier(
     float       * __restrict dst_xy,
     float const * __restrict a_xy,
     float const * __restrict b_xy,
     float const * __restrict itan_xy,
     float const * __restrict otan_xy,
-    float                  t);
+    float                  t)
+{
+    dst_xy[0] = bezier(a_xy[0], b_xy[0], itan_xy[0], otan_xy[0], t);
+    dst_xy[1] = bezier(a_xy[1], b_xy[1], itan_xy[1], otan_xy[1], t);
+    return dst_xy;
+}
 
 /// @summary Performs componentwise Bezier interpolation between two vector or point quantities.
 /// @param dst_xyz Pointer to the destination storage.
@@ -844,13 +1502,19 @@ float* vec2_bezier(
 /// @param otan_xyz The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyz.
-float* vec3_bezier(
+inline float* vec3_bezier(
     float       * __restrict dst_xyz,
     float const * __restrict a_xyz,
     float const * __restrict b_xyz,
     float const * __restrict itan_xyz,
     float const * __restrict otan_xyz,
-    float                  t);
+    float                  t)
+{
+    dst_xyz[0] = bezier(a_xyz[0], b_xyz[0], itan_xyz[0], otan_xyz[0], t);
+    dst_xyz[1] = bezier(a_xyz[1], b_xyz[1], itan_xyz[1], otan_xyz[1], t);
+    dst_xyz[2] = bezier(a_xyz[2], b_xyz[2], itan_xyz[2], otan_xyz[2], t);
+    return dst_xyz;
+}
 
 /// @summary Performs componentwise Bezier interpolation between two vector or point quantities.
 /// @param dst_xyzw Pointer to the destination storage.
@@ -860,13 +1524,20 @@ float* vec3_bezier(
 /// @param otan_xyzw The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_bezier(
+inline float* vec4_bezier(
     float       * __restrict dst_xyzw,
     float const * __restrict a_xyzw,
     float const * __restrict b_xyzw,
     float const * __restrict itan_xyzw,
     float const * __restrict otan_xyzw,
-    float                  t);
+    float                  t)
+{
+    dst_xyzw[0] = bezier(a_xyzw[0], b_xyzw[0], itan_xyzw[0], otan_xyzw[0], t);
+    dst_xyzw[1] = bezier(a_xyzw[1], b_xyzw[1], itan_xyzw[1], otan_xyzw[1], t);
+    dst_xyzw[2] = bezier(a_xyzw[2], b_xyzw[2], itan_xyzw[2], otan_xyzw[2], t);
+    dst_xyzw[3] = bezier(a_xyzw[3], b_xyzw[3], itan_xyzw[3], otan_xyzw[3], t);
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise Bezier interpolation between two vector or
 /// point quantities. Only the first three components are interpolated.
@@ -877,13 +1548,20 @@ float* vec4_bezier(
 /// @param otan_xyzw The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_bezier3(
+inline float* vec4_bezier3(
     float       * __restrict dst_xyzw,
     float const * __restrict a_xyzw,
     float const * __restrict b_xyzw,
     float const * __restrict itan_xyz,
     float const * __restrict otan_xyz,
-    float                  t);
+    float                  t)
+{
+    dst_xyzw[0] = bezier(a_xyzw[0], b_xyzw[0], itan_xyz[0], otan_xyz[0], t);
+    dst_xyzw[1] = bezier(a_xyzw[1], b_xyzw[1], itan_xyz[1], otan_xyz[1], t);
+    dst_xyzw[2] = bezier(a_xyzw[2], b_xyzw[2], itan_xyz[2], otan_xyz[2], t);
+    dst_xyzw[3] = a_xyzw[3];
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise Hermite interpolation between two vector or point quantities.
 /// @param dst_xy Pointer to the destination storage.
@@ -893,13 +1571,18 @@ float* vec4_bezier3(
 /// @param otan_xy The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xy.
-float* vec2_hermite(
+inline float* vec2_hermite(
     float       * __restrict dst_xy,
     float const * __restrict a_xy,
     float const * __restrict b_xy,
     float const * __restrict itan_xy,
     float const * __restrict otan_xy,
-    float                  t);
+    float                  t)
+{
+    dst_xy[0] = hermite(a_xy[0], b_xy[0], itan_xy[0], otan_xy[0], t);
+    dst_xy[1] = hermite(a_xy[1], b_xy[1], itan_xy[1], otan_xy[1], t);
+    return dst_xy;
+}
 
 /// @summary Performs componentwise Hermite interpolation between two vector or point quantities.
 /// @param dst_xyz Pointer to the destination storage.
@@ -909,13 +1592,19 @@ float* vec2_hermite(
 /// @param otan_xyz The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyz.
-float* vec3_hermite(
+inline float* vec3_hermite(
     float       * __restrict dst_xyz,
     float const * __restrict a_xyz,
     float const * __restrict b_xyz,
     float const * __restrict itan_xyz,
     float const * __restrict otan_xyz,
-    float                  t);
+    float                  t)
+{
+    dst_xyz[0] = hermite(a_xyz[0], b_xyz[0], itan_xyz[0], otan_xyz[0], t);
+    dst_xyz[1] = hermite(a_xyz[1], b_xyz[1], itan_xyz[1], otan_xyz[1], t);
+    dst_xyz[2] = hermite(a_xyz[2], b_xyz[2], itan_xyz[2], otan_xyz[2], t);
+    return dst_xyz;
+}
 
 /// @summary Performs componentwise Hermite interpolation between two vector or point quantities.
 /// @param dst_xyzw Pointer to the destination storage.
@@ -925,13 +1614,20 @@ float* vec3_hermite(
 /// @param otan_xyzw The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_hermite(
+inline float* vec4_hermite(
     float       * __restrict dst_xyzw,
     float const * __restrict a_xyzw,
     float const * __restrict b_xyzw,
     float const * __restrict itan_xyzw,
     float const * __restrict otan_xyzw,
-    float                      t);
+    float                  t)
+{
+    dst_xyzw[0] = hermite(a_xyzw[0], b_xyzw[0], itan_xyzw[0], otan_xyzw[0], t);
+    dst_xyzw[1] = hermite(a_xyzw[1], b_xyzw[1], itan_xyzw[1], otan_xyzw[1], t);
+    dst_xyzw[2] = hermite(a_xyzw[2], b_xyzw[2], itan_xyzw[2], otan_xyzw[2], t);
+    dst_xyzw[3] = hermite(a_xyzw[3], b_xyzw[3], itan_xyzw[3], otan_xyzw[3], t);
+    return dst_xyzw;
+}
 
 /// @summary Performs componentwise Hermite interpolation between two vector or
 /// point quantities. Only the first three components are interpolated.
@@ -942,36 +1638,170 @@ float* vec4_hermite(
 /// @param otan_xyz The outgoing tangent value.
 /// @param t A value in the range [0, 1] specifying the interpolation parameter.
 /// @return The pointer dst_xyzw.
-float* vec4_hermite3(
+inline float* vec4_hermite3(
     float       * __restrict dst_xyzw,
     float const * __restrict a_xyzw,
     float const * __restrict b_xyzw,
     float const * __restrict itan_xyz,
     float const * __restrict otan_xyz,
-    float                  t);
-
-float* quat_set_xyzw(float *dst_xyzw, float x, float y, float z, float w);
-float* quat_set_quat(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
-float* quat_set_nan(float *dst_xyzw);
-float* quat_set_one(float *dst_xyzw);
-float* quat_set_zero(float *dst_xyzw);
-float* quat_set_ninf(float *dst_xyzw);
-float* quat_set_pinf(float *dst_xyzw);
-float* quat_set_ident(float *dst_xyzw);
-bool   quat_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw);
-float* quat_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
-float* quat_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
-float* quat_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw);
-float* quat_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b);
-float* quat_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b);
-float* quat_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
-float* quat_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
-float* quat_conj(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
-float  quat_dot(float const * __restrict a_xyzw, float const * __restrict b_xyzw);
-float  quat_norm(float const *src_xyzw);
-float  quat_len(float const *src_xyzw);
-float  quat_len_sq(float const *src_xyzw);
-float  quat_sel(float const *src_xyzw);
+    float                  t)
+{
+    dst_xyzw[0] = hermite(a_xyzw[0], b_xyzw[0], itan_xyz[0], otan_xyz[0], t);
+    dst_xyzw[1] = hermite(a_xyzw[1], b_xyzw[1], itan_xyz[1], otan_xyz[1], t);
+    dst_xyzw[2] = hermite(a_xyzw[2], b_xyzw[2], itan_xyz[2], otan_xyz[2], t);
+    dst_xyzw[3] = a_xyzw[3];
+    return dst_xyzw;
+}
+
+inline BACKEND_FORCE_INLINE float* quat_set_xyzw(float *dst_xyzw, float x, float y, float z, float w)
+{
+    dst_xyzw[0] = x;
+    dst_xyzw[1] = y;
+    dst_xyzw[2] = z;
+    dst_xyzw[3] = w;
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_set_quat(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = src_xyzw[0];
+    dst_xyzw[1] = src_xyzw[1];
+    dst_xyzw[2] = src_xyzw[2];
+    dst_xyzw[3] = src_xyzw[3];
+    return dst_xyzw;
+}
+inline float* quat_set_nan(float *dst_xyzw)
+{
+    float qnan  = std::numeric_limits<float>::quiet_NaN();
+    dst_xyzw[0] = qnan;
+    dst_xyzw[1] = qnan;
+    dst_xyzw[2] = qnan;
+    dst_xyzw[3] = qnan;
+    return dst_xyzw;
+}
+inline float* quat_set_one(float *dst_xyzw)
+{
+    dst_xyzw[0] = 1.0f;
+    dst_xyzw[1] = 1.0f;
+    dst_xyzw[2] = 1.0f;
+    dst_xyzw[3] = 1.0f;
+    return dst_xyzw;
+}
+inline float* quat_set_zero(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 0.0f;
+    return dst_xyzw;
+}
+inline float* quat_set_ninf(float *dst_xyzw)
+{
+    float ninf  = -std::numeric_limits<float>::infinity();
+    dst_xyzw[0] = ninf;
+    dst_xyzw[1] = ninf;
+    dst_xyzw[2] = ninf;
+    dst_xyzw[3] = ninf;
+    return dst_xyzw;
+}
+inline float* quat_set_pinf(float *dst_xyzw)
+{
+    float pinf  = std::numeric_limits<float>::infinity();
+    dst_xyzw[0] = pinf;
+    dst_xyzw[1] = pinf;
+    dst_xyzw[2] = pinf;
+    dst_xyzw[3] = pinf;
+    return dst_xyzw;
+}
+inline float* quat_set_ident(float *dst_xyzw)
+{
+    dst_xyzw[0] = 0.0f;
+    dst_xyzw[1] = 0.0f;
+    dst_xyzw[2] = 0.0f;
+    dst_xyzw[3] = 1.0f;
+    return dst_xyzw;
+}
+inline bool quat_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    if (!eq(a_xyzw[0], b_xyzw[0]))
+        return 0;
+    if (!eq(a_xyzw[1], b_xyzw[1]))
+        return 0;
+    if (!eq(a_xyzw[2], b_xyzw[2]))
+        return 0;
+    if (!eq(a_xyzw[3], b_xyzw[3]))
+        return 0;
+    return 1;
+}
+inline BACKEND_FORCE_INLINE float* quat_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    quat_store(dst_xyzw, quat_add(quat_load(a_xyzw), quat_load(b_xyzw)));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    quat_store(dst_xyzw, quat_sub(quat_load(a_xyzw), quat_load(b_xyzw)));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    quat_store(dst_xyzw, quat_mul(quat_load(a_xyzw), quat_load(b_xyzw)));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+{
+    quat_store(dst_xyzw, quat_scl(quat_load(a_xyzw), b));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+{
+    dst_xyzw[0] = a_xyzw[0] * b;
+    dst_xyzw[1] = a_xyzw[1] * b;
+    dst_xyzw[2] = a_xyzw[2] * b;
+    dst_xyzw[3] = a_xyzw[3];
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = -src_xyzw[0];
+    dst_xyzw[1] = -src_xyzw[1];
+    dst_xyzw[2] = -src_xyzw[2];
+    dst_xyzw[3] = -src_xyzw[3];
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = -src_xyzw[0];
+    dst_xyzw[1] = -src_xyzw[1];
+    dst_xyzw[2] = -src_xyzw[2];
+    dst_xyzw[3] =  src_xyzw[3];
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* quat_conj(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    quat_store(dst_xyzw, quat_conj(quat_load(src_xyzw)));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float quat_dot(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    // equivalent to selection(a * conjugate(b))
+    return quat_dot(quat_load(a_xyzw), quat_load(b_xyzw));
+}
+inline BACKEND_FORCE_INLINE float quat_norm(float const *src_xyzw)
+{
+    return (src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+}
+inline BACKEND_FORCE_INLINE float quat_len(float const *src_xyzw)
+{
+    return sqrtf(src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+}
+inline BACKEND_FORCE_INLINE float quat_len_sq(float const *src_xyzw)
+{
+    return (src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+}
+inline float quat_sel(float const *src_xyzw)
+{
+    return src_xyzw[3];
+}
 float* quat_inv(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
 float* quat_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
 float* quat_exp(float * __restrict dst_xyzw, float const * __restrict src_xyzw);
@@ -1009,8 +1839,17 @@ float* mat4_get_col(float * __restrict dst_xyzw, size_t col, float const *__rest
 float* mat4_set_col(float * __restrict dst16, size_t col, float const * __restrict src_xyzw);
 float  mat4_trace(float const *src16);
 float  mat4_det(float const *src16);
-float* mat4_transpose(float * __restrict dst16, float const * __restrict src16);
-float* mat4_concat(float * __restrict dst16, float const * __restrict a16, float const * __restrict b16);
+inline BACKEND_FORCE_INLINE float* mat4_transpose(float * __restrict dst16, float const * __restrict src16)
+{
+    mat4_store(dst16, mat4_transpose(mat4_load(src16)));
+    return dst16;
+}
+inline BACKEND_FORCE_INLINE float* mat4_concat(float * __restrict dst16, float const * __restrict a16, float const * __restrict b16)
+{
+    // transformation 'a' is applied first, followed by transformation 'b'.
+    mat4_store(dst16, mat4_concat(mat4_load(a16), mat4_load(b16)));
+    return dst16;
+}
 float* mat4_inv_affine(float * __restrict dst16, float const * __restrict src16);
 float* mat4_set_quat(float * __restrict dst16, float const * __restrict src_xyzw);
 float* mat4_set_euler_degree_x(float *dst16, float deg_x);
@@ -1034,15 +1873,81 @@ float* mat4_persp_radian(float *dst16, float fov_rad, float aspect, float near,
 float* mat4_2d(float *dst16, float width, float height);
 void   mat4_extract_frustum_n(float * __restrict left_xyzD, float * __restrict right_xyzD, float * __restrict top_xyzD, float * __restrict bottom_xyzD, float * __restrict near_xyzD, float * __restrict far_xyzD, float const * __restrict proj16);
 void   mat4_extract_frustum_u(float * __restrict left_xyzD, float * __restrict right_xyzD, float * __restrict top_xyzD, float * __restrict bottom_xyzD, float * __restrict near_xyzD, float * __restrict far_xyzD, float const * __restrict proj16);
-float* mat4_transform_vec3(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16);
-float* mat4_transform_vec4(float * __restrict dst_xyzw, float const * __restrict src_xyzw, float const * __restrict t16);
-float* mat4_transform_point(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16);
-float* mat4_transform_vector(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16);
+inline BACKEND_FORCE_INLINE float* mat4_transform_vec3(
+    float       * __restrict dst_xyz,
+    float const * __restrict src_xyz,
+    float const * __restrict t16)
+{
+    float vx = src_xyz[0];
+    float vy = src_xyz[1];
+    float vz = src_xyz[2];
+
+    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12];
+    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13];
+    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14];
+
+    return dst_xyz;
+}
+inline BACKEND_FORCE_INLINE float* mat4_transform_vec4(
+    float       * __restrict dst_xyzw,
+    float const * __restrict src_xyzw,
+    float const * __restrict t16)
+{
+    vec4_store(dst_xyzw, mat4_transform_vec4(mat4_load(t16), vec4_load(src_xyzw)));
+    return dst_xyzw;
+}
+inline BACKEND_FORCE_INLINE float* mat4_transform_point(
+    float       * __restrict dst_xyz,
+    float const * __restrict src_xyz,
+    float const * __restrict t16)
+{
+    float vx = src_xyz[0];
+    float vy = src_xyz[1];
+    float vz = src_xyz[2];
+
+    // for points, w = 1.0
+    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12];
+    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13];
+    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14];
+
+    return dst_xyz;
+}
+inline BACKEND_FORCE_INLINE float* mat4_transform_vector(
+    float       * __restrict dst_xyz,
+    float const * __restrict src_xyz,
+    float const * __restrict t16)
+{
+    float vx = src_xyz[0];
+    float vy = src_xyz[1];
+    float vz = src_xyz[2];
+
+    // for vectors, w = 0.0
+    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz;
+    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz;
+    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz;
+
+    return dst_xyz;
+}
 float* mat4_transform_array_vec3(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16, size_t count);
 float* mat4_transform_array_vec4(float * __restrict dst_xyzw, float const * __restrict src_xyzw, float const * __restrict t16, size_t count);
 float* mat4_transform_array_point(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16, size_t count);
 float* mat4_transform_array_vector(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16, size_t count);
 
+/// @summary Transforms arrays of points or vectors stored in SoA form, where
+/// the x, y and z components are held in separate arrays. The w-component is
+/// taken to be 1.0 for points and 0.0 for vectors. Processes eight elements
+/// at a time with AVX, or four with SSE.
+void   mat4_transform_soa_point(float * __restrict dst_x, float * __restrict dst_y, float * __restrict dst_z, float const * __restrict src_x, float const * __restrict src_y, float const * __restrict src_z, float const * __restrict t16, size_t count);
+void   mat4_transform_soa_vector(float * __restrict dst_x, float * __restrict dst_y, float * __restrict dst_z, float const * __restrict src_x, float const * __restrict src_y, float const * __restrict src_z, float const * __restrict t16, size_t count);
+
+/// @summary Transforms large arrays by splitting them into blocks of
+/// MATH_TRANSFORM_BLOCK elements that are executed on a task pool. If pool
+/// is NULL, the transform runs on the calling thread.
+float* mat4_transform_array_vec4_mt(float * __restrict dst_xyzw, float const * __restrict src_xyzw, float const * __restrict t16, size_t count, task_pool_t *pool);
+float* mat4_transform_array_point_mt(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16, size_t count, task_pool_t *pool);
+float* mat4_transform_array_vector_mt(float * __restrict dst_xyz, float const * __restrict src_xyz, float const * __restrict t16, size_t count, task_pool_t *pool);
+void   mat4_transform_soa_point_mt(float * __restrict dst_x, float * __restrict dst_y, float * __restrict dst_z, float const * __restrict src_x, float const * __restrict src_y, float const * __restrict src_z, float const * __restrict t16, size_t count, task_pool_t *pool);
+
 /// Determine the smallest representable value for a given integer type.
 /// @return The smallest representable value for a given integer type.
 template <typename T>
@@ -0,0 +1,534 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines SIMD-backed vector, quaternion and matrix value types and
+/// the force-inlined operations on them. Values are held in SSE registers when
+/// SSE is available, and in plain float arrays otherwise. Load and store from
+/// the float pointer layouts used throughout math.hpp.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_MATH_SIMD_HPP
+#define GW_MATH_SIMD_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include "common.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary Set to 1 if SSE intrinsics are available on the target, or 0 to
+/// use the portable scalar implementation. May be defined on the command line.
+#ifndef GW_MATH_SSE
+    #if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+        #define GW_MATH_SSE                1
+    #else
+        #define GW_MATH_SSE                0
+    #endif
+#endif /* !defined(GW_MATH_SSE) */
+
+#if GW_MATH_SSE
+    #include <xmmintrin.h>
+#endif
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary A four-component vector or point held in a SIMD register.
+struct vec4_t
+{
+#if GW_MATH_SSE
+    __m128 xyzw;
+#else
+    float  xyzw[4];
+#endif
+};
+
+/// @summary A quaternion held in a SIMD register. The vector part is stored in
+/// xyz and the scalar part in w, matching the float[4] layout in math.hpp.
+struct quat_t
+{
+#if GW_MATH_SSE
+    __m128 xyzw;
+#else
+    float  xyzw[4];
+#endif
+};
+
+/// @summary A 4x4 matrix stored as four columns, matching the column-major
+/// float[16] layout used by the mat4_x functions in math.hpp.
+struct mat4_t
+{
+    vec4_t c[4];
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Loads a vec4_t from four floats. The source need not be aligned.
+/// @param src_xyzw Pointer to the source values.
+/// @return The loaded value.
+inline BACKEND_FORCE_INLINE vec4_t vec4_load(float const *src_xyzw)
+{
+    vec4_t r;
+#if GW_MATH_SSE
+    r.xyzw = _mm_loadu_ps(src_xyzw);
+#else
+    r.xyzw[0] = src_xyzw[0]; r.xyzw[1] = src_xyzw[1];
+    r.xyzw[2] = src_xyzw[2]; r.xyzw[3] = src_xyzw[3];
+#endif
+    return r;
+}
+
+/// @summary Stores a vec4_t to four floats. The destination need not be aligned.
+/// @param dst_xyzw Pointer to the destination storage.
+/// @param v The value to store.
+inline BACKEND_FORCE_INLINE void vec4_store(float *dst_xyzw, vec4_t v)
+{
+#if GW_MATH_SSE
+    _mm_storeu_ps(dst_xyzw, v.xyzw);
+#else
+    dst_xyzw[0] = v.xyzw[0]; dst_xyzw[1] = v.xyzw[1];
+    dst_xyzw[2] = v.xyzw[2]; dst_xyzw[3] = v.xyzw[3];
+#endif
+}
+
+/// @summary Constructs a vec4_t from individual components.
+/// @return The vector (x, y, z, w).
+inline BACKEND_FORCE_INLINE vec4_t vec4_make(float x, float y, float z, float w)
+{
+    vec4_t r;
+#if GW_MATH_SSE
+    r.xyzw = _mm_set_ps(w, z, y, x);
+#else
+    r.xyzw[0] = x; r.xyzw[1] = y; r.xyzw[2] = z; r.xyzw[3] = w;
+#endif
+    return r;
+}
+
+/// @summary Constructs a vec4_t with all components set to the same value.
+/// @param s The value to replicate.
+/// @return The vector (s, s, s, s).
+inline BACKEND_FORCE_INLINE vec4_t vec4_splat(float s)
+{
+    vec4_t r;
+#if GW_MATH_SSE
+    r.xyzw = _mm_set1_ps(s);
+#else
+    r.xyzw[0] = s; r.xyzw[1] = s; r.xyzw[2] = s; r.xyzw[3] = s;
+#endif
+    return r;
+}
+
+/// @summary Replicates one component of a vector into all four components.
+/// @param v The source vector.
+/// @param i The zero-based index of the component to replicate. Must be a
+/// compile-time constant in [0, 3].
+/// @return The vector (v[i], v[i], v[i], v[i]).
+#if GW_MATH_SSE
+    #define VEC4_SPLAT_LANE(_v, _i)                                           \
+        vec4_wrap(_mm_shuffle_ps((_v).xyzw, (_v).xyzw, _MM_SHUFFLE(_i, _i, _i, _i)))
+#else
+    #define VEC4_SPLAT_LANE(_v, _i)                                           \
+        vec4_splat((_v).xyzw[_i])
+#endif
+
+#if GW_MATH_SSE
+/// @summary Wraps a raw SSE register in a vec4_t.
+/// @param v The register contents.
+/// @return The wrapped value.
+inline BACKEND_FORCE_INLINE vec4_t vec4_wrap(__m128 v)
+{
+    vec4_t r;
+    r.xyzw = v;
+    return r;
+}
+#endif
+
+/// @summary Retrieves the x-component of a vector.
+inline BACKEND_FORCE_INLINE float vec4_x(vec4_t v)
+{
+#if GW_MATH_SSE
+    return _mm_cvtss_f32(v.xyzw);
+#else
+    return v.xyzw[0];
+#endif
+}
+
+/// @summary Retrieves the y-component of a vector.
+inline BACKEND_FORCE_INLINE float vec4_y(vec4_t v)
+{
+#if GW_MATH_SSE
+    return _mm_cvtss_f32(_mm_shuffle_ps(v.xyzw, v.xyzw, _MM_SHUFFLE(1, 1, 1, 1)));
+#else
+    return v.xyzw[1];
+#endif
+}
+
+/// @summary Retrieves the z-component of a vector.
+inline BACKEND_FORCE_INLINE float vec4_z(vec4_t v)
+{
+#if GW_MATH_SSE
+    return _mm_cvtss_f32(_mm_movehl_ps(v.xyzw, v.xyzw));
+#else
+    return v.xyzw[2];
+#endif
+}
+
+/// @summary Retrieves the w-component of a vector.
+inline BACKEND_FORCE_INLINE float vec4_w(vec4_t v)
+{
+#if GW_MATH_SSE
+    return _mm_cvtss_f32(_mm_shuffle_ps(v.xyzw, v.xyzw, _MM_SHUFFLE(3, 3, 3, 3)));
+#else
+    return v.xyzw[3];
+#endif
+}
+
+/// @summary Computes the component-wise sum a + b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_add(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_add_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(a.xyzw[0] + b.xyzw[0], a.xyzw[1] + b.xyzw[1], a.xyzw[2] + b.xyzw[2], a.xyzw[3] + b.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the component-wise difference a - b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_sub(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_sub_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(a.xyzw[0] - b.xyzw[0], a.xyzw[1] - b.xyzw[1], a.xyzw[2] - b.xyzw[2], a.xyzw[3] - b.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the component-wise product a * b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_mul(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_mul_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(a.xyzw[0] * b.xyzw[0], a.xyzw[1] * b.xyzw[1], a.xyzw[2] * b.xyzw[2], a.xyzw[3] * b.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the component-wise quotient a / b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_div(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_div_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(a.xyzw[0] / b.xyzw[0], a.xyzw[1] / b.xyzw[1], a.xyzw[2] / b.xyzw[2], a.xyzw[3] / b.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the component-wise minimum of a and b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_min(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_min_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(
+        a.xyzw[0] < b.xyzw[0] ? a.xyzw[0] : b.xyzw[0], a.xyzw[1] < b.xyzw[1] ? a.xyzw[1] : b.xyzw[1],
+        a.xyzw[2] < b.xyzw[2] ? a.xyzw[2] : b.xyzw[2], a.xyzw[3] < b.xyzw[3] ? a.xyzw[3] : b.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the component-wise maximum of a and b.
+inline BACKEND_FORCE_INLINE vec4_t vec4_max(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_max_ps(a.xyzw, b.xyzw));
+#else
+    return vec4_make(
+        a.xyzw[0] < b.xyzw[0] ? b.xyzw[0] : a.xyzw[0], a.xyzw[1] < b.xyzw[1] ? b.xyzw[1] : a.xyzw[1],
+        a.xyzw[2] < b.xyzw[2] ? b.xyzw[2] : a.xyzw[2], a.xyzw[3] < b.xyzw[3] ? b.xyzw[3] : a.xyzw[3]);
+#endif
+}
+
+/// @summary Scales all four components of a vector by a scalar value.
+inline BACKEND_FORCE_INLINE vec4_t vec4_scl(vec4_t a, float b)
+{
+    return vec4_mul(a, vec4_splat(b));
+}
+
+/// @summary Negates all four components of a vector.
+inline BACKEND_FORCE_INLINE vec4_t vec4_neg(vec4_t a)
+{
+#if GW_MATH_SSE
+    return vec4_wrap(_mm_xor_ps(a.xyzw, _mm_set1_ps(-0.0f)));
+#else
+    return vec4_make(-a.xyzw[0], -a.xyzw[1], -a.xyzw[2], -a.xyzw[3]);
+#endif
+}
+
+/// @summary Computes the four-component dot product of a and b.
+inline BACKEND_FORCE_INLINE float vec4_dot(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    __m128 m = _mm_mul_ps(a.xyzw, b.xyzw);
+    __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(s, s)));
+#else
+    return a.xyzw[0] * b.xyzw[0] + a.xyzw[1] * b.xyzw[1] + a.xyzw[2] * b.xyzw[2] + a.xyzw[3] * b.xyzw[3];
+#endif
+}
+
+/// @summary Computes the dot product of the xyz components of a and b.
+inline BACKEND_FORCE_INLINE float vec4_dot3(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    __m128 m = _mm_mul_ps(a.xyzw, b.xyzw);
+    __m128 y = _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_movehl_ps(m, m);
+    return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(m, y), z));
+#else
+    return a.xyzw[0] * b.xyzw[0] + a.xyzw[1] * b.xyzw[1] + a.xyzw[2] * b.xyzw[2];
+#endif
+}
+
+/// @summary Computes the cross product of the xyz components of a and b.
+/// The w-component of the result is zero.
+inline BACKEND_FORCE_INLINE vec4_t vec4_cross(vec4_t a, vec4_t b)
+{
+#if GW_MATH_SSE
+    __m128 a_yzx = _mm_shuffle_ps(a.xyzw, a.xyzw, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 b_yzx = _mm_shuffle_ps(b.xyzw, b.xyzw, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c_zxy = _mm_sub_ps(_mm_mul_ps(a.xyzw, b_yzx), _mm_mul_ps(a_yzx, b.xyzw));
+    return vec4_wrap(_mm_shuffle_ps(c_zxy, c_zxy, _MM_SHUFFLE(3, 0, 2, 1)));
+#else
+    return vec4_make(
+        a.xyzw[1] * b.xyzw[2] - a.xyzw[2] * b.xyzw[1],
+        a.xyzw[2] * b.xyzw[0] - a.xyzw[0] * b.xyzw[2],
+        a.xyzw[0] * b.xyzw[1] - a.xyzw[1] * b.xyzw[0], 0.0f);
+#endif
+}
+
+/// @summary Computes the four-component length of a vector.
+inline BACKEND_FORCE_INLINE float vec4_len(vec4_t a)
+{
+    return sqrtf(vec4_dot(a, a));
+}
+
+/// @summary Normalizes all four components of a vector. The caller must
+/// ensure that the vector has non-zero length.
+inline BACKEND_FORCE_INLINE vec4_t vec4_nrm(vec4_t a)
+{
+    return vec4_scl(a, 1.0f / sqrtf(vec4_dot(a, a)));
+}
+
+/// @summary Performs linear interpolation between two vectors.
+/// @param a The value at t = 0.
+/// @param b The value at t = 1.
+/// @param t The interpolation parameter.
+inline BACKEND_FORCE_INLINE vec4_t vec4_linear(vec4_t a, vec4_t b, float t)
+{
+    return vec4_add(a, vec4_scl(vec4_sub(b, a), t));
+}
+
+/// @summary Reinterprets a vec4_t as a quaternion.
+inline BACKEND_FORCE_INLINE quat_t quat_from_vec4(vec4_t v)
+{
+    quat_t r;
+#if GW_MATH_SSE
+    r.xyzw = v.xyzw;
+#else
+    r.xyzw[0] = v.xyzw[0]; r.xyzw[1] = v.xyzw[1];
+    r.xyzw[2] = v.xyzw[2]; r.xyzw[3] = v.xyzw[3];
+#endif
+    return r;
+}
+
+/// @summary Reinterprets a quaternion as a vec4_t.
+inline BACKEND_FORCE_INLINE vec4_t quat_to_vec4(quat_t q)
+{
+    vec4_t r;
+#if GW_MATH_SSE
+    r.xyzw = q.xyzw;
+#else
+    r.xyzw[0] = q.xyzw[0]; r.xyzw[1] = q.xyzw[1];
+    r.xyzw[2] = q.xyzw[2]; r.xyzw[3] = q.xyzw[3];
+#endif
+    return r;
+}
+
+/// @summary Loads a quaternion from four floats (x, y, z, w).
+inline BACKEND_FORCE_INLINE quat_t quat_load(float const *src_xyzw)
+{
+    return quat_from_vec4(vec4_load(src_xyzw));
+}
+
+/// @summary Stores a quaternion to four floats (x, y, z, w).
+inline BACKEND_FORCE_INLINE void quat_store(float *dst_xyzw, quat_t q)
+{
+    vec4_store(dst_xyzw, quat_to_vec4(q));
+}
+
+/// @summary Constructs the identity quaternion (0, 0, 0, 1).
+inline BACKEND_FORCE_INLINE quat_t quat_ident(void)
+{
+    return quat_from_vec4(vec4_make(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+/// @summary Computes the component-wise sum of two quaternions.
+inline BACKEND_FORCE_INLINE quat_t quat_add(quat_t a, quat_t b)
+{
+    return quat_from_vec4(vec4_add(quat_to_vec4(a), quat_to_vec4(b)));
+}
+
+/// @summary Computes the component-wise difference of two quaternions.
+inline BACKEND_FORCE_INLINE quat_t quat_sub(quat_t a, quat_t b)
+{
+    return quat_from_vec4(vec4_sub(quat_to_vec4(a), quat_to_vec4(b)));
+}
+
+/// @summary Scales all four components of a quaternion.
+inline BACKEND_FORCE_INLINE quat_t quat_scl(quat_t a, float b)
+{
+    return quat_from_vec4(vec4_scl(quat_to_vec4(a), b));
+}
+
+/// @summary Computes the dot product of two quaternions.
+inline BACKEND_FORCE_INLINE float quat_dot(quat_t a, quat_t b)
+{
+    return vec4_dot(quat_to_vec4(a), quat_to_vec4(b));
+}
+
+/// @summary Computes the conjugate (-x, -y, -z, w) of a quaternion.
+inline BACKEND_FORCE_INLINE quat_t quat_conj(quat_t a)
+{
+#if GW_MATH_SSE
+    quat_t r;
+    r.xyzw = _mm_xor_ps(a.xyzw, _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f));
+    return r;
+#else
+    return quat_from_vec4(vec4_make(-a.xyzw[0], -a.xyzw[1], -a.xyzw[2], a.xyzw[3]));
+#endif
+}
+
+/// @summary Computes the quaternion product a * b, using the same convention
+/// as the pointer-based quat_mul() in math.hpp.
+inline BACKEND_FORCE_INLINE quat_t quat_mul(quat_t a, quat_t b)
+{
+#if GW_MATH_SSE
+    // x = aw*bx + ax*bw + ay*bz - az*by
+    // y = aw*by + ay*bw + az*bx - ax*bz
+    // z = aw*bz + az*bw + ax*by - ay*bx
+    // w = aw*bw - ax*bx - ay*by - az*bz
+    __m128 sign = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+    __m128 a_ww = _mm_shuffle_ps(a.xyzw, a.xyzw, _MM_SHUFFLE(3, 3, 3, 3));
+    __m128 a_t2 = _mm_shuffle_ps(a.xyzw, a.xyzw, _MM_SHUFFLE(0, 2, 1, 0));
+    __m128 b_t2 = _mm_shuffle_ps(b.xyzw, b.xyzw, _MM_SHUFFLE(0, 3, 3, 3));
+    __m128 a_t3 = _mm_shuffle_ps(a.xyzw, a.xyzw, _MM_SHUFFLE(1, 0, 2, 1));
+    __m128 b_t3 = _mm_shuffle_ps(b.xyzw, b.xyzw, _MM_SHUFFLE(1, 1, 0, 2));
+    __m128 a_t4 = _mm_shuffle_ps(a.xyzw, a.xyzw, _MM_SHUFFLE(2, 1, 0, 2));
+    __m128 b_t4 = _mm_shuffle_ps(b.xyzw, b.xyzw, _MM_SHUFFLE(2, 0, 2, 1));
+    __m128 t1   = _mm_mul_ps(a_ww, b.xyzw);
+    __m128 t2   = _mm_xor_ps(_mm_mul_ps(a_t2, b_t2), sign);
+    __m128 t3   = _mm_xor_ps(_mm_mul_ps(a_t3, b_t3), sign);
+    __m128 t4   = _mm_mul_ps(a_t4, b_t4);
+    quat_t r;
+    r.xyzw = _mm_sub_ps(_mm_add_ps(_mm_add_ps(t1, t2), t3), t4);
+    return r;
+#else
+    float ax = a.xyzw[0], ay = a.xyzw[1], az = a.xyzw[2], aw = a.xyzw[3];
+    float bx = b.xyzw[0], by = b.xyzw[1], bz = b.xyzw[2], bw = b.xyzw[3];
+    return quat_from_vec4(vec4_make(
+        ((aw * bx) + (ax * bw) + (ay * bz) - (az * by)),
+        ((aw * by) - (ax * bz) + (ay * bw) + (az * bx)),
+        ((aw * bz) + (ax * by) - (ay * bx) + (az * bw)),
+        ((aw * bw) - (ax * bx) - (ay * by) - (az * bz))));
+#endif
+}
+
+/// @summary Normalizes a quaternion. The caller must ensure that the
+/// quaternion has non-zero length.
+inline BACKEND_FORCE_INLINE quat_t quat_nrm(quat_t a)
+{
+    return quat_from_vec4(vec4_nrm(quat_to_vec4(a)));
+}
+
+/// @summary Loads a matrix from sixteen floats in column-major order.
+inline BACKEND_FORCE_INLINE mat4_t mat4_load(float const *src16)
+{
+    mat4_t m;
+    m.c[0] = vec4_load(src16 +  0);
+    m.c[1] = vec4_load(src16 +  4);
+    m.c[2] = vec4_load(src16 +  8);
+    m.c[3] = vec4_load(src16 + 12);
+    return m;
+}
+
+/// @summary Stores a matrix to sixteen floats in column-major order.
+inline BACKEND_FORCE_INLINE void mat4_store(float *dst16, mat4_t const &m)
+{
+    vec4_store(dst16 +  0, m.c[0]);
+    vec4_store(dst16 +  4, m.c[1]);
+    vec4_store(dst16 +  8, m.c[2]);
+    vec4_store(dst16 + 12, m.c[3]);
+}
+
+/// @summary Constructs the 4x4 identity matrix.
+inline BACKEND_FORCE_INLINE mat4_t mat4_ident(void)
+{
+    mat4_t m;
+    m.c[0] = vec4_make(1.0f, 0.0f, 0.0f, 0.0f);
+    m.c[1] = vec4_make(0.0f, 1.0f, 0.0f, 0.0f);
+    m.c[2] = vec4_make(0.0f, 0.0f, 1.0f, 0.0f);
+    m.c[3] = vec4_make(0.0f, 0.0f, 0.0f, 1.0f);
+    return m;
+}
+
+/// @summary Transforms a four-component vector by a matrix, computing m * v.
+inline BACKEND_FORCE_INLINE vec4_t mat4_transform_vec4(mat4_t const &m, vec4_t v)
+{
+    vec4_t r =   vec4_mul(m.c[0], VEC4_SPLAT_LANE(v, 0));
+    r = vec4_add(r, vec4_mul(m.c[1], VEC4_SPLAT_LANE(v, 1)));
+    r = vec4_add(r, vec4_mul(m.c[2], VEC4_SPLAT_LANE(v, 2)));
+    r = vec4_add(r, vec4_mul(m.c[3], VEC4_SPLAT_LANE(v, 3)));
+    return r;
+}
+
+/// @summary Concatenates two transformations. Transformation @a a is applied
+/// first, followed by transformation @a b, as with the pointer-based mat4_concat().
+inline BACKEND_FORCE_INLINE mat4_t mat4_concat(mat4_t const &a, mat4_t const &b)
+{
+    mat4_t r;
+    r.c[0] = mat4_transform_vec4(b, a.c[0]);
+    r.c[1] = mat4_transform_vec4(b, a.c[1]);
+    r.c[2] = mat4_transform_vec4(b, a.c[2]);
+    r.c[3] = mat4_transform_vec4(b, a.c[3]);
+    return r;
+}
+
+/// @summary Computes the transpose of a matrix.
+inline BACKEND_FORCE_INLINE mat4_t mat4_transpose(mat4_t const &m)
+{
+#if GW_MATH_SSE
+    __m128 c0 = m.c[0].xyzw;
+    __m128 c1 = m.c[1].xyzw;
+    __m128 c2 = m.c[2].xyzw;
+    __m128 c3 = m.c[3].xyzw;
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    mat4_t r;
+    r.c[0] = vec4_wrap(c0);
+    r.c[1] = vec4_wrap(c1);
+    r.c[2] = vec4_wrap(c2);
+    r.c[3] = vec4_wrap(c3);
+    return r;
+#else
+    mat4_t r;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+            r.c[i].xyzw[j] = m.c[j].xyzw[i];
+    }
+    return r;
+#endif
+}
+
+#endif /* !defined(GW_MATH_SIMD_HPP) */
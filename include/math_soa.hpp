@@ -0,0 +1,227 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines array kernels that operate on 2D vectors stored in
+/// structure-of-arrays form, with separate x and y arrays. The kernels process
+/// eight (AVX) or four (SSE) vectors per iteration and are intended for the
+/// bulk update of bullets, enemies and particles. The lane operations and the
+/// soa_for_range() driver are public so that systems can fuse several steps
+/// of an update into a single pass over their own arrays.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_MATH_SOA_HPP
+#define GW_MATH_SOA_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "math_simd.hpp"
+
+#ifdef __AVX__
+    #include <immintrin.h>
+#endif
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The recommended alignment, in bytes, of SoA component arrays.
+/// The kernels accept arrays of any alignment, but when every array shares
+/// the same alignment modulo SOA_ALIGNMENT the vector loop runs on aligned
+/// addresses after a short scalar prologue.
+#define SOA_ALIGNMENT                32U
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Lane operations for single floats, used for the prologue and tail.
+/// The prologue length depends on the vector width, so an element may run
+/// through these in one build and through SSE or AVX lanes in another; each
+/// operation rounds exactly as its vector form does, and min and max return
+/// the second operand for equal or unordered inputs, as minps and maxps do.
+struct soa_lane1_t
+{
+    typedef float value_t;
+    static const size_t WIDTH = 1;
+    static BACKEND_FORCE_INLINE value_t load(float const *p)             { return *p; }
+    static BACKEND_FORCE_INLINE void    store(float *p, value_t v)       { *p = v; }
+    static BACKEND_FORCE_INLINE value_t splat(float s)                   { return s; }
+    static BACKEND_FORCE_INLINE value_t add(value_t a, value_t b)        { return a + b; }
+    static BACKEND_FORCE_INLINE value_t sub(value_t a, value_t b)        { return a - b; }
+    static BACKEND_FORCE_INLINE value_t mul(value_t a, value_t b)        { return a * b; }
+    static BACKEND_FORCE_INLINE value_t div(value_t a, value_t b)        { return a / b; }
+    static BACKEND_FORCE_INLINE value_t min(value_t a, value_t b)        { return a < b ? a : b; }
+    static BACKEND_FORCE_INLINE value_t max(value_t a, value_t b)        { return a > b ? a : b; }
+    static BACKEND_FORCE_INLINE value_t sqrt(value_t a)                  { return sqrtf(a); }
+    static BACKEND_FORCE_INLINE value_t select_lt(value_t a, value_t b, value_t v) { return a < b ? v : 0.0f; }
+};
+
+#if GW_MATH_SSE
+/// @summary Lane operations for four floats held in an SSE register.
+struct soa_lane4_t
+{
+    typedef __m128 value_t;
+    static const size_t WIDTH = 4;
+    static BACKEND_FORCE_INLINE value_t load(float const *p)             { return _mm_loadu_ps(p); }
+    static BACKEND_FORCE_INLINE void    store(float *p, value_t v)       { _mm_storeu_ps(p, v); }
+    static BACKEND_FORCE_INLINE value_t splat(float s)                   { return _mm_set1_ps(s); }
+    static BACKEND_FORCE_INLINE value_t add(value_t a, value_t b)        { return _mm_add_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t sub(value_t a, value_t b)        { return _mm_sub_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t mul(value_t a, value_t b)        { return _mm_mul_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t div(value_t a, value_t b)        { return _mm_div_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t min(value_t a, value_t b)        { return _mm_min_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t max(value_t a, value_t b)        { return _mm_max_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t sqrt(value_t a)                  { return _mm_sqrt_ps(a); }
+    static BACKEND_FORCE_INLINE value_t select_lt(value_t a, value_t b, value_t v) { return _mm_and_ps(_mm_cmplt_ps(a, b), v); }
+};
+#endif /* GW_MATH_SSE */
+
+#ifdef __AVX__
+/// @summary Lane operations for eight floats held in an AVX register.
+struct soa_lane8_t
+{
+    typedef __m256 value_t;
+    static const size_t WIDTH = 8;
+    static BACKEND_FORCE_INLINE value_t load(float const *p)             { return _mm256_loadu_ps(p); }
+    static BACKEND_FORCE_INLINE void    store(float *p, value_t v)       { _mm256_storeu_ps(p, v); }
+    static BACKEND_FORCE_INLINE value_t splat(float s)                   { return _mm256_set1_ps(s); }
+    static BACKEND_FORCE_INLINE value_t add(value_t a, value_t b)        { return _mm256_add_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t sub(value_t a, value_t b)        { return _mm256_sub_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t mul(value_t a, value_t b)        { return _mm256_mul_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t div(value_t a, value_t b)        { return _mm256_div_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t min(value_t a, value_t b)        { return _mm256_min_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t max(value_t a, value_t b)        { return _mm256_max_ps(a, b); }
+    static BACKEND_FORCE_INLINE value_t sqrt(value_t a)                  { return _mm256_sqrt_ps(a); }
+    static BACKEND_FORCE_INLINE value_t select_lt(value_t a, value_t b, value_t v) { return _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ), v); }
+};
+#endif /* defined(__AVX__) */
+
+/// @summary The widest lane type available on the target.
+#if   defined(__AVX__)
+typedef soa_lane8_t soa_wide_t;
+#elif GW_MATH_SSE
+typedef soa_lane4_t soa_wide_t;
+#else
+typedef soa_lane1_t soa_wide_t;
+#endif
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Runs a kernel over the range [begin, end). Elements are processed
+/// one at a time until primary is aligned to the vector width, then a vector
+/// at a time, then one at a time for the remainder. The kernel type must
+/// define a member template run<L>(size_t i) that processes L::WIDTH elements
+/// starting at index i using the lane operations of L.
+/// @param k The kernel to run.
+/// @param primary The array used to determine alignment.
+/// @param begin The index of the first element to process.
+/// @param end The index one past the last element to process.
+template <typename K>
+inline void soa_for_range(K const &k, float const *primary, size_t begin, size_t end)
+{
+    size_t const width = soa_wide_t::WIDTH;
+    size_t const bytes = width * sizeof(float);
+    uintptr_t    addr  = uintptr_t(primary + begin);
+    size_t       peel  = ((bytes - (addr & (bytes - 1))) & (bytes - 1)) / sizeof(float);
+    size_t       i     = begin;
+    if ((addr & (sizeof(float) - 1)) != 0)
+    {
+        // the array is not float-aligned and never will be vector-aligned.
+        peel = 0;
+    }
+    if (peel > end - begin) peel = end - begin;
+    for ( ; i < begin + peel; ++i)
+    {
+        k.template run<soa_lane1_t>(i);
+    }
+    for ( ; i + width <= end; i += width)
+    {
+        k.template run<soa_wide_t>(i);
+    }
+    for ( ; i < end; ++i)
+    {
+        k.template run<soa_lane1_t>(i);
+    }
+}
+
+/// @summary Accumulates a scaled vector array into another, computing
+/// y += a * x for each element. Use with (position, velocity, dt) and
+/// (velocity, acceleration, dt) to integrate motion.
+/// @param y_x The x-components of the accumulator, updated in place.
+/// @param y_y The y-components of the accumulator, updated in place.
+/// @param x_x The x-components of the scaled input.
+/// @param x_y The y-components of the scaled input.
+/// @param a The scale factor applied to x.
+/// @param count The number of vectors to process.
+void vec2_soa_axpy(float * __restrict y_x, float * __restrict y_y, float const * __restrict x_x, float const * __restrict x_y, float a, size_t count);
+
+/// @summary Scales each vector in an array in place.
+/// @param x The x-components, updated in place.
+/// @param y The y-components, updated in place.
+/// @param s The scale factor.
+/// @param count The number of vectors to process.
+void vec2_soa_scale(float * __restrict x, float * __restrict y, float s, size_t count);
+
+/// @summary Normalizes each vector in an array in place. Unlike vec2_nrm(),
+/// zero-length vectors are left as zero so that the result can be used
+/// directly as a direction without further checks.
+/// @param x The x-components, updated in place.
+/// @param y The y-components, updated in place.
+/// @param count The number of vectors to process.
+void vec2_soa_normalize(float * __restrict x, float * __restrict y, size_t count);
+
+/// @summary Computes the unit direction of each vector in an array, for use
+/// as a (cos, sin) orientation without calling atan2. Zero-length vectors
+/// produce (1, 0), matching an angle of zero. The outputs may alias the
+/// inputs, in which case the vectors are normalized in place.
+/// @param dst_cos The output x-components, the cosine of each orientation.
+/// @param dst_sin The output y-components, the sine of each orientation.
+/// @param x The x-components.
+/// @param y The y-components.
+/// @param count The number of vectors to process.
+void vec2_soa_direction(float *dst_cos, float *dst_sin, float const *x, float const *y, size_t count);
+
+/// @summary Computes the length of each vector in an array.
+/// @param dst The output lengths.
+/// @param x The x-components.
+/// @param y The y-components.
+/// @param count The number of vectors to process.
+void vec2_soa_length(float * __restrict dst, float const * __restrict x, float const * __restrict y, size_t count);
+
+/// @summary Clamps each point in an array to an axis-aligned rectangle.
+/// @param x The x-components, updated in place.
+/// @param y The y-components, updated in place.
+/// @param min_x The minimum x-coordinate of the rectangle.
+/// @param min_y The minimum y-coordinate of the rectangle.
+/// @param max_x The maximum x-coordinate of the rectangle.
+/// @param max_y The maximum y-coordinate of the rectangle.
+/// @param count The number of points to process.
+void vec2_soa_clamp_rect(float * __restrict x, float * __restrict y, float min_x, float min_y, float max_x, float max_y, size_t count);
+
+/// @summary Computes the distance from each point in an array to a point.
+/// @param dst The output distances.
+/// @param x The x-components.
+/// @param y The y-components.
+/// @param px The x-coordinate of the reference point.
+/// @param py The y-coordinate of the reference point.
+/// @param count The number of points to process.
+void vec2_soa_distance(float * __restrict dst, float const * __restrict x, float const * __restrict y, float px, float py, size_t count);
+
+/// @summary Accumulates an attractive force toward a center point for each
+/// point in an array. The force on a point at offset r from the center is
+/// strength * r / (|r|^2 + softening)^(3/2), a softened inverse-square law
+/// that stays finite at the center. Points farther than radius from the
+/// center are unaffected. Specify a negative strength to repel.
+/// @param fx The x-components of the force accumulator, updated in place.
+/// @param fy The y-components of the force accumulator, updated in place.
+/// @param x The x-components of the point positions.
+/// @param y The y-components of the point positions.
+/// @param cx The x-coordinate of the center of the force.
+/// @param cy The y-coordinate of the center of the force.
+/// @param strength The strength of the force.
+/// @param radius The radius beyond which the force has no effect.
+/// @param softening A small positive value that limits the force near the center.
+/// @param count The number of points to process.
+void vec2_soa_radial_force(float * __restrict fx, float * __restrict fy, float const * __restrict x, float const * __restrict y, float cx, float cy, float strength, float radius, float softening, size_t count);
+
+#endif /* !defined(GW_MATH_SOA_HPP) */
@@ -0,0 +1,305 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements range-reduced polynomial approximations of sin, cos and
+/// atan2 in scalar, 4-wide (SSE) and 8-wide (AVX) forms. Each routine accepts
+/// an accuracy tier so that callers can trade precision for throughput.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_MATH_TRIG_HPP
+#define GW_MATH_TRIG_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include "common.hpp"
+#include "math_simd.hpp"
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary Set to 1 if SSE2 integer intrinsics are available on the target.
+#ifndef GW_MATH_SSE2
+    #if GW_MATH_SSE && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+        #define GW_MATH_SSE2               1
+    #else
+        #define GW_MATH_SSE2               0
+    #endif
+#endif /* !defined(GW_MATH_SSE2) */
+
+#if GW_MATH_SSE2
+    #include <emmintrin.h>
+#endif
+
+/// @summary The largest magnitude argument for which fast_sin, fast_cos and
+/// fast_sincos maintain the documented error bounds. Larger arguments lose
+/// precision during range reduction.
+#define TRIG_MAX_ARGUMENT          8192.0f
+
+/// @summary Constants used for the argument reduction x = q * pi/2 + r. The
+/// three parts of pi/2 have trailing zero bits so that q * part is exact.
+#define TRIG_2_OVER_PI             0.636619772367581343f
+#define TRIG_PIO2_HI               1.5703125f
+#define TRIG_PIO2_MD               4.837512969970703125e-4f
+#define TRIG_PIO2_LO               7.54978995489188216e-8f
+#define TRIG_PI                    3.14159265358979324f
+#define TRIG_PI_OVER_2             1.57079632679489662f
+#define TRIG_PI_OVER_4             0.785398163397448310f
+#define TRIG_TAN_PI_OVER_8         0.414213562373095049f
+
+/// @summary Polynomial coefficients for the fast tier, least-squares fit on
+/// [-pi/4, pi/4] for sin and cos and on [0, 1] for atan.
+#define TRIG_FAST_S3              -0.16663964f
+#define TRIG_FAST_S5               0.0081774633f
+#define TRIG_FAST_C2              -0.49981581f
+#define TRIG_FAST_C4               0.040588127f
+#define TRIG_FAST_A1               0.99931617f
+#define TRIG_FAST_A3              -0.32228243f
+#define TRIG_FAST_A5               0.14902187f
+#define TRIG_FAST_A7              -0.040855996f
+
+/// @summary Polynomial coefficients for the precise tier, from the Cephes
+/// single-precision sinf, cosf and atanf implementations.
+#define TRIG_PRECISE_S3           -1.6666654611e-1f
+#define TRIG_PRECISE_S5            8.3321608736e-3f
+#define TRIG_PRECISE_S7           -1.9515295891e-4f
+#define TRIG_PRECISE_C4            4.166664568298827e-2f
+#define TRIG_PRECISE_C6           -1.388731625493765e-3f
+#define TRIG_PRECISE_C8            2.443315711809948e-5f
+#define TRIG_PRECISE_A3           -3.33329491539e-1f
+#define TRIG_PRECISE_A5            1.99777106478e-1f
+#define TRIG_PRECISE_A7           -1.38776856032e-1f
+#define TRIG_PRECISE_A9            8.05374449538e-2f
+
+/// @summary Defines the accuracy tiers supported by the trig routines. Error
+/// bounds were measured exhaustively over every float in the supported domain
+/// against the double-precision libm result. ULP errors for sin and cos are
+/// measured where |result| >= 2^-10; closer to a root, the absolute error
+/// bound applies.
+enum trig_tier_e
+{
+    /// Degree-5 sin, degree-4 cos, degree-7 atan. sin/cos max abs error 2.7e-5
+    /// (max 438 ULP); atan2 max abs error 2.0e-4 radians (max 11473 ULP, near
+    /// zero). Suitable for sprite rotation and other purely visual uses.
+    TRIG_TIER_FAST    = 0,
+    /// Degree-7 sin, degree-8 cos, degree-9 atan. sin/cos max abs error 9.4e-8
+    /// (max 2 ULP); atan2 max abs error 2.8e-7 radians (max 3 ULP). Suitable
+    /// for simulation and gameplay.
+    TRIG_TIER_PRECISE = 1
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Computes the sine and cosine of an angle.
+/// @param x The angle, in radians. Must be finite; see TRIG_MAX_ARGUMENT.
+/// @param out_sin On return, set to the sine of x.
+/// @param out_cos On return, set to the cosine of x.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+inline BACKEND_FORCE_INLINE void fast_sincos(float x, float &out_sin, float &out_cos, int tier)
+{
+    float   q  = floorf(x * TRIG_2_OVER_PI + 0.5f);
+    int32_t qi = int32_t(q);
+    float   r  = ((x - q * TRIG_PIO2_HI) - q * TRIG_PIO2_MD) - q * TRIG_PIO2_LO;
+    float   z  = r * r;
+    float   s, c;
+    if (tier == TRIG_TIER_FAST)
+    {
+        s = r + r * z * (TRIG_FAST_S3 + z * TRIG_FAST_S5);
+        c = 1.0f  + z * (TRIG_FAST_C2 + z * TRIG_FAST_C4);
+    }
+    else
+    {
+        s = r + r * z * (TRIG_PRECISE_S3 + z * (TRIG_PRECISE_S5 + z * TRIG_PRECISE_S7));
+        c = 1.0f - 0.5f * z + z * z * (TRIG_PRECISE_C4 + z * (TRIG_PRECISE_C6 + z * TRIG_PRECISE_C8));
+    }
+    // x = q * pi/2 + r, so the quadrant q selects and negates the results.
+    out_sin = (qi & 1) ? c : s;
+    out_cos = (qi & 1) ? s : c;
+    if ( qi      & 2) out_sin = -out_sin;
+    if ((qi + 1) & 2) out_cos = -out_cos;
+}
+
+/// @summary Computes the sine of an angle.
+/// @param x The angle, in radians. Must be finite; see TRIG_MAX_ARGUMENT.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+/// @return The sine of x.
+inline BACKEND_FORCE_INLINE float fast_sin(float x, int tier)
+{
+    float s, c;
+    fast_sincos(x, s, c, tier);
+    return s;
+}
+
+/// @summary Computes the cosine of an angle.
+/// @param x The angle, in radians. Must be finite; see TRIG_MAX_ARGUMENT.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+/// @return The cosine of x.
+inline BACKEND_FORCE_INLINE float fast_cos(float x, int tier)
+{
+    float s, c;
+    fast_sincos(x, s, c, tier);
+    return c;
+}
+
+/// @summary Computes the angle of the vector (x, y) from the positive x-axis.
+/// @param y The y-component of the vector. Must be finite.
+/// @param x The x-component of the vector. Must be finite.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+/// @return The angle, in radians, in [-pi, pi]. Signed zeros are handled as
+/// by libm: atan2(+-0, +0) is +-0 and atan2(+-0, -0) is +-pi.
+inline BACKEND_FORCE_INLINE float fast_atan2(float y, float x, int tier)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float mn = ax < ay ? ax : ay;
+    float mx = ax < ay ? ay : ax;
+    float t  = mx > 0.0f ? mn / mx : 0.0f;
+    float a;
+    if (tier == TRIG_TIER_FAST)
+    {
+        float z = t * t;
+        a = t * (TRIG_FAST_A1 + z * (TRIG_FAST_A3 + z * (TRIG_FAST_A5 + z * TRIG_FAST_A7)));
+    }
+    else
+    {
+        float o = 0.0f;
+        if (t > TRIG_TAN_PI_OVER_8)
+        {
+            t = (t - 1.0f) / (t + 1.0f);
+            o = TRIG_PI_OVER_4;
+        }
+        float z = t * t;
+        a = o + t + t * z * (TRIG_PRECISE_A3 + z * (TRIG_PRECISE_A5 + z * (TRIG_PRECISE_A7 + z * TRIG_PRECISE_A9)));
+    }
+    if (ay > ax)     a = TRIG_PI_OVER_2 - a;
+    if (signbit(x))  a = TRIG_PI - a;
+    return copysignf(a, y);
+}
+
+/// @summary Computes the sine and cosine of four angles.
+/// @param x The angles, in radians. Must be finite; see TRIG_MAX_ARGUMENT.
+/// @param out_sin On return, set to the sines of x.
+/// @param out_cos On return, set to the cosines of x.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+inline BACKEND_FORCE_INLINE void fast_sincos(vec4_t x, vec4_t &out_sin, vec4_t &out_cos, int tier)
+{
+#if GW_MATH_SSE2
+    __m128i qi = _mm_cvtps_epi32(_mm_mul_ps(x.xyzw, _mm_set1_ps(TRIG_2_OVER_PI)));
+    __m128  q  = _mm_cvtepi32_ps(qi);
+    __m128  r  = _mm_sub_ps(x.xyzw, _mm_mul_ps(q, _mm_set1_ps(TRIG_PIO2_HI)));
+            r  = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(TRIG_PIO2_MD)));
+            r  = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(TRIG_PIO2_LO)));
+    __m128  z  = _mm_mul_ps(r, r);
+    __m128  s, c;
+    if (tier == TRIG_TIER_FAST)
+    {
+        s = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_FAST_S5)), _mm_set1_ps(TRIG_FAST_S3));
+        s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), s));
+        c = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_FAST_C4)), _mm_set1_ps(TRIG_FAST_C2));
+        c = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, c));
+    }
+    else
+    {
+        s = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_PRECISE_S7)), _mm_set1_ps(TRIG_PRECISE_S5));
+        s = _mm_add_ps(_mm_mul_ps(z, s), _mm_set1_ps(TRIG_PRECISE_S3));
+        s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), s));
+        c = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_PRECISE_C8)), _mm_set1_ps(TRIG_PRECISE_C6));
+        c = _mm_add_ps(_mm_mul_ps(z, c), _mm_set1_ps(TRIG_PRECISE_C4));
+        c = _mm_mul_ps(_mm_mul_ps(z, z), c);
+        c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), c);
+    }
+    // swap where q is odd; bit 1 of q (or q+1) moved into the sign bit negates.
+    __m128i one  = _mm_set1_epi32(1);
+    __m128i two  = _mm_set1_epi32(2);
+    __m128  swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(qi, one), one));
+    __m128  sneg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(qi, two), 30));
+    __m128  cneg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(qi, one), two), 30));
+    __m128  ss   = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128  cc   = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+    out_sin.xyzw = _mm_xor_ps(ss, sneg);
+    out_cos.xyzw = _mm_xor_ps(cc, cneg);
+#else
+    float src[4], dst_s[4], dst_c[4];
+    vec4_store(src, x);
+    for (size_t i = 0; i < 4; ++i)
+        fast_sincos(src[i], dst_s[i], dst_c[i], tier);
+    out_sin = vec4_load(dst_s);
+    out_cos = vec4_load(dst_c);
+#endif
+}
+
+/// @summary Computes the angles of four vectors (x, y) from the positive x-axis.
+/// @param y The y-components of the vectors. Must be finite.
+/// @param x The x-components of the vectors. Must be finite.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+/// @return The angles, in radians, in [-pi, pi]. Signed zeros are handled
+/// as by libm.
+inline BACKEND_FORCE_INLINE vec4_t fast_atan2(vec4_t y, vec4_t x, int tier)
+{
+#if GW_MATH_SSE
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 ax   = _mm_andnot_ps(sign, x.xyzw);
+    __m128 ay   = _mm_andnot_ps(sign, y.xyzw);
+    __m128 mn   = _mm_min_ps(ax, ay);
+    __m128 mx   = _mm_max_ps(ax, ay);
+    __m128 t    = _mm_and_ps(_mm_div_ps(mn, mx), _mm_cmpgt_ps(mx, _mm_setzero_ps()));
+    __m128 a;
+    if (tier == TRIG_TIER_FAST)
+    {
+        __m128 z = _mm_mul_ps(t, t);
+        a = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_FAST_A7)), _mm_set1_ps(TRIG_FAST_A5));
+        a = _mm_add_ps(_mm_mul_ps(z, a), _mm_set1_ps(TRIG_FAST_A3));
+        a = _mm_add_ps(_mm_mul_ps(z, a), _mm_set1_ps(TRIG_FAST_A1));
+        a = _mm_mul_ps(t, a);
+    }
+    else
+    {
+        __m128 big = _mm_cmpgt_ps(t, _mm_set1_ps(TRIG_TAN_PI_OVER_8));
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 tr  = _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one));
+        __m128 o   = _mm_and_ps(big, _mm_set1_ps(TRIG_PI_OVER_4));
+               t   = _mm_or_ps(_mm_and_ps(big, tr), _mm_andnot_ps(big, t));
+        __m128 z   = _mm_mul_ps(t, t);
+        a = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(TRIG_PRECISE_A9)), _mm_set1_ps(TRIG_PRECISE_A7));
+        a = _mm_add_ps(_mm_mul_ps(z, a), _mm_set1_ps(TRIG_PRECISE_A5));
+        a = _mm_add_ps(_mm_mul_ps(z, a), _mm_set1_ps(TRIG_PRECISE_A3));
+        a = _mm_add_ps(o, _mm_add_ps(t, _mm_mul_ps(_mm_mul_ps(t, z), a)));
+    }
+    __m128 swap = _mm_cmpgt_ps(ay, ax);
+    // test the sign bit of x rather than x < 0 so that x = -0 selects pi.
+    __m128 negx = _mm_cmplt_ps(_mm_or_ps(_mm_and_ps(sign, x.xyzw), _mm_set1_ps(1.0f)), _mm_setzero_ps());
+    a = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps(TRIG_PI_OVER_2), a)), _mm_andnot_ps(swap, a));
+    a = _mm_or_ps(_mm_and_ps(negx, _mm_sub_ps(_mm_set1_ps(TRIG_PI), a)), _mm_andnot_ps(negx, a));
+    vec4_t r;
+    r.xyzw = _mm_or_ps(a, _mm_and_ps(sign, y.xyzw));
+    return r;
+#else
+    float src_y[4], src_x[4], dst[4];
+    vec4_store(src_y, y);
+    vec4_store(src_x, x);
+    for (size_t i = 0; i < 4; ++i)
+        dst[i] = fast_atan2(src_y[i], src_x[i], tier);
+    return vec4_load(dst);
+#endif
+}
+
+/// @summary Computes the sine and cosine of an array of angles. Uses 8-wide
+/// AVX operations when compiled with AVX support, otherwise 4-wide SSE.
+/// @param dst_sin Storage for count values receiving the sines.
+/// @param dst_cos Storage for count values receiving the cosines.
+/// @param src The angles, in radians. Must be finite; see TRIG_MAX_ARGUMENT.
+/// @param count The number of angles to process.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+void fast_sincos_array(float * __restrict dst_sin, float * __restrict dst_cos, float const * __restrict src, size_t count, int tier);
+
+/// @summary Computes the angles of an array of vectors (x, y). Uses 8-wide AVX
+/// operations when compiled with AVX support, otherwise 4-wide SSE.
+/// @param dst Storage for count values receiving the angles, in [-pi, pi].
+/// @param src_y The y-components of the vectors.
+/// @param src_x The x-components of the vectors.
+/// @param count The number of vectors to process.
+/// @param tier One of trig_tier_e selecting the approximation to use.
+void fast_atan2_array(float * __restrict dst, float const * __restrict src_y, float const * __restrict src_x, size_t count, int tier);
+
+#endif /* !defined(GW_MATH_TRIG_HPP) */
@@ -0,0 +1,159 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines the particle system used for sparks, explosions and other
+/// short-lived effects. Particle attributes are stored in structure-of-arrays
+/// form and updated in bulk using SIMD kernels split across the task pool.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_PARTICLE_HPP
+#define GW_PARTICLE_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "display.hpp"
+#include "field.hpp"
+#include "math_rng.hpp"
+#include "ll_snapshot.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The default maximum number of live particles.
+#define PARTICLE_CAPACITY            (512U * 1024U)
+
+/// @summary The minimum number of particles updated by a single task.
+#define PARTICLE_MIN_CHUNK           (16U * 1024U)
+
+/// @summary The fraction of particle velocity retained over 1/60th of a second.
+#define PARTICLE_DRAG                (0.96f)
+
+/// @summary The number of particles emitted per block in EmitBurst.
+#define PARTICLE_BURST_BLOCK         (64U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Manages the pool of live particles. Particles occupy the range
+/// [0, Count) of each attribute array; expired particles are removed by moving
+/// the last live particle into their slot. When the pool is full, new
+/// particles replace existing ones in ring order.
+class ParticleManager
+{
+private:
+    static ParticleManager *PM;
+public:
+    static ParticleManager* GetInstance(void);
+
+private:
+    task_pool_t  *TaskPool;     /// The pool used to split the update, or NULL.
+    Texture      *Image;        /// The texture used to render every particle.
+    void         *Memory;       /// The single allocation backing all arrays.
+    float        *PosX;         /// The x-coordinate of each particle.
+    float        *PosY;         /// The y-coordinate of each particle.
+    float        *VelX;         /// The x-velocity of each particle, in pixels per second.
+    float        *VelY;         /// The y-velocity of each particle, in pixels per second.
+    float        *Life;         /// The remaining lifetime of each particle, in seconds.
+    float        *InvDuration;  /// The reciprocal of the total lifetime of each particle.
+    float        *Alpha;        /// The fade factor of each particle, in [0, 1].
+    float        *Scale;        /// The uniform scale factor of each particle.
+    float        *FacingCos;    /// Scratch storage for the direction of travel during Draw.
+    float        *FacingSin;    /// Scratch storage for the direction of travel during Draw.
+    uint32_t     *Color;        /// The packed ABGR base color of each particle.
+    uint32_t     *Tint;         /// Scratch storage for faded colors during Draw.
+    size_t        Capacity;     /// The maximum number of live particles.
+    size_t        Count;        /// The number of live particles.
+    size_t        NextReplace;  /// The slot replaced next when the pool is full.
+    float         BurstScale;   /// The fraction of the requested particles emitted by EmitBurst.
+    rng8_state_t  Random;       /// The generator used for burst directions.
+
+public:
+    /// @summary Allocates storage for the particle pool.
+    /// @param capacity The maximum number of live particles.
+    /// @param pool The task pool used to split the update, or NULL.
+    ParticleManager(size_t capacity, task_pool_t *pool);
+    ~ParticleManager(void);
+
+public:
+    size_t GetCount(void) const { return Count; }
+    size_t GetCapacity(void) const { return Capacity; }
+
+    /// @summary Scales the number of particles emitted by every burst, to shed
+    /// load when the simulation is over budget. Bursts always emit at least
+    /// one particle.
+    /// @param scale The fraction of the requested particles to emit, in (0, 1].
+    void SetBurstScale(float scale) { BurstScale = scale; }
+
+public:
+    /// @summary Performs one-time initialization of rendering resources.
+    /// @param dm The DisplayManager, which can be used to retrieve textures.
+    void Init(DisplayManager *dm);
+
+    /// @summary Removes all live particles.
+    void Clear(void);
+
+    /// @summary Spawns a single particle.
+    /// @param x The x-coordinate of the particle, in pixels.
+    /// @param y The y-coordinate of the particle, in pixels.
+    /// @param vx The x-velocity of the particle, in pixels per second.
+    /// @param vy The y-velocity of the particle, in pixels per second.
+    /// @param rgba The RGBA base color of the particle.
+    /// @param duration The lifetime of the particle, in seconds.
+    /// @param scale The uniform scale factor of the particle.
+    void Emit(float x, float y, float vx, float vy, float const *rgba, float duration, float scale);
+
+    /// @summary Spawns a number of particles radiating from a point in random
+    /// directions with random speeds.
+    /// @param x The x-coordinate of the origin, in pixels.
+    /// @param y The y-coordinate of the origin, in pixels.
+    /// @param count The number of particles to spawn.
+    /// @param min_speed The minimum speed of a particle, in pixels per second.
+    /// @param max_speed The maximum speed of a particle, in pixels per second.
+    /// @param rgba The RGBA base color of the particles.
+    /// @param duration The lifetime of each particle, in seconds.
+    /// @param scale The uniform scale factor of each particle.
+    void EmitBurst(float x, float y, size_t count, float min_speed, float max_speed, float const *rgba, float duration, float scale);
+
+    /// @summary Accelerates all particles according to a force field. This
+    /// should be called before Update for the same tick.
+    /// @param field The force field to apply.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    void ApplyForceField(force_field_t const *field, double elapsedTime);
+
+    /// @summary Executes a single simulation tick for all particles, applying
+    /// drag, integrating position, fading, and removing expired particles.
+    /// @param currentTime The current simulation time, in seconds.
+    /// @param elapsedTime The time elapsed since the last simulation tick.
+    void Update(double currentTime, double elapsedTime);
+
+    /// @summary Appends the simulation state of every particle to a snapshot.
+    /// @param buffer The snapshot buffer to append to.
+    /// @return true if the state was written.
+    bool Save(snapshot_buffer_t *buffer) const;
+
+    /// @summary Replaces the simulation state of every particle with state
+    /// previously written by Save.
+    /// @param buffer The snapshot buffer to read from.
+    /// @return true if the state was restored.
+    bool Restore(snapshot_buffer_t *buffer);
+
+    /// @summary Submits all live particles to the default sprite batch using
+    /// additive blending. The blend mode remains additive on return.
+    /// @param currentTime The current game time, in seconds.
+    /// @param elapsedTime The time elapsed since the previous frame, in seconds.
+    /// @param dm The display manager used to submit rendering commands.
+    void Draw(double currentTime, double elapsedTime, DisplayManager *dm);
+
+private:
+    size_t Allocate(void);
+    ParticleManager(ParticleManager const &other);
+    ParticleManager& operator =(ParticleManager const &other);
+};
+
+#endif /* !defined(GW_PARTICLE_HPP) */
@@ -19,14 +19,11 @@
 class Player : public Entity
 {
 protected:
-    float TargetPoint[2];
-    float TargetVector[2];
-    float CooldownRemaining;
-    float TimeUntilRespawn;
-    float ViewportWidth;
-    float ViewportHeight;
+    float WorldWidth;
+    float WorldHeight;
     float ShipSpeed;
     int   PlayerIndex;
+    Texture *BeamImage;
 
 public:
     Player(int index);
@@ -41,9 +38,17 @@ public:
     /// @return true if the player is dead or waiting to respawn.
     bool IsDead(void) const;
 
-    /// @summary Marks the player as being dead.
+    /// @summary Marks the player as being dead and schedules the respawn.
     void Kill(void);
 
+    /// @summary Allows the player to fire again once the weapon cooldown
+    /// timer has expired.
+    void Reload(void);
+
+    /// @summary Returns a dead player to the center of the screen once the
+    /// respawn timer has expired.
+    void Respawn(void);
+
 public:
     /// @summary Perform initialization when the entity is spawned.
     /// @param dm The DisplayManager, which can be used to retrieve textures.
@@ -0,0 +1,83 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Defines ray casts against the circles stored in a spatial grid.
+/// Rays walk the grid cell by cell using a DDA traversal, and only the points
+/// in cells near the ray are tested, several at a time, with SIMD ray-versus-
+/// circle checks. Large batches of rays are split across the task pool.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+#ifndef GW_RAYCAST_HPP
+#define GW_RAYCAST_HPP
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "common.hpp"
+#include "ll_spatial.hpp"
+
+/*//////////////////////////
+//  Forward Declarations  //
+//////////////////////////*/
+struct task_pool_t;
+
+/*///////////////
+//  Constants  //
+///////////////*/
+/// @summary The minimum number of rays cast by a single task.
+#define RAYCAST_MIN_CHUNK            (16U)
+
+/// @summary The largest number of cells, measured from the cell containing
+/// the ray, that are searched for circles overlapping the ray. Circles with
+/// radius larger than RAYCAST_MAX_REACH cells may be missed.
+#define RAYCAST_MAX_REACH            (4U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Describes a ray segment.
+struct ray_t
+{
+    float    OriginX;           /// The x-coordinate of the start of the ray.
+    float    OriginY;           /// The y-coordinate of the start of the ray.
+    float    DirX;              /// The x-component of the unit direction.
+    float    DirY;              /// The y-component of the unit direction.
+    float    Length;            /// The length of the ray segment.
+};
+
+/// @summary Describes the intersection of a ray with a circle.
+struct ray_hit_t
+{
+    uint32_t Item;              /// The index of the point, in the order passed to spatial_grid_build().
+    float    Distance;          /// The distance along the ray to the intersection.
+};
+
+/*///////////////
+//  Functions  //
+///////////////*/
+/// @summary Finds the circles intersected by a ray, nearest first. A ray that
+/// starts inside of a circle hits it at distance zero. The traversal stops as
+/// soon as the nearest max_hits intersections are known. Only the portion of
+/// the ray that lies inside of the grid region is traversed.
+/// @param grid The spatial grid containing the circles.
+/// @param ray The ray to cast.
+/// @param max_hits The maximum number of intersections to return; specify 1
+/// to find only the first hit.
+/// @param hits An array of max_hits elements that receives the intersections,
+/// sorted by increasing distance.
+/// @return The number of intersections written to hits.
+size_t raycast(spatial_grid_t const *grid, ray_t const &ray, size_t max_hits, ray_hit_t *hits);
+
+/// @summary Casts a batch of rays. The grid must not be modified while the
+/// batch is in progress.
+/// @param grid The spatial grid containing the circles.
+/// @param rays The rays to cast.
+/// @param count The number of rays.
+/// @param max_hits The maximum number of intersections to return per ray.
+/// @param hits An array of count * max_hits elements. The intersections of
+/// ray i are written starting at hits[i * max_hits].
+/// @param hit_counts An array of count elements that receives the number of
+/// intersections found for each ray.
+/// @param pool The task pool used to split the work, or NULL.
+void raycast_batch(spatial_grid_t const *grid, ray_t const *rays, size_t count, size_t max_hits, ray_hit_t *hits, size_t *hit_counts, task_pool_t *pool);
+
+#endif /* !defined(GW_RAYCAST_HPP) */
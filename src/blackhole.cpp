@@ -0,0 +1,111 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the game logic associated with a black hole.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include "math.hpp"
+#include "math_trig.hpp"
+#include "blackhole.hpp"
+#include "grid.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The strength of the pull toward the black hole. Well outside of
+/// the softening distance the acceleration is PULL_STRENGTH / distance px/s^2.
+static const float PULL_STRENGTH   = 400000.0f;
+
+/// @summary The strength of the swirl around the black hole, in the same units.
+static const float SWIRL_STRENGTH  = 200000.0f;
+
+/// @summary The radius of influence of the black hole, in pixels.
+static const float FIELD_RADIUS    = 250.0f;
+
+/// @summary The squared distance at which the gravity stops increasing.
+static const float FIELD_SOFTENING = 2500.0f;
+
+/// @summary The radius of the area of the background grid pulled in.
+static const float GRID_RADIUS     = 200.0f;
+
+/// @summary The rate at which the black hole pulses, in radians per second.
+static const float PULSE_RATE      = 10.0f;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+BlackHole::BlackHole(float p_x, float p_y)
+{
+    State->Position[0]           = p_x;
+    State->Position[1]           = p_y;
+    State->Velocity[0]           = 0.0f;
+    State->Velocity[1]           = 0.0f;
+    State->Kind                  = ENTITY_BLACKHOLE;
+    State->Extra.BlackHole.Phase = 0.0f;
+    State->Extra.BlackHole.Scale = 1.0f;
+}
+
+BlackHole::~BlackHole(void)
+{
+    /* empty */
+}
+
+void BlackHole::AddToField(force_field_t *field) const
+{
+    field_source_t source;
+    source.X         = State->Position[0];
+    source.Y         = State->Position[1];
+    source.Pull      = PULL_STRENGTH;
+    source.Swirl     = SWIRL_STRENGTH;
+    source.Radius    = FIELD_RADIUS;
+    source.Softening = FIELD_SOFTENING;
+    field_add_source(field, source);
+}
+
+void BlackHole::Init(DisplayManager *dm)
+{
+    Image         = dm->GetBlackHoleTexture();
+    State->Radius = max2(float(Image->GetWidth()), float(Image->GetHeight())) * 0.5f;
+}
+
+void BlackHole::Update(double currentTime, double elapsedTime)
+{
+    float current = float(currentTime);
+    float elapsed = float(elapsedTime);
+
+    // the phase is wrapped so the sine argument stays small.
+    blackhole_state_t &hole = State->Extra.BlackHole;
+    hole.Phase += PULSE_RATE * elapsed;
+    if (hole.Phase > 2.0f * TRIG_PI) hole.Phase -= 2.0f * TRIG_PI;
+
+    float pulse = fast_sin(hole.Phase, TRIG_TIER_FAST);
+    hole.Scale  = 1.0f + 0.1f * pulse;
+
+    GridManager *gm = GridManager::GetInstance();
+    if (gm != NULL)
+    {
+        gm->ApplyImplosiveForce(10.0f * pulse + 20.0f, State->Position[0], State->Position[1], GRID_RADIUS);
+    }
+
+    UNUSED_LOCAL(current);
+}
+
+void BlackHole::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
+{
+    UNUSED_ARG(currentTime);
+    UNUSED_ARG(elapsedTime);
+    float  width   = (float) Image->GetWidth();
+    float  height  = (float) Image->GetHeight();
+    rect_t src     = { 0, 0, width, height };
+    float  originx = width  * 0.5f;
+    float  originy = height * 0.5f;
+    float  scale   = State->Extra.BlackHole.Scale;
+    dm->GetBatch()->AddRotated(1, Image, State->Position[0], State->Position[1], src, State->Color, State->Rotation[0], State->Rotation[1], originx, originy, scale, scale);
+}
@@ -9,10 +9,14 @@
 #include <math.h>
 #include "math.hpp"
 #include "bullet.hpp"
+#include "events.hpp"
+#include "grid.hpp"
 
 /*/////////////////
 //   Constants   //
 /////////////////*/
+/// @summary The RGBA color of the sparks emitted when a bullet expires.
+static const float SPARK_COLOR[4] = { 0.6f, 1.0f, 1.0f, 1.0f };
 
 /*///////////////////////
 //   Local Functions   //
@@ -23,14 +27,14 @@
 ///////////////////////*/
 Bullet::Bullet(float p_x, float p_y, float v_x, float v_y)
     :
-    ViewportWidth(0.0f),
-    ViewportHeight(0.0f)
+    WorldWidth(0.0f),
+    WorldHeight(0.0f)
 {
-    Position[0] = p_x;
-    Position[1] = p_y;
-    Velocity[0] = v_x;
-    Velocity[1] = v_y;
-    Kind        = ENTITY_BULLET;
+    State->Position[0] = p_x;
+    State->Position[1] = p_y;
+    State->Velocity[0] = v_x;
+    State->Velocity[1] = v_y;
+    State->Kind        = ENTITY_BULLET;
 }
 
 Bullet::~Bullet(void)
@@ -41,9 +45,9 @@ Bullet::~Bullet(void)
 void Bullet::Init(DisplayManager *dm)
 {
     Image          = dm->GetBulletTexture();
-    Radius         = max2(float(Image->GetWidth()), float(Image->GetHeight()));
-    ViewportWidth  = dm->GetViewportWidth();
-    ViewportHeight = dm->GetViewportHeight();
+    State->Radius  = float(Image->GetHeight()) * 0.5f; // swept along the velocity
+    WorldWidth  = dm->GetWorldWidth();
+    WorldHeight = dm->GetWorldHeight();
 }
 
 void Bullet::Update(double currentTime, double elapsedTime)
@@ -51,14 +55,24 @@ void Bullet::Update(double currentTime, double elapsedTime)
     float current = float(currentTime);
     float elapsed = float(elapsedTime);
 
-    Orientation   = atan2(Velocity[1], Velocity[0]);
-    Position[0]  += Velocity[0];
-    Position[1]  += Velocity[1];
+    float *pos = State->Position;
+    float *vel = State->Velocity;
+    SetDirection(vel[0], vel[1]);
+    pos[0] += vel[0];
+    pos[1] += vel[1];
 
-    if (Position[0] < 0 || Position[0] > ViewportWidth ||
-        Position[1] < 0 || Position[1] > ViewportHeight)
+    GridManager *gm = GridManager::GetInstance();
+    if (gm != NULL)
     {
-        IsExpired = true;
+        float speed = sqrtf(vel[0] * vel[0] + vel[1] * vel[1]);
+        gm->ApplyExplosiveForce(0.5f * speed, pos[0], pos[1], 80.0f);
+    }
+
+    if (pos[0] < 0 || pos[0] > WorldWidth ||
+        pos[1] < 0 || pos[1] > WorldHeight)
+    {
+        EventBus::GetInstance()->EmitBurst(pos[0], pos[1], 30, 60.0f, 600.0f, SPARK_COLOR, 0.75f, 1.0f);
+        State->IsExpired = 1;
     }
 
     UNUSED_LOCAL(current);
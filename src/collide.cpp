@@ -0,0 +1,168 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements continuous collision detection for moving circles. A
+/// swept circle touches a target when the distance from the target's center
+/// to the mover's path segment is at most the sum of the radii.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "ll_task.hpp"
+#include "collide.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of candidates tested by a single kernel invocation.
+#define COLLIDE_BLOCK_SIZE           64U
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel computing, for each candidate, the squared distance from
+/// its center to the path segment of the mover minus the squared sum of the
+/// radii. Non-positive values indicate contact during the sweep.
+struct segment_gap_k
+{
+    float const *X, *Y, *R;
+    float       *Gap;
+    size_t       Base;
+    float        PX, PY, DX, DY, InvLengthSq, Radius;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::splat(DX);
+        typename L::value_t dy = L::splat(DY);
+        typename L::value_t rx = L::sub(L::load(X + i), L::splat(PX));
+        typename L::value_t ry = L::sub(L::load(Y + i), L::splat(PY));
+        typename L::value_t t  = L::mul(L::add(L::mul(rx, dx), L::mul(ry, dy)), L::splat(InvLengthSq));
+        t = L::min(L::max(t, L::splat(0.0f)), L::splat(1.0f));
+        typename L::value_t ex = L::sub(rx, L::mul(dx, t));
+        typename L::value_t ey = L::sub(ry, L::mul(dy, t));
+        typename L::value_t rr = L::add(L::load(R + i), L::splat(Radius));
+        L::store(Gap + (i - Base), L::sub(L::add(L::mul(ex, ex), L::mul(ey, ey)), L::mul(rr, rr)));
+    }
+};
+
+/// @summary The arguments to collide_sweep(), passed to each task.
+struct collide_args_t
+{
+    spatial_grid_t const *Grid;
+    float          const *X;
+    float          const *Y;
+    float          const *DX;
+    float          const *DY;
+    float          const *R;
+    sweep_hit_t          *Hits;
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Computes the fraction of a sweep at which a moving circle first
+/// touches a stationary one, given that they do touch at some point.
+/// @param rx The x-offset from the start of the sweep to the target center.
+/// @param ry The y-offset from the start of the sweep to the target center.
+/// @param dx The x-component of the displacement.
+/// @param dy The y-component of the displacement.
+/// @param rr The sum of the radii.
+/// @return The fraction of the displacement, in [0, 1].
+static inline float time_of_impact(float rx, float ry, float dx, float dy, float rr)
+{
+    float c = rx * rx + ry * ry - rr * rr;
+    float a = dx * dx + dy * dy;
+    if (c <= 0.0f || a == 0.0f)
+        return 0.0f; // already overlapping at the start of the sweep.
+
+    float b = rx * dx + ry * dy;
+    float d = b * b - a * c;
+    float s = (b - sqrtf(d > 0.0f ? d : 0.0f)) / a;
+    return clamp(s, 0.0f, 1.0f);
+}
+
+/// @summary Sweeps a range of movers against the grid.
+/// @param begin The index of the first mover.
+/// @param end The index one past the last mover.
+/// @param context The collide_args_t describing the movers.
+static void collide_range(size_t begin, size_t end, void *context)
+{
+    collide_args_t const *args  = (collide_args_t const*) context;
+    spatial_grid_t const *grid  = args->Grid;
+    float                 gap[COLLIDE_BLOCK_SIZE];
+    segment_gap_k         k;
+
+    k.X   = grid->SortedX;
+    k.Y   = grid->SortedY;
+    k.R   = grid->SortedR;
+    k.Gap = gap;
+    for (size_t i = begin; i < end; ++i)
+    {
+        float    px   = args->X[i];
+        float    py   = args->Y[i];
+        float    dx   = args->DX[i];
+        float    dy   = args->DY[i];
+        float    r    = args->R[i];
+        float    lsq  = dx * dx + dy * dy;
+        float    pad  = r + grid->MaxRadius;
+        size_t   col0 = spatial_grid_column(grid, min2(px, px + dx) - pad);
+        size_t   col1 = spatial_grid_column(grid, max2(px, px + dx) + pad);
+        size_t   row0 = spatial_grid_row   (grid, min2(py, py + dy) - pad);
+        size_t   row1 = spatial_grid_row   (grid, max2(py, py + dy) + pad);
+        uint32_t best = COLLIDE_NO_HIT;
+        float    time = 2.0f;
+
+        k.PX          = px;
+        k.PY          = py;
+        k.DX          = dx;
+        k.DY          = dy;
+        k.InvLengthSq = lsq > 0.0f ? 1.0f / lsq : 0.0f;
+        k.Radius      = r;
+        for (size_t row = row0; row <= row1; ++row)
+        {
+            size_t b, e;
+            spatial_grid_run(grid, row, col0, col1, b, e);
+            for ( ; b < e; b += COLLIDE_BLOCK_SIZE)
+            {
+                size_t n = e - b < COLLIDE_BLOCK_SIZE ? e - b : COLLIDE_BLOCK_SIZE;
+                k.Base   = b;
+                soa_for_range(k, k.X, b, b + n);
+                for (size_t j = 0; j < n; ++j)
+                {
+                    if (gap[j] > 0.0f)
+                        continue;
+
+                    size_t c = b + j;
+                    float  s = time_of_impact(grid->SortedX[c] - px, grid->SortedY[c] - py, dx, dy, grid->SortedR[c] + r);
+                    if (s < time)
+                    {
+                        best = grid->Items[c];
+                        time = s;
+                    }
+                }
+            }
+        }
+        args->Hits[i].Item = best;
+        args->Hits[i].Time = best != COLLIDE_NO_HIT ? time : 1.0f;
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void collide_sweep(spatial_grid_t const *grid, float const *x, float const *y, float const *dx, float const *dy, float const *r, size_t count, sweep_hit_t *hits, task_pool_t *pool)
+{
+    collide_args_t args;
+    args.Grid = grid;
+    args.X    = x;
+    args.Y    = y;
+    args.DX   = dx;
+    args.DY   = dy;
+    args.R    = r;
+    args.Hits = hits;
+    task_pool_parallel_for(pool, count, COLLIDE_MIN_CHUNK, collide_range, &args);
+}
@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "math.hpp"
+#include "math_trig.hpp"
 #include "ff_tga.hpp"
 #include "display.hpp"
 #include "ll_image.hpp"
@@ -46,17 +47,59 @@ DisplayManager* DisplayManager::DM = NULL;
 /*///////////////////////
 //   Local Functions   //
 ///////////////////////*/
+/// @summary Writes the definition of a single sprite quad.
+/// @param q The quad to write.
+/// @param t The texture containing the sprite image.
+/// @param src A rectangle defining the position and size of the image on the source texture.
+/// @param x The x-coordinate of the sprite origin, in pixels.
+/// @param y The y-coordinate of the sprite origin, in pixels.
+/// @param sx The horizontal scale factor.
+/// @param sy The vertical scale factor.
+/// @param ox The x-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+/// @param oy The y-coordinate of the sprite origin, relative to the upper-left corner of the sprite.
+/// @param rot_cos The cosine of the sprite orientation.
+/// @param rot_sin The sine of the sprite orientation.
+/// @param abgr The packed ABGR tint color.
+static inline void write_quad(squad_t &q, Texture const *t, rect_t const &src, float x, float y, float sx, float sy, float ox, float oy, float rot_cos, float rot_sin, uint32_t abgr)
+{
+    q.Source[0]   = src.X;
+    q.Source[1]   = src.Y;
+    q.Source[2]   = src.Width;
+    q.Source[3]   = src.Height;
+    q.Target[0]   = x;
+    q.Target[1]   = y;
+    q.Target[2]   = src.Width  * sx;
+    q.Target[3]   = src.Height * sy;
+    q.Origin[0]   = ox;
+    q.Origin[1]   = oy;
+    q.Scale [0]   = t->GetInverseWidth();
+    q.Scale [1]   = t->GetInverseHeight();
+    q.Rotation[0] = rot_cos;
+    q.Rotation[1] = rot_sin;
+    q.TintColor   = abgr;
+}
 
 /*///////////////////////
 //  Public Functions   //
 ///////////////////////*/
+uint32_t color32(float const *rgba)
+{
+    uint32_t r = (uint32_t) clamp(rgba[0] * 255.0f, 0.0f, 255.0f);
+    uint32_t g = (uint32_t) clamp(rgba[1] * 255.0f, 0.0f, 255.0f);
+    uint32_t b = (uint32_t) clamp(rgba[2] * 255.0f, 0.0f, 255.0f);
+    uint32_t a = (uint32_t) clamp(rgba[3] * 255.0f, 0.0f, 255.0f);
+    return ((a << 24) | (b << 16) | (g << 8) | r);
+}
+
 Texture::Texture(void)
     :
     Id(0),
     Wrap(GL_CLAMP_TO_EDGE),
     Filter(GL_NEAREST),
     Width(0),
-    Height(0)
+    Height(0),
+    InvWidth(0.0f),
+    InvHeight(0.0f)
 {
     /* empty */
 }
@@ -129,9 +172,11 @@ bool Texture::LoadFromFile(char const *path)
             transfer_pixels_h2d(&px);
 
             delete[] pix;
-            Id     = id;
-            Width  = tga_w;
-            Height = tga_h;
+            Id        = id;
+            Width     = tga_w;
+            Height    = tga_h;
+            InvWidth  = 1.0f / float(tga_w);
+            InvHeight = 1.0f / float(tga_h);
             return true;
         }
         else
@@ -159,10 +204,9 @@ SpriteBatch::SpriteBatch(size_t initial_capacity)
     AttribPTX(NULL),
     AttribCLR(NULL),
     SamplerTEX(NULL),
-    UniformMSS(NULL)
+    UniformMSS(NULL),
+    BlendMode(SPRITE_BLEND_NONE)
 {
-    SpriteData.reserve(initial_capacity);
-
     shader_source_t sources;
     shader_source_init(&sources);
     shader_source_add(&sources, GL_VERTEX_SHADER, (char**) &SpriteBatch_VSS, 1);
@@ -174,8 +218,7 @@ SpriteBatch::SpriteBatch(size_t initial_capacity)
     UniformMSS = find_uniform(&ShaderDesc, "uMSS");
 
     create_sprite_batch(&BatchData, initial_capacity);
-    create_sprite_effect(&EffectData, initial_capacity, sizeof(sprite_vertex_ptc_t), sizeof(uint16_t));
-    sprite_effect_setup_vao_ptc(&EffectData);
+    create_sprite_effect<sprite_format_ptc_t, sprite_shape_quad_t, sprite_index_u16_t>(&EffectData, initial_capacity);
 }
 
 SpriteBatch::~SpriteBatch(void)
@@ -191,7 +234,6 @@ void SpriteBatch::Dispose(void)
         delete_sprite_batch(&BatchData);
         shader_desc_free(&ShaderDesc);
         glDeleteProgram(Program);
-        SpriteData.clear();
         AttribPTX  = NULL;
         AttribCLR  = NULL;
         SamplerTEX = NULL;
@@ -204,125 +246,84 @@ void SpriteBatch::SetViewport(int width, int height)
     sprite_effect_set_viewport(&EffectData, width, height);
 }
 
-static uint32_t color32(float const *rgba)
-{
-    uint32_t r = (uint32_t) clamp(rgba[0] * 255.0f, 0.0f, 255.0f);
-    uint32_t g = (uint32_t) clamp(rgba[1] * 255.0f, 0.0f, 255.0f);
-    uint32_t b = (uint32_t) clamp(rgba[2] * 255.0f, 0.0f, 255.0f);
-    uint32_t a = (uint32_t) clamp(rgba[3] * 255.0f, 0.0f, 255.0f);
-    return ((a << 24) | (b << 16) | (g << 8) | r);
-}
-
 void SpriteBatch::Add(uint32_t z, Texture *t, rect_t const &dst, rect_t const &src, float const *rgba)
 {
-    sprite_t sprite;
-    sprite.ScreenX       = dst.X;
-    sprite.ScreenY       = dst.Y;
-    sprite.OriginX       = 0.0f;
-    sprite.OriginY       = 0.0f;
-    sprite.ScaleX        = 1.0f;
-    sprite.ScaleY        = 1.0f;
-    sprite.Orientation   = 0.0f;
-    sprite.TintColor     = color32(rgba);
-    sprite.ImageX        = src.X;
-    sprite.ImageY        = src.Y;
-    sprite.ImageWidth    = src.Width;
-    sprite.ImageHeight   = src.Height;
-    sprite.TextureWidth  = t->GetWidth();
-    sprite.TextureHeight = t->GetHeight();
-    sprite.LayerDepth    = z;
-    sprite.RenderState   = uint32_t(t->GetId());
-    SpriteData.push_back(sprite);
+    squad_t *q = sprite_batch_append(&BatchData, 1, z, sprite_render_state(BlendMode, uint32_t(t->GetId())));
+    write_quad(*q, t, src, dst.X, dst.Y, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, color32(rgba));
 }
 
 void SpriteBatch::Add(uint32_t z, Texture *t, float x, float y, rect_t const &src, float const *rgba)
 {
-    sprite_t sprite;
-    sprite.ScreenX       = x;
-    sprite.ScreenY       = y;
-    sprite.OriginX       = 0.0f;
-    sprite.OriginY       = 0.0f;
-    sprite.ScaleX        = 1.0f;
-    sprite.ScaleY        = 1.0f;
-    sprite.Orientation   = 0.0f;
-    sprite.TintColor     = color32(rgba);
-    sprite.ImageX        = src.X;
-    sprite.ImageY        = src.Y;
-    sprite.ImageWidth    = src.Width;
-    sprite.ImageHeight   = src.Height;
-    sprite.TextureWidth  = t->GetWidth();
-    sprite.TextureHeight = t->GetHeight();
-    sprite.LayerDepth    = z;
-    sprite.RenderState   = uint32_t(t->GetId());
-    SpriteData.push_back(sprite);
+    squad_t *q = sprite_batch_append(&BatchData, 1, z, sprite_render_state(BlendMode, uint32_t(t->GetId())));
+    write_quad(*q, t, src, x, y, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, color32(rgba));
 }
 
 void SpriteBatch::Add(uint32_t z, Texture *t, rect_t const &dst, rect_t const &src, float const *rgba, float rot, float ox, float oy)
 {
-    sprite_t sprite;
-    sprite.ScreenX       = dst.X;
-    sprite.ScreenY       = dst.Y;
-    sprite.OriginX       = ox;
-    sprite.OriginY       = oy;
-    sprite.ScaleX        = 1.0f;
-    sprite.ScaleY        = 1.0f;
-    sprite.Orientation   = rot;
-    sprite.TintColor     = color32(rgba);
-    sprite.ImageX        = src.X;
-    sprite.ImageY        = src.Y;
-    sprite.ImageWidth    = src.Width;
-    sprite.ImageHeight   = src.Height;
-    sprite.TextureWidth  = t->GetWidth();
-    sprite.TextureHeight = t->GetHeight();
-    sprite.LayerDepth    = z;
-    sprite.RenderState   = uint32_t(t->GetId());
-    SpriteData.push_back(sprite);
+    float rot_sin, rot_cos;
+    fast_sincos(rot, rot_sin, rot_cos, TRIG_TIER_FAST);
+    squad_t *q = sprite_batch_append(&BatchData, 1, z, sprite_render_state(BlendMode, uint32_t(t->GetId())));
+    write_quad(*q, t, src, dst.X, dst.Y, 1.0f, 1.0f, ox, oy, rot_cos, rot_sin, color32(rgba));
 }
 
 void SpriteBatch::Add(uint32_t z, Texture *t, float x, float y, rect_t const &src, float const *rgba, float rot, float ox, float oy, float sx, float sy)
 {
-    sprite_t sprite;
-    sprite.ScreenX       = x;
-    sprite.ScreenY       = y;
-    sprite.OriginX       = ox;
-    sprite.OriginY       = oy;
-    sprite.ScaleX        = sx;
-    sprite.ScaleY        = sy;
-    sprite.Orientation   = rot;
-    sprite.TintColor     = color32(rgba);
-    sprite.ImageX        = src.X;
-    sprite.ImageY        = src.Y;
-    sprite.ImageWidth    = src.Width;
-    sprite.ImageHeight   = src.Height;
-    sprite.TextureWidth  = t->GetWidth();
-    sprite.TextureHeight = t->GetHeight();
-    sprite.LayerDepth    = z;
-    sprite.RenderState   = uint32_t(t->GetId());
-    SpriteData.push_back(sprite);
+    float rot_sin, rot_cos;
+    fast_sincos(rot, rot_sin, rot_cos, TRIG_TIER_FAST);
+    AddRotated(z, t, x, y, src, rgba, rot_cos, rot_sin, ox, oy, sx, sy);
+}
+
+void SpriteBatch::AddRotated(uint32_t z, Texture *t, float x, float y, rect_t const &src, float const *rgba, float rot_cos, float rot_sin, float ox, float oy, float sx, float sy)
+{
+    squad_t *q = sprite_batch_append(&BatchData, 1, z, sprite_render_state(BlendMode, uint32_t(t->GetId())));
+    write_quad(*q, t, src, x, y, sx, sy, ox, oy, rot_cos, rot_sin, color32(rgba));
+}
+
+void SpriteBatch::AddArray(uint32_t z, Texture *t, rect_t const &src, size_t count, float const *x, float const *y, float const *rot, float const *sx, float const *sy, uint32_t const *abgr, float ox, float oy)
+{
+    size_t base = BatchData.Count;
+    AddArrayRotated(z, t, src, count, x, y, NULL, NULL, sx, sy, abgr, ox, oy);
+    if (rot != NULL)
+    {
+        squad_t *out = BatchData.Quads + base;
+        for (size_t i = 0; i < count; ++i)
+        {
+            fast_sincos(rot[i], out[i].Rotation[1], out[i].Rotation[0], TRIG_TIER_FAST);
+        }
+    }
+}
+
+void SpriteBatch::AddArrayRotated(uint32_t z, Texture *t, rect_t const &src, size_t count, float const *x, float const *y, float const *rot_cos, float const *rot_sin, float const *sx, float const *sy, uint32_t const *abgr, float ox, float oy)
+{
+    squad_t *out = sprite_batch_append(&BatchData, count, z, sprite_render_state(BlendMode, uint32_t(t->GetId())));
+    for (size_t i = 0; i < count; ++i)
+    {
+        float scale_x = sx != NULL ? sx[i] : 1.0f;
+        float scale_y = sy != NULL ? sy[i] : scale_x;
+        float cos_r   = rot_cos != NULL ? rot_cos[i] : 1.0f;
+        float sin_r   = rot_sin != NULL ? rot_sin[i] : 0.0f;
+        write_quad(out[i], t, src, x[i], y[i], scale_x, scale_y, ox, oy, cos_r, sin_r, abgr[i]);
+    }
 }
 
 void SpriteBatch::SetBlendModeNone(void)
 {
-    Flush();
-    sprite_effect_blend_none(&EffectData);
+    BlendMode = SPRITE_BLEND_NONE;
 }
 
 void SpriteBatch::SetBlendModeAlpha(void)
 {
-    Flush();
-    sprite_effect_blend_alpha(&EffectData);
+    BlendMode = SPRITE_BLEND_ALPHA;
 }
 
 void SpriteBatch::SetBlendModeAdditive(void)
 {
-    Flush();
-    sprite_effect_blend_additive(&EffectData);
+    BlendMode = SPRITE_BLEND_ADDITIVE;
 }
 
 void SpriteBatch::SetBlendModePremultiplied(void)
 {
-    Flush();
-    sprite_effect_blend_premultiplied(&EffectData);
+    BlendMode = SPRITE_BLEND_PREMULTIPLIED;
 }
 
 static void sprite_effect_setup(sprite_effect_t *effect, void *context)
@@ -340,8 +341,7 @@ static void sprite_effect_apply_state(sprite_effect_t *effect, uint32_t state, v
 
 void SpriteBatch::Flush(void)
 {
-    uint32_t count = uint32_t(SpriteData.size());
-    if (count > 0)
+    if (BatchData.Count > 0)
     {
         sprite_effect_apply_t fxfuncs = {
             sprite_effect_setup,
@@ -353,17 +353,12 @@ void SpriteBatch::Flush(void)
         glEnable(GL_CULL_FACE);
         glDisable(GL_DEPTH_TEST);
         sprite_effect_bind_buffers(&EffectData);
-        sprite_effect_apply_blendstate(&EffectData);
         set_uniform(UniformMSS, EffectData.Projection, false);
 
-        ensure_sprite_batch(&BatchData, count);
-        generate_quads(BatchData.Quads, BatchData.State, BatchData.Order, 0, &SpriteData[0], 0, count);
-        BatchData.Count = count;
-
-        sprite_effect_draw_batch_ptc(&EffectData, &BatchData, &fxfuncs, this);
-
+        // the blend state is applied per sub-batch from the sorted render states.
+        radix_sort_sprite_batch(&BatchData, true);
+        sprite_effect_draw_batch<sprite_format_ptc_t, sprite_index_u16_t>(&EffectData, &BatchData, &fxfuncs, this);
         flush_sprite_batch(&BatchData);
-        SpriteData.clear();
     }
 }
 
@@ -468,6 +463,8 @@ DisplayManager::DisplayManager(void)
     MainWindow(NULL),
     ViewportWidth(0.0f),
     ViewportHeight(0.0f),
+    WorldWidth(DISPLAY_WORLD_WIDTH),
+    WorldHeight(DISPLAY_WORLD_HEIGHT),
     DefaultBatch(NULL),
     DefaultFont(NULL),
     FontTexture(NULL),
@@ -599,7 +596,7 @@ void DisplayManager::SetViewport(int width, int height)
     ViewportWidth  = float(width);
     ViewportHeight = float(height);
     glViewport(0, 0, width, height);
-    DefaultBatch->SetViewport(width, height);
+    DefaultBatch->SetViewport(int(WorldWidth), int(WorldHeight));
 }
 
 void DisplayManager::EndFrame(void)
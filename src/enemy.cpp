@@ -0,0 +1,765 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the batched enemy system. Each tick rebuilds the
+/// spatial grid, gathers separation from nearby enemies in cell order, turns
+/// the wander headings, and then runs a single fused steering kernel.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "math_trig.hpp"
+#include "ll_task.hpp"
+#include "enemy.hpp"
+#include "entity.hpp"
+#include "player.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of per-enemy arrays allocated for the pool.
+#define ENEMY_ARRAY_COUNT            25U
+
+/// @summary The seed used for the wander and spawn generator.
+#define ENEMY_RANDOM_SEED            0x454E454D59535452ULL
+
+/// @summary The number of partial sums kept by the separation pass. It is
+/// fixed rather than the vector width so that scalar, SSE and AVX builds add
+/// the same values in the same order and reach the same result.
+#define ENEMY_SEPARATION_LANES       8U
+
+/// @summary The acceleration of a seeker toward the player, in px/s^2.
+static const float SEEKER_ACCELERATION   = 3240.0f;
+
+/// @summary The acceleration of a wanderer along its heading, in px/s^2.
+static const float WANDERER_ACCELERATION = 1440.0f;
+
+/// @summary The fraction of enemy velocity retained over 1/60th of a second.
+static const float ENEMY_FRICTION        = 0.8f;
+
+/// @summary The strength of the separation between neighbors. Well outside of
+/// the softening distance, the acceleration is this value / distance px/s^2.
+static const float SEPARATION_STRENGTH   = 60000.0f;
+
+/// @summary The squared distance at which separation stops increasing.
+static const float SEPARATION_SOFTENING  = 16.0f;
+
+/// @summary The largest change in wander heading over 1/60th of a second.
+static const float WANDER_TURN           = 0.1f;
+
+/// @summary The minimum distance between the player and a spawned enemy.
+static const float SPAWN_MIN_DISTANCE    = 250.0f;
+
+/// @summary The initial and final inverse spawn chance per 1/60th of a second.
+static const float SPAWN_ODDS_START      = 90.0f;
+static const float SPAWN_ODDS_END        = 30.0f;
+
+/// @summary The rate at which the inverse spawn chance falls per 1/60th of a second.
+static const float SPAWN_ODDS_DECAY      = 0.005f;
+
+/// @summary The global EnemyManager instance.
+EnemyManager* EnemyManager::EM = NULL;
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel applying a random turn to each wander heading, keeping
+/// the heading in [-pi, pi] so that it remains a valid sincos argument.
+struct enemy_turn_k
+{
+    float       *Heading;
+    float const *Turn;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t pi  = L::splat(TRIG_PI);
+        typename L::value_t tau = L::splat(2.0f * TRIG_PI);
+        typename L::value_t h   = L::add(L::load(Heading + i), L::load(Turn + i));
+        h = L::sub(h, L::select_lt(pi, h, tau));
+        h = L::add(h, L::select_lt(h, L::sub(L::splat(0.0f), pi), tau));
+        L::store(Heading + i, h);
+    }
+};
+
+/// @summary Kernel combining seek, wander and separation, then applying
+/// friction and integrating position.
+struct enemy_steer_k
+{
+    float       *PosX, *PosY, *VelX, *VelY;
+    float const *SepX, *SepY, *HeadingCos, *HeadingSin, *SeekGain, *WanderGain;
+    float        TargetX, TargetY, Seek, Wander, Step, Friction;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t px = L::load(PosX + i);
+        typename L::value_t py = L::load(PosY + i);
+        typename L::value_t dx = L::sub(L::splat(TargetX), px);
+        typename L::value_t dy = L::sub(L::splat(TargetY), py);
+        typename L::value_t ln = L::max(L::sqrt(L::add(L::mul(dx, dx), L::mul(dy, dy))), L::splat(1.0f));
+        typename L::value_t ks = L::div(L::mul(L::splat(Seek), L::load(SeekGain + i)), ln);
+        typename L::value_t kw = L::mul(L::splat(Wander), L::load(WanderGain + i));
+        typename L::value_t dt = L::splat(Step);
+        typename L::value_t fr = L::splat(Friction);
+        typename L::value_t ax = L::add(L::mul(dx, ks), L::mul(L::load(HeadingCos + i), kw));
+        typename L::value_t ay = L::add(L::mul(dy, ks), L::mul(L::load(HeadingSin + i), kw));
+        ax = L::add(ax, L::mul(L::load(SepX + i), dt));
+        ay = L::add(ay, L::mul(L::load(SepY + i), dt));
+        typename L::value_t vx = L::mul(L::add(L::load(VelX + i), ax), fr);
+        typename L::value_t vy = L::mul(L::add(L::load(VelY + i), ay), fr);
+        L::store(VelX + i, vx);
+        L::store(VelY + i, vy);
+        L::store(PosX + i, L::add(px, L::mul(vx, dt)));
+        L::store(PosY + i, L::add(py, L::mul(vy, dt)));
+    }
+};
+
+/// @summary The arguments to the separation pass, passed to each task.
+struct enemy_separation_args_t
+{
+    spatial_grid_t const *Grid;
+    float                *SepX;
+    float                *SepY;
+    float                 RadiusSq;
+    float                 Softening;
+    float                 Strength;
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Reorders the first count elements of an array.
+/// @param values The array to reorder.
+/// @param order The source index of each element in the new order.
+/// @param temp Scratch storage for count elements.
+/// @param count The number of elements.
+template <typename T>
+static void enemy_permute(T *values, uint32_t const *order, T *temp, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        temp[i] = values[order[i]];
+    }
+    memcpy(values, temp, count * sizeof(T));
+}
+
+/// @summary Runs the steering kernel over a range of enemies.
+/// @param begin The index of the first enemy to update.
+/// @param end The index one past the last enemy to update.
+/// @param context The enemy_steer_k describing the update.
+static void enemy_steer_range(size_t begin, size_t end, void *context)
+{
+    enemy_steer_k const *k = (enemy_steer_k const*) context;
+    soa_for_range(*k, k->PosX, begin, end);
+}
+
+/// @summary Accumulates the separation from a contiguous range of neighbors,
+/// v += (p - n) / (|p - n|^2 + softening) for each neighbor n within radius.
+/// A point contributes nothing to itself since p - n is zero. Neighbors are
+/// summed into ENEMY_SEPARATION_LANES partial sums, which are then added in a
+/// fixed order.
+/// @param px The x-coordinate of the enemy.
+/// @param py The y-coordinate of the enemy.
+/// @param nx The x-coordinates of the neighbors.
+/// @param ny The y-coordinates of the neighbors.
+/// @param begin The index of the first neighbor.
+/// @param end The index one past the last neighbor.
+/// @param radius_sq The squared separation radius.
+/// @param softening The softening term.
+/// @param out_x The x-component of the sum, updated in place.
+/// @param out_y The y-component of the sum, updated in place.
+static inline void enemy_separation_sum(float px, float py, float const *nx, float const *ny, size_t begin, size_t end, float radius_sq, float softening, float &out_x, float &out_y)
+{
+    typedef soa_wide_t W;
+    size_t const N = ENEMY_SEPARATION_LANES / W::WIDTH;
+    W::value_t cx  = W::splat(px);
+    W::value_t cy  = W::splat(py);
+    W::value_t r2  = W::splat(radius_sq);
+    W::value_t sf  = W::splat(softening);
+    W::value_t ax[N];
+    W::value_t ay[N];
+    for (size_t j = 0; j < N; ++j)
+    {
+        ax[j] = W::splat(0.0f);
+        ay[j] = W::splat(0.0f);
+    }
+    size_t     i   = begin;
+    for ( ; i + ENEMY_SEPARATION_LANES <= end; i += ENEMY_SEPARATION_LANES)
+    {
+        for (size_t j = 0; j < N; ++j)
+        {
+            W::value_t dx = W::sub(cx, W::load(nx + i + j * W::WIDTH));
+            W::value_t dy = W::sub(cy, W::load(ny + i + j * W::WIDTH));
+            W::value_t ds = W::add(W::mul(dx, dx), W::mul(dy, dy));
+            W::value_t m  = W::select_lt(ds, r2, W::div(W::splat(1.0f), W::add(ds, sf)));
+            ax[j] = W::add(ax[j], W::mul(dx, m));
+            ay[j] = W::add(ay[j], W::mul(dy, m));
+        }
+    }
+    float lx[ENEMY_SEPARATION_LANES];
+    float ly[ENEMY_SEPARATION_LANES];
+    for (size_t j = 0; j < N; ++j)
+    {
+        W::store(lx + j * W::WIDTH, ax[j]);
+        W::store(ly + j * W::WIDTH, ay[j]);
+    }
+    float sx = ((lx[0] + lx[4]) + (lx[2] + lx[6])) + ((lx[1] + lx[5]) + (lx[3] + lx[7]));
+    float sy = ((ly[0] + ly[4]) + (ly[2] + ly[6])) + ((ly[1] + ly[5]) + (ly[3] + ly[7]));
+    for ( ; i < end; ++i)
+    {
+        float dx = px - nx[i];
+        float dy = py - ny[i];
+        float ds = dx * dx + dy * dy;
+        if (ds < radius_sq)
+        {
+            float m = 1.0f / (ds + softening);
+            sx += dx * m;
+            sy += dy * m;
+        }
+    }
+    out_x += sx;
+    out_y += sy;
+}
+
+/// @summary Computes the separation acceleration for a range of enemies, in
+/// spatial grid order so that neighboring cells stay in cache. Crowded runs
+/// of cells are subsampled, starting at an offset that varies per enemy.
+/// @param begin The index of the first enemy in the sorted arrays.
+/// @param end The index one past the last enemy in the sorted arrays.
+/// @param context The enemy_separation_args_t describing the pass.
+static void enemy_separation_range(size_t begin, size_t end, void *context)
+{
+    enemy_separation_args_t const *args = (enemy_separation_args_t const*) context;
+    spatial_grid_t          const *grid = args->Grid;
+    float                   const *sx   = grid->SortedX;
+    float                   const *sy   = grid->SortedY;
+    size_t                  const  last_col = grid->CellsX - 1;
+    size_t                  const  last_row = grid->CellsY - 1;
+
+    for (size_t k = begin; k < end; ++k)
+    {
+        float  px   = sx[k];
+        float  py   = sy[k];
+        size_t col  = spatial_grid_column(grid, px);
+        size_t row  = spatial_grid_row(grid, py);
+        size_t col0 = col > 0 ? col - 1 : 0;
+        size_t col1 = col < last_col ? col + 1 : last_col;
+        size_t row0 = row > 0 ? row - 1 : 0;
+        size_t row1 = row < last_row ? row + 1 : last_row;
+        float  fx   = 0.0f;
+        float  fy   = 0.0f;
+        for (size_t r = row0; r <= row1; ++r)
+        {
+            size_t b, e;
+            spatial_grid_run(grid, r, col0, col1, b, e);
+            if (e - b > ENEMY_SEPARATION_SAMPLES)
+            {
+                b += (k * 7919U) % (e - b - ENEMY_SEPARATION_SAMPLES + 1);
+                e  = b + ENEMY_SEPARATION_SAMPLES;
+            }
+            enemy_separation_sum(px, py, sx, sy, b, e, args->RadiusSq, args->Softening, fx, fy);
+        }
+        uint32_t i = grid->Items[k];
+        args->SepX[i] = fx * args->Strength;
+        args->SepY[i] = fy * args->Strength;
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+EnemyManager* EnemyManager::GetInstance(void)
+{
+    return EM;
+}
+
+EnemyManager::EnemyManager(size_t capacity, task_pool_t *pool)
+    :
+    TaskPool(pool),
+    Memory(NULL),
+    FreeCount(0),
+    FreeLow(0),
+    Capacity(capacity),
+    Count(0),
+    WorldWidth(0.0f),
+    WorldHeight(0.0f),
+    SpawnOdds(SPAWN_ODDS_START),
+    SortInterval(ENEMY_SORT_INTERVAL),
+    SortThreshold(ENEMY_SORT_THRESHOLD),
+    SortTicks(0),
+    Displaced(0)
+{
+    if (Capacity > (size_t(1) << ENEMY_SLOT_BITS))
+        Capacity = size_t(1) << ENEMY_SLOT_BITS;
+
+    // every array starts on a SOA_ALIGNMENT boundary so that the
+    // steering kernels run entirely on aligned vectors.
+    size_t    stride = (Capacity * sizeof(float) + (SOA_ALIGNMENT - 1)) & ~size_t(SOA_ALIGNMENT - 1);
+    Memory           = malloc(stride * ENEMY_ARRAY_COUNT + SOA_ALIGNMENT);
+    uintptr_t base   = (uintptr_t(Memory) + (SOA_ALIGNMENT - 1)) & ~uintptr_t(SOA_ALIGNMENT - 1);
+    PosX             = (float   *) (base + stride *  0);
+    PosY             = (float   *) (base + stride *  1);
+    VelX             = (float   *) (base + stride *  2);
+    VelY             = (float   *) (base + stride *  3);
+    SepX             = (float   *) (base + stride *  4);
+    SepY             = (float   *) (base + stride *  5);
+    Heading          = (float   *) (base + stride *  6);
+    HeadingCos       = (float   *) (base + stride *  7);
+    HeadingSin       = (float   *) (base + stride *  8);
+    Turn             = (float   *) (base + stride *  9);
+    SeekGain         = (float   *) (base + stride * 10);
+    WanderGain       = (float   *) (base + stride * 11);
+    FacingCos        = (float   *) (base + stride * 12);
+    DrawX            = (float   *) (base + stride * 13);
+    DrawY            = (float   *) (base + stride * 14);
+    DrawCos          = (float   *) (base + stride * 15);
+    DrawColor        = (uint32_t*) (base + stride * 16);
+    Type             = (uint32_t*) (base + stride * 17);
+    Handle           = (uint32_t*) (base + stride * 18);
+    Sparse           = (uint32_t*) (base + stride * 19);
+    Generation       = (uint32_t*) (base + stride * 20);
+    FreeSlots        = (uint32_t*) (base + stride * 21);
+    Radius           = (float   *) (base + stride * 22);
+    FacingSin        = (float   *) (base + stride * 23);
+    DrawSin          = (float   *) (base + stride * 24);
+
+    // slots are handed out lowest first.
+    for (size_t i = 0; i < Capacity; ++i)
+    {
+        DrawColor[i]  = 0xFFFFFFFFU;
+        Generation[i] = 0;
+        FreeSlots[i]  = uint32_t(Capacity - 1 - i);
+    }
+    FreeCount = Capacity;
+    FreeLow   = Capacity;
+
+    for (size_t i = 0; i < ENEMY_TYPE_COUNT; ++i)
+    {
+        Images[i] = NULL;
+        Radii[i]  = 0.0f;
+    }
+    Grid.CellStart = NULL;
+    Grid.Cursor    = NULL;
+    Grid.Memory    = NULL;
+    random8_seed(&Random, ENEMY_RANDOM_SEED);
+    EnemyManager::EM = this;
+}
+
+EnemyManager::~EnemyManager(void)
+{
+    spatial_grid_delete(&Grid);
+    free(Memory);
+    Memory   = NULL;
+    Count    = 0;
+    Capacity = 0;
+    EnemyManager::EM = NULL;
+}
+
+void EnemyManager::Init(DisplayManager *dm)
+{
+    Images[ENEMY_SEEKER]   = dm->GetSeekerTexture();
+    Images[ENEMY_WANDERER] = dm->GetWandererTexture();
+    for (size_t i = 0; i < ENEMY_TYPE_COUNT; ++i)
+    {
+        Radii[i] = max2(float(Images[i]->GetWidth()), float(Images[i]->GetHeight())) * 0.5f;
+    }
+    WorldWidth  = dm->GetWorldWidth();
+    WorldHeight = dm->GetWorldHeight();
+    spatial_grid_delete(&Grid);
+    spatial_grid_create(&Grid, 0.0f, 0.0f, WorldWidth, WorldHeight, ENEMY_SEPARATION_RADIUS, Capacity);
+}
+
+void EnemyManager::Clear(void)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        uint32_t slot = Handle[i] & ((1U << ENEMY_SLOT_BITS) - 1);
+        Generation[slot]++;
+        FreeSlots[FreeCount++] = slot;
+    }
+    Count      = 0;
+    Grid.Count = 0;
+    SortTicks  = 0;
+    Displaced  = 0;
+    SpawnQueue.clear();
+    KillQueue.clear();
+}
+
+void EnemyManager::SetSortPolicy(size_t interval, float threshold)
+{
+    SortInterval  = interval;
+    SortThreshold = threshold;
+}
+
+void EnemyManager::SortByPosition(void)
+{
+    SortTicks = 0;
+    Displaced = 0;
+    if (Count < 2 || Grid.CellStart == NULL)
+        return;
+
+    // the wander and draw scratch arrays are free at this point; they hold
+    // the keys and indices during the sort, and Turn is then reused as the
+    // temporary storage for each permutation.
+    uint32_t *keys  = (uint32_t*) Turn;
+    uint32_t *order = NULL;
+    spatial_morton_codes(&Grid, PosX, PosY, Count, keys);
+    order = spatial_radix_sort(keys, (uint32_t*) DrawX, (uint32_t*) DrawY, (uint32_t*) DrawCos, Count);
+    enemy_permute(PosX      , order, Turn, Count);
+    enemy_permute(PosY      , order, Turn, Count);
+    enemy_permute(VelX      , order, Turn, Count);
+    enemy_permute(VelY      , order, Turn, Count);
+    enemy_permute(Radius    , order, Turn, Count);
+    enemy_permute(Heading   , order, Turn, Count);
+    enemy_permute(SeekGain  , order, Turn, Count);
+    enemy_permute(WanderGain, order, Turn, Count);
+    enemy_permute(Type      , order, (uint32_t*) Turn, Count);
+    enemy_permute(Handle    , order, (uint32_t*) Turn, Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        Sparse[Handle[i] & ((1U << ENEMY_SLOT_BITS) - 1)] = uint32_t(i);
+    }
+}
+
+void EnemyManager::Spawn(EnemyType type, float x, float y)
+{
+    spawn_t s = { x, y, uint32_t(type) };
+    SpawnQueue.push_back(s);
+}
+
+void EnemyManager::Kill(uint32_t handle)
+{
+    KillQueue.push_back(handle);
+}
+
+bool EnemyManager::IsAlive(uint32_t handle) const
+{
+    uint32_t slot = handle & ((1U << ENEMY_SLOT_BITS) - 1);
+    if (handle == ENEMY_INVALID_HANDLE || slot >= Capacity)
+        return false;
+    return ((handle >> ENEMY_SLOT_BITS) == (Generation[slot] & ((1U << (32 - ENEMY_SLOT_BITS)) - 1)) && Sparse[slot] < Count && Handle[Sparse[slot]] == handle);
+}
+
+void EnemyManager::CommitQueues(void)
+{
+    // despawn by moving the last live enemy into the vacated index. the
+    // slot goes back on the free list with a new generation, which makes
+    // any other handles to the despawned enemy stale.
+    for (size_t k = 0; k < KillQueue.size(); ++k)
+    {
+        uint32_t handle = KillQueue[k];
+        if (!IsAlive(handle))
+            continue;
+
+        uint32_t slot = handle & ((1U << ENEMY_SLOT_BITS) - 1);
+        size_t   i    = Sparse[slot];
+        size_t   n    = --Count;
+        if (i != n)
+        {
+            PosX[i]       = PosX[n];
+            PosY[i]       = PosY[n];
+            VelX[i]       = VelX[n];
+            VelY[i]       = VelY[n];
+            Radius[i]     = Radius[n];
+            SepX[i]       = SepX[n];
+            SepY[i]       = SepY[n];
+            Heading[i]    = Heading[n];
+            SeekGain[i]   = SeekGain[n];
+            WanderGain[i] = WanderGain[n];
+            Type[i]       = Type[n];
+            Handle[i]     = Handle[n];
+            Sparse[Handle[i] & ((1U << ENEMY_SLOT_BITS) - 1)] = uint32_t(i);
+            Displaced++;
+        }
+        Generation[slot]++;
+        FreeSlots[FreeCount++] = slot;
+    }
+    KillQueue.clear();
+
+    for (size_t k = 0; k < SpawnQueue.size() && FreeCount > 0; ++k)
+    {
+        float          head;
+        random8_fill_uniform(&head, 1, -TRIG_PI, TRIG_PI, &Random);
+        spawn_t const &s    = SpawnQueue[k];
+        uint32_t       slot = FreeSlots[--FreeCount];
+        uint32_t       gen  = Generation[slot] & ((1U << (32 - ENEMY_SLOT_BITS)) - 1);
+        size_t         i    = Count++;
+        PosX[i]       = s.X;
+        PosY[i]       = s.Y;
+        VelX[i]       = 0.0f;
+        VelY[i]       = 0.0f;
+        Radius[i]     = Radii[s.Type];
+        SepX[i]       = 0.0f;
+        SepY[i]       = 0.0f;
+        Heading[i]    = head;
+        SeekGain[i]   = s.Type == ENEMY_SEEKER   ? 1.0f : 0.0f;
+        WanderGain[i] = s.Type == ENEMY_WANDERER ? 1.0f : 0.0f;
+        Type[i]       = s.Type;
+        Handle[i]     = (gen << ENEMY_SLOT_BITS) | slot;
+        Sparse[slot]  = uint32_t(i);
+        Displaced++;
+    }
+    if (FreeLow > FreeCount)
+        FreeLow = FreeCount;
+    SpawnQueue.clear();
+}
+
+void EnemyManager::UpdateSpawner(float elapsed)
+{
+    EntityManager *em     = EntityManager::GetInstance();
+    Player        *player = em != NULL ? em->GetPlayer(0) : NULL;
+    if (player == NULL || player->IsDead())
+        return;
+
+    // the odds are defined per 1/60th of a second, as in the original game.
+    float   ticks = elapsed * 60.0f;
+    float   roll[8];
+    float   const *p = player->GetPosition();
+    random8_fill_uniform(roll, 8, 0.0f, 1.0f, &Random);
+    for (size_t t = 0; t < ENEMY_TYPE_COUNT; ++t)
+    {
+        if (roll[t] * SpawnOdds >= ticks)
+            continue;
+
+        // pick a position away from the player; give up after a few tries.
+        for (size_t attempt = 0; attempt < 3; ++attempt)
+        {
+            float x  = roll[2 + attempt * 2 + 0] * WorldWidth;
+            float y  = roll[2 + attempt * 2 + 1] * WorldHeight;
+            float dx = x - p[0];
+            float dy = y - p[1];
+            if (dx * dx + dy * dy >= SPAWN_MIN_DISTANCE * SPAWN_MIN_DISTANCE)
+            {
+                Spawn(EnemyType(t), x, y);
+                break;
+            }
+        }
+    }
+    if (SpawnOdds > SPAWN_ODDS_END)
+    {
+        SpawnOdds = max2(SpawnOdds - SPAWN_ODDS_DECAY * ticks, SPAWN_ODDS_END);
+    }
+}
+
+void EnemyManager::CastRays(ray_t const *rays, size_t count, size_t max_hits, ray_hit_t *hits, size_t *hit_counts) const
+{
+    raycast_batch(&Grid, rays, count, max_hits, hits, hit_counts, TaskPool);
+}
+
+void EnemyManager::SweepCircles(float const *x, float const *y, float const *dx, float const *dy, float const *r, size_t count, sweep_hit_t *hits) const
+{
+    collide_sweep(&Grid, x, y, dx, dy, r, count, hits, TaskPool);
+}
+
+void EnemyManager::ApplyForceField(force_field_t const *field, double elapsedTime)
+{
+    field_apply(field, VelX, VelY, PosX, PosY, Count, float(elapsedTime), TaskPool);
+}
+
+void EnemyManager::Update(double currentTime, double elapsedTime)
+{
+    UNUSED_ARG(currentTime);
+    float step = float(elapsedTime);
+
+    UpdateSpawner(step);
+    CommitQueues();
+
+    // dense indices are free to change here, before the grid is rebuilt.
+    SortTicks++;
+    if ((SortInterval  > 0    && SortTicks >= SortInterval) ||
+        (SortThreshold > 0.0f && float(Displaced) > SortThreshold * float(Count)))
+    {
+        SortByPosition();
+    }
+    spatial_grid_build(&Grid, PosX, PosY, Radius, Count);
+    if (Count == 0) return;
+
+    enemy_separation_args_t sep;
+    sep.Grid      = &Grid;
+    sep.SepX      = SepX;
+    sep.SepY      = SepY;
+    sep.RadiusSq  = ENEMY_SEPARATION_RADIUS * ENEMY_SEPARATION_RADIUS;
+    sep.Softening = SEPARATION_SOFTENING;
+    sep.Strength  = SEPARATION_STRENGTH;
+    task_pool_parallel_for(TaskPool, Count, ENEMY_MIN_CHUNK, enemy_separation_range, &sep);
+
+    float turn = WANDER_TURN * step * 60.0f;
+    enemy_turn_k tk;
+    tk.Heading = Heading;
+    tk.Turn    = Turn;
+    random8_fill_uniform(Turn, Count, -turn, turn, &Random);
+    soa_for_range(tk, Heading, 0, Count);
+    fast_sincos_array(HeadingSin, HeadingCos, Heading, Count, TRIG_TIER_FAST);
+
+    // seekers idle while there is no living player to chase.
+    EntityManager *em     = EntityManager::GetInstance();
+    Player        *player = em != NULL ? em->GetPlayer(0) : NULL;
+    bool           chase  = player != NULL && !player->IsDead();
+    enemy_steer_k  k;
+    k.PosX       = PosX;
+    k.PosY       = PosY;
+    k.VelX       = VelX;
+    k.VelY       = VelY;
+    k.SepX       = SepX;
+    k.SepY       = SepY;
+    k.HeadingCos = HeadingCos;
+    k.HeadingSin = HeadingSin;
+    k.SeekGain   = SeekGain;
+    k.WanderGain = WanderGain;
+    k.TargetX    = chase ? player->GetPosition()[0] : 0.0f;
+    k.TargetY    = chase ? player->GetPosition()[1] : 0.0f;
+    k.Seek       = chase ? SEEKER_ACCELERATION * step : 0.0f;
+    k.Wander     = WANDERER_ACCELERATION * step;
+    k.Step       = step;
+    k.Friction   = powf(ENEMY_FRICTION, step * 60.0f);
+    task_pool_parallel_for(TaskPool, Count, ENEMY_MIN_CHUNK, enemy_steer_range, &k);
+    vec2_soa_clamp_rect(PosX, PosY, 0.0f, 0.0f, WorldWidth, WorldHeight, Count);
+}
+
+bool EnemyManager::Save(snapshot_buffer_t *buffer) const
+{
+    // steering scratch and draw state are recomputed every tick, and the
+    // per-type gains and radii are recomputed from Type on restore, so only
+    // the arrays below need to be kept. slots that have never been used
+    // still hold their initial generation and free list entries.
+    uint32_t header[8] =
+    {
+        uint32_t(Count),
+        uint32_t(FreeCount),
+        uint32_t(SpawnQueue.size()),
+        uint32_t(KillQueue.size()),
+        uint32_t(Grid.Count),
+        SortTicks,
+        Displaced,
+        uint32_t(FreeLow)
+    };
+    size_t const n = Count * sizeof(float);
+    size_t const g = Grid.Count * sizeof(float);
+    size_t const c = (Grid.CellsX * Grid.CellsY + 1) * sizeof(uint32_t);
+    bool ok = snapshot_write_value(buffer, header);
+    ok = ok && snapshot_write_value(buffer, SpawnOdds);
+    ok = ok && snapshot_write_value(buffer, Grid.MaxRadius);
+    ok = ok && snapshot_write_value(buffer, Random);
+    ok = ok && snapshot_write(buffer, PosX, n);
+    ok = ok && snapshot_write(buffer, PosY, n);
+    ok = ok && snapshot_write(buffer, VelX, n);
+    ok = ok && snapshot_write(buffer, VelY, n);
+    ok = ok && snapshot_write(buffer, Heading, n);
+    ok = ok && snapshot_write(buffer, Type, n);
+    ok = ok && snapshot_write(buffer, Handle, n);
+    ok = ok && snapshot_write(buffer, Generation, (Capacity - FreeLow) * sizeof(uint32_t));
+    ok = ok && snapshot_write(buffer, FreeSlots + FreeLow, (FreeCount - FreeLow) * sizeof(uint32_t));
+    ok = ok && snapshot_write(buffer, Grid.CellStart, c);
+    ok = ok && snapshot_write(buffer, Grid.Items, g);
+    ok = ok && snapshot_write(buffer, Grid.SortedX, g);
+    ok = ok && snapshot_write(buffer, Grid.SortedY, g);
+    ok = ok && snapshot_write(buffer, Grid.SortedR, g);
+    if (!SpawnQueue.empty()) ok = ok && snapshot_write(buffer, &SpawnQueue[0], SpawnQueue.size() * sizeof(spawn_t));
+    if (!KillQueue.empty())  ok = ok && snapshot_write(buffer, &KillQueue[0],  KillQueue.size()  * sizeof(uint32_t));
+    return ok;
+}
+
+bool EnemyManager::Restore(snapshot_buffer_t *buffer)
+{
+    uint32_t header[8];
+    if (!snapshot_read_value(buffer, header))
+        return false;
+    if (header[0] > Capacity || header[1] > Capacity || header[4] > Grid.Capacity || header[7] > header[1])
+        return false;
+
+    // slots first used after the snapshot return to their initial state.
+    for (size_t i = FreeLow; i < header[7]; ++i)
+    {
+        Generation[Capacity - 1 - i] = 0;
+        FreeSlots[i] = uint32_t(Capacity - 1 - i);
+    }
+    Count      = header[0];
+    FreeCount  = header[1];
+    Grid.Count = header[4];
+    SortTicks  = header[5];
+    Displaced  = header[6];
+    FreeLow    = header[7];
+    SpawnQueue.resize(header[2]);
+    KillQueue.resize(header[3]);
+
+    size_t const n = Count * sizeof(float);
+    size_t const g = Grid.Count * sizeof(float);
+    size_t const c = (Grid.CellsX * Grid.CellsY + 1) * sizeof(uint32_t);
+    bool ok = snapshot_read_value(buffer, SpawnOdds);
+    ok = ok && snapshot_read_value(buffer, Grid.MaxRadius);
+    ok = ok && snapshot_read_value(buffer, Random);
+    ok = ok && snapshot_read(buffer, PosX, n);
+    ok = ok && snapshot_read(buffer, PosY, n);
+    ok = ok && snapshot_read(buffer, VelX, n);
+    ok = ok && snapshot_read(buffer, VelY, n);
+    ok = ok && snapshot_read(buffer, Heading, n);
+    ok = ok && snapshot_read(buffer, Type, n);
+    ok = ok && snapshot_read(buffer, Handle, n);
+    ok = ok && snapshot_read(buffer, Generation, (Capacity - FreeLow) * sizeof(uint32_t));
+    ok = ok && snapshot_read(buffer, FreeSlots + FreeLow, (FreeCount - FreeLow) * sizeof(uint32_t));
+    ok = ok && snapshot_read(buffer, Grid.CellStart, c);
+    ok = ok && snapshot_read(buffer, Grid.Items, g);
+    ok = ok && snapshot_read(buffer, Grid.SortedX, g);
+    ok = ok && snapshot_read(buffer, Grid.SortedY, g);
+    ok = ok && snapshot_read(buffer, Grid.SortedR, g);
+    if (!SpawnQueue.empty()) ok = ok && snapshot_read(buffer, &SpawnQueue[0], SpawnQueue.size() * sizeof(spawn_t));
+    if (!KillQueue.empty())  ok = ok && snapshot_read(buffer, &KillQueue[0],  KillQueue.size()  * sizeof(uint32_t));
+    if (!ok)
+    {
+        Clear();
+        return false;
+    }
+
+    // slots not referenced by a live enemy keep stale Sparse entries, which
+    // IsAlive rejects by checking the handle stored at the dense index.
+    for (size_t i = 0; i < Count; ++i)
+    {
+        uint32_t t    = Type[i];
+        Radius[i]     = Radii[t];
+        SeekGain[i]   = t == ENEMY_SEEKER   ? 1.0f : 0.0f;
+        WanderGain[i] = t == ENEMY_WANDERER ? 1.0f : 0.0f;
+        Sparse[Handle[i] & ((1U << ENEMY_SLOT_BITS) - 1)] = uint32_t(i);
+    }
+    return true;
+}
+
+void EnemyManager::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
+{
+    UNUSED_ARG(currentTime);
+    UNUSED_ARG(elapsedTime);
+    if (Count == 0) return;
+
+    // enemies face their direction of travel. each type is gathered into
+    // the scratch arrays and submitted as a single run of sprites.
+    SpriteBatch *batch = dm->GetBatch();
+    vec2_soa_direction(FacingCos, FacingSin, VelX, VelY, Count);
+    for (size_t t = 0; t < ENEMY_TYPE_COUNT; ++t)
+    {
+        Texture *image = Images[t];
+        size_t   n     = 0;
+        for (size_t i  = 0; i < Count; ++i)
+        {
+            if (Type[i] == t)
+            {
+                DrawX[n]     = PosX[i];
+                DrawY[n]     = PosY[i];
+                DrawCos[n]   = FacingCos[i];
+                DrawSin[n]   = FacingSin[i];
+                n++;
+            }
+        }
+        if (n == 0 || image == NULL)
+            continue;
+
+        float  width  = float(image->GetWidth());
+        float  height = float(image->GetHeight());
+        rect_t src    = { 0, 0, width, height };
+        batch->AddArrayRotated(1, image, src, n, DrawX, DrawY, DrawCos, DrawSin, NULL, NULL, DrawColor, width * 0.5f, height * 0.5f);
+    }
+}
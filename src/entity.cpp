@@ -7,9 +7,15 @@
 //   Includes   //
 ////////////////*/
 #include <stdio.h>
+#include <string.h>
+#include "math.hpp"
+#include "math_trig.hpp"
 #include "entity.hpp"
 #include "bullet.hpp"
+#include "blackhole.hpp"
 #include "player.hpp"
+#include "enemy.hpp"
+#include "events.hpp"
 #include "input.hpp"
 #include "display.hpp"
 
@@ -19,6 +25,28 @@
 /// @summary The global EntityManager instance.
 EntityManager* EntityManager::EM = NULL;
 
+/// @summary The RGBA color of the sparks emitted when a bullet hits an enemy.
+static const float IMPACT_COLOR[4] = { 0.6f, 1.0f, 1.0f, 1.0f };
+
+/// @summary The number of timers allocated up front; the wheel grows as needed.
+#define ENTITY_TIMER_RESERVE         (256U)
+
+/// @summary The number of levels below the root of the entity index. On an
+/// 800 pixel viewport the smallest cells are 12.5 pixels across.
+#define ENTITY_INDEX_DEPTH           (6U)
+
+/// @summary The maximum number of entities in the index. Entities created
+/// beyond this are simulated and drawn, but not found by queries.
+#define ENTITY_INDEX_CAPACITY        (16384U)
+
+/// @summary The edge length of a cell of the bullet grid, in world units,
+/// about the diameter of a black hole.
+#define ENTITY_BULLET_CELL           (32.0f)
+
+/// @summary The number of bullets the bullet grid holds up front; it is
+/// reallocated at twice the size whenever a tick has more.
+#define ENTITY_BULLET_RESERVE        (1024U)
+
 /*///////////////////////
 //   Local Functions   //
 ///////////////////////*/
@@ -28,15 +56,18 @@ EntityManager* EntityManager::EM = NULL;
 ///////////////////////*/
 Entity::Entity(void) :
     Image(NULL),
-    Orientation(0.0f),
-    Radius(0.0f),
-    IsExpired(false),
-    Kind(ENTITY_DONT_CARE)
+    State(&Spawn)
 {
-    Color[0] = 1.0f;
-    Color[1] = 1.0f;
-    Color[2] = 1.0f;
-    Color[3] = 1.0f;
+    // zero the bytes of the kind-specific state that the kind does not use,
+    // so that snapshots hash identically on every peer.
+    memset(&Spawn, 0, sizeof(Spawn));
+    Spawn.Kind        = ENTITY_DONT_CARE;
+    Spawn.Color[0]    = 1.0f;
+    Spawn.Color[1]    = 1.0f;
+    Spawn.Color[2]    = 1.0f;
+    Spawn.Color[3]    = 1.0f;
+    Spawn.Rotation[0] = 1.0f;
+    Spawn.Rotation[1] = 0.0f;
 }
 
 Entity::~Entity(void)
@@ -44,6 +75,27 @@ Entity::~Entity(void)
     /* empty */
 }
 
+float Entity::GetOrientation(void) const
+{
+    return fast_atan2(State->Rotation[1], State->Rotation[0], TRIG_TIER_FAST);
+}
+
+void Entity::SetOrientation(float angle)
+{
+    fast_sincos(angle, State->Rotation[1], State->Rotation[0], TRIG_TIER_FAST);
+}
+
+void Entity::SetDirection(float x, float y)
+{
+    float len_sq = x * x + y * y;
+    if (len_sq > 0.0f)
+    {
+        float inv_len      = 1.0f / sqrtf(len_sq);
+        State->Rotation[0] = x * inv_len;
+        State->Rotation[1] = y * inv_len;
+    }
+}
+
 void Entity::Input(double currentTime, double elapsedTime, InputManager *im)
 {
     UNUSED_ARG(currentTime);
@@ -58,13 +110,13 @@ void Entity::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
     float  width   = (float) Image->GetWidth();
     float  height  = (float) Image->GetHeight();
     rect_t src     = { 0, 0, width, height };
-    float  posx    = Position[0];
-    float  posy    = Position[1];
+    float  posx    = State->Position[0];
+    float  posy    = State->Position[1];
     float  originx = width  * 0.5f;
     float  originy = height * 0.5f;
     float  scalex  = 1.0f;
     float  scaley  = 1.0f;
-    dm->GetBatch()->Add(1, Image, posx, posy, src, Color, Orientation, originx, originy, scalex, scaley);
+    dm->GetBatch()->AddRotated(1, Image, posx, posy, src, State->Color, State->Rotation[0], State->Rotation[1], originx, originy, scalex, scaley);
 }
 
 EntityManager* EntityManager::GetInstance(void)
@@ -72,10 +124,21 @@ EntityManager* EntityManager::GetInstance(void)
     return EM;
 }
 
-EntityManager::EntityManager(void)
+EntityManager::EntityManager(double tickLength)
     :
+    TickLength(tickLength),
+    IndexStale(false),
     IsUpdating(false)
 {
+    DisplayManager *dm = DisplayManager::GetInstance();
+    float    width     = (dm != NULL) ? dm->GetWorldWidth()  : DISPLAY_WORLD_WIDTH;
+    float    height    = (dm != NULL) ? dm->GetWorldHeight() : DISPLAY_WORLD_HEIGHT;
+    field_create(&Field, 0.0f, 0.0f, width, height);
+    timer_wheel_create(&Timers, ENTITY_TIMER_RESERVE);
+    quadtree_create(&Index, 0.0f, 0.0f, max2(width, height), ENTITY_INDEX_DEPTH, ENTITY_INDEX_CAPACITY);
+    spatial_grid_create(&BulletGrid, 0.0f, 0.0f, width, height, ENTITY_BULLET_CELL, ENTITY_BULLET_RESERVE);
+    timer_wheel_register(&Timers, TIMER_PLAYER_RELOAD , EntityManager::PlayersReloaded , this);
+    timer_wheel_register(&Timers, TIMER_PLAYER_RESPAWN, EntityManager::PlayersRespawned, this);
     EntityManager::EM = this;
 }
 
@@ -89,7 +152,12 @@ EntityManager::~EntityManager(void)
     Entities.clear();
     AddedEntities.clear();
     Bullets.clear();
+    BlackHoles.clear();
     Players.clear();
+    field_delete(&Field);
+    timer_wheel_delete(&Timers);
+    quadtree_delete(&Index);
+    spatial_grid_delete(&BulletGrid);
 }
 
 size_t EntityManager::PlayerCount(void) const
@@ -126,7 +194,17 @@ void EntityManager::Add(Entity *entity)
 void EntityManager::AddEntity(Entity *entity)
 {
     entity->Init(DisplayManager::GetInstance());
+    entity_state_t const *base = States.empty() ? NULL : &States[0];
+    States.push_back(*entity->GetState());
     Entities.push_back(entity);
+    if (&States[0] != base) BindStates();
+    else entity->SetState(&States.back());
+    Track(entity);
+    IndexStale = true;
+}
+
+void EntityManager::Track(Entity *entity)
+{
     switch (entity->GetKind())
     {
         case ENTITY_BULLET:
@@ -137,6 +215,7 @@ void EntityManager::AddEntity(Entity *entity)
             break;
 
         case ENTITY_BLACKHOLE:
+            BlackHoles.push_back((BlackHole*) entity);
             break;
 
         case ENTITY_PLAYER:
@@ -148,16 +227,313 @@ void EntityManager::AddEntity(Entity *entity)
     }
 }
 
+void EntityManager::BindStates(void)
+{
+    size_t n = 0;
+    for (std::list<Entity*>::iterator i = Entities.begin(); i != Entities.end(); ++i)
+    {
+        (*i)->SetState(&States[n++]);
+    }
+}
+
+void EntityManager::RemoveExpired(void)
+{
+    // the kind lists are pruned first, while the expired entities still
+    // point at their state.
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i)
+    {
+        if ((*i)->GetExpired()) *i = NULL;
+    }
+    Bullets.remove(NULL);
+    for (std::list<BlackHole*>::iterator i = BlackHoles.begin(); i != BlackHoles.end(); ++i)
+    {
+        if ((*i)->GetExpired()) *i = NULL;
+    }
+    BlackHoles.remove(NULL);
+    for (std::list<Player*>::iterator i = Players.begin(); i != Players.end(); ++i)
+    {
+        if ((*i)->GetExpired()) *i = NULL;
+    }
+    Players.remove(NULL);
+
+    // the state of each survivor moves down over the expired entities, so
+    // States stays in list order without reallocating.
+    std::list<Entity*>::iterator i = Entities.begin();
+    size_t n = 0;
+    while (i != Entities.end())
+    {
+        Entity *e = *i;
+        if (e->GetExpired())
+        {
+            delete e;
+            i = Entities.erase(i);
+            continue;
+        }
+        if (e->GetState() != &States[n])
+        {
+            States[n] = *e->GetState();
+            e->SetState(&States[n]);
+        }
+        ++n;
+        ++i;
+    }
+    States.resize(n);
+}
+
+void EntityManager::RebuildIndex(void)
+{
+    // assign items in list order and insert them all at once.
+    size_t n = Entities.size() < ENTITY_INDEX_CAPACITY ? Entities.size() : ENTITY_INDEX_CAPACITY;
+    IndexItems.clear();
+    FieldScratch.resize(n * 3 + 1);
+    float *x = &FieldScratch[0];
+    float *y = x + n;
+    float *r = y + n;
+    for (std::list<Entity*>::iterator i = Entities.begin(); i != Entities.end() && IndexItems.size() < n; ++i)
+    {
+        Entity      *e = *i;
+        size_t       j = IndexItems.size();
+        float const *p = e->GetPosition();
+        x[j] = p[0];
+        y[j] = p[1];
+        r[j] = e->GetRadius();
+        IndexItems.push_back(e);
+    }
+    quadtree_build(&Index, x, y, r, n);
+    IndexStale = false;
+}
+
+Entity* EntityManager::CreateEntity(entity_state_t const *state)
+{
+    switch (state->Kind)
+    {
+        case ENTITY_BULLET:
+            return new Bullet();
+
+        case ENTITY_BLACKHOLE:
+            return new BlackHole();
+
+        case ENTITY_PLAYER:
+            return new Player(state->Index);
+
+        default:
+            break;
+    }
+    return NULL;
+}
+
+void EntityManager::ApplyForceField(float elapsed)
+{
+    field_clear(&Field);
+    for (std::list<BlackHole*>::iterator i = BlackHoles.begin(); i != BlackHoles.end(); ++i)
+    {
+        (*i)->AddToField(&Field);
+    }
+    if (Field.SourceCount == 0 || Bullets.empty())
+        return;
+
+    // gather bullets into structure-of-arrays form, apply the field, and
+    // scatter the new velocities back. bullet velocities are in pixels per
+    // tick, so the acceleration is scaled by the tick length twice.
+    size_t n = Bullets.size();
+    FieldScratch.resize(n * 4);
+    float *px = &FieldScratch[0];
+    float *py = px + n;
+    float *vx = py + n;
+    float *vy = vx + n;
+    size_t j  = 0;
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i, ++j)
+    {
+        float const *p = (*i)->GetPosition();
+        float const *v = (*i)->GetVelocity();
+        px[j] = p[0]; py[j] = p[1];
+        vx[j] = v[0]; vy[j] = v[1];
+    }
+    field_apply(&Field, vx, vy, px, py, n, elapsed * elapsed, NULL);
+    j = 0;
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i, ++j)
+    {
+        (*i)->SetVelocity(vx[j], vy[j]);
+    }
+}
+
+void EntityManager::CollideBullets(void)
+{
+    EnemyManager *enemies = EnemyManager::GetInstance();
+    if (enemies == NULL || enemies->GetCount() == 0 || Bullets.empty())
+        return;
+
+    // sweep each bullet along the displacement it is about to make. bullets
+    // that hit an enemy stop at the point of contact and expire before they
+    // get a chance to move through it.
+    size_t n = Bullets.size();
+    FieldScratch.resize(n * 5);
+    SweepHits.resize(n);
+    float *px = &FieldScratch[0];
+    float *py = px + n;
+    float *vx = py + n;
+    float *vy = vx + n;
+    float *r  = vy + n;
+    size_t j  = 0;
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i, ++j)
+    {
+        float const *p = (*i)->GetPosition();
+        float const *v = (*i)->GetVelocity();
+        px[j] = p[0]; py[j] = p[1];
+        vx[j] = v[0]; vy[j] = v[1];
+        r [j] = (*i)->GetRadius();
+    }
+    enemies->SweepCircles(px, py, vx, vy, r, n, &SweepHits[0]);
+
+    EventBus *bus = EventBus::GetInstance();
+    j = 0;
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i, ++j)
+    {
+        sweep_hit_t const &hit = SweepHits[j];
+        if (hit.Item == COLLIDE_NO_HIT)
+            continue;
+
+        float x = px[j] + vx[j] * hit.Time;
+        float y = py[j] + vy[j] * hit.Time;
+        enemies->Kill(enemies->GetHandle(hit.Item));
+        (*i)->SetPosition(x, y);
+        (*i)->SetExpired();
+        bus->EmitBurst(x, y, 30, 60.0f, 600.0f, IMPACT_COLOR, 0.75f, 1.0f);
+    }
+}
+
+void EntityManager::CollideBlackHoles(void)
+{
+    if (BlackHoles.empty() || Bullets.empty())
+        return;
+
+    // bin the bullets by center, growing the grid if this tick has more than
+    // it holds. bullets only expire here, so the outcome does not depend on
+    // the order in which the black holes scan the grid.
+    size_t n = Bullets.size();
+    if (n > BulletGrid.Capacity)
+    {
+        size_t capacity = max2(n, 2 * BulletGrid.Capacity);
+        spatial_grid_delete(&BulletGrid);
+        spatial_grid_create(&BulletGrid, 0.0f, 0.0f, (float) BulletGrid.CellsX * ENTITY_BULLET_CELL, (float) BulletGrid.CellsY * ENTITY_BULLET_CELL, ENTITY_BULLET_CELL, capacity);
+    }
+    FieldScratch.resize(n * 2);
+    BulletItems.resize(n);
+    float *px = &FieldScratch[0];
+    float *py = px + n;
+    size_t j  = 0;
+    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i, ++j)
+    {
+        float const *p = (*i)->GetPosition();
+        px[j] = p[0]; py[j] = p[1];
+        BulletItems[j] = *i;
+    }
+    spatial_grid_build(&BulletGrid, px, py, NULL, n);
+
+    // bullets whose centers lie within a black hole are swallowed.
+    for (std::list<BlackHole*>::iterator i = BlackHoles.begin(); i != BlackHoles.end(); ++i)
+    {
+        BlackHole   *hole = *i;
+        float const *p    = hole->GetPosition();
+        float        r    = hole->GetRadius();
+        if (hole->GetExpired())
+            continue;
+
+        size_t col0 = spatial_grid_column(&BulletGrid, p[0] - r);
+        size_t col1 = spatial_grid_column(&BulletGrid, p[0] + r);
+        size_t row0 = spatial_grid_row   (&BulletGrid, p[1] - r);
+        size_t row1 = spatial_grid_row   (&BulletGrid, p[1] + r);
+        for (size_t row = row0; row <= row1; ++row)
+        {
+            size_t b, e;
+            spatial_grid_run(&BulletGrid, row, col0, col1, b, e);
+            for (size_t k = b; k < e; ++k)
+            {
+                float dx = BulletGrid.SortedX[k] - p[0];
+                float dy = BulletGrid.SortedY[k] - p[1];
+                if (dx * dx + dy * dy <= r * r)
+                    BulletItems[BulletGrid.Items[k]]->SetExpired();
+            }
+        }
+    }
+}
+
+void EntityManager::PlayersReloaded(uint32_t const *players, size_t count, void *context)
+{
+    EntityManager *em = (EntityManager*) context;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Player *player = em->GetPlayer(int(players[i]));
+        if (player != NULL) player->Reload();
+    }
+}
+
+void EntityManager::PlayersRespawned(uint32_t const *players, size_t count, void *context)
+{
+    EntityManager *em = (EntityManager*) context;
+    for (size_t i = 0; i < count; ++i)
+    {
+        Player *player = em->GetPlayer(int(players[i]));
+        if (player != NULL) player->Respawn();
+    }
+}
+
+timer_handle_t EntityManager::Schedule(EntityTimerKind kind, uint32_t payload, double delay)
+{
+    return timer_wheel_schedule(&Timers, uint32_t(kind), payload, timer_ticks(delay, TickLength));
+}
+
+bool EntityManager::Cancel(timer_handle_t handle)
+{
+    return timer_wheel_cancel(&Timers, handle);
+}
+
+size_t EntityManager::QueryCircle(float x, float y, float r, std::vector<Entity*> &result)
+{
+    result.clear();
+    if (IndexStale)
+        RebuildIndex();
+    if (Index.Count == 0)
+        return 0;
+
+    IndexHits.resize(Index.Count);
+    size_t n = quadtree_query_circle(&Index, x, y, r, &IndexHits[0], IndexHits.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        result.push_back(IndexItems[IndexHits[i]]);
+    }
+    return n;
+}
+
+size_t EntityManager::FindNearest(float x, float y, size_t k, float max_dist, Entity **result)
+{
+    uint32_t items[ENTITY_NEAREST_MAX];
+    float    dist_sq[ENTITY_NEAREST_MAX];
+    if (IndexStale)
+        RebuildIndex();
+    size_t   n = quadtree_nearest(&Index, x, y, k < ENTITY_NEAREST_MAX ? k : ENTITY_NEAREST_MAX, max_dist, items, dist_sq);
+    for (size_t i = 0; i < n; ++i)
+    {
+        result[i] = IndexItems[items[i]];
+    }
+    return n;
+}
+
 void EntityManager::Update(double currentTime, double elapsedTime)
 {
+    timer_wheel_advance(&Timers);
+    ApplyForceField(float(elapsedTime));
+    CollideBullets();
+    CollideBlackHoles();
+
     IsUpdating = true;
     for (std::list<Entity*>::iterator i = Entities.begin(); i != Entities.end(); ++i)
     {
-        (*i)->Update(currentTime, elapsedTime);
-        if ((*i)->GetExpired())
-            *i = NULL;
+        if ((*i)->GetExpired() == false)
+            (*i)->Update(currentTime, elapsedTime);
     }
     IsUpdating = false;
+    RemoveExpired();
 
     // add entities created during the update:
     for (std::list<Entity*>::iterator i = AddedEntities.begin(); i != AddedEntities.end(); ++i)
@@ -165,18 +541,9 @@ void EntityManager::Update(double currentTime, double elapsedTime)
         AddEntity(*i);
     }
     AddedEntities.clear();
-    Entities.remove(NULL);
 
-    // prune bullet objects.
-    for (std::list<Bullet*>::iterator i = Bullets.begin(); i != Bullets.end(); ++i)
-    {
-        if ((*i)->GetExpired())
-        {
-            delete *i;
-            *i = NULL;
-        }
-    }
-    Bullets.remove(NULL);
+    // the index is rebuilt by the first query after entities move.
+    IndexStale = true;
 }
 
 void EntityManager::Input(double currentTime, double elapsedTime, InputManager *im)
@@ -194,3 +561,101 @@ void EntityManager::Draw(double currentTime, double elapsedTime, DisplayManager
         (*i)->Draw(currentTime, elapsedTime, dm);
     }
 }
+
+bool EntityManager::Save(snapshot_buffer_t *buffer) const
+{
+    uint32_t count = uint32_t(States.size());
+    bool     ok    = snapshot_write_value(buffer, count);
+    if (ok && count > 0)
+        ok = snapshot_write(buffer, &States[0], count * sizeof(entity_state_t));
+
+    // the timing wheel is plain data; only the nodes in use are written.
+    ok = ok && snapshot_write_value(buffer, Timers.Now);
+    ok = ok && snapshot_write_value(buffer, uint32_t(Timers.Count));
+    ok = ok && snapshot_write_value(buffer, uint32_t(Timers.Used));
+    ok = ok && snapshot_write_value(buffer, Timers.FreeHead);
+    ok = ok && snapshot_write(buffer, Timers.Slots, sizeof(Timers.Slots));
+    ok = ok && snapshot_write(buffer, Timers.Nodes, Timers.Used * sizeof(timer_node_t));
+    return ok;
+}
+
+bool EntityManager::RestoreTimers(snapshot_buffer_t *buffer)
+{
+    uint32_t count = 0;
+    uint32_t used  = 0;
+    bool ok = snapshot_read_value(buffer, Timers.Now);
+    ok = ok && snapshot_read_value(buffer, count);
+    ok = ok && snapshot_read_value(buffer, used);
+    ok = ok && snapshot_read_value(buffer, Timers.FreeHead);
+    ok = ok && snapshot_read(buffer, Timers.Slots, sizeof(Timers.Slots));
+    ok = ok && timer_wheel_reserve(&Timers, used);
+    ok = ok && snapshot_read(buffer, Timers.Nodes, used * sizeof(timer_node_t));
+    Timers.Count = ok ? count : 0;
+    Timers.Used  = ok ? used  : 0;
+    return ok;
+}
+
+bool EntityManager::Restore(snapshot_buffer_t *buffer)
+{
+    uint32_t              count = 0;
+    entity_state_t const *state = NULL;
+    if (!snapshot_read_value(buffer, count))
+        return false;
+    if ((state = (entity_state_t const*) snapshot_view(buffer, count * sizeof(entity_state_t))) == NULL)
+        return false;
+
+    // keep live entities for as long as they match the saved entities,
+    // which is normally all but the few created or destroyed since the
+    // snapshot was taken. their state is replaced by the copy below.
+    std::list<Entity*>::iterator iter = Entities.begin();
+    size_t n = 0;
+    while (n < count && iter != Entities.end())
+    {
+        Entity *e = *iter;
+        if (uint32_t(e->GetKind()) != state[n].Kind)
+            break;
+        if (e->GetKind() == ENTITY_PLAYER && ((Player*) e)->GetIndex() != state[n].Index)
+            break;
+
+        ++iter;
+        ++n;
+    }
+    States.assign(state, state + count);
+    if (n == count && iter == Entities.end())
+    {
+        BindStates();
+        IndexStale = true;
+        return RestoreTimers(buffer);
+    }
+
+    // delete the remaining entities and recreate the rest from the snapshot.
+    // saved entities of an unknown kind are dropped.
+    for (std::list<Entity*>::iterator i = iter; i != Entities.end(); ++i)
+    {
+        delete *i;
+    }
+    Entities.erase(iter, Entities.end());
+    for (size_t i = n; i < count; ++i)
+    {
+        Entity *e = CreateEntity(&state[i]);
+        if (e != NULL)
+        {
+            e->Init(DisplayManager::GetInstance());
+            Entities.push_back(e);
+            States[n++] = state[i];
+        }
+    }
+    States.resize(n);
+    BindStates();
+    Bullets.clear();
+    BlackHoles.clear();
+    Players.clear();
+    for (std::list<Entity*>::iterator i = Entities.begin(); i != Entities.end(); ++i)
+    {
+        Track(*i);
+    }
+    IndexStale = true;
+    // recreated entities may have scheduled timers in Init; restoring the
+    // wheel afterwards discards them.
+    return RestoreTimers(buffer);
+}
@@ -0,0 +1,95 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the simulation event bus.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "events.hpp"
+#include "entity.hpp"
+#include "bullet.hpp"
+#include "particle.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The global EventBus instance.
+EventBus* EventBus::EB = NULL;
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+EventBus* EventBus::GetInstance(void)
+{
+    return EB;
+}
+
+EventBus::EventBus(void)
+{
+    event_stream_create(&BulletSpawns  , sizeof(bullet_spawn_event_t)  , EVENT_BULLET_CAPACITY);
+    event_stream_create(&ParticleBursts, sizeof(particle_burst_event_t), EVENT_BURST_CAPACITY);
+    EventBus::EB = this;
+}
+
+EventBus::~EventBus(void)
+{
+    event_stream_delete(&ParticleBursts);
+    event_stream_delete(&BulletSpawns);
+    EventBus::EB = NULL;
+}
+
+void EventBus::SpawnBullet(float x, float y, float vx, float vy)
+{
+    bullet_spawn_event_t ev = { x, y, vx, vy };
+    event_stream_push(&BulletSpawns, ev);
+}
+
+void EventBus::EmitBurst(float x, float y, size_t count, float min_speed, float max_speed, float const *rgba, float duration, float scale)
+{
+    particle_burst_event_t ev;
+    ev.X        = x;
+    ev.Y        = y;
+    ev.Count    = uint32_t(count);
+    ev.MinSpeed = min_speed;
+    ev.MaxSpeed = max_speed;
+    ev.Color[0] = rgba[0];
+    ev.Color[1] = rgba[1];
+    ev.Color[2] = rgba[2];
+    ev.Color[3] = rgba[3];
+    ev.Duration = duration;
+    ev.Scale    = scale;
+    event_stream_push(&ParticleBursts, ev);
+}
+
+void EventBus::Dispatch(void)
+{
+    EntityManager *em = EntityManager::GetInstance();
+    if (em != NULL)
+    {
+        bullet_spawn_event_t const *ev = event_stream_data<bullet_spawn_event_t>(&BulletSpawns);
+        size_t                       n = event_stream_count(&BulletSpawns);
+        for (size_t i = 0; i < n; ++i)
+        {
+            em->AddEntity(new Bullet(ev[i].X, ev[i].Y, ev[i].VelX, ev[i].VelY));
+        }
+    }
+
+    ParticleManager *pm = ParticleManager::GetInstance();
+    if (pm != NULL)
+    {
+        particle_burst_event_t const *ev = event_stream_data<particle_burst_event_t>(&ParticleBursts);
+        size_t                         n = event_stream_count(&ParticleBursts);
+        for (size_t i = 0; i < n; ++i)
+        {
+            pm->EmitBurst(ev[i].X, ev[i].Y, ev[i].Count, ev[i].MinSpeed, ev[i].MaxSpeed, ev[i].Color, ev[i].Duration, ev[i].Scale);
+        }
+    }
+    event_stream_reset(&BulletSpawns);
+    event_stream_reset(&ParticleBursts);
+}
+
+size_t EventBus::DroppedCount(void) const
+{
+    return BulletSpawns.Dropped + ParticleBursts.Dropped;
+}
@@ -0,0 +1,231 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the force field. Each source marks the cells covered
+/// by its bounding square in a coarse grid; bodies are then processed in
+/// blocks, and each block runs a SIMD kernel for only those sources marked in
+/// the cells under the bounding box of the block.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "ll_task.hpp"
+#include "field.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The minimum number of blocks of bodies processed by a single task.
+#define FIELD_MIN_BLOCKS             64U
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel accumulating the pull and swirl of a single source into the
+/// velocity of each body within its radius.
+struct field_source_k
+{
+    float const *PosX, *PosY;
+    float       *VelX, *VelY;
+    float        CX, CY, Pull, Swirl, Softening, RadiusSq;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::sub(L::splat(CX), L::load(PosX + i));
+        typename L::value_t dy = L::sub(L::splat(CY), L::load(PosY + i));
+        typename L::value_t ds = L::add(L::mul(dx, dx), L::mul(dy, dy));
+        typename L::value_t m  = L::div(L::splat(1.0f), L::add(L::splat(Softening), ds));
+        typename L::value_t p  = L::splat(Pull);
+        typename L::value_t s  = L::splat(Swirl);
+        m = L::select_lt(ds, L::splat(RadiusSq), m);
+        typename L::value_t fx = L::sub(L::mul(dx, p), L::mul(dy, s));
+        typename L::value_t fy = L::add(L::mul(dy, p), L::mul(dx, s));
+        L::store(VelX + i, L::add(L::load(VelX + i), L::mul(fx, m)));
+        L::store(VelY + i, L::add(L::load(VelY + i), L::mul(fy, m)));
+    }
+};
+
+/// @summary The arguments to field_apply(), passed to each task.
+struct field_apply_args_t
+{
+    force_field_t const *Field;
+    float               *VelX;
+    float               *VelY;
+    float const         *PosX;
+    float const         *PosY;
+    size_t               Count;
+    float                Scale;
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Converts a coordinate to a cell index, clamped to the grid. Since
+/// both sources and bodies are clamped the same way, overlap is preserved for
+/// anything lying outside of the grid.
+/// @param v The coordinate value.
+/// @param origin The coordinate of the grid origin along the same axis.
+/// @param inv_cell The reciprocal of the cell edge length.
+/// @param cells The number of cells along the axis.
+/// @return The clamped cell index.
+static inline size_t field_cell(float v, float origin, float inv_cell, size_t cells)
+{
+    float c = (v - origin) * inv_cell;
+    if (c <= 0.0f) return 0;
+    if (c >= float(cells - 1)) return cells - 1;
+    return size_t(c);
+}
+
+/// @summary Retrieves the set of sources that may affect a rectangular region.
+/// @param field The force field to query.
+/// @param x0 The minimum x-coordinate of the region.
+/// @param y0 The minimum y-coordinate of the region.
+/// @param x1 The maximum x-coordinate of the region.
+/// @param y1 The maximum y-coordinate of the region.
+/// @return A bitmask with bit i set if Sources[i] may affect the region.
+static uint64_t field_query(force_field_t const *field, float x0, float y0, float x1, float y1)
+{
+    size_t   cx0  = field_cell(x0, field->OriginX, field->InvCellSize, field->CellsX);
+    size_t   cy0  = field_cell(y0, field->OriginY, field->InvCellSize, field->CellsY);
+    size_t   cx1  = field_cell(x1, field->OriginX, field->InvCellSize, field->CellsX);
+    size_t   cy1  = field_cell(y1, field->OriginY, field->InvCellSize, field->CellsY);
+    uint64_t mask = 0;
+    for (size_t y = cy0; y <= cy1; ++y)
+    {
+        uint64_t const *row = field->CellMask + y * field->CellsX;
+        for (size_t x = cx0; x <= cx1; ++x)
+        {
+            mask |= row[x];
+        }
+    }
+    return mask;
+}
+
+/// @summary Applies the force field to a range of blocks of bodies.
+/// @param begin The index of the first block to process.
+/// @param end The index one past the last block to process.
+/// @param context The field_apply_args_t describing the bodies.
+static void field_apply_range(size_t begin, size_t end, void *context)
+{
+    field_apply_args_t const *args  = (field_apply_args_t const*) context;
+    force_field_t      const *field = args->Field;
+    float              const *px    = args->PosX;
+    float              const *py    = args->PosY;
+    field_source_k            k;
+
+    k.PosX = px;
+    k.PosY = py;
+    k.VelX = args->VelX;
+    k.VelY = args->VelY;
+    for (size_t b = begin; b < end; ++b)
+    {
+        size_t i0 = b  * FIELD_BLOCK_SIZE;
+        size_t i1 = i0 + FIELD_BLOCK_SIZE;
+        if (i1 > args->Count) i1 = args->Count;
+
+        float x0 = px[i0], x1 = px[i0];
+        float y0 = py[i0], y1 = py[i0];
+        for (size_t i = i0 + 1; i < i1; ++i)
+        {
+            x0 = min2(x0, px[i]); x1 = max2(x1, px[i]);
+            y0 = min2(y0, py[i]); y1 = max2(y1, py[i]);
+        }
+
+        uint64_t mask = field_query(field, x0, y0, x1, y1);
+        for (size_t s = 0; mask != 0; ++s, mask >>= 1)
+        {
+            if ((mask & 1) == 0)
+                continue;
+
+            field_source_t const &src = field->Sources[s];
+            k.CX        = src.X;
+            k.CY        = src.Y;
+            k.Pull      = src.Pull  * args->Scale;
+            k.Swirl     = src.Swirl * args->Scale;
+            k.Softening = src.Softening;
+            k.RadiusSq  = src.Radius * src.Radius;
+            soa_for_range(k, k.VelX, i0, i1);
+        }
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void field_create(force_field_t *field, float x, float y, float width, float height, float cell_size)
+{
+    size_t cells_x      = size_t(ceilf(width  / cell_size));
+    size_t cells_y      = size_t(ceilf(height / cell_size));
+    field->SourceCount  = 0;
+    field->OriginX      = x;
+    field->OriginY      = y;
+    field->InvCellSize  = 1.0f / cell_size;
+    field->CellsX       = cells_x > 0 ? cells_x : 1;
+    field->CellsY       = cells_y > 0 ? cells_y : 1;
+    field->CellMask     = (uint64_t*) calloc(field->CellsX * field->CellsY, sizeof(uint64_t));
+}
+
+void field_delete(force_field_t *field)
+{
+    free(field->CellMask);
+    field->CellMask    = NULL;
+    field->CellsX      = 0;
+    field->CellsY      = 0;
+    field->SourceCount = 0;
+}
+
+void field_clear(force_field_t *field)
+{
+    if (field->SourceCount > 0)
+    {
+        memset(field->CellMask, 0, field->CellsX * field->CellsY * sizeof(uint64_t));
+        field->SourceCount = 0;
+    }
+}
+
+bool field_add_source(force_field_t *field, field_source_t const &source)
+{
+    if (field->SourceCount == FIELD_MAX_SOURCES)
+        return false;
+
+    size_t   index = field->SourceCount++;
+    uint64_t bit   = uint64_t(1) << index;
+    size_t   cx0   = field_cell(source.X - source.Radius, field->OriginX, field->InvCellSize, field->CellsX);
+    size_t   cy0   = field_cell(source.Y - source.Radius, field->OriginY, field->InvCellSize, field->CellsY);
+    size_t   cx1   = field_cell(source.X + source.Radius, field->OriginX, field->InvCellSize, field->CellsX);
+    size_t   cy1   = field_cell(source.Y + source.Radius, field->OriginY, field->InvCellSize, field->CellsY);
+    for (size_t y = cy0; y <= cy1; ++y)
+    {
+        uint64_t *row = field->CellMask + y * field->CellsX;
+        for (size_t x = cx0; x <= cx1; ++x)
+        {
+            row[x] |= bit;
+        }
+    }
+    field->Sources[index] = source;
+    return true;
+}
+
+void field_apply(force_field_t const *field, float *vel_x, float *vel_y, float const *pos_x, float const *pos_y, size_t count, float scale, task_pool_t *pool)
+{
+    if (field->SourceCount == 0 || count == 0)
+        return;
+
+    field_apply_args_t args;
+    args.Field  = field;
+    args.VelX   = vel_x;
+    args.VelY   = vel_y;
+    args.PosX   = pos_x;
+    args.PosY   = pos_y;
+    args.Count  = count;
+    args.Scale  = scale;
+
+    size_t blocks = (count + FIELD_BLOCK_SIZE - 1) / FIELD_BLOCK_SIZE;
+    task_pool_parallel_for(pool, blocks, FIELD_MIN_BLOCKS, field_apply_range, &args);
+}
@@ -0,0 +1,512 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the warping background grid. Each tick runs two SIMD
+/// passes over the interior rows: one gathering spring forces from the four
+/// neighbors of every point, and one integrating velocity and position.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "ll_task.hpp"
+#include "grid.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of per-point arrays allocated for the grid.
+#define GRID_ARRAY_COUNT             13U
+
+/// @summary The RGBA color of the grid lines.
+static const float GRID_COLOR[4] = { 30.0f / 255.0f, 30.0f / 255.0f, 139.0f / 255.0f, 85.0f / 255.0f };
+
+/// @summary The global GridManager instance.
+GridManager* GridManager::GM = NULL;
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel gathering the spring and anchor forces acting on each point.
+struct grid_force_k
+{
+    float const *PosX, *PosY, *VelX, *VelY, *RestX, *RestY;
+    float       *AccX, *AccY;
+    size_t       Stride;
+    float        RestH, RestV, Stiffness, Damping, Anchor;
+
+    /// @summary Accumulates the force exerted on a point by the spring
+    /// connecting it to one neighbor. Springs only pull when stretched.
+    template <typename L>
+    static BACKEND_FORCE_INLINE void spring(
+        typename L::value_t  px, typename L::value_t  py,
+        typename L::value_t  vx, typename L::value_t  vy,
+        float const         *nx, float const         *ny,
+        float const         *nvx, float const        *nvy,
+        float rest, float stiffness, float damping,
+        typename L::value_t &fx, typename L::value_t &fy)
+    {
+        typename L::value_t dx  = L::sub(L::load(nx), px);
+        typename L::value_t dy  = L::sub(L::load(ny), py);
+        typename L::value_t len = L::sqrt(L::add(L::mul(dx, dx), L::mul(dy, dy)));
+        typename L::value_t r   = L::splat(rest);
+        typename L::value_t m   = L::div(L::mul(L::splat(stiffness), L::sub(len, r)), len);
+        typename L::value_t c   = L::splat(damping);
+        m  = L::select_lt(r, len, m);
+        fx = L::add(fx, L::add(L::mul(dx, m), L::mul(c, L::sub(L::load(nvx), vx))));
+        fy = L::add(fy, L::add(L::mul(dy, m), L::mul(c, L::sub(L::load(nvy), vy))));
+    }
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t px = L::load(PosX + i);
+        typename L::value_t py = L::load(PosY + i);
+        typename L::value_t vx = L::load(VelX + i);
+        typename L::value_t vy = L::load(VelY + i);
+        typename L::value_t ka = L::splat(Anchor);
+        typename L::value_t fx = L::mul(ka, L::sub(L::load(RestX + i), px));
+        typename L::value_t fy = L::mul(ka, L::sub(L::load(RestY + i), py));
+        size_t const        l  = i - 1;
+        size_t const        r  = i + 1;
+        size_t const        u  = i - Stride;
+        size_t const        d  = i + Stride;
+        spring<L>(px, py, vx, vy, PosX + l, PosY + l, VelX + l, VelY + l, RestH, Stiffness, Damping, fx, fy);
+        spring<L>(px, py, vx, vy, PosX + r, PosY + r, VelX + r, VelY + r, RestH, Stiffness, Damping, fx, fy);
+        spring<L>(px, py, vx, vy, PosX + u, PosY + u, VelX + u, VelY + u, RestV, Stiffness, Damping, fx, fy);
+        spring<L>(px, py, vx, vy, PosX + d, PosY + d, VelX + d, VelY + d, RestV, Stiffness, Damping, fx, fy);
+        L::store(AccX + i, fx);
+        L::store(AccY + i, fy);
+    }
+};
+
+/// @summary Kernel integrating the velocity and position of each point.
+struct grid_integrate_k
+{
+    float       *PosX, *PosY, *VelX, *VelY;
+    float const *AccX, *AccY;
+    float        Step, Damping;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t t  = L::splat(Step);
+        typename L::value_t k  = L::splat(Damping);
+        typename L::value_t vx = L::mul(L::add(L::load(VelX + i), L::mul(L::load(AccX + i), t)), k);
+        typename L::value_t vy = L::mul(L::add(L::load(VelY + i), L::mul(L::load(AccY + i), t)), k);
+        L::store(VelX + i, vx);
+        L::store(VelY + i, vy);
+        L::store(PosX + i, L::add(L::load(PosX + i), L::mul(vx, t)));
+        L::store(PosY + i, L::add(L::load(PosY + i), L::mul(vy, t)));
+    }
+};
+
+/// @summary Kernel applying a radial impulse, v += (p - c) * s / (a + |p - c|^2),
+/// to every point within a radius. Negative strengths pull toward the center.
+struct grid_radial_k
+{
+    float const *PosX, *PosY;
+    float       *VelX, *VelY;
+    float        CX, CY, Strength, Softening, RadiusSq;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::sub(L::load(PosX + i), L::splat(CX));
+        typename L::value_t dy = L::sub(L::load(PosY + i), L::splat(CY));
+        typename L::value_t ds = L::add(L::mul(dx, dx), L::mul(dy, dy));
+        typename L::value_t m  = L::div(L::splat(Strength), L::add(L::splat(Softening), ds));
+        m = L::select_lt(ds, L::splat(RadiusSq), m);
+        L::store(VelX + i, L::add(L::load(VelX + i), L::mul(dx, m)));
+        L::store(VelY + i, L::add(L::load(VelY + i), L::mul(dy, m)));
+    }
+};
+
+/// @summary Kernel applying a directed impulse, v += f * 10 / (10 + |p - c|),
+/// to every point within a radius.
+struct grid_directed_k
+{
+    float const *PosX, *PosY;
+    float       *VelX, *VelY;
+    float        CX, CY, FX, FY, RadiusSq;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::sub(L::load(PosX + i), L::splat(CX));
+        typename L::value_t dy = L::sub(L::load(PosY + i), L::splat(CY));
+        typename L::value_t ds = L::add(L::mul(dx, dx), L::mul(dy, dy));
+        typename L::value_t m  = L::div(L::splat(10.0f), L::add(L::splat(10.0f), L::sqrt(ds)));
+        m = L::select_lt(ds, L::splat(RadiusSq), m);
+        L::store(VelX + i, L::add(L::load(VelX + i), L::mul(L::splat(FX), m)));
+        L::store(VelY + i, L::add(L::load(VelY + i), L::mul(L::splat(FY), m)));
+    }
+};
+
+/// @summary Kernel computing the direction and length of the segment from
+/// each point to the point a fixed number of elements later in the arrays.
+/// The direction is the (cos, sin) orientation of the segment sprite, and is
+/// (1, 0) for a segment of zero length.
+struct grid_segment_k
+{
+    float const *PosX, *PosY;
+    float       *DX, *DY, *Length;
+    size_t       Offset;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx  = L::sub(L::load(PosX + i + Offset), L::load(PosX + i));
+        typename L::value_t dy  = L::sub(L::load(PosY + i + Offset), L::load(PosY + i));
+        typename L::value_t len = L::sqrt(L::add(L::mul(dx, dx), L::mul(dy, dy)));
+        typename L::value_t one = L::splat(1.0f);
+        typename L::value_t inv = L::select_lt(L::splat(0.0f), len, L::div(one, len));
+        typename L::value_t nz  = L::select_lt(L::splat(0.0f), len, one);
+        L::store(DX + i, L::add(L::mul(dx, inv), L::sub(one, nz)));
+        L::store(DY + i, L::mul(dy, inv));
+        L::store(Length + i, len);
+    }
+};
+
+/// @summary Data passed to the band-partitioned update tasks.
+struct grid_update_job_t
+{
+    grid_force_k     Force;    /// The force kernel parameters.
+    grid_integrate_k Integrate;/// The integration kernel parameters, for a single tick.
+    uint32_t const  *Bands;    /// The bands updated this tick.
+    uint32_t const  *Ticks;    /// The number of ticks each band advances by.
+    size_t           Columns;  /// The number of points per row.
+    size_t           Rows;     /// The number of interior rows.
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Computes the rows spanned by a band.
+/// @param job The grid_update_job_t describing the update.
+/// @param band The index of the band.
+/// @param row_begin On return, the index of the first row of the band.
+/// @param row_end On return, the index one past the last row of the band.
+static inline void grid_band_rows(grid_update_job_t const *job, size_t band, size_t &row_begin, size_t &row_end)
+{
+    row_begin = 1 + band * GRID_BAND_ROWS;
+    row_end   = row_begin + GRID_BAND_ROWS;
+    if (row_end > job->Rows + 1) row_end = job->Rows + 1;
+}
+
+/// @summary Runs the force kernel over a range of the bands due this tick.
+/// @param begin The index of the first entry of the due band list.
+/// @param end The index one past the last entry of the due band list.
+/// @param context The grid_update_job_t describing the update.
+static void grid_force_bands(size_t begin, size_t end, void *context)
+{
+    grid_update_job_t const *job  = (grid_update_job_t const*) context;
+    size_t const             cols = job->Columns;
+    for (size_t i = begin; i < end; ++i)
+    {
+        size_t row_begin, row_end;
+        grid_band_rows(job, job->Bands[i], row_begin, row_end);
+        for (size_t row = row_begin; row < row_end; ++row)
+        {
+            size_t base = row * cols;
+            soa_for_range(job->Force, job->Force.AccX, base + 1, base + cols - 1);
+        }
+    }
+}
+
+/// @summary Runs the integration kernel over a range of the bands due this
+/// tick, stepping each band over every tick since it last updated.
+/// @param begin The index of the first entry of the due band list.
+/// @param end The index one past the last entry of the due band list.
+/// @param context The grid_update_job_t describing the update.
+static void grid_integrate_bands(size_t begin, size_t end, void *context)
+{
+    grid_update_job_t const *job  = (grid_update_job_t const*) context;
+    size_t const             cols = job->Columns;
+    for (size_t i = begin; i < end; ++i)
+    {
+        grid_integrate_k k = job->Integrate;
+        if (job->Ticks[i] > 1)
+        {
+            k.Step    = job->Integrate.Step * float(job->Ticks[i]);
+            k.Damping = powf(GRID_VELOCITY_DAMPING, k.Step);
+        }
+        size_t row_begin, row_end;
+        grid_band_rows(job, job->Bands[i], row_begin, row_end);
+        for (size_t row = row_begin; row < row_end; ++row)
+        {
+            size_t base = row * cols;
+            soa_for_range(k, k.PosX, base + 1, base + cols - 1);
+        }
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+GridManager* GridManager::GetInstance(void)
+{
+    return GM;
+}
+
+GridManager::GridManager(size_t columns, size_t rows, task_pool_t *pool)
+    :
+    TaskPool(pool),
+    Image(NULL),
+    Memory(NULL),
+    Columns(columns < 3 ? 3 : columns),
+    Rows(rows < 3 ? 3 : rows),
+    SpacingX(0.0f),
+    SpacingY(0.0f),
+    BandCount(0),
+    Settle(GRID_LOD_SETTLE)
+{
+    // every array starts on a SOA_ALIGNMENT boundary; rows are not padded,
+    // so the kernels peel a few points at the start of each row.
+    size_t    count  = Columns * Rows;
+    size_t    stride = (count * sizeof(float) + (SOA_ALIGNMENT - 1)) & ~size_t(SOA_ALIGNMENT - 1);
+    Memory           = malloc(stride * GRID_ARRAY_COUNT + SOA_ALIGNMENT);
+    uintptr_t base   = (uintptr_t(Memory) + (SOA_ALIGNMENT - 1)) & ~uintptr_t(SOA_ALIGNMENT - 1);
+    PosX             = (float   *) (base + stride *  0);
+    PosY             = (float   *) (base + stride *  1);
+    VelX             = (float   *) (base + stride *  2);
+    VelY             = (float   *) (base + stride *  3);
+    AccX             = (float   *) (base + stride *  4);
+    AccY             = (float   *) (base + stride *  5);
+    RestX            = (float   *) (base + stride *  6);
+    RestY            = (float   *) (base + stride *  7);
+    SegDX            = (float   *) (base + stride *  8);
+    SegDY            = (float   *) (base + stride *  9);
+    SegLength        = (float   *) (base + stride * 10);
+    SegThick         = (float   *) (base + stride * 11);
+    SegColor         = (uint32_t*) (base + stride * 12);
+    memset(Memory, 0, stride * GRID_ARRAY_COUNT + SOA_ALIGNMENT);
+
+    // every band starts due, as though it last updated on tick zero.
+    BandCount        = (Rows - 2 + GRID_BAND_ROWS - 1) / GRID_BAND_ROWS;
+    BandLast         = (uint64_t*) calloc(BandCount, sizeof(uint64_t));
+    BandActive       = (uint64_t*) calloc(BandCount, sizeof(uint64_t));
+    DueBand          = (uint32_t*) calloc(BandCount, sizeof(uint32_t));
+    DueTicks         = (uint32_t*) calloc(BandCount, sizeof(uint32_t));
+    lod_scheduler_init(&Lod);
+    lod_scheduler_set_period(&Lod, 1, GRID_LOD_PERIOD);
+    GridManager::GM  = this;
+}
+
+GridManager::~GridManager(void)
+{
+    free(DueTicks);
+    free(DueBand);
+    free(BandActive);
+    free(BandLast);
+    free(Memory);
+    Memory  = NULL;
+    GridManager::GM = NULL;
+}
+
+void GridManager::Init(DisplayManager *dm)
+{
+    Image           = dm->GetLaserTexture();
+    SpacingX        = dm->GetWorldWidth()  / float(Columns - 1);
+    SpacingY        = dm->GetWorldHeight() / float(Rows    - 1);
+
+    float    thick  = GRID_LINE_THICKNESS / float(Image->GetHeight());
+    uint32_t color  = color32(GRID_COLOR);
+    for (size_t row = 0, i = 0; row < Rows; ++row)
+    {
+        for (size_t col = 0; col < Columns; ++col, ++i)
+        {
+            RestX[i]    = PosX[i] = float(col) * SpacingX;
+            RestY[i]    = PosY[i] = float(row) * SpacingY;
+            VelX[i]     = VelY[i] = 0.0f;
+            AccX[i]     = AccY[i] = 0.0f;
+            SegThick[i] = thick;
+            SegColor[i] = color;
+        }
+    }
+}
+
+void GridManager::SetLodPolicy(uint32_t period, uint32_t settle)
+{
+    lod_scheduler_set_period(&Lod, 1, period);
+    Settle = settle;
+}
+
+void GridManager::Activate(size_t row_begin, size_t row_end)
+{
+    // waves spread beyond the area of the impulse, so the neighboring bands
+    // are woken as well.
+    size_t first = (row_begin - 1) / GRID_BAND_ROWS;
+    size_t last  = (row_end   - 2) / GRID_BAND_ROWS + 1;
+    first = first > 0 ? first - 1 : 0;
+    last  = last < BandCount ? last + 1 : BandCount;
+    for (size_t b = first; b < last; ++b)
+    {
+        BandActive[b] = Lod.Tick + Settle;
+    }
+}
+
+template <typename K>
+void GridManager::ApplyImpulse(K const &k, float x, float y, float radius)
+{
+    if (SpacingX <= 0.0f || SpacingY <= 0.0f)
+        return;
+
+    // only visit the interior points inside the bounding box of the radius.
+    float  c0 = floorf((x - radius) / SpacingX);
+    float  c1 = ceilf ((x + radius) / SpacingX) + 1.0f;
+    float  r0 = floorf((y - radius) / SpacingY);
+    float  r1 = ceilf ((y + radius) / SpacingY) + 1.0f;
+    size_t col_begin = c0 < 1.0f ? 1 : size_t(c0);
+    size_t col_end   = c1 > float(Columns - 1) ? Columns - 1 : size_t(c1);
+    size_t row_begin = r0 < 1.0f ? 1 : size_t(r0);
+    size_t row_end   = r1 > float(Rows - 1) ? Rows - 1 : size_t(r1);
+    if (row_begin >= row_end || col_begin >= col_end)
+        return;
+
+    for (size_t row  = row_begin; row < row_end; ++row)
+    {
+        size_t base  = row * Columns;
+        soa_for_range(k, k.VelX, base + col_begin, base + col_end);
+    }
+    Activate(row_begin, row_end);
+}
+
+void GridManager::ApplyDirectedForce(float fx, float fy, float x, float y, float radius)
+{
+    grid_directed_k k = { PosX, PosY, VelX, VelY, x, y, fx, fy, radius * radius };
+    ApplyImpulse(k, x, y, radius);
+}
+
+void GridManager::ApplyExplosiveForce(float force, float x, float y, float radius)
+{
+    grid_radial_k k = { PosX, PosY, VelX, VelY, x, y, 100.0f * force, 10000.0f, radius * radius };
+    ApplyImpulse(k, x, y, radius);
+}
+
+void GridManager::ApplyImplosiveForce(float force, float x, float y, float radius)
+{
+    grid_radial_k k = { PosX, PosY, VelX, VelY, x, y, -10.0f * force, 100.0f, radius * radius };
+    ApplyImpulse(k, x, y, radius);
+}
+
+void GridManager::Update(double currentTime, double elapsedTime)
+{
+    UNUSED_ARG(currentTime);
+
+    float             step = float(elapsedTime) * 60.0f;
+    grid_update_job_t job;
+    job.Force.PosX          = PosX;
+    job.Force.PosY          = PosY;
+    job.Force.VelX          = VelX;
+    job.Force.VelY          = VelY;
+    job.Force.RestX         = RestX;
+    job.Force.RestY         = RestY;
+    job.Force.AccX          = AccX;
+    job.Force.AccY          = AccY;
+    job.Force.Stride        = Columns;
+    job.Force.RestH         = SpacingX;
+    job.Force.RestV         = SpacingY;
+    job.Force.Stiffness     = GRID_SPRING_STIFFNESS;
+    job.Force.Damping       = GRID_SPRING_DAMPING;
+    job.Force.Anchor        = GRID_ANCHOR_STIFFNESS;
+    job.Integrate.PosX      = PosX;
+    job.Integrate.PosY      = PosY;
+    job.Integrate.VelX      = VelX;
+    job.Integrate.VelY      = VelY;
+    job.Integrate.AccX      = AccX;
+    job.Integrate.AccY      = AccY;
+    job.Integrate.Step      = step;
+    job.Integrate.Damping   = powf(GRID_VELOCITY_DAMPING, step);
+    job.Bands               = DueBand;
+    job.Ticks               = DueTicks;
+    job.Columns             = Columns;
+    job.Rows                = Rows - 2;
+
+    // recently disturbed bands update every tick. quiet bands are split
+    // into contiguous slices that take turns; a band that updates on a
+    // different tick than its neighbor sees it half a step out of date, so
+    // interleaving the bands would put such a seam between every pair.
+    size_t due = 0;
+    Lod.Tick++;
+    for (size_t b = 0; b < BandCount; ++b)
+    {
+        uint32_t tier  = BandActive[b] >= Lod.Tick ? 0 : 1;
+        uint32_t slice = uint32_t(b * Lod.Period[1] / BandCount);
+        uint32_t ticks = lod_scheduler_due(&Lod, tier, slice, BandLast[b]);
+        size_t   rows  = b + 1 < BandCount ? GRID_BAND_ROWS : (Rows - 2) - b * GRID_BAND_ROWS;
+        lod_scheduler_record(&Lod, rows * (Columns - 2), ticks > 0);
+        if (ticks > 0)
+        {
+            DueBand [due]   = uint32_t(b);
+            DueTicks[due++] = ticks;
+            BandLast[b]     = Lod.Tick;
+        }
+    }
+
+    // all forces are gathered from the current positions before any point
+    // moves, so the two passes must not overlap.
+    size_t chunk = GRID_MIN_ROWS / GRID_BAND_ROWS;
+    task_pool_parallel_for(TaskPool, due, chunk, grid_force_bands, &job);
+    task_pool_parallel_for(TaskPool, due, chunk, grid_integrate_bands, &job);
+}
+
+bool GridManager::Save(snapshot_buffer_t *buffer) const
+{
+    // rest positions and segment styles never change after Init, and the
+    // spring forces are recomputed from scratch every tick.
+    size_t n  = Columns * Rows * sizeof(float);
+    bool   ok = snapshot_write(buffer, PosX, n);
+    ok = ok && snapshot_write(buffer, PosY, n);
+    ok = ok && snapshot_write(buffer, VelX, n);
+    ok = ok && snapshot_write(buffer, VelY, n);
+    ok = ok && snapshot_write_value(buffer, Lod.Tick);
+    ok = ok && snapshot_write(buffer, BandLast  , BandCount * sizeof(uint64_t));
+    ok = ok && snapshot_write(buffer, BandActive, BandCount * sizeof(uint64_t));
+    return ok;
+}
+
+bool GridManager::Restore(snapshot_buffer_t *buffer)
+{
+    size_t n  = Columns * Rows * sizeof(float);
+    bool   ok = snapshot_read(buffer, PosX, n);
+    ok = ok && snapshot_read(buffer, PosY, n);
+    ok = ok && snapshot_read(buffer, VelX, n);
+    ok = ok && snapshot_read(buffer, VelY, n);
+    ok = ok && snapshot_read_value(buffer, Lod.Tick);
+    ok = ok && snapshot_read(buffer, BandLast  , BandCount * sizeof(uint64_t));
+    ok = ok && snapshot_read(buffer, BandActive, BandCount * sizeof(uint64_t));
+    return ok;
+}
+
+void GridManager::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
+{
+    UNUSED_ARG(currentTime);
+    UNUSED_ARG(elapsedTime);
+    if (Image == NULL) return;
+
+    SpriteBatch  *batch  = dm->GetBatch();
+    float         height = float(Image->GetHeight());
+    rect_t        src    = { floorf(Image->GetWidth() * 0.5f), 0, 1, height };
+    size_t const  count  = Columns * Rows;
+    size_t const  cols   = Columns;
+
+    // horizontal segments. the segment from the last point of a row wraps
+    // to the next row and is skipped by submitting one row at a time.
+    grid_segment_k h = { PosX, PosY, SegDX, SegDY, SegLength, 1 };
+    soa_for_range(h, SegDX, 0, count - 1);
+    for (size_t row = 0; row < Rows; ++row)
+    {
+        size_t base = row * cols;
+        batch->AddArrayRotated(3, Image, src, cols - 1, PosX + base, PosY + base, SegDX + base, SegDY + base, SegLength + base, SegThick + base, SegColor + base, 0.0f, height * 0.5f);
+    }
+
+    // vertical segments.
+    grid_segment_k v = { PosX, PosY, SegDX, SegDY, SegLength, cols };
+    soa_for_range(v, SegDX, 0, count - cols);
+    batch->AddArrayRotated(3, Image, src, count - cols, PosX, PosY, SegDX, SegDY, SegLength, SegThick, SegColor, 0.0f, height * 0.5f);
+}
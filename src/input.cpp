@@ -21,9 +21,9 @@ InputManager* InputManager::IM = NULL;
 static uint32_t controller_bitmap(input_snapshot_t const *state)
 {
     uint32_t bitmap = 0;
-    for (size_t i = 0; i < state->ControllerCount; ++i)
+    for (size_t i = 0; i < state->Controllers.ControllerCount; ++i)
     {
-        bitmap |= (1 << state->ControllerIds[i]);
+        bitmap |= (1 << state->Controllers.ControllerIds[i]);
     }
     return bitmap;
 }
@@ -44,6 +44,10 @@ InputManager::InputManager(void)
     MouseDeltaX(0.0f),
     MouseDeltaY(0.0f)
 {
+    for (size_t i = 0; i < INPUT_MAX_PLAYERS; ++i)
+    {
+        PlayerStates[i] = NULL;
+    }
     InputManager::IM = this;
 }
 
@@ -54,7 +58,7 @@ InputManager::~InputManager(void)
 }
 
 
-bool InputManager::Init(GLFWwindow *win)
+bool InputManager::Init(GLFWwindow *win, uint32_t controller_poll_rate)
 {
     if (win != NULL)
     {
@@ -66,6 +70,7 @@ bool InputManager::Init(GLFWwindow *win)
         memset(&CurrentState,  0, sizeof(input_snapshot_t));
         memset(&PreviousState, 0, sizeof(input_snapshot_t));
         input_attach(win);
+        input_controller_poll_start(controller_poll_rate);
         return true;
     }
     else return false;
@@ -73,6 +78,7 @@ bool InputManager::Init(GLFWwindow *win)
 
 void InputManager::Shutdown(void)
 {
+    input_controller_poll_stop();
     input_detach(MainWindow);
 }
 
@@ -106,8 +112,8 @@ bool InputManager::IsMouseButtonDown(int button) const
 
 bool InputManager::IsControllerConnected(int id) const
 {
-    int const *ids = CurrentState.ControllerIds;
-    for (size_t  i = 0; i < CurrentState.ControllerCount; ++i)
+    int const *ids = CurrentState.Controllers.ControllerIds;
+    for (size_t  i = 0; i < CurrentState.Controllers.ControllerCount; ++i)
     {
         if (ids[i] == id)
             return true;
@@ -175,15 +181,15 @@ void InputManager::GetController(int id, controller_state_t *prev, controller_st
     curr->ButtonCount  = 0;
     curr->AxisValues   = NULL;
     curr->ButtonValues = NULL;
-    for (size_t i = 0; i < CurrentState.ControllerCount; ++i)
+    for (size_t i = 0; i < CurrentState.Controllers.ControllerCount; ++i)
     {
-        if (CurrentState.ControllerIds[i] == id)
+        if (CurrentState.Controllers.ControllerIds[i] == id)
         {
             curr->IsAttached   = true;
-            curr->AxisCount    = CurrentState.ControllerAxisCount[i];
-            curr->ButtonCount  = CurrentState.ControllerButtonCount[i];
-            curr->AxisValues   = CurrentState.ControllerAxes[i];
-            curr->ButtonValues = CurrentState.ControllerButtons[i];
+            curr->AxisCount    = CurrentState.Controllers.ControllerAxisCount[i];
+            curr->ButtonCount  = CurrentState.Controllers.ControllerButtonCount[i];
+            curr->AxisValues   = CurrentState.Controllers.ControllerAxes[i];
+            curr->ButtonValues = CurrentState.Controllers.ControllerButtons[i];
         }
     }
 
@@ -193,15 +199,15 @@ void InputManager::GetController(int id, controller_state_t *prev, controller_st
     prev->ButtonCount  = 0;
     prev->AxisValues   = NULL;
     prev->ButtonValues = NULL;
-    for (size_t i = 0; i < PreviousState.ControllerCount; ++i)
+    for (size_t i = 0; i < PreviousState.Controllers.ControllerCount; ++i)
     {
-        if (PreviousState.ControllerIds[i] == id)
+        if (PreviousState.Controllers.ControllerIds[i] == id)
         {
             prev->IsAttached   = true;
-            prev->AxisCount    = PreviousState.ControllerAxisCount[i];
-            prev->ButtonCount  = PreviousState.ControllerButtonCount[i];
-            prev->AxisValues   = PreviousState.ControllerAxes[i];
-            prev->ButtonValues = PreviousState.ControllerButtons[i];
+            prev->AxisCount    = PreviousState.Controllers.ControllerAxisCount[i];
+            prev->ButtonCount  = PreviousState.Controllers.ControllerButtonCount[i];
+            prev->AxisValues   = PreviousState.Controllers.ControllerAxes[i];
+            prev->ButtonValues = PreviousState.Controllers.ControllerButtons[i];
         }
     }
 }
@@ -218,6 +224,13 @@ void InputManager::Update(double currentTime, double elapsedTime)
     MouseDeltaY = CurrentState.MouseY - PreviousState.MouseY;
 
     // determine whether any controllers have been connected or disconnected.
+    // input_controller_poll() sees every hotplug event, including those that
+    // were undone before this tick, so prefer its event stream when active.
+    if (input_controller_poll_active())
+    {
+        input_controller_events(&ConnectEvents, &DisconnectEvents);
+        return;
+    }
     uint32_t curr       = controller_bitmap(&CurrentState);
     uint32_t prev       = controller_bitmap(&PreviousState);
     uint32_t changes    = (curr    ^  prev);
@@ -0,0 +1,92 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the frame budget scheduler. The degradation level
+/// rises on the first frame over budget and falls only after a long run of
+/// frames with plenty of headroom, so the quality does not oscillate.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "ll_budget.hpp"
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void frame_budget_init(frame_budget_t *budget, double step, double frame_budget, uint32_t max_steps, uint32_t max_level)
+{
+    budget->Step        = step;
+    budget->Budget      = frame_budget;
+    budget->StepCost    = 0.0;
+    budget->MaxSteps    = max_steps > 0 ? max_steps : 1;
+    budget->MaxLevel    = max_level;
+    budget->Level       = 0;
+    budget->CalmFrames  = 0;
+    budget->Carried     = 0;
+    budget->Frames      = 0;
+    budget->OverBudget  = 0;
+    budget->UnderBudget = 0;
+    budget->Dropped     = 0;
+}
+
+uint32_t frame_budget_begin(frame_budget_t *budget, double &accumulator)
+{
+    double   owed  = accumulator / budget->Step;
+    uint32_t want  = owed < double(UINT32_MAX) ? uint32_t(owed) : UINT32_MAX;
+    uint32_t limit = budget->MaxSteps;
+
+    // once there is no optional work left to shed, run only as many steps
+    // as are expected to fit, but always make some progress.
+    if (budget->Level >= budget->MaxLevel && budget->StepCost > 0.0)
+    {
+        double   fit = budget->Budget / budget->StepCost;
+        uint32_t n   = fit < 1.0 ? 1 : (fit < double(limit) ? uint32_t(fit) : limit);
+        limit = n;
+    }
+    budget->Frames++;
+    budget->Carried = 0;
+    if (want <= limit)
+        return want;
+
+    // below the highest level the remaining steps are owed to later frames,
+    // and the level rises until either they fit or there is nothing left to
+    // shed; only then is the time discarded.
+    if (budget->Level < budget->MaxLevel)
+    {
+        budget->Carried = want - limit;
+        return limit;
+    }
+    budget->Dropped += want - limit;
+    accumulator     -= double(want - limit) * budget->Step;
+    return limit;
+}
+
+void frame_budget_step(frame_budget_t *budget, double seconds)
+{
+    if (budget->StepCost <= 0.0)
+        budget->StepCost = seconds;
+    else
+        budget->StepCost += (seconds - budget->StepCost) * BUDGET_COST_WEIGHT;
+}
+
+uint32_t frame_budget_end(frame_budget_t *budget, double seconds)
+{
+    if (seconds > budget->Budget || budget->Carried > 0)
+    {
+        budget->OverBudget++;
+        budget->CalmFrames = 0;
+        if (budget->Level < budget->MaxLevel)
+            budget->Level++;
+    }
+    else if (seconds < budget->Budget * BUDGET_RELAX_FRACTION)
+    {
+        budget->UnderBudget++;
+        if (++budget->CalmFrames >= BUDGET_RECOVER_FRAMES && budget->Level > 0)
+        {
+            budget->Level--;
+            budget->CalmFrames = 0;
+        }
+    }
+    else budget->CalmFrames = 0;
+    return budget->Level;
+}
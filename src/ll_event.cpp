@@ -0,0 +1,54 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements event streams. Appending is lock-free; the buffer is
+/// only resized by the consumer between ticks, when no producer is running.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdlib.h>
+#include "ll_event.hpp"
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool event_stream_create(event_stream_t *stream, size_t element_size, size_t capacity)
+{
+    stream->ElementSize = element_size;
+    stream->Capacity    = 0;
+    stream->Dropped     = 0;
+    stream->Data        = (uint8_t*) malloc(capacity * element_size);
+    stream->Count.store(0, std::memory_order_relaxed);
+    if (stream->Data == NULL)
+        return false;
+
+    stream->Capacity = capacity;
+    return true;
+}
+
+void event_stream_delete(event_stream_t *stream)
+{
+    free(stream->Data);
+    stream->Data     = NULL;
+    stream->Capacity = 0;
+    stream->Count.store(0, std::memory_order_relaxed);
+}
+
+void event_stream_reset(event_stream_t *stream)
+{
+    size_t count = stream->Count.exchange(0, std::memory_order_relaxed);
+    if (count <= stream->Capacity)
+        return;
+
+    // grow by at least half again so repeated small overflows settle quickly.
+    size_t   capacity = stream->Capacity + stream->Capacity / 2;
+    if (capacity < count) capacity = count;
+    uint8_t *data     = (uint8_t*) realloc(stream->Data, capacity * stream->ElementSize);
+    stream->Dropped  += count - stream->Capacity;
+    if (data != NULL)
+    {
+        stream->Data     = data;
+        stream->Capacity = capacity;
+    }
+}
@@ -8,6 +8,8 @@
 /*////////////////
 //   Includes   //
 ////////////////*/
+#include <string.h>
+#include <chrono>
 #include "ll_input.hpp"
 
 /*/////////////////
@@ -29,6 +31,24 @@ static GLFWwindow*     gWindowList[MAX_INPUT_CONTEXTS];
 /// @summary The number of valid input context records.
 static size_t          gContextCount = 0;
 
+/// @summary The controller state most recently polled by
+/// input_controller_poll(). Written and read on the main thread only.
+static input_controllers_t        gControllerData;
+
+/// @summary Bitmaps of controller connect and disconnect events accumulated by
+/// input_controller_poll() and not yet retrieved by input_controller_events().
+static uint32_t                   gConnectEvents    = 0;
+static uint32_t                   gDisconnectEvents = 0;
+
+/// @summary true while rate-limited controller polling is active.
+static bool                       gPollActive   = false;
+
+/// @summary The bitmap of controllers in the most recently polled state,
+/// the time at which the next poll is due, and the polling rate.
+static uint32_t                   gPollPrevious = 0;
+static uint32_t                   gPollRate     = INPUT_CONTROLLER_POLL_RATE;
+static std::chrono::steady_clock::time_point gPollNext;
+
 /*///////////////////////
 //   Local Functions   //
 ///////////////////////*/
@@ -171,6 +191,64 @@ static void glfw_key(GLFWwindow *win, int key, int scancode, int action, int mod
     }
 }
 
+/// @summary Queries GLFW for the current state of all attached controllers.
+/// GLFW's joystick functions are not thread-safe, and on some platforms the
+/// joystick tables are rebuilt by glfwPollEvents(), so this must only be
+/// called on the main thread.
+/// @param dst The controller state to populate.
+static void poll_controllers(input_controllers_t *dst)
+{
+    size_t  ncontrollers = 0;
+    for (int i = GLFW_JOYSTICK_1; i <= GLFW_JOYSTICK_LAST; ++i)
+    {
+        if (glfwJoystickPresent(i) == GL_TRUE)
+        {
+            int naxes    = 0;
+            int nbuttons = 0;
+            float const *axes = glfwGetJoystickAxes(i, &naxes);
+            unsigned char const *buttons = glfwGetJoystickButtons(i, &nbuttons);
+
+            if (naxes > INPUT_MAX_CONTROLLER_AXES)
+                naxes = INPUT_MAX_CONTROLLER_AXES;
+
+            if (nbuttons > INPUT_MAX_CONTROLLER_BUTTONS)
+                nbuttons = INPUT_MAX_CONTROLLER_BUTTONS;
+
+            dst->ControllerIds[ncontrollers] = i;
+            dst->ControllerAxisCount[ncontrollers] = size_t(naxes);
+            dst->ControllerButtonCount[ncontrollers] = size_t(nbuttons);
+
+            for (int j = 0; j < naxes; ++j)
+            {
+                dst->ControllerAxes[ncontrollers][j] = axes[j];
+            }
+            for (int j = 0; j < nbuttons; ++j)
+            {
+                dst->ControllerButtons[ncontrollers][j] = buttons[j];
+            }
+            ncontrollers++;
+
+            if (ncontrollers == INPUT_MAX_CONTROLLERS)
+                break;
+        }
+    }
+    dst->ControllerCount = ncontrollers;
+}
+
+/// @summary Builds a bitmap of attached controllers, where bit i is set if
+/// the controller with GLFW joystick identifier i is present.
+/// @param src The controller state to inspect.
+/// @return The bitmap of attached controllers.
+static uint32_t controller_bitmap(input_controllers_t const *src)
+{
+    uint32_t bitmap = 0;
+    for (size_t i = 0; i < src->ControllerCount; ++i)
+    {
+        bitmap |= (1U << src->ControllerIds[i]);
+    }
+    return bitmap;
+}
+
 /*///////////////////////
 //  Public Functions   //
 ///////////////////////*/
@@ -221,42 +299,84 @@ void input_snapshot(input_snapshot_t *dst, GLFWwindow *win)
         for (size_t i = 0; i < INPUT_KEY_WORDS; ++i)
             dst->KeyboardState[i] = ctx->KeyboardState[i];
 
-        // poll for the current joystick state.
-        size_t  ncontrollers = 0;
-        dst->ControllerCount = 0;
-        for (int i = GLFW_JOYSTICK_1; i <= GLFW_JOYSTICK_LAST; ++i)
+        // copy the joystick state stored by input_controller_poll(),
+        // or poll synchronously if polling hasn't been started.
+        if (gPollActive)
         {
-            if (glfwJoystickPresent(i) == GL_TRUE)
-            {
-                int naxes    = 0;
-                int nbuttons = 0;
-                float const *axes = glfwGetJoystickAxes(i, &naxes);
-                unsigned char const *buttons = glfwGetJoystickButtons(i, &nbuttons);
-
-                if (naxes > INPUT_MAX_CONTROLLER_AXES)
-                    naxes = INPUT_MAX_CONTROLLER_AXES;
-
-                if (nbuttons > INPUT_MAX_CONTROLLER_BUTTONS)
-                    nbuttons = INPUT_MAX_CONTROLLER_BUTTONS;
-
-                dst->ControllerIds[ncontrollers] = i;
-                dst->ControllerAxisCount[ncontrollers] = size_t(naxes);
-                dst->ControllerButtonCount[ncontrollers] = size_t(nbuttons);
-
-                for (int j = 0; j < naxes; ++j)
-                {
-                    dst->ControllerAxes[ncontrollers][j] = axes[j];
-                }
-                for (int j = 0; j < nbuttons; ++j)
-                {
-                    dst->ControllerButtons[ncontrollers][j] = buttons[j];
-                }
-                ncontrollers++;
-
-                if (ncontrollers == INPUT_MAX_CONTROLLERS)
-                    break;
-            }
+            memcpy(&dst->Controllers, &gControllerData, sizeof(input_controllers_t));
         }
-        dst->ControllerCount = ncontrollers;
+        else poll_controllers(&dst->Controllers);
     }
 }
+
+bool input_controller_poll_start(uint32_t rate_hz)
+{
+    if (gPollActive)
+    {
+        // controller polling is already active.
+        return true;
+    }
+    if (rate_hz == 0)
+    {
+        // polling is performed synchronously by input_snapshot().
+        return false;
+    }
+
+    // take an initial poll so that input_snapshot() never sees an empty
+    // state for controllers that were attached before polling started.
+    memset(&gControllerData, 0, sizeof(input_controllers_t));
+    poll_controllers(&gControllerData);
+
+    uint32_t attached = controller_bitmap(&gControllerData);
+    gPollRate         = rate_hz;
+    gPollPrevious     = attached;
+    gPollNext         = std::chrono::steady_clock::now() + std::chrono::nanoseconds(1000000000ULL / rate_hz);
+    gConnectEvents    = attached;
+    gDisconnectEvents = 0;
+    gPollActive       = true;
+    return true;
+}
+
+void input_controller_poll_stop(void)
+{
+    gPollActive = false;
+}
+
+bool input_controller_poll_active(void)
+{
+    return gPollActive;
+}
+
+void input_controller_poll(void)
+{
+    if (gPollActive == false)
+    {
+        // input_snapshot() polls synchronously.
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < gPollNext)
+    {
+        // the polling interval hasn't elapsed yet.
+        return;
+    }
+    // don't try to catch up with a burst of polls; just resume the cadence.
+    gPollNext += std::chrono::nanoseconds(1000000000ULL / gPollRate);
+    if (gPollNext < now) gPollNext = now;
+
+    poll_controllers(&gControllerData);
+    uint32_t curr       = controller_bitmap(&gControllerData);
+    uint32_t changes    = (curr    ^  gPollPrevious);
+    gConnectEvents     |= (changes &  curr);
+    gDisconnectEvents  |= (changes & ~curr);
+    gPollPrevious       = curr;
+}
+
+void input_controller_events(uint32_t *connect, uint32_t *disconnect)
+{
+    *connect          = gConnectEvents;
+    *disconnect       = gDisconnectEvents;
+    gConnectEvents    = 0;
+    gDisconnectEvents = 0;
+}
@@ -0,0 +1,44 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the simulation level-of-detail scheduler.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "ll_lod.hpp"
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void lod_scheduler_init(lod_scheduler_t *sched)
+{
+    sched->Tick = 0;
+    for (uint32_t i = 0; i < LOD_MAX_TIERS; ++i)
+    {
+        sched->Period[i] = 1;
+    }
+    lod_scheduler_reset_stats(sched);
+}
+
+void lod_scheduler_set_period(lod_scheduler_t *sched, uint32_t tier, uint32_t period)
+{
+    if (tier > 0 && tier < LOD_MAX_TIERS)
+    {
+        sched->Period[tier] = period > 0 ? period : 1;
+    }
+}
+
+float lod_scheduler_skipped(lod_scheduler_t const *sched)
+{
+    if (sched->Considered == 0)
+        return 0.0f;
+
+    return float(double(sched->Considered - sched->Updated) / double(sched->Considered));
+}
+
+void lod_scheduler_reset_stats(lod_scheduler_t *sched)
+{
+    sched->Considered = 0;
+    sched->Updated    = 0;
+}
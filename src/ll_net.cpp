@@ -0,0 +1,129 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements non-blocking UDP sockets on top of BSD sockets.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "ll_net.hpp"
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Converts an endpoint to a BSD socket address.
+/// @param addr The endpoint.
+/// @param sa On return, the equivalent socket address.
+static void to_sockaddr(net_address_t const &addr, struct sockaddr_in *sa)
+{
+    memset(sa, 0, sizeof(struct sockaddr_in));
+    sa->sin_family      = AF_INET;
+    sa->sin_addr.s_addr = htonl(addr.Host);
+    sa->sin_port        = htons(addr.Port);
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool net_parse_address(char const *str, net_address_t *addr)
+{
+    char const *colon = strrchr(str, ':');
+    if (colon == NULL || colon[1] == '\0')
+        return false;
+
+    char *end  = NULL;
+    long  port = strtol(colon + 1, &end, 10);
+    if (*end != '\0' || port <= 0 || port > 65535)
+        return false;
+
+    char   host[64];
+    size_t len = size_t(colon - str);
+    if (len >= sizeof(host))
+        return false;
+
+    memcpy(host, str, len);
+    host[len] = '\0';
+    struct in_addr in;
+    if (len == 0)
+    {
+        in.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    else if (inet_pton(AF_INET, host, &in) != 1)
+    {
+        return false;
+    }
+    addr->Host = ntohl(in.s_addr);
+    addr->Port = uint16_t(port);
+    return true;
+}
+
+bool udp_open(udp_socket_t *sock, uint16_t port)
+{
+    sock->Handle    = -1;
+    sock->BytesSent = 0;
+    sock->BytesRecv = 0;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0)
+        return false;
+
+    struct sockaddr_in sa;
+    net_address_t      any = { INADDR_ANY, port };
+    to_sockaddr(any, &sa);
+    if (bind(fd, (struct sockaddr*) &sa, sizeof(sa)) != 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    sock->Handle = fd;
+    return true;
+}
+
+void udp_close(udp_socket_t *sock)
+{
+    if (sock->Handle >= 0)
+    {
+        close(sock->Handle);
+        sock->Handle = -1;
+    }
+}
+
+bool udp_send(udp_socket_t *sock, net_address_t const &to, void const *data, size_t size)
+{
+    if (sock->Handle < 0 || size > NET_MAX_DATAGRAM)
+        return false;
+
+    struct sockaddr_in sa;
+    to_sockaddr(to, &sa);
+    if (sendto(sock->Handle, data, size, 0, (struct sockaddr*) &sa, sizeof(sa)) != ssize_t(size))
+        return false;
+
+    sock->BytesSent += size;
+    return true;
+}
+
+size_t udp_recv(udp_socket_t *sock, net_address_t *from, void *data, size_t capacity)
+{
+    if (sock->Handle < 0)
+        return 0;
+
+    struct sockaddr_in sa;
+    socklen_t          len = sizeof(sa);
+    ssize_t            n   = recvfrom(sock->Handle, data, capacity, 0, (struct sockaddr*) &sa, &len);
+    if (n <= 0)
+        return 0;
+
+    from->Host = ntohl(sa.sin_addr.s_addr);
+    from->Port = ntohs(sa.sin_port);
+    sock->BytesRecv += size_t(n);
+    return size_t(n);
+}
@@ -0,0 +1,471 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a loose quadtree. Queries walk the tree depth-first
+/// with a small explicit stack, skipping subtrees that hold no items or whose
+/// loose bounds miss the query, and test the items of each visited node.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdlib.h>
+#include <string.h>
+#include "ll_quadtree.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The maximum depth of the traversal stack. Each step pops one node
+/// and pushes at most four, so the stack never exceeds 3 * depth + 4 entries.
+#define QUADTREE_STACK_SIZE          (4U * (QUADTREE_MAX_DEPTH + 1U))
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary A node waiting to be visited during a traversal.
+struct quadtree_visit_t
+{
+    uint32_t Level;        /// The level of the node.
+    uint32_t CellX;        /// The column of the node within its level.
+    uint32_t CellY;        /// The row of the node within its level.
+    float    Distance;     /// The squared distance from the query to the node bounds.
+};
+
+/// @summary Query shape selecting items that overlap a circle.
+struct quadtree_circle_q
+{
+    float X, Y, R;
+
+    /// @summary Checks whether the loose bounds of a node may hold a match.
+    bool node(float x0, float y0, float x1, float y1) const
+    {
+        float cx = X < x0 ? x0 : (X > x1 ? x1 : X);
+        float cy = Y < y0 ? y0 : (Y > y1 ? y1 : Y);
+        return (cx - X) * (cx - X) + (cy - Y) * (cy - Y) <= R * R;
+    }
+
+    /// @summary Checks whether an item matches.
+    bool item(float x, float y, float r) const
+    {
+        float dx = x - X;
+        float dy = y - Y;
+        float rr = r + R;
+        return dx * dx + dy * dy <= rr * rr;
+    }
+};
+
+/// @summary Query shape selecting items that overlap a rectangle.
+struct quadtree_rect_q
+{
+    float X0, Y0, X1, Y1;
+
+    /// @summary Checks whether the loose bounds of a node may hold a match.
+    bool node(float x0, float y0, float x1, float y1) const
+    {
+        return x0 <= X1 && x1 >= X0 && y0 <= Y1 && y1 >= Y0;
+    }
+
+    /// @summary Checks whether an item matches.
+    bool item(float x, float y, float r) const
+    {
+        float cx = x < X0 ? X0 : (x > X1 ? X1 : x);
+        float cy = y < Y0 ? Y0 : (y > Y1 ? Y1 : y);
+        return (cx - x) * (cx - x) + (cy - y) * (cy - y) <= r * r;
+    }
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Computes the index of the first node of a level.
+/// @param level The level.
+/// @return The number of nodes in all shallower levels, (4^level - 1) / 3.
+static inline uint32_t level_offset(uint32_t level)
+{
+    return uint32_t(((size_t(1) << (2 * level)) - 1) / 3);
+}
+
+/// @summary Computes the index of a node.
+/// @param level The level of the node.
+/// @param cx The column of the node within its level.
+/// @param cy The row of the node within its level.
+/// @return The index of the node.
+static inline uint32_t node_index(uint32_t level, uint32_t cx, uint32_t cy)
+{
+    return level_offset(level) + (cy << level) + cx;
+}
+
+/// @summary Computes the loose bounds of a node, which extend half a cell
+/// beyond each edge of the cell.
+/// @param tree The loose quadtree.
+/// @param v The node.
+/// @param x0 On return, the minimum x-coordinate of the bounds.
+/// @param y0 On return, the minimum y-coordinate of the bounds.
+/// @param x1 On return, the maximum x-coordinate of the bounds.
+/// @param y1 On return, the maximum y-coordinate of the bounds.
+static inline void node_bounds(quadtree_t const *tree, quadtree_visit_t const &v, float &x0, float &y0, float &x1, float &y1)
+{
+    float cell = tree->Size / float(1U << v.Level);
+    x0 = tree->OriginX + (float(v.CellX) - 0.5f) * cell;
+    y0 = tree->OriginY + (float(v.CellY) - 0.5f) * cell;
+    x1 = x0 + 2.0f * cell;
+    y1 = y0 + 2.0f * cell;
+}
+
+/// @summary Computes the squared distance from a point to a box.
+/// @return Zero if the point is inside the box.
+static inline float box_distance_sq(float x, float y, float x0, float y0, float x1, float y1)
+{
+    float dx = x < x0 ? x0 - x : (x > x1 ? x - x1 : 0.0f);
+    float dy = y < y0 ? y0 - y : (y > y1 ? y - y1 : 0.0f);
+    return dx * dx + dy * dy;
+}
+
+/// @summary Selects the node that stores a circle.
+/// @param tree The loose quadtree.
+/// @param x The x-coordinate of the center of the circle.
+/// @param y The y-coordinate of the center of the circle.
+/// @param r The radius of the circle.
+/// @param level On return, the level of the node.
+/// @return The index of the node.
+static uint32_t locate(quadtree_t const *tree, float x, float y, float r, uint32_t &level)
+{
+    float fx = (x - tree->OriginX) / tree->Size;
+    float fy = (y - tree->OriginY) / tree->Size;
+    level    = 0;
+    if (!(fx >= 0.0f && fx < 1.0f && fy >= 0.0f && fy < 1.0f))
+        return 0;
+
+    // descend while the circle fits in half a cell of the next level.
+    float half = tree->Size * 0.25f;
+    while (level < tree->Depth && r <= half)
+    {
+        level++;
+        half *= 0.5f;
+    }
+    uint32_t n  = 1U << level;
+    uint32_t cx = uint32_t(fx * float(n));
+    uint32_t cy = uint32_t(fy * float(n));
+    if (cx >= n) cx = n - 1;
+    if (cy >= n) cy = n - 1;
+    return node_index(level, cx, cy);
+}
+
+/// @summary Adds a value to the subtree count of a node and its ancestors.
+/// @param tree The loose quadtree.
+/// @param node The index of the node.
+/// @param level The level of the node.
+/// @param delta The value to add.
+static void adjust_totals(quadtree_t *tree, uint32_t node, uint32_t level, int32_t delta)
+{
+    uint32_t local = node - level_offset(level);
+    uint32_t cx    = local & ((1U << level) - 1);
+    uint32_t cy    = local >> level;
+    for ( ; ; )
+    {
+        tree->Total[node_index(level, cx, cy)] += uint32_t(delta);
+        if (level == 0) break;
+        level--;
+        cx >>= 1;
+        cy >>= 1;
+    }
+}
+
+/// @summary Adds an item to the front of the list of a node.
+/// @param tree The loose quadtree.
+/// @param item The item index.
+/// @param node The index of the node.
+static inline void link_item(quadtree_t *tree, uint32_t item, uint32_t node)
+{
+    uint32_t head    = tree->Head[node];
+    tree->Node[item] = node;
+    tree->Prev[item] = QUADTREE_NIL;
+    tree->Items[item].Next = head;
+    if (head != QUADTREE_NIL)
+        tree->Prev[head] = item;
+    tree->Head[node] = item;
+}
+
+/// @summary Removes an item from the list of its node.
+/// @param tree The loose quadtree.
+/// @param item The item index.
+static inline void unlink_item(quadtree_t *tree, uint32_t item)
+{
+    uint32_t next = tree->Items[item].Next;
+    uint32_t prev = tree->Prev[item];
+    if (prev != QUADTREE_NIL)
+        tree->Items[prev].Next = next;
+    else
+        tree->Head[tree->Node[item]] = next;
+    if (next != QUADTREE_NIL)
+        tree->Prev[next] = prev;
+    tree->Node[item] = QUADTREE_NIL;
+}
+
+/// @summary Visits every node whose loose bounds may hold a match for a query
+/// shape, and collects the matching items.
+/// @param tree The loose quadtree.
+/// @param q The query shape.
+/// @param items An array of max_items elements receiving the matching items.
+/// @param max_items The maximum number of items to return.
+/// @return The number of items written to items.
+template <typename Q>
+static size_t query(quadtree_t const *tree, Q const &q, uint32_t *items, size_t max_items)
+{
+    quadtree_visit_t stack[QUADTREE_STACK_SIZE];
+    size_t           top   = 0;
+    size_t           count = 0;
+    quadtree_visit_t root  = { 0, 0, 0, 0.0f };
+    stack[top++] = root;
+    while (top > 0 && count < max_items)
+    {
+        quadtree_visit_t v    = stack[--top];
+        uint32_t         node = node_index(v.Level, v.CellX, v.CellY);
+        if (tree->Total[node] == 0)
+            continue;
+
+        // the root also holds the items outside of the region, so it is
+        // searched regardless of its bounds.
+        if (v.Level > 0)
+        {
+            float x0, y0, x1, y1;
+            node_bounds(tree, v, x0, y0, x1, y1);
+            if (!q.node(x0, y0, x1, y1))
+                continue;
+        }
+        for (uint32_t i = tree->Head[node]; i != QUADTREE_NIL && count < max_items; )
+        {
+            quadtree_item_t const &it = tree->Items[i];
+            if (q.item(it.X, it.Y, it.R))
+                items[count++] = i;
+            i = it.Next;
+        }
+        if (v.Level < tree->Depth)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                quadtree_visit_t child = { v.Level + 1, (v.CellX << 1) | (c & 1), (v.CellY << 1) | (c >> 1), 0.0f };
+                stack[top++] = child;
+            }
+        }
+    }
+    return count;
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool quadtree_create(quadtree_t *tree, float x, float y, float size, size_t depth, size_t capacity)
+{
+    if (depth > QUADTREE_MAX_DEPTH)
+        depth = QUADTREE_MAX_DEPTH;
+
+    tree->OriginX   = x;
+    tree->OriginY   = y;
+    tree->Size      = size > 0.0f ? size : 1.0f;
+    tree->Depth     = depth;
+    tree->NodeCount = level_offset(uint32_t(depth + 1));
+    tree->Capacity  = capacity;
+    tree->Count     = 0;
+    tree->Head      = (uint32_t*) malloc(tree->NodeCount * sizeof(uint32_t));
+    tree->Total     = (uint32_t*) malloc(tree->NodeCount * sizeof(uint32_t));
+    tree->Node      = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+    tree->Prev      = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+    tree->Items     = (quadtree_item_t*) malloc(capacity * sizeof(quadtree_item_t));
+
+    if (tree->Head == NULL || tree->Total == NULL || tree->Node == NULL || tree->Prev == NULL || tree->Items == NULL)
+    {
+        quadtree_delete(tree);
+        return false;
+    }
+    quadtree_clear(tree);
+    return true;
+}
+
+void quadtree_delete(quadtree_t *tree)
+{
+    free(tree->Items);
+    free(tree->Prev);
+    free(tree->Node);
+    free(tree->Total);
+    free(tree->Head);
+    tree->Items     = NULL;
+    tree->Prev      = NULL;
+    tree->Node      = NULL;
+    tree->Total     = NULL;
+    tree->Head      = NULL;
+    tree->NodeCount = 0;
+    tree->Capacity  = 0;
+    tree->Count     = 0;
+}
+
+void quadtree_clear(quadtree_t *tree)
+{
+    memset(tree->Head , 0xFF, tree->NodeCount * sizeof(uint32_t));
+    memset(tree->Total, 0x00, tree->NodeCount * sizeof(uint32_t));
+    memset(tree->Node , 0xFF, tree->Capacity  * sizeof(uint32_t));
+    tree->Count = 0;
+}
+
+void quadtree_build(quadtree_t *tree, float const *x, float const *y, float const *r, size_t count)
+{
+    if (count > tree->Capacity)
+        count = tree->Capacity;
+
+    // link every item into its node and count it there, then accumulate
+    // the counts up the tree one level at a time.
+    quadtree_clear(tree);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t level;
+        uint32_t node = locate(tree, x[i], y[i], r[i], level);
+        tree->Items[i].X = x[i];
+        tree->Items[i].Y = y[i];
+        tree->Items[i].R = r[i];
+        link_item(tree, uint32_t(i), node);
+        tree->Total[node]++;
+    }
+    for (uint32_t level = uint32_t(tree->Depth); level > 0; --level)
+    {
+        uint32_t n = 1U << level;
+        for (uint32_t cy = 0; cy < n; ++cy)
+        {
+            for (uint32_t cx = 0; cx < n; ++cx)
+            {
+                uint32_t total = tree->Total[node_index(level, cx, cy)];
+                if (total > 0) tree->Total[node_index(level - 1, cx >> 1, cy >> 1)] += total;
+            }
+        }
+    }
+    tree->Count = count;
+}
+
+void quadtree_update(quadtree_t *tree, uint32_t item, float x, float y, float r)
+{
+    if (item >= tree->Capacity)
+        return;
+
+    uint32_t level;
+    uint32_t node = locate(tree, x, y, r, level);
+    uint32_t old  = tree->Node[item];
+    tree->Items[item].X = x;
+    tree->Items[item].Y = y;
+    tree->Items[item].R = r;
+    if (node == old)
+        return;
+
+    if (old != QUADTREE_NIL)
+    {
+        quadtree_remove(tree, item);
+    }
+    link_item(tree, item, node);
+    adjust_totals(tree, node, level, +1);
+    tree->Count++;
+}
+
+void quadtree_remove(quadtree_t *tree, uint32_t item)
+{
+    if (item >= tree->Capacity || tree->Node[item] == QUADTREE_NIL)
+        return;
+
+    uint32_t node  = tree->Node[item];
+    uint32_t level = 0;
+    while (node >= level_offset(level + 1))
+        level++;
+
+    unlink_item(tree, item);
+    adjust_totals(tree, node, level, -1);
+    tree->Count--;
+}
+
+size_t quadtree_query_circle(quadtree_t const *tree, float x, float y, float r, uint32_t *items, size_t max_items)
+{
+    quadtree_circle_q q = { x, y, r };
+    return query(tree, q, items, max_items);
+}
+
+size_t quadtree_query_rect(quadtree_t const *tree, float x0, float y0, float x1, float y1, uint32_t *items, size_t max_items)
+{
+    quadtree_rect_q q = { x0, y0, x1, y1 };
+    return query(tree, q, items, max_items);
+}
+
+size_t quadtree_nearest(quadtree_t const *tree, float x, float y, size_t k, float max_dist, uint32_t *items, float *dist_sq)
+{
+    quadtree_visit_t stack[QUADTREE_STACK_SIZE];
+    float           *dist  = dist_sq;
+    float            limit = max_dist * max_dist;
+    size_t           found = 0;
+    size_t           top   = 0;
+    quadtree_visit_t root  = { 0, 0, 0, 0.0f };
+    if (k == 0)
+        return 0;
+
+    // depth-first, nearest child first, so that the k-th distance shrinks
+    // quickly and prunes the remaining subtrees.
+    stack[top++] = root;
+    while (top > 0)
+    {
+        quadtree_visit_t v    = stack[--top];
+        uint32_t         node = node_index(v.Level, v.CellX, v.CellY);
+        if (v.Distance > limit)
+            continue;
+
+        for (uint32_t i = tree->Head[node]; i != QUADTREE_NIL; )
+        {
+            quadtree_item_t const &it = tree->Items[i];
+            float dx = it.X - x;
+            float dy = it.Y - y;
+            float d  = dx * dx + dy * dy;
+            uint32_t item = i;
+            i = it.Next;
+            if (d > limit || (found == k && d >= dist[k - 1]))
+                continue;
+
+            // insertion sort into the k best.
+            size_t j = found < k ? found++ : k - 1;
+            while (j > 0 && dist[j - 1] > d)
+            {
+                dist [j] = dist [j - 1];
+                items[j] = items[j - 1];
+                j--;
+            }
+            dist [j] = d;
+            items[j] = item;
+            if (found == k && dist[k - 1] < limit)
+                limit = dist[k - 1];
+        }
+        if (v.Level >= tree->Depth)
+            continue;
+
+        quadtree_visit_t child[4];
+        size_t           n = 0;
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            quadtree_visit_t ch = { v.Level + 1, (v.CellX << 1) | (c & 1), (v.CellY << 1) | (c >> 1), 0.0f };
+            if (tree->Total[node_index(ch.Level, ch.CellX, ch.CellY)] == 0)
+                continue;
+
+            float x0, y0, x1, y1;
+            node_bounds(tree, ch, x0, y0, x1, y1);
+            ch.Distance = box_distance_sq(x, y, x0, y0, x1, y1);
+            if (ch.Distance > limit)
+                continue;
+
+            // keep the children sorted farthest first, so the nearest is
+            // pushed last and visited next.
+            size_t j = n++;
+            while (j > 0 && child[j - 1].Distance < ch.Distance)
+            {
+                child[j] = child[j - 1];
+                j--;
+            }
+            child[j] = ch;
+        }
+        for (size_t c = 0; c < n; ++c)
+        {
+            stack[top++] = child[c];
+        }
+    }
+    return found;
+}
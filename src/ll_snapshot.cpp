@@ -0,0 +1,178 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a ring of simulation snapshots. Buffers are allocated
+/// when first written, grow by doubling and are never shrunk, so steady-state
+/// saves are a sequence of memcpy calls.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdlib.h>
+#include <string.h>
+#include "ll_snapshot.hpp"
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool snapshot_ring_create(snapshot_ring_t *ring, size_t frame_count, size_t max_bytes)
+{
+    ring->Frames     = (snapshot_buffer_t*) calloc(frame_count, sizeof(snapshot_buffer_t));
+    ring->FrameCount = frame_count;
+    ring->MaxBytes   = max_bytes;
+    if (ring->Frames == NULL)
+    {
+        ring->FrameCount = 0;
+        return false;
+    }
+    for (size_t i = 0; i < frame_count; ++i)
+    {
+        ring->Frames[i].Tick = SNAPSHOT_INVALID_TICK;
+    }
+    return true;
+}
+
+void snapshot_ring_delete(snapshot_ring_t *ring)
+{
+    for (size_t i = 0; i < ring->FrameCount; ++i)
+    {
+        free(ring->Frames[i].Data);
+    }
+    free(ring->Frames);
+    ring->Frames     = NULL;
+    ring->FrameCount = 0;
+    ring->MaxBytes   = 0;
+}
+
+void snapshot_ring_truncate(snapshot_ring_t *ring, uint64_t tick)
+{
+    for (size_t i = 0; i < ring->FrameCount; ++i)
+    {
+        snapshot_buffer_t *f = &ring->Frames[i];
+        if (f->Tick != SNAPSHOT_INVALID_TICK && f->Tick > tick)
+            f->Tick  = SNAPSHOT_INVALID_TICK;
+    }
+}
+
+snapshot_buffer_t* snapshot_ring_save(snapshot_ring_t *ring, uint64_t tick)
+{
+    snapshot_buffer_t *f = &ring->Frames[tick % ring->FrameCount];
+    if (f->Data == NULL)
+    {
+        // new buffers are sized for the largest saved tick, plus some room
+        // to grow. at the memory limit, the buffer of the oldest saved tick
+        // is reused instead. truncated buffers hold no tick and are taken
+        // first; adding one to SNAPSHOT_INVALID_TICK wraps to zero.
+        snapshot_buffer_t *oldest  = NULL;
+        size_t             bytes   = 0;
+        size_t             largest = 0;
+        for (size_t i = 0; i < ring->FrameCount; ++i)
+        {
+            snapshot_buffer_t *o = &ring->Frames[i];
+            bytes  += o->Capacity;
+            largest = o->Size > largest ? o->Size : largest;
+            if (o->Data != NULL && (oldest == NULL || o->Tick + 1 < oldest->Tick + 1))
+                oldest = o;
+        }
+        size_t want = largest + largest / 16;
+        if (oldest != NULL && bytes + want > ring->MaxBytes)
+        {
+            f->Data          = oldest->Data;
+            f->Capacity      = oldest->Capacity;
+            oldest->Tick     = SNAPSHOT_INVALID_TICK;
+            oldest->Data     = NULL;
+            oldest->Capacity = 0;
+        }
+        else if (want > 0)
+        {
+            f->Data     = (uint8_t*) malloc(want);
+            f->Capacity = f->Data != NULL ? want : 0;
+        }
+    }
+    f->Tick   = tick;
+    f->Size   = 0;
+    f->Cursor = 0;
+    return f;
+}
+
+snapshot_buffer_t* snapshot_ring_find(snapshot_ring_t *ring, uint64_t tick)
+{
+    if (ring->FrameCount == 0)
+        return NULL;
+
+    snapshot_buffer_t *f = &ring->Frames[tick % ring->FrameCount];
+    if (f->Tick != tick)
+        return NULL;
+
+    f->Cursor = 0;
+    return f;
+}
+
+void* snapshot_reserve(snapshot_buffer_t *buffer, size_t size)
+{
+    if (buffer->Size + size > buffer->Capacity)
+    {
+        size_t capacity = buffer->Capacity > 0 ? buffer->Capacity : SNAPSHOT_DEFAULT_RESERVE;
+        while (capacity < buffer->Size + size)
+            capacity *= 2;
+
+        uint8_t *data = (uint8_t*) realloc(buffer->Data, capacity);
+        if (data == NULL)
+            return NULL;
+
+        buffer->Data     = data;
+        buffer->Capacity = capacity;
+    }
+    void *p = buffer->Data + buffer->Size;
+    buffer->Size += size;
+    return p;
+}
+
+bool snapshot_write(snapshot_buffer_t *buffer, void const *src, size_t size)
+{
+    void *dst = snapshot_reserve(buffer, size);
+    if (dst == NULL)
+        return false;
+
+    memcpy(dst, src, size);
+    return true;
+}
+
+void const* snapshot_view(snapshot_buffer_t *buffer, size_t size)
+{
+    if (buffer->Cursor + size > buffer->Size)
+        return NULL;
+
+    void const *p = buffer->Data + buffer->Cursor;
+    buffer->Cursor += size;
+    return p;
+}
+
+bool snapshot_read(snapshot_buffer_t *buffer, void *dst, size_t size)
+{
+    void const *src = snapshot_view(buffer, size);
+    if (src == NULL)
+        return false;
+
+    memcpy(dst, src, size);
+    return true;
+}
+
+uint64_t snapshot_hash(snapshot_buffer_t const *buffer)
+{
+    // FNV-1a over 64-bit words, with the tail bytes folded in one at a time.
+    uint64_t const prime = 0x100000001B3ULL;
+    uint64_t       h     = 0xCBF29CE484222325ULL;
+    size_t   const words = buffer->Size / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i)
+    {
+        uint64_t w;
+        memcpy(&w, buffer->Data + i * sizeof(uint64_t), sizeof(uint64_t));
+        h = (h ^ w) * prime;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < buffer->Size; ++i)
+    {
+        h = (h ^ buffer->Data[i]) * prime;
+    }
+    return h;
+}
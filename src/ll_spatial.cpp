@@ -0,0 +1,210 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a uniform grid used to answer neighbor queries. The
+/// grid is rebuilt with a two-pass counting sort, which is linear in the
+/// number of points and keeps each cell's points adjacent in memory.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "math_soa.hpp"
+#include "ll_spatial.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of per-point arrays allocated for the grid.
+#define SPATIAL_ARRAY_COUNT          5U
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Spreads the low 16 bits of a value into the even bits of the result.
+/// @param v The value to spread.
+/// @return The spread value.
+static inline uint32_t morton_spread(uint32_t v)
+{
+    v &= 0x0000FFFFU;
+    v  = (v | (v << 8)) & 0x00FF00FFU;
+    v  = (v | (v << 4)) & 0x0F0F0F0FU;
+    v  = (v | (v << 2)) & 0x33333333U;
+    v  = (v | (v << 1)) & 0x55555555U;
+    return v;
+}
+
+/// @summary Quantizes a coordinate to 16 bits across an interval.
+/// @param v The coordinate.
+/// @param origin The start of the interval.
+/// @param scale 65535 divided by the length of the interval.
+/// @return The quantized coordinate, clamped to [0, 65535].
+static inline uint32_t morton_quantize(float v, float origin, float scale)
+{
+    float q = (v - origin) * scale;
+    if (q <= 0.0f) return 0;
+    if (q >= 65535.0f) return 65535;
+    return uint32_t(q);
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool spatial_grid_create(spatial_grid_t *grid, float x, float y, float width, float height, float cell_size, size_t capacity)
+{
+    size_t cells_x    = size_t(ceilf(width  / cell_size));
+    size_t cells_y    = size_t(ceilf(height / cell_size));
+    grid->OriginX     = x;
+    grid->OriginY     = y;
+    grid->CellSize    = cell_size;
+    grid->InvCellSize = 1.0f / cell_size;
+    grid->CellsX      = cells_x > 0 ? cells_x : 1;
+    grid->CellsY      = cells_y > 0 ? cells_y : 1;
+    grid->Capacity    = capacity;
+    grid->Count       = 0;
+    grid->MaxRadius   = 0.0f;
+
+    size_t cells      = grid->CellsX * grid->CellsY;
+    grid->CellStart   = (uint32_t*) calloc(cells + 1, sizeof(uint32_t));
+    grid->Cursor      = (uint32_t*) malloc(cells * sizeof(uint32_t));
+
+    // the sorted coordinate arrays start on SOA_ALIGNMENT boundaries.
+    size_t    stride  = (capacity * sizeof(float) + (SOA_ALIGNMENT - 1)) & ~size_t(SOA_ALIGNMENT - 1);
+    grid->Memory      = malloc(stride * SPATIAL_ARRAY_COUNT + SOA_ALIGNMENT);
+    uintptr_t base    = (uintptr_t(grid->Memory) + (SOA_ALIGNMENT - 1)) & ~uintptr_t(SOA_ALIGNMENT - 1);
+    grid->PointCell   = (uint32_t*) (base + stride * 0);
+    grid->Items       = (uint32_t*) (base + stride * 1);
+    grid->SortedX     = (float   *) (base + stride * 2);
+    grid->SortedY     = (float   *) (base + stride * 3);
+    grid->SortedR     = (float   *) (base + stride * 4);
+
+    if (grid->CellStart == NULL || grid->Cursor == NULL || grid->Memory == NULL)
+    {
+        spatial_grid_delete(grid);
+        return false;
+    }
+    return true;
+}
+
+void spatial_grid_delete(spatial_grid_t *grid)
+{
+    free(grid->Memory);
+    free(grid->Cursor);
+    free(grid->CellStart);
+    grid->Memory    = NULL;
+    grid->Cursor    = NULL;
+    grid->CellStart = NULL;
+    grid->PointCell = NULL;
+    grid->Items     = NULL;
+    grid->SortedX   = NULL;
+    grid->SortedY   = NULL;
+    grid->SortedR   = NULL;
+    grid->Capacity  = 0;
+    grid->Count     = 0;
+    grid->MaxRadius = 0.0f;
+}
+
+void spatial_grid_build(spatial_grid_t *grid, float const *x, float const *y, float const *r, size_t count)
+{
+    size_t    cells  = grid->CellsX * grid->CellsY;
+    uint32_t *start  = grid->CellStart;
+    uint32_t *cursor = grid->Cursor;
+    uint32_t *cell   = grid->PointCell;
+
+    if (count > grid->Capacity)
+        count = grid->Capacity;
+
+    // pass 1: bin each point and count the points in each cell.
+    memset(cursor, 0, cells * sizeof(uint32_t));
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t c = uint32_t(spatial_grid_row(grid, y[i]) * grid->CellsX + spatial_grid_column(grid, x[i]));
+        cell[i]    = c;
+        cursor[c] += 1;
+    }
+
+    // convert counts to starting offsets.
+    uint32_t sum = 0;
+    for (size_t c = 0; c < cells; ++c)
+    {
+        uint32_t n = cursor[c];
+        start[c]   = sum;
+        cursor[c]  = sum;
+        sum       += n;
+    }
+    start[cells] = sum;
+
+    // pass 2: scatter the points into cell order.
+    float max_r = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t dst       = cursor[cell[i]]++;
+        float    rad       = r != NULL ? r[i] : 0.0f;
+        grid->Items[dst]   = uint32_t(i);
+        grid->SortedX[dst] = x[i];
+        grid->SortedY[dst] = y[i];
+        grid->SortedR[dst] = rad;
+        if (rad > max_r) max_r = rad;
+    }
+    grid->Count     = count;
+    grid->MaxRadius = max_r;
+}
+
+void spatial_morton_codes(spatial_grid_t const *grid, float const *x, float const *y, size_t count, uint32_t *codes)
+{
+    float sx = 65535.0f / (float(grid->CellsX) * grid->CellSize);
+    float sy = 65535.0f / (float(grid->CellsY) * grid->CellSize);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t qx = morton_quantize(x[i], grid->OriginX, sx);
+        uint32_t qy = morton_quantize(y[i], grid->OriginY, sy);
+        codes[i]    = morton_spread(qx) | (morton_spread(qy) << 1);
+    }
+}
+
+uint32_t* spatial_radix_sort(uint32_t *keys, uint32_t *scratch_keys, uint32_t *order, uint32_t *scratch_order, size_t count)
+{
+    // build the histograms of all four digits in a single pass.
+    uint32_t hist[4][256];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t k = keys[i];
+        hist[0][(k >>  0) & 0xFF]++;
+        hist[1][(k >>  8) & 0xFF]++;
+        hist[2][(k >> 16) & 0xFF]++;
+        hist[3][(k >> 24) & 0xFF]++;
+        order[i] = uint32_t(i);
+    }
+
+    uint32_t *src_k = keys,  *dst_k = scratch_keys;
+    uint32_t *src_o = order, *dst_o = scratch_order;
+    for (size_t d = 0; d < 4; ++d)
+    {
+        uint32_t shift = uint32_t(d * 8);
+        uint32_t sum   = 0;
+        bool     skip  = false;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            uint32_t n = hist[d][b];
+            if (n == count) { skip = true; break; }
+            hist[d][b] = sum;
+            sum       += n;
+        }
+        if (skip) continue;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t k   = src_k[i];
+            uint32_t dst = hist[d][(k >> shift) & 0xFF]++;
+            dst_k[dst]   = k;
+            dst_o[dst]   = src_o[i];
+        }
+        uint32_t *t;
+        t = src_k; src_k = dst_k; dst_k = t;
+        t = src_o; src_o = dst_o; dst_o = t;
+    }
+    return src_o;
+}
@@ -10,7 +10,7 @@
 ////////////////*/
 #include <math.h>
 #include <stdlib.h>
-#include <assert.h>
+#include <string.h>
 
 #include "ll_sprite.hpp"
 
@@ -33,15 +33,19 @@ void create_sprite_batch(sprite_batch_t *batch, size_t capacity)
         batch->Capacity = capacity;
         if (capacity)
         {
-            batch->Quads = (squad_t *) malloc(capacity * sizeof(squad_t));
-            batch->State = (qsdata_t*) malloc(capacity * sizeof(qsdata_t));
-            batch->Order = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+            batch->Quads     = (squad_t *) malloc(capacity * sizeof(squad_t));
+            batch->State     = (qsdata_t*) malloc(capacity * sizeof(qsdata_t));
+            batch->Order     = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+            batch->SortOrder = (uint32_t*) malloc(capacity * sizeof(uint32_t));
+            batch->SortKeys  = (uint64_t*) malloc(capacity * sizeof(uint64_t) * 2);
         }
         else
         {
-            batch->Quads = NULL;
-            batch->State = NULL;
-            batch->Order = NULL;
+            batch->Quads     = NULL;
+            batch->State     = NULL;
+            batch->Order     = NULL;
+            batch->SortOrder = NULL;
+            batch->SortKeys  = NULL;
         }
     }
 }
@@ -52,15 +56,19 @@ void delete_sprite_batch(sprite_batch_t *batch)
     {
         if (batch->Capacity)
         {
+            free(batch->SortKeys);
+            free(batch->SortOrder);
             free(batch->Order);
             free(batch->State);
             free(batch->Quads);
         }
-        batch->Count    = 0;
-        batch->Capacity = 0;
-        batch->Quads    = NULL;
-        batch->State    = NULL;
-        batch->Order    = NULL;
+        batch->Count     = 0;
+        batch->Capacity  = 0;
+        batch->Quads     = NULL;
+        batch->State     = NULL;
+        batch->Order     = NULL;
+        batch->SortOrder = NULL;
+        batch->SortKeys  = NULL;
     }
 }
 
@@ -69,10 +77,12 @@ void ensure_sprite_batch(sprite_batch_t *batch, size_t capacity)
 {
     if (batch->Capacity < capacity)
     {
-        batch->Capacity = capacity;
-        batch->Quads    = (squad_t *) realloc(batch->Quads, capacity * sizeof(squad_t));
-        batch->State    = (qsdata_t*) realloc(batch->State, capacity * sizeof(qsdata_t));
-        batch->Order    = (uint32_t*) realloc(batch->Order, capacity * sizeof(uint32_t));
+        batch->Capacity  = capacity;
+        batch->Quads     = (squad_t *) realloc(batch->Quads    , capacity * sizeof(squad_t));
+        batch->State     = (qsdata_t*) realloc(batch->State    , capacity * sizeof(qsdata_t));
+        batch->Order     = (uint32_t*) realloc(batch->Order    , capacity * sizeof(uint32_t));
+        batch->SortOrder = (uint32_t*) realloc(batch->SortOrder, capacity * sizeof(uint32_t));
+        batch->SortKeys  = (uint64_t*) realloc(batch->SortKeys , capacity * sizeof(uint64_t) * 2);
     }
 }
 
@@ -81,45 +91,88 @@ void flush_sprite_batch(sprite_batch_t *batch)
     batch->Count = 0;
 }
 
-void generate_quads(squad_t *quads, qsdata_t *sdata, uint32_t *indices, size_t quad_offset, sprite_t const *sprites, size_t sprite_offset, size_t sprite_count)
+void radix_sort_sprite_batch(sprite_batch_t *batch, bool back_to_front)
 {
-    size_t qindex = quad_offset;
-    size_t sindex = sprite_offset;
-    for (size_t i = 0;  i < sprite_count; ++i, ++qindex, ++sindex)
+    size_t const count = batch->Count;
+    if (count < 2)
+        return;
+
+    // build the keys and the histograms of all eight digits in a single
+    // pass. inverting the layer depth draws the deepest layer first.
+    uint32_t const layer_flip = back_to_front ? 0xFFFFFFFFU : 0U;
+    uint64_t      *keys       = batch->SortKeys;
+    uint32_t       hist[8][256];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < count; ++i)
     {
-        sprite_t const &s = sprites[sindex];
-        qsdata_t       &r = sdata[qindex];
-        squad_t        &q = quads[qindex];
+        qsdata_t const &sd = batch->State[batch->Order[i]];
+        uint64_t        k  = (uint64_t(sd.LayerDepth ^ layer_flip) << 32) | sd.RenderState;
+        keys[i] = k;
+        for (size_t d = 0; d < 8; ++d)
+        {
+            hist[d][(k >> (d * 8)) & 0xFF]++;
+        }
+    }
 
-        q.Source[0]   = s.ImageX;
-        q.Source[1]   = s.ImageY;
-        q.Source[2]   = s.ImageWidth;
-        q.Source[3]   = s.ImageHeight;
-        q.Target[0]   = s.ScreenX;
-        q.Target[1]   = s.ScreenY;
-        q.Target[2]   = s.ImageWidth  * s.ScaleX;
-        q.Target[3]   = s.ImageHeight * s.ScaleY;
-        q.Origin[0]   = s.OriginX;
-        q.Origin[1]   = s.OriginY;
-        q.Scale [0]   = 1.0f / s.TextureWidth;
-        q.Scale [1]   = 1.0f / s.TextureHeight;
-        q.Orientation = s.Orientation;
-        q.TintColor   = s.TintColor;
+    uint64_t *src_k = keys,         *dst_k = keys + count;
+    uint32_t *src_o = batch->Order, *dst_o = batch->SortOrder;
+    for (size_t d = 0; d < 8; ++d)
+    {
+        uint32_t shift = uint32_t(d * 8);
+        uint32_t sum   = 0;
+        bool     skip  = false;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            uint32_t n = hist[d][b];
+            if (n == count) { skip = true; break; }
+            hist[d][b] = sum;
+            sum       += n;
+        }
+        if (skip) continue;
 
-        r.LayerDepth  = s.LayerDepth;
-        r.RenderState = s.RenderState;
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t k   = src_k[i];
+            uint32_t dst = hist[d][(k >> shift) & 0xFF]++;
+            dst_k[dst]   = k;
+            dst_o[dst]   = src_o[i];
+        }
+        uint64_t *tk = src_k; src_k = dst_k; dst_k = tk;
+        uint32_t *to = src_o; src_o = dst_o; dst_o = to;
+    }
+    if (src_o != batch->Order)
+    {
+        // the sorted order ended up in the scratch array; swap the buffers.
+        batch->SortOrder = batch->Order;
+        batch->Order     = src_o;
+    }
+}
 
-        indices[qindex] = qindex;
+squad_t* sprite_batch_append(sprite_batch_t *batch, size_t count, uint32_t layer_depth, uint32_t render_state)
+{
+    size_t first = batch->Count;
+    size_t total = batch->Count + count;
+    if (total > batch->Capacity)
+    {
+        size_t capacity = batch->Capacity * 2;
+        ensure_sprite_batch(batch, capacity > total ? capacity : total);
     }
+    for (size_t i = first; i < total; ++i)
+    {
+        batch->State[i].LayerDepth  = layer_depth;
+        batch->State[i].RenderState = render_state;
+        batch->Order[i]             = uint32_t(i);
+    }
+    batch->Count = total;
+    return &batch->Quads[first];
 }
 
-void generate_quad_vertices_ptc(
-    void           *buffer,
-    size_t          buffer_offset,
-    squad_t const  *quads,
-    uint32_t const *indices,
-    size_t          quad_offset,
-    size_t          quad_count)
+void sprite_format_ptc_t::generate_vertices(
+    sprite_vertex_ptc_t *buffer,
+    squad_t const       *quads,
+    uint32_t const      *indices,
+    size_t               quad_offset,
+    size_t               quad_count)
 {
     static const size_t X      =  0;
     static const size_t Y      =  1;
@@ -128,8 +181,8 @@ void generate_quad_vertices_ptc(
     static const float  XCO[4] = {0.0f, 1.0f, 1.0f, 0.0f};
     static const float  YCO[4] = {0.0f, 0.0f, 1.0f, 1.0f};
 
-    sprite_vertex_ptc_t   *vertex_buffer = (sprite_vertex_ptc_t*) buffer;
-    size_t                 vertex_offset = buffer_offset;
+    sprite_vertex_ptc_t   *vertex_buffer = buffer;
+    size_t                 vertex_offset = 0;
     for (size_t i = 0; i < quad_count; ++i)
     {
         // figure out which quad we're working with.
@@ -149,10 +202,9 @@ void generate_quad_vertices_ptc(
         const float     ctr_y = quad.Origin[Y] / src_h;
         const float     scl_u = quad.Scale[X];
         const float     scl_v = quad.Scale[Y];
-        const float     angle = quad.Orientation;
+        const float     cos_o = quad.Rotation[0];
+        const float     sin_o = quad.Rotation[1];
         const uint32_t  color = quad.TintColor;
-        const float     sin_o = sinf(angle);
-        const float     cos_o = cosf(angle);
 
         // calculate values that change per-vertex.
         for (size_t j = 0; j < 4; ++j)
@@ -171,84 +223,6 @@ void generate_quad_vertices_ptc(
     }
 }
 
-void generate_quad_indices_u16(void *buffer, size_t offset, size_t base_vertex, size_t quad_count)
-{
-    uint16_t *u16 = (uint16_t*) buffer;
-    uint16_t  b16 = (uint16_t ) base_vertex;
-    for (size_t i = 0; i < quad_count; ++i)
-    {
-        u16[offset++]  = (b16 + 1);
-        u16[offset++]  = (b16 + 0);
-        u16[offset++]  = (b16 + 2);
-        u16[offset++]  = (b16 + 2);
-        u16[offset++]  = (b16 + 0);
-        u16[offset++]  = (b16 + 3);
-        b16 += 4;
-    }
-}
-
-void generate_quad_indices_u32(void *buffer, size_t offset, size_t base_vertex, size_t quad_count)
-{
-    uint32_t *u32 = (uint32_t*) buffer;
-    uint32_t  b32 = (uint32_t ) base_vertex;
-    for (size_t i = 0; i < quad_count; ++i)
-    {
-        u32[offset++]  = (b32 + 1);
-        u32[offset++]  = (b32 + 0);
-        u32[offset++]  = (b32 + 2);
-        u32[offset++]  = (b32 + 2);
-        u32[offset++]  = (b32 + 0);
-        u32[offset++]  = (b32 + 3);
-        b32 += 4;
-    }
-}
-
-bool create_sprite_effect(sprite_effect_t *effect, size_t quad_count, size_t vertex_size, size_t index_size)
-{
-    assert(effect     != NULL);
-    assert(quad_count  > 0);
-    assert(vertex_size > 0);
-    assert(index_size  > 0);
-
-    GLuint  vao        =  0;
-    GLuint  buffers[2] = {0, 0};
-    size_t  vcount     = quad_count  * 4;
-    size_t  icount     = quad_count  * 6;
-    GLsizei abo_size   = vertex_size * vcount;
-    GLsizei eao_size   = index_size  * icount;
-
-    // @todo: error handling.
-    glGenBuffers(2, buffers);
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
-    glBufferData(GL_ARRAY_BUFFER, abo_size, NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, eao_size, NULL, GL_DYNAMIC_DRAW);
-    glGenVertexArrays(1, &vao);
-
-    effect->VertexCapacity   = vcount;
-    effect->VertexOffset     = 0;
-    effect->VertexSize       = vertex_size;
-    effect->IndexCapacity    = icount;
-    effect->IndexOffset      = 0;
-    effect->IndexSize        = index_size;
-    effect->CurrentState     = 0xFFFFFFFFU;
-    effect->VertexArray      = vao;
-    effect->VertexBuffer     = buffers[0];
-    effect->IndexBuffer      = buffers[1];
-    effect->BlendEnabled     = GL_FALSE;
-    effect->BlendSourceColor = GL_ONE;
-    effect->BlendSourceAlpha = GL_ONE;
-    effect->BlendTargetColor = GL_ZERO;
-    effect->BlendTargetAlpha = GL_ZERO;
-    effect->BlendFuncColor   = GL_FUNC_ADD;
-    effect->BlendFuncAlpha   = GL_FUNC_ADD;
-    effect->BlendColor[0]    = 0.0f;
-    effect->BlendColor[1]    = 0.0f;
-    effect->BlendColor[2]    = 0.0f;
-    effect->BlendColor[3]    = 0.0f;
-    return true;
-}
-
 void delete_sprite_effect(sprite_effect_t *effect)
 {
     GLuint buffers[2] = {
@@ -259,10 +233,8 @@ void delete_sprite_effect(sprite_effect_t *effect)
     glDeleteVertexArrays(1, &effect->VertexArray);
     effect->VertexCapacity = 0;
     effect->VertexOffset   = 0;
-    effect->VertexSize     = 0;
     effect->IndexCapacity  = 0;
     effect->IndexOffset    = 0;
-    effect->IndexSize      = 0;
     effect->VertexArray    = 0;
     effect->VertexBuffer   = 0;
     effect->IndexBuffer    = 0;
@@ -328,6 +300,25 @@ void sprite_effect_blend_premultiplied(sprite_effect_t *effect)
     effect->BlendColor[3]    = 0.0f;
 }
 
+void sprite_effect_blend_mode(sprite_effect_t *effect, uint32_t blend)
+{
+    switch (blend)
+    {
+        case SPRITE_BLEND_ALPHA:
+            sprite_effect_blend_alpha(effect);
+            break;
+        case SPRITE_BLEND_ADDITIVE:
+            sprite_effect_blend_additive(effect);
+            break;
+        case SPRITE_BLEND_PREMULTIPLIED:
+            sprite_effect_blend_premultiplied(effect);
+            break;
+        default:
+            sprite_effect_blend_none(effect);
+            break;
+    }
+}
+
 void sprite_effect_set_viewport(sprite_effect_t *effect, int width, int height)
 {
     float *dst16 = effect->Projection;
@@ -358,7 +349,7 @@ void sprite_effect_apply_blendstate(sprite_effect_t *effect)
     else glDisable(GL_BLEND);
 }
 
-void sprite_effect_setup_vao_ptc(sprite_effect_t *effect)
+void sprite_format_ptc_t::setup_vao(sprite_effect_t *effect)
 {
     glBindVertexArray(effect->VertexArray);
     glEnableVertexAttribArray(SPRITE_PTC_LOCATION_PTX);
@@ -366,141 +357,3 @@ void sprite_effect_setup_vao_ptc(sprite_effect_t *effect)
     glVertexAttribPointer(SPRITE_PTC_LOCATION_PTX, 4, GL_FLOAT,         GL_FALSE, sizeof(sprite_vertex_ptc_t), (GLvoid const*)  0);
     glVertexAttribPointer(SPRITE_PTC_LOCATION_CLR, 4, GL_UNSIGNED_BYTE, GL_TRUE,  sizeof(sprite_vertex_ptc_t), (GLvoid const*) 16);
 }
-
-size_t sprite_effect_buffer_data_ptc(
-    sprite_effect_t *effect,
-    squad_t const   *quads,
-    uint32_t const  *indices,
-    size_t           quad_offset,
-    size_t           quad_count,
-    size_t          *base_index_arg)
-{
-    if (effect->VertexOffset == effect->VertexCapacity)
-    {
-        // the buffer is completely full. time to discard it and
-        // request a new buffer from the driver, to avoid stalls.
-        GLsizei abo_size     = effect->VertexCapacity * effect->VertexSize;
-        GLsizei eao_size     = effect->IndexCapacity  * effect->IndexSize;
-        effect->VertexOffset = 0;
-        effect->IndexOffset  = 0;
-        glBufferData(GL_ARRAY_BUFFER, abo_size, NULL, GL_DYNAMIC_DRAW);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, eao_size, NULL, GL_DYNAMIC_DRAW);
-    }
-
-    size_t num_indices  = quad_count * 6;
-    size_t num_vertices = quad_count * 4;
-    size_t max_vertices = effect->VertexCapacity;
-    size_t base_vertex  = effect->VertexOffset;
-    size_t vertex_size  = effect->VertexSize;
-    size_t max_indices  = effect->IndexCapacity;
-    size_t base_index   = effect->IndexOffset;
-    size_t index_size   = effect->IndexSize;
-    if (max_vertices < base_vertex + num_vertices)
-    {
-        // not enough space in the buffer to fit everything.
-        // only a portion of the desired data will be buffered.
-        num_vertices = max_vertices - base_vertex;
-        num_indices  = max_indices  - base_index;
-    }
-
-    size_t buffer_count =  num_vertices / 4;
-    if (buffer_count == 0) return 0;
-
-    GLintptr   v_offset = base_vertex  * vertex_size;
-    GLsizeiptr v_size   = num_vertices * vertex_size;
-    GLbitfield v_access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
-    GLvoid    *v_data   = glMapBufferRange(GL_ARRAY_BUFFER, v_offset, v_size, v_access);
-    if (v_data != NULL)
-    {
-        generate_quad_vertices_ptc(v_data, 0, quads, indices, quad_offset, buffer_count);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-    }
-
-    GLintptr   i_offset = base_index  * index_size;
-    GLsizeiptr i_size   = num_indices * index_size;
-    GLbitfield i_access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
-    GLvoid    *i_data   = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, i_offset, i_size, i_access);
-    if (i_data != NULL)
-    {
-        if (index_size == sizeof(uint16_t)) generate_quad_indices_u16(i_data, 0, base_vertex, buffer_count);
-        else generate_quad_indices_u32(i_data, 0, base_vertex, buffer_count);
-        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
-    }
-
-    effect->VertexOffset += buffer_count * 4;
-    effect->IndexOffset  += buffer_count * 6;
-    *base_index_arg       = base_index;
-    return buffer_count;
-}
-
-void sprite_effect_draw_batch_ptc(
-    sprite_effect_t             *effect,
-    sprite_batch_t              *batch,
-    sprite_effect_apply_t const *fxfuncs,
-    void                        *context)
-{
-    size_t quad_count = batch->Count;
-    size_t quad_index = 0;
-    size_t base_index = 0;
-    size_t n          = 0;
-
-    fxfuncs->SetupEffect(effect, context);
-    effect->CurrentState = 0xFFFFFFFFU;
-
-    while (quad_count > 0)
-    {
-        n = sprite_effect_buffer_data_ptc(effect, batch->Quads, batch->Order, quad_index, quad_count, &base_index);
-        sprite_effect_draw_batch_region_ptc(effect, batch, quad_index, n, base_index, fxfuncs, context);
-        base_index  = effect->IndexOffset;
-        quad_index += n;
-        quad_count -= n;
-    }
-}
-
-void sprite_effect_draw_batch_region_ptc(
-    sprite_effect_t             *effect,
-    sprite_batch_t              *batch,
-    size_t                       quad_offset,
-    size_t                       quad_count,
-    size_t                       base_index,
-    sprite_effect_apply_t const *fxfuncs,
-    void                        *context)
-{
-    #define GLPTR(x)  (GLvoid const*)(x)
-    uint32_t state_0 = effect->CurrentState;
-    uint32_t state_1 = effect->CurrentState;
-    size_t   index   = 0; // index of start of sub-batch
-    size_t   nquad   = 0; // count of quads in sub-batch
-    size_t   nindex  = 0; // count of indices in sub-batch
-    size_t   quad_id = 0; // quad insertion index
-    GLsizei  size    = effect->IndexSize;
-    GLenum   type    = size == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
-
-    for (size_t i = 0; i < quad_count; ++i)
-    {
-        quad_id = batch->Order[quad_offset + i];
-        state_1 = batch->State[quad_id].RenderState;
-        if (state_1 != state_0)
-        {
-            // render the previous sub-batch with the current state,
-            // as long as it has at least one quad in the sub-batch.
-            if (i > index)
-            {
-                nquad  = i - index;  // the number of quads being submitted
-                nindex = nquad * 6;  // the number of indices being submitted
-                glDrawElements(GL_TRIANGLES, nindex, type, GLPTR(base_index * size));
-                base_index += nindex;
-            }
-            // now apply the new state and start a new sub-batch.
-            fxfuncs->ApplyState(effect, state_1, context);
-            state_0 = state_1;
-            index   = i;
-        }
-    }
-    // submit the remainder of the sub-batch.
-    nquad  = quad_count - index;
-    nindex = nquad * 6;
-    glDrawElements(GL_TRIANGLES, nindex, type, GLPTR(base_index * size));
-    effect->CurrentState = state_1;
-    #undef GLPTR
-}
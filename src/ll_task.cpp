@@ -0,0 +1,173 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a persistent pool of worker threads used to split
+/// data-parallel loops across the available cores. Workers claim chunks of
+/// the loop range from a shared atomic counter, and the submitting thread
+/// participates in the loop before waiting for the workers to drain.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "ll_task.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Internal state associated with a pool of worker threads.
+struct task_pool_t
+{
+    std::thread              Workers[TASK_MAX_WORKERS]; /// The worker threads.
+    size_t                   WorkerCount;               /// The number of valid Workers.
+    std::mutex               Lock;                      /// Protects Generation, Busy and Exit.
+    std::condition_variable  WakeCond;                  /// Signaled when a loop is submitted.
+    std::condition_variable  DoneCond;                  /// Signaled when the last worker finishes.
+    uint64_t                 Generation;                /// Incremented for each submitted loop.
+    size_t                   Busy;                      /// Workers still running the current loop.
+    bool                     Exit;                      /// Set to request that workers exit.
+    task_range_fn            Func;                      /// The current loop body.
+    void                    *Context;                   /// Opaque data passed to Func.
+    size_t                   Count;                     /// The number of items in the current loop.
+    size_t                   Chunk;                     /// The number of items claimed at once.
+    std::atomic<size_t>      NextIndex;                 /// The next unclaimed item index.
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Claims and processes chunks of the current loop until the range
+/// has been exhausted.
+/// @param pool The pool whose current loop is being executed.
+static void run_chunks(task_pool_t *pool)
+{
+    size_t const count = pool->Count;
+    size_t const chunk = pool->Chunk;
+    size_t       begin = pool->NextIndex.fetch_add(chunk, std::memory_order_relaxed);
+    while (begin < count)
+    {
+        size_t end = begin + chunk;
+        if (end > count) end = count;
+        pool->Func(begin, end, pool->Context);
+        begin = pool->NextIndex.fetch_add(chunk, std::memory_order_relaxed);
+    }
+}
+
+/// @summary The entry point for each worker thread. Sleeps until a loop is
+/// submitted, helps execute it, and reports completion.
+/// @param pool The pool that owns the thread.
+static void task_worker_thread(task_pool_t *pool)
+{
+    uint64_t seen = 0;
+    for ( ; ; )
+    {
+        {
+            std::unique_lock<std::mutex> guard(pool->Lock);
+            while (pool->Exit == false && pool->Generation == seen)
+                pool->WakeCond.wait(guard);
+            if (pool->Exit) return;
+            seen = pool->Generation;
+        }
+
+        run_chunks(pool);
+
+        {
+            std::lock_guard<std::mutex> guard(pool->Lock);
+            if (--pool->Busy == 0)
+                pool->DoneCond.notify_one();
+        }
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+task_pool_t* task_pool_create(size_t worker_count)
+{
+    if (worker_count == 0)
+    {
+        size_t hw = size_t(std::thread::hardware_concurrency());
+        worker_count = hw > 1 ? hw - 1 : 0;
+    }
+    if (worker_count > TASK_MAX_WORKERS)
+    {
+        worker_count = TASK_MAX_WORKERS;
+    }
+
+    task_pool_t *pool  = new task_pool_t();
+    pool->WorkerCount  = 0;
+    pool->Generation   = 0;
+    pool->Busy         = 0;
+    pool->Exit         = false;
+    pool->Func         = NULL;
+    pool->Context      = NULL;
+    pool->Count        = 0;
+    pool->Chunk        = 1;
+    pool->NextIndex.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        pool->Workers[i] = std::thread(task_worker_thread, pool);
+        pool->WorkerCount++;
+    }
+    return pool;
+}
+
+void task_pool_delete(task_pool_t *pool)
+{
+    if (pool == NULL)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(pool->Lock);
+        pool->Exit = true;
+    }
+    pool->WakeCond.notify_all();
+    for (size_t i = 0; i < pool->WorkerCount; ++i)
+    {
+        pool->Workers[i].join();
+    }
+    delete pool;
+}
+
+size_t task_pool_concurrency(task_pool_t const *pool)
+{
+    return (pool != NULL) ? pool->WorkerCount + 1 : 1;
+}
+
+void task_pool_parallel_for(task_pool_t *pool, size_t count, size_t min_chunk, task_range_fn func, void *context)
+{
+    if (min_chunk == 0) min_chunk = 1;
+    if (pool == NULL || pool->WorkerCount == 0 || count <= min_chunk)
+    {
+        // not worth waking the workers; run inline.
+        if (count > 0) func(0, count, context);
+        return;
+    }
+
+    // split the range into a few chunks per thread so that uneven
+    // progress between threads still balances out at the end.
+    size_t threads = pool->WorkerCount + 1;
+    size_t chunk   = count / (threads * 4);
+    if (chunk < min_chunk) chunk = min_chunk;
+
+    {
+        std::lock_guard<std::mutex> guard(pool->Lock);
+        pool->Func    = func;
+        pool->Context = context;
+        pool->Count   = count;
+        pool->Chunk   = chunk;
+        pool->Busy    = pool->WorkerCount;
+        pool->NextIndex.store(0, std::memory_order_relaxed);
+        pool->Generation++;
+    }
+    pool->WakeCond.notify_all();
+
+    run_chunks(pool);
+
+    std::unique_lock<std::mutex> guard(pool->Lock);
+    while (pool->Busy > 0)
+        pool->DoneCond.wait(guard);
+}
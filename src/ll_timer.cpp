@@ -0,0 +1,295 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a hierarchical timing wheel. Level L of the wheel holds
+/// timers due in fewer than 64^(L+1) ticks, in the slot selected by bits
+/// [6L, 6L+6) of their deadline. Whenever the low 6L bits of the current tick
+/// wrap to zero, the current slot of level L is redistributed to the levels
+/// below it, so every timer reaches level 0 in time to expire exactly on its
+/// deadline.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdlib.h>
+#include <string.h>
+#include "ll_timer.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The Slot value of a node that is not in any slot list.
+#define TIMER_SLOT_FREE              (0xFFFFU)
+
+/// @summary The mask applied to a slot index within a single level.
+#define TIMER_SLOT_MASK              (TIMER_WHEEL_SLOTS - 1U)
+
+/// @summary The mask applied to a handle to extract the node index plus one.
+#define TIMER_INDEX_MASK             (0x00FFFFFFU)
+
+/// @summary The largest number of nodes that can be addressed by a handle.
+#define TIMER_MAX_NODES              (size_t(TIMER_INDEX_MASK) - 1)
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Builds the handle for a node.
+/// @param wheel The timing wheel.
+/// @param index The index of the node.
+/// @return The handle to the node.
+static inline timer_handle_t make_handle(timer_wheel_t const *wheel, uint32_t index)
+{
+    return (uint32_t(wheel->Nodes[index].Generation) << 24) | (index + 1);
+}
+
+/// @summary Resolves a handle to the node of a pending timer.
+/// @param wheel The timing wheel.
+/// @param handle The handle to resolve.
+/// @return The index of the node, or TIMER_NIL if the handle is stale.
+static uint32_t resolve_handle(timer_wheel_t const *wheel, timer_handle_t handle)
+{
+    uint32_t index = (handle & TIMER_INDEX_MASK) - 1;
+    if (handle == TIMER_INVALID_HANDLE || index >= wheel->Used)
+        return TIMER_NIL;
+
+    timer_node_t const &node = wheel->Nodes[index];
+    if (node.Slot == TIMER_SLOT_FREE || node.Generation != uint8_t(handle >> 24))
+        return TIMER_NIL;
+
+    return index;
+}
+
+/// @summary Adds a node to the slot list selected by its deadline.
+/// @param wheel The timing wheel.
+/// @param index The index of the node, whose Deadline is not before Now.
+static void link_node(timer_wheel_t *wheel, uint32_t index)
+{
+    timer_node_t &node  = wheel->Nodes[index];
+    uint64_t      delta = node.Deadline - wheel->Now;
+    uint32_t      level = 0;
+    while (level + 1 < TIMER_WHEEL_LEVELS && delta >= (1ULL << (TIMER_WHEEL_BITS * (level + 1))))
+    {
+        level++;
+    }
+    uint32_t slot = level * TIMER_WHEEL_SLOTS + (uint32_t(node.Deadline >> (TIMER_WHEEL_BITS * level)) & TIMER_SLOT_MASK);
+    uint32_t head = wheel->Slots[slot];
+    node.Slot = uint16_t(slot);
+    node.Prev = TIMER_NIL;
+    node.Next = head;
+    if (head != TIMER_NIL)
+        wheel->Nodes[head].Prev = index;
+    wheel->Slots[slot] = index;
+}
+
+/// @summary Removes a node from its slot list.
+/// @param wheel The timing wheel.
+/// @param index The index of the node.
+static void unlink_node(timer_wheel_t *wheel, uint32_t index)
+{
+    timer_node_t &node = wheel->Nodes[index];
+    if (node.Prev != TIMER_NIL)
+        wheel->Nodes[node.Prev].Next = node.Next;
+    else
+        wheel->Slots[node.Slot] = node.Next;
+    if (node.Next != TIMER_NIL)
+        wheel->Nodes[node.Next].Prev = node.Prev;
+}
+
+/// @summary Returns a node to the free list, invalidating its handles.
+/// @param wheel The timing wheel.
+/// @param index The index of the node, which is not in any slot list.
+static void free_node(timer_wheel_t *wheel, uint32_t index)
+{
+    timer_node_t &node = wheel->Nodes[index];
+    node.Slot        = TIMER_SLOT_FREE;
+    node.Generation++;
+    node.Next        = wheel->FreeHead;
+    wheel->FreeHead  = index;
+    wheel->Count--;
+}
+
+/// @summary Moves every timer in a slot of an upper level to the levels below.
+/// @param wheel The timing wheel.
+/// @param slot The index of the slot.
+static void cascade_slot(timer_wheel_t *wheel, uint32_t slot)
+{
+    uint32_t index = wheel->Slots[slot];
+    wheel->Slots[slot] = TIMER_NIL;
+    while (index != TIMER_NIL)
+    {
+        uint32_t next = wheel->Nodes[index].Next;
+        link_node(wheel, index);
+        index = next;
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+bool timer_wheel_create(timer_wheel_t *wheel, size_t capacity)
+{
+    memset(wheel, 0, sizeof(timer_wheel_t));
+    wheel->FreeHead = TIMER_NIL;
+    for (size_t i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; ++i)
+    {
+        wheel->Slots[i] = TIMER_NIL;
+    }
+    return timer_wheel_reserve(wheel, capacity);
+}
+
+void timer_wheel_delete(timer_wheel_t *wheel)
+{
+    free(wheel->Batch);
+    free(wheel->Nodes);
+    wheel->Batch         = NULL;
+    wheel->BatchCapacity = 0;
+    wheel->Nodes         = NULL;
+    wheel->Capacity      = 0;
+    wheel->Used          = 0;
+    wheel->Count         = 0;
+    wheel->FreeHead      = TIMER_NIL;
+}
+
+bool timer_wheel_reserve(timer_wheel_t *wheel, size_t capacity)
+{
+    if (capacity <= wheel->Capacity)
+        return true;
+    if (capacity > TIMER_MAX_NODES)
+        return false;
+
+    timer_node_t *nodes = (timer_node_t*) realloc(wheel->Nodes, capacity * sizeof(timer_node_t));
+    if (nodes == NULL)
+        return false;
+
+    wheel->Nodes    = nodes;
+    wheel->Capacity = capacity;
+    return true;
+}
+
+void timer_wheel_register(timer_wheel_t *wheel, uint32_t kind, timer_fire_fn callback, void *context)
+{
+    if (kind < TIMER_MAX_KINDS)
+    {
+        wheel->Callbacks[kind] = callback;
+        wheel->Contexts [kind] = context;
+    }
+}
+
+timer_handle_t timer_wheel_schedule(timer_wheel_t *wheel, uint32_t kind, uint32_t payload, uint64_t delay)
+{
+    uint32_t index = wheel->FreeHead;
+    if (kind >= TIMER_MAX_KINDS)
+        return TIMER_INVALID_HANDLE;
+
+    if (index != TIMER_NIL)
+    {
+        wheel->FreeHead = wheel->Nodes[index].Next;
+    }
+    else
+    {
+        if (wheel->Used == wheel->Capacity && !timer_wheel_reserve(wheel, wheel->Capacity > 0 ? wheel->Capacity * 2 : 64))
+            return TIMER_INVALID_HANDLE;
+
+        index = uint32_t(wheel->Used++);
+        wheel->Nodes[index].Generation = 0;
+    }
+    if (delay < 1) delay = 1;
+    if (delay > TIMER_MAX_DELAY) delay = TIMER_MAX_DELAY;
+
+    timer_node_t &node = wheel->Nodes[index];
+    node.Deadline = wheel->Now + delay;
+    node.Payload  = payload;
+    node.Kind     = uint8_t(kind);
+    link_node(wheel, index);
+    wheel->Count++;
+    return make_handle(wheel, index);
+}
+
+bool timer_wheel_cancel(timer_wheel_t *wheel, timer_handle_t handle)
+{
+    uint32_t index = resolve_handle(wheel, handle);
+    if (index == TIMER_NIL)
+        return false;
+
+    unlink_node(wheel, index);
+    free_node(wheel, index);
+    return true;
+}
+
+uint64_t timer_wheel_remaining(timer_wheel_t const *wheel, timer_handle_t handle)
+{
+    uint32_t index = resolve_handle(wheel, handle);
+    if (index == TIMER_NIL)
+        return 0;
+
+    return wheel->Nodes[index].Deadline - wheel->Now;
+}
+
+size_t timer_wheel_advance(timer_wheel_t *wheel)
+{
+    wheel->Now++;
+
+    // bring down the timers of every level whose current slot just came due.
+    for (uint32_t level = 1; level < TIMER_WHEEL_LEVELS; ++level)
+    {
+        uint32_t shift = TIMER_WHEEL_BITS * level;
+        if ((wheel->Now & ((1ULL << shift) - 1)) != 0)
+            break;
+
+        cascade_slot(wheel, level * TIMER_WHEEL_SLOTS + (uint32_t(wheel->Now >> shift) & TIMER_SLOT_MASK));
+    }
+
+    // everything in the current level 0 slot expires now.
+    uint32_t slot = uint32_t(wheel->Now) & TIMER_SLOT_MASK;
+    uint32_t head = wheel->Slots[slot];
+    if (head == TIMER_NIL)
+        return 0;
+
+    wheel->Slots[slot] = TIMER_NIL;
+    size_t count = 0;
+    size_t kinds[TIMER_MAX_KINDS + 1];
+    memset(kinds, 0, sizeof(kinds));
+    for (uint32_t i = head; i != TIMER_NIL; i = wheel->Nodes[i].Next)
+    {
+        kinds[wheel->Nodes[i].Kind + 1]++;
+        count++;
+    }
+    if (count > wheel->BatchCapacity)
+    {
+        size_t    capacity = wheel->Capacity > count ? wheel->Capacity : count;
+        uint32_t *batch    = (uint32_t*) realloc(wheel->Batch, capacity * sizeof(uint32_t));
+        if (batch == NULL)
+        {
+            // put the timers back; they are retried on the next revolution.
+            wheel->Slots[slot] = head;
+            return 0;
+        }
+        wheel->Batch         = batch;
+        wheel->BatchCapacity = capacity;
+    }
+
+    // group the payloads by kind with a counting sort, then release the
+    // nodes so that the callbacks are free to schedule new timers.
+    for (uint32_t k = 1; k <= TIMER_MAX_KINDS; ++k)
+    {
+        kinds[k] += kinds[k - 1];
+    }
+    size_t offset[TIMER_MAX_KINDS];
+    memcpy(offset, kinds, sizeof(offset));
+    for (uint32_t i = head; i != TIMER_NIL; )
+    {
+        timer_node_t &node = wheel->Nodes[i];
+        uint32_t      next = node.Next;
+        wheel->Batch[offset[node.Kind]++] = node.Payload;
+        free_node(wheel, i);
+        i = next;
+    }
+    for (uint32_t k = 0; k < TIMER_MAX_KINDS; ++k)
+    {
+        if (kinds[k + 1] > kinds[k] && wheel->Callbacks[k] != NULL)
+        {
+            wheel->Callbacks[k](wheel->Batch + kinds[k], kinds[k + 1] - kinds[k], wheel->Contexts[k]);
+        }
+    }
+    return count;
+}
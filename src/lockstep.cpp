@@ -0,0 +1,536 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements deterministic lockstep play over UDP. Every packet sent
+/// to a peer carries all of the local input the peer has not acknowledged, as
+/// runs of identical ticks, each run delta-encoded against the previous one
+/// using exponential-Golomb codes. Mouse motion costs a few bits per change,
+/// and ticks with unchanged input cost a few bits per run rather than per tick.
+/// Tick numbers in the header are sent relative to one another, and the state
+/// hash only until the peer is known to have it.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <string.h>
+#include "math.hpp"
+#include "lockstep.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The value identifying a lockstep packet.
+#define LOCKSTEP_MAGIC               (0x4C53U)
+
+/// @summary The number of bits used to store the sender's player index.
+#define LOCKSTEP_PLAYER_BITS         (2U)
+
+/// @summary The number of low bits of the first tick in a packet that are
+/// sent. The receiver restores the rest from the input it already holds; the
+/// first tick is never more than LOCKSTEP_WINDOW ticks behind it.
+#define LOCKSTEP_TICK_BITS           (16U)
+
+/// @summary The order of the exponential-Golomb code used for the number of
+/// ticks in a packet.
+#define LOCKSTEP_COUNT_ORDER         (2U)
+
+/// @summary The order of the exponential-Golomb code used for the
+/// acknowledgement, sent relative to the first tick in the packet.
+#define LOCKSTEP_ACK_ORDER           (2U)
+
+/// @summary The order of the exponential-Golomb code used for the hashed
+/// tick, sent relative to the first tick in the packet.
+#define LOCKSTEP_HASH_ORDER          (4U)
+
+/// @summary The order of the exponential-Golomb code used for mouse deltas.
+#define LOCKSTEP_MOUSE_ORDER         (2U)
+
+/// @summary The order of the exponential-Golomb code used for key positions.
+#define LOCKSTEP_KEY_ORDER           (3U)
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Writes a stream of bits, least-significant bit first.
+struct bit_writer_t
+{
+    uint8_t *Data;         /// The destination buffer.
+    size_t   Capacity;     /// The size of the buffer, in bits.
+    size_t   Position;     /// The number of bits written.
+    bool     Overflow;     /// Set if a write did not fit.
+};
+
+/// @summary Reads a stream of bits written by a bit_writer_t.
+struct bit_reader_t
+{
+    uint8_t const *Data;   /// The source buffer.
+    size_t         Size;   /// The size of the buffer, in bits.
+    size_t         Position; /// The number of bits read.
+    bool           Overflow; /// Set if a read ran past the end of the buffer.
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Writes the low bits of a value.
+/// @param w The bit writer.
+/// @param value The value to write.
+/// @param n The number of bits to write, at most 32.
+static void write_bits(bit_writer_t *w, uint32_t value, uint32_t n)
+{
+    if (w->Position + n > w->Capacity)
+    {
+        w->Overflow = true;
+        return;
+    }
+    for (uint32_t i = 0; i < n; ++i, ++w->Position)
+    {
+        uint8_t mask = uint8_t(1U << (w->Position & 7));
+        if (value & (1U << i)) w->Data[w->Position >> 3] |=  mask;
+        else                   w->Data[w->Position >> 3] &= ~mask;
+    }
+}
+
+/// @summary Reads a value written by write_bits.
+/// @param r The bit reader.
+/// @param n The number of bits to read, at most 32.
+/// @return The value read, or 0 on overflow.
+static uint32_t read_bits(bit_reader_t *r, uint32_t n)
+{
+    if (r->Position + n > r->Size)
+    {
+        r->Overflow = true;
+        r->Position = r->Size;
+        return 0;
+    }
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < n; ++i, ++r->Position)
+    {
+        if (r->Data[r->Position >> 3] & (1U << (r->Position & 7)))
+            value |= 1U << i;
+    }
+    return value;
+}
+
+/// @summary Writes a value using an exponential-Golomb code of order k, which
+/// spends about 2 * log2(value / 2^k) + k + 1 bits, so small values are cheap.
+/// @param w The bit writer.
+/// @param value The value to write, less than 2^31.
+/// @param k The order of the code.
+static void write_golomb(bit_writer_t *w, uint32_t value, uint32_t k)
+{
+    uint64_t v = uint64_t(value) + (uint64_t(1) << k);
+    uint32_t n = 0;
+    while ((v >> (n + 1)) != 0) ++n;
+    write_bits(w, 0, n - k);
+    write_bits(w, 1, 1);
+    write_bits(w, uint32_t(v & ((uint64_t(1) << n) - 1)), n);
+}
+
+/// @summary Reads a value written by write_golomb.
+/// @param r The bit reader.
+/// @param k The order of the code.
+/// @return The value read, or 0 on overflow.
+static uint32_t read_golomb(bit_reader_t *r, uint32_t k)
+{
+    uint32_t zeros = 0;
+    while (read_bits(r, 1) == 0)
+    {
+        if (r->Overflow || ++zeros + k > 31)
+        {
+            r->Overflow = true;
+            return 0;
+        }
+    }
+    uint32_t n = zeros + k;
+    uint64_t v = (uint64_t(1) << n) | read_bits(r, n);
+    return uint32_t(v - (uint64_t(1) << k));
+}
+
+/// @summary Appends the bits written to one bit writer to another.
+/// @param w The bit writer to append to.
+/// @param src The bit writer holding the bits to append.
+static void write_stream(bit_writer_t *w, bit_writer_t const *src)
+{
+    bit_reader_t r = { src->Data, src->Position, 0, false };
+    while (r.Position < r.Size)
+    {
+        uint32_t n = (r.Size - r.Position) < 32 ? uint32_t(r.Size - r.Position) : 32U;
+        write_bits(w, read_bits(&r, n), n);
+    }
+}
+
+/// @summary Maps a signed value to an unsigned one so that values of small
+/// magnitude are small: 0, -1, 1, -2, 2 map to 0, 1, 2, 3, 4.
+static inline uint32_t zigzag(int32_t v)
+{
+    return (uint32_t(v) << 1) ^ uint32_t(v >> 31);
+}
+
+/// @summary Inverts zigzag().
+static inline int32_t unzigzag(uint32_t v)
+{
+    return int32_t(v >> 1) ^ -int32_t(v & 1);
+}
+
+/// @summary Checks whether two inputs are identical.
+static bool input_equal(lockstep_input_t const &a, lockstep_input_t const &b)
+{
+    return a.MouseX == b.MouseX && a.MouseY == b.MouseY &&
+           a.MouseButtons == b.MouseButtons && a.Modifiers == b.Modifiers &&
+           memcmp(a.Keys, b.Keys, sizeof(a.Keys)) == 0;
+}
+
+/// @summary Writes an input as a set of changes from a previous input. Each
+/// group of fields costs one bit when unchanged.
+/// @param w The bit writer.
+/// @param cur The input to write.
+/// @param prev The input the reader already holds.
+static void write_input(bit_writer_t *w, lockstep_input_t const &cur, lockstep_input_t const &prev)
+{
+    bool mouse   = cur.MouseX != prev.MouseX || cur.MouseY != prev.MouseY;
+    bool buttons = cur.MouseButtons != prev.MouseButtons || cur.Modifiers != prev.Modifiers;
+    bool keys    = memcmp(cur.Keys, prev.Keys, sizeof(cur.Keys)) != 0;
+    write_bits(w, mouse, 1);
+    if (mouse)
+    {
+        write_golomb(w, zigzag(int32_t(cur.MouseX) - int32_t(prev.MouseX)), LOCKSTEP_MOUSE_ORDER);
+        write_golomb(w, zigzag(int32_t(cur.MouseY) - int32_t(prev.MouseY)), LOCKSTEP_MOUSE_ORDER);
+    }
+    write_bits(w, buttons, 1);
+    if (buttons)
+    {
+        write_bits(w, cur.MouseButtons ^ prev.MouseButtons, 8);
+        write_bits(w, cur.Modifiers    ^ prev.Modifiers,    8);
+    }
+    write_bits(w, keys, 1);
+    if (keys)
+    {
+        // keys are sent as the positions of the bits that toggled, each
+        // relative to the previous one.
+        uint32_t count = 0;
+        for (size_t i = 0; i < INPUT_KEY_WORDS; ++i)
+        {
+            uint32_t x = cur.Keys[i] ^ prev.Keys[i];
+            while (x) { x &= x - 1; ++count; }
+        }
+        write_golomb(w, count - 1, 0);
+        uint32_t last = 0;
+        for (uint32_t bit = 0; bit < INPUT_KEY_WORDS * 32; ++bit)
+        {
+            if ((cur.Keys[bit >> 5] ^ prev.Keys[bit >> 5]) & (1U << (bit & 31)))
+            {
+                write_golomb(w, bit - last, LOCKSTEP_KEY_ORDER);
+                last = bit;
+            }
+        }
+    }
+}
+
+/// @summary Reads an input written by write_input.
+/// @param r The bit reader.
+/// @param cur On return, the input read.
+/// @param prev The input the writer encoded against.
+static void read_input(bit_reader_t *r, lockstep_input_t &cur, lockstep_input_t const &prev)
+{
+    cur = prev;
+    if (read_bits(r, 1))
+    {
+        cur.MouseX = int16_t(int32_t(prev.MouseX) + unzigzag(read_golomb(r, LOCKSTEP_MOUSE_ORDER)));
+        cur.MouseY = int16_t(int32_t(prev.MouseY) + unzigzag(read_golomb(r, LOCKSTEP_MOUSE_ORDER)));
+    }
+    if (read_bits(r, 1))
+    {
+        cur.MouseButtons ^= uint8_t(read_bits(r, 8));
+        cur.Modifiers    ^= uint8_t(read_bits(r, 8));
+    }
+    if (read_bits(r, 1))
+    {
+        uint32_t count = read_golomb(r, 0) + 1;
+        uint32_t bit   = 0;
+        for (uint32_t i = 0; i < count && !r->Overflow; ++i)
+        {
+            bit += read_golomb(r, LOCKSTEP_KEY_ORDER);
+            if (bit >= INPUT_KEY_WORDS * 32)
+            {
+                r->Overflow = true;
+                break;
+            }
+            cur.Keys[bit >> 5] ^= 1U << (bit & 31);
+        }
+    }
+}
+
+/// @summary Records a divergence if a hash reported by another instance does
+/// not match the local hash for the same tick.
+/// @param ls The session.
+/// @param tick The tick that was hashed.
+/// @param hash The hash reported by the other instance.
+static void compare_hash(lockstep_t *ls, uint32_t tick, uint64_t hash)
+{
+    size_t slot = (tick / LOCKSTEP_HASH_INTERVAL) % LOCKSTEP_HASH_HISTORY;
+    if (tick == 0 || ls->HashTicks[slot] != tick)
+        return;
+    if (ls->Hashes[slot] != hash && (ls->DesyncTick == 0 || tick < ls->DesyncTick))
+        ls->DesyncTick = tick;
+}
+
+/// @summary Sends all unacknowledged local input to another instance. The
+/// most recent local state hash is included until the instance acknowledges
+/// input sent after it, and omitted from then on.
+/// @param ls The session.
+/// @param to The index of the player controlled by the instance.
+static void send_packet(lockstep_t *ls, size_t to)
+{
+    uint8_t                  data[NET_MAX_DATAGRAM];
+    uint8_t                  body[NET_MAX_DATAGRAM];
+    lockstep_player_t       &peer  = ls->Players[to];
+    lockstep_player_t const &local = ls->Players[ls->LocalPlayer];
+    lockstep_input_t  const *ring  = ls->Inputs[ls->LocalPlayer];
+    bit_writer_t             w     = { data, sizeof(data) * 8, 0, false };
+
+    // header: the first tick sent, the acknowledgement, and the most recent
+    // local state hash if the peer may not have it yet. a packet carrying
+    // input past HashMark was sent after the hash was, so it carried it too.
+    size_t latest = 0;
+    for (size_t i = 1; i < LOCKSTEP_HASH_HISTORY; ++i)
+    {
+        if (ls->HashTicks[i] > ls->HashTicks[latest])
+            latest = i;
+    }
+    uint32_t const hash_tick = ls->HashTicks[latest];
+    if (hash_tick != peer.HashSent)
+    {
+        peer.HashSent = hash_tick;
+        peer.HashMark = local.Received;
+    }
+    bool     const hash  = hash_tick != 0 && peer.Acked <= peer.HashMark;
+    uint32_t const first = peer.Acked;
+    uint32_t const end   = local.Received;
+    write_bits  (&w, LOCKSTEP_MAGIC, 16);
+    write_bits  (&w, uint32_t(ls->LocalPlayer), LOCKSTEP_PLAYER_BITS);
+    write_bits  (&w, first & ((1U << LOCKSTEP_TICK_BITS) - 1), LOCKSTEP_TICK_BITS);
+    write_golomb(&w, zigzag(int32_t(peer.Received - first)), LOCKSTEP_ACK_ORDER);
+    write_bits  (&w, hash, 1);
+    if (hash)
+    {
+        write_golomb(&w, zigzag(int32_t(first - hash_tick)), LOCKSTEP_HASH_ORDER);
+        write_bits  (&w, uint32_t(ls->Hashes[latest]), 32);
+        write_bits  (&w, uint32_t(ls->Hashes[latest] >> 32), 32);
+    }
+
+    // body: runs of identical input starting at the first unacknowledged
+    // tick, written separately since the header gives the number of ticks.
+    // the count is at most LOCKSTEP_WINDOW, which codes in under 32 bits.
+    lockstep_input_t zero;
+    memset(&zero, 0, sizeof(zero));
+    bit_writer_t            b    = { body, w.Capacity - w.Position - 32, 0, false };
+    uint32_t                sent = 0;
+    lockstep_input_t const *prev = first > 0 ? &ring[(first - 1) & (LOCKSTEP_WINDOW - 1)] : &zero;
+    while (first + sent < end && !b.Overflow)
+    {
+        lockstep_input_t const *cur = &ring[(first + sent) & (LOCKSTEP_WINDOW - 1)];
+        uint32_t run = 1;
+        while (first + sent + run < end && input_equal(ring[(first + sent + run) & (LOCKSTEP_WINDOW - 1)], *cur))
+            ++run;
+
+        size_t mark = b.Position;
+        write_golomb(&b, run - 1, 0);
+        write_input (&b, *cur, *prev);
+        if (b.Overflow)
+        {
+            b.Position = mark;
+            break;
+        }
+        sent += run;
+        prev  = cur;
+    }
+    write_golomb(&w, sent, LOCKSTEP_COUNT_ORDER);
+    write_stream(&w, &b);
+    if (udp_send(&ls->Socket, peer.Address, data, (w.Position + 7) / 8))
+        ls->PacketsSent++;
+}
+
+/// @summary Processes a packet received from another instance.
+/// @param ls The session.
+/// @param from The endpoint the packet was received from.
+/// @param data The packet payload.
+/// @param size The size of the payload, in bytes.
+static void recv_packet(lockstep_t *ls, net_address_t const &from, uint8_t const *data, size_t size)
+{
+    bit_reader_t r = { data, size * 8, 0, false };
+    if (read_bits(&r, 16) != LOCKSTEP_MAGIC)
+        return;
+
+    size_t sender = read_bits(&r, LOCKSTEP_PLAYER_BITS);
+    if (r.Overflow || sender >= ls->PlayerCount || sender == ls->LocalPlayer)
+        return;
+    if (!net_address_equal(from, ls->Players[sender].Address))
+        return;
+
+    // the first tick is at most the number of ticks held from the sender,
+    // and within 2^LOCKSTEP_TICK_BITS of it.
+    lockstep_player_t &peer  = ls->Players[sender];
+    uint32_t           low   = read_bits(&r, LOCKSTEP_TICK_BITS);
+    uint32_t           first = peer.Received - ((peer.Received - low) & ((1U << LOCKSTEP_TICK_BITS) - 1));
+    uint32_t           ack   = first + uint32_t(unzigzag(read_golomb(&r, LOCKSTEP_ACK_ORDER)));
+    if (read_bits(&r, 1))
+    {
+        uint32_t tick = first - uint32_t(unzigzag(read_golomb(&r, LOCKSTEP_HASH_ORDER)));
+        uint64_t lo   = read_bits(&r, 32);
+        uint64_t hi   = read_bits(&r, 32);
+        if (!r.Overflow && tick > peer.HashTick)
+        {
+            peer.HashTick = tick;
+            peer.Hash     = lo | (hi << 32);
+            compare_hash(ls, peer.HashTick, peer.Hash);
+        }
+    }
+    if (r.Overflow)
+        return;
+    if (ack > peer.Acked && ack <= ls->Players[ls->LocalPlayer].Received)
+        peer.Acked = ack;
+
+    // the runs are encoded against the input for the tick before the first,
+    // which must still be in the window.
+    uint32_t count = read_golomb(&r, LOCKSTEP_COUNT_ORDER);
+    if (r.Overflow || first > peer.Received || (first > 0 && first - 1 + LOCKSTEP_WINDOW < peer.Received))
+        return;
+
+    lockstep_input_t *ring = ls->Inputs[sender];
+    lockstep_input_t  prev;
+    lockstep_input_t  cur;
+    if (first > 0) prev = ring[(first - 1) & (LOCKSTEP_WINDOW - 1)];
+    else memset(&prev, 0, sizeof(prev));
+    uint32_t t = first;
+    while (t < first + count)
+    {
+        uint32_t run = read_golomb(&r, 0) + 1;
+        read_input(&r, cur, prev);
+        if (r.Overflow || t + run > first + count)
+            return;
+
+        for (uint32_t i = 0; i < run; ++i, ++t)
+        {
+            if (t < peer.Received)
+                continue;
+            if (t >= ls->Tick + LOCKSTEP_WINDOW)
+                return;
+            ring[t & (LOCKSTEP_WINDOW - 1)] = cur;
+            peer.Received = t + 1;
+        }
+        prev = cur;
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void lockstep_input_from_snapshot(lockstep_input_t *dst, input_snapshot_t const *src)
+{
+    dst->MouseX       = int16_t(lrintf(clamp(src->MouseX, -32768.0f, 32767.0f)));
+    dst->MouseY       = int16_t(lrintf(clamp(src->MouseY, -32768.0f, 32767.0f)));
+    dst->MouseButtons = uint8_t(src->MouseState);
+    dst->Modifiers    = uint8_t(src->KeyboardModifiers);
+    memcpy(dst->Keys, src->KeyboardState, sizeof(dst->Keys));
+}
+
+void lockstep_input_to_snapshot(input_snapshot_t *dst, lockstep_input_t const *src)
+{
+    dst->MouseX            = float(src->MouseX);
+    dst->MouseY            = float(src->MouseY);
+    dst->MouseState        = src->MouseButtons;
+    dst->KeyboardModifiers = src->Modifiers;
+    memcpy(dst->KeyboardState, src->Keys, sizeof(src->Keys));
+}
+
+bool lockstep_create(lockstep_t *ls, net_address_t const *endpoints, size_t player_count, size_t local_player, uint32_t delay)
+{
+    memset(ls, 0, sizeof(lockstep_t));
+    ls->Socket.Handle = -1;
+    if (player_count < 1 || player_count > LOCKSTEP_MAX_PLAYERS || local_player >= player_count || delay >= LOCKSTEP_WINDOW / 2)
+        return false;
+    if (!udp_open(&ls->Socket, endpoints[local_player].Port))
+        return false;
+
+    // every player's input for the first delay ticks is implicitly empty.
+    ls->PlayerCount = player_count;
+    ls->LocalPlayer = local_player;
+    ls->Delay       = delay;
+    for (size_t i = 0; i < player_count; ++i)
+    {
+        ls->Players[i].Address  = endpoints[i];
+        ls->Players[i].Received = delay;
+        ls->Players[i].Acked    = delay;
+        ls->Players[i].LastSend = -LOCKSTEP_SEND_PERIOD;
+    }
+    return true;
+}
+
+void lockstep_delete(lockstep_t *ls)
+{
+    udp_close(&ls->Socket);
+    ls->PlayerCount = 0;
+}
+
+bool lockstep_submit(lockstep_t *ls, lockstep_input_t const *input)
+{
+    // the input a peer has not acknowledged, and the tick before it, must
+    // stay in the window so it can be resent.
+    lockstep_player_t &local = ls->Players[ls->LocalPlayer];
+    uint32_t           t     = local.Received;
+    for (size_t i = 0; i < ls->PlayerCount; ++i)
+    {
+        if (i != ls->LocalPlayer && t + 1 >= ls->Players[i].Acked + LOCKSTEP_WINDOW)
+            return false;
+    }
+    if (t >= ls->Tick + LOCKSTEP_WINDOW)
+        return false;
+
+    ls->Inputs[ls->LocalPlayer][t & (LOCKSTEP_WINDOW - 1)] = *input;
+    local.Received = t + 1;
+    return true;
+}
+
+bool lockstep_ready(lockstep_t *ls, uint32_t tick)
+{
+    ls->Tick = tick;
+    for (size_t i = 0; i < ls->PlayerCount; ++i)
+    {
+        if (ls->Players[i].Received <= tick)
+            return false;
+    }
+    return true;
+}
+
+void lockstep_submit_hash(lockstep_t *ls, uint32_t tick, uint64_t hash)
+{
+    size_t slot = (tick / LOCKSTEP_HASH_INTERVAL) % LOCKSTEP_HASH_HISTORY;
+    ls->HashTicks[slot] = tick;
+    ls->Hashes[slot]    = hash;
+    for (size_t i = 0; i < ls->PlayerCount; ++i)
+    {
+        if (i != ls->LocalPlayer && ls->Players[i].HashTick == tick)
+            compare_hash(ls, tick, ls->Players[i].Hash);
+    }
+}
+
+void lockstep_update(lockstep_t *ls, double now)
+{
+    uint8_t       data[NET_MAX_DATAGRAM];
+    net_address_t from;
+    size_t        size;
+    while ((size = udp_recv(&ls->Socket, &from, data, sizeof(data))) > 0)
+    {
+        recv_packet(ls, from, data, size);
+    }
+    for (size_t i = 0; i < ls->PlayerCount; ++i)
+    {
+        if (i != ls->LocalPlayer && now - ls->Players[i].LastSend >= LOCKSTEP_SEND_PERIOD)
+        {
+            send_packet(ls, i);
+            ls->Players[i].LastSend = now;
+        }
+    }
+}
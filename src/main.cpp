@@ -10,14 +10,24 @@
 ////////////////*/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "math.hpp"
 #include "input.hpp"
 #include "display.hpp"
 #include "entity.hpp"
 #include "player.hpp"
+#include "blackhole.hpp"
+#include "enemy.hpp"
+#include "particle.hpp"
+#include "grid.hpp"
+#include "events.hpp"
 #include "ll_sprite.hpp"
 #include "ll_shader.hpp"
+#include "ll_task.hpp"
+#include "ll_snapshot.hpp"
+#include "ll_budget.hpp"
+#include "lockstep.hpp"
 
 /*/////////////////
 //   Constants   //
@@ -28,13 +38,53 @@
 #define GW_MIN_TIMESTEP    0.000001
 #define GW_MAX_TIMESTEP    0.25
 #define GW_SIM_TIMESTEP    1.0 / 120.0
+#define GW_REWIND_KEY      GLFW_KEY_BACKSPACE
+#define GW_FRAME_BUDGET    0.008
+#define GW_MAX_CATCHUP     8
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary The optional work performed at one degradation level of the frame
+/// budget. Level 0 is full quality; each level sheds more.
+struct quality_level_t
+{
+    float    BurstScale;   /// The fraction of requested particles emitted by bursts.
+    uint32_t GridSettle;   /// The ticks a disturbed grid band stays at full rate.
+};
+
+/// @summary The degradation levels, in order of increasing savings.
+static const quality_level_t QUALITY_LEVELS[] =
+{
+    { 1.0f , GRID_LOD_SETTLE },
+    { 0.5f , GRID_LOD_SETTLE },
+    { 0.5f , 0 },
+    { 0.25f, 0 }
+};
+
+/// @summary The number of entries in QUALITY_LEVELS.
+#define GW_QUALITY_LEVELS  (sizeof(QUALITY_LEVELS) / sizeof(QUALITY_LEVELS[0]))
 
 /*///////////////
 //   Globals   //
 ///////////////*/
-static EntityManager  *gEntityManager  = NULL;
-static DisplayManager *gDisplayManager = NULL;
-static InputManager   *gInputManager   = NULL;
+static EntityManager   *gEntityManager   = NULL;
+static EnemyManager    *gEnemyManager    = NULL;
+static DisplayManager  *gDisplayManager  = NULL;
+static InputManager    *gInputManager    = NULL;
+static ParticleManager *gParticleManager = NULL;
+static GridManager     *gGridManager     = NULL;
+static EventBus        *gEventBus        = NULL;
+static task_pool_t     *gTaskPool        = NULL;
+static snapshot_ring_t  gSnapshots       = { NULL, 0, 0 };
+static snapshot_buffer_t gHashState      = { SNAPSHOT_INVALID_TICK, NULL, 0, 0, 0 };
+static bool             gRewind          = false;
+static lockstep_t      *gLockstep        = NULL;
+static lockstep_t       gSession;
+static input_snapshot_t gPlayerInput[LOCKSTEP_MAX_PLAYERS];
+static input_snapshot_t gLocalInput;
+static size_t           gPlayerCount     = 1;
+static frame_budget_t   gBudget;
 
 /*///////////////////////
 //   Local Functions   //
@@ -76,6 +126,83 @@ static void gl_arb_debug(
 }
 #endif
 
+/// @summary Parses the command line. Networked play is requested with:
+///     gw --lockstep <player> <endpoint> <endpoint> [...] [--delay <ticks>]
+/// where the endpoints, of the form a.b.c.d:port, are listed in player order
+/// and are identical on every instance, and player is the local player index.
+/// Single-player games started with --rewind save every tick, so that holding
+/// the rewind key steps back through them.
+/// @param argc The number of command-line arguments.
+/// @param argv The command-line arguments.
+/// @return true if the command line is valid.
+static bool parse_command_line(int argc, char **argv)
+{
+    net_address_t endpoints[LOCKSTEP_MAX_PLAYERS];
+    size_t        count = 0;
+    long          local = -1;
+    long          delay = LOCKSTEP_DEFAULT_DELAY;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc)
+        {
+            delay = strtol(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--rewind") == 0)
+        {
+            gRewind = true;
+        }
+        else if (strcmp(argv[i], "--lockstep") == 0 && i + 1 < argc)
+        {
+            local = strtol(argv[++i], NULL, 10);
+            while (i + 1 < argc && count < LOCKSTEP_MAX_PLAYERS && net_parse_address(argv[i + 1], &endpoints[count]))
+            {
+                count++;
+                i++;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unrecognized argument \"%s\".\n", argv[i]);
+            return false;
+        }
+    }
+    if (local < 0)
+        return true;
+
+    if (gRewind)
+    {
+        fprintf(stderr, "ERROR: --rewind cannot be combined with --lockstep.\n");
+        return false;
+    }
+    if (count < 2 || size_t(local) >= count || delay < 0)
+    {
+        fprintf(stderr, "ERROR: Usage: --lockstep <player> <endpoint> <endpoint> [...] [--delay <ticks>]\n");
+        return false;
+    }
+    if (!lockstep_create(&gSession, endpoints, count, size_t(local), uint32_t(delay)))
+    {
+        fprintf(stderr, "ERROR: Cannot start lockstep session on port %u.\n", unsigned(endpoints[local].Port));
+        return false;
+    }
+    gLockstep = &gSession;
+    return true;
+}
+
+/// @summary Copies the local device input, mapping the cursor from framebuffer
+/// pixels into world units so that it means the same thing on every instance
+/// whatever the size of the window.
+/// @param dst On return, the local input in world units.
+static void local_input(input_snapshot_t *dst)
+{
+    DisplayManager *dm = gDisplayManager;
+    *dst = *gInputManager->GetCurrentSnapshot();
+    if (dm->GetViewportWidth() > 0.0f && dm->GetViewportHeight() > 0.0f)
+    {
+        dst->MouseX *= dm->GetWorldWidth()  / dm->GetViewportWidth();
+        dst->MouseY *= dm->GetWorldHeight() / dm->GetViewportHeight();
+    }
+}
+
 /// @summary Executes all of the logic associated with game user input. This
 /// is also where we would run user interface logic. Runs once per application tick.
 /// @param currentTime The current absolute time, in seconds. This represents
@@ -84,7 +211,42 @@ static void gl_arb_debug(
 static void input(double currentTime, double elapsedTime)
 {
     gInputManager->Update(currentTime, elapsedTime);
-    gEntityManager->Input(currentTime, elapsedTime, gInputManager);
+    local_input(&gLocalInput);
+    if (gLockstep == NULL)
+    {
+        // during networked play, entities receive input once per tick.
+        gInputManager->SetPlayerSnapshot(0, &gLocalInput);
+        gEntityManager->Input(currentTime, elapsedTime, gInputManager);
+    }
+}
+
+/// @summary Schedules the local input and applies the input of every player
+/// for the next tick of a lockstep session.
+/// @param tick The index of the tick about to be simulated.
+/// @param simTime The simulation time at the start of the tick, in seconds.
+/// @param step The length of the tick, in seconds.
+/// @return true if input from every player is available and the tick can be
+/// simulated, or false to wait.
+static bool network_input(uint64_t tick, double simTime, double step)
+{
+    lockstep_t *ls = gLockstep;
+    if (ls->Players[ls->LocalPlayer].Received == tick + ls->Delay)
+    {
+        lockstep_input_t local;
+        lockstep_input_from_snapshot(&local, &gLocalInput);
+        lockstep_submit(ls, &local);
+    }
+    if (!lockstep_ready(ls, uint32_t(tick)))
+        return false;
+
+    for (size_t i = 0; i < ls->PlayerCount; ++i)
+    {
+        gPlayerInput[i] = gLocalInput;
+        lockstep_input_to_snapshot(&gPlayerInput[i], lockstep_get_input(ls, i, uint32_t(tick)));
+        gInputManager->SetPlayerSnapshot(int(i), &gPlayerInput[i]);
+    }
+    gEntityManager->Input(simTime, step, gInputManager);
+    return true;
 }
 
 /// @summary Executes a single game simulation tick to move all game entities.
@@ -95,6 +257,78 @@ static void input(double currentTime, double elapsedTime)
 static void simulate(double currentTime, double elapsedTime)
 {
     gEntityManager->Update(currentTime, elapsedTime);
+    gEnemyManager->ApplyForceField(gEntityManager->GetForceField(), elapsedTime);
+    gEnemyManager->Update(currentTime, elapsedTime);
+    gEventBus->Dispatch();
+    gParticleManager->ApplyForceField(gEntityManager->GetForceField(), elapsedTime);
+    gParticleManager->Update(currentTime, elapsedTime);
+    gGridManager->Update(currentTime, elapsedTime);
+}
+
+/// @summary Applies one of the degradation levels of the frame budget.
+/// @param level The index of the level in QUALITY_LEVELS.
+static void apply_quality(uint32_t level)
+{
+    quality_level_t const &q = QUALITY_LEVELS[level < GW_QUALITY_LEVELS ? level : GW_QUALITY_LEVELS - 1];
+    gParticleManager->SetBurstScale(q.BurstScale);
+    gGridManager->SetLodPolicy(GRID_LOD_PERIOD, q.GridSettle);
+}
+
+/// @summary Saves the state of the simulation at the end of a tick, along
+/// with the input applied to each player during the tick.
+/// @param buf The snapshot buffer to write to.
+/// @param simTime The simulation time at the end of the tick, in seconds.
+/// @return true if the state was saved.
+static bool save_state(snapshot_buffer_t *buf, double simTime)
+{
+    bool ok = snapshot_write_value(buf, simTime);
+    ok = ok && snapshot_write_value(buf, uint32_t(gPlayerCount));
+    for (size_t i = 0; ok && i < gPlayerCount; ++i)
+    {
+        // the padding must be zero for the hash to match between peers.
+        lockstep_input_t input;
+        memset(&input, 0, sizeof(input));
+        lockstep_input_from_snapshot(&input, gInputManager->GetPlayerSnapshot(int(i)));
+        ok = snapshot_write_value(buf, input);
+    }
+    ok = ok && gEntityManager->Save(buf);
+    ok = ok && gEnemyManager->Save(buf);
+    ok = ok && gParticleManager->Save(buf);
+    ok = ok && gGridManager->Save(buf);
+    return ok;
+}
+
+/// @summary Saves the state at the end of a tick into the rewind ring.
+/// @param tick The index of the tick that just completed.
+/// @param simTime The simulation time at the end of the tick, in seconds.
+static void save_rewind(uint64_t tick, double simTime)
+{
+    if (!save_state(snapshot_ring_save(&gSnapshots, tick), simTime))
+        snapshot_ring_truncate(&gSnapshots, tick - 1);
+}
+
+/// @summary Rewinds the simulation to the end of a previously saved tick.
+/// Saved ticks after it are discarded.
+/// @param tick The index of the tick to restore.
+/// @param simTime On return, the simulation time at the end of the tick.
+/// @return true if the tick was restored.
+static bool restore_state(uint64_t tick, double *simTime)
+{
+    snapshot_buffer_t *buf = snapshot_ring_find(&gSnapshots, tick);
+    if (buf == NULL)
+        return false;
+
+    // the recorded input is only needed to replay the tick, so skip it.
+    uint32_t players = 0;
+    bool ok = snapshot_read_value(buf, *simTime);
+    ok = ok && snapshot_read_value(buf, players);
+    ok = ok && snapshot_view(buf, players * sizeof(lockstep_input_t)) != NULL;
+    ok = ok && gEntityManager->Restore(buf);
+    ok = ok && gEnemyManager->Restore(buf);
+    ok = ok && gParticleManager->Restore(buf);
+    ok = ok && gGridManager->Restore(buf);
+    snapshot_ring_truncate(&gSnapshots, tick);
+    return ok;
 }
 
 /// @summary Submits a single frame to the GPU for rendering. Runs once per
@@ -121,8 +355,11 @@ static void render(double currentTime, double elapsedTime, double t, int width,
     dm->Clear(0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0);
     dm->BeginFrame();
     batch->SetBlendModeAlpha();
+    gGridManager->Draw(currentTime, elapsedTime, dm);
     font->Draw("Hello, world!", 0, 0, 1, rgba, 5.0f, 5.0f, batch);
     gEntityManager->Draw(currentTime, elapsedTime, dm);
+    gEnemyManager->Draw(currentTime, elapsedTime, dm);
+    gParticleManager->Draw(currentTime, elapsedTime, dm);
     dm->EndFrame();
 }
 
@@ -133,8 +370,10 @@ int main(int argc, char **argv)
 {
     GLFWwindow *window = NULL;
 
-    UNUSED_ARG(argc);
-    UNUSED_ARG(argv);
+    if (!parse_command_line(argc, argv))
+    {
+        exit(EXIT_FAILURE);
+    }
 
     // initialize GLFW, our platform abstraction library.
     glfwSetErrorCallback(glfw_error);
@@ -186,16 +425,32 @@ int main(int argc, char **argv)
     }
 #endif
 
-    // initialize global managers:
+    // initialize global managers. the task pool is shared by any
+    // system that splits large data-parallel loops across cores.
+    gTaskPool = task_pool_create();
+    gEventBus = new EventBus();
     gDisplayManager = new DisplayManager();
     gDisplayManager->Init(window);
     gInputManager = new InputManager();
     gInputManager->Init(window);
+    gParticleManager = new ParticleManager(PARTICLE_CAPACITY, gTaskPool);
+    gParticleManager->Init(gDisplayManager);
+    gGridManager = new GridManager(GRID_COLUMNS, GRID_ROWS, gTaskPool);
+    gGridManager->Init(gDisplayManager);
+    gEnemyManager = new EnemyManager(ENEMY_CAPACITY, gTaskPool);
+    gEnemyManager->Init(gDisplayManager);
 
-    Player *player = new Player(0);
-    player->Init(gDisplayManager);
-    gEntityManager = new EntityManager();
-    gEntityManager->AddEntity(player);
+    gEntityManager = new EntityManager(GW_SIM_TIMESTEP);
+    gPlayerCount   = gLockstep != NULL ? gLockstep->PlayerCount : 1;
+    for (size_t i = 0; i < gPlayerCount; ++i)
+    {
+        gEntityManager->AddEntity(new Player(int(i)));
+    }
+    gEntityManager->AddEntity(new BlackHole(gDisplayManager->GetWorldWidth() * 0.25f, gDisplayManager->GetWorldHeight() * 0.25f));
+    if (gRewind)
+    {
+        snapshot_ring_create(&gSnapshots, SNAPSHOT_DEFAULT_FRAMES, SNAPSHOT_DEFAULT_BUDGET);
+    }
 
     // game loop setup and run:
     const double   Step = GW_SIM_TIMESTEP;
@@ -204,10 +459,20 @@ int main(int argc, char **argv)
     double elapsedTime  = 0.0;
     double accumulator  = 0.0;
     double simTime      = 0.0;
+    uint64_t simTick    = 0;
+    bool   desynced     = false;
     double t            = 0.0;
+    uint32_t quality    = 0;
     int    width        = 0;
     int    height       = 0;
 
+    // particles and the grid are part of the state compared between peers,
+    // so a lockstep session may drop ticks under load but never degrade.
+    frame_budget_init(&gBudget, Step, GW_FRAME_BUDGET, GW_MAX_CATCHUP, gLockstep != NULL ? 0 : GW_QUALITY_LEVELS - 1);
+    if (gRewind)
+    {
+        save_rewind(simTick, simTime);
+    }
     while (!glfwWindowShouldClose(window))
     {
         // retrieve the current framebuffer size, which
@@ -233,13 +498,68 @@ int main(int argc, char **argv)
 
         // execute the simulation zero or more times per-frame.
         // the simulation runs at a fixed timestep.
-        while (accumulator >= Step)
+        // with --rewind, the state at the end of every tick is saved, and
+        // holding the rewind key steps backwards through the saved ticks
+        // instead. during networked play, the simulation waits for every
+        // player's input, and the state is saved and hashed only on the
+        // ticks compared between peers. the frame budget limits the number
+        // of catch-up steps.
+        if (gLockstep != NULL)
         {
-            // @todo: swap game state buffers here.
-            // pass the current game state to simulate.
-            simulate(simTime, Step);
+            lockstep_update(gLockstep, currentTime);
+        }
+        uint32_t steps     = frame_budget_begin(&gBudget, accumulator);
+        double   simStart  = glfwGetTime();
+        double   stepStart = simStart;
+        for (uint32_t i = 0; i < steps; ++i)
+        {
+            if (gLockstep != NULL)
+            {
+                if (!network_input(simTick, simTime, Step))
+                {
+                    accumulator = Step;
+                    break;
+                }
+                simulate(simTime, Step);
+                simTime += Step;
+                if (++simTick % LOCKSTEP_HASH_INTERVAL == 0)
+                {
+                    gHashState.Size = 0;
+                    if (save_state(&gHashState, simTime))
+                        lockstep_submit_hash(gLockstep, uint32_t(simTick), snapshot_hash(&gHashState));
+                }
+            }
+            else if (gRewind && gInputManager->IsKeyDown(GW_REWIND_KEY))
+            {
+                if (simTick > 0 && restore_state(simTick - 1, &simTime))
+                    simTick--;
+            }
+            else
+            {
+                simulate(simTime, Step);
+                simTime += Step;
+                simTick++;
+                if (gRewind)
+                {
+                    save_rewind(simTick, simTime);
+                }
+            }
             accumulator -= Step;
-            simTime += Step;
+
+            double stepEnd = glfwGetTime();
+            frame_budget_step(&gBudget, stepEnd - stepStart);
+            stepStart = stepEnd;
+        }
+        uint32_t level = frame_budget_end(&gBudget, glfwGetTime() - simStart);
+        if (level != quality)
+        {
+            apply_quality(level);
+            quality = level;
+        }
+        if (gLockstep != NULL && gLockstep->DesyncTick != 0 && !desynced)
+        {
+            fprintf(stderr, "ERROR: Simulation diverged from a peer at tick %u.\n", gLockstep->DesyncTick);
+            desynced = true;
         }
 
         // interpolate display state.
@@ -247,15 +567,37 @@ int main(int argc, char **argv)
         // state = currentState * t + previousState * (1.0 - t);
         render(currentTime, elapsedTime, t, width, height);
 
-        // now present the current frame and process OS events.
+        // now present the current frame and process OS events. controller
+        // state must be queried on this thread, after GLFW has processed
+        // any hotplug events.
         glfwSwapBuffers(window);
         glfwPollEvents();
+        input_controller_poll();
     }
 
     // teardown global managers.
+    if (gLockstep != NULL)
+    {
+        fprintf(stdout, "Lockstep: sent %llu bytes in %llu packets over %.1f seconds.\n",
+            (unsigned long long) gLockstep->Socket.BytesSent,
+            (unsigned long long) gLockstep->PacketsSent, simTime);
+        lockstep_delete(gLockstep);
+        gLockstep = NULL;
+    }
+    fprintf(stdout, "Budget: %llu of %llu frames over budget, %llu under, %llu ticks dropped, %.3f ms per step.\n",
+        (unsigned long long) gBudget.OverBudget, (unsigned long long) gBudget.Frames,
+        (unsigned long long) gBudget.UnderBudget, (unsigned long long) gBudget.Dropped, gBudget.StepCost * 1000.0);
+    fprintf(stdout, "Grid: level of detail skipped %.1f%% of point updates.\n", gGridManager->GetLodSkipped() * 100.0f);
+    snapshot_ring_delete(&gSnapshots);
+    free(gHashState.Data);
     delete gEntityManager;
+    delete gEnemyManager;
+    delete gParticleManager;
+    delete gGridManager;
+    delete gEventBus;
     delete gDisplayManager;
     delete gInputManager;
+    task_pool_delete(gTaskPool);
 
     // perform any top-level cleanup.
     glfwTerminate();
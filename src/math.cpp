@@ -12,6 +12,11 @@
 #include <assert.h>
 
 #include "math.hpp"
+#include "ll_task.hpp"
+
+#ifdef __AVX__
+    #include <immintrin.h>
+#endif
 
 /*/////////////////
 //   Constants   //
@@ -49,1315 +54,510 @@ static const uint32_t F32_QNaN     = 0x7FC00000;
 /// @return The number of bytes required to seed a WELL512 PRNG.
 static inline size_t well512_seed_size(void)
 {
-    return WELL512_SEED_SIZE;
-}
-
-/// @summary Initializes a WELL512 PRNG instance to the default state. The RNG
-/// remains unseeded; call well512_seed() before requesting data from the RNG.
-/// @param rng The WELL512 PRNG state data to initialize.
-static void well512_init(rng_state_t *rng)
-{
-    if (rng != NULL)
-    {
-        rng->index = 0;
-        for (size_t i = 0; i < WELL512_SEED_UNITS; ++i)
-        {
-            rng->state[i]  = 0;
-        }
-    }
-}
-
-/// @summary Supplies seed data to seed (or re-seed) a WELL512 PRNG.
-/// @param rng The WELL512 PRNG instance to seed (or re-seed.)
-/// @param seed_data Pointer to the start of a memory block containing the seed data for the RNG.
-/// @param seed_size The size of the seed data, in bytes. This value must be
-/// at least the size specified by well512_seed_size().
-static void well512_seed(rng_state_t *rng, void *seed_data, size_t seed_size)
-{
-    if (rng       == NULL) return;
-    if (seed_data == NULL) return;
-    if (seed_size  < WELL512_SEED_SIZE) return;
-    uint32_t *seed = (uint32_t*) seed_data;
-    for (size_t i  = 0; i < WELL512_SEED_UNITS; ++i)
-    {
-        rng->state[i] = seed[i];
-    }
-    rng->index = 0;
-}
-
-/// @summary Draws a single double-precision IEEE-754 floating point value from
-/// a WELL512 PRNG. Values are uniformly distributed over the range [0, 1).
-/// @param rng The WELL512 PRNG instance to draw from.
-/// @return A value selected from the range [0, 1).
-static inline double well512_draw(rng_state_t *rng)
-{
-    uint32_t &r = rng->index;
-    uint32_t *s = rng->state;
-    uint32_t  n = r;    // read the current value of rng->index
-    uint32_t  a = s[n];
-    uint32_t  b = 0;
-    uint32_t  c = s[(n + 13) & 15];
-    uint32_t  d = 0;
-    b           = a ^ c ^ (a << 16) ^ (c << 15);
-    c           = s[(n + 9)   & 15];
-    c          ^= (c >> 11);
-    a           = s[n] = b ^ c;
-    d           = a ^ ((a << 5) & 0xDA442D24UL);
-    r           = (n + 15) & 15; // update  rng->index
-    n           = (n + 15) & 15; // updated rng->index; update cached
-    a           = s[n];
-    s[n]        = a ^ b ^ d ^ (a << 2) ^ (b << 18) ^ (c << 28);
-    return s[n] * WELL512_RAND_SCALE;
-}
-
-/// @summary Retrieves 32 random bits from a WELL512 PRNG. The bits are returned
-/// without any transformation performed and the full range [0, UINT32_MAX] is possible.
-/// @param rng The WELL512 PRNG instance to draw from.
-/// @return A value selected from the range [0, 4294967295].
-static inline uint32_t well512_bits(rng_state_t *rng)
-{
-    uint32_t &r = rng->index;
-    uint32_t *s = rng->state;
-    uint32_t  n = r;    // read the current value of rng->index
-    uint32_t  a = s[n];
-    uint32_t  b = 0;
-    uint32_t  c = s[(n + 13) & 15];
-    uint32_t  d = 0;
-    b           = a ^ c ^ (a << 16) ^ (c << 15);
-    c           = s[(n + 9)   & 15];
-    c          ^= (c >> 11);
-    a           = s[n] = b ^ c;
-    d           = a ^ ((a << 5) & 0xDA442D24UL);
-    r           = (n + 15) & 15; // update  rng->index
-    n           = (n + 15) & 15; // updated rng->index; update cached
-    a           = s[n];
-    s[n]        = a ^ b ^ d ^ (a << 2) ^ (b << 18) ^ (c << 28);
-    return s[n];
-}
-
-/*///////////////////////
-//  Public Functions   //
-///////////////////////*/
-float min2(float a, float b)
-{
-    return (a < b ? a : b);
-}
-
-float max2(float a, float b)
-{
-    return (a < b ? b : a);
-}
-
-float min3(float a, float b, float c)
-{
-    return (a < b ? (a < c ? a : c) : (b < c ? b : c));
-}
-
-float max3(float a, float b, float c)
-{
-    return (a > b ? (a > c ? a : c) : (b > c ? b : c));
-}
-
-float mix(float a, float b, float t)
-{
-    return (a + ((b - a) * t));
-}
-
-float clamp(float x, float a, float b)
-{
-    return max2(min2(x, b), a);
-}
-
-bool eq(float a, float b)
-{
-    return (fabsf(a-b) <= (FLT_EPSILON * max2(fabsf(a), fabsf(b))));
-}
-
-bool eq_abs(float a, float b, float tol)
-{
-    return (fabsf(a-b) <= tol);
-}
-
-bool eq_rel(float a, float b, float tol)
-{
-    return (fabsf(a-b) <= (tol * max2(fabsf(a), fabsf(b))));
-}
-
-bool eq_com(float a, float b, float t_a, float t_r)
-{
-    return (fabsf(a-b) <= max2(t_a, t_r*max2(fabsf(a), fabsf(b))));
-}
-
-bool is_nan(float a)
-{
-    const uint32_t   mask   = 0xFFC00000;  // sign + exponent
-    const uint32_t   snan   = 0x7FC00000;  // all exponent + top-most mantissa
-    uint32_t         value  = *(uint32_t*) &a;
-    return ((value & mask) == snan);
-}
-
-bool is_inf(float a)
-{
-    const uint32_t   mask    = 0x7FFFFFFF;  // all exponent + all mantissa
-    const uint32_t   inf     = 0x7F800000;  // all exponent; no mantissa
-    uint32_t         value   = *(uint32_t*) &a;
-    return ((value & mask)  == inf);
-}
-
-float rcp(float a)
-{
-    return 1.0f / a;
-}
-
-float rad(float degrees)
-{
-    // degrees * (PI/180)
-    return (degrees * 0.017453292519943295769236907684886f);
-}
-
-float deg(float radians)
-{
-    // radians * (180/PI)
-    return (radians * 57.29577951308232087679815481410500f);
-}
-
-float linear(float a, float b, float t)
-{
-    return (a + ((b - a) * t));
-}
-
-float bezier(float a, float b, float in_t, float out_t, float t)
-{
-    float d  =  b - a;
-    float a2 = (d * 3.0f) - (in_t + (out_t * 2.0f));
-    float a3 =   out_t    +  in_t - (d  * 2.0f);
-    return a + ((out_t    +  (a2  + (a3 * t)) * t) * t);
-}
-
-float hermite(float a, float b, float in_t, float out_t, float t)
-{
-    float t2 =  t  * t;
-    float t3 =  t2 * t;
-    return ((+2.0f * t3   - 3.0f * t2  + 1.0f) * a     +
-            (-2.0f * t3   + 3.0f * t2)         * b     +
-            (  t3  - 2.0f *   t2 +  t)         * out_t +
-            (  t3  -  t2)                      * in_t);
-}
-
-size_t random_seed_size(void)
-{
-    return well512_seed_size();
-}
-
-void random_init(rng_state_t *rng)
-{
-    well512_init(rng);
-}
-
-void random_seed(rng_state_t *rng, void *seed_data, size_t seed_size)
-{
-    well512_seed(rng, seed_data, seed_size);
-}
-
-void random_sequence(uint32_t *values, uint32_t start, size_t count)
-{
-    uint32_t n = (uint32_t)  count;
-    for (uint32_t i = 0; i < n; ++i)
-    {
-        *values++ = start  + i;
-    }
-}
-
-void random_shuffle(uint32_t *values, size_t count, rng_state_t *rng)
-{
-    // algorithm 3.4.2P of The Art of Computer Programming, Vol. 2
-    uint32_t n = (uint32_t) count;
-    while   (n > 1)
-    {
-        uint32_t k = random_range(0, n, rng); // k in [0, n)
-        uint32_t t = values[k];               // swap values[k] and values[n-1]
-        --n;                                  // n decreases every iteration
-        values[k]  = values[n];
-        values[n]  = t;
-    }
-}
-
-void random_choose(uint64_t population_size, uint64_t sample_size, uint32_t *values, rng_state_t *rng)
-{
-    // algorithm 3.4.2S of The Art of Computer Programming, Vol. 2
-    uint64_t n = sample_size;      // max allowable is UINT32_MAX + 1
-    uint64_t N = population_size;  // max allowable is UINT32_MAX + 1
-    uint32_t t = 0;                // total dealt with so far
-    uint32_t m = 0;                // number selected so far
-    while   (m < n)
-    {
-        double v = random_draw(rng);
-        if ((N - t) * v >= (n-m))
-        {
-            ++t;
-        }
-        else
-        {
-            values[m++] = t++;
-        }
-    }
-}
-
-void random_choose_with_replacement(uint64_t population_size, uint64_t sample_size, uint32_t *values, rng_state_t *rng)
-{
-    for (uint64_t i = 0; i < sample_size; ++i)
-    {
-        *values++ = random_range(0, population_size, rng);
-    }
-}
-
-double random_draw(rng_state_t *rng)
-{
-    return well512_draw(rng); // in [0, 1)
-}
-
-uint32_t random_range(uint64_t min_value, uint64_t max_value, rng_state_t *rng)
-{
-    // @note: max_value must be greater than min_value (or we divide by zero)
-    // @note: the max value of max_value is UINT32_MAX + 1
-    // see http://www.azillionmonkeys.com/qed/random.html
-    // see http://en.wikipedia.org/wiki/Fisher-Yates_shuffle#Modulo_bias
-    // remove the bias that can result when the range 'r'
-    // does not divide evenly into the PRNG range 'n'.
-    uint64_t r = max_value - min_value; // size of request range [min, max)
-    uint64_t u = WELL512_RAND_MAX;      // PRNG inclusive upper bound
-    uint64_t n = u + 1;                 // size of PRNG range [0, UINT32_MAX]
-    uint64_t i = n / r;                 // # times whole of 'r' fits in 'n'
-    uint64_t m = r * i;                 // largest integer multiple of 'r'<='n'
-    uint64_t x = 0;                     // raw value from PRNG
-    do
-    {
-        x = well512_bits(rng);          // x in [0, UINT32_MAX]
-    } while (x >= m);
-    x /= i;                             // x -> [0, r) and [0, UINT32_MAX]
-    return uint32_t(x + min_value);     // x -> [min, max)
-}
-
-uint32_t random_bits(rng_state_t *rng)
-{
-    return well512_bits(rng);           // in [0, UINT32_MAX]
-}
-
-float* vec2_set_xy(float *dst_xy, float x, float y)
-{
-    dst_xy[0] = x;
-    dst_xy[1] = y;
-    return dst_xy;
-}
-
-float* vec2_set_vec2(float * __restrict dst_xy, float const * __restrict src_xy)
-{
-    dst_xy[0] = src_xy[0];
-    dst_xy[1] = src_xy[1];
-    return dst_xy;
-}
-
-float* vec2_set_vec3(float * __restrict dst_xy, float const * __restrict src_xyz)
-{
-    dst_xy[0] = src_xyz[0];
-    dst_xy[1] = src_xyz[1];
-    return dst_xy;
-}
-
-float* vec2_set_vec4(float * __restrict dst_xy, float const * __restrict src_xyzw)
-{
-    dst_xy[0] = src_xyzw[0];
-    dst_xy[1] = src_xyzw[1];
-    return dst_xy;
-}
-
-float* vec3_set_xyz(float *dst_xyz, float x, float y, float z)
-{
-    dst_xyz[0] = x;
-    dst_xyz[1] = y;
-    dst_xyz[2] = z;
-    return dst_xyz;
-}
-
-float* vec3_set_vec2(float * __restrict dst_xyz, float const * __restrict src_xy, float z)
-{
-    dst_xyz[0] = src_xy[0];
-    dst_xyz[1] = src_xy[1];
-    dst_xyz[2] = z;
-    return dst_xyz;
-}
-
-float* vec3_set_vec3(float * __restrict dst_xyz, float const * __restrict src_xyz)
-{
-    dst_xyz[0] = src_xyz[0];
-    dst_xyz[1] = src_xyz[1];
-    dst_xyz[2] = src_xyz[2];
-    return dst_xyz;
-}
-
-float* vec3_set_vec4(float * __restrict dst_xyz, float const * __restrict src_xyzw)
-{
-    dst_xyz[0] = src_xyzw[0];
-    dst_xyz[1] = src_xyzw[1];
-    dst_xyz[2] = src_xyzw[2];
-    return dst_xyz;
-}
-
-float* vec4_set(float *dst_xyzw, float x, float y, float z, float w)
-{
-    dst_xyzw[0] = x;
-    dst_xyzw[1] = y;
-    dst_xyzw[2] = z;
-    dst_xyzw[3] = w;
-    return dst_xyzw;
-}
-
-float* vec4_set_vec2(float * __restrict dst_xyzw, float const * __restrict src_xy, float z, float w)
-{
-    dst_xyzw[0] = src_xy[0];
-    dst_xyzw[1] = src_xy[1];
-    dst_xyzw[2] = z;
-    dst_xyzw[3] = w;
-    return dst_xyzw;
-}
-
-float* vec4_set_vec3(float * __restrict dst_xyzw, float const * __restrict src_xyz, float w)
-{
-    dst_xyzw[0] = src_xyz[0];
-    dst_xyzw[1] = src_xyz[1];
-    dst_xyzw[2] = src_xyz[2];
-    dst_xyzw[3] = w;
-    return dst_xyzw;
-}
-
-float* vec4_set_vec4(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    dst_xyzw[0] = src_xyzw[0];
-    dst_xyzw[1] = src_xyzw[1];
-    dst_xyzw[2] = src_xyzw[2];
-    dst_xyzw[3] = src_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_set_nan(float *dst_xy)
-{
-    float qnan = *(float*) &F32_QNaN;
-    dst_xy[0]  = qnan;
-    dst_xy[1]  = qnan;
-    return dst_xy;
-}
-
-float* vec3_set_nan(float *dst_xyz)
-{
-    float qnan = *(float*) &F32_QNaN;
-    dst_xyz[0] = qnan;
-    dst_xyz[1] = qnan;
-    dst_xyz[2] = qnan;
-    return dst_xyz;
-}
-
-float* vec4_set_nan(float *dst_xyzw)
-{
-    float qnan  = *(float*) &F32_QNaN;
-    dst_xyzw[0] = qnan;
-    dst_xyzw[1] = qnan;
-    dst_xyzw[2] = qnan;
-    dst_xyzw[3] = qnan;
-    return dst_xyzw;
-}
-
-float* vec2_set_one(float *dst_xy)
-{
-    dst_xy[0] = 1.0f;
-    dst_xy[1] = 1.0f;
-    return dst_xy;
-}
-
-float* vec3_set_one(float *dst_xyz)
-{
-    dst_xyz[0] = 1.0f;
-    dst_xyz[1] = 1.0f;
-    dst_xyz[2] = 1.0f;
-    return dst_xyz;
-}
-
-float* vec4_set_one(float *dst_xyzw)
-{
-    dst_xyzw[0] = 1.0f;
-    dst_xyzw[1] = 1.0f;
-    dst_xyzw[2] = 1.0f;
-    dst_xyzw[3] = 1.0f;
-    return dst_xyzw;
-}
-
-float* vec2_set_zero(float *dst_xy)
-{
-    dst_xy[0] = 0.0f;
-    dst_xy[1] = 0.0f;
-    return dst_xy;
-}
-
-float* vec3_set_zero(float *dst_xyz)
-{
-    dst_xyz[0] = 0.0f;
-    dst_xyz[1] = 0.0f;
-    dst_xyz[2] = 0.0f;
-    return dst_xyz;
-}
-
-float* vec4_set_zero(float *dst_xyzw)
-{
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 0.0f;
-    return dst_xyzw;
-}
-
-float* vec2_set_ninf(float *dst_xy)
-{
-    float ninf = *(float*) &F32_NInf;
-    dst_xy[0]  = ninf;
-    dst_xy[1]  = ninf;
-    return dst_xy;
-}
-
-float* vec3_set_ninf(float *dst_xyz)
-{
-    float ninf = *(float*) &F32_NInf;
-    dst_xyz[0] = ninf;
-    dst_xyz[1] = ninf;
-    dst_xyz[2] = ninf;
-    return dst_xyz;
-}
-
-float* vec4_set_ninf(float *dst_xyzw)
-{
-    float ninf  = *(float*) &F32_NInf;
-    dst_xyzw[0] = ninf;
-    dst_xyzw[1] = ninf;
-    dst_xyzw[2] = ninf;
-    dst_xyzw[3] = ninf;
-    return dst_xyzw;
-}
-
-float* vec2_set_pinf(float *dst_xy)
-{
-    float pinf = *(float*) &F32_PInf;
-    dst_xy[0]  = pinf;
-    dst_xy[1]  = pinf;
-    return dst_xy;
-}
-
-float* vec3_set_pinf(float *dst_xyz)
-{
-    float pinf = *(float*) &F32_PInf;
-    dst_xyz[0] = pinf;
-    dst_xyz[1] = pinf;
-    dst_xyz[2] = pinf;
-    return dst_xyz;
-}
-
-float* vec4_set_pinf(float *dst_xyzw)
-{
-    float pinf  = *(float*) &F32_PInf;
-    dst_xyzw[0] = pinf;
-    dst_xyzw[1] = pinf;
-    dst_xyzw[2] = pinf;
-    dst_xyzw[3] = pinf;
-    return dst_xyzw;
-}
-
-float* vec2_set_unit_x(float *dst_xy)
-{
-    dst_xy[0] = 1.0f;
-    dst_xy[1] = 0.0f;
-    return dst_xy;
-}
-
-float* vec3_set_unit_x(float *dst_xyz)
-{
-    dst_xyz[0] = 1.0f;
-    dst_xyz[1] = 0.0f;
-    dst_xyz[2] = 0.0f;
-    return dst_xyz;
-}
-
-float* vec4_set_unit_x(float *dst_xyzw)
-{
-    dst_xyzw[0] = 1.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 0.0f;
-    return dst_xyzw;
-}
-
-float* vec2_set_unit_y(float *dst_xy)
-{
-    dst_xy[0] = 0.0f;
-    dst_xy[1] = 1.0f;
-    return dst_xy;
-}
-
-float* vec3_set_unit_y(float *dst_xyz)
-{
-    dst_xyz[0] = 0.0f;
-    dst_xyz[1] = 1.0f;
-    dst_xyz[2] = 0.0f;
-    return dst_xyz;
-}
-
-float* vec4_set_unit_y(float *dst_xyzw)
-{
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 1.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 0.0f;
-    return dst_xyzw;
-}
-
-float* vec3_set_unit_z(float *dst_xyz)
-{
-    dst_xyz[0] = 0.0f;
-    dst_xyz[1] = 0.0f;
-    dst_xyz[2] = 1.0f;
-    return dst_xyz;
-}
-
-float* vec4_set_unit_z(float *dst_xyzw)
-{
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 1.0f;
-    dst_xyzw[3] = 0.0f;
-    return dst_xyzw;
-}
-
-float* vec4_set_unit_w(float *dst_xyzw)
-{
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 1.0f;
-    return dst_xyzw;
-}
-
-bool vec2_eq(float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    if (!eq(a_xy[0], b_xy[0])) return false;
-    if (!eq(a_xy[1], b_xy[1])) return false;
-    return true;
-}
-
-bool vec3_eq(float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    if (!eq(a_xyz[0], b_xyz[0])) return false;
-    if (!eq(a_xyz[1], b_xyz[1])) return false;
-    if (!eq(a_xyz[2], b_xyz[2])) return false;
-    return true;
-}
-
-bool vec4_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    if (!eq(a_xyzw[0], b_xyzw[0])) return false;
-    if (!eq(a_xyzw[1], b_xyzw[1])) return false;
-    if (!eq(a_xyzw[2], b_xyzw[2])) return false;
-    if (!eq(a_xyzw[3], b_xyzw[3])) return false;
-    return true;
-}
-
-float* vec2_add(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    dst_xy[0] = a_xy[0] + b_xy[0];
-    dst_xy[1] = a_xy[1] + b_xy[1];
-    return dst_xy;
-}
-
-float* vec3_add(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    dst_xyz[0] = a_xyz[0] + b_xyz[0];
-    dst_xyz[1] = a_xyz[1] + b_xyz[1];
-    dst_xyz[2] = a_xyz[2] + b_xyz[2];
-    return dst_xyz;
-}
-
-float* vec4_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst_xyzw[0] = a_xyzw[0] + b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] + b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] + b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] + b_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_sub(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    dst_xy[0] = a_xy[0] - b_xy[0];
-    dst_xy[1] = a_xy[1] - b_xy[1];
-    return dst_xy;
-}
-
-float* vec3_sub(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    dst_xyz[0] = a_xyz[0] - b_xyz[0];
-    dst_xyz[1] = a_xyz[1] - b_xyz[1];
-    dst_xyz[2] = a_xyz[2] - b_xyz[2];
-    return dst_xyz;
-}
-
-float* vec4_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst_xyzw[0] = a_xyzw[0] - b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] - b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] - b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] - b_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_mul(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    dst_xy[0] = a_xy[0] * b_xy[0];
-    dst_xy[1] = a_xy[1] * b_xy[1];
-    return dst_xy;
-}
-
-float* vec3_mul(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    dst_xyz[0] = a_xyz[0] * b_xyz[0];
-    dst_xyz[1] = a_xyz[1] * b_xyz[1];
-    dst_xyz[2] = a_xyz[2] * b_xyz[2];
-    return dst_xyz;
-}
-
-float* vec4_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst_xyzw[0] = a_xyzw[0] * b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] * b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] * b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] * b_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_div(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    dst_xy[0] = a_xy[0] / b_xy[0];
-    dst_xy[1] = a_xy[1] / b_xy[1];
-    return dst_xy;
-}
-
-float* vec3_div(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    dst_xyz[0] = a_xyz[0] / b_xyz[0];
-    dst_xyz[1] = a_xyz[1] / b_xyz[1];
-    dst_xyz[2] = a_xyz[2] / b_xyz[2];
-    return dst_xyz;
-}
-
-float* vec4_div(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst_xyzw[0] = a_xyzw[0] / b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] / b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] / b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] / b_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_scl(float * __restrict dst_xy, float const * __restrict a_xy, float b)
-{
-    dst_xy[0] = a_xy[0] * b;
-    dst_xy[1] = a_xy[1] * b;
-    return dst_xy;
-}
-
-float* vec3_scl(float * __restrict dst_xyz, float const * __restrict a_xyz, float b)
-{
-    dst_xyz[0] = a_xyz[0] * b;
-    dst_xyz[1] = a_xyz[1] * b;
-    dst_xyz[2] = a_xyz[2] * b;
-    return dst_xyz;
-}
-
-float* vec4_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
-{
-    dst_xyzw[0] = a_xyzw[0] * b;
-    dst_xyzw[1] = a_xyzw[1] * b;
-    dst_xyzw[2] = a_xyzw[2] * b;
-    dst_xyzw[3] = a_xyzw[3] * b;
-    return dst_xyzw;
-}
-
-float* vec4_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
-{
-    dst_xyzw[0] = a_xyzw[0] * b;
-    dst_xyzw[1] = a_xyzw[1] * b;
-    dst_xyzw[2] = a_xyzw[2] * b;
-    dst_xyzw[3] = a_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_neg(float * __restrict dst_xy, float const * __restrict src_xy)
-{
-    dst_xy[0] = -src_xy[0];
-    dst_xy[1] = -src_xy[1];
-    return dst_xy;
-}
-
-float* vec3_neg(float * __restrict dst_xyz, float const * __restrict src_xyz)
-{
-    dst_xyz[0] = -src_xyz[0];
-    dst_xyz[1] = -src_xyz[1];
-    dst_xyz[2] = -src_xyz[2];
-    return dst_xyz;
-}
-
-float* vec4_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    dst_xyzw[0] = -src_xyzw[0];
-    dst_xyzw[1] = -src_xyzw[1];
-    dst_xyzw[2] = -src_xyzw[2];
-    dst_xyzw[3] = -src_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec4_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    dst_xyzw[0] = -src_xyzw[0];
-    dst_xyzw[1] = -src_xyzw[1];
-    dst_xyzw[2] = -src_xyzw[2];
-    dst_xyzw[3] =  src_xyzw[3];
-    return dst_xyzw;
-}
-
-float vec2_dot(float &dst, float const * __restrict a_xy, float const * __restrict b_xy)
-{
-    dst = (a_xy[0] * b_xy[0] + a_xy[1] * b_xy[1]);
-    return dst;
-}
-
-float vec3_dot(float &dst, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    dst = (a_xyz[0] * b_xyz[0] + a_xyz[1] * b_xyz[1] + a_xyz[2] * b_xyz[2]);
-    return dst;
-}
-
-float vec4_dot(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst = (a_xyzw[0] * b_xyzw[0] + a_xyzw[1] * b_xyzw[1] + a_xyzw[2] * b_xyzw[2] + a_xyzw[3] * b_xyzw[3]);
-    return dst;
-}
-
-float vec4_dot3(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst = (a_xyzw[0] * b_xyzw[0] + a_xyzw[1] * b_xyzw[1] + a_xyzw[2] * b_xyzw[2]);
-    return dst;
-}
-
-float vec2_len(float &dst, float const *a_xy)
-{
-    dst  = sqrtf(a_xy[0] * a_xy[0] + a_xy[1] * a_xy[1]);
-    return dst;
-}
-
-float vec3_len(float &dst, float const *a_xyz)
-{
-    dst = sqrtf(a_xyz[0] * a_xyz[0] + a_xyz[1] * a_xyz[1] + a_xyz[2] * a_xyz[2]);
-    return dst;
-}
-
-float vec4_len(float &dst, float const *a_xyzw)
-{
-    dst = sqrtf(a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2] + a_xyzw[3] * a_xyzw[3]);
-    return dst;
-}
-
-float vec4_len3(float &dst, float const *a_xyzw)
-{
-    dst = sqrtf(a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2]);
-    return dst;
-}
-
-float vec2_len_sq(float &dst, float const *a_xy)
-{
-    dst = (a_xy[0] * a_xy[0] + a_xy[1] * a_xy[1]);
-    return dst;
-}
-
-float vec3_len_sq(float &dst, float const *a_xyz)
-{
-    dst = (a_xyz[0] * a_xyz[0] + a_xyz[1] * a_xyz[1] + a_xyz[2] * a_xyz[2]);
-    return dst;
-}
-
-float vec4_len_sq(float &dst, float const *a_xyzw)
-{
-    dst = (a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2] + a_xyzw[3] * a_xyzw[3]);
-    return dst;
-}
-
-float vec4_len3_sq(float &dst, float const *a_xyzw)
-{
-    dst = (a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2]);
-    return dst;
-}
-
-float* vec2_nrm(float * __restrict dst_xy, float const * __restrict src_xy)
-{
-    float len;
-    if (!eq(vec2_len(len, src_xy), 0))
-    {
-        float rcp = 1.0f / len;
-        dst_xy[0]  = src_xy[0] * rcp;
-        dst_xy[1]  = src_xy[1] * rcp;
-        return dst_xy;
-    }
-    else return vec2_set_pinf(dst_xy);
-}
-
-float* vec3_nrm(float * __restrict dst_xyz, float const * __restrict src_xyz)
-{
-    float len;
-    if (!eq(vec3_len(len, src_xyz), 0))
-    {
-        float rcp = 1.0f / len;
-        dst_xyz[0]  = src_xyz[0] * rcp;
-        dst_xyz[1]  = src_xyz[1] * rcp;
-        dst_xyz[2]  = src_xyz[2] * rcp;
-        return dst_xyz;
-    }
-    else return vec3_set_pinf(dst_xyz);
-}
-
-float* vec4_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    float len;
-    if (!eq(vec4_len(len, src_xyzw), 0))
-    {
-        float rcp = 1.0f / len;
-        dst_xyzw[0]  = src_xyzw[0] * rcp;
-        dst_xyzw[1]  = src_xyzw[1] * rcp;
-        dst_xyzw[2]  = src_xyzw[2] * rcp;
-        dst_xyzw[3]  = src_xyzw[3] * rcp;
-        return dst_xyzw;
-    }
-    else return vec4_set_pinf(dst_xyzw);
-}
-
-float* vec4_nrm3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    float len;
-    if (!eq(vec4_len3(len, src_xyzw), 0))
-    {
-        float rcp = 1.0f / len;
-        dst_xyzw[0]  = src_xyzw[0] * rcp;
-        dst_xyzw[1]  = src_xyzw[1] * rcp;
-        dst_xyzw[2]  = src_xyzw[2] * rcp;
-        dst_xyzw[3]  = src_xyzw[3];
-        return dst_xyzw;
-    }
-    else
-    {
-        vec3_set_pinf(dst_xyzw);
-        dst_xyzw[3]  = src_xyzw[3];
-        return dst_xyzw;
-    }
-}
-
-float* vec2_perp(float * __restrict dst_xy, float const * __restrict src_xy)
-{
-    float x   = src_xy[0];
-    float y   = src_xy[1];
-    dst_xy[0] = -y;
-    dst_xy[1] =  x;
-    return dst_xy;
-}
-
-float* vec3_cross(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz)
-{
-    float ax   = a_xyz[0], ay = a_xyz[1], az = a_xyz[2];
-    float bx   = b_xyz[0], by = b_xyz[1], bz = b_xyz[2];
-    dst_xyz[0] = ay * bz - az * by;
-    dst_xyz[1] = az * bx - ax * bz;
-    dst_xyz[2] = ax * by - ay * bx;
-    return dst_xyz;
-}
-
-float* vec4_cross(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    float ax    = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2];
-    float bx    = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2];
-    dst_xyzw[0] = ay * bz  - az * by;
-    dst_xyzw[1] = az * bx  - ax * bz;
-    dst_xyzw[2] = ax * by  - ay * bx;
-    dst_xyzw[3] = 0.0f; // cross product always results in a vector
-    return dst_xyzw;
-}
-
-float* vec2_swizzle(float * __restrict dst_xy, float const * __restrict src_xy, size_t x, size_t y)
-{
-    float a   = src_xy[x];
-    float b   = src_xy[y];
-    dst_xy[0] = a;
-    dst_xy[1] = b;
-    return dst_xy;
-}
-
-float* vec3_swizzle(float * __restrict dst_xyz, float const * __restrict src_xyz, size_t x, size_t y, size_t z)
-{
-    float a    = src_xyz[x];
-    float b    = src_xyz[y];
-    float c    = src_xyz[z];
-    dst_xyz[0] = a;
-    dst_xyz[1] = b;
-    dst_xyz[2] = c;
-    return dst_xyz;
-}
-
-float* vec4_swizzle(float * __restrict dst_xyzw, float const * __restrict src_xyzw, size_t x, size_t y, size_t z, size_t w)
-{
-    float a     = src_xyzw[x];
-    float b     = src_xyzw[y];
-    float c     = src_xyzw[z];
-    float d     = src_xyzw[w];
-    dst_xyzw[0] = a;
-    dst_xyzw[1] = b;
-    dst_xyzw[2] = c;
-    dst_xyzw[3] = d;
-    return dst_xyzw;
-}
-
-float* vec2_linear(float * __restrict dst_xy, float const * __restrict a_xy, float const * __restrict b_xy, float t)
-{
-    dst_xy[0] = linear(a_xy[0], b_xy[0], t);
-    dst_xy[1] = linear(a_xy[1], b_xy[1], t);
-    return dst_xy;
-}
-
-float* vec3_linear(float * __restrict dst_xyz, float const * __restrict a_xyz, float const * __restrict b_xyz, float t)
-{
-    dst_xyz[0] = linear(a_xyz[0], b_xyz[0], t);
-    dst_xyz[1] = linear(a_xyz[1], b_xyz[1], t);
-    dst_xyz[2] = linear(a_xyz[2], b_xyz[2], t);
-    return dst_xyz;
-}
-
-float* vec4_linear(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t)
-{
-    dst_xyzw[0] = linear(a_xyzw[0], b_xyzw[0], t);
-    dst_xyzw[1] = linear(a_xyzw[1], b_xyzw[1], t);
-    dst_xyzw[2] = linear(a_xyzw[2], b_xyzw[2], t);
-    dst_xyzw[3] = linear(a_xyzw[3], b_xyzw[3], t);
-    return dst_xyzw;
-}
-
-float* vec4_linear3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw, float t)
-{
-    dst_xyzw[0] = linear(a_xyzw[0], b_xyzw[0], t);
-    dst_xyzw[1] = linear(a_xyzw[1], b_xyzw[1], t);
-    dst_xyzw[2] = linear(a_xyzw[2], b_xyzw[2], t);
-    dst_xyzw[3] = a_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_bezier(
-    float       * __restrict dst_xy,
-    float const * __restrict a_xy,
-    float const * __restrict b_xy,
-    float const * __restrict itan_xy,
-    float const * __restrict otan_xy,
-    float                  t)
-{
-    dst_xy[0] = bezier(a_xy[0], b_xy[0], itan_xy[0], otan_xy[0], t);
-    dst_xy[1] = bezier(a_xy[1], b_xy[1], itan_xy[1], otan_xy[1], t);
-    return dst_xy;
-}
-
-float* vec3_bezier(
-    float       * __restrict dst_xyz,
-    float const * __restrict a_xyz,
-    float const * __restrict b_xyz,
-    float const * __restrict itan_xyz,
-    float const * __restrict otan_xyz,
-    float                  t)
-{
-    dst_xyz[0] = bezier(a_xyz[0], b_xyz[0], itan_xyz[0], otan_xyz[0], t);
-    dst_xyz[1] = bezier(a_xyz[1], b_xyz[1], itan_xyz[1], otan_xyz[1], t);
-    dst_xyz[2] = bezier(a_xyz[2], b_xyz[2], itan_xyz[2], otan_xyz[2], t);
-    return dst_xyz;
-}
-
-float* vec4_bezier(
-    float       * __restrict dst_xyzw,
-    float const * __restrict a_xyzw,
-    float const * __restrict b_xyzw,
-    float const * __restrict itan_xyzw,
-    float const * __restrict otan_xyzw,
-    float                  t)
-{
-    dst_xyzw[0] = bezier(a_xyzw[0], b_xyzw[0], itan_xyzw[0], otan_xyzw[0], t);
-    dst_xyzw[1] = bezier(a_xyzw[1], b_xyzw[1], itan_xyzw[1], otan_xyzw[1], t);
-    dst_xyzw[2] = bezier(a_xyzw[2], b_xyzw[2], itan_xyzw[2], otan_xyzw[2], t);
-    dst_xyzw[3] = bezier(a_xyzw[3], b_xyzw[3], itan_xyzw[3], otan_xyzw[3], t);
-    return dst_xyzw;
-}
-
-float* vec4_bezier3(
-    float       * __restrict dst_xyzw,
-    float const * __restrict a_xyzw,
-    float const * __restrict b_xyzw,
-    float const * __restrict itan_xyz,
-    float const * __restrict otan_xyz,
-    float                  t)
-{
-    dst_xyzw[0] = bezier(a_xyzw[0], b_xyzw[0], itan_xyz[0], otan_xyz[0], t);
-    dst_xyzw[1] = bezier(a_xyzw[1], b_xyzw[1], itan_xyz[1], otan_xyz[1], t);
-    dst_xyzw[2] = bezier(a_xyzw[2], b_xyzw[2], itan_xyz[2], otan_xyz[2], t);
-    dst_xyzw[3] = a_xyzw[3];
-    return dst_xyzw;
-}
-
-float* vec2_hermite(
-    float       * __restrict dst_xy,
-    float const * __restrict a_xy,
-    float const * __restrict b_xy,
-    float const * __restrict itan_xy,
-    float const * __restrict otan_xy,
-    float                  t)
-{
-    dst_xy[0] = hermite(a_xy[0], b_xy[0], itan_xy[0], otan_xy[0], t);
-    dst_xy[1] = hermite(a_xy[1], b_xy[1], itan_xy[1], otan_xy[1], t);
-    return dst_xy;
-}
-
-float* vec3_hermite(
-    float       * __restrict dst_xyz,
-    float const * __restrict a_xyz,
-    float const * __restrict b_xyz,
-    float const * __restrict itan_xyz,
-    float const * __restrict otan_xyz,
-    float                  t)
-{
-    dst_xyz[0] = hermite(a_xyz[0], b_xyz[0], itan_xyz[0], otan_xyz[0], t);
-    dst_xyz[1] = hermite(a_xyz[1], b_xyz[1], itan_xyz[1], otan_xyz[1], t);
-    dst_xyz[2] = hermite(a_xyz[2], b_xyz[2], itan_xyz[2], otan_xyz[2], t);
-    return dst_xyz;
-}
-
-float* vec4_hermite(
-    float       * __restrict dst_xyzw,
-    float const * __restrict a_xyzw,
-    float const * __restrict b_xyzw,
-    float const * __restrict itan_xyzw,
-    float const * __restrict otan_xyzw,
-    float                  t)
-{
-    dst_xyzw[0] = hermite(a_xyzw[0], b_xyzw[0], itan_xyzw[0], otan_xyzw[0], t);
-    dst_xyzw[1] = hermite(a_xyzw[1], b_xyzw[1], itan_xyzw[1], otan_xyzw[1], t);
-    dst_xyzw[2] = hermite(a_xyzw[2], b_xyzw[2], itan_xyzw[2], otan_xyzw[2], t);
-    dst_xyzw[3] = hermite(a_xyzw[3], b_xyzw[3], itan_xyzw[3], otan_xyzw[3], t);
-    return dst_xyzw;
-}
-
-float* vec4_hermite3(
-    float       * __restrict dst_xyzw,
-    float const * __restrict a_xyzw,
-    float const * __restrict b_xyzw,
-    float const * __restrict itan_xyz,
-    float const * __restrict otan_xyz,
-    float                  t)
-{
-    dst_xyzw[0] = hermite(a_xyzw[0], b_xyzw[0], itan_xyz[0], otan_xyz[0], t);
-    dst_xyzw[1] = hermite(a_xyzw[1], b_xyzw[1], itan_xyz[1], otan_xyz[1], t);
-    dst_xyzw[2] = hermite(a_xyzw[2], b_xyzw[2], itan_xyz[2], otan_xyz[2], t);
-    dst_xyzw[3] = a_xyzw[3];
-    return dst_xyzw;
-}
-
-float* quat_set(float *dst_xyzw, float x, float y, float z, float w)
-{
-    dst_xyzw[0] = x;
-    dst_xyzw[1] = y;
-    dst_xyzw[2] = z;
-    dst_xyzw[3] = w;
-    return dst_xyzw;
-}
-
-float* quat_set_quat(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
-{
-    dst_xyzw[0] = src_xyzw[0];
-    dst_xyzw[1] = src_xyzw[1];
-    dst_xyzw[2] = src_xyzw[2];
-    dst_xyzw[3] = src_xyzw[3];
-    return dst_xyzw;
-}
-
-float* quat_set_nan(float *dst_xyzw)
-{
-    float qnan  = *(float*) &F32_QNaN;
-    dst_xyzw[0] = qnan;
-    dst_xyzw[1] = qnan;
-    dst_xyzw[2] = qnan;
-    dst_xyzw[3] = qnan;
-    return dst_xyzw;
-}
-
-float* quat_set_one(float *dst_xyzw)
-{
-    dst_xyzw[0] = 1.0f;
-    dst_xyzw[1] = 1.0f;
-    dst_xyzw[2] = 1.0f;
-    dst_xyzw[3] = 1.0f;
-    return dst_xyzw;
+    return WELL512_SEED_SIZE;
 }
 
-float* quat_set_zero(float *dst_xyzw)
+/// @summary Initializes a WELL512 PRNG instance to the default state. The RNG
+/// remains unseeded; call well512_seed() before requesting data from the RNG.
+/// @param rng The WELL512 PRNG state data to initialize.
+static void well512_init(rng_state_t *rng)
 {
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 0.0f;
-    return dst_xyzw;
+    if (rng != NULL)
+    {
+        rng->index = 0;
+        for (size_t i = 0; i < WELL512_SEED_UNITS; ++i)
+        {
+            rng->state[i]  = 0;
+        }
+    }
 }
 
-float* quat_set_ninf(float *dst_xyzw)
+/// @summary Supplies seed data to seed (or re-seed) a WELL512 PRNG.
+/// @param rng The WELL512 PRNG instance to seed (or re-seed.)
+/// @param seed_data Pointer to the start of a memory block containing the seed data for the RNG.
+/// @param seed_size The size of the seed data, in bytes. This value must be
+/// at least the size specified by well512_seed_size().
+static void well512_seed(rng_state_t *rng, void *seed_data, size_t seed_size)
 {
-    float ninf  = *(float*) &F32_NInf;
-    dst_xyzw[0] = ninf;
-    dst_xyzw[1] = ninf;
-    dst_xyzw[2] = ninf;
-    dst_xyzw[3] = ninf;
-    return dst_xyzw;
+    if (rng       == NULL) return;
+    if (seed_data == NULL) return;
+    if (seed_size  < WELL512_SEED_SIZE) return;
+    uint32_t *seed = (uint32_t*) seed_data;
+    for (size_t i  = 0; i < WELL512_SEED_UNITS; ++i)
+    {
+        rng->state[i] = seed[i];
+    }
+    rng->index = 0;
 }
 
-float* quat_set_pinf(float *dst_xyzw)
+/// @summary Draws a single double-precision IEEE-754 floating point value from
+/// a WELL512 PRNG. Values are uniformly distributed over the range [0, 1).
+/// @param rng The WELL512 PRNG instance to draw from.
+/// @return A value selected from the range [0, 1).
+static inline double well512_draw(rng_state_t *rng)
 {
-    float pinf  = *(float*) &F32_PInf;
-    dst_xyzw[0] = pinf;
-    dst_xyzw[1] = pinf;
-    dst_xyzw[2] = pinf;
-    dst_xyzw[3] = pinf;
-    return dst_xyzw;
+    uint32_t &r = rng->index;
+    uint32_t *s = rng->state;
+    uint32_t  n = r;    // read the current value of rng->index
+    uint32_t  a = s[n];
+    uint32_t  b = 0;
+    uint32_t  c = s[(n + 13) & 15];
+    uint32_t  d = 0;
+    b           = a ^ c ^ (a << 16) ^ (c << 15);
+    c           = s[(n + 9)   & 15];
+    c          ^= (c >> 11);
+    a           = s[n] = b ^ c;
+    d           = a ^ ((a << 5) & 0xDA442D24UL);
+    r           = (n + 15) & 15; // update  rng->index
+    n           = (n + 15) & 15; // updated rng->index; update cached
+    a           = s[n];
+    s[n]        = a ^ b ^ d ^ (a << 2) ^ (b << 18) ^ (c << 28);
+    return s[n] * WELL512_RAND_SCALE;
 }
 
-float* quat_set_ident(float *dst_xyzw)
+/// @summary Retrieves 32 random bits from a WELL512 PRNG. The bits are returned
+/// without any transformation performed and the full range [0, UINT32_MAX] is possible.
+/// @param rng The WELL512 PRNG instance to draw from.
+/// @return A value selected from the range [0, 4294967295].
+static inline uint32_t well512_bits(rng_state_t *rng)
 {
-    dst_xyzw[0] = 0.0f;
-    dst_xyzw[1] = 0.0f;
-    dst_xyzw[2] = 0.0f;
-    dst_xyzw[3] = 1.0f;
-    return dst_xyzw;
+    uint32_t &r = rng->index;
+    uint32_t *s = rng->state;
+    uint32_t  n = r;    // read the current value of rng->index
+    uint32_t  a = s[n];
+    uint32_t  b = 0;
+    uint32_t  c = s[(n + 13) & 15];
+    uint32_t  d = 0;
+    b           = a ^ c ^ (a << 16) ^ (c << 15);
+    c           = s[(n + 9)   & 15];
+    c          ^= (c >> 11);
+    a           = s[n] = b ^ c;
+    d           = a ^ ((a << 5) & 0xDA442D24UL);
+    r           = (n + 15) & 15; // update  rng->index
+    n           = (n + 15) & 15; // updated rng->index; update cached
+    a           = s[n];
+    s[n]        = a ^ b ^ d ^ (a << 2) ^ (b << 18) ^ (c << 28);
+    return s[n];
 }
 
-bool quat_eq(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    if (!eq(a_xyzw[0], b_xyzw[0]))
-        return 0;
-    if (!eq(a_xyzw[1], b_xyzw[1]))
-        return 0;
-    if (!eq(a_xyzw[2], b_xyzw[2]))
-        return 0;
-    if (!eq(a_xyzw[3], b_xyzw[3]))
-        return 0;
-    return 1;
-}
+#if GW_MATH_SSE
+/// @summary Stores four floats to memory, bypassing the cache if requested.
+/// @param dst The destination address. Must be 16-byte aligned if stream is true.
+/// @param v The value to store.
+/// @param stream true to use a non-temporal store.
+static inline void store_ps(float *dst, __m128 v, bool stream)
+{
+    if (stream) _mm_stream_ps(dst, v);
+    else _mm_storeu_ps(dst, v);
+}
+
+/// @summary Transforms four points or vectors held in SoA form by a matrix.
+/// @param x On entry, the x-components; on return, the transformed x-components.
+/// @param y On entry, the y-components; on return, the transformed y-components.
+/// @param z On entry, the z-components; on return, the transformed z-components.
+/// @param t16 The column-major transformation matrix.
+/// @param w 1.0 to transform points, or 0.0 to transform vectors.
+static inline void transform_soa4(__m128 &x, __m128 &y, __m128 &z, float const *t16, float w)
+{
+    __m128 rx = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[0]), x), _mm_mul_ps(_mm_set1_ps(t16[4]), y));
+    __m128 ry = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[1]), x), _mm_mul_ps(_mm_set1_ps(t16[5]), y));
+    __m128 rz = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[2]), x), _mm_mul_ps(_mm_set1_ps(t16[6]), y));
+    rx = _mm_add_ps(rx, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[8]),  z), _mm_set1_ps(t16[12] * w)));
+    ry = _mm_add_ps(ry, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[9]),  z), _mm_set1_ps(t16[13] * w)));
+    rz = _mm_add_ps(rz, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t16[10]), z), _mm_set1_ps(t16[14] * w)));
+    x  = rx; y = ry; z = rz;
+}
+#endif /* GW_MATH_SSE */
+
+#ifdef __AVX__
+/// @summary Transforms eight points or vectors held in SoA form by a matrix.
+/// @param x On entry, the x-components; on return, the transformed x-components.
+/// @param y On entry, the y-components; on return, the transformed y-components.
+/// @param z On entry, the z-components; on return, the transformed z-components.
+/// @param t16 The column-major transformation matrix.
+/// @param w 1.0 to transform points, or 0.0 to transform vectors.
+static inline void transform_soa8(__m256 &x, __m256 &y, __m256 &z, float const *t16, float w)
+{
+    __m256 rx = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[0]), x), _mm256_mul_ps(_mm256_set1_ps(t16[4]), y));
+    __m256 ry = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[1]), x), _mm256_mul_ps(_mm256_set1_ps(t16[5]), y));
+    __m256 rz = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[2]), x), _mm256_mul_ps(_mm256_set1_ps(t16[6]), y));
+    rx = _mm256_add_ps(rx, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[8]),  z), _mm256_set1_ps(t16[12] * w)));
+    ry = _mm256_add_ps(ry, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[9]),  z), _mm256_set1_ps(t16[13] * w)));
+    rz = _mm256_add_ps(rz, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t16[10]), z), _mm256_set1_ps(t16[14] * w)));
+    x  = rx; y = ry; z = rz;
+}
+#endif /* defined(__AVX__) */
+
+/// @summary Determines whether an output array is large enough, and suitably
+/// aligned, to benefit from non-temporal stores.
+/// @param dst The destination array.
+/// @param size The size of the destination array, in bytes.
+/// @param align The alignment required by the streaming store instruction.
+/// @return true if streaming stores should be used.
+static inline bool use_streaming_stores(float const *dst, size_t size, size_t align)
+{
+    return (size >= MATH_STREAM_THRESHOLD) && ((uintptr_t(dst) & (align - 1)) == 0);
+}
+
+/// @summary Transforms an array of three-component points or vectors stored
+/// in AoS form (xyzxyz...). Four elements are processed per iteration with
+/// SSE; the remainder are processed one at a time.
+/// @param dst_xyz The destination array. May not overlap the source array.
+/// @param src_xyz The source array.
+/// @param t16 The column-major transformation matrix.
+/// @param count The number of three-component elements to transform.
+/// @param w 1.0 to transform points, or 0.0 to transform vectors.
+/// @param stream true to use non-temporal stores for the destination.
+static void transform_array_xyz(
+    float       * __restrict dst_xyz,
+    float const * __restrict src_xyz,
+    float const * __restrict t16,
+    size_t                   count,
+    float                    w,
+    bool                     stream)
+{
+    size_t i = 0;
+#if GW_MATH_SSE
+    // a streaming destination must be 16-byte aligned; the 48-byte
+    // stride of each group of four elements preserves that alignment.
+    for ( ; i + 4 <= count; i += 4)
+    {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3.
+        __m128 a = _mm_loadu_ps(src_xyz + 0);
+        __m128 b = _mm_loadu_ps(src_xyz + 4);
+        __m128 c = _mm_loadu_ps(src_xyz + 8);
+        __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        transform_soa4(x, y, z, t16, w);
+
+        // re-interleave into the AoS layout.
+        a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        store_ps(dst_xyz + 0, a, stream);
+        store_ps(dst_xyz + 4, b, stream);
+        store_ps(dst_xyz + 8, c, stream);
+
+        src_xyz += 12;
+        dst_xyz += 12;
+    }
+    if (stream) _mm_sfence();
+#else
+    UNUSED_ARG(stream);
+#endif
+    for ( ; i < count; ++i)
+    {
+        float x = src_xyz[0];
+        float y = src_xyz[1];
+        float z = src_xyz[2];
 
-float* quat_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    dst_xyzw[0] = a_xyzw[0] + b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] + b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] + b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] + b_xyzw[3];
-    return dst_xyzw;
+        dst_xyz[0] = t16[0] * x + t16[4] * y + t16[8]  * z + t16[12] * w;
+        dst_xyz[1] = t16[1] * x + t16[5] * y + t16[9]  * z + t16[13] * w;
+        dst_xyz[2] = t16[2] * x + t16[6] * y + t16[10] * z + t16[14] * w;
+
+        src_xyz += 3;
+        dst_xyz += 3;
+    }
 }
 
-float* quat_sub(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+/// @summary Transforms an array of four-component vectors. Two elements are
+/// processed per iteration with AVX, or one with SSE.
+/// @param dst_xyzw The destination array. May not overlap the source array.
+/// @param src_xyzw The source array.
+/// @param t16 The column-major transformation matrix.
+/// @param count The number of four-component elements to transform.
+/// @param stream true to use non-temporal stores for the destination.
+static void transform_array_xyzw(
+    float       * __restrict dst_xyzw,
+    float const * __restrict src_xyzw,
+    float const * __restrict t16,
+    size_t                   count,
+    bool                     stream)
 {
-    dst_xyzw[0] = a_xyzw[0] - b_xyzw[0];
-    dst_xyzw[1] = a_xyzw[1] - b_xyzw[1];
-    dst_xyzw[2] = a_xyzw[2] - b_xyzw[2];
-    dst_xyzw[3] = a_xyzw[3] - b_xyzw[3];
-    return dst_xyzw;
+    size_t i = 0;
+#ifdef __AVX__
+    if (stream && count > 0 && (uintptr_t(dst_xyzw) & 31) != 0)
+    {
+        // peel one element to reach the 32-byte alignment _mm256_stream_ps needs.
+        vec4_store(dst_xyzw, mat4_transform_vec4(mat4_load(t16), vec4_load(src_xyzw)));
+        src_xyzw += 4; dst_xyzw += 4; ++i;
+    }
+    __m256 c0 = _mm256_broadcast_ps((__m128 const*) (t16 +  0));
+    __m256 c1 = _mm256_broadcast_ps((__m128 const*) (t16 +  4));
+    __m256 c2 = _mm256_broadcast_ps((__m128 const*) (t16 +  8));
+    __m256 c3 = _mm256_broadcast_ps((__m128 const*) (t16 + 12));
+    for ( ; i + 2 <= count; i += 2)
+    {
+        __m256 v = _mm256_loadu_ps(src_xyzw);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_permute_ps(v, 0xAA)));
+        r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_permute_ps(v, 0xFF)));
+        if (stream) _mm256_stream_ps(dst_xyzw, r);
+        else _mm256_storeu_ps(dst_xyzw, r);
+        src_xyzw += 8;
+        dst_xyzw += 8;
+    }
+#endif
+    mat4_t m = mat4_load(t16);
+    for ( ; i < count; ++i)
+    {
+        vec4_t r = mat4_transform_vec4(m, vec4_load(src_xyzw));
+#if GW_MATH_SSE
+        store_ps(dst_xyzw, r.xyzw, stream);
+#else
+        vec4_store(dst_xyzw, r);
+#endif
+        src_xyzw += 4;
+        dst_xyzw += 4;
+    }
+#if GW_MATH_SSE
+    if (stream) _mm_sfence();
+#else
+    UNUSED_ARG(stream);
+#endif
+}
+
+/// @summary Transforms an array of three-component points or vectors stored
+/// in SoA form. Eight elements are processed per iteration with AVX, or four
+/// with SSE; the remainder are processed one at a time.
+/// @param dst_x The destination x-components.
+/// @param dst_y The destination y-components.
+/// @param dst_z The destination z-components.
+/// @param src_x The source x-components.
+/// @param src_y The source y-components.
+/// @param src_z The source z-components.
+/// @param t16 The column-major transformation matrix.
+/// @param count The number of elements to transform.
+/// @param w 1.0 to transform points, or 0.0 to transform vectors.
+static void transform_soa_xyz(
+    float       * __restrict dst_x,
+    float       * __restrict dst_y,
+    float       * __restrict dst_z,
+    float const * __restrict src_x,
+    float const * __restrict src_y,
+    float const * __restrict src_z,
+    float const * __restrict t16,
+    size_t                   count,
+    float                    w)
+{
+    size_t i = 0;
+#ifdef __AVX__
+    for ( ; i + 8 <= count; i += 8)
+    {
+        __m256 x = _mm256_loadu_ps(src_x + i);
+        __m256 y = _mm256_loadu_ps(src_y + i);
+        __m256 z = _mm256_loadu_ps(src_z + i);
+        transform_soa8(x, y, z, t16, w);
+        _mm256_storeu_ps(dst_x + i, x);
+        _mm256_storeu_ps(dst_y + i, y);
+        _mm256_storeu_ps(dst_z + i, z);
+    }
+#endif
+#if GW_MATH_SSE
+    for ( ; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(src_x + i);
+        __m128 y = _mm_loadu_ps(src_y + i);
+        __m128 z = _mm_loadu_ps(src_z + i);
+        transform_soa4(x, y, z, t16, w);
+        _mm_storeu_ps(dst_x + i, x);
+        _mm_storeu_ps(dst_y + i, y);
+        _mm_storeu_ps(dst_z + i, z);
+    }
+#endif
+    for ( ; i < count; ++i)
+    {
+        float x  = src_x[i];
+        float y  = src_y[i];
+        float z  = src_z[i];
+        dst_x[i] = t16[0] * x + t16[4] * y + t16[8]  * z + t16[12] * w;
+        dst_y[i] = t16[1] * x + t16[5] * y + t16[9]  * z + t16[13] * w;
+        dst_z[i] = t16[2] * x + t16[6] * y + t16[10] * z + t16[14] * w;
+    }
 }
 
-float* quat_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
-{
-    float ax = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2], aw = a_xyzw[3];
-    float bx = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2], bw = b_xyzw[3];
-    dst_xyzw[0] = ((aw * bx) + (ax * bw) + (ay * bz) - (az * by));
-    dst_xyzw[1] = ((aw * by) - (ax * bz) + (ay * bw) + (az * bx));
-    dst_xyzw[2] = ((aw * bz) + (ax * by) - (ay * bx) + (az * bw));
-    dst_xyzw[3] = ((aw * bw) - (ax * bx) - (ay * by) - (az * bz));
-    return dst_xyzw;
+/// @summary Describes an array transform split across a task pool.
+struct transform_job_t
+{
+    float       *Dst;      /// The destination array.
+    float const *Src;      /// The source array.
+    float const *T16;      /// The column-major transformation matrix.
+    size_t       Count;    /// The total number of elements.
+    size_t       Stride;   /// The number of floats per element (3 or 4).
+    float        W;        /// 1.0 for points, 0.0 for vectors.
+    bool         Stream;   /// true to use non-temporal stores.
+};
+
+/// @summary Task pool callback that transforms a range of blocks of a
+/// transform_job_t. Blocks are MATH_TRANSFORM_BLOCK elements, which keeps the
+/// start of each range aligned for streaming stores.
+/// @param begin The index of the first block.
+/// @param end The index one past the last block.
+/// @param context The transform_job_t.
+static void transform_job_range(size_t begin, size_t end, void *context)
+{
+    transform_job_t *job = (transform_job_t*) context;
+    size_t first = begin * MATH_TRANSFORM_BLOCK;
+    size_t last  = end   * MATH_TRANSFORM_BLOCK;
+    if (last > job->Count) last = job->Count;
+    float       *dst = job->Dst + first * job->Stride;
+    float const *src = job->Src + first * job->Stride;
+    if (job->Stride == 4) transform_array_xyzw(dst, src, job->T16, last - first, job->Stream);
+    else transform_array_xyz(dst, src, job->T16, last - first, job->W, job->Stream);
+}
+
+/// @summary Splits an AoS array transform across a task pool.
+/// @param dst The destination array.
+/// @param src The source array.
+/// @param t16 The column-major transformation matrix.
+/// @param count The number of elements to transform.
+/// @param stride The number of floats per element (3 or 4).
+/// @param w 1.0 for points, 0.0 for vectors. Ignored if stride is 4.
+/// @param pool The task pool used to execute the transform. May be NULL.
+static void transform_array_mt(float *dst, float const *src, float const *t16, size_t count, size_t stride, float w, task_pool_t *pool)
+{
+    transform_job_t job;
+    job.Dst    = dst;
+    job.Src    = src;
+    job.T16    = t16;
+    job.Count  = count;
+    job.Stride = stride;
+    job.W      = w;
+    job.Stream = use_streaming_stores(dst, count * stride * sizeof(float), stride == 4 ? 32 : 16);
+    size_t blocks = (count + MATH_TRANSFORM_BLOCK - 1) / MATH_TRANSFORM_BLOCK;
+    task_pool_parallel_for(pool, blocks, 1, transform_job_range, &job);
+}
+
+/// @summary Describes an SoA transform split across a task pool.
+struct transform_soa_job_t
+{
+    float       *Dst[3];   /// The destination x, y and z arrays.
+    float const *Src[3];   /// The source x, y and z arrays.
+    float const *T16;      /// The column-major transformation matrix.
+    size_t       Count;    /// The total number of elements.
+    float        W;        /// 1.0 for points, 0.0 for vectors.
+};
+
+/// @summary Task pool callback that transforms a range of blocks of a
+/// transform_soa_job_t.
+/// @param begin The index of the first block.
+/// @param end The index one past the last block.
+/// @param context The transform_soa_job_t.
+static void transform_soa_job_range(size_t begin, size_t end, void *context)
+{
+    transform_soa_job_t *job = (transform_soa_job_t*) context;
+    size_t first = begin * MATH_TRANSFORM_BLOCK;
+    size_t last  = end   * MATH_TRANSFORM_BLOCK;
+    if (last > job->Count) last = job->Count;
+    transform_soa_xyz(
+        job->Dst[0] + first, job->Dst[1] + first, job->Dst[2] + first,
+        job->Src[0] + first, job->Src[1] + first, job->Src[2] + first,
+        job->T16, last - first, job->W);
 }
 
-float* quat_scl(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+size_t random_seed_size(void)
 {
-    dst_xyzw[0] = a_xyzw[0] * b;
-    dst_xyzw[1] = a_xyzw[1] * b;
-    dst_xyzw[2] = a_xyzw[2] * b;
-    dst_xyzw[3] = a_xyzw[3] * b;
-    return dst_xyzw;
+    return well512_seed_size();
 }
 
-float* quat_scl3(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float b)
+void random_init(rng_state_t *rng)
 {
-    dst_xyzw[0] = a_xyzw[0] * b;
-    dst_xyzw[1] = a_xyzw[1] * b;
-    dst_xyzw[2] = a_xyzw[2] * b;
-    dst_xyzw[3] = a_xyzw[3];
-    return dst_xyzw;
+    well512_init(rng);
 }
 
-float* quat_neg(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+void random_seed(rng_state_t *rng, void *seed_data, size_t seed_size)
 {
-    dst_xyzw[0] = -src_xyzw[0];
-    dst_xyzw[1] = -src_xyzw[1];
-    dst_xyzw[2] = -src_xyzw[2];
-    dst_xyzw[3] = -src_xyzw[3];
-    return dst_xyzw;
+    well512_seed(rng, seed_data, seed_size);
 }
 
-float* quat_neg3(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+void random_sequence(uint32_t *values, uint32_t start, size_t count)
 {
-    dst_xyzw[0] = -src_xyzw[0];
-    dst_xyzw[1] = -src_xyzw[1];
-    dst_xyzw[2] = -src_xyzw[2];
-    dst_xyzw[3] =  src_xyzw[3];
-    return dst_xyzw;
+    uint32_t n = (uint32_t)  count;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        *values++ = start  + i;
+    }
 }
 
-float* quat_conj(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+void random_shuffle(uint32_t *values, size_t count, rng_state_t *rng)
 {
-    dst_xyzw[0] = -src_xyzw[0];
-    dst_xyzw[1] = -src_xyzw[1];
-    dst_xyzw[2] = -src_xyzw[2];
-    dst_xyzw[3] =  src_xyzw[3];
-    return dst_xyzw;
+    // algorithm 3.4.2P of The Art of Computer Programming, Vol. 2
+    uint32_t n = (uint32_t) count;
+    while   (n > 1)
+    {
+        uint32_t k = random_range(0, n, rng); // k in [0, n)
+        uint32_t t = values[k];               // swap values[k] and values[n-1]
+        --n;                                  // n decreases every iteration
+        values[k]  = values[n];
+        values[n]  = t;
+    }
 }
 
-float quat_dot(float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+void random_choose(uint64_t population_size, uint64_t sample_size, uint32_t *values, rng_state_t *rng)
 {
-    // equivalent to selection(a * conjugate(b))
-    return (a_xyzw[0] * b_xyzw[0] + a_xyzw[1] * b_xyzw[1] + a_xyzw[2] * b_xyzw[2] + a_xyzw[3] * b_xyzw[3]);
+    // algorithm 3.4.2S of The Art of Computer Programming, Vol. 2
+    uint64_t n = sample_size;      // max allowable is UINT32_MAX + 1
+    uint64_t N = population_size;  // max allowable is UINT32_MAX + 1
+    uint32_t t = 0;                // total dealt with so far
+    uint32_t m = 0;                // number selected so far
+    while   (m < n)
+    {
+        double v = random_draw(rng);
+        if ((N - t) * v >= (n-m))
+        {
+            ++t;
+        }
+        else
+        {
+            values[m++] = t++;
+        }
+    }
 }
 
-float quat_norm(float const *src_xyzw)
+void random_choose_with_replacement(uint64_t population_size, uint64_t sample_size, uint32_t *values, rng_state_t *rng)
 {
-    return (src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+    for (uint64_t i = 0; i < sample_size; ++i)
+    {
+        *values++ = random_range(0, population_size, rng);
+    }
 }
 
-float quat_len(float const *src_xyzw)
+double random_draw(rng_state_t *rng)
 {
-    return sqrtf(src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+    return well512_draw(rng); // in [0, 1)
 }
 
-float quat_len_sq(float const *src_xyzw)
+uint32_t random_range(uint64_t min_value, uint64_t max_value, rng_state_t *rng)
 {
-    return (src_xyzw[0] * src_xyzw[0] + src_xyzw[1] * src_xyzw[1] + src_xyzw[2] * src_xyzw[2] + src_xyzw[3] * src_xyzw[3]);
+    // @note: max_value must be greater than min_value (or we divide by zero)
+    // @note: the max value of max_value is UINT32_MAX + 1
+    // see http://www.azillionmonkeys.com/qed/random.html
+    // see http://en.wikipedia.org/wiki/Fisher-Yates_shuffle#Modulo_bias
+    // remove the bias that can result when the range 'r'
+    // does not divide evenly into the PRNG range 'n'.
+    uint64_t r = max_value - min_value; // size of request range [min, max)
+    uint64_t u = WELL512_RAND_MAX;      // PRNG inclusive upper bound
+    uint64_t n = u + 1;                 // size of PRNG range [0, UINT32_MAX]
+    uint64_t i = n / r;                 // # times whole of 'r' fits in 'n'
+    uint64_t m = r * i;                 // largest integer multiple of 'r'<='n'
+    uint64_t x = 0;                     // raw value from PRNG
+    do
+    {
+        x = well512_bits(rng);          // x in [0, UINT32_MAX]
+    } while (x >= m);
+    x /= i;                             // x -> [0, r) and [0, UINT32_MAX]
+    return uint32_t(x + min_value);     // x -> [min, max)
 }
 
-float quat_sel(float const *src_xyzw)
+uint32_t random_bits(rng_state_t *rng)
 {
-    return src_xyzw[3];
+    return well512_bits(rng);           // in [0, UINT32_MAX]
 }
 
 float* quat_inv(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
@@ -1470,17 +670,19 @@ float* quat_orient_vec3(float * __restrict dst_xyzw, float const * __restrict fr
     float unit_to[3];
     float x_from_to[3];
     float dp_from_to;
+    float scale;
     float rcp_scale;
 
     vec3_nrm(unit_to,     to_xyz);
     vec3_nrm(unit_from,   from_xyz);
     vec3_cross(x_from_to, unit_from, unit_to);
     vec3_dot(dp_from_to,  unit_from, unit_to);
-    rcp_scale   = 1.0f / (sqrtf((1.0f + dp_from_to) * 2.0f));
+    scale       = sqrtf((1.0f + dp_from_to) * 2.0f);
+    rcp_scale   = 1.0f / scale;
     dst_xyzw[0] = x_from_to[0] * rcp_scale;
     dst_xyzw[1] = x_from_to[1] * rcp_scale;
     dst_xyzw[2] = x_from_to[2] * rcp_scale;
-    dst_xyzw[3] = 0.5f         * rcp_scale;
+    dst_xyzw[3] = 0.5f         * scale;
     return dst_xyzw;
 }
 
@@ -1490,25 +692,30 @@ float* quat_orient_vec4(float * __restrict dst_xyzw, float const * __restrict fr
     float unit_to[3];
     float x_from_to[3];
     float dp_from_to;
+    float scale;
     float rcp_scale;
 
     vec3_nrm(unit_to,    to_xyzw);
     vec3_nrm(unit_from,  from_xyzw);
     vec3_cross(x_from_to,unit_from, unit_to);
     vec3_dot(dp_from_to, unit_from, unit_to);
-    rcp_scale   = 1.0f / sqrtf((1.0f + dp_from_to) * 2.0f);
+    scale       = sqrtf((1.0f + dp_from_to) * 2.0f);
+    rcp_scale   = 1.0f / scale;
     dst_xyzw[0] = x_from_to[0] * rcp_scale;
     dst_xyzw[1] = x_from_to[1] * rcp_scale;
     dst_xyzw[2] = x_from_to[2] * rcp_scale;
-    dst_xyzw[3] = 0.5f         * rcp_scale;
+    dst_xyzw[3] = 0.5f         * scale;
     return dst_xyzw;
 }
 
 float* quat_set_mat4(float * __restrict dst_xyzw, float const * __restrict m16)
 {
     float trace_plus_one = 1.0f + m16[0] + m16[5] + m16[10];
-    if   (trace_plus_one > 0.0f)
+    if   (trace_plus_one > 1.0f)
     {
+        // |w| > 1/2, so s is well away from zero. for smaller traces, s
+        // approaches zero and the off-diagonal differences lose precision,
+        // so the branches below divide by the largest diagonal term instead.
         float s     = 2.0f  * sqrtf(trace_plus_one);
         float rcp_s = 1.0f  / s;
         dst_xyzw[0] = rcp_s * (m16[6] - m16[9]);
@@ -1642,7 +849,7 @@ float* quat_slerp(float * __restrict dst_xyzw, float const * __restrict a_xyzw,
     float ax  = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2], aw = a_xyzw[3];
     float bx  = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2], bw = b_xyzw[3];
     float omt = 1.0f - t;
-    float co  = cosf(ax * bx + ay * by + az * bz + aw * bw);
+    float co  = ax * bx + ay * by + az * bz + aw * bw;
     float s1  = 0.0f;
     float s2  = 0.0f;
     float q[4];
@@ -1658,8 +865,10 @@ float* quat_slerp(float * __restrict dst_xyzw, float const * __restrict a_xyzw,
         q[3] = -bw;
     }
 
-    if (!eq(1.0f - co, 0))
+    if (1.0f - co > FLT_EPSILON)
     {
+        // co may round to slightly above one for nearly equal inputs, where
+        // acosf() would return NaN; those take the linear path below.
         float om = acosf(co);
         float so = sinf(om);
         s1 = sinf(omt * om) / so;
@@ -1691,7 +900,7 @@ float* quat_squad(
     float bt[4];
     quat_slerp(at,      p_xyzw,  q_xyzw, t);
     quat_slerp(bt,      a_xyzw,  b_xyzw, t);
-    quat_slerp(dst_xyzw, at,     bt,     2.0f * t * (1.0f * t));
+    quat_slerp(dst_xyzw, at,     bt,     2.0f * t * (1.0f - t));
     return dst_xyzw;
 }
 
@@ -1930,108 +1139,6 @@ float mat4_det(float const *src16)
     return src16[0] * c0 + src16[4]  * c4 + src16[8] * c8;
 }
 
-float* mat4x4_transpose(float * __restrict dst16, float const * __restrict src16)
-{
-    float src0   = src16[0];
-    float src1   = src16[1];
-    float src2   = src16[2];
-    float src3   = src16[3];
-    float src4   = src16[4];
-    float src5   = src16[5];
-    float src6   = src16[6];
-    float src7   = src16[7];
-    float src8   = src16[8];
-    float src9   = src16[9];
-    float src10  = src16[10];
-    float src11  = src16[11];
-    float src12  = src16[12];
-    float src13  = src16[13];
-    float src14  = src16[14];
-    float src15  = src16[15];
-
-    dst16[0]  = src0;
-    dst16[1]  = src4;
-    dst16[2]  = src8;
-    dst16[3]  = src12;
-
-    dst16[4]  = src1;
-    dst16[5]  = src5;
-    dst16[6]  = src9;
-    dst16[7]  = src13;
-
-    dst16[8]  = src2;
-    dst16[9]  = src6;
-    dst16[10] = src10;
-    dst16[11] = src14;
-
-    dst16[12] = src3;
-    dst16[13] = src7;
-    dst16[14] = src11;
-    dst16[15] = src15;
-
-    return dst16;
-}
-
-float* mat4_concat(float * __restrict dst16, float const * __restrict a16, float const * __restrict b16)
-{
-    // transformation 'a' is applied first, followed by transformation 'b'.
-    // result is the dot product of the columns of 'a' and the rows of 'b'.
-    float a0   = a16[0];
-    float a1   = a16[1];
-    float a2   = a16[2];
-    float a3   = a16[3];
-    float a4   = a16[4];
-    float a5   = a16[5];
-    float a6   = a16[6];
-    float a7   = a16[7];
-    float a8   = a16[8];
-    float a9   = a16[9];
-    float a10  = a16[10];
-    float a11  = a16[11];
-    float a12  = a16[12];
-    float a13  = a16[13];
-    float a14  = a16[14];
-    float a15  = a16[15];
-    float b0   = b16[0];
-    float b1   = b16[1];
-    float b2   = b16[2];
-    float b3   = b16[3];
-    float b4   = b16[4];
-    float b5   = b16[5];
-    float b6   = b16[6];
-    float b7   = b16[7];
-    float b8   = b16[8];
-    float b9   = b16[9];
-    float b10  = b16[10];
-    float b11  = b16[11];
-    float b12  = b16[12];
-    float b13  = b16[13];
-    float b14  = b16[14];
-    float b15  = b16[15];
-
-    dst16[0]   = b0 * a0  + b4 * a1  + b8  * a2  + b12 * a3;
-    dst16[1]   = b1 * a0  + b5 * a1  + b9  * a2  + b13 * a3;
-    dst16[2]   = b2 * a0  + b6 * a1  + b10 * a2  + b14 * a3;
-    dst16[3]   = b3 * a0  + b7 * a1  + b11 * a2  + b15 * a3;
-
-    dst16[4]   = b0 * a4  + b4 * a5  + b8  * a6  + b12 * a7;
-    dst16[5]   = b1 * a4  + b5 * a5  + b9  * a6  + b13 * a7;
-    dst16[6]   = b2 * a4  + b6 * a5  + b10 * a6  + b14 * a7;
-    dst16[7]   = b3 * a4  + b7 * a5  + b11 * a6  + b15 * a7;
-
-    dst16[8]   = b0 * a8  + b4 * a9  + b8  * a10 + b12 * a11;
-    dst16[9]   = b1 * a8  + b5 * a9  + b9  * a10 + b13 * a11;
-    dst16[10]  = b2 * a8  + b6 * a9  + b10 * a10 + b14 * a11;
-    dst16[11]  = b3 * a8  + b7 * a9  + b11 * a10 + b15 * a11;
-
-    dst16[12]  = b0 * a12 + b4 * a13 + b8  * a14 + b12 * a15;
-    dst16[13]  = b1 * a12 + b5 * a13 + b9  * a14 + b13 * a15;
-    dst16[14]  = b2 * a12 + b6 * a13 + b10 * a14 + b14 * a15;
-    dst16[15]  = b3 * a12 + b7 * a13 + b11 * a14 + b15 * a15;
-
-    return dst16;
-}
-
 float* mat4_inv_affine(float * __restrict dst16, float const * __restrict src16)
 {
     float c0  = src16[5] * src16[10] - src16[6] * src16[9];
@@ -2231,9 +1338,9 @@ float* mat4_look_at(float * __restrict dst16, float const * __restrict pos_xyz,
     tx = -vec3_dot(d1, xn, pos_xyz);
     ty = -vec3_dot(d2, y,  pos_xyz);
     tz = -vec3_dot(d3, zn, pos_xyz);
-    dst16[0]  = x[0];  dst16[1]  = y[0];  dst16[2]  = z[0];  dst16[3]  = 0.0f;
-    dst16[4]  = x[1];  dst16[5]  = y[1];  dst16[6]  = z[1];  dst16[7]  = 0.0f;
-    dst16[8]  = x[2];  dst16[9]  = y[2];  dst16[10] = z[2];  dst16[11] = 0.0f;
+    dst16[0]  = xn[0]; dst16[1]  = y[0];  dst16[2]  = zn[0]; dst16[3]  = 0.0f;
+    dst16[4]  = xn[1]; dst16[5]  = y[1];  dst16[6]  = zn[1]; dst16[7]  = 0.0f;
+    dst16[8]  = xn[2]; dst16[9]  = y[2];  dst16[10] = zn[2]; dst16[11] = 0.0f;
     dst16[12] = tx;    dst16[13] = ty;    dst16[14] = tz;    dst16[15] = 1.0f;
     return dst16;
 }
@@ -2309,14 +1416,20 @@ void mat4_extract_frustum_n(
     float       * __restrict far_xyzD,
     float const * __restrict src16)
 {
-    float l[4], r[4], t[4], b[4], n[4], f[4];
-    mat4_extract_frustum_u(l, r, t, b, n, f, src16);
-    vec3_nrm(left_xyzD,    l);
-    vec3_nrm(right_xyzD,   r);
-    vec3_nrm(top_xyzD,     t);
-    vec3_nrm(bottom_xyzD,  b);
-    vec3_nrm(near_xyzD,    n);
-    vec3_nrm(far_xyzD,     f);
+    float *planes[6] = { left_xyzD, right_xyzD, top_xyzD, bottom_xyzD, near_xyzD, far_xyzD };
+    mat4_extract_frustum_u(left_xyzD, right_xyzD, top_xyzD, bottom_xyzD, near_xyzD, far_xyzD, src16);
+    for (size_t i = 0; i < 6; ++i)
+    {
+        // scale D along with the normal, so that the plane equation gives
+        // the signed distance to a point.
+        float *p = planes[i];
+        float len;
+        float rcp = 1.0f / vec3_len(len, p);
+        p[0] *= rcp;
+        p[1] *= rcp;
+        p[2] *= rcp;
+        p[3] *= rcp;
+    }
 }
 
 void mat4_extract_frustum_u(
@@ -2359,141 +1472,124 @@ void mat4_extract_frustum_u(
     far_xyzD[3]    = src16[15] - src16[14];
 }
 
-float* mat4_transform_vec3(
+float* mat4_transform_array_vec3(
     float       * __restrict dst_xyz,
     float const * __restrict src_xyz,
-    float const * __restrict t16)
+    float const * __restrict t16,
+    size_t                   count)
 {
-    float vx = src_xyz[0];
-    float vy = src_xyz[1];
-    float vz = src_xyz[2];
-
-    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12];
-    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13];
-    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14];
-
-    return dst_xyz;
+    return mat4_transform_array_point(dst_xyz, src_xyz, t16, count);
 }
 
-float* mat4_transform_vec4(
+float* mat4_transform_array_vec4(
     float       * __restrict dst_xyzw,
     float const * __restrict src_xyzw,
-    float const * __restrict t16)
+    float const * __restrict t16,
+    size_t                   count)
 {
-    float vx = src_xyzw[0];
-    float vy = src_xyzw[1];
-    float vz = src_xyzw[2];
-    float vw = src_xyzw[3];
-
-    dst_xyzw[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12] * vw;
-    dst_xyzw[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13] * vw;
-    dst_xyzw[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14] * vw;
-    dst_xyzw[3] = t16[3] * vx + t16[7] * vy + t16[11] * vz + t16[15] * vw;
-
+    bool stream = use_streaming_stores(dst_xyzw, count * 4 * sizeof(float), 32);
+    transform_array_xyzw(dst_xyzw, src_xyzw, t16, count, stream);
     return dst_xyzw;
 }
 
-float* mat4_transform_point(
+float* mat4_transform_array_point(
     float       * __restrict dst_xyz,
     float const * __restrict src_xyz,
-    float const * __restrict t16)
+    float const * __restrict t16,
+    size_t                   count)
 {
-    float vx = src_xyz[0];
-    float vy = src_xyz[1];
-    float vz = src_xyz[2];
-
-    // for points, w = 1.0
-    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12];
-    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13];
-    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14];
-
+    bool stream = use_streaming_stores(dst_xyz, count * 3 * sizeof(float), 16);
+    transform_array_xyz(dst_xyz, src_xyz, t16, count, 1.0f, stream);
     return dst_xyz;
 }
 
-float* mat4_transform_vector(
+float* mat4_transform_array_vector(
     float       * __restrict dst_xyz,
     float const * __restrict src_xyz,
-    float const * __restrict t16)
+    float const * __restrict t16,
+    size_t                   count)
 {
-    float vx = src_xyz[0];
-    float vy = src_xyz[1];
-    float vz = src_xyz[2];
+    bool stream = use_streaming_stores(dst_xyz, count * 3 * sizeof(float), 16);
+    transform_array_xyz(dst_xyz, src_xyz, t16, count, 0.0f, stream);
+    return dst_xyz;
+}
 
-    // for vectors, w = 0.0
-    dst_xyz[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz;
-    dst_xyz[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz;
-    dst_xyz[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz;
+void mat4_transform_soa_point(
+    float       * __restrict dst_x,
+    float       * __restrict dst_y,
+    float       * __restrict dst_z,
+    float const * __restrict src_x,
+    float const * __restrict src_y,
+    float const * __restrict src_z,
+    float const * __restrict t16,
+    size_t                   count)
+{
+    transform_soa_xyz(dst_x, dst_y, dst_z, src_x, src_y, src_z, t16, count, 1.0f);
+}
 
-    return dst_xyz;
+void mat4_transform_soa_vector(
+    float       * __restrict dst_x,
+    float       * __restrict dst_y,
+    float       * __restrict dst_z,
+    float const * __restrict src_x,
+    float const * __restrict src_y,
+    float const * __restrict src_z,
+    float const * __restrict t16,
+    size_t                   count)
+{
+    transform_soa_xyz(dst_x, dst_y, dst_z, src_x, src_y, src_z, t16, count, 0.0f);
 }
 
-float* mat4_transform_array_vec4(
+float* mat4_transform_array_vec4_mt(
     float       * __restrict dst_xyzw,
     float const * __restrict src_xyzw,
     float const * __restrict t16,
-    size_t                 count)
+    size_t                   count,
+    task_pool_t             *pool)
 {
-    float  *dst = dst_xyzw;
-    for (size_t i = 0; i < count; ++i)
-    {
-        float x = src_xyzw[0];
-        float y = src_xyzw[1];
-        float z = src_xyzw[2];
-        float w = src_xyzw[3];
-
-        dst_xyzw[0]  = t16[0] * x + t16[4] * y + t16[8]  * z + t16[12] * w;
-        dst_xyzw[1]  = t16[1] * x + t16[5] * y + t16[9]  * z + t16[13] * w;
-        dst_xyzw[2]  = t16[2] * x + t16[6] * y + t16[10] * z + t16[14] * w;
-        dst_xyzw[3]  = t16[3] * x + t16[7] * y + t16[11] * z + t16[15] * w;
-
-        src_xyzw += 4;
-        dst_xyzw += 4;
-    }
-    return dst;
+    transform_array_mt(dst_xyzw, src_xyzw, t16, count, 4, 1.0f, pool);
+    return dst_xyzw;
 }
 
-float* mat4_transform_array_point(
+float* mat4_transform_array_point_mt(
     float       * __restrict dst_xyz,
     float const * __restrict src_xyz,
     float const * __restrict t16,
-    size_t                 count)
+    size_t                   count,
+    task_pool_t             *pool)
 {
-    float  *dst = dst_xyz;
-    for (size_t i = 0; i < count; ++i)
-    {
-        float x = src_xyz[0];
-        float y = src_xyz[1];
-        float z = src_xyz[2];
-
-        dst_xyz[0] = t16[0] * x + t16[4] * y + t16[8]  * z + t16[12];
-        dst_xyz[1] = t16[1] * x + t16[5] * y + t16[9]  * z + t16[13];
-        dst_xyz[2] = t16[2] * x + t16[6] * y + t16[10] * z + t16[14];
-
-        src_xyz += 3;
-        dst_xyz += 3;
-    }
-    return dst;
+    transform_array_mt(dst_xyz, src_xyz, t16, count, 3, 1.0f, pool);
+    return dst_xyz;
 }
 
-float* mat4_transform_array_vector(
+float* mat4_transform_array_vector_mt(
     float       * __restrict dst_xyz,
     float const * __restrict src_xyz,
     float const * __restrict t16,
-    size_t                 count)
+    size_t                   count,
+    task_pool_t             *pool)
 {
-    float  *dst = dst_xyz;
-    for (size_t i = 0; i < count; ++i)
-    {
-        float x = src_xyz[0];
-        float y = src_xyz[1];
-        float z = src_xyz[2];
-
-        dst_xyz[0] = t16[0] * x + t16[4] * y + t16[8]  * z;
-        dst_xyz[1] = t16[1] * x + t16[5] * y + t16[9]  * z;
-        dst_xyz[2] = t16[2] * x + t16[6] * y + t16[10] * z;
+    transform_array_mt(dst_xyz, src_xyz, t16, count, 3, 0.0f, pool);
+    return dst_xyz;
+}
 
-        src_xyz += 3;
-        dst_xyz += 3;
-    }
-    return dst;
+void mat4_transform_soa_point_mt(
+    float       * __restrict dst_x,
+    float       * __restrict dst_y,
+    float       * __restrict dst_z,
+    float const * __restrict src_x,
+    float const * __restrict src_y,
+    float const * __restrict src_z,
+    float const * __restrict t16,
+    size_t                   count,
+    task_pool_t             *pool)
+{
+    transform_soa_job_t job;
+    job.Dst[0] = dst_x; job.Dst[1] = dst_y; job.Dst[2] = dst_z;
+    job.Src[0] = src_x; job.Src[1] = src_y; job.Src[2] = src_z;
+    job.T16    = t16;
+    job.Count  = count;
+    job.W      = 1.0f;
+    size_t blocks = (count + MATH_TRANSFORM_BLOCK - 1) / MATH_TRANSFORM_BLOCK;
+    task_pool_parallel_for(pool, blocks, 1, transform_soa_job_range, &job);
 }
@@ -0,0 +1,292 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a multi-lane xoshiro128++ pseudo-random number
+/// generator. See http://prng.di.unimi.it/ for a description of the algorithm.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <string.h>
+#include "math_rng.hpp"
+#include "math_trig.hpp"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif GW_MATH_SSE2
+    #include <emmintrin.h>
+#endif
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The xoshiro128 jump polynomial, equivalent to 2^64 calls to next().
+static const uint32_t XOSHIRO128_JUMP[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+/// @summary The value 2^-24, used to convert 24 random bits to [0, 1).
+#define RANDOM8_FLOAT_SCALE   (1.0f / 16777216.0f)
+
+/// @summary The value 2 * pi, used by the Box-Muller transform.
+#define RANDOM8_TWO_PI        (6.28318530717958648f)
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Rotates a 32-bit value left.
+static inline uint32_t rotl32(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+/// @summary Advances a single xoshiro128 state by one step.
+/// @param s The four state words of the lane.
+static inline void xoshiro128_step(uint32_t s[4])
+{
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = rotl32(s[3], 11);
+}
+
+/// @summary Advances a single xoshiro128 state by 2^64 steps.
+/// @param s The four state words of the lane.
+static void xoshiro128_jump(uint32_t s[4])
+{
+    uint32_t j[4] = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        for (int b = 0; b < 32; ++b)
+        {
+            if (XOSHIRO128_JUMP[i] & (1U << b))
+            {
+                j[0] ^= s[0];
+                j[1] ^= s[1];
+                j[2] ^= s[2];
+                j[3] ^= s[3];
+            }
+            xoshiro128_step(s);
+        }
+    }
+    s[0] = j[0]; s[1] = j[1]; s[2] = j[2]; s[3] = j[3];
+}
+
+/// @summary Jumps one lane of a multi-lane generator a number of times.
+/// @param rng The generator state.
+/// @param lane The zero-based lane index.
+/// @param count The number of 2^64-step jumps to apply.
+static void jump_lane(rng8_state_t *rng, size_t lane, size_t count)
+{
+    uint32_t s[4] = { rng->s[0][lane], rng->s[1][lane], rng->s[2][lane], rng->s[3][lane] };
+    for (size_t i = 0; i < count; ++i)
+    {
+        xoshiro128_jump(s);
+    }
+    rng->s[0][lane] = s[0];
+    rng->s[1][lane] = s[1];
+    rng->s[2][lane] = s[2];
+    rng->s[3][lane] = s[3];
+}
+
+/// @summary Produces the next output of SplitMix64, used for seed expansion.
+/// @param x The SplitMix64 state, updated on return.
+/// @return The next 64-bit output.
+static inline uint64_t splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/// @summary Generates RANDOM8_LANES 32-bit outputs and advances every lane.
+/// @param rng The generator state.
+/// @param out Storage for RANDOM8_LANES values. Need not be aligned.
+static inline void random8_next(rng8_state_t *rng, uint32_t *out)
+{
+#if defined(__AVX2__)
+    __m256i s0 = _mm256_loadu_si256((__m256i const*) rng->s[0]);
+    __m256i s1 = _mm256_loadu_si256((__m256i const*) rng->s[1]);
+    __m256i s2 = _mm256_loadu_si256((__m256i const*) rng->s[2]);
+    __m256i s3 = _mm256_loadu_si256((__m256i const*) rng->s[3]);
+    // result = rotl(s0 + s3, 7) + s0
+    __m256i r  = _mm256_add_epi32(s0, s3);
+    r  = _mm256_add_epi32(_mm256_or_si256(_mm256_slli_epi32(r, 7), _mm256_srli_epi32(r, 25)), s0);
+    __m256i t  = _mm256_slli_epi32(s1, 9);
+    s2 = _mm256_xor_si256(s2, s0);
+    s3 = _mm256_xor_si256(s3, s1);
+    s1 = _mm256_xor_si256(s1, s2);
+    s0 = _mm256_xor_si256(s0, s3);
+    s2 = _mm256_xor_si256(s2, t);
+    s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+    _mm256_storeu_si256((__m256i*) out, r);
+    _mm256_storeu_si256((__m256i*) rng->s[0], s0);
+    _mm256_storeu_si256((__m256i*) rng->s[1], s1);
+    _mm256_storeu_si256((__m256i*) rng->s[2], s2);
+    _mm256_storeu_si256((__m256i*) rng->s[3], s3);
+#elif GW_MATH_SSE2
+    for (size_t i = 0; i < RANDOM8_LANES; i += 4)
+    {
+        __m128i s0 = _mm_loadu_si128((__m128i const*) &rng->s[0][i]);
+        __m128i s1 = _mm_loadu_si128((__m128i const*) &rng->s[1][i]);
+        __m128i s2 = _mm_loadu_si128((__m128i const*) &rng->s[2][i]);
+        __m128i s3 = _mm_loadu_si128((__m128i const*) &rng->s[3][i]);
+        __m128i r  = _mm_add_epi32(s0, s3);
+        r  = _mm_add_epi32(_mm_or_si128(_mm_slli_epi32(r, 7), _mm_srli_epi32(r, 25)), s0);
+        __m128i t  = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+        _mm_storeu_si128((__m128i*) (out + i), r);
+        _mm_storeu_si128((__m128i*) &rng->s[0][i], s0);
+        _mm_storeu_si128((__m128i*) &rng->s[1][i], s1);
+        _mm_storeu_si128((__m128i*) &rng->s[2][i], s2);
+        _mm_storeu_si128((__m128i*) &rng->s[3][i], s3);
+    }
+#else
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        uint32_t s[4] = { rng->s[0][i], rng->s[1][i], rng->s[2][i], rng->s[3][i] };
+        out[i] = rotl32(s[0] + s[3], 7) + s[0];
+        xoshiro128_step(s);
+        rng->s[0][i] = s[0];
+        rng->s[1][i] = s[1];
+        rng->s[2][i] = s[2];
+        rng->s[3][i] = s[3];
+    }
+#endif
+}
+
+/// @summary Converts RANDOM8_LANES 32-bit outputs to floats in [min, max).
+/// @param dst Storage for RANDOM8_LANES values. Need not be aligned.
+/// @param bits The random bits to convert.
+/// @param min_value The inclusive lower bound of the range.
+/// @param range The value max_value - min_value.
+static inline void bits_to_uniform(float *dst, uint32_t const *bits, float min_value, float range)
+{
+#if GW_MATH_SSE2
+    __m128 scale = _mm_set1_ps(range * RANDOM8_FLOAT_SCALE);
+    __m128 bias  = _mm_set1_ps(min_value);
+    for (size_t i = 0; i < RANDOM8_LANES; i += 4)
+    {
+        __m128i b = _mm_srli_epi32(_mm_loadu_si128((__m128i const*) (bits + i)), 8);
+        _mm_storeu_ps(dst + i, _mm_add_ps(bias, _mm_mul_ps(_mm_cvtepi32_ps(b), scale)));
+    }
+#else
+    float scale = range * RANDOM8_FLOAT_SCALE;
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        dst[i] = min_value + float(bits[i] >> 8) * scale;
+    }
+#endif
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void random8_seed(rng8_state_t *rng, uint64_t seed)
+{
+    uint64_t x  = seed;
+    uint64_t a  = splitmix64(x);
+    uint64_t b  = splitmix64(x);
+    rng->s[0][0] = uint32_t(a);
+    rng->s[1][0] = uint32_t(a >> 32);
+    rng->s[2][0] = uint32_t(b);
+    rng->s[3][0] = uint32_t(b >> 32);
+    if ((a | b) == 0)
+    {
+        // the all-zero state is a fixed point of the generator.
+        rng->s[0][0] = 1;
+    }
+    for (size_t i = 1; i < RANDOM8_LANES; ++i)
+    {
+        rng->s[0][i] = rng->s[0][i-1];
+        rng->s[1][i] = rng->s[1][i-1];
+        rng->s[2][i] = rng->s[2][i-1];
+        rng->s[3][i] = rng->s[3][i-1];
+        jump_lane(rng, i, 1);
+    }
+}
+
+void random8_jump(rng8_state_t *rng)
+{
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        jump_lane(rng, i, RANDOM8_LANES);
+    }
+}
+
+void random8_stream(rng8_state_t *rng, uint64_t seed, size_t stream_index)
+{
+    random8_seed(rng, seed);
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        jump_lane(rng, i, RANDOM8_LANES * stream_index);
+    }
+}
+
+void random8_fill_bits(uint32_t *dst, size_t count, rng8_state_t *rng)
+{
+    size_t i = 0;
+    for ( ; i + RANDOM8_LANES <= count; i += RANDOM8_LANES)
+    {
+        random8_next(rng, dst + i);
+    }
+    if (i < count)
+    {
+        uint32_t tail[RANDOM8_LANES];
+        random8_next(rng, tail);
+        memcpy(dst + i, tail, (count - i) * sizeof(uint32_t));
+    }
+}
+
+void random8_fill_uniform(float *dst, size_t count, float min_value, float max_value, rng8_state_t *rng)
+{
+    uint32_t bits[RANDOM8_LANES];
+    float    range = max_value - min_value;
+    size_t   i     = 0;
+    for ( ; i + RANDOM8_LANES <= count; i += RANDOM8_LANES)
+    {
+        random8_next(rng, bits);
+        bits_to_uniform(dst + i, bits, min_value, range);
+    }
+    if (i < count)
+    {
+        float tail[RANDOM8_LANES];
+        random8_next(rng, bits);
+        bits_to_uniform(tail, bits, min_value, range);
+        memcpy(dst + i, tail, (count - i) * sizeof(float));
+    }
+}
+
+void random8_fill_gaussian(float *dst, size_t count, float mean, float stddev, rng8_state_t *rng)
+{
+    uint32_t bits[RANDOM8_LANES];
+    float    u1[RANDOM8_LANES];
+    float    u2[RANDOM8_LANES];
+    float    sn[RANDOM8_LANES];
+    float    cs[RANDOM8_LANES];
+    size_t   i = 0;
+    while (i < count)
+    {
+        // each block produces 2 * RANDOM8_LANES values from as many pairs.
+        // u1 is drawn from (0, 1] so that the logarithm is finite.
+        random8_next(rng, bits);
+        bits_to_uniform(u1, bits, RANDOM8_FLOAT_SCALE, 1.0f);
+        random8_next(rng, bits);
+        bits_to_uniform(u2, bits, 0.0f, RANDOM8_TWO_PI);
+        fast_sincos_array(sn, cs, u2, RANDOM8_LANES, TRIG_TIER_PRECISE);
+        for (size_t j = 0; j < RANDOM8_LANES && i < count; ++j)
+        {
+            float r = stddev * sqrtf(-2.0f * logf(u1[j]));
+            dst[i++] = mean + r * cs[j];
+            if (i < count) dst[i++] = mean + r * sn[j];
+        }
+    }
+}
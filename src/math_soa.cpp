@@ -0,0 +1,201 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the structure-of-arrays 2D vector kernels. Each kernel
+/// is written once against the lane operations in math_soa.hpp and run over
+/// the array using soa_for_range().
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include "math_soa.hpp"
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel computing y += a * x.
+struct soa_axpy_k
+{
+    float       *YX, *YY;
+    float const *XX, *XY;
+    float        A;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t a = L::splat(A);
+        L::store(YX + i, L::add(L::load(YX + i), L::mul(a, L::load(XX + i))));
+        L::store(YY + i, L::add(L::load(YY + i), L::mul(a, L::load(XY + i))));
+    }
+};
+
+/// @summary Kernel computing v *= s.
+struct soa_scale_k
+{
+    float *X, *Y;
+    float  S;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t s = L::splat(S);
+        L::store(X + i, L::mul(L::load(X + i), s));
+        L::store(Y + i, L::mul(L::load(Y + i), s));
+    }
+};
+
+/// @summary Kernel computing v /= |v|, leaving zero-length vectors as zero.
+struct soa_normalize_k
+{
+    float *X, *Y;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t x   = L::load(X + i);
+        typename L::value_t y   = L::load(Y + i);
+        typename L::value_t ls  = L::add(L::mul(x, x), L::mul(y, y));
+        typename L::value_t inv = L::select_lt(L::splat(0.0f), ls, L::div(L::splat(1.0f), L::sqrt(ls)));
+        L::store(X + i, L::mul(x, inv));
+        L::store(Y + i, L::mul(y, inv));
+    }
+};
+
+/// @summary Kernel computing dst = v / |v|, with zero vectors mapped to (1, 0).
+/// Each element is loaded before it is stored, so dst may alias v.
+struct soa_direction_k
+{
+    float       *C, *S;
+    float const *X, *Y;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t x   = L::load(X + i);
+        typename L::value_t y   = L::load(Y + i);
+        typename L::value_t ls  = L::add(L::mul(x, x), L::mul(y, y));
+        typename L::value_t one = L::splat(1.0f);
+        typename L::value_t inv = L::select_lt(L::splat(0.0f), ls, L::div(one, L::sqrt(ls)));
+        typename L::value_t nz  = L::select_lt(L::splat(0.0f), ls, one);
+        L::store(C + i, L::add(L::mul(x, inv), L::sub(one, nz)));
+        L::store(S + i, L::mul(y, inv));
+    }
+};
+
+/// @summary Kernel computing dst = |v|.
+struct soa_length_k
+{
+    float       *D;
+    float const *X, *Y;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t x = L::load(X + i);
+        typename L::value_t y = L::load(Y + i);
+        L::store(D + i, L::sqrt(L::add(L::mul(x, x), L::mul(y, y))));
+    }
+};
+
+/// @summary Kernel clamping points to a rectangle.
+struct soa_clamp_rect_k
+{
+    float *X, *Y;
+    float  MinX, MinY, MaxX, MaxY;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        L::store(X + i, L::min(L::max(L::load(X + i), L::splat(MinX)), L::splat(MaxX)));
+        L::store(Y + i, L::min(L::max(L::load(Y + i), L::splat(MinY)), L::splat(MaxY)));
+    }
+};
+
+/// @summary Kernel computing dst = |v - p|.
+struct soa_distance_k
+{
+    float       *D;
+    float const *X, *Y;
+    float        PX, PY;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::sub(L::load(X + i), L::splat(PX));
+        typename L::value_t dy = L::sub(L::load(Y + i), L::splat(PY));
+        L::store(D + i, L::sqrt(L::add(L::mul(dx, dx), L::mul(dy, dy))));
+    }
+};
+
+/// @summary Kernel accumulating a softened inverse-square force toward a point.
+struct soa_radial_force_k
+{
+    float       *FX, *FY;
+    float const *X, *Y;
+    float        CX, CY, Strength, RadiusSq, Softening;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dx = L::sub(L::splat(CX), L::load(X + i));
+        typename L::value_t dy = L::sub(L::splat(CY), L::load(Y + i));
+        typename L::value_t ds = L::add(L::mul(dx, dx), L::mul(dy, dy));
+        typename L::value_t sd = L::add(ds, L::splat(Softening));
+        typename L::value_t m  = L::div(L::splat(Strength), L::mul(sd, L::sqrt(sd)));
+        m = L::select_lt(ds, L::splat(RadiusSq), m);
+        L::store(FX + i, L::add(L::load(FX + i), L::mul(dx, m)));
+        L::store(FY + i, L::add(L::load(FY + i), L::mul(dy, m)));
+    }
+};
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void vec2_soa_axpy(float * __restrict y_x, float * __restrict y_y, float const * __restrict x_x, float const * __restrict x_y, float a, size_t count)
+{
+    soa_axpy_k k = { y_x, y_y, x_x, x_y, a };
+    soa_for_range(k, y_x, 0, count);
+}
+
+void vec2_soa_scale(float * __restrict x, float * __restrict y, float s, size_t count)
+{
+    soa_scale_k k = { x, y, s };
+    soa_for_range(k, x, 0, count);
+}
+
+void vec2_soa_normalize(float * __restrict x, float * __restrict y, size_t count)
+{
+    soa_normalize_k k = { x, y };
+    soa_for_range(k, x, 0, count);
+}
+
+void vec2_soa_direction(float *dst_cos, float *dst_sin, float const *x, float const *y, size_t count)
+{
+    soa_direction_k k = { dst_cos, dst_sin, x, y };
+    soa_for_range(k, dst_cos, 0, count);
+}
+
+void vec2_soa_length(float * __restrict dst, float const * __restrict x, float const * __restrict y, size_t count)
+{
+    soa_length_k k = { dst, x, y };
+    soa_for_range(k, dst, 0, count);
+}
+
+void vec2_soa_clamp_rect(float * __restrict x, float * __restrict y, float min_x, float min_y, float max_x, float max_y, size_t count)
+{
+    soa_clamp_rect_k k = { x, y, min_x, min_y, max_x, max_y };
+    soa_for_range(k, x, 0, count);
+}
+
+void vec2_soa_distance(float * __restrict dst, float const * __restrict x, float const * __restrict y, float px, float py, size_t count)
+{
+    soa_distance_k k = { dst, x, y, px, py };
+    soa_for_range(k, dst, 0, count);
+}
+
+void vec2_soa_radial_force(float * __restrict fx, float * __restrict fy, float const * __restrict x, float const * __restrict y, float cx, float cy, float strength, float radius, float softening, size_t count)
+{
+    soa_radial_force_k k = { fx, fy, x, y, cx, cy, strength, radius * radius, softening };
+    soa_for_range(k, fx, 0, count);
+}
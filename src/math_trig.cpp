@@ -0,0 +1,159 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the array forms of the fast trig routines, using AVX
+/// when available and falling back to the 4-wide and scalar header routines.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "math_trig.hpp"
+
+#ifdef __AVX__
+    #include <immintrin.h>
+#endif
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+#ifdef __AVX__
+/// @summary Selects lanes from a where mask is set and from b elsewhere.
+static inline __m256 avx_select(__m256 mask, __m256 a, __m256 b)
+{
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+/// @summary Computes the sine and cosine of eight angles.
+/// @param x The angles, in radians.
+/// @param out_sin On return, set to the sines of x.
+/// @param out_cos On return, set to the cosines of x.
+/// @param tier One of trig_tier_e.
+static inline void avx_sincos(__m256 x, __m256 &out_sin, __m256 &out_cos, int tier)
+{
+    // AVX lacks 256-bit integer operations, so the quadrant is kept in float.
+    __m256 q  = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(TRIG_2_OVER_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r  = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(TRIG_PIO2_HI)));
+           r  = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(TRIG_PIO2_MD)));
+           r  = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(TRIG_PIO2_LO)));
+    __m256 z  = _mm256_mul_ps(r, r);
+    __m256 s, c;
+    if (tier == TRIG_TIER_FAST)
+    {
+        s = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_FAST_S5)), _mm256_set1_ps(TRIG_FAST_S3));
+        s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), s));
+        c = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_FAST_C4)), _mm256_set1_ps(TRIG_FAST_C2));
+        c = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(z, c));
+    }
+    else
+    {
+        s = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_PRECISE_S7)), _mm256_set1_ps(TRIG_PRECISE_S5));
+        s = _mm256_add_ps(_mm256_mul_ps(z, s), _mm256_set1_ps(TRIG_PRECISE_S3));
+        s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, z), s));
+        c = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_PRECISE_C8)), _mm256_set1_ps(TRIG_PRECISE_C6));
+        c = _mm256_add_ps(_mm256_mul_ps(z, c), _mm256_set1_ps(TRIG_PRECISE_C4));
+        c = _mm256_mul_ps(_mm256_mul_ps(z, z), c);
+        c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), z)), c);
+    }
+    // m = q mod 4, in [0, 3]; sin negates for m in {2, 3} and cos for m in {1, 2}.
+    __m256 m    = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_set1_ps(4.0f), _mm256_floor_ps(_mm256_mul_ps(q, _mm256_set1_ps(0.25f)))));
+    __m256 m1   = _mm256_cmp_ps(m, _mm256_set1_ps(1.0f), _CMP_EQ_OQ);
+    __m256 m2   = _mm256_cmp_ps(m, _mm256_set1_ps(2.0f), _CMP_EQ_OQ);
+    __m256 m3   = _mm256_cmp_ps(m, _mm256_set1_ps(3.0f), _CMP_EQ_OQ);
+    __m256 swap = _mm256_or_ps(m1, m3);
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 sneg = _mm256_and_ps(_mm256_or_ps(m2, m3), sign);
+    __m256 cneg = _mm256_and_ps(_mm256_or_ps(m1, m2), sign);
+    out_sin     = _mm256_xor_ps(avx_select(swap, c, s), sneg);
+    out_cos     = _mm256_xor_ps(avx_select(swap, s, c), cneg);
+}
+
+/// @summary Computes the angles of eight vectors (x, y).
+/// @param y The y-components of the vectors.
+/// @param x The x-components of the vectors.
+/// @param tier One of trig_tier_e.
+/// @return The angles, in radians, in [-pi, pi].
+static inline __m256 avx_atan2(__m256 y, __m256 x, int tier)
+{
+    __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 zero = _mm256_setzero_ps();
+    __m256 ax   = _mm256_andnot_ps(sign, x);
+    __m256 ay   = _mm256_andnot_ps(sign, y);
+    __m256 mn   = _mm256_min_ps(ax, ay);
+    __m256 mx   = _mm256_max_ps(ax, ay);
+    __m256 t    = _mm256_and_ps(_mm256_div_ps(mn, mx), _mm256_cmp_ps(mx, zero, _CMP_GT_OQ));
+    __m256 a;
+    if (tier == TRIG_TIER_FAST)
+    {
+        __m256 z = _mm256_mul_ps(t, t);
+        a = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_FAST_A7)), _mm256_set1_ps(TRIG_FAST_A5));
+        a = _mm256_add_ps(_mm256_mul_ps(z, a), _mm256_set1_ps(TRIG_FAST_A3));
+        a = _mm256_add_ps(_mm256_mul_ps(z, a), _mm256_set1_ps(TRIG_FAST_A1));
+        a = _mm256_mul_ps(t, a);
+    }
+    else
+    {
+        __m256 big = _mm256_cmp_ps(t, _mm256_set1_ps(TRIG_TAN_PI_OVER_8), _CMP_GT_OQ);
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 tr  = _mm256_div_ps(_mm256_sub_ps(t, one), _mm256_add_ps(t, one));
+        __m256 o   = _mm256_and_ps(big, _mm256_set1_ps(TRIG_PI_OVER_4));
+               t   = avx_select(big, tr, t);
+        __m256 z   = _mm256_mul_ps(t, t);
+        a = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(TRIG_PRECISE_A9)), _mm256_set1_ps(TRIG_PRECISE_A7));
+        a = _mm256_add_ps(_mm256_mul_ps(z, a), _mm256_set1_ps(TRIG_PRECISE_A5));
+        a = _mm256_add_ps(_mm256_mul_ps(z, a), _mm256_set1_ps(TRIG_PRECISE_A3));
+        a = _mm256_add_ps(o, _mm256_add_ps(t, _mm256_mul_ps(_mm256_mul_ps(t, z), a)));
+    }
+    a = avx_select(_mm256_cmp_ps(ay, ax, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(TRIG_PI_OVER_2), a), a);
+    // test the sign bit of x rather than x < 0 so that x = -0 selects pi.
+    __m256 negx = _mm256_cmp_ps(_mm256_or_ps(_mm256_and_ps(sign, x), _mm256_set1_ps(1.0f)), zero, _CMP_LT_OQ);
+    a = avx_select(negx, _mm256_sub_ps(_mm256_set1_ps(TRIG_PI), a), a);
+    return _mm256_or_ps(a, _mm256_and_ps(sign, y));
+}
+#endif /* defined(__AVX__) */
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+void fast_sincos_array(float * __restrict dst_sin, float * __restrict dst_cos, float const * __restrict src, size_t count, int tier)
+{
+    size_t i = 0;
+#ifdef __AVX__
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 s, c;
+        avx_sincos(_mm256_loadu_ps(src + i), s, c, tier);
+        _mm256_storeu_ps(dst_sin + i, s);
+        _mm256_storeu_ps(dst_cos + i, c);
+    }
+#endif
+    for (; i + 4 <= count; i += 4)
+    {
+        vec4_t s, c;
+        fast_sincos(vec4_load(src + i), s, c, tier);
+        vec4_store(dst_sin + i, s);
+        vec4_store(dst_cos + i, c);
+    }
+    for (; i < count; ++i)
+    {
+        fast_sincos(src[i], dst_sin[i], dst_cos[i], tier);
+    }
+}
+
+void fast_atan2_array(float * __restrict dst, float const * __restrict src_y, float const * __restrict src_x, size_t count, int tier)
+{
+    size_t i = 0;
+#ifdef __AVX__
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(dst + i, avx_atan2(_mm256_loadu_ps(src_y + i), _mm256_loadu_ps(src_x + i), tier));
+    }
+#endif
+    for (; i + 4 <= count; i += 4)
+    {
+        vec4_store(dst + i, fast_atan2(vec4_load(src_y + i), vec4_load(src_x + i), tier));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = fast_atan2(src_y[i], src_x[i], tier);
+    }
+}
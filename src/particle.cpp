@@ -0,0 +1,341 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the particle system. The per-tick update is a single
+/// fused SIMD pass over the attribute arrays, split across the task pool.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <math.h>
+#include <stdlib.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "math_trig.hpp"
+#include "ll_task.hpp"
+#include "particle.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of attribute arrays allocated for the pool.
+#define PARTICLE_ARRAY_COUNT         12U
+
+/// @summary The seed used for the burst direction generator.
+#define PARTICLE_RANDOM_SEED         0x5041525449434C45ULL
+
+/// @summary The global ParticleManager instance.
+ParticleManager* ParticleManager::PM = NULL;
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel applying drag, integrating position, and fading each
+/// particle for a single simulation tick.
+struct particle_update_k
+{
+    float       *PosX, *PosY, *VelX, *VelY, *Life, *Alpha;
+    float const *InvDuration;
+    float        Drag, Step;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t dt = L::splat(Step);
+        typename L::value_t vx = L::mul(L::load(VelX + i), L::splat(Drag));
+        typename L::value_t vy = L::mul(L::load(VelY + i), L::splat(Drag));
+        typename L::value_t lf = L::sub(L::load(Life + i), dt);
+        typename L::value_t a  = L::mul(lf, L::load(InvDuration + i));
+        L::store(VelX  + i, vx);
+        L::store(VelY  + i, vy);
+        L::store(PosX  + i, L::add(L::load(PosX + i), L::mul(vx, dt)));
+        L::store(PosY  + i, L::add(L::load(PosY + i), L::mul(vy, dt)));
+        L::store(Life  + i, lf);
+        L::store(Alpha + i, L::min(L::max(a, L::splat(0.0f)), L::splat(1.0f)));
+    }
+};
+
+/// @summary Kernel recomputing the fade factor of each particle from its
+/// remaining lifetime, as the update kernel does.
+struct particle_fade_k
+{
+    float const *Life, *InvDuration;
+    float       *Alpha;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t a = L::mul(L::load(Life + i), L::load(InvDuration + i));
+        L::store(Alpha + i, L::min(L::max(a, L::splat(0.0f)), L::splat(1.0f)));
+    }
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Runs the particle update kernel over a range of particles.
+/// @param begin The index of the first particle to update.
+/// @param end The index one past the last particle to update.
+/// @param context The particle_update_k describing the update.
+static void particle_update_range(size_t begin, size_t end, void *context)
+{
+    particle_update_k const *k = (particle_update_k const*) context;
+    soa_for_range(*k, k->PosX, begin, end);
+}
+
+/// @summary Scales each channel of a packed ABGR color by a fade factor.
+/// @param abgr The packed ABGR color.
+/// @param alpha The fade factor, in [0, 1].
+/// @return The faded color.
+static inline uint32_t fade_color(uint32_t abgr, float alpha)
+{
+    uint32_t a  = uint32_t(alpha * 255.0f);
+    uint32_t rb = (((abgr & 0x00FF00FFU) * a) >> 8) & 0x00FF00FFU;
+    uint32_t ga = (((abgr >> 8) & 0x00FF00FFU) * a) & 0xFF00FF00U;
+    return (rb | ga);
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+ParticleManager* ParticleManager::GetInstance(void)
+{
+    return PM;
+}
+
+ParticleManager::ParticleManager(size_t capacity, task_pool_t *pool)
+    :
+    TaskPool(pool),
+    Image(NULL),
+    Memory(NULL),
+    Capacity(capacity),
+    Count(0),
+    NextReplace(0),
+    BurstScale(1.0f)
+{
+    // every array starts on a SOA_ALIGNMENT boundary so that the
+    // update kernel runs entirely on aligned vectors.
+    size_t    stride = (capacity * sizeof(float) + (SOA_ALIGNMENT - 1)) & ~size_t(SOA_ALIGNMENT - 1);
+    Memory           = malloc(stride * PARTICLE_ARRAY_COUNT + SOA_ALIGNMENT);
+    uintptr_t base   = (uintptr_t(Memory) + (SOA_ALIGNMENT - 1)) & ~uintptr_t(SOA_ALIGNMENT - 1);
+    PosX             = (float   *) (base + stride *  0);
+    PosY             = (float   *) (base + stride *  1);
+    VelX             = (float   *) (base + stride *  2);
+    VelY             = (float   *) (base + stride *  3);
+    Life             = (float   *) (base + stride *  4);
+    InvDuration      = (float   *) (base + stride *  5);
+    Alpha            = (float   *) (base + stride *  6);
+    Scale            = (float   *) (base + stride *  7);
+    FacingCos        = (float   *) (base + stride *  8);
+    FacingSin        = (float   *) (base + stride *  9);
+    Color            = (uint32_t*) (base + stride * 10);
+    Tint             = (uint32_t*) (base + stride * 11);
+    random8_seed(&Random, PARTICLE_RANDOM_SEED);
+    ParticleManager::PM = this;
+}
+
+ParticleManager::~ParticleManager(void)
+{
+    free(Memory);
+    Memory   = NULL;
+    Count    = 0;
+    Capacity = 0;
+    ParticleManager::PM = NULL;
+}
+
+void ParticleManager::Init(DisplayManager *dm)
+{
+    Image = dm->GetLaserTexture();
+}
+
+void ParticleManager::Clear(void)
+{
+    Count       = 0;
+    NextReplace = 0;
+}
+
+size_t ParticleManager::Allocate(void)
+{
+    if (Count < Capacity)
+    {
+        return Count++;
+    }
+    // the pool is full; replace existing particles in ring order.
+    size_t slot = NextReplace;
+    if (++NextReplace >= Capacity) NextReplace = 0;
+    return slot;
+}
+
+void ParticleManager::Emit(float x, float y, float vx, float vy, float const *rgba, float duration, float scale)
+{
+    if (Capacity == 0) return;
+    size_t i       = Allocate();
+    PosX[i]        = x;
+    PosY[i]        = y;
+    VelX[i]        = vx;
+    VelY[i]        = vy;
+    Life[i]        = duration;
+    InvDuration[i] = 1.0f / duration;
+    Alpha[i]       = 1.0f;
+    Scale[i]       = scale;
+    Color[i]       = color32(rgba);
+}
+
+void ParticleManager::EmitBurst(float x, float y, size_t count, float min_speed, float max_speed, float const *rgba, float duration, float scale)
+{
+    float    angle[PARTICLE_BURST_BLOCK];
+    float    speed[PARTICLE_BURST_BLOCK];
+    float    sin_a[PARTICLE_BURST_BLOCK];
+    float    cos_a[PARTICLE_BURST_BLOCK];
+    uint32_t color   = color32(rgba);
+    float    inv_dur = 1.0f / duration;
+
+    if (Capacity == 0) return;
+    if (BurstScale < 1.0f && count > 0)
+    {
+        size_t n = size_t(float(count) * BurstScale);
+        count = n > 0 ? n : 1;
+    }
+    while (count > 0)
+    {
+        size_t n = count < PARTICLE_BURST_BLOCK ? count : PARTICLE_BURST_BLOCK;
+        random8_fill_uniform(angle, n, 0.0f, 2.0f * TRIG_PI, &Random);
+        random8_fill_uniform(speed, n, min_speed, max_speed, &Random);
+        fast_sincos_array(sin_a, cos_a, angle, n, TRIG_TIER_FAST);
+        for (size_t j = 0; j < n; ++j)
+        {
+            size_t i       = Allocate();
+            PosX[i]        = x;
+            PosY[i]        = y;
+            VelX[i]        = cos_a[j] * speed[j];
+            VelY[i]        = sin_a[j] * speed[j];
+            Life[i]        = duration;
+            InvDuration[i] = inv_dur;
+            Alpha[i]       = 1.0f;
+            Scale[i]       = scale;
+            Color[i]       = color;
+        }
+        count -= n;
+    }
+}
+
+void ParticleManager::ApplyForceField(force_field_t const *field, double elapsedTime)
+{
+    field_apply(field, VelX, VelY, PosX, PosY, Count, float(elapsedTime), TaskPool);
+}
+
+void ParticleManager::Update(double currentTime, double elapsedTime)
+{
+    UNUSED_ARG(currentTime);
+    if (Count == 0) return;
+
+    float step = float(elapsedTime);
+    particle_update_k k;
+    k.PosX        = PosX;
+    k.PosY        = PosY;
+    k.VelX        = VelX;
+    k.VelY        = VelY;
+    k.Life        = Life;
+    k.Alpha       = Alpha;
+    k.InvDuration = InvDuration;
+    k.Drag        = powf(PARTICLE_DRAG, step * 60.0f);
+    k.Step        = step;
+    task_pool_parallel_for(TaskPool, Count, PARTICLE_MIN_CHUNK, particle_update_range, &k);
+
+    // remove expired particles by moving the last live particle into the
+    // vacated slot. this keeps the live range contiguous for the next pass.
+    size_t i = 0;
+    size_t n = Count;
+    while (i < n)
+    {
+        if (Life[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+        --n;
+        PosX[i]        = PosX[n];
+        PosY[i]        = PosY[n];
+        VelX[i]        = VelX[n];
+        VelY[i]        = VelY[n];
+        Life[i]        = Life[n];
+        InvDuration[i] = InvDuration[n];
+        Alpha[i]       = Alpha[n];
+        Scale[i]       = Scale[n];
+        Color[i]       = Color[n];
+    }
+    Count = n;
+    if (NextReplace >= Count) NextReplace = 0;
+}
+
+bool ParticleManager::Save(snapshot_buffer_t *buffer) const
+{
+    // the fade factor is a function of the lifetime and is recomputed on
+    // restore, which keeps each particle to 32 bytes.
+    uint32_t header[2] = { uint32_t(Count), uint32_t(NextReplace) };
+    size_t   n  = Count * sizeof(float);
+    bool     ok = snapshot_write_value(buffer, header);
+    ok = ok && snapshot_write_value(buffer, Random);
+    ok = ok && snapshot_write(buffer, PosX, n);
+    ok = ok && snapshot_write(buffer, PosY, n);
+    ok = ok && snapshot_write(buffer, VelX, n);
+    ok = ok && snapshot_write(buffer, VelY, n);
+    ok = ok && snapshot_write(buffer, Life, n);
+    ok = ok && snapshot_write(buffer, InvDuration, n);
+    ok = ok && snapshot_write(buffer, Scale, n);
+    ok = ok && snapshot_write(buffer, Color, n);
+    return ok;
+}
+
+bool ParticleManager::Restore(snapshot_buffer_t *buffer)
+{
+    uint32_t header[2];
+    if (!snapshot_read_value(buffer, header) || header[0] > Capacity)
+        return false;
+
+    Count       = header[0];
+    NextReplace = header[1];
+    size_t   n  = Count * sizeof(float);
+    bool     ok = snapshot_read_value(buffer, Random);
+    ok = ok && snapshot_read(buffer, PosX, n);
+    ok = ok && snapshot_read(buffer, PosY, n);
+    ok = ok && snapshot_read(buffer, VelX, n);
+    ok = ok && snapshot_read(buffer, VelY, n);
+    ok = ok && snapshot_read(buffer, Life, n);
+    ok = ok && snapshot_read(buffer, InvDuration, n);
+    ok = ok && snapshot_read(buffer, Scale, n);
+    ok = ok && snapshot_read(buffer, Color, n);
+    if (!ok)
+    {
+        Clear();
+        return false;
+    }
+    particle_fade_k k;
+    k.Life        = Life;
+    k.InvDuration = InvDuration;
+    k.Alpha       = Alpha;
+    soa_for_range(k, Alpha, 0, Count);
+    return true;
+}
+
+void ParticleManager::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
+{
+    UNUSED_ARG(currentTime);
+    UNUSED_ARG(elapsedTime);
+    if (Count == 0 || Image == NULL) return;
+
+    float  width  = float(Image->GetWidth());
+    float  height = float(Image->GetHeight());
+    rect_t src    = { 0, 0, width, height };
+
+    // line particles are drawn aligned with their direction of travel.
+    vec2_soa_direction(FacingCos, FacingSin, VelX, VelY, Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        Tint[i] = fade_color(Color[i], Alpha[i]);
+    }
+
+    SpriteBatch *batch = dm->GetBatch();
+    batch->SetBlendModeAdditive();
+    batch->AddArrayRotated(2, Image, src, Count, PosX, PosY, FacingCos, FacingSin, Scale, NULL, Tint, width * 0.5f, height * 0.5f);
+}
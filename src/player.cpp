@@ -7,8 +7,10 @@
 //   Includes   //
 ////////////////*/
 #include <math.h>
-#include "bullet.hpp"
 #include "player.hpp"
+#include "enemy.hpp"
+#include "events.hpp"
+#include "raycast.hpp"
 #include "math.hpp"
 
 /*/////////////////
@@ -17,6 +19,14 @@
 static const float RESPAWN_TIME  = 300.0f / 60.0f;
 static const float COOLDOWN_TIME = 6.0f   / 60.0f;
 static const float SHIP_SPEED    = 550.0f;
+static const float BEAM_RANGE    = 1000.0f;
+static const float BEAM_WIDTH    = 0.5f;
+
+/// @summary The number of enemies the beam passes through before it is stopped.
+#define BEAM_PIERCE                  4U
+
+/// @summary The RGBA color of the beam and the sparks where it hits.
+static const float BEAM_COLOR[4] = { 1.0f, 0.5f, 0.3f, 1.0f };
 
 /*///////////////////////
 //   Local Functions   //
@@ -26,14 +36,14 @@ static const float SHIP_SPEED    = 550.0f;
 //  Public Functions   //
 ///////////////////////*/
 Player::Player(int index) :
-    CooldownRemaining(0.0f),
-    TimeUntilRespawn(0.0f),
-    ViewportWidth(0.0f),
-    ViewportHeight(0.0f),
+    WorldWidth(0.0f),
+    WorldHeight(0.0f),
     ShipSpeed(SHIP_SPEED),
-    PlayerIndex(index)
+    PlayerIndex(index),
+    BeamImage(NULL)
 {
-    Kind = ENTITY_PLAYER;
+    State->Kind  = ENTITY_PLAYER;
+    State->Index = index;
 }
 
 Player::~Player(void)
@@ -43,50 +53,80 @@ Player::~Player(void)
 
 bool Player::IsDead(void) const
 {
-    return (TimeUntilRespawn > 0.0f);
+    return State->Extra.Player.Dead != 0;
 }
 
 void Player::Kill(void)
 {
-    TimeUntilRespawn = RESPAWN_TIME;
+    if (State->Extra.Player.Dead == 0)
+    {
+        State->Extra.Player.Dead = 1;
+        EntityManager::GetInstance()->Schedule(TIMER_PLAYER_RESPAWN, uint32_t(PlayerIndex), RESPAWN_TIME);
+    }
+}
+
+void Player::Reload(void)
+{
+    State->Extra.Player.WeaponReady = 1;
+}
+
+void Player::Respawn(void)
+{
+    player_state_t &ship = State->Extra.Player;
+    State->Velocity[0]   = 0.0f;
+    State->Velocity[1]   = 0.0f;
+    State->Position[0]   = WorldWidth  * 0.5f;
+    State->Position[1]   = WorldHeight * 0.5f;
+    ship.TargetPoint[0]  = WorldWidth  * 0.5f;
+    ship.TargetPoint[1]  = WorldHeight * 0.5f;
+    ship.TargetVector[0] = 0.0f;
+    ship.TargetVector[1] = 0.0f;
+    ship.Dead            = 0;
 }
 
 void Player::Init(DisplayManager *dm)
 {
-    Image             = dm->GetPlayerTexture();
-    Radius            = max2(float(Image->GetWidth()), float(Image->GetHeight()));
-    ShipSpeed         = SHIP_SPEED;
-    CooldownRemaining = COOLDOWN_TIME;
-    ViewportWidth     = dm->GetViewportWidth();
-    ViewportHeight    = dm->GetViewportHeight();
-    TargetPoint[0]    = ViewportWidth  * 0.5f;
-    TargetPoint[1]    = ViewportHeight * 0.5f;
-    TargetVector[0]   = 0.0f;
-    TargetVector[1]   = 0.0f;
-    Position[0]       = ViewportWidth  * 0.5f;
-    Position[1]       = ViewportHeight * 0.5f;
-    Velocity[0]       = 0.0f;
-    Velocity[1]       = 0.0f;
+    player_state_t &ship = State->Extra.Player;
+    Image                = dm->GetPlayerTexture();
+    BeamImage            = dm->GetLaserTexture();
+    State->Radius        = max2(float(Image->GetWidth()), float(Image->GetHeight()));
+    ShipSpeed            = SHIP_SPEED;
+    ship.WeaponReady     = 0;
+    ship.Dead            = 0;
+    WorldWidth        = dm->GetWorldWidth();
+    WorldHeight       = dm->GetWorldHeight();
+    ship.TargetPoint[0]  = WorldWidth  * 0.5f;
+    ship.TargetPoint[1]  = WorldHeight * 0.5f;
+    ship.TargetVector[0] = 0.0f;
+    ship.TargetVector[1] = 0.0f;
+    State->Position[0]   = WorldWidth  * 0.5f;
+    State->Position[1]   = WorldHeight * 0.5f;
+    State->Velocity[0]   = 0.0f;
+    State->Velocity[1]   = 0.0f;
+    EntityManager::GetInstance()->Schedule(TIMER_PLAYER_RELOAD, uint32_t(PlayerIndex), COOLDOWN_TIME);
 }
 
 void Player::Input(double currentTime, double elapsedTime, InputManager *im)
 {
     float current = float(currentTime);
     float elapsed = float(elapsedTime);
-    float mouse_x = im->GetCurrentSnapshot()->MouseX;
-    float mouse_y = im->GetCurrentSnapshot()->MouseY;
-    float dist_x  = mouse_x - Position[0];
-    float dist_y  = mouse_y - Position[1];
+    player_state_t         &ship  = State->Extra.Player;
+    input_snapshot_t const *state = im->GetPlayerSnapshot(PlayerIndex);
+    float mouse_x = state->MouseX;
+    float mouse_y = state->MouseY;
+    float dist_x  = mouse_x - State->Position[0];
+    float dist_y  = mouse_y - State->Position[1];
     if (dist_x != 0 && dist_y != 0)
     {
-        Orientation     = atan2f(dist_y, dist_x);
-        Velocity[0]     = dist_x / (ShipSpeed * elapsed);
-        Velocity[1]     = dist_y / (ShipSpeed * elapsed);
-        TargetPoint[0]  = mouse_x;
-        TargetPoint[1]  = mouse_y;
-        TargetVector[0] = dist_x;
-        TargetVector[1] = dist_y;
+        SetDirection(dist_x, dist_y);
+        State->Velocity[0]   = dist_x / (ShipSpeed * elapsed);
+        State->Velocity[1]   = dist_y / (ShipSpeed * elapsed);
+        ship.TargetPoint[0]  = mouse_x;
+        ship.TargetPoint[1]  = mouse_y;
+        ship.TargetVector[0] = dist_x;
+        ship.TargetVector[1] = dist_y;
     }
+    ship.FiringBeam = (state->MouseState & (1U << GLFW_MOUSE_BUTTON_RIGHT)) != 0 ? 1 : 0;
     UNUSED_LOCAL(current);
 }
 
@@ -95,56 +135,68 @@ void Player::Update(double currentTime, double elapsedTime)
     float current = float(currentTime);
     float elapsed = float(elapsedTime);
 
-    if (IsDead())
-    {
-        TimeUntilRespawn     -= elapsed;
-        if (TimeUntilRespawn <= 0.0f)
-        {
-            // respawn the player.
-            Velocity[0]       = 0.0f;
-            Velocity[1]       = 0.0f;
-            Position[0]       = ViewportWidth  * 0.5f;
-            Position[1]       = ViewportHeight * 0.5f;
-            TargetPoint[0]    = ViewportWidth  * 0.5f;
-            TargetPoint[1]    = ViewportHeight * 0.5f;
-            TargetVector[0]   = 0.0f;
-            TargetVector[1]   = 0.0f;
-            TimeUntilRespawn  = 0.0f;
-        }
-    }
-    else
+    // the weapon cooldown and respawn delay are timers owned by the
+    // EntityManager, which calls Reload and Respawn when they expire.
+    if (IsDead() == false)
     {
-        Position[0] += Velocity[0];
-        Position[1] += Velocity[1];
-        Position[0]  = clamp(Position[0], 0, ViewportWidth);
-        Position[1]  = clamp(Position[1], 0, ViewportHeight);
+        player_state_t &ship = State->Extra.Player;
+        float          *pos  = State->Position;
+        float          *rot  = State->Rotation;
+        pos[0] += State->Velocity[0];
+        pos[1] += State->Velocity[1];
+        pos[0]  = clamp(pos[0], 0, WorldWidth);
+        pos[1]  = clamp(pos[1], 0, WorldHeight);
 
-        if (CooldownRemaining > 0.0f)
+        if (ship.WeaponReady)
         {
-            CooldownRemaining -= elapsed;
+            float vel_x = 11.0f * rot[0];
+            float vel_y = 11.0f * rot[1];
+            EventBus::GetInstance()->SpawnBullet(pos[0], pos[1], vel_x, vel_y);
+            EntityManager::GetInstance()->Schedule(TIMER_PLAYER_RELOAD, uint32_t(PlayerIndex), COOLDOWN_TIME);
+            ship.WeaponReady = 0;
         }
-        else
+
+        // the beam destroys the first few enemies in its path and is
+        // stopped by the last one it can pierce.
+        ship.BeamLength = 0.0f;
+        EnemyManager *enemies = EnemyManager::GetInstance();
+        if (ship.FiringBeam && enemies != NULL)
         {
-            float cos_a = cosf(Orientation);
-            float sin_a = sinf(Orientation);
-            float vel_x = 11.0f * cos_a;
-            float vel_y = 11.0f * sin_a;
-            float pos_x = Position[0];
-            float pos_y = Position[1];
-            Bullet *ent = new Bullet(pos_x, pos_y, vel_x, vel_y);
-            EntityManager::GetInstance()->Add(ent);
-            CooldownRemaining  = COOLDOWN_TIME;
+            ray_t     ray;
+            ray_hit_t hits[BEAM_PIERCE];
+            size_t    count = 0;
+            ray.DirX    = rot[0];
+            ray.DirY    = rot[1];
+            ray.OriginX = pos[0];
+            ray.OriginY = pos[1];
+            ray.Length  = BEAM_RANGE;
+            enemies->CastRays(&ray, 1, BEAM_PIERCE, hits, &count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                float hit_x = ray.OriginX + ray.DirX * hits[i].Distance;
+                float hit_y = ray.OriginY + ray.DirY * hits[i].Distance;
+                enemies->Kill(enemies->GetHandle(hits[i].Item));
+                EventBus::GetInstance()->EmitBurst(hit_x, hit_y, 30, 60.0f, 600.0f, BEAM_COLOR, 0.75f, 1.0f);
+            }
+            ship.BeamLength = count == BEAM_PIERCE ? hits[count - 1].Distance : BEAM_RANGE;
         }
     }
     UNUSED_LOCAL(current);
+    UNUSED_LOCAL(elapsed);
 }
 
 void Player::Draw(double currentTime, double elapsedTime, DisplayManager *dm)
 {
     if (IsDead() == false)
     {
+        float beam = State->Extra.Player.BeamLength;
+        if (beam > 0.0f)
+        {
+            float  width  = (float) BeamImage->GetWidth();
+            float  height = (float) BeamImage->GetHeight();
+            rect_t src    = { 0, 0, width, height };
+            dm->GetBatch()->AddRotated(1, BeamImage, State->Position[0], State->Position[1], src, BEAM_COLOR, State->Rotation[0], State->Rotation[1], 0.0f, height * 0.5f, beam / width, BEAM_WIDTH);
+        }
         Entity::Draw(currentTime, elapsedTime, dm);
     }
-    ViewportWidth  = dm->GetViewportWidth();
-    ViewportHeight = dm->GetViewportHeight();
 }
@@ -0,0 +1,274 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements ray casts against the circles stored in a spatial grid.
+/// The ray is clipped to the grid and walked cell by cell (Amanatides & Woo).
+/// Circles may extend beyond the cell holding their center, so each visited
+/// cell also searches its neighbors out to the largest radius; neighbors that
+/// were already searched for a recent cell are skipped, so each circle is
+/// tested once.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <float.h>
+#include <math.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "ll_task.hpp"
+#include "raycast.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of circles tested by a single kernel invocation.
+#define RAYCAST_BLOCK_SIZE           64U
+
+/// @summary The number of recently visited cells remembered during traversal.
+/// Must be at least 4 * RAYCAST_MAX_REACH.
+#define RAYCAST_HISTORY              16U
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Kernel computing, for each circle, the distance along the ray to
+/// the point closest to its center, and the squared half-length of the chord
+/// (negative if the ray misses the circle).
+struct ray_circle_k
+{
+    float const *X, *Y, *R;
+    float       *Closest, *ChordSq;
+    size_t       Base;
+    float        OX, OY, DX, DY;
+
+    template <typename L>
+    BACKEND_FORCE_INLINE void run(size_t i) const
+    {
+        typename L::value_t rx = L::sub(L::load(X + i), L::splat(OX));
+        typename L::value_t ry = L::sub(L::load(Y + i), L::splat(OY));
+        typename L::value_t r  = L::load(R + i);
+        typename L::value_t tc = L::add(L::mul(rx, L::splat(DX)), L::mul(ry, L::splat(DY)));
+        typename L::value_t ds = L::add(L::mul(rx, rx), L::mul(ry, ry));
+        L::store(Closest + (i - Base), tc);
+        L::store(ChordSq + (i - Base), L::sub(L::add(L::mul(r, r), L::mul(tc, tc)), ds));
+    }
+};
+
+/// @summary The arguments to raycast_batch(), passed to each task.
+struct raycast_args_t
+{
+    spatial_grid_t const *Grid;
+    ray_t          const *Rays;
+    size_t                MaxHits;
+    ray_hit_t            *Hits;
+    size_t               *HitCounts;
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Inserts an intersection into a list sorted by distance, dropping
+/// the farthest entry if the list is full.
+/// @param hits The sorted list of intersections.
+/// @param n The number of entries in the list.
+/// @param max_hits The capacity of the list.
+/// @param item The index of the circle.
+/// @param t The distance along the ray to the intersection.
+/// @return The new number of entries in the list.
+static inline size_t insert_hit(ray_hit_t *hits, size_t n, size_t max_hits, uint32_t item, float t)
+{
+    if (n == max_hits)
+    {
+        if (t >= hits[n - 1].Distance)
+            return n;
+        --n;
+    }
+    size_t j = n;
+    while (j > 0 && hits[j - 1].Distance > t)
+    {
+        hits[j] = hits[j - 1];
+        --j;
+    }
+    hits[j].Item     = item;
+    hits[j].Distance = t;
+    return n + 1;
+}
+
+/// @summary Tests every circle in a single cell against a ray.
+/// @param grid The spatial grid.
+/// @param ray The ray being cast.
+/// @param cell The index of the cell to test.
+/// @param max_hits The capacity of the hit list.
+/// @param hits The sorted list of intersections.
+/// @param n The number of entries in the list.
+/// @return The new number of entries in the list.
+static size_t test_cell(spatial_grid_t const *grid, ray_t const &ray, size_t cell, size_t max_hits, ray_hit_t *hits, size_t n)
+{
+    float        closest[RAYCAST_BLOCK_SIZE];
+    float        chord_sq[RAYCAST_BLOCK_SIZE];
+    size_t const begin = grid->CellStart[cell];
+    size_t const end   = grid->CellStart[cell + 1];
+    ray_circle_k k;
+
+    k.X       = grid->SortedX;
+    k.Y       = grid->SortedY;
+    k.R       = grid->SortedR;
+    k.Closest = closest;
+    k.ChordSq = chord_sq;
+    k.OX      = ray.OriginX;
+    k.OY      = ray.OriginY;
+    k.DX      = ray.DirX;
+    k.DY      = ray.DirY;
+    for (size_t b = begin; b < end; b += RAYCAST_BLOCK_SIZE)
+    {
+        size_t e = b + RAYCAST_BLOCK_SIZE;
+        if (e > end) e = end;
+        k.Base = b;
+        soa_for_range(k, k.X, b, e);
+
+        // most circles miss; only the hits need the square root.
+        for (size_t j = 0; j < e - b; ++j)
+        {
+            if (chord_sq[j] < 0.0f)
+                continue;
+
+            float h  = sqrtf(chord_sq[j]);
+            float tn = closest[j] - h;
+            float tf = closest[j] + h;
+            if (tf >= 0.0f && tn <= ray.Length)
+            {
+                n = insert_hit(hits, n, max_hits, grid->Items[b + j], tn > 0.0f ? tn : 0.0f);
+            }
+        }
+    }
+    return n;
+}
+
+/// @summary Casts a range of rays from a batch.
+/// @param begin The index of the first ray to cast.
+/// @param end The index one past the last ray to cast.
+/// @param context The raycast_args_t describing the batch.
+static void raycast_range(size_t begin, size_t end, void *context)
+{
+    raycast_args_t const *args = (raycast_args_t const*) context;
+    for (size_t i = begin; i < end; ++i)
+    {
+        args->HitCounts[i] = raycast(args->Grid, args->Rays[i], args->MaxHits, args->Hits + i * args->MaxHits);
+    }
+}
+
+/*///////////////////////
+//  Public Functions   //
+///////////////////////*/
+size_t raycast(spatial_grid_t const *grid, ray_t const &ray, size_t max_hits, ray_hit_t *hits)
+{
+    if (max_hits == 0 || grid->Count == 0)
+        return 0;
+
+    // clip the ray segment against the bounds of the grid.
+    float const cell   = grid->CellSize;
+    float const lo[2]  = { grid->OriginX, grid->OriginY };
+    float const hi[2]  = { grid->OriginX + grid->CellsX * cell, grid->OriginY + grid->CellsY * cell };
+    float const o[2]   = { ray.OriginX, ray.OriginY };
+    float const d[2]   = { ray.DirX, ray.DirY };
+    float       t0     = 0.0f;
+    float       t1     = ray.Length;
+    for (size_t a = 0; a < 2; ++a)
+    {
+        if (d[a] == 0.0f)
+        {
+            if (o[a] < lo[a] || o[a] > hi[a]) return 0;
+            continue;
+        }
+        float inv = 1.0f / d[a];
+        float ta  = (lo[a] - o[a]) * inv;
+        float tb  = (hi[a] - o[a]) * inv;
+        t0 = max2(t0, min2(ta, tb));
+        t1 = min2(t1, max2(ta, tb));
+    }
+    if (t0 > t1)
+        return 0;
+
+    // set up the DDA from the point where the ray enters the grid.
+    long   const cols   = long(grid->CellsX);
+    long   const rows   = long(grid->CellsY);
+    long         cx     = long(spatial_grid_column(grid, o[0] + d[0] * t0));
+    long         cy     = long(spatial_grid_row   (grid, o[1] + d[1] * t0));
+    long   const step_x = d[0] > 0.0f ? 1 : (d[0] < 0.0f ? -1 : 0);
+    long   const step_y = d[1] > 0.0f ? 1 : (d[1] < 0.0f ? -1 : 0);
+    float  const dt_x   = step_x != 0 ? cell / fabsf(d[0]) : FLT_MAX;
+    float  const dt_y   = step_y != 0 ? cell / fabsf(d[1]) : FLT_MAX;
+    float        tmax_x = step_x != 0 ? (lo[0] + (cx + (step_x > 0)) * cell - o[0]) / d[0] : FLT_MAX;
+    float        tmax_y = step_y != 0 ? (lo[1] + (cy + (step_y > 0)) * cell - o[1]) / d[1] : FLT_MAX;
+
+    // a circle whose intersection lies in visited cell m has its center at
+    // most reach cells away, so it has been tested once cell m is done. a
+    // neighbor of the current cell can only have been searched already for
+    // one of the previous 4 * reach cells along the ray.
+    long   reach  = grid->MaxRadius > 0.0f ? long(ceilf(grid->MaxRadius * grid->InvCellSize)) : 0;
+    if (reach > long(RAYCAST_MAX_REACH)) reach = long(RAYCAST_MAX_REACH);
+    long   hist_x[RAYCAST_HISTORY];
+    long   hist_y[RAYCAST_HISTORY];
+    size_t window = size_t(reach) * 4;
+    size_t visits = 0;
+    size_t n      = 0;
+    for ( ; ; )
+    {
+        float  t_exit = min2(min2(tmax_x, tmax_y), t1);
+        size_t recent = visits < window ? visits : window;
+        long   x0 = cx - reach > 0 ? cx - reach : 0;
+        long   x1 = cx + reach < cols - 1 ? cx + reach : cols - 1;
+        long   y0 = cy - reach > 0 ? cy - reach : 0;
+        long   y1 = cy + reach < rows - 1 ? cy + reach : rows - 1;
+        for (long y = y0; y <= y1; ++y)
+        {
+            for (long x = x0; x <= x1; ++x)
+            {
+                bool seen = false;
+                for (size_t h = 1; h <= recent && !seen; ++h)
+                {
+                    size_t s = (visits - h) % RAYCAST_HISTORY;
+                    seen = labs(x - hist_x[s]) <= reach && labs(y - hist_y[s]) <= reach;
+                }
+                if (!seen)
+                {
+                    n = test_cell(grid, ray, size_t(y * cols + x), max_hits, hits, n);
+                }
+            }
+        }
+        hist_x[visits % RAYCAST_HISTORY] = cx;
+        hist_y[visits % RAYCAST_HISTORY] = cy;
+        visits++;
+
+        // stop once the nearest max_hits intersections are final.
+        if (n == max_hits && hits[n - 1].Distance <= t_exit)
+            break;
+        if (t_exit >= t1)
+            break;
+
+        if (tmax_x < tmax_y)
+        {
+            cx     += step_x;
+            tmax_x += dt_x;
+        }
+        else
+        {
+            cy     += step_y;
+            tmax_y += dt_y;
+        }
+        if (cx < 0 || cx >= cols || cy < 0 || cy >= rows)
+            break;
+    }
+    return n;
+}
+
+void raycast_batch(spatial_grid_t const *grid, ray_t const *rays, size_t count, size_t max_hits, ray_hit_t *hits, size_t *hit_counts, task_pool_t *pool)
+{
+    raycast_args_t args;
+    args.Grid      = grid;
+    args.Rays      = rays;
+    args.MaxHits   = max_hits;
+    args.Hits      = hits;
+    args.HitCounts = hit_counts;
+    task_pool_parallel_for(pool, count, RAYCAST_MIN_CHUNK, raycast_range, &args);
+}
@@ -0,0 +1,120 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements headless stand-ins for the display, entity and player
+/// symbols referenced by the game modules, so that the benchmarks can run the
+/// grid, enemy and particle updates without a window or an OpenGL context.
+/// Textures report a fixed size, the play area is set through SetWorldSize(),
+/// and there is no player, so nothing spawns or seeks.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stddef.h>
+#include "display.hpp"
+#include "entity.hpp"
+#include "player.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The width and height reported by every texture, in pixels. This
+/// matches the enemy sprites, whose half-size is the enemy collision radius.
+#define BENCH_TEXTURE_SIZE           (40U)
+
+/*///////////////
+//  Functions  //
+///////////////*/
+uint32_t color32(float const *rgba)
+{
+    UNUSED_ARG(rgba);
+    return 0xFFFFFFFFU;
+}
+
+Texture::Texture(void)
+    :
+    Id(0),
+    Wrap(GL_CLAMP_TO_EDGE),
+    Filter(GL_NEAREST),
+    Width(BENCH_TEXTURE_SIZE),
+    Height(BENCH_TEXTURE_SIZE),
+    InvWidth(1.0f / BENCH_TEXTURE_SIZE),
+    InvHeight(1.0f / BENCH_TEXTURE_SIZE)
+{
+    /* empty */
+}
+
+Texture::~Texture(void)
+{
+    /* empty */
+}
+
+void Texture::Dispose(void)
+{
+    /* empty */
+}
+
+DisplayManager::DisplayManager(void)
+    :
+    MainWindow(NULL),
+    ViewportWidth(0.0f),
+    ViewportHeight(0.0f),
+    WorldWidth(DISPLAY_WORLD_WIDTH),
+    WorldHeight(DISPLAY_WORLD_HEIGHT),
+    DefaultBatch(NULL),
+    DefaultFont(NULL),
+    FontTexture(new Texture()),
+    PlayerTexture(new Texture()),
+    BlackHoleTexture(new Texture()),
+    BulletTexture(new Texture()),
+    GlowTexture(new Texture()),
+    LaserTexture(new Texture()),
+    PixelTexture(new Texture()),
+    PointerTexture(new Texture()),
+    SeekerTexture(new Texture()),
+    WandererTexture(new Texture())
+{
+    /* empty */
+}
+
+DisplayManager::~DisplayManager(void)
+{
+    delete WandererTexture;
+    delete SeekerTexture;
+    delete PointerTexture;
+    delete PixelTexture;
+    delete LaserTexture;
+    delete GlowTexture;
+    delete BulletTexture;
+    delete BlackHoleTexture;
+    delete PlayerTexture;
+    delete FontTexture;
+}
+
+void SpriteBatch::AddArrayRotated(uint32_t z, Texture *t, rect_t const &src, size_t count, float const *x, float const *y, float const *rot_cos, float const *rot_sin, float const *sx, float const *sy, uint32_t const *abgr, float ox, float oy)
+{
+    UNUSED_ARG(z); UNUSED_ARG(t); UNUSED_ARG(src); UNUSED_ARG(count);
+    UNUSED_ARG(x); UNUSED_ARG(y); UNUSED_ARG(rot_cos); UNUSED_ARG(rot_sin);
+    UNUSED_ARG(sx); UNUSED_ARG(sy); UNUSED_ARG(abgr); UNUSED_ARG(ox); UNUSED_ARG(oy);
+}
+
+void SpriteBatch::SetBlendModeAdditive(void)
+{
+    /* empty */
+}
+
+EntityManager* EntityManager::GetInstance(void)
+{
+    return NULL;
+}
+
+Player* EntityManager::GetPlayer(int index)
+{
+    UNUSED_ARG(index);
+    return NULL;
+}
+
+bool Player::IsDead(void) const
+{
+    return true;
+}
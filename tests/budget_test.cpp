@@ -0,0 +1,180 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the frame budget scheduler. Frames of a
+/// simulated game loop owe the scheduler a varying number of steps whose cost
+/// is chosen by the test. Below the highest degradation level no owed time
+/// may be dropped; steps beyond the per-frame limit are carried into later
+/// frames and raise the level. At the highest level, the steps run are limited
+/// to those that fit in the budget and the rest are dropped. Every tick of
+/// elapsed time must be simulated, dropped or still owed, and the level must
+/// recover once frames are cheap again. Build and run with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ll_budget.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The length of a simulation tick, in seconds.
+#define TEST_STEP                  (1.0 / 120.0)
+
+/// @summary The wall-clock time per frame allowed for simulation, in seconds.
+#define TEST_BUDGET                (0.008)
+
+/// @summary The most steps a frame may run.
+#define TEST_MAX_STEPS             (8U)
+
+/// @summary The number of degradation levels.
+#define TEST_MAX_LEVEL             (3U)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary The state of a simulated game loop.
+struct test_loop_t
+{
+    frame_budget_t Budget;      /// The scheduler under test.
+    double         Accumulator; /// The simulation time owed, in seconds.
+    double         Elapsed;     /// The total elapsed time, in seconds.
+    uint64_t       Simulated;   /// The number of steps run.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param frame The frame being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, uint64_t frame)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (frame %llu)\n", name, (unsigned long long) frame);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Initializes a simulated game loop.
+/// @param loop The loop to initialize.
+/// @param max_level The number of degradation levels.
+static void loop_init(test_loop_t *loop, uint32_t max_level)
+{
+    frame_budget_init(&loop->Budget, TEST_STEP, TEST_BUDGET, TEST_MAX_STEPS, max_level);
+    loop->Accumulator = 0.0;
+    loop->Elapsed     = 0.0;
+    loop->Simulated   = 0;
+}
+
+/// @summary Runs one frame of a simulated game loop and checks that owed time
+/// is only dropped at the highest degradation level.
+/// @param loop The loop.
+/// @param elapsed The time elapsed since the previous frame, in seconds.
+/// @param cost The wall-clock cost of each step, in seconds.
+/// @return The number of steps run.
+static uint32_t loop_frame(test_loop_t *loop, double elapsed, double cost)
+{
+    frame_budget_t *b       = &loop->Budget;
+    uint64_t        frame   = b->Frames;
+    uint32_t        level   = b->Level;
+    uint64_t        dropped = b->Dropped;
+    uint32_t        owed    = uint32_t((loop->Accumulator + elapsed) / TEST_STEP);
+
+    loop->Accumulator += elapsed;
+    loop->Elapsed     += elapsed;
+    uint32_t steps = frame_budget_begin(b, loop->Accumulator);
+    for (uint32_t i = 0; i < steps; ++i)
+    {
+        loop->Accumulator -= TEST_STEP;
+        frame_budget_step(b, cost);
+    }
+    loop->Simulated += steps;
+    frame_budget_end(b, steps * cost);
+
+    check(steps <= TEST_MAX_STEPS, "a frame runs at most MaxSteps steps", frame);
+    check(steps <= owed, "a frame runs no more steps than are owed", frame);
+    check(steps > 0 || owed == 0, "a frame that owes steps makes progress", frame);
+    if (level < b->MaxLevel)
+    {
+        check(b->Dropped == dropped, "time is only dropped at the highest level", frame);
+        check(steps == (owed < TEST_MAX_STEPS ? owed : TEST_MAX_STEPS), "below the highest level every owed step up to the limit runs", frame);
+    }
+    // every tick of elapsed time is simulated, dropped or still owed.
+    double ticks = double(loop->Simulated + b->Dropped) + loop->Accumulator / TEST_STEP;
+    check(fabs(ticks - loop->Elapsed / TEST_STEP) < 1.0e-6, "elapsed time is simulated, dropped or owed", frame);
+    return steps;
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    test_loop_t loop;
+    printf("budget_test, %u steps per frame at most, %.0f ms budget, %u levels:\n", TEST_MAX_STEPS, TEST_BUDGET * 1000.0, TEST_MAX_LEVEL);
+
+    // cheap steps that fit the budget: a long frame owes more steps than the
+    // limit. the rest is carried, not dropped, and the level rises.
+    loop_init(&loop, TEST_MAX_LEVEL);
+    loop_frame(&loop, 20 * TEST_STEP, 0.0001);
+    check(loop.Budget.Dropped == 0, "steps over the limit are carried below the highest level", 0);
+    check(loop.Budget.Level == 1, "carrying steps raises the level", 0);
+    check(loop.Accumulator >= 12 * TEST_STEP, "carried steps remain owed", 0);
+    uint32_t steps = loop_frame(&loop, TEST_STEP, 0.0001);
+    check(steps == TEST_MAX_STEPS, "the next frame runs carried steps", 1);
+    printf("  cheap steps:     %llu simulated, %llu dropped, level %u\n", (unsigned long long) loop.Simulated, (unsigned long long) loop.Budget.Dropped, loop.Budget.Level);
+
+    // a run of long frames with expensive steps reaches the highest level,
+    // which then runs only what fits in the budget and drops the rest.
+    loop_init(&loop, TEST_MAX_LEVEL);
+    for (uint32_t i = 0; i < 2 * TEST_MAX_LEVEL; ++i)
+    {
+        loop_frame(&loop, 0.1, 0.004);
+    }
+    check(loop.Budget.Level == TEST_MAX_LEVEL, "frames over budget reach the highest level", loop.Budget.Frames);
+    check(loop.Budget.Dropped > 0, "the highest level drops time", loop.Budget.Frames);
+    steps = loop_frame(&loop, 0.1, 0.004);
+    check(steps == 2, "the highest level runs as many steps as fit", loop.Budget.Frames);
+    check(loop.Accumulator < TEST_STEP, "the highest level leaves less than a step owed", loop.Budget.Frames);
+    printf("  expensive steps: %llu simulated, %llu dropped, level %u\n", (unsigned long long) loop.Simulated, (unsigned long long) loop.Budget.Dropped, loop.Budget.Level);
+
+    // cheap frames that fit comfortably lower the level again, one at a time.
+    for (uint32_t i = 0; i < TEST_MAX_LEVEL * BUDGET_RECOVER_FRAMES; ++i)
+    {
+        loop_frame(&loop, TEST_STEP, 0.0001);
+    }
+    check(loop.Budget.Level == 0, "the level recovers once frames are cheap", loop.Budget.Frames);
+    printf("  recovered:       level %u after %llu frames\n", loop.Budget.Level, (unsigned long long) loop.Budget.Frames);
+
+    // with no levels to shed, as in a lockstep session, the first frame that
+    // cannot run every owed step drops the rest.
+    loop_init(&loop, 0);
+    steps = loop_frame(&loop, 20 * TEST_STEP, 0.0001);
+    check(steps == TEST_MAX_STEPS, "without levels the limit still applies", 0);
+    check(loop.Budget.Dropped == 20 - TEST_MAX_STEPS, "without levels the rest is dropped at once", 0);
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "budget_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("budget_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
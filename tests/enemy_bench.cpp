@@ -0,0 +1,183 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a benchmark for the Morton-order re-sort of the enemy
+/// arrays. Enemies are spawned in random order, and the enemy update is timed
+/// before the sort, after it, and after a period of drift without a re-sort.
+/// Each phase also replays the grid-order gather of the enemy positions, the
+/// access pattern of the separation pass and of ray and sweep hits, through a
+/// simulated cache, since hardware counters may not be available. Build and
+/// run with `make bench`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "display.hpp"
+#include "enemy.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of enemies spawned.
+#define BENCH_ENEMIES                (256U * 1024U)
+
+/// @summary The width and height of the play area, in pixels.
+#define BENCH_FIELD_SIZE             (4096)
+
+/// @summary The number of updates timed in each phase.
+#define BENCH_TICKS                  (20U)
+
+/// @summary The number of updates run without a re-sort before the last phase.
+#define BENCH_DRIFT_TICKS            (600U)
+
+/// @summary The fixed timestep, in seconds.
+#define BENCH_TIMESTEP               (1.0 / 120.0)
+
+/// @summary The geometry of the simulated cache: 256 KB, 8-way set
+/// associative with LRU replacement and 64-byte lines.
+#define CACHE_SIZE                   (256U * 1024U)
+#define CACHE_WAYS                   (8U)
+#define CACHE_LINE_BITS              (6U)
+#define CACHE_SETS                   (CACHE_SIZE / CACHE_WAYS / (1U << CACHE_LINE_BITS))
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary The state of a simulated set-associative cache.
+struct cache_sim_t
+{
+    uintptr_t Tag[CACHE_SETS][CACHE_WAYS]; /// The line held by each way.
+    uint32_t  Age[CACHE_SETS][CACHE_WAYS]; /// The access clock of each way's last use.
+    uint32_t  Clock;                       /// The number of accesses so far.
+    size_t    Misses;                      /// The number of accesses that missed.
+};
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Empties a simulated cache.
+/// @param c The cache to reset.
+static void cache_reset(cache_sim_t *c)
+{
+    memset(c->Tag, 0xFF, sizeof(c->Tag));
+    memset(c->Age, 0x00, sizeof(c->Age));
+    c->Clock  = 0;
+    c->Misses = 0;
+}
+
+/// @summary Simulates an access to an address, evicting the least recently
+/// used way of its set on a miss.
+/// @param c The cache to update.
+/// @param p The address being accessed.
+static void cache_touch(cache_sim_t *c, void const *p)
+{
+    uintptr_t line = uintptr_t(p) >> CACHE_LINE_BITS;
+    size_t    set  = line % CACHE_SETS;
+    size_t    lru  = 0;
+    c->Clock++;
+    for (size_t w = 0; w < CACHE_WAYS; ++w)
+    {
+        if (c->Tag[set][w] == line)
+        {
+            c->Age[set][w] = c->Clock;
+            return;
+        }
+        if (c->Age[set][w] < c->Age[set][lru])
+            lru = w;
+    }
+    c->Tag[set][lru] = line;
+    c->Age[set][lru] = c->Clock;
+    c->Misses++;
+}
+
+/// @summary Times BENCH_TICKS enemy updates, then replays the grid-order
+/// position gather through the simulated cache and prints both results.
+/// @param name The name of the phase.
+/// @param em The enemy manager to update.
+/// @param cache The simulated cache.
+static void bench_phase(char const *name, EnemyManager *em, cache_sim_t *cache)
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_TICKS; ++i)
+    {
+        em->Update(0.0, BENCH_TIMESTEP);
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / BENCH_TICKS;
+
+    spatial_grid_t const *grid = em->GetSpatialGrid();
+    float const          *x    = em->GetPositionX();
+    float const          *y    = em->GetPositionY();
+    cache_reset(cache);
+    for (size_t k = 0; k < grid->Count; ++k)
+    {
+        uint32_t i = grid->Items[k];
+        cache_touch(cache, &x[i]);
+        cache_touch(cache, &y[i]);
+    }
+    printf("  %-8s update %7.2f ms/tick, gather misses %5.1f%%\n", name, ms, 100.0 * cache->Misses / (2.0 * grid->Count));
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    DisplayManager dm;
+    dm.SetWorldSize(float(BENCH_FIELD_SIZE), float(BENCH_FIELD_SIZE));
+    EnemyManager  *em    = new EnemyManager(BENCH_ENEMIES, NULL);
+    cache_sim_t   *cache = new cache_sim_t;
+    em->Init(&dm);
+    em->SetSortPolicy(0, 0.0f);
+
+    std::vector<float> xs(BENCH_ENEMIES);
+    std::vector<float> ys(BENCH_ENEMIES);
+    rng8_state_t       rng;
+    random8_seed(&rng, 3);
+    random8_fill_uniform(&xs[0], BENCH_ENEMIES, 0.0f, float(BENCH_FIELD_SIZE), &rng);
+    random8_fill_uniform(&ys[0], BENCH_ENEMIES, 0.0f, float(BENCH_FIELD_SIZE), &rng);
+    for (size_t i = 0; i < BENCH_ENEMIES; ++i)
+    {
+        em->Spawn(EnemyType(i % ENEMY_TYPE_COUNT), xs[i], ys[i]);
+    }
+    em->Update(0.0, BENCH_TIMESTEP);
+
+    printf("enemy_bench, %zu enemies on a %dx%d field, %u KB %u-way simulated cache:\n", em->GetCount(), BENCH_FIELD_SIZE, BENCH_FIELD_SIZE, CACHE_SIZE / 1024U, CACHE_WAYS);
+    bench_phase("random", em, cache);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    em->SortByPosition();
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    printf("  %-8s %7.2f ms\n", "sort", std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    size_t stale = 0;
+    for (size_t i = 0; i < em->GetCount(); ++i)
+    {
+        if (!em->IsAlive(em->GetHandle(i)))
+            stale++;
+    }
+    bench_phase("morton", em, cache);
+
+    for (size_t i = 0; i < BENCH_DRIFT_TICKS; ++i)
+    {
+        em->Update(0.0, BENCH_TIMESTEP);
+    }
+    bench_phase("drifted", em, cache);
+
+    delete cache;
+    delete em;
+    if (stale > 0)
+    {
+        fprintf(stderr, "enemy_bench: %zu handle(s) invalid after the sort.\n", stale);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
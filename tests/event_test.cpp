@@ -0,0 +1,225 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the event streams behind the event bus under
+/// contention. Eight threads append numbered records to one stream at once,
+/// for several rounds. Every record must be stored exactly once, the records
+/// of each thread must appear in the order it appended them, and when the
+/// stream overflows it must store exactly Capacity records, count the rest
+/// as dropped, and grow so that the next round fits. Build and run with
+/// `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "ll_event.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of producer threads.
+#define TEST_THREADS               (8U)
+
+/// @summary The number of records appended by each thread per round.
+#define TEST_RECORDS               (50000U)
+
+/// @summary The number of rounds. The first overflows the stream.
+#define TEST_ROUNDS                (20U)
+
+/// @summary The initial capacity of the stream, in records.
+#define TEST_CAPACITY              (TEST_THREADS * TEST_RECORDS / 4U)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary A record appended by a producer thread.
+struct test_record_t
+{
+    uint32_t Thread;   /// The index of the thread that appended the record.
+    uint32_t Sequence; /// The number of records the thread appended before it.
+    uint32_t Round;    /// The round in which the record was appended.
+    uint32_t Check;    /// A value derived from the other fields.
+};
+
+/// @summary The arguments passed to each producer thread.
+struct producer_args_t
+{
+    event_stream_t      *Stream;  /// The stream to append to.
+    std::atomic<size_t> *Ready;   /// The number of threads waiting to start.
+    uint32_t             Thread;  /// The index of the thread.
+    uint32_t             Round;   /// The current round.
+    size_t               Stored;  /// The number of records the stream accepted.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param round The round being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, uint32_t round)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (round %u)\n", name, round);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Computes the check value of a record.
+/// @param r The record.
+/// @return A value that changes if any other field of the record does.
+static uint32_t record_check(test_record_t const &r)
+{
+    return (r.Thread * 0x9E3779B9U) ^ (r.Sequence * 0x85EBCA6BU) ^ (r.Round * 0xC2B2AE35U);
+}
+
+/// @summary Waits for every producer to be ready, then appends TEST_RECORDS
+/// records to the stream as fast as possible.
+/// @param args The producer_args_t of the thread.
+static void produce(producer_args_t *args)
+{
+    args->Ready->fetch_sub(1);
+    while (args->Ready->load() != 0)
+    {
+        /* spin, so that every thread starts appending at once */
+    }
+    for (uint32_t i = 0; i < TEST_RECORDS; ++i)
+    {
+        test_record_t r;
+        r.Thread   = args->Thread;
+        r.Sequence = i;
+        r.Round    = args->Round;
+        r.Check    = record_check(r);
+        if (event_stream_push(args->Stream, r))
+            args->Stored++;
+    }
+}
+
+/// @summary Checks the contents of the stream after a round.
+/// @param stream The stream.
+/// @param args The arguments of each producer thread.
+/// @param round The round.
+/// @param capacity The capacity of the stream during the round.
+static void check_round(event_stream_t const *stream, producer_args_t const *args, uint32_t round, size_t capacity)
+{
+    size_t const total    = TEST_THREADS * TEST_RECORDS;
+    size_t const expected = total < capacity ? total : capacity;
+    size_t const count    = event_stream_count(stream);
+    size_t       stored   = 0;
+    for (uint32_t t = 0; t < TEST_THREADS; ++t)
+    {
+        stored += args[t].Stored;
+    }
+    check(count == expected, "the stream holds every record that fits", round);
+    check(stored == count, "each accepted append is counted once", round);
+
+    // every record is intact and unique, and each thread's records are in
+    // the order it appended them.
+    std::vector<uint8_t>  seen(total, 0);
+    std::vector<int64_t>  last(TEST_THREADS, -1);
+    test_record_t const  *data    = event_stream_data<test_record_t>(stream);
+    size_t                corrupt = 0;
+    size_t                repeats = 0;
+    size_t                order   = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        test_record_t const &r = data[i];
+        if (r.Thread >= TEST_THREADS || r.Sequence >= TEST_RECORDS || r.Round != round || r.Check != record_check(r))
+        {
+            corrupt++;
+            continue;
+        }
+        size_t key = r.Thread * TEST_RECORDS + r.Sequence;
+        if (seen[key]++) repeats++;
+        if (int64_t(r.Sequence) <= last[r.Thread]) order++;
+        last[r.Thread] = r.Sequence;
+    }
+    check(corrupt == 0, "every record is intact", round);
+    check(repeats == 0, "no record is stored twice", round);
+    check(order == 0, "each thread's records keep their order", round);
+    if (count == total)
+    {
+        size_t missing = 0;
+        for (size_t i = 0; i < total; ++i)
+        {
+            if (!seen[i]) missing++;
+        }
+        check(missing == 0, "every record is stored", round);
+    }
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    event_stream_t stream;
+    if (!event_stream_create(&stream, sizeof(test_record_t), TEST_CAPACITY))
+    {
+        fprintf(stderr, "event_test: cannot allocate the stream.\n");
+        return EXIT_FAILURE;
+    }
+    printf("event_test, %u threads appending %u records each for %u rounds:\n", TEST_THREADS, TEST_RECORDS, TEST_ROUNDS);
+
+    size_t const total = TEST_THREADS * TEST_RECORDS;
+    for (uint32_t round = 0; round < TEST_ROUNDS; ++round)
+    {
+        std::atomic<size_t> ready(TEST_THREADS);
+        std::vector<std::thread> threads;
+        producer_args_t args[TEST_THREADS];
+        size_t capacity = stream.Capacity;
+        size_t dropped  = stream.Dropped;
+        for (uint32_t t = 0; t < TEST_THREADS; ++t)
+        {
+            args[t].Stream = &stream;
+            args[t].Ready  = &ready;
+            args[t].Thread = t;
+            args[t].Round  = round;
+            args[t].Stored = 0;
+            threads.push_back(std::thread(produce, &args[t]));
+        }
+        for (uint32_t t = 0; t < TEST_THREADS; ++t)
+        {
+            threads[t].join();
+        }
+        check_round(&stream, args, round, capacity);
+        event_stream_reset(&stream);
+
+        size_t lost = total > capacity ? total - capacity : 0;
+        check(stream.Dropped - dropped == lost, "records past the capacity are counted as dropped", round);
+        check(stream.Capacity >= total, "the stream grows to fit the demand", round);
+        check(event_stream_count(&stream) == 0, "a reset stream is empty", round);
+        if (round == 0)
+        {
+            printf("  round 0: %zu of %zu records stored, %zu dropped, capacity %zu -> %zu\n", total - lost, total, lost, capacity, stream.Capacity);
+        }
+    }
+    check(stream.Dropped == total - TEST_CAPACITY, "only the first round drops records", TEST_ROUNDS);
+    event_stream_delete(&stream);
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "event_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("event_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the bucketed force field against a brute-force
+/// evaluation of every source for every body. Fields of one source up to the
+/// full 64, so that every bit of the 64-bit source masks is used, are applied
+/// to bodies spread over the region, clustered around the sources, and lying
+/// outside of it, in counts that leave partial blocks. Culling must never
+/// change the result, so the velocities must match the brute-force sum
+/// exactly, with and without the task pool. Build and run with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "math_rng.hpp"
+#include "ll_task.hpp"
+#include "field.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The size of the field region, in world units.
+#define TEST_WORLD_WIDTH           (1000.0f)
+#define TEST_WORLD_HEIGHT          (700.0f)
+
+/// @summary The edge length of a bucketing cell. Smaller than the default,
+/// so that each source covers many cells.
+#define TEST_CELL_SIZE             (50.0f)
+
+/// @summary The time step scale passed to field_apply.
+#define TEST_SCALE                 (1.0f / 14400.0f)
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param value A value identifying the case being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, size_t value)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (%zu)\n", name, value);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Applies every source to every body, in source order, with the
+/// same single precision operations as the field kernel.
+/// @param field The force field.
+/// @param vx The x-velocities of the bodies, updated in place.
+/// @param vy The y-velocities of the bodies, updated in place.
+/// @param px The x-coordinates of the bodies.
+/// @param py The y-coordinates of the bodies.
+/// @param count The number of bodies.
+/// @param scale The factor applied to the velocity change.
+static void brute_apply(force_field_t const *field, float *vx, float *vy, float const *px, float const *py, size_t count, float scale)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t s = 0; s < field->SourceCount; ++s)
+        {
+            field_source_t const &src = field->Sources[s];
+            float dx = src.X - px[i];
+            float dy = src.Y - py[i];
+            float ds = dx * dx + dy * dy;
+            if (!(ds < src.Radius * src.Radius))
+                continue;
+
+            float m  = 1.0f / (src.Softening + ds);
+            float p  = src.Pull  * scale;
+            float w  = src.Swirl * scale;
+            float fx = dx * p - dy * w;
+            float fy = dy * p + dx * w;
+            vx[i] = vx[i] + fx * m;
+            vy[i] = vy[i] + fy * m;
+        }
+    }
+}
+
+/// @summary Builds a field of random sources, some of them partly or wholly
+/// outside of the region, and checks that the field accepts no more than
+/// FIELD_MAX_SOURCES.
+/// @param field The field to fill. Cleared first.
+/// @param sources The number of sources.
+/// @param rng The random number generator.
+static void make_sources(force_field_t *field, size_t sources, rng8_state_t *rng)
+{
+    float p[6];
+    field_clear(field);
+    for (size_t i = 0; i < sources; ++i)
+    {
+        random8_fill_uniform(p, 6, 0.0f, 1.0f, rng);
+        field_source_t src;
+        src.X         = -100.0f + p[0] * (TEST_WORLD_WIDTH  + 200.0f);
+        src.Y         = -100.0f + p[1] * (TEST_WORLD_HEIGHT + 200.0f);
+        src.Pull      = 1.0e4f + p[2] * 1.0e5f;
+        src.Swirl     = (p[3] - 0.5f) * 1.0e5f;
+        src.Radius    = 20.0f + p[4] * 300.0f;
+        src.Softening = 1.0f + p[5] * 1000.0f;
+        check(field_add_source(field, src), "a source below the limit is added", i);
+    }
+    if (sources == FIELD_MAX_SOURCES)
+    {
+        field_source_t extra = field->Sources[0];
+        check(!field_add_source(field, extra), "a source past the limit is rejected", sources);
+        check(field->SourceCount == FIELD_MAX_SOURCES, "a rejected source is not counted", sources);
+    }
+}
+
+/// @summary Places bodies spread over the region and slightly beyond it.
+/// @param px The x-coordinate of each body.
+/// @param py The y-coordinate of each body.
+/// @param count The number of bodies.
+/// @param field The field, unused.
+/// @param rng The random number generator.
+static void place_spread(float *px, float *py, size_t count, force_field_t const *field, rng8_state_t *rng)
+{
+    UNUSED_ARG(field);
+    random8_fill_uniform(px, count, -200.0f, TEST_WORLD_WIDTH  + 200.0f, rng);
+    random8_fill_uniform(py, count, -200.0f, TEST_WORLD_HEIGHT + 200.0f, rng);
+}
+
+/// @summary Places consecutive runs of bodies around each source in turn, so
+/// that most blocks are small and see only one or two sources.
+/// @param px The x-coordinate of each body.
+/// @param py The y-coordinate of each body.
+/// @param count The number of bodies.
+/// @param field The field whose sources the bodies cluster around.
+/// @param rng The random number generator.
+static void place_clustered(float *px, float *py, size_t count, force_field_t const *field, rng8_state_t *rng)
+{
+    random8_fill_uniform(px, count, -1.0f, 1.0f, rng);
+    random8_fill_uniform(py, count, -1.0f, 1.0f, rng);
+    for (size_t i = 0; i < count; ++i)
+    {
+        field_source_t const &src = field->Sources[(i / 37) % field->SourceCount];
+        px[i] = src.X + px[i] * src.Radius * 1.1f;
+        py[i] = src.Y + py[i] * src.Radius * 1.1f;
+    }
+}
+
+/// @summary Applies a field to a set of bodies with and without the task
+/// pool, and compares both with the brute-force sum.
+/// @param field The force field.
+/// @param count The number of bodies.
+/// @param place The function placing the bodies.
+/// @param pool The task pool.
+/// @param rng The random number generator.
+/// @return The number of bodies affected by at least one source.
+static size_t test_case(force_field_t const *field, size_t count, void (*place)(float*, float*, size_t, force_field_t const*, rng8_state_t*), task_pool_t *pool, rng8_state_t *rng)
+{
+    std::vector<float> px(count), py(count);
+    std::vector<float> vx(count), vy(count);
+    place(&px[0], &py[0], count, field, rng);
+    random8_fill_uniform(&vx[0], count, -5.0f, 5.0f, rng);
+    random8_fill_uniform(&vy[0], count, -5.0f, 5.0f, rng);
+
+    std::vector<float> bx(vx), by(vy);
+    std::vector<float> sx(vx), sy(vy);
+    std::vector<float> tx(vx), ty(vy);
+    brute_apply(field, &bx[0], &by[0], &px[0], &py[0], count, TEST_SCALE);
+    field_apply(field, &sx[0], &sy[0], &px[0], &py[0], count, TEST_SCALE, NULL);
+    field_apply(field, &tx[0], &ty[0], &px[0], &py[0], count, TEST_SCALE, pool);
+
+    size_t serial   = 0;
+    size_t pooled   = 0;
+    size_t affected = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (sx[i] != bx[i] || sy[i] != by[i]) serial++;
+        if (tx[i] != bx[i] || ty[i] != by[i]) pooled++;
+        if (bx[i] != vx[i] || by[i] != vy[i]) affected++;
+    }
+    check(serial == 0, "field_apply matches the brute-force sum", serial);
+    check(pooled == 0, "field_apply on the task pool matches the brute-force sum", pooled);
+    return affected;
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    task_pool_t   *pool = task_pool_create(3);
+    force_field_t  field;
+    rng8_state_t   rng;
+    random8_seed(&rng, 63);
+    field_create(&field, 0.0f, 0.0f, TEST_WORLD_WIDTH, TEST_WORLD_HEIGHT, TEST_CELL_SIZE);
+    printf("field_test, %.0fx%.0f region of %.0f unit cells, blocks of %u bodies:\n", TEST_WORLD_WIDTH, TEST_WORLD_HEIGHT, TEST_CELL_SIZE, FIELD_BLOCK_SIZE);
+
+    size_t const sources[] = { 1, 2, 31, 32, 33, 63, FIELD_MAX_SOURCES };
+    size_t const counts[]  = { 1, 7, FIELD_BLOCK_SIZE + 3, 50001 };
+    for (size_t s = 0; s < sizeof(sources) / sizeof(sources[0]); ++s)
+    {
+        size_t bodies   = 0;
+        size_t affected = 0;
+        make_sources(&field, sources[s], &rng);
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            affected += test_case(&field, counts[c], place_spread, pool, &rng);
+            affected += test_case(&field, counts[c], place_clustered, pool, &rng);
+            bodies   += 2 * counts[c];
+        }
+        printf("  %2zu sources: %6zu bodies, %6zu affected\n", sources[s], bodies, affected);
+    }
+
+    // a body next to the last source only must be moved by it, which needs
+    // bit 63 of the cell masks.
+    make_sources(&field, FIELD_MAX_SOURCES, &rng);
+    field_source_t &last = field.Sources[FIELD_MAX_SOURCES - 1];
+    float px = last.X + 1.0f, py = last.Y;
+    float vx = 0.0f, vy = 0.0f;
+    field_apply(&field, &vx, &vy, &px, &py, 1, TEST_SCALE, NULL);
+    check(vx != 0.0f || vy != 0.0f, "the 64th source affects the bodies near it", FIELD_MAX_SOURCES - 1);
+
+    field_delete(&field);
+    task_pool_delete(pool);
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "field_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("field_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a timing benchmark for the spring-mass background grid.
+/// A GRID_COLUMNS x GRID_ROWS lattice is disturbed by explosive, implosive
+/// and directed impulses and then updated on the calling thread, once with
+/// every band updated on every tick and once with the default level-of-detail
+/// schedule. Build and run with `make bench`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "display.hpp"
+#include "grid.hpp"
+#include "math.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of ticks timed for each configuration.
+#define BENCH_TICKS                  (1200U)
+
+/// @summary The fixed timestep, in seconds.
+#define BENCH_TIMESTEP               (1.0 / 120.0)
+
+/// @summary The size of the play area, in world units.
+#define BENCH_WORLD_WIDTH            (800)
+#define BENCH_WORLD_HEIGHT           (600)
+
+/// @summary A label for the math backend this benchmark was compiled against.
+#if GW_MATH_SSE
+    #if defined(__AVX__)
+        #define BENCH_BACKEND_NAME   "AVX"
+    #else
+        #define BENCH_BACKEND_NAME   "SSE"
+    #endif
+#else
+    #define BENCH_BACKEND_NAME       "scalar"
+#endif
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Creates a grid, disturbs it and times BENCH_TICKS updates.
+/// @param name The name of the configuration.
+/// @param dm The display manager providing the size of the play area.
+/// @param period The level-of-detail period passed to SetLodPolicy().
+/// @param settle The level-of-detail settle time passed to SetLodPolicy().
+static void bench_grid(char const *name, DisplayManager *dm, uint32_t period, uint32_t settle)
+{
+    GridManager grid(GRID_COLUMNS, GRID_ROWS, NULL);
+    grid.Init(dm);
+    grid.SetLodPolicy(period, settle);
+    grid.ApplyExplosiveForce(50.0f, 400.0f, 300.0f, 150.0f);
+    grid.ApplyImplosiveForce(30.0f, 200.0f, 200.0f, 100.0f);
+    grid.ApplyDirectedForce (5.0f, -3.0f, 600.0f, 100.0f, 80.0f);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_TICKS; ++i)
+    {
+        grid.Update(i * BENCH_TIMESTEP, BENCH_TIMESTEP);
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(t1 - t0).count() / BENCH_TICKS;
+    printf("  %-24s %8.3f ms/tick (%4.1f%% of point updates skipped)\n", name, ms, grid.GetLodSkipped() * 100.0f);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    DisplayManager dm;
+    dm.SetWorldSize(BENCH_WORLD_WIDTH, BENCH_WORLD_HEIGHT);
+    printf("grid_bench (%s), %ux%u points, %u ticks on one thread:\n", BENCH_BACKEND_NAME, GRID_COLUMNS, GRID_ROWS, BENCH_TICKS);
+    bench_grid("every band, every tick", &dm, 1, 0);
+    bench_grid("default LOD schedule", &dm, GRID_LOD_PERIOD, GRID_LOD_SETTLE);
+    return EXIT_SUCCESS;
+}
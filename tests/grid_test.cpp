@@ -0,0 +1,331 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the task pool and of the spring-mass grid it
+/// splits. Parallel loops over a range of counts and chunk sizes must visit
+/// every index exactly once, in chunks no smaller than requested, with and
+/// without a pool. A grid disturbed by every kind of impulse and updated on
+/// the pool must match the same grid updated on the calling thread exactly,
+/// with and without the level-of-detail schedule; it must come back to rest
+/// once the impulses stop, and a restored snapshot must replay the same
+/// ticks exactly. Build and run with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <vector>
+#include "display.hpp"
+#include "grid.hpp"
+#include "ll_snapshot.hpp"
+#include "ll_task.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of worker threads in the task pool.
+#define TEST_WORKERS               (3U)
+
+/// @summary The fixed timestep, in seconds.
+#define TEST_TIMESTEP              (1.0 / 120.0)
+
+/// @summary The number of ticks during which impulses are applied.
+#define TEST_DISTURB_TICKS         (240U)
+
+/// @summary The number of quiet ticks the grid is given to come to rest.
+#define TEST_SETTLE_TICKS          (3600U)
+
+/// @summary The largest distance from its rest position, in pixels, of any
+/// point of a grid that has come back to rest.
+#define TEST_REST_EPSILON          (0.01f)
+
+/// @summary The size of the play area, in world units.
+#define TEST_WORLD_WIDTH           (800)
+#define TEST_WORLD_HEIGHT          (600)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary The state shared by the invocations of a parallel loop.
+struct coverage_t
+{
+    std::atomic<uint32_t> *Visits;    /// The number of times each index was visited.
+    std::atomic<size_t>    Calls;     /// The number of invocations.
+    std::atomic<size_t>    Short;     /// The number of invocations below the minimum chunk.
+    std::atomic<size_t>    Invalid;   /// The number of invocations with an empty or out-of-range range.
+    size_t                 Count;     /// The number of items in the loop.
+    size_t                 MinChunk;  /// The minimum chunk size passed to the loop.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param value A value identifying the case being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, size_t value)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (%zu)\n", name, value);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Records the range processed by one invocation of a parallel loop.
+/// @param begin The index of the first item to process.
+/// @param end The index one past the last item to process.
+/// @param context The coverage_t of the loop.
+static void visit_range(size_t begin, size_t end, void *context)
+{
+    coverage_t *cov = (coverage_t*) context;
+    cov->Calls++;
+    if (begin >= end || end > cov->Count)
+    {
+        cov->Invalid++;
+        return;
+    }
+    if (end - begin < cov->MinChunk && end != cov->Count)
+    {
+        cov->Short++;
+    }
+    for (size_t i = begin; i < end; ++i)
+    {
+        cov->Visits[i]++;
+    }
+}
+
+/// @summary Runs a parallel loop that records every index it visits, and
+/// checks that each index was visited exactly once.
+/// @param pool The task pool, or NULL.
+/// @param count The number of items in the loop.
+/// @param min_chunk The minimum chunk size.
+/// @return The number of invocations of the loop body.
+static size_t test_parallel_for(task_pool_t *pool, size_t count, size_t min_chunk)
+{
+    std::vector<std::atomic<uint32_t> > visits(count > 0 ? count : 1);
+    coverage_t cov;
+    for (size_t i = 0; i < visits.size(); ++i)
+    {
+        visits[i].store(0);
+    }
+    cov.Visits   = &visits[0];
+    cov.Calls    = 0;
+    cov.Short    = 0;
+    cov.Invalid  = 0;
+    cov.Count    = count;
+    cov.MinChunk = min_chunk;
+    task_pool_parallel_for(pool, count, min_chunk, visit_range, &cov);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (visits[i].load() != 1) wrong++;
+    }
+    check(wrong == 0, "every index is visited exactly once", count);
+    check(cov.Invalid.load() == 0, "every range is non-empty and in bounds", count);
+    check(cov.Short.load() == 0, "only the last range is smaller than the minimum chunk", count);
+    check(count > 0 || cov.Calls.load() == 0, "an empty loop never calls the body", min_chunk);
+    return cov.Calls.load();
+}
+
+/// @summary Disturbs a grid with every kind of impulse during the first
+/// TEST_DISTURB_TICKS ticks, at positions that move from tick to tick.
+/// @param grid The grid.
+/// @param tick The tick about to be simulated.
+static void disturb(GridManager *grid, size_t tick)
+{
+    if (tick >= TEST_DISTURB_TICKS)
+        return;
+
+    float t = float(tick);
+    if (tick % 7 == 0) grid->ApplyExplosiveForce(50.0f, 100.0f + 2.5f * t, 300.0f, 150.0f);
+    if (tick % 5 == 0) grid->ApplyImplosiveForce(30.0f, 700.0f - 2.0f * t, 150.0f + t, 100.0f);
+    if (tick % 3 == 0) grid->ApplyDirectedForce (5.0f, -3.0f, 400.0f, 550.0f - 2.0f * t, 80.0f);
+}
+
+/// @summary Advances a grid by a number of ticks.
+/// @param grid The grid.
+/// @param first The first tick to simulate.
+/// @param count The number of ticks to simulate.
+static void run(GridManager *grid, size_t first, size_t count)
+{
+    for (size_t i = first; i < first + count; ++i)
+    {
+        disturb(grid, i);
+        grid->Update(i * TEST_TIMESTEP, TEST_TIMESTEP);
+    }
+}
+
+/// @summary Saves the state of a grid into an empty snapshot buffer.
+/// @param grid The grid.
+/// @param buffer The buffer, which is emptied first.
+static void save(GridManager const *grid, snapshot_buffer_t *buffer)
+{
+    buffer->Size   = 0;
+    buffer->Cursor = 0;
+    check(grid->Save(buffer), "the grid state is saved", buffer->Size);
+}
+
+/// @summary Checks whether two snapshot buffers hold the same bytes.
+/// @param a The first buffer.
+/// @param b The second buffer.
+/// @return true if the buffers match.
+static bool same_state(snapshot_buffer_t const *a, snapshot_buffer_t const *b)
+{
+    return a->Size == b->Size && memcmp(a->Data, b->Data, a->Size) == 0;
+}
+
+/// @summary Computes the largest distance of any point of a grid from its
+/// position in another snapshot of the same grid.
+/// @param a The first snapshot, which begins with the point positions.
+/// @param b The second snapshot.
+/// @param points The number of points in the grid.
+/// @return The largest distance, in pixels.
+static float max_offset(snapshot_buffer_t const *a, snapshot_buffer_t const *b, size_t points)
+{
+    float const *ax = (float const*) a->Data;
+    float const *bx = (float const*) b->Data;
+    float const *ay = ax + points;
+    float const *by = bx + points;
+    float        md = 0.0f;
+    for (size_t i = 0; i < points; ++i)
+    {
+        float dx = ax[i] - bx[i];
+        float dy = ay[i] - by[i];
+        float d  = sqrtf(dx * dx + dy * dy);
+        if (d > md) md = d;
+    }
+    return md;
+}
+
+/// @summary Runs a grid on the calling thread and on the task pool, checks
+/// that both match on every tick, that the grid comes back to rest, and that
+/// a restored snapshot replays the same ticks.
+/// @param name The name of the configuration.
+/// @param dm The display manager providing the size of the play area.
+/// @param pool The task pool.
+/// @param period The level-of-detail period passed to SetLodPolicy().
+/// @param settle The level-of-detail settle time passed to SetLodPolicy().
+static void test_grid(char const *name, DisplayManager *dm, task_pool_t *pool, uint32_t period, uint32_t settle)
+{
+    GridManager serial(GRID_COLUMNS, GRID_ROWS, NULL);
+    GridManager pooled(GRID_COLUMNS, GRID_ROWS, pool);
+    serial.Init(dm);
+    pooled.Init(dm);
+    serial.SetLodPolicy(period, settle);
+    pooled.SetLodPolicy(period, settle);
+
+    snapshot_buffer_t rest, a, b, mark;
+    memset(&rest, 0, sizeof(rest));
+    memset(&a   , 0, sizeof(a));
+    memset(&b   , 0, sizeof(b));
+    memset(&mark, 0, sizeof(mark));
+    save(&serial, &rest);
+
+    // the pool splits the update by band, and bands never write to each
+    // other, so the split must not change a single bit of the result.
+    size_t const points   = GRID_COLUMNS * GRID_ROWS;
+    size_t const total    = TEST_DISTURB_TICKS + TEST_SETTLE_TICKS;
+    size_t const midpoint = TEST_DISTURB_TICKS / 2;
+    size_t       differ   = 0;
+    float        peak     = 0.0f;
+    for (size_t i = 0; i < total; ++i)
+    {
+        run(&serial, i, 1);
+        run(&pooled, i, 1);
+        save(&serial, &a);
+        save(&pooled, &b);
+        if (!same_state(&a, &b)) differ++;
+        if (i < TEST_DISTURB_TICKS)
+        {
+            float d = max_offset(&a, &rest, points);
+            if (d > peak) peak = d;
+        }
+        if (i + 1 == midpoint)
+        {
+            save(&serial, &mark);
+        }
+    }
+    float offset = max_offset(&a, &rest, points);
+    check(differ == 0, "the pooled update matches the serial update", differ);
+    check(peak > 1.0f, "the impulses move the grid", size_t(peak));
+    check(offset < TEST_REST_EPSILON, "the grid comes back to rest", size_t(offset * 1000.0f));
+
+    // restoring the midpoint into the pooled grid rewinds it, and replaying
+    // the same ticks arrives at the same state as the serial grid.
+    mark.Cursor = 0;
+    check(pooled.Restore(&mark), "the grid state is restored", mark.Size);
+    check(mark.Cursor == mark.Size, "restore reads everything save wrote", mark.Cursor);
+    save(&pooled, &b);
+    check(same_state(&mark, &b), "a restored grid saves the same state", b.Size);
+    run(&pooled, midpoint, total - midpoint);
+    save(&pooled, &b);
+    check(same_state(&a, &b), "a restored grid replays the same ticks", total - midpoint);
+
+    printf("  %-24s peak offset %7.3f px, after %u quiet ticks %.6f px, %4.1f%% of point updates skipped\n",
+        name, peak, TEST_SETTLE_TICKS, offset, serial.GetLodSkipped() * 100.0f);
+    free(mark.Data);
+    free(b.Data);
+    free(a.Data);
+    free(rest.Data);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    task_pool_t *pool = task_pool_create(TEST_WORKERS);
+    if (pool == NULL)
+    {
+        fprintf(stderr, "grid_test: cannot create the task pool.\n");
+        return EXIT_FAILURE;
+    }
+    printf("grid_test, %zu threads per loop:\n", task_pool_concurrency(pool));
+    check(task_pool_concurrency(pool) == TEST_WORKERS + 1, "the calling thread joins the workers", task_pool_concurrency(pool));
+    check(task_pool_concurrency(NULL) == 1, "a NULL pool runs on the calling thread", task_pool_concurrency(NULL));
+
+    size_t const counts[] = { 0, 1, 2, 7, 16, 17, 64, 1000, 100003 };
+    size_t const chunks[] = { 0, 1, 3, 16, 64, 5000 };
+    size_t       calls    = 0;
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        for (size_t k = 0; k < sizeof(chunks) / sizeof(chunks[0]); ++k)
+        {
+            calls += test_parallel_for(pool, counts[c], chunks[k]);
+            check(test_parallel_for(NULL, counts[c], chunks[k]) == (counts[c] > 0 ? 1U : 0U), "a NULL pool runs the loop in one call", counts[c]);
+        }
+    }
+    printf("  parallel_for: %zu loops, %zu calls of the loop body\n", sizeof(counts) / sizeof(counts[0]) * sizeof(chunks) / sizeof(chunks[0]), calls);
+
+    DisplayManager dm;
+    dm.SetWorldSize(TEST_WORLD_WIDTH, TEST_WORLD_HEIGHT);
+    test_grid("every band, every tick", &dm, pool, 1, 0);
+    test_grid("default LOD schedule", &dm, pool, GRID_LOD_PERIOD, GRID_LOD_SETTLE);
+
+    task_pool_delete(pool);
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "grid_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("grid_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a round-trip test of the lockstep input codec. Two
+/// sessions on the loopback interface exchange generated input through the
+/// Exp-Golomb and run-length coded packets: idle input, a jittering mouse,
+/// full-range random input, and random input with half of the packets to one
+/// session dropped, so that the backlog overflows a datagram and is sent in
+/// pieces. Every tick each session simulates must hold
+/// exactly the input generated for it. State hashes are exchanged, a hash
+/// mismatch is injected and must be reported at the right tick, and the
+/// bandwidth of each phase is printed. Build and run with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lockstep.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The first of the two loopback ports used by the sessions.
+#define TEST_PORT                  (47810U)
+
+/// @summary The simulation rate, in ticks per second.
+#define TEST_TICK_RATE             (120U)
+
+/// @summary The number of ticks in each phase of generated input.
+#define TEST_PHASE_TICKS           (1200U)
+
+/// @summary The number of phases: idle, jitter, random and lossy.
+#define TEST_PHASE_COUNT           (4U)
+
+/// @summary The tick at which the second session reports a different hash.
+#define TEST_DESYNC_TICK           (3U * LOCKSTEP_HASH_INTERVAL * 10U)
+
+/// @summary The rate each session must stay under while idle and while the
+/// mouse jitters, in bytes per second including UDP/IP headers.
+#define TEST_MAX_RATE              (800U)
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/// @summary The names of the phases of generated input.
+static char const *gPhaseNames[TEST_PHASE_COUNT] = { "idle", "jitter", "random", "lossy" };
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param tick The tick being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, uint32_t tick)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (tick %u)\n", name, tick);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Hashes a player index and tick into a pseudo-random value, so
+/// that the input for any tick can be generated again when it is checked.
+/// @param player The player index.
+/// @param tick The tick.
+/// @param salt Selects one of several independent values.
+/// @return A pseudo-random 32-bit value.
+static uint32_t mix(uint32_t player, uint32_t tick, uint32_t salt)
+{
+    uint32_t h = player * 0x9E3779B9U ^ tick * 0x85EBCA6BU ^ salt * 0xC2B2AE35U;
+    h ^= h >> 16; h *= 0x7FEB352DU;
+    h ^= h >> 15; h *= 0x846CA68BU;
+    h ^= h >> 16;
+    return h;
+}
+
+/// @summary Generates the input of a player for a tick.
+/// @param player The player index.
+/// @param tick The tick.
+/// @param dst On return, the input.
+static void make_input(uint32_t player, uint32_t tick, lockstep_input_t *dst)
+{
+    memset(dst, 0, sizeof(lockstep_input_t));
+    uint32_t phase = tick / TEST_PHASE_TICKS;
+    if (phase == 0)
+    {
+        // idle: the cursor rests and a key is tapped once a second.
+        dst->MouseX  = int16_t(400 + player * 10);
+        dst->MouseY  = 300;
+        dst->Keys[1] = (tick % TEST_TICK_RATE) < 10 ? 1U << 7 : 0U;
+    }
+    else if (phase == 1)
+    {
+        // jitter: the cursor drifts in a circle with a pixel or two of noise
+        // every tick, and the fire button is held half of the time.
+        int32_t cx = int32_t((tick * 3U) % 800U);
+        int32_t cy = int32_t((tick * 2U) % 600U);
+        dst->MouseX       = int16_t(cx + int32_t(mix(player, tick, 0) % 5U) - 2);
+        dst->MouseY       = int16_t(cy + int32_t(mix(player, tick, 1) % 5U) - 2);
+        dst->MouseButtons = uint8_t((tick / 60U) & 1U);
+    }
+    else
+    {
+        // random: every field takes any value on every tick.
+        dst->MouseX       = int16_t(mix(player, tick, 0));
+        dst->MouseY       = int16_t(mix(player, tick, 1));
+        dst->MouseButtons = uint8_t(mix(player, tick, 2));
+        dst->Modifiers    = uint8_t(mix(player, tick, 3));
+        for (uint32_t i = 0; i < INPUT_KEY_WORDS; ++i)
+        {
+            dst->Keys[i] = mix(player, tick, 4 + i) & mix(player, tick, 20 + i);
+        }
+    }
+}
+
+/// @summary Checks whether two inputs hold the same values.
+/// @param a The first input.
+/// @param b The second input.
+/// @return true if every field matches.
+static bool same_input(lockstep_input_t const *a, lockstep_input_t const *b)
+{
+    return a->MouseX == b->MouseX && a->MouseY == b->MouseY &&
+           a->MouseButtons == b->MouseButtons && a->Modifiers == b->Modifiers &&
+           memcmp(a->Keys, b->Keys, sizeof(a->Keys)) == 0;
+}
+
+/// @summary Generates the state hash a session reports for a tick.
+/// @param session The session index.
+/// @param tick The tick.
+/// @return The hash; the second session's differs at TEST_DESYNC_TICK.
+static uint64_t make_hash(uint32_t session, uint32_t tick)
+{
+    uint64_t h = (uint64_t(mix(0, tick, 100)) << 32) | mix(0, tick, 101);
+    return (session == 1 && tick == TEST_DESYNC_TICK) ? ~h : h;
+}
+
+/// @summary Discards the datagrams waiting on a session's socket.
+/// @param ls The session.
+static void drop_packets(lockstep_t *ls)
+{
+    uint8_t       data[NET_MAX_DATAGRAM];
+    net_address_t from;
+    while (udp_recv(&ls->Socket, &from, data, sizeof(data)) > 0)
+    {
+        /* empty */
+    }
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    net_address_t endpoints[2];
+    lockstep_t   *ls = (lockstep_t*) malloc(2 * sizeof(lockstep_t));
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        endpoints[i].Host = 0x7F000001U;
+        endpoints[i].Port = uint16_t(TEST_PORT + i);
+    }
+    if (!lockstep_create(&ls[0], endpoints, 2, 0, LOCKSTEP_DEFAULT_DELAY) ||
+        !lockstep_create(&ls[1], endpoints, 2, 1, LOCKSTEP_DEFAULT_DELAY))
+    {
+        fprintf(stderr, "lockstep_test: cannot bind loopback ports %u and %u.\n", TEST_PORT, TEST_PORT + 1);
+        return EXIT_FAILURE;
+    }
+
+    // each session simulates at most one tick per step of the clock, as the
+    // game does, and submits input Delay ticks ahead of the tick it waits on.
+    uint32_t const last      = TEST_PHASE_COUNT * TEST_PHASE_TICKS;
+    uint32_t       tick[2]   = { 0, 0 };
+    uint64_t       bytes[2]  = { 0, 0 };
+    uint64_t       packets[2]= { 0, 0 };
+    uint32_t       reported  = 0;
+    double         start     = 0.0;
+    double         now       = 0.0;
+    size_t         step      = 0;
+    printf("lockstep_test, %u ticks of input per phase, %u ticks of delay:\n", TEST_PHASE_TICKS, LOCKSTEP_DEFAULT_DELAY);
+    while ((tick[0] < last || tick[1] < last) && step < 4 * last)
+    {
+        now = double(++step) / TEST_TICK_RATE;
+        for (uint32_t s = 0; s < 2; ++s)
+        {
+            uint32_t t = tick[s];
+            if (t / TEST_PHASE_TICKS == 3 && s == 1 && (mix(s, uint32_t(step), 200) & 1U))
+            {
+                drop_packets(&ls[s]);
+            }
+            lockstep_update(&ls[s], now);
+            if (t >= last)
+                continue;
+
+            lockstep_player_t const &local = ls[s].Players[s];
+            if (local.Received == t + LOCKSTEP_DEFAULT_DELAY && t + LOCKSTEP_DEFAULT_DELAY < last)
+            {
+                lockstep_input_t input;
+                make_input(s, t + LOCKSTEP_DEFAULT_DELAY, &input);
+                check(lockstep_submit(&ls[s], &input), "lockstep_submit accepts input", t);
+            }
+            if (!lockstep_ready(&ls[s], t))
+                continue;
+
+            for (uint32_t p = 0; p < 2; ++p)
+            {
+                lockstep_input_t expect;
+                if (t >= LOCKSTEP_DEFAULT_DELAY) make_input(p, t, &expect);
+                else memset(&expect, 0, sizeof(expect));
+                check(same_input(lockstep_get_input(&ls[s], p, t), &expect), "decoded input matches the input sent", t);
+            }
+            if (t > 0 && t % LOCKSTEP_HASH_INTERVAL == 0)
+            {
+                lockstep_submit_hash(&ls[s], t, make_hash(s, t));
+            }
+            tick[s] = t + 1;
+        }
+
+        // report the bandwidth of each phase once the first session leaves it.
+        if (tick[0] == (reported + 1) * TEST_PHASE_TICKS)
+        {
+            uint32_t phase   = reported++;
+            double   seconds = now - start;
+            uint64_t sent0   = ls[0].Socket.BytesSent - bytes[0];
+            uint64_t sent1   = ls[1].Socket.BytesSent - bytes[1];
+            uint64_t pkts0   = ls[0].PacketsSent - packets[0];
+            uint64_t pkts1   = ls[1].PacketsSent - packets[1];
+            double   total0  = (sent0 + pkts0 * NET_UDP_OVERHEAD) / seconds;
+            double   total1  = (sent1 + pkts1 * NET_UDP_OVERHEAD) / seconds;
+            printf("  %-8s %6.1f s, payload %6.0f / %6.0f B/s, with UDP/IP headers %6.0f / %6.0f B/s\n",
+                gPhaseNames[phase], seconds, sent0 / seconds, sent1 / seconds, total0, total1);
+            if (phase < 2)
+            {
+                check(total0 < TEST_MAX_RATE && total1 < TEST_MAX_RATE, "idle and jittering input stay under the bandwidth budget", tick[0]);
+            }
+            bytes[0]   = ls[0].Socket.BytesSent;
+            bytes[1]   = ls[1].Socket.BytesSent;
+            packets[0] = ls[0].PacketsSent;
+            packets[1] = ls[1].PacketsSent;
+            start      = now;
+        }
+    }
+    check(tick[0] == last && tick[1] == last, "both sessions simulate every tick", tick[0] < tick[1] ? tick[0] : tick[1]);
+
+    // let the last hashes reach the other session before checking them.
+    for (size_t i = 0; i < TEST_TICK_RATE; ++i)
+    {
+        now += 1.0 / TEST_TICK_RATE;
+        lockstep_update(&ls[0], now);
+        lockstep_update(&ls[1], now);
+    }
+    uint32_t hashed = ((last - 1) / LOCKSTEP_HASH_INTERVAL) * LOCKSTEP_HASH_INTERVAL;
+    check(ls[0].Players[1].HashTick == hashed && ls[1].Players[0].HashTick == hashed, "the latest hash reaches the other session", hashed);
+    check(ls[0].DesyncTick == TEST_DESYNC_TICK, "session 0 reports the injected desync", ls[0].DesyncTick);
+    check(ls[1].DesyncTick == TEST_DESYNC_TICK, "session 1 reports the injected desync", ls[1].DesyncTick);
+    printf("  desync reported at tick %u / %u, injected at %u\n", ls[0].DesyncTick, ls[1].DesyncTick, TEST_DESYNC_TICK);
+
+    lockstep_delete(&ls[1]);
+    lockstep_delete(&ls[0]);
+    free(ls);
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "lockstep_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("lockstep_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements copies of the vec4, quat and mat4 routines as they were
+/// defined in math.cpp before they moved inline into math.hpp: scalar code,
+/// called out-of-line. The math_test benchmarks time these against the
+/// current inline routines. Kept in a separate translation unit so that the
+/// calls cannot be inlined.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include "math.hpp"
+
+/*///////////////
+//  Functions  //
+///////////////*/
+float before_vec4_dot(float &dst, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    dst = (a_xyzw[0] * b_xyzw[0] + a_xyzw[1] * b_xyzw[1] + a_xyzw[2] * b_xyzw[2] + a_xyzw[3] * b_xyzw[3]);
+    return dst;
+}
+
+float* before_vec4_add(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    dst_xyzw[0] = a_xyzw[0] + b_xyzw[0];
+    dst_xyzw[1] = a_xyzw[1] + b_xyzw[1];
+    dst_xyzw[2] = a_xyzw[2] + b_xyzw[2];
+    dst_xyzw[3] = a_xyzw[3] + b_xyzw[3];
+    return dst_xyzw;
+}
+
+float* before_vec4_cross(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    float ax    = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2];
+    float bx    = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2];
+    dst_xyzw[0] = ay * bz  - az * by;
+    dst_xyzw[1] = az * bx  - ax * bz;
+    dst_xyzw[2] = ax * by  - ay * bx;
+    dst_xyzw[3] = 0.0f; // cross product always results in a vector
+    return dst_xyzw;
+}
+
+float before_vec4_len(float &dst, float const *a_xyzw)
+{
+    dst = sqrtf(a_xyzw[0] * a_xyzw[0] + a_xyzw[1] * a_xyzw[1] + a_xyzw[2] * a_xyzw[2] + a_xyzw[3] * a_xyzw[3]);
+    return dst;
+}
+
+float* before_vec4_nrm(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    float len;
+    if (!eq(before_vec4_len(len, src_xyzw), 0))
+    {
+        float rcp = 1.0f / len;
+        dst_xyzw[0]  = src_xyzw[0] * rcp;
+        dst_xyzw[1]  = src_xyzw[1] * rcp;
+        dst_xyzw[2]  = src_xyzw[2] * rcp;
+        dst_xyzw[3]  = src_xyzw[3] * rcp;
+        return dst_xyzw;
+    }
+    else return vec4_set_pinf(dst_xyzw);
+}
+
+float* before_quat_mul(float * __restrict dst_xyzw, float const * __restrict a_xyzw, float const * __restrict b_xyzw)
+{
+    float ax = a_xyzw[0], ay = a_xyzw[1], az = a_xyzw[2], aw = a_xyzw[3];
+    float bx = b_xyzw[0], by = b_xyzw[1], bz = b_xyzw[2], bw = b_xyzw[3];
+    dst_xyzw[0] = ((aw * bx) + (ax * bw) + (ay * bz) - (az * by));
+    dst_xyzw[1] = ((aw * by) - (ax * bz) + (ay * bw) + (az * bx));
+    dst_xyzw[2] = ((aw * bz) + (ax * by) - (ay * bx) + (az * bw));
+    dst_xyzw[3] = ((aw * bw) - (ax * bx) - (ay * by) - (az * bz));
+    return dst_xyzw;
+}
+
+float* before_quat_conj(float * __restrict dst_xyzw, float const * __restrict src_xyzw)
+{
+    dst_xyzw[0] = -src_xyzw[0];
+    dst_xyzw[1] = -src_xyzw[1];
+    dst_xyzw[2] = -src_xyzw[2];
+    dst_xyzw[3] =  src_xyzw[3];
+    return dst_xyzw;
+}
+
+float* before_mat4_concat(float * __restrict dst16, float const * __restrict a16, float const * __restrict b16)
+{
+    // transformation 'a' is applied first, followed by transformation 'b'.
+    // result is the dot product of the columns of 'a' and the rows of 'b'.
+    float a0   = a16[0];
+    float a1   = a16[1];
+    float a2   = a16[2];
+    float a3   = a16[3];
+    float a4   = a16[4];
+    float a5   = a16[5];
+    float a6   = a16[6];
+    float a7   = a16[7];
+    float a8   = a16[8];
+    float a9   = a16[9];
+    float a10  = a16[10];
+    float a11  = a16[11];
+    float a12  = a16[12];
+    float a13  = a16[13];
+    float a14  = a16[14];
+    float a15  = a16[15];
+    float b0   = b16[0];
+    float b1   = b16[1];
+    float b2   = b16[2];
+    float b3   = b16[3];
+    float b4   = b16[4];
+    float b5   = b16[5];
+    float b6   = b16[6];
+    float b7   = b16[7];
+    float b8   = b16[8];
+    float b9   = b16[9];
+    float b10  = b16[10];
+    float b11  = b16[11];
+    float b12  = b16[12];
+    float b13  = b16[13];
+    float b14  = b16[14];
+    float b15  = b16[15];
+
+    dst16[0]   = b0 * a0  + b4 * a1  + b8  * a2  + b12 * a3;
+    dst16[1]   = b1 * a0  + b5 * a1  + b9  * a2  + b13 * a3;
+    dst16[2]   = b2 * a0  + b6 * a1  + b10 * a2  + b14 * a3;
+    dst16[3]   = b3 * a0  + b7 * a1  + b11 * a2  + b15 * a3;
+
+    dst16[4]   = b0 * a4  + b4 * a5  + b8  * a6  + b12 * a7;
+    dst16[5]   = b1 * a4  + b5 * a5  + b9  * a6  + b13 * a7;
+    dst16[6]   = b2 * a4  + b6 * a5  + b10 * a6  + b14 * a7;
+    dst16[7]   = b3 * a4  + b7 * a5  + b11 * a6  + b15 * a7;
+
+    dst16[8]   = b0 * a8  + b4 * a9  + b8  * a10 + b12 * a11;
+    dst16[9]   = b1 * a8  + b5 * a9  + b9  * a10 + b13 * a11;
+    dst16[10]  = b2 * a8  + b6 * a9  + b10 * a10 + b14 * a11;
+    dst16[11]  = b3 * a8  + b7 * a9  + b11 * a10 + b15 * a11;
+
+    dst16[12]  = b0 * a12 + b4 * a13 + b8  * a14 + b12 * a15;
+    dst16[13]  = b1 * a12 + b5 * a13 + b9  * a14 + b13 * a15;
+    dst16[14]  = b2 * a12 + b6 * a13 + b10 * a14 + b14 * a15;
+    dst16[15]  = b3 * a12 + b7 * a13 + b11 * a14 + b15 * a15;
+
+    return dst16;
+}
+
+float* before_mat4_transform_vec4(
+    float       * __restrict dst_xyzw,
+    float const * __restrict src_xyzw,
+    float const * __restrict t16)
+{
+    float vx = src_xyzw[0];
+    float vy = src_xyzw[1];
+    float vz = src_xyzw[2];
+    float vw = src_xyzw[3];
+
+    dst_xyzw[0] = t16[0] * vx + t16[4] * vy + t16[8]  * vz + t16[12] * vw;
+    dst_xyzw[1] = t16[1] * vx + t16[5] * vy + t16[9]  * vz + t16[13] * vw;
+    dst_xyzw[2] = t16[2] * vx + t16[6] * vy + t16[10] * vz + t16[14] * vw;
+    dst_xyzw[3] = t16[3] * vx + t16[7] * vy + t16[11] * vz + t16[15] * vw;
+
+    return dst_xyzw;
+}
@@ -0,0 +1,1159 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements accuracy, property and timing tests for the math
+/// library. Each routine is checked against a double-precision reference
+/// using eq_ulp(), randomized inputs are checked against algebraic identities,
+/// and the per-call cost of the hot routines is reported, along with the cost
+/// of their former out-of-line versions in math_before.cpp. The array and
+/// structure-of-arrays kernels are checked against the scalar routines. Build
+/// and run with `make test-math`, which runs both the SIMD and the scalar
+/// (GW_MATH_SSE=0) builds.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string.h>
+#include "math.hpp"
+#include "math_soa.hpp"
+#include "ll_task.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of random inputs used for each accuracy and property check.
+#define TEST_SAMPLES               (100000U)
+
+/// @summary The number of elements in the arrays used by the array transform
+/// checks. Not a multiple of eight, so the scalar tail of each kernel runs.
+#define TEST_ARRAY_COUNT           (100003U)
+
+/// @summary The number of calls timed for each benchmark.
+#define BENCH_ITERATIONS           (4000000U)
+
+/// @summary The number of distinct inputs cycled through by each benchmark.
+/// Small enough that the inputs stay resident in L1.
+#define BENCH_INPUTS               (256U)
+
+/// @summary A label for the math backend this test was compiled against.
+#if GW_MATH_SSE
+    #define TEST_BACKEND_NAME      "SIMD"
+#else
+    #define TEST_BACKEND_NAME      "scalar"
+#endif
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t   gFailures = 0;
+
+/// @summary The state of the generator used to produce test inputs.
+static uint32_t gTestSeed = 0x9E3779B9U;
+
+/// @summary Benchmark inputs and outputs. The outputs are global so that the
+/// compiler cannot discard the work being timed.
+static float    gBenchA[BENCH_INPUTS][16];
+static float    gBenchB[BENCH_INPUTS][16];
+static float    gBenchOut[16];
+static float    gBenchSum = 0.0f;
+
+/// @summary The routines as they were defined in math.cpp before they moved
+/// inline, from math_before.cpp.
+extern float  before_vec4_dot(float &dst, float const *a_xyzw, float const *b_xyzw);
+extern float* before_vec4_add(float *dst_xyzw, float const *a_xyzw, float const *b_xyzw);
+extern float* before_vec4_cross(float *dst_xyzw, float const *a_xyzw, float const *b_xyzw);
+extern float* before_vec4_nrm(float *dst_xyzw, float const *src_xyzw);
+extern float* before_quat_mul(float *dst_xyzw, float const *a_xyzw, float const *b_xyzw);
+extern float* before_quat_conj(float *dst_xyzw, float const *src_xyzw);
+extern float* before_mat4_concat(float *dst16, float const *a16, float const *b16);
+extern float* before_mat4_transform_vec4(float *dst_xyzw, float const *src_xyzw, float const *t16);
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Generates a pseudo-random value in [lo, hi) using xorshift32.
+/// The sequence is fixed so that failures are reproducible.
+/// @param lo The inclusive lower bound.
+/// @param hi The exclusive upper bound.
+/// @return A value in [lo, hi).
+static float test_random(float lo, float hi)
+{
+    gTestSeed ^= gTestSeed << 13;
+    gTestSeed ^= gTestSeed >> 17;
+    gTestSeed ^= gTestSeed << 5;
+    return lo + (hi - lo) * float(gTestSeed >> 8) * (1.0f / 16777216.0f);
+}
+
+/// @summary Generates a random unit quaternion.
+/// @param dst_xyzw The quaternion to populate.
+static void test_random_quat(float *dst_xyzw)
+{
+    float q[4];
+    for (size_t i = 0; i < 4; ++i)
+        q[i] = test_random(-1.0f, 1.0f);
+    quat_nrm(dst_xyzw, q);
+}
+
+/// @summary Generates a random, well-conditioned affine transform composed of
+/// a rotation, a non-uniform scale and a translation.
+/// @param dst16 The matrix to populate.
+static void test_random_affine(float *dst16)
+{
+    float q[4], r[16], s[16], t[16], rs[16];
+    test_random_quat(q);
+    mat4_set_quat(r, q);
+    mat4_scale(s, test_random(0.5f, 2.0f), test_random(0.5f, 2.0f), test_random(0.5f, 2.0f));
+    mat4_trans(t, test_random(-100.0f, 100.0f), test_random(-100.0f, 100.0f), test_random(-100.0f, 100.0f));
+    mat4_concat(rs, s, r);
+    mat4_concat(dst16, rs, t);
+}
+
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param index The sample index, for reproducing the failure.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, size_t index)
+{
+    if (!passed)
+    {
+        // only report the first few failures of any one run.
+        if (gFailures < 16) fprintf(stderr, "FAIL: %s (sample %zu)\n", name, index);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Tracks the largest error observed by a group of eq_ulp checks.
+struct ulp_check_t
+{
+    char const *Name;     /// The name of the routine being checked.
+    uint32_t    Limit;    /// The maximum permitted error, in ULPs.
+    uint32_t    MaxError; /// The largest error observed.
+    size_t      Count;    /// The number of values checked.
+};
+
+/// @summary Initializes a ULP check group.
+/// @param c The check group to initialize.
+/// @param name The name of the routine being checked.
+/// @param limit The maximum permitted error, in ULPs.
+static void ulp_check_init(ulp_check_t *c, char const *name, uint32_t limit)
+{
+    c->Name     = name;
+    c->Limit    = limit;
+    c->MaxError = 0;
+    c->Count    = 0;
+}
+
+/// @summary Compares a single-precision result against a double-precision
+/// reference value rounded to single-precision.
+/// @param c The check group.
+/// @param value The value computed by the routine under test.
+/// @param reference The double-precision reference value.
+/// @param index The sample index, for reproducing a failure.
+static void ulp_check(ulp_check_t *c, float value, double reference, size_t index)
+{
+    uint32_t err = ulp_distance(value, float(reference));
+    if (err > c->MaxError) c->MaxError = err;
+    check(eq_ulp(value, float(reference), c->Limit), c->Name, index);
+    c->Count++;
+}
+
+/// @summary Prints the summary of a ULP check group.
+/// @param c The check group.
+static void ulp_check_report(ulp_check_t const *c)
+{
+    printf("  %-30s max %3u ULP (limit %3u) over %zu values\n", c->Name, c->MaxError, c->Limit, c->Count);
+}
+
+/// @summary Tracks the largest error observed by a group of absolute error
+/// checks, for routines whose results are compared with a tolerance rather
+/// than a reference value, such as identities involving sin and cos.
+struct abs_check_t
+{
+    char const *Name;     /// The name of the routine or identity being checked.
+    float       Limit;    /// The maximum permitted absolute error.
+    float       MaxError; /// The largest error observed.
+    size_t      Count;    /// The number of values checked.
+};
+
+/// @summary Initializes an absolute error check group.
+/// @param c The check group to initialize.
+/// @param name The name of the routine or identity being checked.
+/// @param limit The maximum permitted absolute error.
+static void abs_check_init(abs_check_t *c, char const *name, float limit)
+{
+    c->Name     = name;
+    c->Limit    = limit;
+    c->MaxError = 0.0f;
+    c->Count    = 0;
+}
+
+/// @summary Compares a set of values against their expected values.
+/// @param c The check group.
+/// @param value The values computed by the routine under test.
+/// @param expect The expected values.
+/// @param count The number of values to compare.
+/// @param index The sample index, for reproducing a failure.
+static void abs_check(abs_check_t *c, float const *value, float const *expect, size_t count, size_t index)
+{
+    float err = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        float e = fabsf(value[i] - expect[i]);
+        if (!(e <= err)) err = e; // NaN propagates as a failure.
+    }
+    if (err > c->MaxError || err != err) c->MaxError = err;
+    check(err <= c->Limit, c->Name, index);
+    c->Count += count;
+}
+
+/// @summary Prints the summary of an absolute error check group.
+/// @param c The check group.
+static void abs_check_report(abs_check_t const *c)
+{
+    printf("  %-30s max abs error %-11g (limit %g) over %zu values\n", c->Name, c->MaxError, c->Limit, c->Count);
+}
+
+/// @summary Checks ulp_distance() and eq_ulp() against known answers.
+static void test_ulp_distance(void)
+{
+    printf("ulp_distance:\n");
+    check(ulp_distance(1.0f, 1.0f) == 0, "ulp_distance(1, 1) == 0", 0);
+    check(ulp_distance(1.0f, nextafterf(1.0f, 2.0f)) == 1, "ulp_distance(1, next(1)) == 1", 0);
+    check(ulp_distance(nextafterf(1.0f, 0.0f), 1.0f) == 1, "ulp_distance(prev(1), 1) == 1", 0);
+    check(ulp_distance(0.0f, -0.0f) == 0, "ulp_distance(+0, -0) == 0", 0);
+    check(ulp_distance(-FLT_MIN, FLT_MIN) == 0x01000000U, "ulp_distance(-FLT_MIN, FLT_MIN)", 0);
+    check(ulp_distance(1.0f, NAN) == UINT32_MAX, "ulp_distance(1, NaN) == UINT32_MAX", 0);
+    check(ulp_distance(NAN, NAN) == UINT32_MAX, "ulp_distance(NaN, NaN) == UINT32_MAX", 0);
+    check(ulp_distance(-FLT_MAX, FLT_MAX) == 0xFEFFFFFEU, "ulp_distance(-FLT_MAX, FLT_MAX)", 0);
+    check(ulp_distance(FLT_MAX, INFINITY) == 1, "ulp_distance(FLT_MAX, inf) == 1", 0);
+    check(eq_ulp(1.0f, 1.0000001f, 1), "eq_ulp(1, 1 + eps, 1)", 0);
+    check(!eq_ulp(1.0f, 1.0000003f, 1), "!eq_ulp(1, 1 + 3 eps, 1)", 0);
+    printf("  done\n");
+}
+
+/// @summary Checks the vector, quaternion and matrix routines against a
+/// double-precision reference. Inputs are positive so the reference sums do
+/// not cancel, which keeps the ULP error meaningful.
+static void test_reference(void)
+{
+    ulp_check_t dot, len, nrm, qmul, concat, xform, det;
+    ulp_check_init(&dot,    "vec4_dot",            2);
+    ulp_check_init(&len,    "vec4_len",            2);
+    ulp_check_init(&nrm,    "vec4_nrm",            3);
+    ulp_check_init(&qmul,   "quat_mul",            2);
+    ulp_check_init(&concat, "mat4_concat",         2);
+    ulp_check_init(&xform,  "mat4_transform_vec4", 2);
+    ulp_check_init(&det,    "mat4_det",            4);
+
+    printf("reference (double precision):\n");
+    for (size_t n = 0; n < TEST_SAMPLES; ++n)
+    {
+        float  a[16], b[16], r[16], s;
+        double ref[16];
+        for (size_t i = 0; i < 16; ++i)
+        {
+            a[i] = test_random(0.25f, 4.0f);
+            b[i] = test_random(0.25f, 4.0f);
+        }
+
+        vec4_dot(s, a, b);
+        ulp_check(&dot, s, double(a[0])*b[0] + double(a[1])*b[1] + double(a[2])*b[2] + double(a[3])*b[3], n);
+
+        ulp_check(&len, vec4_len(s, a), sqrt(double(a[0])*a[0] + double(a[1])*a[1] + double(a[2])*a[2] + double(a[3])*a[3]), n);
+
+        double l = sqrt(double(a[0])*a[0] + double(a[1])*a[1] + double(a[2])*a[2] + double(a[3])*a[3]);
+        vec4_nrm(r, a);
+        for (size_t i = 0; i < 4; ++i)
+            ulp_check(&nrm, r[i], a[i] / l, n);
+
+        // with b conjugated, the w term of the product is a sum of positive
+        // products; the x, y and z terms cancel and are covered by the
+        // inverse and slerp properties instead.
+        float bc[4] = { -b[0], -b[1], -b[2], b[3] };
+        quat_mul(r, a, bc);
+        ref[3] = double(a[3])*bc[3] - double(a[0])*bc[0] - double(a[1])*bc[1] - double(a[2])*bc[2];
+        ulp_check(&qmul, r[3], ref[3], n);
+
+        // transformation a is applied first, then b; column-major storage.
+        mat4_concat(r, a, b);
+        for (size_t c = 0; c < 4; ++c)
+        {
+            for (size_t k = 0; k < 4; ++k)
+            {
+                ref[c*4+k] = double(b[0*4+k])*a[c*4+0] + double(b[1*4+k])*a[c*4+1] +
+                             double(b[2*4+k])*a[c*4+2] + double(b[3*4+k])*a[c*4+3];
+                ulp_check(&concat, r[c*4+k], ref[c*4+k], n);
+            }
+        }
+
+        mat4_transform_vec4(r, b, a);
+        for (size_t k = 0; k < 4; ++k)
+        {
+            ref[k] = double(a[0*4+k])*b[0] + double(a[1*4+k])*b[1] + double(a[2*4+k])*b[2] + double(a[3*4+k])*b[3];
+            ulp_check(&xform, r[k], ref[k], n);
+        }
+
+        // a diagonally dominant matrix keeps the determinant well away from zero.
+        float m[16];
+        mat4_set_mat4(m, a);
+        m[0] += 16.0f; m[5] += 16.0f; m[10] += 16.0f;
+        double c0 = double(m[5])*m[10] - double(m[6])*m[9];
+        double c4 = double(m[2])*m[9]  - double(m[1])*m[10];
+        double c8 = double(m[1])*m[6]  - double(m[2])*m[5];
+        ulp_check(&det, mat4_det(m), m[0]*c0 + m[4]*c4 + m[8]*c8, n);
+    }
+    ulp_check_report(&dot);
+    ulp_check_report(&len);
+    ulp_check_report(&nrm);
+    ulp_check_report(&qmul);
+    ulp_check_report(&concat);
+    ulp_check_report(&xform);
+    ulp_check_report(&det);
+}
+
+/// @summary Checks randomized inputs against algebraic identities: the
+/// product of an affine transform and its inverse is the identity, and the
+/// spherical interpolation of two unit quaternions is a unit quaternion.
+static void test_properties(void)
+{
+    float  max_inv_err   = 0.0f;
+    uint32_t max_len_ulp = 0;
+
+    printf("properties:\n");
+    for (size_t n = 0; n < TEST_SAMPLES; ++n)
+    {
+        float m[16], inv[16], p[16];
+        test_random_affine(m);
+        mat4_inv_affine(inv, m);
+        mat4_concat(p, inv, m);
+        for (size_t i = 0; i < 16; ++i)
+        {
+            // the translation column picks up error proportional to its magnitude.
+            float expect = (i % 5) == 0 ? 1.0f : 0.0f;
+            float tol    = i >= 12 ? 1.0e-4f : 1.0e-5f;
+            float err    = fabsf(p[i] - expect);
+            if (err > max_inv_err) max_inv_err = err;
+            check(eq_abs(p[i], expect, tol), "mat4_inv_affine(M) * M == I", n);
+        }
+
+        float a[4], b[4], q[4];
+        test_random_quat(a);
+        test_random_quat(b);
+        quat_slerp(q, a, b, test_random(0.0f, 1.0f));
+        uint32_t err = ulp_distance(quat_len(q), 1.0f);
+        if (err > max_len_ulp) max_len_ulp = err;
+        check(eq_ulp(quat_len(q), 1.0f, 8), "|quat_slerp(a, b, t)| == 1", n);
+    }
+    printf("  %-30s max abs error %g\n", "mat4_inv_affine(M) * M", max_inv_err);
+    printf("  %-30s max %3u ULP (limit %3u)\n", "|quat_slerp(a, b, t)|", max_len_ulp, 8U);
+}
+
+/// @summary Rotates a vector by a unit quaternion, through mat4_set_quat().
+/// @param dst_xyz The rotated vector.
+/// @param q_xyzw The rotation.
+/// @param src_xyz The vector to rotate.
+static void test_rotate(float *dst_xyz, float const *q_xyzw, float const *src_xyz)
+{
+    float m[16];
+    mat4_set_quat(m, q_xyzw);
+    mat4_transform_vector(dst_xyz, src_xyz, m);
+}
+
+/// @summary Checks the quaternion routines against known answers and
+/// identities: construction from angle-axis, Euler angles and matrices agree
+/// with the matrix constructors, exp inverts log, the interpolators hit their
+/// endpoints and stay on the unit sphere, and squad reduces to slerp when its
+/// control points are the endpoints.
+static void test_quaternions(void)
+{
+    float const half = 0.70710678f;
+    float q[4], r[4], m[16], n[16];
+
+    printf("quaternions:\n");
+    float z_axis[3] = { 0.0f, 0.0f, 1.0f };
+    float q_z90[4]  = { 0.0f, 0.0f, half, half };
+    quat_set_angle_axis_radian_n(q, float(M_PI / 2), z_axis);
+    check(eq_abs(q[0], 0.0f, 1e-7f) && eq_abs(q[1], 0.0f, 1e-7f) && eq_ulp(q[2], half, 1) && eq_ulp(q[3], half, 1), "quat_set_angle_axis(90, z)", 0);
+    quat_set_euler_degree(r, 0.0f, 0.0f, 90.0f);
+    check(eq_abs(quat_dot(q, r), 1.0f, 1e-6f), "quat_set_euler(0, 0, 90) == quat_set_angle_axis(90, z)", 0);
+    mat4_set_quat(m, q_z90);
+    mat4_set_euler_radian_z(n, float(M_PI / 2));
+    float ex[3] = { 1.0f, 0.0f, 0.0f }, ey[3];
+    mat4_transform_vector(ey, ex, m);
+    check(eq_abs(ey[0], 0.0f, 1e-6f) && eq_abs(ey[1], 1.0f, 1e-6f) && eq_abs(ey[2], 0.0f, 1e-6f), "mat4_set_quat(90, z) rotates x to y", 0);
+    quat_set_ident(r);
+    quat_set_mat4(q, m);
+    check(eq_abs(fabsf(quat_dot(q, q_z90)), 1.0f, 1e-6f), "quat_set_mat4(mat4_set_quat(q)) == q", 0);
+    quat_set_mat4(q, mat4_set_ident(m));
+    check(quat_eq(q, r), "quat_set_mat4(I) == identity", 0);
+    float qa[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    quat_inv(q, qa);
+    check(eq_ulp(q[0], -1.0f / 30.0f, 1) && eq_ulp(q[1], -2.0f / 30.0f, 1) && eq_ulp(q[2], -3.0f / 30.0f, 1) && eq_ulp(q[3], 4.0f / 30.0f, 1), "quat_inv(1, 2, 3, 4)", 0);
+    quat_linear(q, r, q_z90, 0.25f);
+    check(eq_ulp(q[2], 0.25f * half, 1) && eq_ulp(q[3], 0.75f + 0.25f * half, 1), "quat_linear(I, q, 0.25)", 0);
+
+    abs_check_t mat, euler, axis_u, inv, exp_log, orient, slerp_end, squad_end, squad_slerp, squad_len, spline;
+    abs_check_init(&mat,         "quat_set_mat4(mat4_set_quat)",    1e-5f);
+    abs_check_init(&euler,       "quat_set_euler vs mat4",          1e-5f);
+    abs_check_init(&axis_u,      "quat/mat4_set_angle_axis_u",      1e-5f);
+    abs_check_init(&inv,         "q * quat_inv(q) == I",            1e-5f);
+    abs_check_init(&exp_log,     "quat_exp(quat_log(q)) == q",      1e-4f);
+    abs_check_init(&orient,      "quat_orient_vec3",                1e-4f);
+    abs_check_init(&slerp_end,   "quat_slerp endpoints",            1e-5f);
+    abs_check_init(&squad_end,   "quat_squad endpoints",            1e-5f);
+    abs_check_init(&squad_slerp, "quat_squad(p, p, q, q)",          1e-5f);
+    abs_check_init(&squad_len,   "|quat_squad|",                    1e-5f);
+    abs_check_init(&spline,      "quat_spline on a uniform arc",    1e-4f);
+
+    for (size_t k = 0; k < TEST_SAMPLES; ++k)
+    {
+        float a[4], b[4], c[4], d[4], e[4];
+        float one = 1.0f, len;
+        test_random_quat(a);
+        test_random_quat(b);
+
+        // the matrix and the quaternion agree up to sign.
+        mat4_set_quat(m, a);
+        quat_set_mat4(e, m);
+        quat_closest(q, e, a);
+        abs_check(&mat, q, a, 4, k);
+
+        float rx = test_random(-3.0f, 3.0f), ry = test_random(-3.0f, 3.0f), rz = test_random(-3.0f, 3.0f);
+        quat_set_euler_radian(q, rx, ry, rz);
+        mat4_set_quat(m, q);
+        mat4_set_euler_radian(n, rx, ry, rz);
+        abs_check(&euler, m, n, 16, k);
+
+        float axis[3] = { test_random(-2.0f, 2.0f), test_random(-2.0f, 2.0f), test_random(0.5f, 2.0f) };
+        float angle   = test_random(-3.0f, 3.0f);
+        quat_set_angle_axis_radian_u(q, angle, axis);
+        mat4_set_quat(m, q);
+        mat4_set_angle_axis_radian_u(n, angle, axis);
+        abs_check(&axis_u, m, n, 16, k);
+
+        quat_inv(q, a);
+        quat_mul(c, a, q);
+        abs_check(&inv, c, quat_set_ident(d), 4, k);
+
+        // log is defined for w in (-1, 1); the identity holds up to sign.
+        quat_log(c, a);
+        quat_exp(e, c);
+        quat_closest(d, e, a);
+        abs_check(&exp_log, d, a, 4, k);
+
+        quat_closest(c, a, b);
+        check(quat_dot(c, b) >= 0.0f && (quat_eq(c, a) || (c[0] == -a[0] && c[1] == -a[1] && c[2] == -a[2] && c[3] == -a[3])), "quat_closest", k);
+
+        // rotate a random vector onto another, avoiding opposite vectors.
+        float from[3] = { test_random(-1.0f, 1.0f), test_random(-1.0f, 1.0f), test_random(0.1f, 1.0f) };
+        float to[3]   = { test_random(-1.0f, 1.0f), test_random(-1.0f, 1.0f), test_random(0.1f, 1.0f) };
+        float fn[3], tn[3], rot[3];
+        vec3_nrm(fn, from);
+        vec3_nrm(tn, to);
+        quat_orient_vec3(q, from, to);
+        test_rotate(rot, q, fn);
+        abs_check(&orient, rot, tn, 3, k);
+
+        quat_closest(e, b, a);
+        quat_slerp(c, a, b, 0.0f);
+        abs_check(&slerp_end, c, a, 4, k);
+        quat_slerp(c, a, b, 1.0f);
+        abs_check(&slerp_end, c, e, 4, k);
+
+        // squad between a and b, with control points c and d.
+        test_random_quat(c);
+        test_random_quat(d);
+        float t = test_random(0.0f, 1.0f);
+        quat_squad(q, a, c, d, b, 0.0f);
+        abs_check(&squad_end, q, a, 4, k);
+        quat_squad(e, a, c, d, b, 1.0f);
+        quat_closest(q, e, b);
+        abs_check(&squad_end, q, b, 4, k);
+        quat_squad(q, a, c, d, b, t);
+        len = quat_len(q);
+        abs_check(&squad_len, &len, &one, 1, k);
+        quat_squad(q, a, a, b, b, t);
+        quat_slerp(r, a, b, t);
+        abs_check(&squad_slerp, q, r, 4, k);
+
+        // on an arc of uniform steps about one axis, the spline control point
+        // at the middle key is the key itself.
+        float step = test_random(0.05f, 0.5f);
+        float p0[4], p1[4], p2[4];
+        quat_set_angle_axis_radian_u(p0, angle - step, axis);
+        quat_set_angle_axis_radian_u(p1, angle,        axis);
+        quat_set_angle_axis_radian_u(p2, angle + step, axis);
+        quat_spline(q, p1, p2, p0);
+        abs_check(&spline, q, p1, 4, k);
+    }
+    abs_check_report(&mat);
+    abs_check_report(&euler);
+    abs_check_report(&axis_u);
+    abs_check_report(&inv);
+    abs_check_report(&exp_log);
+    abs_check_report(&orient);
+    abs_check_report(&slerp_end);
+    abs_check_report(&squad_end);
+    abs_check_report(&squad_slerp);
+    abs_check_report(&squad_len);
+    abs_check_report(&spline);
+}
+
+/// @summary Evaluates a plane at a point.
+/// @param plane_xyzD The plane coefficients.
+/// @param p_xyz The point.
+/// @return The signed distance from the plane to the point, if the plane is
+/// normalized; otherwise a value with the same sign.
+static float test_plane_dist(float const *plane_xyzD, float const *p_xyz)
+{
+    return plane_xyzD[0] * p_xyz[0] + plane_xyzD[1] * p_xyz[1] + plane_xyzD[2] * p_xyz[2] + plane_xyzD[3];
+}
+
+/// @summary Checks the matrix constructors and accessors against known
+/// answers: rows and columns round-trip, the Euler, angle-axis, scale and
+/// translation matrices move points where expected, the view and projection
+/// matrices map the view volume onto the unit cube, and the frustum planes
+/// extracted from a projection bound the view volume.
+static void test_matrices(void)
+{
+    float m[16], n[16], p[16], v[4], w[4];
+    float r0[4] = {  1.0f,  2.0f,  3.0f,  4.0f };
+    float r1[4] = {  5.0f,  6.0f,  7.0f,  8.0f };
+    float r2[4] = {  9.0f, 10.0f, 11.0f, 12.0f };
+    float r3[4] = { 13.0f, 14.0f, 15.0f, 16.0f };
+
+    printf("matrices:\n");
+    mat4_set_rows(m, r0, r1, r2, r3);
+    check(m[0] == 1.0f && m[4] == 2.0f && m[1] == 5.0f && m[15] == 16.0f, "mat4_set_rows layout", 0);
+    mat4_set_cols(n, r0, r1, r2, r3);
+    mat4_transpose(p, n);
+    check(memcmp(m, p, sizeof(m)) == 0, "mat4_set_rows == transpose(mat4_set_cols)", 0);
+    mat4_set(p, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f);
+    check(memcmp(m, p, sizeof(m)) == 0, "mat4_set == mat4_set_rows", 0);
+    mat4_get_row(v, 2, m);
+    mat4_get_col(w, 2, n);
+    check(memcmp(v, r2, sizeof(v)) == 0 && memcmp(w, r2, sizeof(w)) == 0, "mat4_get_row, mat4_get_col", 0);
+    mat4_set_row(m, 3, r0);
+    mat4_set_col(n, 3, r0);
+    mat4_get_row(v, 3, m);
+    mat4_get_col(w, 3, n);
+    check(memcmp(v, r0, sizeof(v)) == 0 && memcmp(w, r0, sizeof(w)) == 0, "mat4_set_row, mat4_set_col", 0);
+    check(mat4_trace(p) == 34.0f, "mat4_trace", 0);
+    check(mat4_det(mat4_scale(m, 2.0f, 3.0f, 4.0f)) == 24.0f, "mat4_det(scale(2, 3, 4)) == 24", 0);
+    check(mat4_is_identity(mat4_set_ident(m)) && !mat4_is_identity(mat4_trans(n, 0.0f, 1.0f, 0.0f)), "mat4_is_identity", 0);
+    check(mat4_eq(m, m) && !mat4_eq(m, n), "mat4_eq", 0);
+
+    // scale, then translate; points are column vectors.
+    float pt[3] = { 1.0f, 2.0f, 3.0f }, out[3];
+    mat4_scale(m, 2.0f, 3.0f, 4.0f);
+    mat4_trans(n, 10.0f, 20.0f, 30.0f);
+    mat4_concat(p, m, n);
+    mat4_transform_point(out, pt, p);
+    check(out[0] == 12.0f && out[1] == 26.0f && out[2] == 42.0f, "mat4_trans(mat4_scale(p))", 0);
+    mat4_transform_vector(out, pt, p);
+    check(out[0] == 2.0f && out[1] == 6.0f && out[2] == 12.0f, "mat4_transform_vector ignores translation", 0);
+
+    // each Euler matrix matches the angle-axis rotation about its axis.
+    float ax[3] = { 1.0f, 0.0f, 0.0f }, ay[3] = { 0.0f, 1.0f, 0.0f }, az[3] = { 0.0f, 0.0f, 1.0f };
+    abs_check_t euler_axis, euler_xyz, rotation;
+    abs_check_init(&euler_axis, "mat4_set_euler_{x,y,z}",         1e-6f);
+    abs_check_init(&euler_xyz,  "mat4_set_euler == Rz Ry Rx",     1e-5f);
+    abs_check_init(&rotation,   "mat4_set_angle_axis R R^T == I", 1e-5f);
+    for (size_t k = 0; k < TEST_SAMPLES / 10; ++k)
+    {
+        float rx = test_random(-3.0f, 3.0f), ry = test_random(-3.0f, 3.0f), rz = test_random(-3.0f, 3.0f);
+        float x[16], y[16], z[16], xy[16], xyz[16];
+        mat4_set_euler_radian_x(x, rx);
+        mat4_set_angle_axis_radian_n(m, rx, ax);
+        abs_check(&euler_axis, x, m, 16, k);
+        mat4_set_euler_radian_y(y, ry);
+        mat4_set_angle_axis_radian_n(m, ry, ay);
+        abs_check(&euler_axis, y, m, 16, k);
+        mat4_set_euler_radian_z(z, rz);
+        mat4_set_angle_axis_radian_n(m, rz, az);
+        abs_check(&euler_axis, z, m, 16, k);
+        mat4_concat(xy, z, y);
+        mat4_concat(xyz, xy, x);
+        mat4_set_euler_radian(m, rx, ry, rz);
+        abs_check(&euler_xyz, m, xyz, 16, k);
+
+        // R * transpose(R) == I, and det(R) == 1.
+        float axis[3] = { test_random(-1.0f, 1.0f), test_random(-1.0f, 1.0f), test_random(0.5f, 1.0f) };
+        float det = mat4_det(mat4_set_angle_axis_radian_u(m, rx, axis)), one = 1.0f;
+        mat4_transpose(n, m);
+        mat4_concat(p, m, n);
+        abs_check(&rotation, p, mat4_set_ident(xyz), 16, k);
+        abs_check(&rotation, &det, &one, 1, k);
+    }
+    abs_check_report(&euler_axis);
+    abs_check_report(&euler_xyz);
+    abs_check_report(&rotation);
+
+    // the view matrix moves the eye to the origin, looking down -z.
+    float eye[3] = { 3.0f, 4.0f, 12.0f }, target[3] = { 3.0f, 4.0f, 2.0f }, up[3] = { 0.0f, 1.0f, 0.0f };
+    float above[3] = { 3.0f, 5.0f, 2.0f };
+    mat4_look_at(m, eye, target, up);
+    mat4_transform_point(out, eye, m);
+    check(eq_abs(out[0], 0.0f, 1e-5f) && eq_abs(out[1], 0.0f, 1e-5f) && eq_abs(out[2], 0.0f, 1e-5f), "mat4_look_at(eye) == 0", 0);
+    mat4_transform_point(out, target, m);
+    check(eq_abs(out[0], 0.0f, 1e-5f) && eq_abs(out[1], 0.0f, 1e-5f) && eq_abs(out[2], -10.0f, 1e-5f), "mat4_look_at(target) == (0, 0, -10)", 0);
+    mat4_transform_point(out, above, m);
+    check(eq_abs(out[0], 0.0f, 1e-5f) && eq_abs(out[1], 1.0f, 1e-5f) && eq_abs(out[2], -10.0f, 1e-5f), "mat4_look_at keeps up", 0);
+
+    // projections map the corners of the view volume onto the unit cube.
+    float lbn[4] = { -4.0f, -3.0f, -1.0f, 1.0f }, rtf[4] = { 6.0f, 5.0f, -9.0f, 1.0f };
+    mat4_ortho(m, -4.0f, 6.0f, -3.0f, 5.0f, 1.0f, 9.0f);
+    mat4_transform_vec4(v, lbn, m);
+    check(eq_abs(v[0], -1.0f, 1e-6f) && eq_abs(v[1], -1.0f, 1e-6f) && eq_abs(v[2], -1.0f, 1e-6f) && v[3] == 1.0f, "mat4_ortho(l, b, n) == (-1, -1, -1)", 0);
+    mat4_transform_vec4(v, rtf, m);
+    check(eq_abs(v[0],  1.0f, 1e-6f) && eq_abs(v[1],  1.0f, 1e-6f) && eq_abs(v[2],  1.0f, 1e-6f) && v[3] == 1.0f, "mat4_ortho(r, t, f) == (1, 1, 1)", 0);
+
+    // a 90 degree field of view with aspect 2 puts the right edge of the near
+    // plane at x = 2 * near.
+    float nr[4] = { 2.0f, 1.0f, -1.0f, 1.0f }, fc[4] = { 0.0f, 0.0f, -100.0f, 1.0f };
+    mat4_persp_degree(p, 90.0f, 2.0f, 1.0f, 100.0f);
+    mat4_transform_vec4(v, nr, p);
+    check(eq_abs(v[0] / v[3], 1.0f, 1e-6f) && eq_abs(v[1] / v[3], 1.0f, 1e-6f) && eq_abs(v[2] / v[3], -1.0f, 1e-6f), "mat4_persp near corner == (1, 1, -1)", 0);
+    mat4_transform_vec4(v, fc, p);
+    check(eq_abs(v[0] / v[3], 0.0f, 1e-6f) && eq_abs(v[2] / v[3], 1.0f, 1e-5f), "mat4_persp far center == (0, 0, 1)", 0);
+
+    // the 2D projection maps pixels, with y down, onto clip space.
+    float tl[3] = { 0.0f, 0.0f, 0.0f }, br[3] = { 800.0f, 600.0f, 0.0f };
+    mat4_2d(m, 800.0f, 600.0f);
+    mat4_transform_point(out, tl, m);
+    check(eq_abs(out[0], -1.0f, 1e-6f) && eq_abs(out[1],  1.0f, 1e-6f), "mat4_2d(0, 0) == (-1, 1)", 0);
+    mat4_transform_point(out, br, m);
+    check(eq_abs(out[0],  1.0f, 1e-6f) && eq_abs(out[1], -1.0f, 1e-6f), "mat4_2d(w, h) == (1, -1)", 0);
+
+    // the frustum of the perspective projection, in view space. normalized
+    // planes give the true distance to a point, and all six planes face in.
+    float l[4], r[4], t[4], b[4], np[4], fp[4];
+    float inside[3] = { 0.5f, -0.25f, -50.0f }, before[3] = { 0.0f, 0.0f, -0.5f }, beyond[3] = { 0.0f, 0.0f, -101.0f };
+    mat4_extract_frustum_n(l, r, t, b, np, fp, p);
+    float lens[6] = { vec3_len(lens[0], l), vec3_len(lens[1], r), vec3_len(lens[2], t), vec3_len(lens[3], b), vec3_len(lens[4], np), vec3_len(lens[5], fp) };
+    bool  unit    = true;
+    for (size_t i = 0; i < 6; ++i) unit = unit && eq_abs(lens[i], 1.0f, 1e-6f);
+    check(unit, "mat4_extract_frustum_n planes are normalized", 0);
+    check(test_plane_dist(l, inside) > 0.0f && test_plane_dist(r, inside) > 0.0f && test_plane_dist(t, inside) > 0.0f &&
+          test_plane_dist(b, inside) > 0.0f && test_plane_dist(np, inside) > 0.0f && test_plane_dist(fp, inside) > 0.0f, "mat4_extract_frustum_n contains an inside point", 0);
+    check(eq_abs(test_plane_dist(np, before), -0.5f, 1e-5f), "mat4_extract_frustum_n near distance", 0);
+    check(eq_abs(test_plane_dist(fp, beyond), -1.0f, 1e-3f), "mat4_extract_frustum_n far distance", 0);
+    check(eq_abs(test_plane_dist(r, nr), 0.0f, 1e-5f) && eq_abs(test_plane_dist(t, nr), 0.0f, 1e-5f), "mat4_extract_frustum_n near corner", 0);
+    mat4_extract_frustum_u(l, r, t, b, np, fp, p);
+    check(test_plane_dist(np, before) < 0.0f && test_plane_dist(fp, beyond) < 0.0f && test_plane_dist(l, inside) > 0.0f, "mat4_extract_frustum_u signs", 0);
+    printf("  done\n");
+}
+
+/// @summary Checks the array and structure-of-arrays transforms, including the
+/// multi-threaded variants, against the scalar mat4_transform_point() and
+/// mat4_transform_vector() routines.
+static void test_array_transforms(void)
+{
+    size_t const n   = TEST_ARRAY_COUNT;
+    float *src       = (float*) malloc(n * 4 * sizeof(float));
+    float *dst       = (float*) malloc(n * 4 * sizeof(float));
+    float *sx        = (float*) malloc(n * 3 * sizeof(float));
+    float *dx        = (float*) malloc(n * 3 * sizeof(float));
+    float *sy        = sx + n, *sz = sx + n * 2;
+    float *dy        = dx + n, *dz = dx + n * 2;
+    task_pool_t *pool= task_pool_create(4);
+    float  m[16];
+    float  ref[4];
+
+    printf("array transforms:\n");
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = test_random(0.25f, 4.0f);
+    for (size_t i = 0; i < n * 4; ++i)
+        src[i] = test_random(0.25f, 4.0f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        sx[i] = src[i*3+0];
+        sy[i] = src[i*3+1];
+        sz[i] = src[i*3+2];
+    }
+
+    ulp_check_t point, vector, vec4, soa, point_mt, vec4_mt, soa_mt;
+    // the vector kernels add the translation column in a different order
+    // than the scalar routines, which costs up to one rounding per sum.
+    ulp_check_init(&point,    "mat4_transform_array_point",    2);
+    ulp_check_init(&vector,   "mat4_transform_array_vector",   1);
+    ulp_check_init(&vec4,     "mat4_transform_array_vec4",     1);
+    ulp_check_init(&soa,      "mat4_transform_soa_point",      2);
+    ulp_check_init(&point_mt, "mat4_transform_array_point_mt", 2);
+    ulp_check_init(&vec4_mt,  "mat4_transform_array_vec4_mt",  1);
+    ulp_check_init(&soa_mt,   "mat4_transform_soa_point_mt",   2);
+
+    mat4_transform_array_point(dst, src, m, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_point(ref, &src[i*3], m);
+        for (size_t k = 0; k < 3; ++k) ulp_check(&point, dst[i*3+k], ref[k], i);
+    }
+    mat4_transform_array_point_mt(dst, src, m, n, pool);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_point(ref, &src[i*3], m);
+        for (size_t k = 0; k < 3; ++k) ulp_check(&point_mt, dst[i*3+k], ref[k], i);
+    }
+    mat4_transform_array_vector(dst, src, m, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_vector(ref, &src[i*3], m);
+        for (size_t k = 0; k < 3; ++k) ulp_check(&vector, dst[i*3+k], ref[k], i);
+    }
+    mat4_transform_array_vec4(dst, src, m, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_vec4(ref, &src[i*4], m);
+        for (size_t k = 0; k < 4; ++k) ulp_check(&vec4, dst[i*4+k], ref[k], i);
+    }
+    mat4_transform_array_vec4_mt(dst, src, m, n, pool);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_vec4(ref, &src[i*4], m);
+        for (size_t k = 0; k < 4; ++k) ulp_check(&vec4_mt, dst[i*4+k], ref[k], i);
+    }
+    mat4_transform_soa_point(dx, dy, dz, sx, sy, sz, m, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_point(ref, &src[i*3], m);
+        ulp_check(&soa, dx[i], ref[0], i);
+        ulp_check(&soa, dy[i], ref[1], i);
+        ulp_check(&soa, dz[i], ref[2], i);
+    }
+    mat4_transform_soa_point_mt(dx, dy, dz, sx, sy, sz, m, n, pool);
+    for (size_t i = 0; i < n; ++i)
+    {
+        mat4_transform_point(ref, &src[i*3], m);
+        ulp_check(&soa_mt, dx[i], ref[0], i);
+        ulp_check(&soa_mt, dy[i], ref[1], i);
+        ulp_check(&soa_mt, dz[i], ref[2], i);
+    }
+    ulp_check_report(&point);
+    ulp_check_report(&point_mt);
+    ulp_check_report(&vector);
+    ulp_check_report(&vec4);
+    ulp_check_report(&vec4_mt);
+    ulp_check_report(&soa);
+    ulp_check_report(&soa_mt);
+
+    task_pool_delete(pool);
+    free(dx);
+    free(sx);
+    free(dst);
+    free(src);
+}
+
+/// @summary Checks the structure-of-arrays 2D vector kernels against known
+/// answers, and against the scalar vec2 routines over an array that starts
+/// one element past an aligned address, so that the peeled head, the wide
+/// body and the scalar tail of soa_for_range() all run.
+static void test_soa_kernels(void)
+{
+    printf("soa kernels:\n");
+
+    // known answers; the four elements fit within the scalar tail.
+    float kx[4] = {  3.0f, 0.0f, -6.0f, 10.0f };
+    float ky[4] = {  4.0f, 0.0f,  8.0f,  0.0f };
+    float ka[4], kb[4], kc[4];
+    vec2_soa_length(ka, kx, ky, 4);
+    check(ka[0] == 5.0f && ka[1] == 0.0f && ka[2] == 10.0f && ka[3] == 10.0f, "vec2_soa_length known answer", 0);
+    vec2_soa_distance(ka, kx, ky, 3.0f, 4.0f, 4);
+    check(ka[0] == 0.0f && ka[1] == 5.0f && eq_ulp(ka[2], sqrtf(97.0f), 0) && eq_ulp(ka[3], sqrtf(65.0f), 0), "vec2_soa_distance known answer", 0);
+    memcpy(ka, kx, sizeof(kx)); memcpy(kb, ky, sizeof(ky));
+    vec2_soa_normalize(ka, kb, 4);
+    check(eq_ulp(ka[0], 0.6f, 1) && eq_ulp(kb[0], 0.8f, 1), "vec2_soa_normalize(3, 4) == (0.6, 0.8)", 0);
+    check(ka[1] == 0.0f && kb[1] == 0.0f, "vec2_soa_normalize(0, 0) == (0, 0)", 1);
+    check(eq_ulp(ka[2], -0.6f, 1) && eq_ulp(kb[2], 0.8f, 1), "vec2_soa_normalize(-6, 8) == (-0.6, 0.8)", 2);
+    check(ka[3] == 1.0f && kb[3] == 0.0f, "vec2_soa_normalize(10, 0) == (1, 0)", 3);
+    memcpy(ka, kx, sizeof(kx)); memcpy(kb, ky, sizeof(ky));
+    vec2_soa_scale(ka, kb, -0.5f, 4);
+    check(ka[0] == -1.5f && kb[0] == -2.0f && ka[2] == 3.0f && kb[2] == -4.0f, "vec2_soa_scale known answer", 0);
+    memcpy(ka, kx, sizeof(kx)); memcpy(kb, ky, sizeof(ky));
+    vec2_soa_axpy(ka, kb, ky, kx, 2.0f, 4);
+    check(ka[0] == 11.0f && kb[0] == 10.0f && ka[2] == 10.0f && kb[2] == -4.0f, "vec2_soa_axpy known answer", 0);
+    memcpy(ka, kx, sizeof(kx)); memcpy(kb, ky, sizeof(ky));
+    vec2_soa_clamp_rect(ka, kb, -1.0f, 1.0f, 5.0f, 6.0f, 4);
+    check(ka[0] ==  3.0f && kb[0] == 4.0f && ka[1] == 0.0f && kb[1] == 1.0f, "vec2_soa_clamp_rect known answer", 0);
+    check(ka[2] == -1.0f && kb[2] == 6.0f && ka[3] == 5.0f && kb[3] == 1.0f, "vec2_soa_clamp_rect known answer", 2);
+    // a point at (3, 4) from the center, with softening 11, is pulled with
+    // magnitude 2 * 5 / 36^(3/2) = 10 / 216; the point at the center is not
+    // pulled, and the points beyond the radius are unaffected.
+    memset(ka, 0, sizeof(ka)); memset(kc, 0, sizeof(kc));
+    vec2_soa_radial_force(ka, kc, kx, ky, 6.0f, 8.0f, 2.0f, 8.5f, 11.0f, 4);
+    check(eq_ulp(ka[0], 3.0f * 2.0f / 216.0f, 1) && eq_ulp(kc[0], 4.0f * 2.0f / 216.0f, 1), "vec2_soa_radial_force known answer", 0);
+    check(ka[2] == 0.0f && kc[2] == 0.0f && ka[3] == 0.0f && kc[3] == 0.0f, "vec2_soa_radial_force beyond radius", 2);
+    vec2_soa_radial_force(ka, kc, kx, ky, 3.0f, 4.0f, 2.0f, 8.5f, 11.0f, 1);
+    check(eq_ulp(ka[0], 3.0f * 2.0f / 216.0f, 1) && eq_ulp(kc[0], 4.0f * 2.0f / 216.0f, 1), "vec2_soa_radial_force at center", 0);
+
+    // scalar equivalence over an unaligned array.
+    size_t const n   = TEST_ARRAY_COUNT;
+    float *mem       = (float*) malloc((n * 6 + 1) * sizeof(float));
+    float *x         = mem + 1;
+    float *y         = x + n;
+    float *ax        = y + n;
+    float *ay        = ax + n;
+    float *fx        = ay + n;
+    float *fy        = fx + n;
+    float  cx        = test_random(-10.0f, 10.0f);
+    float  cy        = test_random(-10.0f, 10.0f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = test_random(-100.0f, 100.0f);
+        y[i] = test_random(-100.0f, 100.0f);
+    }
+    x[n / 2] = y[n / 2] = 0.0f; // a zero-length vector within the wide body.
+
+    ulp_check_t axpy, scale, nrm, len, rect, dist, force;
+    // the kernels use IEEE division and square root in every lane, and the
+    // same order of operations as the scalar routines, so they match exactly.
+    ulp_check_init(&axpy,  "vec2_soa_axpy",         0);
+    ulp_check_init(&scale, "vec2_soa_scale",        0);
+    ulp_check_init(&nrm,   "vec2_soa_normalize",    0);
+    ulp_check_init(&len,   "vec2_soa_length",       0);
+    ulp_check_init(&rect,  "vec2_soa_clamp_rect",   0);
+    ulp_check_init(&dist,  "vec2_soa_distance",     0);
+    ulp_check_init(&force, "vec2_soa_radial_force", 0);
+
+    memcpy(ax, x, n * sizeof(float)); memcpy(ay, y, n * sizeof(float));
+    vec2_soa_axpy(ax, ay, y, x, 0.75f, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ulp_check(&axpy, ax[i], x[i] + 0.75f * y[i], i);
+        ulp_check(&axpy, ay[i], y[i] + 0.75f * x[i], i);
+    }
+    memcpy(ax, x, n * sizeof(float)); memcpy(ay, y, n * sizeof(float));
+    vec2_soa_scale(ax, ay, -1.25f, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ulp_check(&scale, ax[i], x[i] * -1.25f, i);
+        ulp_check(&scale, ay[i], y[i] * -1.25f, i);
+    }
+    memcpy(ax, x, n * sizeof(float)); memcpy(ay, y, n * sizeof(float));
+    vec2_soa_normalize(ax, ay, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v[2] = { x[i], y[i] }, r[2] = { 0.0f, 0.0f };
+        if (x[i] != 0.0f || y[i] != 0.0f) vec2_nrm(r, v);
+        ulp_check(&nrm, ax[i], r[0], i);
+        ulp_check(&nrm, ay[i], r[1], i);
+    }
+    vec2_soa_length(ax, x, y, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v[2] = { x[i], y[i] }, l;
+        ulp_check(&len, ax[i], vec2_len(l, v), i);
+    }
+    memcpy(ax, x, n * sizeof(float)); memcpy(ay, y, n * sizeof(float));
+    vec2_soa_clamp_rect(ax, ay, -50.0f, -25.0f, 25.0f, 50.0f, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ulp_check(&rect,  ax[i], clamp(x[i], -50.0f, 25.0f), i);
+        ulp_check(&rect,  ay[i], clamp(y[i], -25.0f, 50.0f), i);
+    }
+    vec2_soa_distance(ax, x, y, cx, cy, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float v[2] = { x[i], y[i] }, c[2] = { cx, cy }, d[2], l;
+        vec2_sub(d, v, c);
+        ulp_check(&dist, ax[i], vec2_len(l, d), i);
+    }
+    memset(fx, 0, n * sizeof(float)); memset(fy, 0, n * sizeof(float));
+    vec2_soa_radial_force(fx, fy, x, y, cx, cy, 500.0f, 80.0f, 1.0f, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        float dx = cx - x[i], dy = cy - y[i];
+        float ds = dx * dx + dy * dy;
+        float sd = ds + 1.0f;
+        float m  = ds < 80.0f * 80.0f ? 500.0f / (sd * sqrtf(sd)) : 0.0f;
+        ulp_check(&force, fx[i], dx * m, i);
+        ulp_check(&force, fy[i], dy * m, i);
+    }
+    ulp_check_report(&axpy);
+    ulp_check_report(&scale);
+    ulp_check_report(&nrm);
+    ulp_check_report(&len);
+    ulp_check_report(&rect);
+    ulp_check_report(&dist);
+    ulp_check_report(&force);
+    free(mem);
+}
+
+/// @summary Checks vec2_soa_direction() against cos(atan2(y, x)) and
+/// sin(atan2(y, x)) computed in double precision, out of place over an
+/// unaligned array and in place, and checks that zero vectors map to (1, 0).
+static void test_soa_direction(void)
+{
+    size_t const n = TEST_ARRAY_COUNT;
+    float *mem     = (float*) malloc((n * 4 + 1) * sizeof(float));
+    float *x       = mem + 1;
+    float *y       = x + n;
+    float *c       = y + n;
+    float *s       = c + n;
+    double max_err = 0.0;
+
+    printf("soa direction:\n");
+    for (size_t i = 0; i < n; ++i)
+    {
+        // cover several orders of magnitude, and both signs of each axis.
+        float scale = i % 3 == 0 ? 1.0e-3f : (i % 3 == 1 ? 1.0f : 1.0e3f);
+        x[i] = test_random(-scale, scale);
+        y[i] = test_random(-scale, scale);
+    }
+    x[0]     = y[0]     = 0.0f;
+    x[n / 2] = y[n / 2] = 0.0f;
+    x[n - 1] = y[n - 1] = 0.0f;
+    x[1] = 0.0f; y[1] = -2.0f;
+    x[2] = -3.0f; y[2] = 0.0f;
+
+    vec2_soa_direction(c, s, x, y, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        double a  = atan2(double(y[i]), double(x[i]));
+        double ec = fabs(c[i] - cos(a));
+        double es = fabs(s[i] - sin(a));
+        if (ec > max_err) max_err = ec;
+        if (es > max_err) max_err = es;
+        check(ec <= 2.5e-7 && es <= 2.5e-7, "vec2_soa_direction == (cos, sin)(atan2(y, x))", i);
+    }
+    check(c[0] == 1.0f && s[0] == 0.0f, "vec2_soa_direction(0, 0) == (1, 0)", 0);
+    check(c[n / 2] == 1.0f && s[n / 2] == 0.0f, "vec2_soa_direction(0, 0) == (1, 0)", n / 2);
+    check(c[n - 1] == 1.0f && s[n - 1] == 0.0f, "vec2_soa_direction(0, 0) == (1, 0)", n - 1);
+    check(c[1] == 0.0f && s[1] == -1.0f, "vec2_soa_direction(0, -2) == (0, -1)", 1);
+    check(c[2] == -1.0f && s[2] == 0.0f, "vec2_soa_direction(-3, 0) == (-1, 0)", 2);
+
+    // in place, the result must match the out-of-place result exactly.
+    vec2_soa_direction(x, y, x, y, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        check(c[i] == x[i] && s[i] == y[i], "vec2_soa_direction in place", i);
+    }
+    printf("  %-30s max abs error %g\n", "vec2_soa_direction", max_err);
+    free(mem);
+}
+
+/// @summary Signature of a benchmark body, which performs the specified
+/// number of calls to the routine being timed.
+typedef void (*bench_fn)(size_t iterations);
+
+/// @summary Times a benchmark and prints the cost per call.
+/// @param name The name of the routine being timed.
+/// @param func The benchmark body.
+/// @param iterations The number of calls to time.
+/// @return The cost of one call, in nanoseconds.
+static double bench(char const *name, bench_fn func, size_t iterations)
+{
+    func(iterations / 16); // warm up caches and the branch predictor.
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    func(iterations);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / double(iterations);
+    printf("  %-36s %8.2f ns/call\n", name, ns);
+    return ns;
+}
+
+static void bench_vec4_dot(size_t iterations)
+{
+    float s = 0.0f;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        float d;
+        s += vec4_dot(d, gBenchA[i & (BENCH_INPUTS-1)], gBenchB[i & (BENCH_INPUTS-1)]);
+    }
+    gBenchSum += s;
+}
+
+static void bench_vec4_nrm(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        vec4_nrm(gBenchOut, gBenchA[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_quat_mul(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        quat_mul(gBenchOut, gBenchA[i & (BENCH_INPUTS-1)], gBenchB[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_quat_slerp(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        quat_slerp(gBenchOut, gBenchB[i & (BENCH_INPUTS-1)], gBenchB[(i + 1) & (BENCH_INPUTS-1)], 0.25f);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_mat4_concat(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        mat4_concat(gBenchOut, gBenchA[i & (BENCH_INPUTS-1)], gBenchB[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_mat4_transpose(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        mat4_transpose(gBenchOut, gBenchA[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[1];
+    }
+}
+
+static void bench_mat4_inv_affine(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        mat4_inv_affine(gBenchOut, gBenchA[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_mat4_transform_vec4(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        mat4_transform_vec4(gBenchOut, gBenchB[i & (BENCH_INPUTS-1)], gBenchA[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+static void bench_mat4_transform_array_point(size_t iterations)
+{
+    // reports the cost per point; each call transforms the whole array.
+    size_t const count = BENCH_INPUTS * 16 / 3;
+    size_t const calls = iterations / count;
+    static float dst[BENCH_INPUTS * 16];
+    for (size_t i = 0; i < calls; ++i)
+    {
+        mat4_transform_array_point(dst, &gBenchB[0][0], gBenchA[i & (BENCH_INPUTS-1)], count);
+        gBenchSum += dst[0];
+    }
+}
+
+/// @summary Benchmark body for a routine with the signature of vec4_dot.
+template <float (*F)(float&, float const*, float const*)>
+static void bench_dot(size_t iterations)
+{
+    float s = 0.0f;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        float d;
+        s += F(d, gBenchA[i & (BENCH_INPUTS-1)], gBenchB[i & (BENCH_INPUTS-1)]);
+    }
+    gBenchSum += s;
+}
+
+/// @summary Benchmark body for a routine of the form dst = f(src).
+template <float* (*F)(float*, float const*)>
+static void bench_unary(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        F(gBenchOut, gBenchB[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[1];
+    }
+}
+
+/// @summary Benchmark body for a routine of the form dst = f(a, b).
+template <float* (*F)(float*, float const*, float const*)>
+static void bench_binary(size_t iterations)
+{
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        F(gBenchOut, gBenchB[i & (BENCH_INPUTS-1)], gBenchA[i & (BENCH_INPUTS-1)]);
+        gBenchSum += gBenchOut[0];
+    }
+}
+
+/// @summary Times the former and current forms of a routine and prints both,
+/// with the speedup of the current form.
+/// @param name The name of the routine being timed.
+/// @param before_func The benchmark body calling the former routine.
+/// @param after_func The benchmark body calling the current routine.
+static void bench_pair(char const *name, bench_fn before_func, bench_fn after_func)
+{
+    char   label[64];
+    snprintf(label, sizeof(label), "%s (before)", name);
+    double before = bench(label, before_func, BENCH_ITERATIONS);
+    snprintf(label, sizeof(label), "%s (after)", name);
+    double after  = bench(label, after_func , BENCH_ITERATIONS);
+    printf("  %-36s %8.2fx\n", "  speedup", before / after);
+}
+
+/// @summary Reports the per-call cost of the hot vector, quaternion and
+/// matrix routines.
+static void run_benchmarks(void)
+{
+    for (size_t i = 0; i < BENCH_INPUTS; ++i)
+    {
+        test_random_affine(gBenchA[i]);
+        test_random_quat(gBenchB[i]);
+        // the first four elements of each B input are a unit quaternion.
+        for (size_t j = 4; j < 16; ++j)
+            gBenchB[i][j] = test_random(-1.0f, 1.0f);
+    }
+
+    printf("timings (%s):\n", TEST_BACKEND_NAME);
+    bench("vec4_dot",                   bench_vec4_dot,                   BENCH_ITERATIONS);
+    bench("vec4_nrm",                   bench_vec4_nrm,                   BENCH_ITERATIONS);
+    bench("quat_mul",                   bench_quat_mul,                   BENCH_ITERATIONS);
+    bench("quat_slerp",                 bench_quat_slerp,                 BENCH_ITERATIONS);
+    bench("mat4_concat",                bench_mat4_concat,                BENCH_ITERATIONS);
+    bench("mat4_transpose",             bench_mat4_transpose,             BENCH_ITERATIONS);
+    bench("mat4_inv_affine",            bench_mat4_inv_affine,            BENCH_ITERATIONS);
+    bench("mat4_transform_vec4",        bench_mat4_transform_vec4,        BENCH_ITERATIONS);
+    bench("mat4_transform_array_point/point", bench_mat4_transform_array_point, BENCH_ITERATIONS * 4);
+
+    printf("out-of-line scalar (before) vs inline (after), %s:\n", TEST_BACKEND_NAME);
+    bench_pair("vec4_dot"           , bench_dot   <before_vec4_dot>           , bench_dot   <vec4_dot>);
+    bench_pair("vec4_add"           , bench_binary<before_vec4_add>           , bench_binary<vec4_add>);
+    bench_pair("vec4_cross"         , bench_binary<before_vec4_cross>         , bench_binary<vec4_cross>);
+    bench_pair("vec4_nrm"           , bench_unary <before_vec4_nrm>           , bench_unary <vec4_nrm>);
+    bench_pair("quat_mul"           , bench_binary<before_quat_mul>           , bench_binary<quat_mul>);
+    bench_pair("quat_conj"          , bench_unary <before_quat_conj>          , bench_unary <quat_conj>);
+    bench_pair("mat4_concat"        , bench_binary<before_mat4_concat>        , bench_binary<mat4_concat>);
+    bench_pair("mat4_transform_vec4", bench_binary<before_mat4_transform_vec4>, bench_binary<mat4_transform_vec4>);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    printf("math_test (%s)\n", TEST_BACKEND_NAME);
+    test_ulp_distance();
+    test_reference();
+    test_properties();
+    test_quaternions();
+    test_matrices();
+    test_array_transforms();
+    test_soa_kernels();
+    test_soa_direction();
+    run_benchmarks();
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "math_test (%s): %zu check(s) FAILED.\n", TEST_BACKEND_NAME, gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("math_test (%s): all checks passed. (checksum %g)\n", TEST_BACKEND_NAME, gBenchSum);
+    return EXIT_SUCCESS;
+}
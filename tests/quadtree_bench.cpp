@@ -0,0 +1,303 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a benchmark comparing the loose quadtree against the
+/// flat spatial grid. Items are scattered uniformly and in four dense
+/// clusters, with mostly small and a few large radii. For each distribution
+/// the build, move, circle and nearest-neighbor costs are reported, and the
+/// circle, rectangle and nearest-neighbor results are checked against a
+/// brute-force scan. Build and run with `make bench`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "ll_quadtree.hpp"
+#include "ll_spatial.hpp"
+#include "math_rng.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of items indexed.
+#define BENCH_ITEMS                  (100000U)
+
+/// @summary The width and height of the indexed region, in pixels.
+#define BENCH_WORLD_SIZE             (2048.0f)
+
+/// @summary The depth of the quadtree.
+#define BENCH_TREE_DEPTH             (7U)
+
+/// @summary The cell size of the spatial grid, in pixels.
+#define BENCH_GRID_CELL              (24.0f)
+
+/// @summary The number of timed queries of each kind.
+#define BENCH_QUERIES                (10000U)
+
+/// @summary The number of times each build is repeated.
+#define BENCH_BUILDS                 (10U)
+
+/// @summary The number of queries of each kind checked against brute force.
+#define CHECK_CIRCLE_QUERIES         (200U)
+#define CHECK_NEAREST_QUERIES        (100U)
+#define CHECK_RECT_QUERIES           (50U)
+
+/// @summary The number of neighbors found by each nearest-neighbor query.
+#define NEAREST_K                    (8U)
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of brute-force checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Retrieves the time elapsed since a given point, in milliseconds.
+/// @param t0 The start of the interval.
+/// @return The number of milliseconds since t0.
+static double elapsed_ms(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/// @summary Counts the grid items overlapping a circle, the way the enemy
+/// queries walk the grid.
+/// @param grid The grid to query.
+/// @param x The x-coordinate of the circle center.
+/// @param y The y-coordinate of the circle center.
+/// @param r The circle radius.
+/// @return The number of overlapping items.
+static size_t grid_query_circle(spatial_grid_t const *grid, float x, float y, float r)
+{
+    float  reach = r + grid->MaxRadius;
+    size_t c0    = spatial_grid_column(grid, x - reach);
+    size_t c1    = spatial_grid_column(grid, x + reach);
+    size_t r0    = spatial_grid_row(grid, y - reach);
+    size_t r1    = spatial_grid_row(grid, y + reach);
+    size_t n     = 0;
+    for (size_t row = r0; row <= r1; ++row)
+    {
+        size_t begin, end;
+        spatial_grid_run(grid, row, c0, c1, begin, end);
+        for (size_t k = begin; k < end; ++k)
+        {
+            float dx = grid->SortedX[k] - x;
+            float dy = grid->SortedY[k] - y;
+            float rr = r + grid->SortedR[k];
+            if (dx * dx + dy * dy <= rr * rr) n++;
+        }
+    }
+    return n;
+}
+
+/// @summary Generates the item positions and radii for one distribution.
+/// 99% of items have a radius in [4, 12) and 1% in [30, 90).
+/// @param clustered true to place 90% of items in four gaussian clusters.
+/// @param x The BENCH_ITEMS x-coordinates to overwrite.
+/// @param y The BENCH_ITEMS y-coordinates to overwrite.
+/// @param r The BENCH_ITEMS radii to overwrite.
+/// @param rng The generator to draw from.
+static void generate(bool clustered, std::vector<float> &x, std::vector<float> &y, std::vector<float> &r, rng8_state_t *rng)
+{
+    std::vector<float> u(BENCH_ITEMS * 4);
+    random8_fill_uniform(&u[0], u.size(), 0.0f, 1.0f, rng);
+    for (size_t i = 0; i < BENCH_ITEMS; ++i)
+    {
+        float u0 = u[i];
+        float u1 = u[i + BENCH_ITEMS * 1];
+        float u2 = u[i + BENCH_ITEMS * 2];
+        float u3 = u[i + BENCH_ITEMS * 3];
+        if (!clustered || i % 10 == 0)
+        {
+            x[i] = u0 * BENCH_WORLD_SIZE;
+            y[i] = u1 * BENCH_WORLD_SIZE;
+        }
+        else
+        {
+            size_t c  = i % 4;
+            float  cx = 300.0f + c * 450.0f;
+            float  cy = 500.0f + (c & 1) * 900.0f;
+            float  a  = u0 * 6.2831853f;
+            float  d  = 40.0f * sqrtf(-2.0f * logf(u1 + 1e-7f));
+            x[i] = cx + d * cosf(a);
+            y[i] = cy + d * sinf(a);
+        }
+        r[i] = (u2 < 0.99f) ? 4.0f + u3 * 8.0f : 30.0f + u3 * 60.0f;
+    }
+}
+
+/// @summary Checks circle, rectangle and nearest-neighbor queries against a
+/// brute-force scan of every item.
+/// @param tree The tree built over the items.
+/// @param x The x-coordinate of each item.
+/// @param y The y-coordinate of each item.
+/// @param r The radius of each item.
+/// @param rng The generator used for the query positions.
+static void check_queries(quadtree_t const *tree, std::vector<float> const &x, std::vector<float> const &y, std::vector<float> const &r, rng8_state_t *rng)
+{
+    std::vector<uint32_t> items(BENCH_ITEMS);
+    std::vector<float>    dist(BENCH_ITEMS);
+    float                 u[2 * CHECK_NEAREST_QUERIES];
+    size_t                circle_errors  = 0;
+    size_t                rect_errors    = 0;
+    size_t                nearest_errors = 0;
+
+    for (size_t q = 0; q < CHECK_CIRCLE_QUERIES; ++q)
+    {
+        size_t i = (q * 7919) % BENCH_ITEMS;
+        size_t n = quadtree_query_circle(tree, x[i], y[i], BENCH_GRID_CELL, &items[0], BENCH_ITEMS);
+        size_t b = 0;
+        for (size_t j = 0; j < BENCH_ITEMS; ++j)
+        {
+            float dx = x[j] - x[i];
+            float dy = y[j] - y[i];
+            float rr = BENCH_GRID_CELL + r[j];
+            if (dx * dx + dy * dy <= rr * rr) b++;
+        }
+        if (n != b) circle_errors++;
+    }
+
+    random8_fill_uniform(u, 2 * CHECK_NEAREST_QUERIES, 0.0f, BENCH_WORLD_SIZE, rng);
+    for (size_t q = 0; q < CHECK_RECT_QUERIES; ++q)
+    {
+        float  x0 = u[q * 2 + 0];
+        float  y0 = u[q * 2 + 1];
+        float  x1 = x0 + 100.0f;
+        float  y1 = y0 + 60.0f;
+        size_t n  = quadtree_query_rect(tree, x0, y0, x1, y1, &items[0], BENCH_ITEMS);
+        size_t b  = 0;
+        for (size_t j = 0; j < BENCH_ITEMS; ++j)
+        {
+            float cx = std::min(std::max(x[j], x0), x1) - x[j];
+            float cy = std::min(std::max(y[j], y0), y1) - y[j];
+            if (cx * cx + cy * cy <= r[j] * r[j]) b++;
+        }
+        if (n != b) rect_errors++;
+    }
+
+    for (size_t q = 0; q < CHECK_NEAREST_QUERIES; ++q)
+    {
+        uint32_t nearest[NEAREST_K];
+        float    nearest_dist[NEAREST_K];
+        float    px = u[q * 2 + 0];
+        float    py = u[q * 2 + 1];
+        size_t   n  = quadtree_nearest(tree, px, py, NEAREST_K, 1e9f, nearest, nearest_dist);
+        for (size_t j = 0; j < BENCH_ITEMS; ++j)
+        {
+            dist[j] = (x[j] - px) * (x[j] - px) + (y[j] - py) * (y[j] - py);
+        }
+        std::nth_element(dist.begin(), dist.begin() + (NEAREST_K - 1), dist.end());
+        if (n != NEAREST_K || nearest_dist[NEAREST_K - 1] != dist[NEAREST_K - 1]) nearest_errors++;
+    }
+
+    printf("  brute-force mismatches: circle %zu, rect %zu, %u-NN %zu\n", circle_errors, rect_errors, NEAREST_K, nearest_errors);
+    gFailures += circle_errors + rect_errors + nearest_errors;
+}
+
+/// @summary Times the quadtree and the grid over one distribution.
+/// @param name The name of the distribution.
+/// @param clustered true to place most items in dense clusters.
+/// @param rng The generator used for the items.
+static void bench_distribution(char const *name, bool clustered, rng8_state_t *rng)
+{
+    std::vector<float>    x(BENCH_ITEMS), y(BENCH_ITEMS), r(BENCH_ITEMS);
+    std::vector<uint32_t> items(BENCH_ITEMS);
+    quadtree_t            tree;
+    spatial_grid_t        grid;
+    generate(clustered, x, y, r, rng);
+    quadtree_create(&tree, 0.0f, 0.0f, BENCH_WORLD_SIZE, BENCH_TREE_DEPTH, BENCH_ITEMS);
+    spatial_grid_create(&grid, 0.0f, 0.0f, BENCH_WORLD_SIZE, BENCH_WORLD_SIZE, BENCH_GRID_CELL, BENCH_ITEMS);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < BENCH_BUILDS; ++k)
+        quadtree_build(&tree, &x[0], &y[0], &r[0], BENCH_ITEMS);
+    double tree_build = elapsed_ms(t0) / BENCH_BUILDS;
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t k = 0; k < BENCH_BUILDS; ++k)
+        spatial_grid_build(&grid, &x[0], &y[0], &r[0], BENCH_ITEMS);
+    double grid_build = elapsed_ms(t0) / BENCH_BUILDS;
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_ITEMS; ++i)
+        quadtree_update(&tree, uint32_t(i), x[i] + 0.7f, y[i] - 0.4f, r[i]);
+    double tree_move = elapsed_ms(t0);
+    quadtree_build(&tree, &x[0], &y[0], &r[0], BENCH_ITEMS);
+
+    size_t densest = 0;
+    for (size_t c = 0; c < grid.CellsX * grid.CellsY; ++c)
+        densest = std::max<size_t>(densest, grid.CellStart[c + 1] - grid.CellStart[c]);
+
+    printf("%s (densest grid cell holds %zu items):\n", name, densest);
+    printf("  build: quadtree %.2f ms, grid %.2f ms; moving every item %.2f ms\n", tree_build, grid_build, tree_move);
+
+    float const radii[2] = { 4.0f, BENCH_GRID_CELL };
+    for (size_t k = 0; k < 2; ++k)
+    {
+        size_t tree_hits = 0;
+        size_t grid_hits = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < BENCH_QUERIES; ++q)
+        {
+            size_t i = (q * 7919) % BENCH_ITEMS;
+            tree_hits += quadtree_query_circle(&tree, x[i], y[i], radii[k], &items[0], BENCH_ITEMS);
+        }
+        double tree_query = elapsed_ms(t0);
+        t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < BENCH_QUERIES; ++q)
+        {
+            size_t i = (q * 7919) % BENCH_ITEMS;
+            grid_hits += grid_query_circle(&grid, x[i], y[i], radii[k]);
+        }
+        double grid_query = elapsed_ms(t0);
+        printf("  circle r=%2.0f: quadtree %.2f us, grid %.2f us per query\n", radii[k], tree_query * 1000.0 / BENCH_QUERIES, grid_query * 1000.0 / BENCH_QUERIES);
+        if (tree_hits != grid_hits)
+        {
+            printf("  circle r=%2.0f: quadtree found %zu hits, grid %zu\n", radii[k], tree_hits, grid_hits);
+            gFailures++;
+        }
+    }
+
+    uint32_t nearest[NEAREST_K];
+    float    nearest_dist[NEAREST_K];
+    t0 = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < BENCH_QUERIES; ++q)
+    {
+        size_t i = (q * 7919) % BENCH_ITEMS;
+        quadtree_nearest(&tree, x[i], y[i], NEAREST_K, 1e9f, nearest, nearest_dist);
+    }
+    printf("  %u-NN: quadtree %.2f us per query\n", NEAREST_K, elapsed_ms(t0) * 1000.0 / BENCH_QUERIES);
+
+    check_queries(&tree, x, y, r, rng);
+    quadtree_delete(&tree);
+    spatial_grid_delete(&grid);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    rng8_state_t rng;
+    random8_seed(&rng, 11);
+    printf("quadtree_bench, %u items, depth %u over %.0f px, against a %.0f px grid:\n", BENCH_ITEMS, BENCH_TREE_DEPTH, BENCH_WORLD_SIZE, BENCH_GRID_CELL);
+    bench_distribution("uniform"  , false, &rng);
+    bench_distribution("clustered", true , &rng);
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "quadtree_bench: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
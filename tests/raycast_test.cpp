@@ -0,0 +1,298 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the grid ray cast against a brute-force cast
+/// that tests every circle. Random rays, rays along the grid axes and rays
+/// through cell corners are cast into scenes of small and large circles, for
+/// the first hit, the first few hits and every hit, and must find the same
+/// circles at the same distances. A batch cast split across the task pool
+/// must match the single-ray casts exactly. Build and run with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "math_rng.hpp"
+#include "ll_task.hpp"
+#include "raycast.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The size of the grid region, in world units.
+#define TEST_WORLD_WIDTH           (1024.0f)
+#define TEST_WORLD_HEIGHT          (768.0f)
+
+/// @summary The edge length of a grid cell.
+#define TEST_CELL_SIZE             (32.0f)
+
+/// @summary The number of random rays cast in each scene.
+#define TEST_RANDOM_RAYS           (3000U)
+
+/// @summary The largest number of hits requested, enough for every hit.
+#define TEST_ALL_HITS              (256U)
+
+/// @summary The absolute tolerance on a hit distance, to which the rounding
+/// error of the single precision chord computation is added.
+#define TEST_DISTANCE_EPSILON      (1.0e-3)
+
+/// @summary Rays passing this close to the edge of a circle, or ending this
+/// close to it, are left out, since rounding decides whether they hit.
+#define TEST_GRAZE_EPSILON         (1.0e-2)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary An intersection found by the brute-force cast.
+struct brute_hit_t
+{
+    double   Distance;          /// The distance along the ray to the intersection.
+    double   Tolerance;         /// The error allowed in the distance.
+    uint32_t Item;              /// The index of the circle.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param ray The index of the ray being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, size_t ray)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (ray %zu)\n", name, ray);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Orders brute-force hits by distance.
+static bool nearer(brute_hit_t const &a, brute_hit_t const &b)
+{
+    return a.Distance < b.Distance;
+}
+
+/// @summary Casts a ray against every circle in double precision.
+/// @param x The x-coordinate of each circle.
+/// @param y The y-coordinate of each circle.
+/// @param r The radius of each circle.
+/// @param count The number of circles.
+/// @param ray The ray to cast.
+/// @param hits On return, every intersection, nearest first.
+/// @return false if the ray grazes a circle or ends at its edge, so that
+/// whether it hits is decided by rounding.
+static bool brute_cast(float const *x, float const *y, float const *r, size_t count, ray_t const &ray, std::vector<brute_hit_t> &hits)
+{
+    bool clear = true;
+    hits.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        double rx = double(x[i]) - ray.OriginX;
+        double ry = double(y[i]) - ray.OriginY;
+        double tc = rx * ray.DirX + ry * ray.DirY;
+        double ds = rx * rx + ry * ry - tc * tc;
+        double rr = double(r[i]) * r[i];
+        if (fabs(sqrt(ds) - r[i]) < TEST_GRAZE_EPSILON)
+        {
+            clear = false;
+            continue;
+        }
+        if (ds > rr)
+            continue;
+
+        double h  = sqrt(rr - ds);
+        double tn = tc - h;
+        double tf = tc + h;
+        if (fabs(tn - ray.Length) < TEST_GRAZE_EPSILON || fabs(tf) < TEST_GRAZE_EPSILON)
+        {
+            clear = false;
+            continue;
+        }
+        if (tf >= 0.0 && tn <= ray.Length)
+        {
+            // the grid cast computes r^2 + tc^2 - |c - o|^2 in single
+            // precision, which loses the low bits of the squares.
+            double      err = 4.0 * FLT_EPSILON * (rr + tc * tc + rx * rx + ry * ry) / (2.0 * h);
+            brute_hit_t hit = { tn > 0.0 ? tn : 0.0, TEST_DISTANCE_EPSILON + err, uint32_t(i) };
+            hits.push_back(hit);
+        }
+    }
+    std::sort(hits.begin(), hits.end(), nearer);
+    return clear;
+}
+
+/// @summary Builds a ray from an origin, a direction and a length.
+/// @param x The x-coordinate of the origin.
+/// @param y The y-coordinate of the origin.
+/// @param dx The x-component of the direction, not necessarily unit length.
+/// @param dy The y-component of the direction, not necessarily unit length.
+/// @param length The length of the ray.
+/// @return The ray.
+static ray_t make_ray(float x, float y, float dx, float dy, float length)
+{
+    float inv = 1.0f / sqrtf(dx * dx + dy * dy);
+    ray_t ray = { x, y, dx * inv, dy * inv, length };
+    return ray;
+}
+
+/// @summary Compares the hits of the grid cast with the brute-force hits.
+/// Distances are compared by rank, so circles at the same distance may be
+/// returned in either order, and each returned circle must really be hit at
+/// the distance reported.
+/// @param hits The hits of the grid cast.
+/// @param n The number of hits of the grid cast.
+/// @param max_hits The number of hits requested.
+/// @param expect The brute-force hits, nearest first.
+/// @param dist The brute-force hit of each circle, or NULL if it is missed.
+/// @param index The index of the ray.
+/// @return true if the hits match.
+static bool compare_hits(ray_hit_t const *hits, size_t n, size_t max_hits, std::vector<brute_hit_t> const &expect, std::vector<brute_hit_t const*> const &dist, size_t index)
+{
+    size_t want = expect.size() < max_hits ? expect.size() : max_hits;
+    bool   ok   = check(n == want, "the grid cast finds as many hits as brute force", index);
+    for (size_t k = 0; ok && k < n; ++k)
+    {
+        brute_hit_t const *t = dist[hits[k].Item];
+        ok = check(t != NULL && fabs(hits[k].Distance - t->Distance) <= t->Tolerance, "each hit circle is really hit at that distance", index) &&
+             check(fabs(hits[k].Distance - expect[k].Distance) <= t->Tolerance + expect[k].Tolerance, "the k-th hit is at the brute-force distance", index) &&
+             check(k == 0 || hits[k].Distance >= hits[k - 1].Distance, "hits are sorted nearest first", index);
+    }
+    return ok;
+}
+
+/// @summary Casts a set of rays into a scene of random circles with the grid
+/// and by brute force, and compares the results.
+/// @param name The name of the scene.
+/// @param circles The number of circles.
+/// @param min_radius The smallest circle radius.
+/// @param max_radius The largest circle radius.
+/// @param pool The task pool used for the batch cast.
+/// @param rng The random number generator.
+static void test_scene(char const *name, size_t circles, float min_radius, float max_radius, task_pool_t *pool, rng8_state_t *rng)
+{
+    std::vector<float> x(circles), y(circles), r(circles);
+    random8_fill_uniform(&r[0], circles, min_radius, max_radius, rng);
+    random8_fill_uniform(&x[0], circles, 0.0f, 1.0f, rng);
+    random8_fill_uniform(&y[0], circles, 0.0f, 1.0f, rng);
+    for (size_t i = 0; i < circles; ++i)
+    {
+        // keep every circle inside of the grid region.
+        x[i] = r[i] + x[i] * (TEST_WORLD_WIDTH  - 2.0f * r[i]);
+        y[i] = r[i] + y[i] * (TEST_WORLD_HEIGHT - 2.0f * r[i]);
+    }
+    spatial_grid_t grid;
+    spatial_grid_create(&grid, 0.0f, 0.0f, TEST_WORLD_WIDTH, TEST_WORLD_HEIGHT, TEST_CELL_SIZE, circles);
+    spatial_grid_build(&grid, &x[0], &y[0], &r[0], circles);
+
+    // random rays, some starting outside of the grid, then rays along each
+    // axis and rays through cell corners at 45 degrees.
+    std::vector<ray_t> rays;
+    std::vector<float> params(TEST_RANDOM_RAYS * 4);
+    random8_fill_uniform(&params[0], params.size(), 0.0f, 1.0f, rng);
+    for (size_t i = 0; i < TEST_RANDOM_RAYS; ++i)
+    {
+        float const *p     = &params[i * 4];
+        float        angle = p[2] * 6.2831853f;
+        float        ox    = -64.0f + p[0] * (TEST_WORLD_WIDTH  + 128.0f);
+        float        oy    = -64.0f + p[1] * (TEST_WORLD_HEIGHT + 128.0f);
+        rays.push_back(make_ray(ox, oy, cosf(angle), sinf(angle), p[3] * 1500.0f));
+    }
+    for (size_t i = 0; i < 24; ++i)
+    {
+        float c = (float(i) + 0.5f) * TEST_CELL_SIZE;
+        rays.push_back(make_ray(0.0f, c, 1.0f, 0.0f, TEST_WORLD_WIDTH));
+        rays.push_back(make_ray(TEST_WORLD_WIDTH, c, -1.0f, 0.0f, TEST_WORLD_WIDTH));
+        rays.push_back(make_ray(c, 0.0f, 0.0f, 1.0f, TEST_WORLD_HEIGHT));
+        rays.push_back(make_ray(c, TEST_WORLD_HEIGHT, 0.0f, -1.0f, TEST_WORLD_HEIGHT));
+        rays.push_back(make_ray(float(i) * TEST_CELL_SIZE, 0.0f,  1.0f, 1.0f, 2000.0f));
+        rays.push_back(make_ray(float(i) * TEST_CELL_SIZE, TEST_WORLD_HEIGHT, 1.0f, -1.0f, 2000.0f));
+    }
+
+    size_t const                    max_hits[3] = { 1, 4, TEST_ALL_HITS };
+    std::vector<brute_hit_t>        expect;
+    std::vector<brute_hit_t const*> dist(circles);
+    std::vector<ray_hit_t>          hits(TEST_ALL_HITS);
+    size_t                          tested = 0;
+    size_t                          found  = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        if (!brute_cast(&x[0], &y[0], &r[0], circles, rays[i], expect))
+            continue;
+
+        std::fill(dist.begin(), dist.end(), (brute_hit_t const*) NULL);
+        for (size_t k = 0; k < expect.size(); ++k)
+        {
+            dist[expect[k].Item] = &expect[k];
+        }
+        check(expect.size() <= TEST_ALL_HITS, "the scene has few enough hits per ray", i);
+        for (size_t m = 0; m < 3; ++m)
+        {
+            size_t n = raycast(&grid, rays[i], max_hits[m], &hits[0]);
+            compare_hits(&hits[0], n, max_hits[m], expect, dist, i);
+        }
+        tested++;
+        found += expect.size();
+    }
+
+    // a batch split across the pool matches the single-ray casts exactly.
+    size_t const           batch_hits = 4;
+    std::vector<ray_hit_t> batch(rays.size() * batch_hits);
+    std::vector<size_t>    counts(rays.size());
+    size_t                 differ = 0;
+    raycast_batch(&grid, &rays[0], rays.size(), batch_hits, &batch[0], &counts[0], pool);
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        size_t n = raycast(&grid, rays[i], batch_hits, &hits[0]);
+        bool   same = (n == counts[i]);
+        for (size_t k = 0; same && k < n; ++k)
+        {
+            ray_hit_t const &b = batch[i * batch_hits + k];
+            same = b.Item == hits[k].Item && b.Distance == hits[k].Distance;
+        }
+        if (!same) differ++;
+    }
+    check(differ == 0, "the batch cast matches the single-ray casts", differ);
+    printf("  %-6s %5zu circles, r %4.1f-%4.1f: %zu rays compared, %zu hits, %zu skipped as grazing\n",
+        name, circles, min_radius, max_radius, tested, found, rays.size() - tested);
+    spatial_grid_delete(&grid);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    task_pool_t  *pool = task_pool_create(3);
+    rng8_state_t  rng;
+    random8_seed(&rng, 62);
+    printf("raycast_test, %.0fx%.0f grid of %.0f unit cells:\n", TEST_WORLD_WIDTH, TEST_WORLD_HEIGHT, TEST_CELL_SIZE);
+    test_scene("sparse", 200, 2.0f, 20.0f, pool, &rng);
+    test_scene("dense", 3000, 2.0f, 12.0f, pool, &rng);
+    test_scene("large", 150, 20.0f, RAYCAST_MAX_REACH * TEST_CELL_SIZE * 0.5f, pool, &rng);
+    task_pool_delete(pool);
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "raycast_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("raycast_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,437 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements correctness, statistical and throughput tests for the
+/// eight-lane xoshiro128++ generator. Each lane is checked against the
+/// reference scalar xoshiro128++ and jump implementations, derived streams
+/// are checked for overlap, the uniform fill is checked with a chi-square
+/// test, and throughput is compared against the WELL512 generator. Build and
+/// run with `make test-math`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "math.hpp"
+#include "math_rng.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of outputs per lane compared against the reference.
+#define KAT_STEPS                  (4096U)
+
+/// @summary The number of streams checked for overlap, and the number of
+/// steps of each lane whose states are compared.
+#define OVERLAP_STREAMS            (4U)
+#define OVERLAP_STEPS              (1U << 16)
+
+/// @summary The number of samples and bins for the chi-square test. The
+/// critical value is the 99.9th percentile of chi-square with 255 degrees of
+/// freedom, so a correct generator fails about one run in a thousand; the
+/// seeds are fixed, so the test is deterministic.
+#define CHI_SQUARE_SAMPLES         (1U << 22)
+#define CHI_SQUARE_BINS            (256U)
+#define CHI_SQUARE_CRITICAL        (330.52)
+
+/// @summary The number of values generated by each throughput benchmark.
+#define BENCH_COUNT                (1U << 12)
+#define BENCH_PASSES               (2000U)
+
+/// @summary A label for the generator backend this test was compiled against.
+#if defined(__AVX2__)
+    #define TEST_BACKEND_NAME      "AVX2"
+#elif GW_MATH_SSE
+    #define TEST_BACKEND_NAME      "SIMD"
+#else
+    #define TEST_BACKEND_NAME      "scalar"
+#endif
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t   gFailures = 0;
+
+/// @summary Accumulates benchmark output so the timed work can't be discarded.
+static uint32_t gBenchSum = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @return The value of passed.
+static bool check(bool passed, char const *name)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s\n", name);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary The reference xoshiro128++ rotate, from xoshiro128plusplus.c by
+/// David Blackman and Sebastiano Vigna.
+static inline uint32_t ref_rotl(uint32_t const x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+/// @summary The reference xoshiro128++ next().
+/// @param s The four state words, updated on return.
+/// @return The next output.
+static uint32_t ref_next(uint32_t s[4])
+{
+    uint32_t const result = ref_rotl(s[0] + s[3], 7) + s[0];
+    uint32_t const t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ref_rotl(s[3], 11);
+    return result;
+}
+
+/// @summary The reference xoshiro128++ jump(), equivalent to 2^64 calls to next().
+/// @param s The four state words, updated on return.
+static void ref_jump(uint32_t s[4])
+{
+    static uint32_t const JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    uint32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t i = 0; i < sizeof(JUMP) / sizeof(*JUMP); ++i)
+    {
+        for (int b = 0; b < 32; ++b)
+        {
+            if (JUMP[i] & UINT32_C(1) << b)
+            {
+                s0 ^= s[0];
+                s1 ^= s[1];
+                s2 ^= s[2];
+                s3 ^= s[3];
+            }
+            ref_next(s);
+        }
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+}
+
+/// @summary The reference SplitMix64 next(), used to expand the seed.
+/// @param x The SplitMix64 state, updated on return.
+/// @return The next output.
+static uint64_t ref_splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/// @summary Copies one lane of a multi-lane generator into a scalar state.
+/// @param dst The four state words to populate.
+/// @param rng The multi-lane generator.
+/// @param lane The zero-based lane index.
+static void get_lane(uint32_t dst[4], rng8_state_t const *rng, size_t lane)
+{
+    for (size_t w = 0; w < 4; ++w)
+        dst[w] = rng->s[w][lane];
+}
+
+/// @summary Checks the generator against the reference implementation: the
+/// first outputs for a fixed state, the seed expansion, the lane spacing and
+/// the output of every lane.
+static void test_known_answers(void)
+{
+    size_t failures = gFailures;
+    printf("known answers:\n");
+
+    // the first outputs of the reference generator from state { 1, 2, 3, 4 }.
+    static uint32_t const EXPECTED[8] = {
+        0x00000281U, 0x00180387U, 0xC0183387U, 0xD1AE3B02U,
+        0x31E2310AU, 0xFD275AB0U, 0xE67F7CECU, 0x50D07F0FU
+    };
+    rng8_state_t rng;
+    uint32_t     out[RANDOM8_LANES];
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        rng.s[0][i] = 1; rng.s[1][i] = 2; rng.s[2][i] = 3; rng.s[3][i] = 4;
+    }
+    for (size_t n = 0; n < 8; ++n)
+    {
+        random8_fill_bits(out, RANDOM8_LANES, &rng);
+        for (size_t i = 0; i < RANDOM8_LANES; ++i)
+            check(out[i] == EXPECTED[n], "random8 matches xoshiro128++ from state {1, 2, 3, 4}");
+    }
+
+    // lane zero is seeded from SplitMix64, and lane i is lane zero jumped i times.
+    uint64_t const seeds[3] = { 0, 12345, 0xDEADBEEFCAFEF00DULL };
+    for (size_t k = 0; k < 3; ++k)
+    {
+        uint64_t x = seeds[k];
+        uint64_t a = ref_splitmix64(x);
+        uint64_t b = ref_splitmix64(x);
+        uint32_t ref[RANDOM8_LANES][4];
+        ref[0][0]  = uint32_t(a); ref[0][1] = uint32_t(a >> 32);
+        ref[0][2]  = uint32_t(b); ref[0][3] = uint32_t(b >> 32);
+        for (size_t i = 1; i < RANDOM8_LANES; ++i)
+        {
+            memcpy(ref[i], ref[i-1], sizeof(ref[i]));
+            ref_jump(ref[i]);
+        }
+
+        random8_seed(&rng, seeds[k]);
+        for (size_t i = 0; i < RANDOM8_LANES; ++i)
+        {
+            uint32_t s[4];
+            get_lane(s, &rng, i);
+            check(memcmp(s, ref[i], sizeof(s)) == 0, "random8_seed lane i is lane 0 jumped i times");
+        }
+
+        // every lane, across the unaligned tail of the bulk fill.
+        std::vector<uint32_t> bits(KAT_STEPS * RANDOM8_LANES + 5);
+        random8_fill_bits(&bits[0], bits.size(), &rng);
+        size_t mismatches = 0;
+        for (size_t n = 0; n < KAT_STEPS; ++n)
+        {
+            for (size_t i = 0; i < RANDOM8_LANES; ++i)
+            {
+                if (bits[n * RANDOM8_LANES + i] != ref_next(ref[i]))
+                    mismatches++;
+            }
+        }
+        for (size_t i = 0; i < 5; ++i)
+        {
+            if (bits[KAT_STEPS * RANDOM8_LANES + i] != ref_next(ref[i]))
+                mismatches++;
+        }
+        check(mismatches == 0, "random8_fill_bits matches reference xoshiro128++ in every lane");
+        printf("  seed %016llx: %zu outputs, %zu mismatches\n", (unsigned long long) seeds[k], bits.size(), mismatches);
+    }
+
+    // random8_jump() jumps each lane RANDOM8_LANES times, and stream i is
+    // the seeded generator jumped i times.
+    rng8_state_t s0, s1;
+    random8_stream(&s0, 7, 0);
+    random8_stream(&s1, 7, 1);
+    random8_jump(&s0);
+    check(memcmp(&s0, &s1, sizeof(rng8_state_t)) == 0, "random8_jump(stream 0) == stream 1");
+    random8_stream(&s0, 7, 3);
+    random8_stream(&s1, 7, 0);
+    random8_jump(&s1); random8_jump(&s1); random8_jump(&s1);
+    check(memcmp(&s0, &s1, sizeof(rng8_state_t)) == 0, "random8_jump^3(stream 0) == stream 3");
+    random8_stream(&s1, 7, 0);
+    for (size_t i = 0; i < RANDOM8_LANES; ++i)
+    {
+        uint32_t ref[4], jmp[4];
+        get_lane(ref, &s1, i);
+        for (size_t j = 0; j < RANDOM8_LANES * 3; ++j)
+            ref_jump(ref);
+        get_lane(jmp, &s0, i);
+        check(memcmp(ref, jmp, sizeof(ref)) == 0, "random8_stream matches the reference jump polynomial");
+    }
+    printf("  jumps and streams: %s\n", gFailures == failures ? "match the reference jump polynomial" : "MISMATCH");
+}
+
+/// @summary A 128-bit generator state, tagged with the stream and lane it
+/// came from.
+struct lane_state_t
+{
+    uint32_t S[4];
+    uint32_t Source;
+
+    bool operator < (lane_state_t const &other) const
+    {
+        return memcmp(S, other.S, sizeof(S)) < 0;
+    }
+};
+
+/// @summary Checks that streams derived with random8_stream() and the lanes
+/// within them don't overlap. Every state visited by every lane of every
+/// stream over OVERLAP_STEPS steps must be distinct; a shared state would
+/// mean two lanes produce the same sequence from that point on.
+static void test_stream_overlap(void)
+{
+    printf("stream overlap:\n");
+    std::vector<lane_state_t> states;
+    states.reserve(OVERLAP_STREAMS * RANDOM8_LANES * OVERLAP_STEPS);
+    uint32_t out[RANDOM8_LANES];
+    for (uint32_t k = 0; k < OVERLAP_STREAMS; ++k)
+    {
+        rng8_state_t rng;
+        random8_stream(&rng, 42, k);
+        for (size_t n = 0; n < OVERLAP_STEPS; ++n)
+        {
+            for (uint32_t i = 0; i < RANDOM8_LANES; ++i)
+            {
+                lane_state_t st;
+                get_lane(st.S, &rng, i);
+                st.Source = k * RANDOM8_LANES + i;
+                states.push_back(st);
+            }
+            random8_fill_bits(out, RANDOM8_LANES, &rng);
+        }
+    }
+    std::sort(states.begin(), states.end());
+    size_t shared = 0;
+    for (size_t i = 1; i < states.size(); ++i)
+    {
+        if (memcmp(states[i].S, states[i-1].S, sizeof(states[i].S)) == 0)
+            shared++;
+    }
+    check(shared == 0, "streams and lanes visit disjoint states");
+    printf("  %u streams x %u lanes x %u steps: %zu shared states\n", OVERLAP_STREAMS, RANDOM8_LANES, OVERLAP_STEPS, shared);
+}
+
+/// @summary Performs a chi-square goodness-of-fit test of random8_fill_uniform()
+/// against the uniform distribution, and checks the output range.
+/// @param min_value The inclusive lower bound of the range.
+/// @param max_value The exclusive upper bound of the range.
+/// @param count The number of values to generate; need not be a multiple of
+/// RANDOM8_LANES.
+/// @param seed The generator seed.
+static void test_chi_square(float min_value, float max_value, size_t count, uint64_t seed)
+{
+    std::vector<float>  values(count);
+    std::vector<size_t> bins(CHI_SQUARE_BINS, 0);
+    rng8_state_t rng;
+    random8_seed(&rng, seed);
+    random8_fill_uniform(&values[0], count, min_value, max_value, &rng);
+
+    bool   in_range = true;
+    double scale    = CHI_SQUARE_BINS / (double(max_value) - double(min_value));
+    for (size_t i = 0; i < count; ++i)
+    {
+        float v = values[i];
+        if (v < min_value || v >= max_value) in_range = false;
+        size_t b = size_t((double(v) - min_value) * scale);
+        bins[b < CHI_SQUARE_BINS ? b : CHI_SQUARE_BINS - 1]++;
+    }
+    double expected = double(count) / CHI_SQUARE_BINS;
+    double chi2     = 0.0;
+    for (size_t b = 0; b < CHI_SQUARE_BINS; ++b)
+    {
+        double d = double(bins[b]) - expected;
+        chi2 += d * d / expected;
+    }
+    printf("  [%g, %g) x %zu: chi-square %.1f (critical %.1f, %u bins)\n", min_value, max_value, count, chi2, CHI_SQUARE_CRITICAL, CHI_SQUARE_BINS);
+    check(in_range, "random8_fill_uniform output lies in [min, max)");
+    check(chi2 < CHI_SQUARE_CRITICAL, "random8_fill_uniform chi-square");
+}
+
+/// @summary Checks the mean and variance of random8_fill_gaussian().
+static void test_gaussian(void)
+{
+    size_t const count = CHI_SQUARE_SAMPLES - 3;
+    std::vector<float> values(count);
+    rng8_state_t rng;
+    random8_seed(&rng, 99);
+    random8_fill_gaussian(&values[0], count, 2.0f, 0.5f, &rng);
+    double mean = 0.0, var = 0.0;
+    for (size_t i = 0; i < count; ++i) mean += values[i];
+    mean /= count;
+    for (size_t i = 0; i < count; ++i) var += (values[i] - mean) * (values[i] - mean);
+    var /= count;
+    // the standard error of the mean is 0.5 / sqrt(count), about 2.4e-4.
+    printf("  gaussian(2, 0.5) x %zu: mean %.5f, variance %.5f\n", count, mean, var);
+    check(fabs(mean - 2.0) < 2.0e-3, "random8_fill_gaussian mean");
+    check(fabs(var  - 0.25) < 2.0e-3, "random8_fill_gaussian variance");
+}
+
+/// @summary Times count values of output and prints the cost per value.
+/// @param name The name of the generator being timed.
+/// @param t0 The start time.
+/// @param count The number of values generated.
+/// @return The cost per value, in nanoseconds.
+static double bench_report(char const *name, std::chrono::steady_clock::time_point t0, size_t count, double baseline)
+{
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / double(count);
+    if (baseline > 0.0) printf("  %-36s %6.2f ns/value (%5.1fx WELL512)\n", name, ns, baseline / ns);
+    else printf("  %-36s %6.2f ns/value\n", name, ns);
+    return ns;
+}
+
+/// @summary Compares the throughput of the eight-lane generator against the
+/// WELL512 generator it supplements, for raw bits and for uniform floats.
+static void run_benchmarks(void)
+{
+    static uint32_t bits[BENCH_COUNT];
+    static float    uniform[BENCH_COUNT];
+    uint32_t        seed[16];
+    rng_state_t     well;
+    rng8_state_t    x8;
+    for (size_t i = 0; i < 16; ++i)
+        seed[i] = uint32_t(i * 0x9E3779B9U + 1);
+    random_init(&well);
+    random_seed(&well, seed, sizeof(seed));
+    random8_seed(&x8, 1);
+
+    printf("throughput (%s):\n", TEST_BACKEND_NAME);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < BENCH_PASSES; ++p)
+    {
+        for (size_t i = 0; i < BENCH_COUNT; ++i)
+            bits[i] = random_bits(&well);
+        gBenchSum += bits[p & (BENCH_COUNT-1)];
+    }
+    double well_bits = bench_report("WELL512 random_bits", t0, BENCH_COUNT * BENCH_PASSES, 0.0);
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < BENCH_PASSES; ++p)
+    {
+        random8_fill_bits(bits, BENCH_COUNT, &x8);
+        gBenchSum += bits[p & (BENCH_COUNT-1)];
+    }
+    bench_report("xoshiro128++ x8 random8_fill_bits", t0, BENCH_COUNT * BENCH_PASSES, well_bits);
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < BENCH_PASSES; ++p)
+    {
+        for (size_t i = 0; i < BENCH_COUNT; ++i)
+            uniform[i] = float(-1.0 + 4.0 * random_draw(&well));
+        gBenchSum += uint32_t(uniform[p & (BENCH_COUNT-1)]);
+    }
+    double well_uniform = bench_report("WELL512 random_draw", t0, BENCH_COUNT * BENCH_PASSES, 0.0);
+
+    t0 = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < BENCH_PASSES; ++p)
+    {
+        random8_fill_uniform(uniform, BENCH_COUNT, -1.0f, 3.0f, &x8);
+        gBenchSum += uint32_t(uniform[p & (BENCH_COUNT-1)]);
+    }
+    bench_report("xoshiro128++ x8 random8_fill_uniform", t0, BENCH_COUNT * BENCH_PASSES, well_uniform);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    printf("rng_test (%s)\n", TEST_BACKEND_NAME);
+    test_known_answers();
+    test_stream_overlap();
+    printf("distribution:\n");
+    test_chi_square( 0.0f, 1.0f, CHI_SQUARE_SAMPLES,     1);
+    test_chi_square(-1.0f, 3.0f, CHI_SQUARE_SAMPLES - 5, 2);
+    test_gaussian();
+    run_benchmarks();
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "rng_test (%s): %zu check(s) FAILED.\n", TEST_BACKEND_NAME, gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("rng_test (%s): all checks passed. (checksum %u)\n", TEST_BACKEND_NAME, gBenchSum);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a timing benchmark for simulation snapshots. The enemy,
+/// particle and background grid state of a typical scene and of a scene with
+/// every pool full is saved into a snapshot ring and restored from it, in tick
+/// order so that each save lands in a different buffer as it does in the game.
+/// Build and run with `make bench`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "display.hpp"
+#include "enemy.hpp"
+#include "grid.hpp"
+#include "particle.hpp"
+#include "ll_snapshot.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of saves and restores timed for each scene.
+#define BENCH_TICKS                  (960U)
+
+/// @summary The number of ticks simulated before timing starts.
+#define BENCH_WARMUP_TICKS           (4U)
+
+/// @summary The fixed timestep, in seconds.
+#define BENCH_TIMESTEP               (1.0 / 120.0)
+
+/// @summary The size of the play area, in world units.
+#define BENCH_WORLD_WIDTH            (800)
+#define BENCH_WORLD_HEIGHT           (600)
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Populates a scene, then times saving it into a snapshot ring
+/// and restoring it again.
+/// @param name The name of the scene.
+/// @param dm The display manager providing the size of the play area.
+/// @param enemies The number of enemies spawned.
+/// @param particles The number of particles emitted.
+static void bench_scene(char const *name, DisplayManager *dm, size_t enemies, size_t particles)
+{
+    EnemyManager    em(ENEMY_CAPACITY, NULL);
+    ParticleManager pm(PARTICLE_CAPACITY, NULL);
+    GridManager     gm(GRID_COLUMNS, GRID_ROWS, NULL);
+    float const     white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    em.Init(dm);
+    pm.Init(dm);
+    gm.Init(dm);
+    for (size_t i = 0; i < enemies; ++i)
+    {
+        float x = float((i * 7919U) % BENCH_WORLD_WIDTH);
+        float y = float((i * 6271U) % BENCH_WORLD_HEIGHT);
+        em.Spawn(EnemyType(i % ENEMY_TYPE_COUNT), x, y);
+    }
+    for (size_t i = 0; i < particles; i += PARTICLE_BURST_BLOCK)
+    {
+        float x = float((i * 7919U) % BENCH_WORLD_WIDTH);
+        float y = float((i * 6271U) % BENCH_WORLD_HEIGHT);
+        pm.EmitBurst(x, y, PARTICLE_BURST_BLOCK, 60.0f, 600.0f, white, 60.0f, 1.0f);
+    }
+    gm.ApplyExplosiveForce(50.0f, 400.0f, 300.0f, 150.0f);
+    for (size_t i = 0; i < BENCH_WARMUP_TICKS; ++i)
+    {
+        em.Update(i * BENCH_TIMESTEP, BENCH_TIMESTEP);
+        pm.Update(i * BENCH_TIMESTEP, BENCH_TIMESTEP);
+        gm.Update(i * BENCH_TIMESTEP, BENCH_TIMESTEP);
+    }
+
+    // the first pass through the ring allocates the buffers; time the second.
+    // scenes too large for SNAPSHOT_DEFAULT_FRAMES ticks keep fewer.
+    snapshot_ring_t ring;
+    size_t          bytes = 0;
+    size_t          kept  = 0;
+    uint64_t        last  = 2 * SNAPSHOT_DEFAULT_FRAMES + BENCH_TICKS - 1;
+    bool            ok    = snapshot_ring_create(&ring, SNAPSHOT_DEFAULT_FRAMES, SNAPSHOT_DEFAULT_BUDGET);
+    for (uint64_t t = 0; ok && t < 2 * SNAPSHOT_DEFAULT_FRAMES; ++t)
+    {
+        snapshot_buffer_t *buf = snapshot_ring_save(&ring, t);
+        ok = em.Save(buf) && pm.Save(buf) && gm.Save(buf);
+    }
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (uint64_t t = 2 * SNAPSHOT_DEFAULT_FRAMES; ok && t <= last; ++t)
+    {
+        snapshot_buffer_t *buf = snapshot_ring_save(&ring, t);
+        ok    = em.Save(buf) && pm.Save(buf) && gm.Save(buf);
+        bytes = buf->Size;
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    while (kept < SNAPSHOT_DEFAULT_FRAMES && snapshot_ring_find(&ring, last - kept) != NULL)
+    {
+        kept++;
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    for (size_t i = 0; ok && i < BENCH_TICKS; ++i)
+    {
+        snapshot_buffer_t *buf = snapshot_ring_find(&ring, last - i % kept);
+        ok = buf != NULL && em.Restore(buf) && pm.Restore(buf) && gm.Restore(buf);
+    }
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+    snapshot_ring_delete(&ring);
+
+    double save_us    = std::chrono::duration<double, std::micro>(t1 - t0).count() / BENCH_TICKS;
+    double restore_us = std::chrono::duration<double, std::micro>(t3 - t2).count() / BENCH_TICKS;
+    if (!ok)
+    {
+        printf("  %-8s FAILED\n", name);
+        return;
+    }
+    printf("  %-8s %6zu enemies %6zu particles %8.1f KB %3zu ticks kept, save %7.1f us, restore %7.1f us\n",
+        name, em.GetCount(), pm.GetCount(), bytes / 1024.0, kept, save_us, restore_us);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    DisplayManager dm;
+    dm.SetWorldSize(BENCH_WORLD_WIDTH, BENCH_WORLD_HEIGHT);
+    printf("snapshot_bench, %ux%u grid, %u ticks on one thread:\n", GRID_COLUMNS, GRID_ROWS, BENCH_TICKS);
+    bench_scene("typical", &dm, 1024U, 16U * 1024U);
+    bench_scene("full", &dm, ENEMY_CAPACITY, PARTICLE_CAPACITY);
+    return EXIT_SUCCESS;
+}
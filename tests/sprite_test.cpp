@@ -0,0 +1,456 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the sprite batch sort and of the render state
+/// changes made while drawing a batch. The radix sort must produce the same
+/// order as std::stable_sort of the layer and render state keys, in both
+/// layer directions, for batches whose keys are random, mostly equal, all
+/// equal, or differ only in their highest digit, starting from a shuffled
+/// order. A batch is then drawn through an effect whose OpenGL entry points
+/// are replaced by stand-ins that record what was drawn; every run of quads
+/// must be drawn once with its own state applied first, including the packed
+/// state with every bit set, and across a full vertex buffer. Build and run
+/// with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "ll_sprite.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The capacity of the test effect, in quads. Smaller than the
+/// drawn batches, so that the vertex buffer fills and is discarded.
+#define TEST_EFFECT_QUADS          (64U)
+
+/// @summary The number of quads in each run of equal state in a drawn batch.
+#define TEST_RUN_LENGTH            (23U)
+
+/// @summary The render state with every bit set; blend mode 3 and the
+/// largest application-defined state.
+#define TEST_STATE_ALL_BITS        (0xFFFFFFFFU)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary The ways in which the keys of a sorted batch are generated.
+enum test_keys_e
+{
+    TEST_KEYS_RANDOM    = 0, /// Any layer and render state.
+    TEST_KEYS_FEW       = 1, /// A few layers, blend modes and states.
+    TEST_KEYS_EQUAL     = 2, /// The same key for every quad.
+    TEST_KEYS_HIGH_BYTE = 3, /// Keys differing only in the top byte of the layer.
+    TEST_KEYS_COUNT     = 4
+};
+
+/// @summary What the OpenGL stand-ins observed while a batch was drawn.
+struct draw_log_t
+{
+    std::vector<uint32_t> Applied;  /// The application state of each ApplyState call.
+    std::vector<uint32_t> Blends;   /// The blend mode in effect at each ApplyState call.
+    std::vector<size_t>   Draws;    /// The number of indices of each draw call.
+    uint32_t              Blend;    /// The blend mode last applied to the stand-in context.
+    size_t                Setups;   /// The number of SetupEffect calls.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/// @summary The names of the ways in which keys are generated.
+static char const *gKeyNames[TEST_KEYS_COUNT] = { "random", "few", "equal", "high byte" };
+
+/// @summary The log written by the OpenGL stand-ins.
+static draw_log_t gLog;
+
+/// @summary The memory returned by glMapBufferRange.
+static std::vector<uint8_t> gMapped;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param value A value identifying the case being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, size_t value)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (%zu)\n", name, value);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Hashes an index into a pseudo-random value.
+/// @param i The index.
+/// @param salt Selects one of several independent values.
+/// @return A pseudo-random 32-bit value.
+static uint32_t mix(uint32_t i, uint32_t salt)
+{
+    uint32_t h = i * 0x9E3779B9U ^ salt * 0xC2B2AE35U;
+    h ^= h >> 16; h *= 0x7FEB352DU;
+    h ^= h >> 15; h *= 0x846CA68BU;
+    h ^= h >> 16;
+    return h;
+}
+
+/// @summary Fills a sprite batch with quads whose keys follow a pattern, and
+/// shuffles its order so that the sort does not start from insertion order.
+/// @param batch The sprite batch, which is flushed first.
+/// @param count The number of quads.
+/// @param keys One of test_keys_e.
+/// @param seed Selects the generated keys and order.
+static void fill_batch(sprite_batch_t *batch, size_t count, uint32_t keys, uint32_t seed)
+{
+    flush_sprite_batch(batch);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t a = mix(i, seed * 2 + 0);
+        uint32_t b = mix(i, seed * 2 + 1);
+        uint32_t layer, state;
+        switch (keys)
+        {
+            case TEST_KEYS_RANDOM:
+                layer = a;
+                state = b;
+                break;
+            case TEST_KEYS_FEW:
+                layer = a % 5U;
+                state = sprite_render_state(b & 3U, (b >> 2) % 3U);
+                break;
+            case TEST_KEYS_EQUAL:
+                layer = 7U;
+                state = TEST_STATE_ALL_BITS;
+                break;
+            default:
+                layer = (a & 0xFF000000U) | 0x123456U;
+                state = 42U;
+                break;
+        }
+        squad_t *quad = sprite_batch_append(batch, 1, layer, state);
+        memset(quad, 0, sizeof(squad_t));
+    }
+    for (size_t i = count; i > 1; --i)
+    {
+        size_t j = mix(uint32_t(i), seed + 1000U) % i;
+        std::swap(batch->Order[i - 1], batch->Order[j]);
+    }
+}
+
+/// @summary Computes the sort key of a quad, as described for the radix sort.
+/// @param batch The sprite batch.
+/// @param quad The insertion index of the quad.
+/// @param back_to_front true if greater layer depths are drawn first.
+/// @return The 64-bit sort key.
+static uint64_t sort_key(sprite_batch_t const *batch, uint32_t quad, bool back_to_front)
+{
+    qsdata_t const &sd    = batch->State[quad];
+    uint32_t        layer = back_to_front ? ~sd.LayerDepth : sd.LayerDepth;
+    return (uint64_t(layer) << 32) | sd.RenderState;
+}
+
+/// @summary Orders quads by their sort key alone, for std::stable_sort.
+struct key_less_t
+{
+    sprite_batch_t const *Batch;
+    bool                  BackToFront;
+
+    bool operator()(uint32_t a, uint32_t b) const
+    {
+        return sort_key(Batch, a, BackToFront) < sort_key(Batch, b, BackToFront);
+    }
+};
+
+/// @summary Sorts a batch with radix_sort_sprite_batch and compares the order
+/// with std::stable_sort of the order the batch started from.
+/// @param batch The sprite batch.
+/// @param count The number of quads.
+/// @param keys One of test_keys_e.
+/// @param back_to_front true if greater layer depths are drawn first.
+/// @param seed Selects the generated keys and order.
+static void test_sort(sprite_batch_t *batch, size_t count, uint32_t keys, bool back_to_front, uint32_t seed)
+{
+    fill_batch(batch, count, keys, seed);
+    std::vector<uint32_t> expect(batch->Order, batch->Order + count);
+    key_less_t less = { batch, back_to_front };
+    std::stable_sort(expect.begin(), expect.end(), less);
+
+    radix_sort_sprite_batch(batch, back_to_front);
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (batch->Order[i] != expect[i]) wrong++;
+    }
+    check(wrong == 0, "the radix sort matches std::stable_sort", count);
+    if (wrong != 0)
+    {
+        fprintf(stderr, "  %s keys, %s, %zu of %zu quads out of place\n", gKeyNames[keys], back_to_front ? "back to front" : "front to back", wrong, count);
+    }
+}
+
+/// @summary Records the start of a batch.
+/// @param effect The effect being used for rendering.
+/// @param context Unused.
+static void test_setup(sprite_effect_t *effect, void *context)
+{
+    UNUSED_ARG(effect);
+    UNUSED_ARG(context);
+    gLog.Setups++;
+}
+
+/// @summary Records the application state applied for a run of quads, and the
+/// blend mode applied to the stand-in context at the time.
+/// @param effect The effect being used for rendering.
+/// @param render_state The application-defined render state.
+/// @param context Unused.
+static void test_apply(sprite_effect_t *effect, uint32_t render_state, void *context)
+{
+    UNUSED_ARG(effect);
+    UNUSED_ARG(context);
+    gLog.Applied.push_back(render_state);
+    gLog.Blends.push_back(gLog.Blend);
+}
+
+/// @summary Identifies the blend mode last applied, from the source and
+/// target color factors set by sprite_effect_blend_mode().
+/// @param src The source color factor.
+/// @param dst The destination color factor.
+/// @return One of sprite_blend_e.
+static uint32_t blend_from_factors(GLenum src, GLenum dst)
+{
+    if (src == GL_SRC_COLOR && dst == GL_ONE_MINUS_SRC_ALPHA) return SPRITE_BLEND_ALPHA;
+    if (src == GL_SRC_COLOR && dst == GL_ONE)                 return SPRITE_BLEND_ADDITIVE;
+    if (src == GL_ONE       && dst == GL_ONE_MINUS_SRC_ALPHA) return SPRITE_BLEND_PREMULTIPLIED;
+    return 0xFFU;
+}
+
+/// @summary Draws a batch whose quads come in runs of TEST_RUN_LENGTH with the
+/// same state, and checks that each run was drawn with its own state.
+/// @param effect The effect.
+/// @param batch The sprite batch.
+/// @param states The render state of each run.
+/// @param runs The number of runs.
+static void test_draw(sprite_effect_t *effect, sprite_batch_t *batch, uint32_t const *states, size_t runs)
+{
+    flush_sprite_batch(batch);
+    for (size_t r = 0; r < runs; ++r)
+    {
+        squad_t *quads = sprite_batch_append(batch, TEST_RUN_LENGTH, 0, states[r]);
+        memset(quads, 0, TEST_RUN_LENGTH * sizeof(squad_t));
+    }
+
+    // the expected state changes; a run with the same state as the one
+    // before it continues the same sub-batch.
+    std::vector<uint32_t> expect;
+    for (size_t r = 0; r < runs; ++r)
+    {
+        if (r == 0 || states[r] != states[r - 1])
+            expect.push_back(states[r]);
+    }
+
+    sprite_effect_apply_t fx = { test_setup, test_apply };
+    gLog.Applied.clear();
+    gLog.Blends.clear();
+    gLog.Draws.clear();
+    gLog.Blend  = 0xFFU;
+    gLog.Setups = 0;
+    sprite_effect_draw_batch<sprite_format_ptc_t, sprite_index_u16_t>(effect, batch, &fx, NULL);
+
+    size_t indices = 0;
+    for (size_t i = 0; i < gLog.Draws.size(); ++i)
+    {
+        indices += gLog.Draws[i];
+    }
+    size_t wrong = 0;
+    for (size_t i = 0; i < expect.size() && i < gLog.Applied.size(); ++i)
+    {
+        if (gLog.Applied[i] != (expect[i] & SPRITE_STATE_MASK)) wrong++;
+        if (gLog.Blends [i] != (expect[i] >> SPRITE_BLEND_SHIFT)) wrong++;
+    }
+    check(gLog.Setups == 1, "the effect is set up once per batch", gLog.Setups);
+    check(gLog.Applied.size() == expect.size(), "the state is applied once per run", gLog.Applied.size());
+    check(wrong == 0, "each run is drawn with its own state and blend mode", wrong);
+    check(indices == batch->Count * 6, "every quad is drawn", indices);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+// stand-ins for the OpenGL entry points referenced by the sprite effect. The
+// blend mode is recovered from the factors, and mapped buffers are backed by
+// ordinary memory, so a batch can be drawn without a context.
+void glGenBuffers(GLsizei n, GLuint *buffers)
+{
+    for (GLsizei i = 0; i < n; ++i) buffers[i] = GLuint(i + 1);
+}
+
+void glDeleteBuffers(GLsizei n, GLuint const *buffers)
+{
+    UNUSED_ARG(n);
+    UNUSED_ARG(buffers);
+}
+
+void glGenVertexArrays(GLsizei n, GLuint *arrays)
+{
+    for (GLsizei i = 0; i < n; ++i) arrays[i] = GLuint(i + 1);
+}
+
+void glDeleteVertexArrays(GLsizei n, GLuint const *arrays)
+{
+    UNUSED_ARG(n);
+    UNUSED_ARG(arrays);
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    UNUSED_ARG(target);
+    UNUSED_ARG(buffer);
+}
+
+void glBindVertexArray(GLuint array)
+{
+    UNUSED_ARG(array);
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, void const *data, GLenum usage)
+{
+    UNUSED_ARG(target);
+    UNUSED_ARG(size);
+    UNUSED_ARG(data);
+    UNUSED_ARG(usage);
+}
+
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    UNUSED_ARG(target);
+    UNUSED_ARG(offset);
+    UNUSED_ARG(access);
+    gMapped.resize(size_t(length));
+    return &gMapped[0];
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+    UNUSED_ARG(target);
+    return GL_TRUE;
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+    UNUSED_ARG(index);
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, void const *pointer)
+{
+    UNUSED_ARG(index);
+    UNUSED_ARG(size);
+    UNUSED_ARG(type);
+    UNUSED_ARG(normalized);
+    UNUSED_ARG(stride);
+    UNUSED_ARG(pointer);
+}
+
+void glEnable(GLenum cap)
+{
+    UNUSED_ARG(cap);
+}
+
+void glDisable(GLenum cap)
+{
+    if (cap == GL_BLEND) gLog.Blend = SPRITE_BLEND_NONE;
+}
+
+void glBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    UNUSED_ARG(red);
+    UNUSED_ARG(green);
+    UNUSED_ARG(blue);
+    UNUSED_ARG(alpha);
+}
+
+void glBlendFuncSeparate(GLenum src_rgb, GLenum dst_rgb, GLenum src_alpha, GLenum dst_alpha)
+{
+    UNUSED_ARG(src_alpha);
+    UNUSED_ARG(dst_alpha);
+    gLog.Blend = blend_from_factors(src_rgb, dst_rgb);
+}
+
+void glBlendEquationSeparate(GLenum mode_rgb, GLenum mode_alpha)
+{
+    UNUSED_ARG(mode_rgb);
+    UNUSED_ARG(mode_alpha);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, GLvoid const *indices)
+{
+    UNUSED_ARG(mode);
+    UNUSED_ARG(type);
+    UNUSED_ARG(indices);
+    gLog.Draws.push_back(size_t(count));
+}
+
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    sprite_batch_t batch;
+    create_sprite_batch(&batch, 16);
+
+    size_t const counts[] = { 0, 1, 2, 3, 255, 256, 4097, 100000 };
+    printf("sprite_test, radix sort against std::stable_sort:\n");
+    for (uint32_t k = 0; k < TEST_KEYS_COUNT; ++k)
+    {
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+        {
+            test_sort(&batch, counts[c], k, true , uint32_t(c * 8 + k));
+            test_sort(&batch, counts[c], k, false, uint32_t(c * 8 + k + 4));
+        }
+        printf("  %-9s keys: %zu batches of up to %zu quads\n", gKeyNames[k], sizeof(counts) / sizeof(counts[0]) * 2, counts[sizeof(counts) / sizeof(counts[0]) - 1]);
+    }
+
+    // the first run has the state with every bit set, which must still be
+    // applied, as must the same state at the start of the next batch. the
+    // batches span several fills of the vertex buffer.
+    sprite_effect_t effect;
+    create_sprite_effect<sprite_format_ptc_t, sprite_shape_quad_t, sprite_index_u16_t>(&effect, TEST_EFFECT_QUADS);
+    uint32_t const all_bits[] = { TEST_STATE_ALL_BITS, TEST_STATE_ALL_BITS };
+    uint32_t const mixed[]    = {
+        TEST_STATE_ALL_BITS,
+        sprite_render_state(SPRITE_BLEND_ALPHA, 5),
+        sprite_render_state(SPRITE_BLEND_ALPHA, 5),
+        sprite_render_state(SPRITE_BLEND_ALPHA, 6),
+        sprite_render_state(SPRITE_BLEND_NONE, 6),
+        sprite_render_state(SPRITE_BLEND_ADDITIVE, 0),
+        sprite_render_state(SPRITE_BLEND_PREMULTIPLIED, 0),
+        TEST_STATE_ALL_BITS
+    };
+    uint32_t const repeat[]   = { sprite_render_state(SPRITE_BLEND_PREMULTIPLIED, 0), sprite_render_state(SPRITE_BLEND_ALPHA, 1) };
+    test_draw(&effect, &batch, all_bits, sizeof(all_bits) / sizeof(all_bits[0]));
+    test_draw(&effect, &batch, all_bits, sizeof(all_bits) / sizeof(all_bits[0]));
+    test_draw(&effect, &batch, mixed   , sizeof(mixed)    / sizeof(mixed[0]));
+    test_draw(&effect, &batch, repeat  , 1);
+    test_draw(&effect, &batch, repeat  , 1);
+    printf("  drew %u-quad runs through a %u-quad effect\n", TEST_RUN_LENGTH, TEST_EFFECT_QUADS);
+    delete_sprite_effect(&effect);
+    delete_sprite_batch(&batch);
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "sprite_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("sprite_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
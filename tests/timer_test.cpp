@@ -0,0 +1,369 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements a test of the hierarchical timing wheel. Timers are
+/// scheduled on either side of the span of every level, from starting ticks
+/// that put the wheel at each cascade boundary and past the wrap of the top
+/// level, and must each fire exactly once, on their deadline. Cancelled timers
+/// must never fire and their handles must go stale, including after the node
+/// is reused, and timers re-armed from their own callback or by cancelling
+/// and scheduling again must fire on the new deadline only. Build and run
+/// with `make test`.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ll_timer.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The number of timers with random delays scheduled in each phase.
+#define TEST_RANDOM_TIMERS         (256U)
+
+/// @summary The largest number of timers scheduled in a single phase.
+#define TEST_MAX_TIMERS            (512U)
+
+/// @summary The value of a fire tick for a timer that has not fired.
+#define TEST_NOT_FIRED             (~0ULL)
+
+/// @summary The period of the timer re-armed from its own callback, in ticks.
+#define TEST_REARM_PERIOD          (97U)
+
+/// @summary The number of times the self re-arming timer fires.
+#define TEST_REARM_COUNT           (100U)
+
+/*//////////////////
+//   Data Types   //
+//////////////////*/
+/// @summary Records when each timer fired, passed to the callbacks.
+struct fire_log_t
+{
+    timer_wheel_t *Wheel;                     /// The wheel being advanced.
+    uint64_t       Fired[TEST_MAX_TIMERS];    /// The tick each timer fired, or TEST_NOT_FIRED.
+    size_t         Repeats;                   /// The number of timers that fired more than once.
+    size_t         Unknown;                   /// The number of payloads out of range.
+    uint32_t       LastKind;                  /// The kind of the most recent callback this tick.
+    uint64_t       LastTick;                  /// The tick of the most recent callback.
+    size_t         OutOfOrder;                /// The number of callbacks not in order of kind.
+    size_t         Rearmed;                   /// The number of times the re-arming timer fired.
+    size_t         Late;                      /// The number of re-arming fires off their deadline.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @param value A value identifying the case being checked.
+/// @return The value of passed.
+static bool check(bool passed, char const *name, uint64_t value)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s (%llu)\n", name, (unsigned long long) value);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Hashes an index into a pseudo-random value.
+/// @param i The index.
+/// @return A pseudo-random 32-bit value.
+static uint32_t mix(uint32_t i)
+{
+    uint32_t h = i * 0x9E3779B9U + 0x7F4A7C15U;
+    h ^= h >> 16; h *= 0x7FEB352DU;
+    h ^= h >> 15; h *= 0x846CA68BU;
+    h ^= h >> 16;
+    return h;
+}
+
+/// @summary Records the payload of each expired timer against the tick it
+/// fired on, and checks that callbacks within a tick arrive in order of kind.
+/// @param payloads The payload of each expired timer.
+/// @param count The number of expired timers.
+/// @param context The fire_log_t.
+/// @param kind The kind of the timers.
+static void record(uint32_t const *payloads, size_t count, void *context, uint32_t kind)
+{
+    fire_log_t *log = (fire_log_t*) context;
+    uint64_t    now = log->Wheel->Now;
+    if (log->LastTick == now && log->LastKind >= kind)
+        log->OutOfOrder++;
+    log->LastTick = now;
+    log->LastKind = kind;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (payloads[i] >= TEST_MAX_TIMERS)
+        {
+            log->Unknown++;
+            continue;
+        }
+        if (log->Fired[payloads[i]] != TEST_NOT_FIRED)
+            log->Repeats++;
+        log->Fired[payloads[i]] = now;
+    }
+}
+
+/// @summary Receives the expired timers of kind 0.
+static void fire_kind0(uint32_t const *payloads, size_t count, void *context)
+{
+    record(payloads, count, context, 0);
+}
+
+/// @summary Receives the expired timers of kind 1.
+static void fire_kind1(uint32_t const *payloads, size_t count, void *context)
+{
+    record(payloads, count, context, 1);
+}
+
+/// @summary Receives the self re-arming timer, scheduling it again for one
+/// period later until it has fired TEST_REARM_COUNT times.
+static void fire_rearm(uint32_t const *payloads, size_t count, void *context)
+{
+    fire_log_t *log = (fire_log_t*) context;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (log->Wheel->Now != uint64_t(payloads[i]))
+            log->Late++;
+        if (++log->Rearmed < TEST_REARM_COUNT)
+            timer_wheel_schedule(log->Wheel, 2, uint32_t(log->Wheel->Now + TEST_REARM_PERIOD), TEST_REARM_PERIOD);
+    }
+}
+
+/// @summary Resets a fire log.
+/// @param log The log to reset.
+/// @param wheel The wheel being advanced.
+static void reset_log(fire_log_t *log, timer_wheel_t *wheel)
+{
+    memset(log, 0, sizeof(fire_log_t));
+    for (size_t i = 0; i < TEST_MAX_TIMERS; ++i)
+    {
+        log->Fired[i] = TEST_NOT_FIRED;
+    }
+    log->Wheel    = wheel;
+    log->LastTick = TEST_NOT_FIRED;
+}
+
+/// @summary Creates an empty wheel whose current tick is start, with the
+/// callbacks registered.
+/// @param wheel The wheel to create.
+/// @param log The log receiving the expired timers.
+/// @param start The current tick of the wheel.
+static void create_wheel(timer_wheel_t *wheel, fire_log_t *log, uint64_t start)
+{
+    timer_wheel_create(wheel, 16);
+    timer_wheel_register(wheel, 0, fire_kind0, log);
+    timer_wheel_register(wheel, 1, fire_kind1, log);
+    timer_wheel_register(wheel, 2, fire_rearm, log);
+    wheel->Now = start;
+    reset_log(log, wheel);
+}
+
+/// @summary Advances a wheel until no timers are pending.
+/// @param wheel The wheel to advance.
+/// @param limit The largest number of ticks to advance.
+/// @return The number of timers that expired.
+static size_t drain(timer_wheel_t *wheel, uint64_t limit)
+{
+    size_t fired = 0;
+    for (uint64_t i = 0; i < limit && wheel->Count > 0; ++i)
+    {
+        fired += timer_wheel_advance(wheel);
+    }
+    return fired;
+}
+
+/// @summary Schedules timers on either side of the span of each level, plus
+/// a spread of random delays, from a given starting tick, and checks that
+/// each fires exactly once on its deadline.
+/// @param log The log receiving the expired timers.
+/// @param start The current tick of the wheel when the timers are scheduled.
+static void test_boundaries(fire_log_t *log, uint64_t start)
+{
+    uint64_t delays[TEST_MAX_TIMERS];
+    size_t   count = 0;
+    delays[count++] = 0;
+    delays[count++] = 1;
+    delays[count++] = 2;
+    for (uint32_t level = 1; level <= TIMER_WHEEL_LEVELS; ++level)
+    {
+        uint64_t span = 1ULL << (TIMER_WHEEL_BITS * level);
+        delays[count++] = span - 1;
+        delays[count++] = span;
+        delays[count++] = span + 1;
+        delays[count++] = span + (span >> 1);
+    }
+    for (uint32_t i = 0; i < TEST_RANDOM_TIMERS; ++i)
+    {
+        // spread the random delays evenly over the levels.
+        uint32_t bits = TIMER_WHEEL_BITS * (1 + i % TIMER_WHEEL_LEVELS);
+        delays[count++] = mix(uint32_t(start) + i) & ((1U << bits) - 1U);
+    }
+
+    timer_wheel_t wheel;
+    create_wheel(&wheel, log, start);
+    uint64_t deadline[TEST_MAX_TIMERS];
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t expect = delays[i] < 1 ? 1 : (delays[i] > TIMER_MAX_DELAY ? TIMER_MAX_DELAY : delays[i]);
+        timer_handle_t h = timer_wheel_schedule(&wheel, uint32_t(i & 1), uint32_t(i), delays[i]);
+        deadline[i] = start + expect;
+        check(h != TIMER_INVALID_HANDLE, "timer_wheel_schedule returns a handle", delays[i]);
+        check(timer_wheel_remaining(&wheel, h) == expect, "timer_wheel_remaining is the clamped delay", delays[i]);
+    }
+    size_t fired = drain(&wheel, TIMER_MAX_DELAY + 1);
+    check(fired == count, "every timer expires", start);
+    check(wheel.Count == 0, "no timers remain pending", start);
+    check(log->Repeats == 0 && log->Unknown == 0, "each timer fires once with its own payload", start);
+    check(log->OutOfOrder == 0, "callbacks arrive in order of kind", start);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!check(log->Fired[i] == deadline[i], "timer fires on its deadline", delays[i]))
+        {
+            fprintf(stderr, "  start %llu delay %llu fired at %llu, due %llu\n", (unsigned long long) start,
+                (unsigned long long) delays[i], (unsigned long long) log->Fired[i], (unsigned long long) deadline[i]);
+        }
+    }
+    timer_wheel_delete(&wheel);
+}
+
+/// @summary Schedules timers across every level, cancels half of them, and
+/// checks that only the rest fire and that stale handles stay stale after
+/// their nodes are reused.
+/// @param log The log receiving the expired timers.
+static void test_cancel(fire_log_t *log)
+{
+    timer_wheel_t  wheel;
+    timer_handle_t handles[TEST_MAX_TIMERS];
+    uint64_t       start = 4000;
+    size_t         count = 256;
+    create_wheel(&wheel, log, start);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t bits = TIMER_WHEEL_BITS * (1 + i % TIMER_WHEEL_LEVELS);
+        handles[i] = timer_wheel_schedule(&wheel, 0, uint32_t(i), 1 + (mix(uint32_t(i)) & ((1U << bits) - 2U)));
+    }
+    for (size_t i = 0; i < count; i += 2)
+    {
+        check(timer_wheel_cancel(&wheel, handles[i]), "cancelling a pending timer succeeds", i);
+        check(!timer_wheel_cancel(&wheel, handles[i]), "cancelling a cancelled timer fails", i);
+        check(timer_wheel_remaining(&wheel, handles[i]) == 0, "a cancelled timer has no time remaining", i);
+    }
+    check(wheel.Count == count / 2, "cancelled timers are no longer pending", wheel.Count);
+
+    // the cancelled nodes are reused by new timers, whose handles differ.
+    timer_handle_t reused[TEST_MAX_TIMERS];
+    for (size_t i = 0; i < count; i += 2)
+    {
+        reused[i] = timer_wheel_schedule(&wheel, 1, uint32_t(count + i), 1 + i);
+        check(reused[i] != handles[i], "a reused node has a new handle", i);
+    }
+    for (size_t i = 0; i < count; i += 2)
+    {
+        check(!timer_wheel_cancel(&wheel, handles[i]), "a stale handle does not cancel the node's new timer", i);
+    }
+    check(wheel.Count == count, "stale handles leave the new timers pending", wheel.Count);
+
+    drain(&wheel, TIMER_MAX_DELAY + 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i & 1)
+        {
+            check(log->Fired[i] != TEST_NOT_FIRED, "an uncancelled timer fires", i);
+            check(!timer_wheel_cancel(&wheel, handles[i]), "cancelling an expired timer fails", i);
+        }
+        else
+        {
+            check(log->Fired[i] == TEST_NOT_FIRED, "a cancelled timer never fires", i);
+            check(log->Fired[count + i] == start + 1 + i, "a timer on a reused node fires on its deadline", i);
+        }
+    }
+    check(log->Repeats == 0 && log->Unknown == 0, "each timer fires once with its own payload", 0);
+    timer_wheel_delete(&wheel);
+}
+
+/// @summary Re-arms one timer from its own callback, and another by cancelling
+/// and scheduling it again before it fires, as weapon cooldowns are, and
+/// checks that each fires on its latest deadline only.
+/// @param log The log receiving the expired timers.
+static void test_rearm(fire_log_t *log)
+{
+    timer_wheel_t wheel;
+    uint64_t      start = (1ULL << (TIMER_WHEEL_BITS * 2)) - 50;
+    create_wheel(&wheel, log, start);
+    timer_wheel_schedule(&wheel, 2, uint32_t(start + TEST_REARM_PERIOD), TEST_REARM_PERIOD);
+    drain(&wheel, TEST_REARM_PERIOD * (TEST_REARM_COUNT + 1));
+    check(log->Rearmed == TEST_REARM_COUNT, "a timer re-armed from its callback fires every period", log->Rearmed);
+    check(log->Late == 0, "a timer re-armed from its callback fires on its deadline", log->Late);
+
+    // push a timer back 300 times, each time before it fires, crossing the
+    // level 1 and level 2 cascades.
+    uint64_t       now    = wheel.Now;
+    timer_handle_t handle = timer_wheel_schedule(&wheel, 0, 0, 5000);
+    for (size_t i = 0; i < 300; ++i)
+    {
+        for (size_t t = 0; t < 37; ++t)
+        {
+            timer_wheel_advance(&wheel);
+        }
+        check(timer_wheel_cancel(&wheel, handle), "a pending timer can be cancelled to re-arm it", i);
+        handle = timer_wheel_schedule(&wheel, 0, 0, 5000);
+    }
+    uint64_t due = wheel.Now + 5000;
+    drain(&wheel, TIMER_MAX_DELAY + 1);
+    check(log->Fired[0] == due, "a re-armed timer fires on its latest deadline only", log->Fired[0] - now);
+    check(log->Repeats == 0, "a re-armed timer fires once", log->Repeats);
+    timer_wheel_delete(&wheel);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    UNUSED_ARG(argc);
+    UNUSED_ARG(argv);
+
+    // start on and around the tick at which each level cascades, and past the
+    // point where the deadlines of the top level wrap around its slots.
+    uint64_t const starts[] =
+    {
+        0, 1, 63, 64, 4095, 4096, 262143, 262144,
+        TIMER_MAX_DELAY, TIMER_MAX_DELAY + 1,
+        (1ULL << 32) - 7, 3ULL * TIMER_MAX_DELAY + 12345
+    };
+    size_t const nstarts = sizeof(starts) / sizeof(starts[0]);
+    fire_log_t  *log     = (fire_log_t*) malloc(sizeof(fire_log_t));
+
+    printf("timer_test, %u levels of %u slots:\n", TIMER_WHEEL_LEVELS, TIMER_WHEEL_SLOTS);
+    for (size_t i = 0; i < nstarts; ++i)
+    {
+        test_boundaries(log, starts[i]);
+    }
+    printf("  level boundaries from %zu starting ticks\n", nstarts);
+    test_cancel(log);
+    printf("  cancellation\n");
+    test_rearm(log);
+    printf("  re-arm\n");
+
+    free(log);
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "timer_test: %zu check(s) FAILED.\n", gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("timer_test: all checks passed.\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,510 @@
+/*/////////////////////////////////////////////////////////////////////////////
+/// @summary Implements the accuracy sweep and throughput comparison for the
+/// fast trig routines. Every float in the supported domain (or every Nth, see
+/// TRIG_SWEEP_STRIDE) is run through the array, vec4 and scalar forms and
+/// compared against the double-precision libm result, and the error bounds
+/// documented on trig_tier_e are asserted. Build and run with `make test-math`;
+/// pass a stride of 1 for a fully exhaustive sweep.
+/// @author Russell Klenk (contact@russellklenk.com)
+///////////////////////////////////////////////////////////////////////////80*/
+
+/*////////////////
+//   Includes   //
+////////////////*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "math.hpp"
+#include "math_trig.hpp"
+
+/*/////////////////
+//   Constants   //
+/////////////////*/
+/// @summary The default step, in float bit patterns, between swept arguments.
+/// A prime stride visits every residue of the low mantissa bits. Override
+/// on the command line; a stride of 1 tests every float in the domain.
+#define TRIG_SWEEP_STRIDE          (61U)
+
+/// @summary The number of arguments passed to each array call in the sweep.
+#define TRIG_SWEEP_BATCH           (8192U)
+
+/// @summary ULP errors are only measured where the reference result has at
+/// least this magnitude; closer to a root the absolute error bound applies.
+#define TRIG_ULP_MIN_MAGNITUDE     (1.0 / 1024.0)
+
+/// @summary The error bounds asserted for each tier. These match the bounds
+/// documented on trig_tier_e.
+#define TRIG_FAST_SINCOS_ABS       (2.7e-5)
+#define TRIG_FAST_ATAN2_ABS        (2.0e-4)
+#define TRIG_PRECISE_SINCOS_ABS    (9.4e-8)
+#define TRIG_PRECISE_SINCOS_ULP    (2U)
+#define TRIG_PRECISE_ATAN2_ABS     (2.8e-7)
+#define TRIG_PRECISE_ATAN2_ULP     (3U)
+
+/// @summary The number of values timed by each throughput benchmark.
+#define BENCH_COUNT                (1U << 12)
+
+/// @summary The number of passes over the benchmark arrays.
+#define BENCH_PASSES               (1000U)
+
+/// @summary A label for the math backend this test was compiled against.
+#if defined(__AVX__)
+    #define TEST_BACKEND_NAME      "AVX"
+#elif GW_MATH_SSE
+    #define TEST_BACKEND_NAME      "SIMD"
+#else
+    #define TEST_BACKEND_NAME      "scalar"
+#endif
+
+/*////////////////
+//  Data Types  //
+////////////////*/
+/// @summary Accumulates the error observed for one routine and tier.
+struct trig_error_t
+{
+    double   MaxAbs;   /// The largest absolute error observed.
+    uint32_t MaxUlp;   /// The largest ULP error observed (see TRIG_ULP_MIN_MAGNITUDE).
+    float    WorstArg; /// The argument producing MaxAbs.
+    size_t   Count;    /// The number of values checked.
+};
+
+/*///////////////
+//   Globals   //
+///////////////*/
+/// @summary The number of checks that have failed.
+static size_t gFailures = 0;
+
+/// @summary Accumulates benchmark output so the timed work can't be discarded.
+static float  gBenchSum = 0.0f;
+
+/*///////////////////////
+//   Local Functions   //
+///////////////////////*/
+/// @summary Records the result of a single check, reporting a failure.
+/// @param passed true if the check passed.
+/// @param name The name of the check.
+/// @return The value of passed.
+static bool check(bool passed, char const *name)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "FAIL: %s\n", name);
+        gFailures++;
+    }
+    return passed;
+}
+
+/// @summary Converts a float bit pattern to a float.
+/// @param bits The bit pattern.
+/// @return The float value.
+static float float_from_bits(uint32_t bits)
+{
+    float f;
+    memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+/// @summary Converts a float to its bit pattern.
+/// @param f The float value.
+/// @return The bit pattern.
+static uint32_t bits_from_float(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(float));
+    return bits;
+}
+
+/// @summary Resets an error accumulator.
+/// @param e The accumulator to reset.
+static void error_init(trig_error_t *e)
+{
+    e->MaxAbs   = 0.0;
+    e->MaxUlp   = 0;
+    e->WorstArg = 0.0f;
+    e->Count    = 0;
+}
+
+/// @summary Accumulates the error of a single result.
+/// @param e The accumulator.
+/// @param value The value computed by the routine under test.
+/// @param reference The double-precision reference value.
+/// @param arg The argument, reported with the worst case.
+static void error_add(trig_error_t *e, float value, double reference, float arg)
+{
+    double err = fabs(double(value) - reference);
+    if (err > e->MaxAbs)
+    {
+        e->MaxAbs   = err;
+        e->WorstArg = arg;
+    }
+    if (fabs(reference) >= TRIG_ULP_MIN_MAGNITUDE)
+    {
+        uint32_t ulp = ulp_distance(value, float(reference));
+        if (ulp > e->MaxUlp) e->MaxUlp = ulp;
+    }
+    e->Count++;
+}
+
+/// @summary Prints an error summary and asserts the bounds.
+/// @param name The name of the routine and tier.
+/// @param e The accumulated error.
+/// @param max_abs The maximum permitted absolute error.
+/// @param max_ulp The maximum permitted ULP error, or UINT32_MAX for no limit.
+static void error_check(char const *name, trig_error_t const *e, double max_abs, uint32_t max_ulp)
+{
+    printf("  %-24s max abs %.3g (limit %.3g), max %5u ULP", name, e->MaxAbs, max_abs, e->MaxUlp);
+    if (max_ulp != UINT32_MAX) printf(" (limit %u)", max_ulp);
+    printf(" over %zu values; worst at %.9g\n", e->Count, e->WorstArg);
+    check(e->MaxAbs <= max_abs, name);
+    check(e->MaxUlp <= max_ulp, name);
+}
+
+/// @summary Sweeps sin and cos over every stride'th float in [0, TRIG_MAX_ARGUMENT]
+/// and its negation, using the array, vec4 and scalar forms.
+/// @param tier One of trig_tier_e.
+/// @param stride The step between swept bit patterns.
+/// @param max_abs The maximum permitted absolute error.
+/// @param max_ulp The maximum permitted ULP error.
+static void sweep_sincos(int tier, uint32_t stride, double max_abs, uint32_t max_ulp)
+{
+    static float x[TRIG_SWEEP_BATCH];
+    static float s[TRIG_SWEEP_BATCH];
+    static float c[TRIG_SWEEP_BATCH];
+    uint32_t const last = bits_from_float(TRIG_MAX_ARGUMENT);
+    trig_error_t   arr, vec, sca;
+    error_init(&arr);
+    error_init(&vec);
+    error_init(&sca);
+
+    uint64_t bits  = 0;
+    size_t   batch = 0;
+    while (bits <= last)
+    {
+        size_t n = 0;
+        for ( ; n < TRIG_SWEEP_BATCH && bits <= last; n += 2, bits += stride)
+        {
+            x[n+0] =  float_from_bits(uint32_t(bits));
+            x[n+1] = -float_from_bits(uint32_t(bits));
+        }
+        fast_sincos_array(s, c, x, n, tier);
+        for (size_t i = 0; i < n; ++i)
+        {
+            error_add(&arr, s[i], sin(double(x[i])), x[i]);
+            error_add(&arr, c[i], cos(double(x[i])), x[i]);
+        }
+        // the vec4 and scalar forms reduce the argument differently, so
+        // check them separately on every fourth batch.
+        if ((batch++ % 4) != 0)
+            continue;
+        for (size_t i = 0; i + 4 <= n; i += 4)
+        {
+            vec4_t vs, vc;
+            fast_sincos(vec4_load(x + i), vs, vc, tier);
+            vec4_store(s + i, vs);
+            vec4_store(c + i, vc);
+        }
+        for (size_t i = 0; i < (n & ~size_t(3)); ++i)
+        {
+            error_add(&vec, s[i], sin(double(x[i])), x[i]);
+            error_add(&vec, c[i], cos(double(x[i])), x[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            float ss, cc;
+            fast_sincos(x[i], ss, cc, tier);
+            error_add(&sca, ss, sin(double(x[i])), x[i]);
+            error_add(&sca, cc, cos(double(x[i])), x[i]);
+        }
+    }
+    char const *tn = tier == TRIG_TIER_FAST ? "fast" : "precise";
+    char name[64];
+    snprintf(name, sizeof(name), "sincos %s array", tn);  error_check(name, &arr, max_abs, max_ulp);
+    snprintf(name, sizeof(name), "sincos %s vec4", tn);   error_check(name, &vec, max_abs, max_ulp);
+    snprintf(name, sizeof(name), "sincos %s scalar", tn); error_check(name, &sca, max_abs, max_ulp);
+}
+
+/// @summary Sweeps atan2 over every stride'th float t in [0, 1] in all eight
+/// octants: (t, 1), (1, t) and their sign combinations. Since atan2 depends
+/// only on the ratio min(|x|, |y|) / max(|x|, |y|), this covers every input the
+/// polynomial sees.
+/// @param tier One of trig_tier_e.
+/// @param stride The step between swept bit patterns.
+/// @param max_abs The maximum permitted absolute error.
+/// @param max_ulp The maximum permitted ULP error.
+static void sweep_atan2(int tier, uint32_t stride, double max_abs, uint32_t max_ulp)
+{
+    static float y[TRIG_SWEEP_BATCH];
+    static float x[TRIG_SWEEP_BATCH];
+    static float a[TRIG_SWEEP_BATCH];
+    uint32_t const last = bits_from_float(1.0f);
+    trig_error_t   arr, sca;
+    error_init(&arr);
+    error_init(&sca);
+
+    uint64_t bits  = 0;
+    size_t   batch = 0;
+    while (bits <= last)
+    {
+        size_t n = 0;
+        for ( ; n < TRIG_SWEEP_BATCH && bits <= last; n += 8, bits += stride)
+        {
+            float t = float_from_bits(uint32_t(bits));
+            y[n+0] =  t; x[n+0] =  1.0f;
+            y[n+1] = -t; x[n+1] =  1.0f;
+            y[n+2] =  t; x[n+2] = -1.0f;
+            y[n+3] = -t; x[n+3] = -1.0f;
+            y[n+4] =  1.0f; x[n+4] =  t;
+            y[n+5] = -1.0f; x[n+5] =  t;
+            y[n+6] =  1.0f; x[n+6] = -t;
+            y[n+7] = -1.0f; x[n+7] = -t;
+        }
+        fast_atan2_array(a, y, x, n, tier);
+        for (size_t i = 0; i < n; ++i)
+        {
+            error_add(&arr, a[i], atan2(double(y[i]), double(x[i])), y[i] / x[i]);
+        }
+        if ((batch++ % 4) != 0)
+            continue;
+        for (size_t i = 0; i < n; ++i)
+        {
+            error_add(&sca, fast_atan2(y[i], x[i], tier), atan2(double(y[i]), double(x[i])), y[i] / x[i]);
+        }
+    }
+    char const *tn = tier == TRIG_TIER_FAST ? "fast" : "precise";
+    char name[64];
+    snprintf(name, sizeof(name), "atan2 %s array", tn);  error_check(name, &arr, max_abs, max_ulp);
+    snprintf(name, sizeof(name), "atan2 %s scalar", tn); error_check(name, &sca, max_abs, max_ulp);
+}
+
+/// @summary Checks that all forms of fast_atan2 treat signed zeros and the
+/// zero vector as libm's atan2 does.
+static void test_atan2_signed_zero(void)
+{
+    // eight lanes of special cases, followed by a scalar tail.
+    float const y[9] = { 0.0f, -0.0f,  0.0f, -0.0f, 0.0f, -0.0f,  0.0f, -0.0f, -0.0f };
+    float const x[9] = { 0.0f,  0.0f, -0.0f, -0.0f, 1.0f,  1.0f, -1.0f, -1.0f, -0.0f };
+    float       a[9];
+
+    printf("signed zeros:\n");
+    for (int tier = TRIG_TIER_FAST; tier <= TRIG_TIER_PRECISE; ++tier)
+    {
+        fast_atan2_array(a, y, x, 9, tier);
+        for (size_t i = 0; i < 9; ++i)
+        {
+            float ref = float(atan2(double(y[i]), double(x[i])));
+            float sca = fast_atan2(y[i], x[i], tier);
+            // compare bit patterns so that the sign of a zero result is checked.
+            check(bits_from_float(sca)  == bits_from_float(ref), "fast_atan2(+-0, x) scalar matches libm");
+            check(bits_from_float(a[i]) == bits_from_float(ref), "fast_atan2_array(+-0, x) matches libm");
+        }
+        vec4_t v = fast_atan2(vec4_load(y), vec4_load(x), tier);
+        vec4_store(a, v);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            float ref = float(atan2(double(y[i]), double(x[i])));
+            check(bits_from_float(a[i]) == bits_from_float(ref), "fast_atan2(vec4) (+-0, +-0) matches libm");
+        }
+    }
+    printf("  atan2(0, -0) = %.9g (libm %.9g)\n", fast_atan2(0.0f, -0.0f, TRIG_TIER_PRECISE), atan2f(0.0f, -0.0f));
+}
+
+/// @summary Checks that the array forms return exactly what the vec4 forms do
+/// for every group of four arguments. In AVX builds the array forms run eight
+/// lanes at a time, so this is what lets AVX and SSE builds of the game play
+/// a lockstep session together.
+static void test_array_matches_vec4(void)
+{
+    static float x[TRIG_SWEEP_BATCH];
+    static float y[TRIG_SWEEP_BATCH];
+    static float s[TRIG_SWEEP_BATCH];
+    static float c[TRIG_SWEEP_BATCH];
+    static float a[TRIG_SWEEP_BATCH];
+    uint32_t const last = bits_from_float(TRIG_MAX_ARGUMENT);
+    for (size_t i = 0; i < TRIG_SWEEP_BATCH; ++i)
+    {
+        // spread the arguments over the whole domain, in both signs.
+        uint32_t bits = uint32_t((uint64_t(last) * i) / TRIG_SWEEP_BATCH);
+        x[i] = (i & 1) ? -float_from_bits(bits) : float_from_bits(bits);
+        y[i] = x[(i * 7919U) % TRIG_SWEEP_BATCH];
+    }
+
+    printf("array forms against vec4 forms:\n");
+    for (int tier = TRIG_TIER_FAST; tier <= TRIG_TIER_PRECISE; ++tier)
+    {
+        size_t mismatches = 0;
+        fast_sincos_array(s, c, x, TRIG_SWEEP_BATCH, tier);
+        fast_atan2_array (a, y, x, TRIG_SWEEP_BATCH, tier);
+        for (size_t i = 0; i < TRIG_SWEEP_BATCH; i += 4)
+        {
+            float  vs[4], vc[4], va[4];
+            vec4_t s4, c4;
+            fast_sincos(vec4_load(x + i), s4, c4, tier);
+            vec4_store(vs, s4);
+            vec4_store(vc, c4);
+            vec4_store(va, fast_atan2(vec4_load(y + i), vec4_load(x + i), tier));
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (bits_from_float(s[i + j]) != bits_from_float(vs[j]) ||
+                    bits_from_float(c[i + j]) != bits_from_float(vc[j]) ||
+                    bits_from_float(a[i + j]) != bits_from_float(va[j]))
+                    mismatches++;
+            }
+        }
+        printf("  %-8s %zu of %u arguments differ\n", tier == TRIG_TIER_FAST ? "fast" : "precise", mismatches, TRIG_SWEEP_BATCH);
+        check(mismatches == 0, "array forms match the vec4 forms bit for bit");
+    }
+}
+
+/// @summary Signature of a throughput benchmark body, which processes count
+/// values from src into dst.
+typedef void (*bench_fn)(float *dst_a, float *dst_b, float const *src_a, float const *src_b, size_t count);
+
+static void bench_libm_sincos(float *s, float *c, float const *x, float const *unused, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+    {
+        s[i] = sinf(x[i]);
+        c[i] = cosf(x[i]);
+    }
+}
+
+static void bench_scalar_sincos_fast(float *s, float *c, float const *x, float const *unused, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+        fast_sincos(x[i], s[i], c[i], TRIG_TIER_FAST);
+}
+
+static void bench_scalar_sincos_precise(float *s, float *c, float const *x, float const *unused, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+        fast_sincos(x[i], s[i], c[i], TRIG_TIER_PRECISE);
+}
+
+static void bench_array_sincos_fast(float *s, float *c, float const *x, float const *unused, size_t n)
+{
+    UNUSED_ARG(unused);
+    fast_sincos_array(s, c, x, n, TRIG_TIER_FAST);
+}
+
+static void bench_array_sincos_precise(float *s, float *c, float const *x, float const *unused, size_t n)
+{
+    UNUSED_ARG(unused);
+    fast_sincos_array(s, c, x, n, TRIG_TIER_PRECISE);
+}
+
+static void bench_libm_atan2(float *a, float *unused, float const *y, float const *x, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+        a[i] = atan2f(y[i], x[i]);
+}
+
+static void bench_scalar_atan2_fast(float *a, float *unused, float const *y, float const *x, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+        a[i] = fast_atan2(y[i], x[i], TRIG_TIER_FAST);
+}
+
+static void bench_scalar_atan2_precise(float *a, float *unused, float const *y, float const *x, size_t n)
+{
+    UNUSED_ARG(unused);
+    for (size_t i = 0; i < n; ++i)
+        a[i] = fast_atan2(y[i], x[i], TRIG_TIER_PRECISE);
+}
+
+static void bench_array_atan2_fast(float *a, float *unused, float const *y, float const *x, size_t n)
+{
+    UNUSED_ARG(unused);
+    fast_atan2_array(a, y, x, n, TRIG_TIER_FAST);
+}
+
+static void bench_array_atan2_precise(float *a, float *unused, float const *y, float const *x, size_t n)
+{
+    UNUSED_ARG(unused);
+    fast_atan2_array(a, y, x, n, TRIG_TIER_PRECISE);
+}
+
+/// @summary Times a benchmark and prints the cost per value.
+/// @param name The name of the routine being timed.
+/// @param func The benchmark body.
+/// @param src_a The first input array.
+/// @param src_b The second input array.
+/// @param baseline The libm cost per value, or zero if this is the baseline.
+/// @return The cost per value, in nanoseconds.
+static double bench(char const *name, bench_fn func, float const *src_a, float const *src_b, double baseline)
+{
+    static float dst_a[BENCH_COUNT];
+    static float dst_b[BENCH_COUNT];
+    func(dst_a, dst_b, src_a, src_b, BENCH_COUNT);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < BENCH_PASSES; ++i)
+    {
+        func(dst_a, dst_b, src_a, src_b, BENCH_COUNT);
+        gBenchSum += dst_a[i & (BENCH_COUNT-1)];
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / double(BENCH_COUNT * BENCH_PASSES);
+    if (baseline > 0.0) printf("  %-26s %7.2f ns/value (%5.1fx libm)\n", name, ns, baseline / ns);
+    else printf("  %-26s %7.2f ns/value\n", name, ns);
+    return ns;
+}
+
+/// @summary Compares the throughput of the fast trig routines against libm.
+static void run_benchmarks(void)
+{
+    static float a[BENCH_COUNT];
+    static float b[BENCH_COUNT];
+    uint32_t seed = 0x2545F491U;
+    for (size_t i = 0; i < BENCH_COUNT; ++i)
+    {
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        a[i] = (float(seed >> 8) * (1.0f / 16777216.0f) - 0.5f) * 200.0f;
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        b[i] = (float(seed >> 8) * (1.0f / 16777216.0f) - 0.5f) * 200.0f;
+    }
+
+    printf("throughput (%s):\n", TEST_BACKEND_NAME);
+    double libm = bench("libm sinf + cosf", bench_libm_sincos, a, b, 0.0);
+    bench("fast_sincos fast",         bench_scalar_sincos_fast,    a, b, libm);
+    bench("fast_sincos precise",      bench_scalar_sincos_precise, a, b, libm);
+    bench("fast_sincos_array fast",   bench_array_sincos_fast,     a, b, libm);
+    bench("fast_sincos_array precise",bench_array_sincos_precise,  a, b, libm);
+    libm = bench("libm atan2f", bench_libm_atan2, a, b, 0.0);
+    bench("fast_atan2 fast",          bench_scalar_atan2_fast,     a, b, libm);
+    bench("fast_atan2 precise",       bench_scalar_atan2_precise,  a, b, libm);
+    bench("fast_atan2_array fast",    bench_array_atan2_fast,      a, b, libm);
+    bench("fast_atan2_array precise", bench_array_atan2_precise,   a, b, libm);
+}
+
+/*///////////////
+//  Functions  //
+///////////////*/
+int main(int argc, char **argv)
+{
+    uint32_t stride = TRIG_SWEEP_STRIDE;
+    if (argc > 1) stride = uint32_t(strtoul(argv[1], NULL, 10));
+    if (stride == 0) stride = 1;
+
+    printf("trig_test (%s), sweeping every %u float(s)\n", TEST_BACKEND_NAME, stride);
+    test_atan2_signed_zero();
+    test_array_matches_vec4();
+    printf("accuracy against double-precision libm:\n");
+    sweep_sincos(TRIG_TIER_FAST,    stride, TRIG_FAST_SINCOS_ABS,    UINT32_MAX);
+    sweep_sincos(TRIG_TIER_PRECISE, stride, TRIG_PRECISE_SINCOS_ABS, TRIG_PRECISE_SINCOS_ULP);
+    sweep_atan2 (TRIG_TIER_FAST,    stride, TRIG_FAST_ATAN2_ABS,     UINT32_MAX);
+    sweep_atan2 (TRIG_TIER_PRECISE, stride, TRIG_PRECISE_ATAN2_ABS,  TRIG_PRECISE_ATAN2_ULP);
+    run_benchmarks();
+
+    if (gFailures > 0)
+    {
+        fprintf(stderr, "trig_test (%s): %zu check(s) FAILED.\n", TEST_BACKEND_NAME, gFailures);
+        return EXIT_FAILURE;
+    }
+    printf("trig_test (%s): all checks passed. (checksum %g)\n", TEST_BACKEND_NAME, gBenchSum);
+    return EXIT_SUCCESS;
+}